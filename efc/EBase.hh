@@ -94,6 +94,10 @@
 #endif
 #endif
 
+#if defined(CPP11_SUPPORT) && defined(__cpp_impl_coroutine)
+	#define CPP20_SUPPORT //C++20 coroutines
+#endif
+
 #ifdef CPP11_SUPPORT
 #if defined( __clang__ ) && !defined( _LIBCPP_VERSION )
 	typedef decltype(nullptr) es_nullptr_t;
@@ -339,4 +343,18 @@ enum MEMType {
 #endif
 #endif
 
+/**
+ * cache line size and alignment, to keep independently written
+ * fields off each other's lines (false sharing)
+ */
+#ifndef ES_CACHE_LINE_SIZE
+#define ES_CACHE_LINE_SIZE 64
+#endif
+
+#if defined(_MSC_VER)
+#define ES_CACHELINE_ALIGNED __declspec(align(ES_CACHE_LINE_SIZE))
+#else
+#define ES_CACHELINE_ALIGNED __attribute__((aligned(ES_CACHE_LINE_SIZE)))
+#endif
+
 #endif //!__EBASE_H__
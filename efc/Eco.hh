@@ -0,0 +1,16 @@
+#ifndef __ECO_H__
+#define __ECO_H__
+
+#define ECO_VERSION "0.1.0"
+
+#include "Efc.hh"
+
+//eco
+#include "./eco/inc/EContext.hh"
+#include "./eco/inc/EFiber.hh"
+#include "./eco/inc/EFiberScheduler.hh"
+#include "./eco/inc/EHooker.hh"
+
+using namespace efc::eco;
+
+#endif /* __ECO_H__ */
@@ -23,8 +23,11 @@
 #include "./inc/EBigInteger.hh"
 #include "./inc/EBits.hh"
 #include "./inc/EBitSet.hh"
+#include "./inc/EBitWords.hh"
 #include "./inc/EBson.hh"
 #include "./inc/EBsonParser.hh"
+#include "./inc/EBTreeMap.hh"
+#include "./inc/EBTreeSet.hh"
 #include "./inc/EBoolean.hh"
 #include "./inc/EBufferedInputStream.hh"
 #include "./inc/EBufferedOutputStream.hh"
@@ -68,6 +71,8 @@
 #include "./inc/EFileInputStream.hh"
 #include "./inc/EFileOutputStream.hh"
 #include "./inc/EFilterOutputStream.hh"
+#include "./inc/EFlatHashMap.hh"
+#include "./inc/EFlatHashSet.hh"
 #include "./inc/EFloat.hh"
 #include "./inc/EFilenameFilter.hh"
 #include "./inc/EFileNotFoundException.hh"
@@ -99,6 +104,8 @@
 #include "./inc/EList.hh"
 #include "./inc/ELLong.hh"
 #include "./inc/ELock.hh"
+#include "./inc/ELongBinaryOperator.hh"
+#include "./inc/ELongObjectHashMap.hh"
 #include "./inc/EMalformedURLException.hh"
 #include "./inc/EMap.hh"
 #include "./inc/EMatcher.hh"
@@ -124,6 +131,9 @@
 #include "./inc/EPipedInputStream.hh"
 #include "./inc/EPipedOutputStream.hh"
 #include "./inc/EPortUnreachableException.hh"
+#include "./inc/EPrimitiveArrayList.hh"
+#include "./inc/EPrimitiveHashMap.hh"
+#include "./inc/EPrimitiveHashSet.hh"
 #include "./inc/EPrintStream.hh"
 #include "./inc/EPriorityQueue.hh"
 #include "./inc/EProcess.hh"
@@ -131,6 +141,7 @@
 #include "./inc/ERandom.hh"
 #include "./inc/ERandomAccessFile.hh"
 #include "./inc/EReference.hh"
+#include "./inc/ERoaringBitmap.hh"
 #include "./inc/ERunnable.hh"
 #include "./inc/ERuntimeException.hh"
 #include "./inc/ESaslException.hh"
@@ -187,6 +198,11 @@
 #include "./inc/concurrent/EAbstractExecutorService.hh"
 #include "./inc/concurrent/EAbstractOwnableSynchronizer.hh"
 #include "./inc/concurrent/EAbstractQueuedSynchronizer.hh"
+#include "./inc/concurrent/EAdaptiveCountDownLatch.hh"
+#include "./inc/concurrent/EAdaptiveReentrantLock.hh"
+#include "./inc/concurrent/EAdaptiveSemaphore.hh"
+#include "./inc/concurrent/EAffinityThreadFactory.hh"
+#include "./inc/concurrent/EArrayBlockingQueue.hh"
 #include "./inc/concurrent/EAtomic.hh"
 #include "./inc/concurrent/EAtomicBoolean.hh"
 #include "./inc/concurrent/EAtomicCounter.hh"
@@ -194,6 +210,7 @@
 #include "./inc/concurrent/EAtomicInteger.hh"
 #include "./inc/concurrent/EAtomicLLong.hh"
 #include "./inc/concurrent/EAtomicReference.hh"
+#include "./inc/concurrent/EAtomicSharedPtr.hh"
 #include "./inc/concurrent/ECallable.hh"
 #include "./inc/concurrent/ECancellationException.hh"
 #include "./inc/concurrent/EConcurrentHashMap.hh"
@@ -201,31 +218,60 @@
 #include "./inc/concurrent/EConcurrentLinkedQueue.hh"
 #include "./inc/concurrent/EConcurrentLiteQueue.hh"
 #include "./inc/concurrent/EConcurrentSkipListMap.hh"
+#include "./inc/concurrent/EConcurrentSkipListPriorityQueue.hh"
+#include "./inc/concurrent/ECompletableFuture.hh"
+#include "./inc/concurrent/ECompletionException.hh"
 #include "./inc/concurrent/ECompletionService.hh"
 #include "./inc/concurrent/ECopyOnWriteArrayList.hh"
 #include "./inc/concurrent/ECountDownLatch.hh"
 #include "./inc/concurrent/ECyclicBarrier.hh"
+#include "./inc/concurrent/EDelayed.hh"
+#include "./inc/concurrent/EDoubleAdder.hh"
+#include "./inc/concurrent/EEpochLinkedQueue.hh"
+#include "./inc/concurrent/EEpochManager.hh"
+#include "./inc/concurrent/EEpochSkipListMap.hh"
 #include "./inc/concurrent/EExchanger.hh"
 #include "./inc/concurrent/EExecutionException.hh"
 #include "./inc/concurrent/EExecutor.hh"
 #include "./inc/concurrent/EExecutorCompletionService.hh"
 #include "./inc/concurrent/EExecutors.hh"
 #include "./inc/concurrent/EExecutorService.hh"
+#include "./inc/concurrent/EForkJoinPool.hh"
+#include "./inc/concurrent/EForkJoinTask.hh"
+#include "./inc/concurrent/EForkJoinWorkerThread.hh"
 #include "./inc/concurrent/EFuture.hh"
+#include "./inc/concurrent/EHazardPointer.hh"
 #include "./inc/concurrent/ELinkedBlockingQueue.hh"
 #include "./inc/concurrent/ELinkedTransferQueue.hh"
 #include "./inc/concurrent/ELockSupport.hh"
+#include "./inc/concurrent/ELongAccumulator.hh"
+#include "./inc/concurrent/ELongAdder.hh"
+#include "./inc/concurrent/EMPMCQueue.hh"
+#include "./inc/concurrent/EMPSCQueue.hh"
 #include "./inc/concurrent/EOrderAccess.hh"
+#include "./inc/concurrent/EPadded.hh"
+#include "./inc/concurrent/EPhaser.hh"
+#include "./inc/concurrent/EPriorityBlockingQueue.hh"
 #include "./inc/concurrent/EReadWriteLock.hh"
+#include "./inc/concurrent/ERecursiveAction.hh"
+#include "./inc/concurrent/ERecursiveTask.hh"
 #include "./inc/concurrent/EReentrantLock.hh"
 #include "./inc/concurrent/EReentrantReadWriteLock.hh"
 #include "./inc/concurrent/ERunnableFuture.hh"
+#include "./inc/concurrent/EScheduledExecutorService.hh"
+#include "./inc/concurrent/EScheduledFuture.hh"
+#include "./inc/concurrent/EScheduledThreadPoolExecutor.hh"
 #include "./inc/concurrent/ESemaphore.hh"
+#include "./inc/concurrent/ESpinControl.hh"
+#include "./inc/concurrent/ESPSCQueue.hh"
+#include "./inc/concurrent/EStampedLock.hh"
+#include "./inc/concurrent/EStriped64.hh"
 #include "./inc/concurrent/ESynchronousQueue.hh"
 #include "./inc/concurrent/EThreadLocalRandom.hh"
 #include "./inc/concurrent/EThreadPoolExecutor.hh"
 #include "./inc/concurrent/ETimeoutException.hh"
 #include "./inc/concurrent/EUnsafe.hh"
+#include "./inc/concurrent/EWorkerLocalQueue.hh"
 
 //efc::nio
 #include "./nio/inc/EAsynchronousCloseException.hh"
@@ -256,11 +302,20 @@
 #include "./nio/inc/ESelector.hh"
 #include "./nio/inc/EServerSocketChannel.hh"
 #include "./nio/inc/ESocketChannel.hh"
+#include "./nio/inc/async/ETask.hh"
+#include "./nio/inc/async/EEventLoop.hh"
+#include "./nio/inc/async/EEventLoopGroup.hh"
+#include "./nio/inc/async/EAsyncChannel.hh"
+#include "./nio/inc/async/EAsyncServerSocketChannel.hh"
+#include "./nio/inc/async/EAsyncSocketChannel.hh"
 
 //efc::cpp11
 #include "./inc/cpp11/EScopeGuard.hh"
 
 using namespace efc;
 using namespace efc::nio;
+#ifdef CPP20_SUPPORT
+using namespace efc::nio::async;
+#endif
 
 #endif // !__EFC_H
@@ -0,0 +1,132 @@
+/*
+ * EContext.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ECONTEXT_HH_
+#define ECONTEXT_HH_
+
+#include "Efc.hh"
+
+#if !defined(WIN32) && !((defined(__x86_64__) || defined(__aarch64__)) && defined(__ELF__))
+#define ECO_UCONTEXT
+#include <ucontext.h>
+#endif
+
+namespace efc {
+namespace eco {
+
+/**
+ * A saved execution context: the callee-saved registers and the stack
+ * pointer of a suspended flow of control, plus the stack it runs on.
+ *
+ * <p>A context created with {@link #EContext()} stands for the calling
+ * thread's own stack and is only ever switched away from and back to.
+ * A context created with a stack size owns a private stack mapped with
+ * {@code mmap}, optionally with an inaccessible guard page below it so
+ * that an overflow faults instead of silently corrupting the
+ * neighbouring stack.  Pages are only committed when touched, so a
+ * fiber that stays shallow costs one or two pages of real memory
+ * regardless of the reserved size.
+ *
+ * <p>On x86_64 and aarch64 ELF targets the switch is a dozen
+ * instructions that save and restore the callee-saved registers; other
+ * POSIX targets fall back to {@code swapcontext}, which also saves the
+ * signal mask and costs a system call per switch.
+ *
+ * <p>Contexts are not thread-safe; a context is resumed by at most one
+ * thread at a time, which is what the fiber scheduler guarantees.
+ */
+
+#ifdef WIN32
+
+class EContext: public EObject {
+public:
+	typedef void (*entry_t)(void* arg);
+
+	EContext() {
+	}
+	EContext(int stackSize, boolean guard=true) {
+		throw EUnsupportedOperationException(__FILE__, __LINE__);
+	}
+	void reset(entry_t entry, void* arg) {
+		throw EUnsupportedOperationException(__FILE__, __LINE__);
+	}
+	void swap(EContext* to) {
+		throw EUnsupportedOperationException(__FILE__, __LINE__);
+	}
+	int getStackSize() {
+		return 0;
+	}
+};
+
+#else //!
+
+class EContext: public EObject {
+public:
+	typedef void (*entry_t)(void* arg);
+
+	virtual ~EContext();
+
+	/**
+	 * Creates the context of the calling thread; it has no stack of its
+	 * own and is filled in by the first {@link #swap}.
+	 */
+	EContext();
+
+	/**
+	 * Creates a context with a private stack of at least
+	 * {@code stackSize} bytes, rounded up to whole pages.
+	 *
+	 * @param stackSize the usable stack size in bytes
+	 * @param guard     whether to protect the page below the stack;
+	 *                  every guard page costs one extra kernel mapping
+	 *                  ({@code vm.max_map_count} on Linux)
+	 * @throws EOutOfMemoryError if the stack cannot be mapped
+	 */
+	EContext(int stackSize, boolean guard=true) THROWS(EOutOfMemoryError);
+
+	/**
+	 * Prepares the context so that the next switch to it calls
+	 * {@code entry(arg)} at the top of its stack.  A context may be reset
+	 * again once its previous entry has switched away for the last time,
+	 * which lets finished fibers hand their stacks on.
+	 *
+	 * <p>{@code entry} must never return; it ends by switching to
+	 * another context.
+	 */
+	void reset(entry_t entry, void* arg);
+
+	/**
+	 * Saves the current flow of control into this context and resumes
+	 * {@code to}.  Returns when some other flow switches back to this
+	 * context.
+	 */
+	void swap(EContext* to);
+
+	/**
+	 * Returns the usable stack size, or 0 for a thread context.
+	 */
+	int getStackSize();
+
+private:
+	void* sp_;
+	char* map_;
+	int mapSize_;
+	int stackSize_;
+#ifdef ECO_UCONTEXT
+	ucontext_t uc_;
+#endif
+
+	// unsupported.
+	EContext(const EContext&);
+	EContext& operator=(const EContext&);
+};
+
+#endif //!WIN32
+
+} /* namespace eco */
+} /* namespace efc */
+#endif /* ECONTEXT_HH_ */
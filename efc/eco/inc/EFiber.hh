@@ -0,0 +1,204 @@
+/*
+ * EFiber.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EFIBER_HH_
+#define EFIBER_HH_
+
+#include "./EContext.hh"
+
+namespace efc {
+namespace eco {
+
+class EFiberScheduler;
+class EFiberWorker;
+
+/**
+ * A fiber is a user-mode thread of execution with its own small stack,
+ * multiplexed by an {@link EFiberScheduler} onto a few carrier
+ * {@code EThread}s.  Creating, switching and parking a fiber never
+ * enters the kernel, so a process can keep hundreds of thousands of
+ * them alive where it could only afford a few thousand threads.
+ *
+ * <p>Code running on a fiber is written in the ordinary blocking style.
+ * While the scheduler is linked in, the libc calls underneath
+ * {@code ESocket}, {@code EServerSocket}, the socket streams,
+ * {@code EThread::sleep} and {@code poll} suspend only the calling
+ * fiber and let its carrier run others until the descriptor is ready
+ * (see {@link EHooker}).  {@link #park()} / {@link #unpark()} are the
+ * fiber counterparts of {@code ELockSupport} for building synchronizers.
+ * When eco is linked with the {@code ELockSupport} wrappers (see
+ * {@link EHooker}), {@code ELockSupport::park} on a fiber parks only the
+ * fiber, so the locks, conditions and queues of the concurrent package
+ * can be used across fibers too.
+ *
+ * <p>Like a thread, a fiber either runs its {@code target} or an
+ * overridden {@link #run()}:
+ *
+ * <pre> {@code
+ * class Echo : public ERunnable {
+ * public:
+ *     Echo(ESocket* s) : socket(s) {}
+ *     virtual void run() {
+ *         char buf[512];
+ *         int n;
+ *         while ((n = socket->getInputStream()->read(buf, sizeof(buf))) > 0) {
+ *             socket->getOutputStream()->write(buf, n);
+ *         }
+ *     }
+ *     sp<ESocket> socket;
+ * };
+ *
+ * EFiberScheduler scheduler;
+ * scheduler.schedule(new EFiber(new Echo(client)));
+ * }</pre>
+ *
+ * <p>A fiber stays on the carrier it was first scheduled on; wakeups
+ * from other threads are handed over to that carrier.
+ */
+
+class EFiber: public ERunnable {
+public:
+	/**
+	 * Default usable stack size of a fiber, in bytes.
+	 */
+	static const int DEFAULT_STACK_SIZE = 64 * 1024;
+
+	/**
+	 * Fiber states.
+	 */
+	enum State {
+		NEW,
+		RUNNABLE,
+		WAITING,
+		TERMINATED
+	};
+
+public:
+	virtual ~EFiber();
+
+	/**
+	 * Creates a fiber that calls its own {@link #run()}.
+	 *
+	 * @param stackSize the usable stack size, or 0 for
+	 *                  {@link #DEFAULT_STACK_SIZE}
+	 */
+	EFiber(int stackSize=0);
+
+	/**
+	 * Creates a fiber that runs {@code target}.
+	 */
+	EFiber(sp<ERunnable> target, int stackSize=0);
+
+#ifdef CPP11_SUPPORT
+	EFiber(std::function<void()> func, int stackSize=0);
+#endif
+
+	/**
+	 * Runs the target, if any.  Subclasses override this method.
+	 */
+	virtual void run();
+
+	/**
+	 * Returns the identifier of this fiber, unique within the process.
+	 */
+	llong getId();
+
+	void setName(const char* name);
+	const char* getName();
+
+	/**
+	 * Returns the state of this fiber.
+	 */
+	State getState();
+
+	/**
+	 * Returns true if this fiber has been scheduled and not terminated.
+	 */
+	boolean isAlive();
+
+	/**
+	 * Returns the scheduler this fiber was scheduled on, or null.
+	 */
+	EFiberScheduler* getScheduler();
+
+	/**
+	 * Makes the permit available to this fiber, waking it if it is
+	 * parked.  May be called from any thread or fiber.
+	 */
+	void unpark();
+
+	virtual EStringBase toString();
+
+	/**
+	 * Returns the fiber running on the calling thread, or null if the
+	 * caller is not a fiber.
+	 */
+	static EFiber* currentFiber();
+
+	/**
+	 * Lets the other runnable fibers of the current carrier run first.
+	 * Does nothing when not called on a fiber.
+	 */
+	static void yield();
+
+	/**
+	 * Suspends the current fiber for {@code millis} milliseconds; on a
+	 * plain thread this is {@code EThread::sleep}.
+	 */
+	static void sleep(llong millis);
+
+	/**
+	 * Disables the current fiber until its permit is available, as
+	 * {@code ELockSupport::park}.  May return spuriously; callers
+	 * re-check their condition.  On a plain thread this is
+	 * {@code ELockSupport::park()}.
+	 */
+	static void park();
+
+	/**
+	 * Like {@link #park()}, for at most {@code nanos} nanoseconds.
+	 */
+	static void parkNanos(llong nanos);
+
+protected:
+	friend class EFiberScheduler;
+	friend class EFiberWorker;
+
+	sp<ERunnable> target_;
+	EString name_;
+	llong id_;
+	int stackSize_;
+	volatile int state_;
+
+	// carrier bookkeeping, owned by the worker.
+	EFiberScheduler* scheduler_;
+	EFiberWorker* worker_;
+	EContext* context_;
+	sp<EFiber> self_;       //keeps a scheduled fiber alive
+	EFiber* next_;          //run queue / inbound list link
+	volatile int waiting_;  //1 while suspended and not yet woken
+	volatile int permit_;
+	int wakeReason_;
+	int timerIndex_;        //slot in the carrier's timer heap, or -1
+	boolean yielded_;
+	EFiber* lockPrev_;      //carrier's list of ELockSupport waiters
+	EFiber* lockNext_;
+	int lockSeen_;          //carrier's unpark count at the last return
+
+	void init(int stackSize);
+
+	static void parkCurrent(llong nanos);
+
+private:
+	// unsupported.
+	EFiber(const EFiber&);
+	EFiber& operator=(const EFiber&);
+};
+
+} /* namespace eco */
+} /* namespace efc */
+#endif /* EFIBER_HH_ */
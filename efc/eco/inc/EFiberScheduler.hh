@@ -0,0 +1,159 @@
+/*
+ * EFiberScheduler.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EFIBERSCHEDULER_HH_
+#define EFIBERSCHEDULER_HH_
+
+#include "./EFiber.hh"
+
+namespace efc {
+namespace eco {
+
+/**
+ * Runs {@link EFiber}s M:N on a fixed set of carrier threads.
+ *
+ * <p>Every carrier owns a run queue, a timer heap and an epoll instance
+ * (poll elsewhere) through which its fibers wait for descriptors.  A new
+ * fiber is assigned to a carrier round-robin and stays there, so the
+ * run queue, the timers and the descriptor registrations are only ever
+ * touched by their own carrier; the only shared structure is a
+ * lock-free inbound list for fibers scheduled or woken by other threads.
+ *
+ * <pre> {@code
+ * EFiberScheduler scheduler(4);
+ * for (;;) {
+ *     sp<ESocket> client = server.accept();
+ *     scheduler.schedule(new EFiber(new Handler(client)));
+ * }
+ * scheduler.join();
+ * }</pre>
+ *
+ * <p>Carriers are started by the first {@link #schedule}.  Fibers may
+ * schedule further fibers, also on other schedulers.
+ */
+
+#ifdef WIN32
+
+class EFiberScheduler: public EObject {
+public:
+	EFiberScheduler(int threads=0) {
+		throw EUnsupportedOperationException(__FILE__, __LINE__);
+	}
+	void setStackGuard(boolean on) {
+	}
+	void schedule(sp<EFiber> fiber) THROWS(EIllegalStateException) {
+		throw EUnsupportedOperationException(__FILE__, __LINE__);
+	}
+	sp<EFiber> schedule(sp<ERunnable> task, int stackSize=0) THROWS(EIllegalStateException) {
+		throw EUnsupportedOperationException(__FILE__, __LINE__);
+	}
+	void join() {
+	}
+	int getThreads() {
+		return 0;
+	}
+	int getFiberCount() {
+		return 0;
+	}
+	static EFiberScheduler* currentScheduler() {
+		return null;
+	}
+};
+
+#else //!
+
+class EFiberScheduler: public EObject {
+public:
+	virtual ~EFiberScheduler();
+
+	/**
+	 * Creates a scheduler.
+	 *
+	 * @param threads the number of carrier threads, or 0 for the number
+	 *                of available processors
+	 */
+	EFiberScheduler(int threads=0);
+
+	/**
+	 * Whether new fiber stacks get a guard page (default true).  A guard
+	 * page turns a stack overflow into a fault, but costs an extra
+	 * kernel mapping per fiber; beyond ~30k fibers Linux needs a larger
+	 * {@code vm.max_map_count} or guards off.
+	 */
+	void setStackGuard(boolean on);
+
+	/**
+	 * Schedules a new fiber for execution.
+	 *
+	 * @throws EIllegalStateException if the fiber was already scheduled,
+	 *         or the scheduler has been joined and all its fibers have
+	 *         terminated
+	 */
+	void schedule(sp<EFiber> fiber) THROWS(EIllegalStateException);
+
+	/**
+	 * Schedules {@code task} on a new fiber.
+	 *
+	 * @return the new fiber
+	 */
+	sp<EFiber> schedule(sp<ERunnable> task, int stackSize=0) THROWS(EIllegalStateException);
+
+#ifdef CPP11_SUPPORT
+	sp<EFiber> scheduleX(std::function<void()> func, int stackSize=0) THROWS(EIllegalStateException) {
+		sp<EFiber> fiber = new EFiber(func, stackSize);
+		schedule(fiber);
+		return fiber;
+	}
+#endif
+
+	/**
+	 * Waits until every scheduled fiber has terminated, then stops the
+	 * carriers.  Running fibers may still schedule more fibers while
+	 * join() waits; afterwards the scheduler cannot be used.  Must not
+	 * be called from one of its own fibers.
+	 */
+	void join();
+
+	/**
+	 * Returns the number of carrier threads.
+	 */
+	int getThreads();
+
+	/**
+	 * Returns the number of scheduled fibers that have not terminated.
+	 */
+	int getFiberCount();
+
+	/**
+	 * Returns the scheduler of the calling fiber, or null.
+	 */
+	static EFiberScheduler* currentScheduler();
+
+private:
+	friend class EFiberWorker;
+
+	EFiberWorker** workers_;
+	int threads_;
+	volatile int next_;
+	volatile int live_;
+	volatile int started_;
+	volatile int joined_;
+	boolean stackGuard_;
+
+	void start();
+	void fiberTerminated();
+
+	// unsupported.
+	EFiberScheduler(const EFiberScheduler&);
+	EFiberScheduler& operator=(const EFiberScheduler&);
+};
+
+#endif //!WIN32
+
+} /* namespace eco */
+} /* namespace efc */
+#endif /* EFIBERSCHEDULER_HH_ */
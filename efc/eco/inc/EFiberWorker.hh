@@ -0,0 +1,205 @@
+/*
+ * EFiberWorker.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EFIBERWORKER_HH_
+#define EFIBERWORKER_HH_
+
+#include "./EFiberScheduler.hh"
+
+#ifndef WIN32
+
+#include <poll.h>
+
+namespace efc {
+namespace eco {
+
+/**
+ * A carrier thread of an {@link EFiberScheduler}.
+ *
+ * <p>Internal to the eco sources: the fiber primitives and the libc
+ * hooks suspend fibers through it, everyone else goes through
+ * {@link EFiber} and {@link EFiberScheduler}.
+ *
+ * <p>Apart from {@link #submit} and {@link #wakeup}, every method must
+ * be called on the carrier's own thread.
+ */
+
+class EFiberWorker: public EThread {
+public:
+	/** Wake reasons returned by {@link #suspend}. */
+	enum {
+		WAKE_SIGNAL = 0,
+		WAKE_TIMEOUT = 1,
+		WAKE_CLOSED = 2
+	};
+
+	virtual ~EFiberWorker();
+
+	EFiberWorker(EFiberScheduler* scheduler);
+
+	virtual void run();
+
+	/**
+	 * Hands a new or remotely woken fiber to this carrier.  Any thread.
+	 */
+	void submit(EFiber* fiber);
+
+	/**
+	 * Interrupts a blocking poll of this carrier.  Any thread.
+	 */
+	void signal();
+
+	/**
+	 * Makes a suspended fiber runnable again.  Any thread.
+	 *
+	 * @return false if the fiber was not waiting or has already been
+	 *         woken by someone else
+	 */
+	static boolean wakeup(EFiber* fiber, int reason);
+
+	/**
+	 * Suspends the running fiber, which must have set its
+	 * {@code waiting_} flag, until {@link #wakeup} or until
+	 * {@code timeoutNanos} have elapsed ({@code < 0}: no timeout).
+	 *
+	 * @return the wake reason
+	 */
+	int suspend(llong timeoutNanos);
+
+	/**
+	 * Suspends the running fiber for {@code nanos} nanoseconds.
+	 */
+	void sleepRunning(llong nanos);
+
+	/**
+	 * Moves the running fiber to the tail of the run queue.
+	 */
+	void yieldRunning();
+
+	/**
+	 * Suspends the running fiber until one of {@code fds} is ready for
+	 * its {@code events}, one of them is closed or the timeout elapses.
+	 * {@code revents} are only filled in, with {@code POLLNVAL}, for the
+	 * descriptors closed meanwhile; otherwise callers re-poll.
+	 *
+	 * @return the wake reason, or -1 if none of the descriptors can be
+	 *         waited on (e.g. regular files)
+	 */
+	int waitIo(struct pollfd* fds, int nfds, llong timeoutNanos);
+
+	/**
+	 * Wakes the fibers of all carriers waiting in {@link #waitIo} for
+	 * {@code fd}, with {@link #WAKE_CLOSED}.  Called by the {@code close}
+	 * hook before the descriptor is closed.  Any thread.
+	 */
+	static void closing(int fd);
+
+	/**
+	 * Parks the running fiber for {@code ELockSupport::park}: until the
+	 * carrier thread is unparked through {@link #lockUnpark}, for at
+	 * most {@code nanos} nanoseconds ({@code < 0}: no timeout).
+	 */
+	void lockPark(llong nanos);
+
+	/**
+	 * {@code ELockSupport::unpark} of this carrier thread.  Waiters
+	 * recorded the carrier as their thread, so all fibers parked in
+	 * {@link #lockPark} return, and those about to park do not block;
+	 * they re-check their conditions, as after a spurious wakeup.
+	 * Any thread.
+	 */
+	void lockUnpark();
+
+	/**
+	 * Returns the fiber running on this carrier, or null.
+	 */
+	EFiber* running();
+
+	/**
+	 * Returns the carrier of the calling thread, or null.
+	 */
+	static EFiberWorker* current();
+
+	/**
+	 * Returns {@code thread} if it is a running carrier, else null.
+	 */
+	static EFiberWorker* carrierOf(EThread* thread);
+
+private:
+	struct IoWait {
+		EFiber* fiber;
+		int fd;
+		short events;
+		IoWait* next;
+		IoWait* prevFd;   //process-wide list of waits on fd, for closing()
+		IoWait* nextFd;
+		volatile boolean closed;
+	};
+	struct IoSlot {
+		IoWait* waiters;
+		boolean added;
+		int active;   //index in actives_, or -1
+	};
+
+	EFiberScheduler* scheduler_;
+	EContext mainContext_;
+	EFiber* running_;
+
+	EFiber* runHead_;
+	EFiber* runTail_;
+	int runCount_;
+	EFiber* volatile inbound_;
+	volatile int polling_;
+	volatile int signalled_;
+
+	int pollFd_;
+	int wakeFds_[2];
+	IoSlot* slots_;
+	int slotCount_;
+	int* actives_;     //fds with waiters, for the poll(2) backend
+	int activeCount_;
+
+	EFiber** timers_;  //min-heap on deadlines_
+	llong* deadlines_;
+	int timerCount_;
+	int timerCapacity_;
+
+	EContext** stacks_; //finished stacks kept for reuse
+	int stackCount_;
+
+	EFiber* lockParked_; //fibers in lockPark, under lockParkedLock_
+	volatile int lockParkedLock_;
+	volatile int lockUnparks_;
+
+	void pushRun(EFiber* fiber);
+	EFiber* popRun();
+	void drainInbound();
+	void resume(EFiber* fiber);
+	void pollIo(llong timeoutNanos);
+	void dispatch(int fd, int revents);
+	boolean arm(IoWait* w);
+	void disarm(IoWait* w);
+	static void watch(IoWait* w);
+	static void unwatch(IoWait* w);
+	void rearm(int fd);
+	IoSlot* slot(int fd);
+	void addTimer(EFiber* fiber, llong deadline);
+	void removeTimer(int index);
+	void siftUp(int index);
+	void siftDown(int index);
+	void expireTimers();
+	EContext* newContext(int stackSize);
+	void freeContext(EContext* context);
+
+	static void fiberEntry(void* arg);
+};
+
+} /* namespace eco */
+} /* namespace efc */
+
+#endif //!WIN32
+#endif /* EFIBERWORKER_HH_ */
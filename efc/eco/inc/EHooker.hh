@@ -0,0 +1,63 @@
+/*
+ * EHooker.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EHOOKER_HH_
+#define EHOOKER_HH_
+
+#include "Efc.hh"
+
+namespace efc {
+namespace eco {
+
+/**
+ * Makes the blocking libc calls of fibers suspend the fiber instead of
+ * the carrier thread.
+ *
+ * <p>The eco library defines {@code read}, {@code readv}, {@code recv},
+ * {@code recvfrom}, {@code recvmsg}, {@code write}, {@code writev},
+ * {@code send}, {@code sendto}, {@code sendmsg}, {@code accept},
+ * {@code connect}, {@code poll}, {@code nanosleep}, {@code usleep} and
+ * {@code sleep}, which is where {@code ESocket}, {@code EServerSocket},
+ * the socket streams, {@code eso_net_wait} and {@code EThread::sleep}
+ * end up.  Called on a plain thread they go straight to libc.  Called
+ * on a fiber, a socket or pipe is switched to non-blocking mode
+ * underneath, and whenever the call would block the fiber waits on its
+ * carrier's epoll instance and retries.  {@code SO_RCVTIMEO} /
+ * {@code SO_SNDTIMEO} keep their meaning, and {@code fcntl},
+ * {@code ioctl(FIONBIO)} and {@code close} keep the descriptor state
+ * the application sees unchanged, also for plain threads that later
+ * use the same descriptor.  A {@code close} from any thread wakes the
+ * fibers still waiting on the descriptor: their calls fail with
+ * {@code EBADF}, a {@code poll} reports {@code POLLNVAL}.
+ *
+ * <p>{@code ELockSupport} is part of the prebuilt efc library and
+ * cannot be hooked by symbol interposition.  On Linux, link the
+ * ELockSupportHook object and pass
+ * {@code -Wl,--wrap=} for {@code _ZN3efc12ELockSupport4parkEv},
+ * {@code _ZN3efc12ELockSupport9parkNanosEx},
+ * {@code _ZN3efc12ELockSupport9parkUntilEx} and
+ * {@code _ZN3efc12ELockSupport6unparkEPNS_7EThreadE} (as
+ * test/Makefile_unix does); then a fiber contending on an
+ * {@code EReentrantLock}, condition or blocking queue parks only
+ * itself, and the carrier goes on running the other fibers.
+ *
+ * <p>{@code select} and regular files are not intercepted; they block
+ * the carrier.
+ */
+
+class EHooker {
+public:
+	/**
+	 * Resolves the libc functions behind the hooks.  Called by every
+	 * {@link EFiberScheduler}, which also keeps the hooks linked in.
+	 */
+	static void init();
+};
+
+} /* namespace eco */
+} /* namespace efc */
+#endif /* EHOOKER_HH_ */
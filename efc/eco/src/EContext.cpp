@@ -0,0 +1,242 @@
+/*
+ * EContext.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../inc/EContext.hh"
+
+#ifndef WIN32
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+
+#ifndef ECO_UCONTEXT
+
+extern "C" {
+void eco_swap_context(void** from, void* to);
+void eco_context_trampoline();
+}
+
+#if defined(__x86_64__)
+
+/*
+ * Frame: [mxcsr|x87 cw] r15 r14 r13 r12 rbx rbp <return address>.
+ * A new context starts in the trampoline with r12 = arg, r13 = entry.
+ */
+__asm__ (
+	".text\n"
+	".globl eco_swap_context\n"
+	".hidden eco_swap_context\n"
+	".type eco_swap_context,@function\n"
+	".align 16\n"
+	"eco_swap_context:\n"
+	"	pushq %rbp\n"
+	"	pushq %rbx\n"
+	"	pushq %r12\n"
+	"	pushq %r13\n"
+	"	pushq %r14\n"
+	"	pushq %r15\n"
+	"	subq $8, %rsp\n"
+	"	stmxcsr (%rsp)\n"
+	"	fnstcw 4(%rsp)\n"
+	"	movq %rsp, (%rdi)\n"
+	"	movq %rsi, %rsp\n"
+	"	ldmxcsr (%rsp)\n"
+	"	fldcw 4(%rsp)\n"
+	"	addq $8, %rsp\n"
+	"	popq %r15\n"
+	"	popq %r14\n"
+	"	popq %r13\n"
+	"	popq %r12\n"
+	"	popq %rbx\n"
+	"	popq %rbp\n"
+	"	ret\n"
+	".size eco_swap_context,.-eco_swap_context\n"
+	".globl eco_context_trampoline\n"
+	".hidden eco_context_trampoline\n"
+	".type eco_context_trampoline,@function\n"
+	".align 16\n"
+	"eco_context_trampoline:\n"
+	"	movq %r12, %rdi\n"
+	"	callq *%r13\n"
+	"	ud2\n"
+	".size eco_context_trampoline,.-eco_context_trampoline\n"
+	".section .note.GNU-stack,\"\",@progbits\n"
+	".text\n"
+);
+
+#define FRAME_SIZE 80
+
+#elif defined(__aarch64__)
+
+/*
+ * Frame: x19..x28 x29 x30 d8..d15.
+ * A new context starts in the trampoline with x19 = arg, x20 = entry.
+ */
+__asm__ (
+	".text\n"
+	".globl eco_swap_context\n"
+	".hidden eco_swap_context\n"
+	".type eco_swap_context,%function\n"
+	".align 4\n"
+	"eco_swap_context:\n"
+	"	sub sp, sp, #160\n"
+	"	stp x19, x20, [sp, #0]\n"
+	"	stp x21, x22, [sp, #16]\n"
+	"	stp x23, x24, [sp, #32]\n"
+	"	stp x25, x26, [sp, #48]\n"
+	"	stp x27, x28, [sp, #64]\n"
+	"	stp x29, x30, [sp, #80]\n"
+	"	stp d8, d9, [sp, #96]\n"
+	"	stp d10, d11, [sp, #112]\n"
+	"	stp d12, d13, [sp, #128]\n"
+	"	stp d14, d15, [sp, #144]\n"
+	"	mov x9, sp\n"
+	"	str x9, [x0]\n"
+	"	mov sp, x1\n"
+	"	ldp x19, x20, [sp, #0]\n"
+	"	ldp x21, x22, [sp, #16]\n"
+	"	ldp x23, x24, [sp, #32]\n"
+	"	ldp x25, x26, [sp, #48]\n"
+	"	ldp x27, x28, [sp, #64]\n"
+	"	ldp x29, x30, [sp, #80]\n"
+	"	ldp d8, d9, [sp, #96]\n"
+	"	ldp d10, d11, [sp, #112]\n"
+	"	ldp d12, d13, [sp, #128]\n"
+	"	ldp d14, d15, [sp, #144]\n"
+	"	add sp, sp, #160\n"
+	"	ret\n"
+	".size eco_swap_context,.-eco_swap_context\n"
+	".globl eco_context_trampoline\n"
+	".hidden eco_context_trampoline\n"
+	".type eco_context_trampoline,%function\n"
+	".align 4\n"
+	"eco_context_trampoline:\n"
+	"	mov x0, x19\n"
+	"	blr x20\n"
+	"	brk #0\n"
+	".size eco_context_trampoline,.-eco_context_trampoline\n"
+	".section .note.GNU-stack,\"\",%progbits\n"
+	".text\n"
+);
+
+#define FRAME_SIZE 160
+
+#endif
+
+#endif //!ECO_UCONTEXT
+
+namespace efc {
+namespace eco {
+
+static int pageSize() {
+	static int size = 0;
+	if (size == 0) {
+		long n = ::sysconf(_SC_PAGESIZE);
+		size = (n > 0) ? (int)n : 4096;
+	}
+	return size;
+}
+
+EContext::~EContext() {
+	if (map_) {
+		::munmap(map_, mapSize_);
+	}
+}
+
+EContext::EContext() : sp_(null), map_(null), mapSize_(0), stackSize_(0) {
+}
+
+EContext::EContext(int stackSize, boolean guard) : sp_(null), map_(null), mapSize_(0), stackSize_(0) {
+	int page = pageSize();
+	stackSize_ = ((ES_MAX(stackSize, page) + page - 1) / page) * page;
+	mapSize_ = stackSize_ + (guard ? page : 0);
+
+	void* p = ::mmap(NULL, mapSize_, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (p == MAP_FAILED) {
+		throw EOutOfMemoryError(__FILE__, __LINE__, "fiber stack");
+	}
+	map_ = (char*)p;
+	if (guard && ::mprotect(map_, page, PROT_NONE) != 0) {
+		::munmap(map_, mapSize_);
+		map_ = null;
+		throw EOutOfMemoryError(__FILE__, __LINE__, "fiber stack guard");
+	}
+}
+
+#ifndef ECO_UCONTEXT
+
+void EContext::reset(entry_t entry, void* arg) {
+	ES_ASSERT(map_);
+
+	void** frame = (void**)(map_ + mapSize_ - FRAME_SIZE);
+	eso_memset(frame, 0, FRAME_SIZE);
+#if defined(__x86_64__)
+	// default mxcsr and x87 control word
+	frame[0] = (void*)(((es_uint64_t)0x037F << 32) | 0x1F80);
+	frame[3] = (void*)entry; //r13
+	frame[4] = arg;          //r12
+	frame[7] = (void*)eco_context_trampoline;
+#elif defined(__aarch64__)
+	frame[0] = arg;          //x19
+	frame[1] = (void*)entry; //x20
+	frame[11] = (void*)eco_context_trampoline; //x30
+#endif
+	sp_ = frame;
+}
+
+void EContext::swap(EContext* to) {
+	eco_swap_context(&sp_, to->sp_);
+}
+
+#else //ECO_UCONTEXT
+
+/*
+ * makecontext() only passes int arguments, so entry and arg are kept at
+ * the top of the stack and the trampoline gets their address in halves.
+ */
+static void ucontextEntry(int hi, int lo) {
+	void** slot = (void**)(((es_uint64_t)(unsigned)hi << 32) | (unsigned)lo);
+	((EContext::entry_t)slot[0])(slot[1]);
+}
+
+void EContext::reset(entry_t entry, void* arg) {
+	ES_ASSERT(map_);
+
+	void** slot = (void**)(map_ + mapSize_ - 2 * sizeof(void*));
+	slot[0] = (void*)entry;
+	slot[1] = arg;
+	sp_ = slot;
+
+	::getcontext(&uc_);
+	uc_.uc_stack.ss_sp = map_ + mapSize_ - stackSize_;
+	uc_.uc_stack.ss_size = stackSize_ - 4 * sizeof(void*);
+	uc_.uc_link = NULL;
+	es_uint64_t p = (es_uint64_t)slot;
+	::makecontext(&uc_, (void (*)())ucontextEntry, 2, (int)(p >> 32), (int)(p & 0xFFFFFFFF));
+}
+
+void EContext::swap(EContext* to) {
+	::swapcontext(&uc_, &to->uc_);
+}
+
+#endif //!ECO_UCONTEXT
+
+int EContext::getStackSize() {
+	return stackSize_;
+}
+
+} /* namespace eco */
+} /* namespace efc */
+
+#endif //!WIN32
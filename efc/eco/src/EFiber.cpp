@@ -0,0 +1,191 @@
+/*
+ * EFiber.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../inc/EFiber.hh"
+#include "../inc/EFiberWorker.hh"
+
+namespace efc {
+namespace eco {
+
+static volatile es_int64_t fiberSequence = 0;
+
+EFiber::~EFiber() {
+	//
+}
+
+EFiber::EFiber(int stackSize) {
+	init(stackSize);
+}
+
+EFiber::EFiber(sp<ERunnable> target, int stackSize) : target_(target) {
+	init(stackSize);
+}
+
+#ifdef CPP11_SUPPORT
+EFiber::EFiber(std::function<void()> func, int stackSize) : target_(new ERunnableTarget(func)) {
+	init(stackSize);
+}
+#endif
+
+void EFiber::init(int stackSize) {
+	id_ = eso_atomic_add_and_fetch64(&fiberSequence, 1);
+	stackSize_ = (stackSize > 0) ? stackSize : DEFAULT_STACK_SIZE;
+	state_ = NEW;
+	scheduler_ = null;
+	worker_ = null;
+	context_ = null;
+	next_ = null;
+	waiting_ = 0;
+	permit_ = 0;
+	wakeReason_ = 0;
+	timerIndex_ = -1;
+	yielded_ = false;
+	lockPrev_ = null;
+	lockNext_ = null;
+	lockSeen_ = 0;
+}
+
+void EFiber::run() {
+	if (target_ != null) {
+		target_->run();
+	}
+}
+
+llong EFiber::getId() {
+	return id_;
+}
+
+void EFiber::setName(const char* name) {
+	name_ = name;
+}
+
+const char* EFiber::getName() {
+	if (name_.isEmpty()) {
+		name_ = EStringBase::formatOf("Fiber-%lld", id_);
+	}
+	return name_.c_str();
+}
+
+EFiber::State EFiber::getState() {
+	return (State)state_;
+}
+
+boolean EFiber::isAlive() {
+	int s = state_;
+	return s != NEW && s != TERMINATED;
+}
+
+EFiberScheduler* EFiber::getScheduler() {
+	return scheduler_;
+}
+
+EStringBase EFiber::toString() {
+	return EStringBase::formatOf("Fiber[%lld,%s]", id_, getName());
+}
+
+#ifndef WIN32
+
+void EFiber::unpark() {
+	if (eso_atomic_test_and_set32(&permit_, 1) == 0 && worker_ != null) {
+		EFiberWorker::wakeup(this, EFiberWorker::WAKE_SIGNAL);
+	}
+}
+
+EFiber* EFiber::currentFiber() {
+	EFiberWorker* worker = EFiberWorker::current();
+	return worker ? worker->running() : null;
+}
+
+void EFiber::yield() {
+	EFiberWorker* worker = EFiberWorker::current();
+	if (worker && worker->running()) {
+		worker->yieldRunning();
+	} else {
+		EThread::yield();
+	}
+}
+
+void EFiber::sleep(llong millis) {
+	EFiber* fiber = currentFiber();
+	if (!fiber) {
+		EThread::sleep(millis);
+		return;
+	}
+	if (millis <= 0) {
+		yield();
+		return;
+	}
+
+	fiber->worker_->sleepRunning(millis * 1000000LL);
+}
+
+void EFiber::parkCurrent(llong nanos) {
+	EFiber* fiber = currentFiber();
+	if (!fiber) {
+		if (nanos < 0) {
+			ELockSupport::park();
+		} else {
+			ELockSupport::parkNanos(nanos);
+		}
+		return;
+	}
+
+	if (eso_atomic_test_and_set32(&fiber->permit_, 0) == 1) {
+		return;
+	}
+
+	// publish the wait before the last look at the permit; unpark()
+	// sets the permit before trying to wake.
+	eso_atomic_test_and_set32(&fiber->waiting_, 1);
+	if (fiber->permit_ == 1 && eso_atomic_compare_and_swap32(&fiber->waiting_, 1, 0)) {
+		fiber->permit_ = 0;
+		return;
+	}
+	fiber->worker_->suspend(nanos);
+	eso_atomic_test_and_set32(&fiber->permit_, 0);
+}
+
+#else //!
+
+void EFiber::unpark() {
+	eso_atomic_test_and_set32(&permit_, 1);
+}
+
+EFiber* EFiber::currentFiber() {
+	return null;
+}
+
+void EFiber::yield() {
+	EThread::yield();
+}
+
+void EFiber::sleep(llong millis) {
+	EThread::sleep(millis);
+}
+
+void EFiber::parkCurrent(llong nanos) {
+	if (nanos < 0) {
+		ELockSupport::park();
+	} else {
+		ELockSupport::parkNanos(nanos);
+	}
+}
+
+#endif //!WIN32
+
+void EFiber::park() {
+	parkCurrent(-1);
+}
+
+void EFiber::parkNanos(llong nanos) {
+	if (nanos > 0) {
+		parkCurrent(nanos);
+	}
+}
+
+} /* namespace eco */
+} /* namespace efc */
@@ -0,0 +1,128 @@
+/*
+ * EFiberScheduler.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../inc/EFiberScheduler.hh"
+#include "../inc/EFiberWorker.hh"
+#include "../inc/EHooker.hh"
+
+#ifndef WIN32
+
+namespace efc {
+namespace eco {
+
+static volatile int schedulerSequence = 0;
+
+EFiberScheduler::~EFiberScheduler() {
+	join();
+	for (int i = 0; i < threads_; i++) {
+		delete workers_[i];
+	}
+	delete[] workers_;
+}
+
+EFiberScheduler::EFiberScheduler(int threads) :
+		next_(-1), live_(0), started_(0), joined_(0), stackGuard_(true) {
+	EHooker::init();
+
+	if (threads <= 0) {
+		threads = ERuntime::getRuntime()->availableProcessors();
+	}
+	threads_ = threads;
+
+	int number = eso_atomic_add_and_fetch32(&schedulerSequence, 1);
+	workers_ = new EFiberWorker*[threads_];
+	for (int i = 0; i < threads_; i++) {
+		workers_[i] = new EFiberWorker(this);
+		workers_[i]->setName(EStringBase::formatOf("FiberScheduler-%d-carrier-%d", number, i + 1).c_str());
+	}
+}
+
+void EFiberScheduler::setStackGuard(boolean on) {
+	stackGuard_ = on;
+}
+
+void EFiberScheduler::start() {
+	if (started_ == 0 && eso_atomic_compare_and_swap32(&started_, 0, 1)) {
+		for (int i = 0; i < threads_; i++) {
+			workers_[i]->start();
+		}
+	}
+}
+
+void EFiberScheduler::schedule(sp<EFiber> fiber) {
+	if (!eso_atomic_compare_and_swap32(&fiber->state_, EFiber::NEW, EFiber::RUNNABLE)) {
+		throw EIllegalStateException(__FILE__, __LINE__, "Fiber has been scheduled.");
+	}
+	// after join() only fibers of this scheduler may add more, which
+	// keeps the live count from coming back from zero.
+	if (eso_atomic_add_and_fetch32(&live_, 1) == 1 && joined_) {
+		fiberTerminated();
+		fiber->state_ = EFiber::NEW;
+		throw EIllegalStateException(__FILE__, __LINE__, "Scheduler has been joined.");
+	}
+
+	int n = eso_atomic_add_and_fetch32(&next_, 1) & 0x7fffffff;
+	EFiberWorker* worker = workers_[n % threads_];
+	fiber->scheduler_ = this;
+	fiber->worker_ = worker;
+	fiber->self_ = fiber;
+
+	start();
+	worker->submit(fiber.get());
+}
+
+sp<EFiber> EFiberScheduler::schedule(sp<ERunnable> task, int stackSize) {
+	sp<EFiber> fiber = new EFiber(task, stackSize);
+	schedule(fiber);
+	return fiber;
+}
+
+void EFiberScheduler::join() {
+	if (currentScheduler() == this) {
+		throw EIllegalStateException(__FILE__, __LINE__, "Join from own fiber.");
+	}
+
+	eso_atomic_test_and_set32(&joined_, 1);
+	eso_atomic_compare_and_swap32(&started_, 0, 2); //never start now
+	if (started_ != 1) {
+		return;
+	}
+	if (live_ == 0) {
+		for (int i = 0; i < threads_; i++) {
+			workers_[i]->signal();
+		}
+	}
+	for (int i = 0; i < threads_; i++) {
+		workers_[i]->join();
+	}
+}
+
+void EFiberScheduler::fiberTerminated() {
+	if (eso_atomic_sub_and_fetch32(&live_, 1) == 0 && joined_) {
+		for (int i = 0; i < threads_; i++) {
+			workers_[i]->signal();
+		}
+	}
+}
+
+int EFiberScheduler::getThreads() {
+	return threads_;
+}
+
+int EFiberScheduler::getFiberCount() {
+	return live_;
+}
+
+EFiberScheduler* EFiberScheduler::currentScheduler() {
+	EFiber* fiber = EFiber::currentFiber();
+	return fiber ? fiber->scheduler_ : null;
+}
+
+} /* namespace eco */
+} /* namespace efc */
+
+#endif //!WIN32
@@ -0,0 +1,717 @@
+/*
+ * EFiberWorker.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../inc/EFiberWorker.hh"
+
+#ifndef WIN32
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#ifdef __linux__
+#define ECO_EPOLL
+#include <sys/epoll.h>
+#endif
+
+namespace efc {
+namespace eco {
+
+#define MAX_EVENTS        256
+#define MAX_CACHED_STACKS 128
+#define CLOSE_BUCKETS     256
+
+#ifdef CPP11_SUPPORT
+static THREAD_TLS EFiberWorker* currentWorker;
+#else
+static __thread EFiberWorker* currentWorker;
+#endif
+
+static volatile int runningCarriers = 0;
+
+/*
+ * The waits of all carriers, hashed by descriptor, so that close() on
+ * any thread finds the fibers to wake.
+ */
+static struct {
+	volatile int lock;
+	void* head;
+} closeBuckets[CLOSE_BUCKETS];
+
+static inline void spinLock(volatile int* lock) {
+	while (!eso_atomic_compare_and_swap32(lock, 0, 1)) {
+		EThread::yield();
+	}
+}
+
+static inline void spinUnlock(volatile int* lock) {
+	eso_atomic_test_and_set32(lock, 0);
+}
+
+EFiberWorker::~EFiberWorker() {
+	for (int i = 0; i < stackCount_; i++) {
+		delete stacks_[i];
+	}
+	eso_free(stacks_);
+	eso_free(timers_);
+	eso_free(deadlines_);
+	eso_free(slots_);
+	eso_free(actives_);
+	if (pollFd_ >= 0) {
+		::close(pollFd_);
+	}
+	::close(wakeFds_[0]);
+	::close(wakeFds_[1]);
+}
+
+EFiberWorker::EFiberWorker(EFiberScheduler* scheduler) :
+		scheduler_(scheduler), running_(null),
+		runHead_(null), runTail_(null), runCount_(0), inbound_(null),
+		polling_(0), signalled_(0), pollFd_(-1),
+		slots_(null), slotCount_(0), actives_(null), activeCount_(0),
+		timers_(null), deadlines_(null), timerCount_(0), timerCapacity_(0),
+		stacks_(null), stackCount_(0),
+		lockParked_(null), lockParkedLock_(0), lockUnparks_(0) {
+	if (::pipe(wakeFds_) != 0) {
+		throw EIllegalStateException(__FILE__, __LINE__, "pipe");
+	}
+	for (int i = 0; i < 2; i++) {
+		::fcntl(wakeFds_[i], F_SETFL, ::fcntl(wakeFds_[i], F_GETFL) | O_NONBLOCK);
+		::fcntl(wakeFds_[i], F_SETFD, FD_CLOEXEC);
+	}
+#ifdef ECO_EPOLL
+	pollFd_ = ::epoll_create(1024);
+	if (pollFd_ < 0) {
+		::close(wakeFds_[0]);
+		::close(wakeFds_[1]);
+		throw EIllegalStateException(__FILE__, __LINE__, "epoll_create");
+	}
+	::fcntl(pollFd_, F_SETFD, FD_CLOEXEC);
+	struct epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.fd = wakeFds_[0];
+	::epoll_ctl(pollFd_, EPOLL_CTL_ADD, wakeFds_[0], &ev);
+#endif
+	stacks_ = (EContext**)eso_malloc(sizeof(EContext*) * MAX_CACHED_STACKS);
+}
+
+EFiberWorker* EFiberWorker::current() {
+	return currentWorker;
+}
+
+EFiber* EFiberWorker::running() {
+	return running_;
+}
+
+EFiberWorker* EFiberWorker::carrierOf(EThread* thread) {
+	if (runningCarriers == 0 || thread == null) {
+		return null;
+	}
+	return dynamic_cast<EFiberWorker*>(thread);
+}
+
+void EFiberWorker::run() {
+	currentWorker = this;
+	eso_atomic_add_and_fetch32(&runningCarriers, 1);
+
+	for (;;) {
+		drainInbound();
+
+		// one round over what is runnable now, so that descriptors and
+		// timers are looked at between rounds even under full load.
+		for (int n = runCount_; n > 0 && runHead_ != null; n--) {
+			resume(popRun());
+		}
+
+		if (scheduler_->joined_ && scheduler_->live_ == 0) {
+			break;
+		}
+
+		llong timeout = -1;
+		if (runHead_ != null) {
+			timeout = 0;
+		} else if (timerCount_ > 0) {
+			timeout = ES_MAX(deadlines_[0] - ESystem::nanoTime(), 0);
+		}
+		pollIo(timeout);
+		expireTimers();
+	}
+
+	eso_atomic_sub_and_fetch32(&runningCarriers, 1);
+	currentWorker = null;
+}
+
+//=============================================================================
+// run queue
+
+void EFiberWorker::pushRun(EFiber* fiber) {
+	fiber->next_ = null;
+	if (runTail_ == null) {
+		runHead_ = fiber;
+	} else {
+		runTail_->next_ = fiber;
+	}
+	runTail_ = fiber;
+	runCount_++;
+}
+
+EFiber* EFiberWorker::popRun() {
+	EFiber* fiber = runHead_;
+	runHead_ = fiber->next_;
+	if (runHead_ == null) {
+		runTail_ = null;
+	}
+	fiber->next_ = null;
+	runCount_--;
+	return fiber;
+}
+
+void EFiberWorker::submit(EFiber* fiber) {
+	EFiber* head;
+	do {
+		head = inbound_;
+		fiber->next_ = head;
+	} while (!eso_atomic_compare_and_swapptr((void* volatile*)&inbound_, head, fiber));
+
+	if (polling_) {
+		signal();
+	}
+}
+
+void EFiberWorker::signal() {
+	if (eso_atomic_compare_and_swap32(&signalled_, 0, 1)) {
+		char c = 0;
+		(void)::write(wakeFds_[1], &c, 1);
+	}
+}
+
+void EFiberWorker::drainInbound() {
+	if (inbound_ == null) {
+		return;
+	}
+	EFiber* list = (EFiber*)eso_atomic_test_and_setptr((es_intptr_t*)&inbound_, null);
+
+	// pushed LIFO; reverse to keep submission order.
+	EFiber* prev = null;
+	while (list != null) {
+		EFiber* next = list->next_;
+		list->next_ = prev;
+		prev = list;
+		list = next;
+	}
+	while (prev != null) {
+		EFiber* next = prev->next_;
+		pushRun(prev);
+		prev = next;
+	}
+}
+
+//=============================================================================
+// switching
+
+void EFiberWorker::fiberEntry(void* arg) {
+	EFiber* fiber = (EFiber*)arg;
+	try {
+		fiber->run();
+	} catch (EThrowable& t) {
+		t.printStackTrace();
+	} catch (...) {
+	}
+	fiber->state_ = EFiber::TERMINATED;
+	fiber->context_->swap(&fiber->worker_->mainContext_);
+	// never resumed.
+}
+
+void EFiberWorker::resume(EFiber* fiber) {
+	if (fiber->context_ == null) {
+		fiber->context_ = newContext(fiber->stackSize_);
+		fiber->context_->reset(fiberEntry, fiber);
+		fiber->lockSeen_ = lockUnparks_;
+	}
+
+	running_ = fiber;
+	fiber->state_ = EFiber::RUNNABLE;
+	mainContext_.swap(fiber->context_);
+	running_ = null;
+
+	if (fiber->state_ == EFiber::TERMINATED) {
+		freeContext(fiber->context_);
+		fiber->context_ = null;
+		if (fiber->timerIndex_ >= 0) {
+			removeTimer(fiber->timerIndex_);
+		}
+		sp<EFiber> self = fiber->self_;
+		fiber->self_ = null;
+		scheduler_->fiberTerminated();
+	} else if (fiber->yielded_) {
+		fiber->yielded_ = false;
+		pushRun(fiber);
+	}
+}
+
+boolean EFiberWorker::wakeup(EFiber* fiber, int reason) {
+	if (!eso_atomic_compare_and_swap32(&fiber->waiting_, 1, 0)) {
+		return false;
+	}
+	fiber->wakeReason_ = reason;
+	EFiberWorker* worker = fiber->worker_;
+	if (worker == currentWorker) {
+		worker->pushRun(fiber);
+	} else {
+		worker->submit(fiber);
+	}
+	return true;
+}
+
+int EFiberWorker::suspend(llong timeoutNanos) {
+	EFiber* fiber = running_;
+	ES_ASSERT(fiber);
+
+	if (timeoutNanos >= 0) {
+		addTimer(fiber, ESystem::nanoTime() + timeoutNanos);
+	}
+	fiber->state_ = EFiber::WAITING;
+	fiber->context_->swap(&mainContext_);
+
+	if (fiber->timerIndex_ >= 0) {
+		removeTimer(fiber->timerIndex_);
+	}
+	return fiber->wakeReason_;
+}
+
+void EFiberWorker::sleepRunning(llong nanos) {
+	EFiber* fiber = running_;
+	ES_ASSERT(fiber);
+
+	llong deadline = ESystem::nanoTime() + nanos;
+	while ((nanos = deadline - ESystem::nanoTime()) > 0) {
+		fiber->waiting_ = 1;
+		suspend(nanos);
+	}
+}
+
+void EFiberWorker::yieldRunning() {
+	EFiber* fiber = running_;
+	ES_ASSERT(fiber);
+
+	fiber->yielded_ = true;
+	fiber->context_->swap(&mainContext_);
+}
+
+EContext* EFiberWorker::newContext(int stackSize) {
+	if (stackCount_ > 0 && stacks_[stackCount_ - 1]->getStackSize() >= stackSize) {
+		return stacks_[--stackCount_];
+	}
+	return new EContext(stackSize, scheduler_->stackGuard_);
+}
+
+void EFiberWorker::freeContext(EContext* context) {
+	if (stackCount_ < MAX_CACHED_STACKS) {
+		stacks_[stackCount_++] = context;
+	} else {
+		delete context;
+	}
+}
+
+//=============================================================================
+// ELockSupport
+
+void EFiberWorker::lockPark(llong nanos) {
+	EFiber* fiber = running_;
+	ES_ASSERT(fiber);
+
+	spinLock(&lockParkedLock_);
+	fiber->lockPrev_ = null;
+	fiber->lockNext_ = lockParked_;
+	if (lockParked_) {
+		lockParked_->lockPrev_ = fiber;
+	}
+	lockParked_ = fiber;
+	spinUnlock(&lockParkedLock_);
+
+	// listed before the look at the count; lockUnpark() counts before
+	// it walks the list, so one of the two sees the other.
+	if (lockUnparks_ == fiber->lockSeen_) {
+		EFiber::parkCurrent(nanos);
+	}
+
+	spinLock(&lockParkedLock_);
+	if (fiber->lockPrev_) {
+		fiber->lockPrev_->lockNext_ = fiber->lockNext_;
+	} else {
+		lockParked_ = fiber->lockNext_;
+	}
+	if (fiber->lockNext_) {
+		fiber->lockNext_->lockPrev_ = fiber->lockPrev_;
+	}
+	spinUnlock(&lockParkedLock_);
+	fiber->lockSeen_ = lockUnparks_;
+}
+
+void EFiberWorker::lockUnpark() {
+	eso_atomic_add_and_fetch32(&lockUnparks_, 1);
+	spinLock(&lockParkedLock_);
+	for (EFiber* fiber = lockParked_; fiber != null; fiber = fiber->lockNext_) {
+		fiber->unpark();
+	}
+	spinUnlock(&lockParkedLock_);
+}
+
+//=============================================================================
+// descriptors
+
+EFiberWorker::IoSlot* EFiberWorker::slot(int fd) {
+	if (fd >= slotCount_) {
+		int n = ES_MAX(fd + 1, slotCount_ * 2);
+		n = ES_MAX(n, 64);
+		slots_ = (IoSlot*)eso_realloc(slots_, sizeof(IoSlot) * n);
+		for (int i = slotCount_; i < n; i++) {
+			slots_[i].waiters = null;
+			slots_[i].added = false;
+			slots_[i].active = -1;
+		}
+		slotCount_ = n;
+	}
+	return &slots_[fd];
+}
+
+int EFiberWorker::waitIo(struct pollfd* fds, int nfds, llong timeoutNanos) {
+	EFiber* fiber = running_;
+	ES_ASSERT(fiber);
+
+	IoWait local[4];
+	IoWait* waits = (nfds <= 4) ? local : (IoWait*)eso_malloc(sizeof(IoWait) * nfds);
+
+	fiber->waiting_ = 1;
+	fiber->wakeReason_ = WAKE_SIGNAL;
+	int armed = 0;
+	for (int i = 0; i < nfds; i++) {
+		waits[i].fiber = fiber;
+		waits[i].fd = fds[i].fd;
+		waits[i].events = fds[i].events;
+		waits[i].next = null;
+		waits[i].closed = false;
+		if (fds[i].fd >= 0 && arm(&waits[i])) {
+			watch(&waits[i]);
+			armed++;
+		} else {
+			waits[i].fd = -1;
+		}
+	}
+
+	int reason = -1;
+	if (armed > 0) {
+		reason = suspend(timeoutNanos);
+	} else {
+		fiber->waiting_ = 0;
+	}
+
+	for (int i = 0; i < nfds; i++) {
+		if (waits[i].fd >= 0) {
+			unwatch(&waits[i]);
+			disarm(&waits[i]);
+			if (waits[i].closed) {
+				fds[i].revents = POLLNVAL;
+			}
+		}
+	}
+	if (waits != local) {
+		eso_free(waits);
+	}
+	return reason;
+}
+
+void EFiberWorker::watch(IoWait* w) {
+	int b = w->fd & (CLOSE_BUCKETS - 1);
+	spinLock(&closeBuckets[b].lock);
+	IoWait* head = (IoWait*)closeBuckets[b].head;
+	w->prevFd = null;
+	w->nextFd = head;
+	if (head) {
+		head->prevFd = w;
+	}
+	closeBuckets[b].head = w;
+	spinUnlock(&closeBuckets[b].lock);
+}
+
+void EFiberWorker::unwatch(IoWait* w) {
+	int b = w->fd & (CLOSE_BUCKETS - 1);
+	spinLock(&closeBuckets[b].lock);
+	if (w->prevFd) {
+		w->prevFd->nextFd = w->nextFd;
+	} else {
+		closeBuckets[b].head = w->nextFd;
+	}
+	if (w->nextFd) {
+		w->nextFd->prevFd = w->prevFd;
+	}
+	spinUnlock(&closeBuckets[b].lock);
+}
+
+void EFiberWorker::closing(int fd) {
+	if (fd < 0) {
+		return;
+	}
+	int b = fd & (CLOSE_BUCKETS - 1);
+	if (closeBuckets[b].head == null) {
+		return;
+	}
+	// the waits stay on their fibers' stacks until unwatch() took them
+	// out under the same lock.
+	spinLock(&closeBuckets[b].lock);
+	for (IoWait* w = (IoWait*)closeBuckets[b].head; w != null; w = w->nextFd) {
+		if (w->fd == fd) {
+			w->closed = true;
+			wakeup(w->fiber, WAKE_CLOSED);
+		}
+	}
+	spinUnlock(&closeBuckets[b].lock);
+}
+
+boolean EFiberWorker::arm(IoWait* w) {
+	IoSlot* s = slot(w->fd);
+	w->next = s->waiters;
+	s->waiters = w;
+
+#ifdef ECO_EPOLL
+	struct epoll_event ev;
+	ev.events = EPOLLONESHOT;
+	for (IoWait* p = s->waiters; p != null; p = p->next) {
+		if (p->events & POLLIN) ev.events |= EPOLLIN;
+		if (p->events & POLLPRI) ev.events |= EPOLLPRI;
+		if (p->events & POLLOUT) ev.events |= EPOLLOUT;
+	}
+	ev.data.fd = w->fd;
+	int r = ::epoll_ctl(pollFd_, s->added ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, w->fd, &ev);
+	if (r != 0 && errno == ENOENT) {
+		r = ::epoll_ctl(pollFd_, EPOLL_CTL_ADD, w->fd, &ev);
+	} else if (r != 0 && errno == EEXIST) {
+		r = ::epoll_ctl(pollFd_, EPOLL_CTL_MOD, w->fd, &ev);
+	}
+	if (r != 0) {
+		s->waiters = w->next;
+		return false;
+	}
+	s->added = true;
+#else
+	if (s->active < 0) {
+		actives_ = (int*)eso_realloc(actives_, sizeof(int) * (activeCount_ + 1));
+		s->active = activeCount_;
+		actives_[activeCount_++] = w->fd;
+	}
+#endif
+	return true;
+}
+
+void EFiberWorker::disarm(IoWait* w) {
+	IoSlot* s = &slots_[w->fd];
+	for (IoWait** pp = &s->waiters; *pp != null; pp = &(*pp)->next) {
+		if (*pp == w) {
+			*pp = w->next;
+			break;
+		}
+	}
+	// epoll: a oneshot registration left behind fires at most once more
+	// and finds nobody to wake.
+#ifndef ECO_EPOLL
+	if (s->waiters == null && s->active >= 0) {
+		int last = actives_[--activeCount_];
+		actives_[s->active] = last;
+		slots_[last].active = s->active;
+		s->active = -1;
+	}
+#endif
+}
+
+void EFiberWorker::dispatch(int fd, int revents) {
+	if (fd >= slotCount_) {
+		return;
+	}
+	IoSlot* s = &slots_[fd];
+	boolean rest = false;
+	for (IoWait* w = s->waiters; w != null; w = w->next) {
+		if ((w->events & revents) || (revents & (POLLERR | POLLHUP | POLLNVAL))) {
+			wakeup(w->fiber, WAKE_SIGNAL);
+		} else if (w->fiber->waiting_) {
+			rest = true;
+		}
+	}
+#ifdef ECO_EPOLL
+	// the oneshot registration is spent; re-arm for those still waiting.
+	if (rest) {
+		rearm(fd);
+	}
+#endif
+}
+
+void EFiberWorker::rearm(int fd) {
+#ifdef ECO_EPOLL
+	struct epoll_event ev;
+	ev.events = EPOLLONESHOT;
+	for (IoWait* p = slots_[fd].waiters; p != null; p = p->next) {
+		if (!p->fiber->waiting_) continue;
+		if (p->events & POLLIN) ev.events |= EPOLLIN;
+		if (p->events & POLLPRI) ev.events |= EPOLLPRI;
+		if (p->events & POLLOUT) ev.events |= EPOLLOUT;
+	}
+	ev.data.fd = fd;
+	::epoll_ctl(pollFd_, EPOLL_CTL_MOD, fd, &ev);
+#endif
+}
+
+void EFiberWorker::pollIo(llong timeoutNanos) {
+	int ms = (timeoutNanos < 0) ? -1 : (int)ES_MIN((timeoutNanos + 999999) / 1000000, 0x7fffffff);
+	if (ms != 0) {
+		// announce the sleep before the last look at the inbound list;
+		// submit() checks polling_ after publishing.
+		eso_atomic_test_and_set32(&polling_, 1);
+		if (inbound_ != null) {
+			ms = 0;
+		}
+	}
+
+#ifdef ECO_EPOLL
+	struct epoll_event events[MAX_EVENTS];
+	int n = ::epoll_wait(pollFd_, events, MAX_EVENTS, ms);
+	polling_ = 0;
+	for (int i = 0; i < n; i++) {
+		int fd = events[i].data.fd;
+		if (fd == wakeFds_[0]) {
+			char buf[64];
+			while (::read(fd, buf, sizeof(buf)) > 0) {
+			}
+			signalled_ = 0;
+			continue;
+		}
+		int ev = events[i].events;
+		int revents = 0;
+		if (ev & EPOLLIN) revents |= POLLIN;
+		if (ev & EPOLLPRI) revents |= POLLPRI;
+		if (ev & EPOLLOUT) revents |= POLLOUT;
+		if (ev & EPOLLERR) revents |= POLLERR;
+		if (ev & EPOLLHUP) revents |= POLLHUP;
+		dispatch(fd, revents);
+	}
+#else
+	struct pollfd local[64];
+	int nfds = activeCount_ + 1;
+	struct pollfd* pfds = (nfds <= 64) ? local : (struct pollfd*)eso_malloc(sizeof(struct pollfd) * nfds);
+	pfds[0].fd = wakeFds_[0];
+	pfds[0].events = POLLIN;
+	pfds[0].revents = 0;
+	for (int i = 0; i < activeCount_; i++) {
+		int fd = actives_[i];
+		short events = 0;
+		for (IoWait* p = slots_[fd].waiters; p != null; p = p->next) {
+			events |= p->events;
+		}
+		pfds[i + 1].fd = fd;
+		pfds[i + 1].events = events;
+		pfds[i + 1].revents = 0;
+	}
+	int n = ::poll(pfds, nfds, ms);
+	polling_ = 0;
+	if (n > 0) {
+		if (pfds[0].revents) {
+			char buf[64];
+			while (::read(wakeFds_[0], buf, sizeof(buf)) > 0) {
+			}
+			signalled_ = 0;
+		}
+		for (int i = 1; i < nfds; i++) {
+			if (pfds[i].revents) {
+				dispatch(pfds[i].fd, pfds[i].revents);
+			}
+		}
+	}
+	if (pfds != local) {
+		eso_free(pfds);
+	}
+#endif
+}
+
+//=============================================================================
+// timers
+
+void EFiberWorker::addTimer(EFiber* fiber, llong deadline) {
+	if (timerCount_ == timerCapacity_) {
+		timerCapacity_ = ES_MAX(timerCapacity_ * 2, 64);
+		timers_ = (EFiber**)eso_realloc(timers_, sizeof(EFiber*) * timerCapacity_);
+		deadlines_ = (llong*)eso_realloc(deadlines_, sizeof(llong) * timerCapacity_);
+	}
+	int i = timerCount_++;
+	timers_[i] = fiber;
+	deadlines_[i] = deadline;
+	fiber->timerIndex_ = i;
+	siftUp(i);
+}
+
+void EFiberWorker::removeTimer(int index) {
+	timers_[index]->timerIndex_ = -1;
+	int last = --timerCount_;
+	if (index != last) {
+		timers_[index] = timers_[last];
+		deadlines_[index] = deadlines_[last];
+		timers_[index]->timerIndex_ = index;
+		siftDown(index);
+		siftUp(index);
+	}
+}
+
+void EFiberWorker::siftUp(int index) {
+	EFiber* f = timers_[index];
+	llong d = deadlines_[index];
+	while (index > 0) {
+		int parent = (index - 1) >> 1;
+		if (deadlines_[parent] <= d) break;
+		timers_[index] = timers_[parent];
+		deadlines_[index] = deadlines_[parent];
+		timers_[index]->timerIndex_ = index;
+		index = parent;
+	}
+	timers_[index] = f;
+	deadlines_[index] = d;
+	f->timerIndex_ = index;
+}
+
+void EFiberWorker::siftDown(int index) {
+	EFiber* f = timers_[index];
+	llong d = deadlines_[index];
+	int half = timerCount_ >> 1;
+	while (index < half) {
+		int child = (index << 1) + 1;
+		int right = child + 1;
+		if (right < timerCount_ && deadlines_[right] < deadlines_[child]) {
+			child = right;
+		}
+		if (d <= deadlines_[child]) break;
+		timers_[index] = timers_[child];
+		deadlines_[index] = deadlines_[child];
+		timers_[index]->timerIndex_ = index;
+		index = child;
+	}
+	timers_[index] = f;
+	deadlines_[index] = d;
+	f->timerIndex_ = index;
+}
+
+void EFiberWorker::expireTimers() {
+	if (timerCount_ == 0) {
+		return;
+	}
+	llong now = ESystem::nanoTime();
+	while (timerCount_ > 0 && deadlines_[0] <= now) {
+		EFiber* fiber = timers_[0];
+		removeTimer(0);
+		wakeup(fiber, WAKE_TIMEOUT);
+	}
+}
+
+} /* namespace eco */
+} /* namespace efc */
+
+#endif //!WIN32
@@ -0,0 +1,588 @@
+/*
+ * EHooker.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "../inc/EHooker.hh"
+#include "../inc/EFiberWorker.hh"
+
+#ifndef WIN32
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+
+#ifndef __THROW
+#define __THROW
+#endif
+
+using namespace efc;
+using namespace efc::eco;
+
+typedef ssize_t (*read_t)(int, void*, size_t);
+typedef ssize_t (*readv_t)(int, const struct iovec*, int);
+typedef ssize_t (*recv_t)(int, void*, size_t, int);
+typedef ssize_t (*recvfrom_t)(int, void*, size_t, int, struct sockaddr*, socklen_t*);
+typedef ssize_t (*recvmsg_t)(int, struct msghdr*, int);
+typedef ssize_t (*write_t)(int, const void*, size_t);
+typedef ssize_t (*writev_t)(int, const struct iovec*, int);
+typedef ssize_t (*send_t)(int, const void*, size_t, int);
+typedef ssize_t (*sendto_t)(int, const void*, size_t, int, const struct sockaddr*, socklen_t);
+typedef ssize_t (*sendmsg_t)(int, const struct msghdr*, int);
+typedef int (*accept_t)(int, struct sockaddr*, socklen_t*);
+typedef int (*connect_t)(int, const struct sockaddr*, socklen_t);
+typedef int (*socket_t)(int, int, int);
+typedef int (*close_t)(int);
+typedef int (*poll_t)(struct pollfd*, nfds_t, int);
+typedef int (*fcntl_t)(int, int, ...);
+typedef int (*ioctl_t)(int, unsigned long, ...);
+typedef int (*setsockopt_t)(int, int, int, const void*, socklen_t);
+typedef int (*nanosleep_t)(const struct timespec*, struct timespec*);
+typedef int (*usleep_t)(useconds_t);
+typedef unsigned int (*sleep_t)(unsigned int);
+
+static read_t read_f;
+static readv_t readv_f;
+static recv_t recv_f;
+static recvfrom_t recvfrom_f;
+static recvmsg_t recvmsg_f;
+static write_t write_f;
+static writev_t writev_f;
+static send_t send_f;
+static sendto_t sendto_f;
+static sendmsg_t sendmsg_f;
+static accept_t accept_f;
+static connect_t connect_f;
+static socket_t socket_f;
+static close_t close_f;
+static poll_t poll_f;
+static fcntl_t fcntl_f;
+static ioctl_t ioctl_f;
+static setsockopt_t setsockopt_f;
+static nanosleep_t nanosleep_f;
+static usleep_t usleep_f;
+static sleep_t sleep_f;
+
+#define HOOK_SYS_FUNC(name) if (!name##_f) name##_f = (name##_t)dlsym(RTLD_NEXT, #name)
+
+//=============================================================================
+// descriptor state
+
+#define FD_INITED        0x01
+#define FD_SYS_NONBLOCK  0x02 //O_NONBLOCK set by us
+#define FD_USER_NONBLOCK 0x04 //O_NONBLOCK as the application sees it
+
+#define FD_CHUNK_BITS    10
+#define FD_CHUNK_SIZE    (1 << FD_CHUNK_BITS)
+#define FD_CHUNKS        1024
+
+struct FdContext {
+	volatile int flags;
+	int rcvTimeout; //ms, 0: none
+	int sndTimeout;
+};
+
+static FdContext* volatile fdChunks[FD_CHUNKS];
+
+static FdContext* fdGet(int fd, boolean create) {
+	if (fd < 0 || (fd >> FD_CHUNK_BITS) >= FD_CHUNKS) {
+		return null;
+	}
+	FdContext* volatile* chunk = &fdChunks[fd >> FD_CHUNK_BITS];
+	if (*chunk == null) {
+		if (!create) {
+			return null;
+		}
+		FdContext* c = (FdContext*)eso_calloc(sizeof(FdContext) * FD_CHUNK_SIZE);
+		if (!eso_atomic_compare_and_swapptr((void* volatile*)chunk, null, c)) {
+			eso_free(c);
+		}
+	}
+	return &(*chunk)[fd & (FD_CHUNK_SIZE - 1)];
+}
+
+static void fdReset(int fd) {
+	FdContext* c = fdGet(fd, false);
+	if (c) {
+		c->flags = 0;
+		c->rcvTimeout = 0;
+		c->sndTimeout = 0;
+	}
+}
+
+/*
+ * First use on a fiber: sockets and pipes the application keeps in
+ * blocking mode are switched to non-blocking underneath.
+ */
+static FdContext* fdInit(int fd) {
+	FdContext* c = fdGet(fd, true);
+	if (c == null || (c->flags & FD_INITED)) {
+		return c;
+	}
+	int flags = FD_INITED;
+	struct stat st;
+	if (::fstat(fd, &st) == 0 && (S_ISSOCK(st.st_mode) || S_ISFIFO(st.st_mode))) {
+		int fl = fcntl_f(fd, F_GETFL, 0);
+		if (fl >= 0) {
+			if (fl & O_NONBLOCK) {
+				flags |= FD_USER_NONBLOCK;
+			} else if (fcntl_f(fd, F_SETFL, fl | O_NONBLOCK) == 0) {
+				flags |= FD_SYS_NONBLOCK;
+			}
+		}
+	}
+	c->flags = flags;
+	return c;
+}
+
+/*
+ * Returns the state of a descriptor whose blocking calls have to be
+ * emulated, or null to call straight through: on a fiber that is every
+ * blocking socket or pipe, on a plain thread only those a fiber has
+ * already switched to non-blocking.
+ */
+static FdContext* fdHooked(int fd) {
+	EFiberWorker* worker = EFiberWorker::current();
+	FdContext* c = (worker && worker->running()) ? fdInit(fd) : fdGet(fd, false);
+	if (c && (c->flags & (FD_SYS_NONBLOCK | FD_USER_NONBLOCK)) == FD_SYS_NONBLOCK) {
+		return c;
+	}
+	return null;
+}
+
+static llong deadlineOf(int timeoutMillis) {
+	return (timeoutMillis > 0) ? ESystem::nanoTime() + timeoutMillis * 1000000LL : -1;
+}
+
+/*
+ * Waits until fd may be ready for events; false with errno set when the
+ * deadline has passed (EAGAIN) or fd was closed meanwhile (EBADF).
+ * Fibers wait on their carrier, threads in poll(2).
+ */
+static boolean waitFd(int fd, short events, llong deadline) {
+	llong remaining = -1;
+	if (deadline >= 0) {
+		remaining = deadline - ESystem::nanoTime();
+		if (remaining <= 0) {
+			errno = EAGAIN;
+			return false;
+		}
+	}
+
+	struct pollfd pfd;
+	pfd.fd = fd;
+	pfd.events = events;
+	pfd.revents = 0;
+
+	EFiberWorker* worker = EFiberWorker::current();
+	if (worker && worker->running()) {
+		int reason = worker->waitIo(&pfd, 1, remaining);
+		if (reason == EFiberWorker::WAKE_CLOSED) {
+			errno = EBADF;
+			return false;
+		}
+		if (reason >= 0) {
+			return true;
+		}
+	}
+	poll_f(&pfd, 1, (remaining < 0) ? -1 : (int)((remaining + 999999) / 1000000));
+	return true;
+}
+
+#define HOOK_IO(fd, events, timeoutField, call) do { \
+	FdContext* c = fdHooked(fd); \
+	if (!c) { \
+		return call; \
+	} \
+	llong deadline = deadlineOf(c->timeoutField); \
+	for (;;) { \
+		ssize_t r = call; \
+		if (r >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) { \
+			return r; \
+		} \
+		if (!waitFd(fd, events, deadline)) { \
+			return -1; \
+		} \
+	} \
+} while (0)
+
+/*
+ * A blocking write to a stream returns only once everything is written,
+ * unless a send timeout expires first.
+ */
+#define HOOK_WRITE(fd, buf, n, call) do { \
+	FdContext* c = fdHooked(fd); \
+	const char* p = (const char*)(buf); \
+	size_t left = (n); \
+	if (!c) { \
+		return call; \
+	} \
+	llong deadline = deadlineOf(c->sndTimeout); \
+	for (;;) { \
+		ssize_t r = call; \
+		if (r >= 0) { \
+			p += r; \
+			left -= r; \
+			if (left == 0 || r == 0) { \
+				return (ssize_t)((n) - left); \
+			} \
+		} else if (errno != EAGAIN && errno != EWOULDBLOCK) { \
+			return (left < (n)) ? (ssize_t)((n) - left) : r; \
+		} \
+		if (!waitFd(fd, POLLOUT, deadline)) { \
+			if (left < (n)) { \
+				return (ssize_t)((n) - left); \
+			} \
+			return -1; \
+		} \
+	} \
+} while (0)
+
+static void sleepNanos(llong nanos) {
+	EFiberWorker::current()->sleepRunning(nanos);
+}
+
+static boolean onFiber() {
+	EFiberWorker* worker = EFiberWorker::current();
+	return worker && worker->running();
+}
+
+namespace efc {
+namespace eco {
+
+void EHooker::init() {
+	HOOK_SYS_FUNC(read);
+	HOOK_SYS_FUNC(readv);
+	HOOK_SYS_FUNC(recv);
+	HOOK_SYS_FUNC(recvfrom);
+	HOOK_SYS_FUNC(recvmsg);
+	HOOK_SYS_FUNC(write);
+	HOOK_SYS_FUNC(writev);
+	HOOK_SYS_FUNC(send);
+	HOOK_SYS_FUNC(sendto);
+	HOOK_SYS_FUNC(sendmsg);
+	HOOK_SYS_FUNC(accept);
+	HOOK_SYS_FUNC(connect);
+	HOOK_SYS_FUNC(socket);
+	HOOK_SYS_FUNC(close);
+	HOOK_SYS_FUNC(poll);
+	HOOK_SYS_FUNC(fcntl);
+	HOOK_SYS_FUNC(ioctl);
+	HOOK_SYS_FUNC(setsockopt);
+	HOOK_SYS_FUNC(nanosleep);
+	HOOK_SYS_FUNC(usleep);
+	HOOK_SYS_FUNC(sleep);
+}
+
+} /* namespace eco */
+} /* namespace efc */
+
+//=============================================================================
+// hooks
+
+extern "C" {
+
+ssize_t read(int fd, void* buf, size_t n) {
+	HOOK_SYS_FUNC(read);
+	HOOK_IO(fd, POLLIN, rcvTimeout, read_f(fd, buf, n));
+}
+
+ssize_t readv(int fd, const struct iovec* iov, int iovcnt) {
+	HOOK_SYS_FUNC(readv);
+	HOOK_IO(fd, POLLIN, rcvTimeout, readv_f(fd, iov, iovcnt));
+}
+
+ssize_t recv(int fd, void* buf, size_t n, int flags) {
+	HOOK_SYS_FUNC(recv);
+	HOOK_IO(fd, POLLIN, rcvTimeout, recv_f(fd, buf, n, flags));
+}
+
+ssize_t recvfrom(int fd, void* buf, size_t n, int flags, struct sockaddr* addr, socklen_t* addrlen) {
+	HOOK_SYS_FUNC(recvfrom);
+	HOOK_IO(fd, POLLIN, rcvTimeout, recvfrom_f(fd, buf, n, flags, addr, addrlen));
+}
+
+ssize_t recvmsg(int fd, struct msghdr* msg, int flags) {
+	HOOK_SYS_FUNC(recvmsg);
+	HOOK_IO(fd, POLLIN, rcvTimeout, recvmsg_f(fd, msg, flags));
+}
+
+ssize_t write(int fd, const void* buf, size_t n) {
+	HOOK_SYS_FUNC(write);
+	HOOK_WRITE(fd, buf, n, write_f(fd, p, left));
+}
+
+ssize_t writev(int fd, const struct iovec* iov, int iovcnt) {
+	HOOK_SYS_FUNC(writev);
+	HOOK_IO(fd, POLLOUT, sndTimeout, writev_f(fd, iov, iovcnt));
+}
+
+ssize_t send(int fd, const void* buf, size_t n, int flags) {
+	HOOK_SYS_FUNC(send);
+	HOOK_WRITE(fd, buf, n, send_f(fd, p, left, flags));
+}
+
+ssize_t sendto(int fd, const void* buf, size_t n, int flags, const struct sockaddr* addr, socklen_t addrlen) {
+	HOOK_SYS_FUNC(sendto);
+	HOOK_WRITE(fd, buf, n, sendto_f(fd, p, left, flags, addr, addrlen));
+}
+
+ssize_t sendmsg(int fd, const struct msghdr* msg, int flags) {
+	HOOK_SYS_FUNC(sendmsg);
+	HOOK_IO(fd, POLLOUT, sndTimeout, sendmsg_f(fd, msg, flags));
+}
+
+static int acceptHooked(int fd, struct sockaddr* addr, socklen_t* addrlen) {
+	HOOK_IO(fd, POLLIN, rcvTimeout, accept_f(fd, addr, addrlen));
+}
+
+int accept(int fd, struct sockaddr* addr, socklen_t* addrlen) {
+	HOOK_SYS_FUNC(accept);
+	int r = acceptHooked(fd, addr, addrlen);
+	if (r >= 0) {
+		fdReset(r);
+	}
+	return r;
+}
+
+int connect(int fd, const struct sockaddr* addr, socklen_t addrlen) {
+	HOOK_SYS_FUNC(connect);
+	FdContext* c = fdHooked(fd);
+	int r = connect_f(fd, addr, addrlen);
+	if (!c || r == 0 || errno != EINPROGRESS) {
+		return r;
+	}
+
+	llong deadline = deadlineOf(c->sndTimeout);
+	struct pollfd pfd;
+	pfd.fd = fd;
+	pfd.events = POLLOUT;
+	do {
+		if (!waitFd(fd, POLLOUT, deadline)) {
+			if (errno == EAGAIN) {
+				errno = ETIMEDOUT;
+			}
+			return -1;
+		}
+		pfd.revents = 0;
+	} while (poll_f(&pfd, 1, 0) == 0);
+
+	int err = 0;
+	socklen_t len = sizeof(err);
+	if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0) {
+		return -1;
+	}
+	if (err != 0) {
+		errno = err;
+		return -1;
+	}
+	return 0;
+}
+
+int socket(int domain, int type, int protocol) __THROW {
+	HOOK_SYS_FUNC(socket);
+	int r = socket_f(domain, type, protocol);
+	if (r >= 0) {
+		fdReset(r);
+	}
+	return r;
+}
+
+int close(int fd) {
+	HOOK_SYS_FUNC(close);
+	// fibers blocked on fd would otherwise never hear of it: wake them
+	// with EBADF / POLLNVAL through their carriers first.
+	EFiberWorker::closing(fd);
+	fdReset(fd);
+	return close_f(fd);
+}
+
+int poll(struct pollfd* fds, nfds_t nfds, int timeout) {
+	HOOK_SYS_FUNC(poll);
+	if (timeout == 0 || !onFiber()) {
+		return poll_f(fds, nfds, timeout);
+	}
+	int n = poll_f(fds, nfds, 0);
+	if (n != 0) {
+		return n;
+	}
+
+	EFiberWorker* worker = EFiberWorker::current();
+	llong deadline = deadlineOf(timeout);
+	for (;;) {
+		llong remaining = -1;
+		if (deadline >= 0) {
+			remaining = deadline - ESystem::nanoTime();
+			if (remaining <= 0) {
+				return 0;
+			}
+		}
+		if (nfds == 0) {
+			sleepNanos(remaining >= 0 ? remaining : 3600 * 1000000000LL);
+			continue;
+		}
+		for (nfds_t i = 0; i < nfds; i++) {
+			fds[i].revents = 0;
+		}
+		int reason = worker->waitIo(fds, (int)nfds, remaining);
+		if (reason < 0) {
+			// nothing the carrier can wait on
+			return poll_f(fds, nfds, (remaining < 0) ? -1 : (int)((remaining + 999999) / 1000000));
+		}
+		if (reason == EFiberWorker::WAKE_CLOSED) {
+			// fd may still be open right now; report it as poll(2) does
+			// a closed one
+			n = 0;
+			for (nfds_t i = 0; i < nfds; i++) {
+				if (fds[i].revents) n++;
+			}
+			return n;
+		}
+		n = poll_f(fds, nfds, 0);
+		if (n != 0) {
+			return n;
+		}
+	}
+}
+
+/*
+ * Only the file status flags need translating; every other command's
+ * optional argument is passed on as a pointer-sized word, which is how
+ * int arguments travel through varargs on the LP64 targets eco runs on.
+ */
+int fcntl(int fd, int cmd, ...) {
+	HOOK_SYS_FUNC(fcntl);
+	va_list va;
+	va_start(va, cmd);
+	void* arg = va_arg(va, void*);
+	va_end(va);
+
+	if (cmd == F_GETFL) {
+		int fl = fcntl_f(fd, cmd);
+		FdContext* c = fdGet(fd, false);
+		if (fl >= 0 && c && (c->flags & (FD_SYS_NONBLOCK | FD_USER_NONBLOCK)) == FD_SYS_NONBLOCK) {
+			fl &= ~O_NONBLOCK;
+		}
+		return fl;
+	}
+	if (cmd == F_SETFL) {
+		int fl = (int)(es_intptr_t)arg;
+		FdContext* c = fdGet(fd, false);
+		if (c && (c->flags & FD_SYS_NONBLOCK)) {
+			if (fl & O_NONBLOCK) {
+				c->flags |= FD_USER_NONBLOCK;
+			} else {
+				c->flags &= ~FD_USER_NONBLOCK;
+			}
+			fl |= O_NONBLOCK;
+		}
+		return fcntl_f(fd, cmd, fl);
+	}
+	return fcntl_f(fd, cmd, arg);
+}
+
+int ioctl(int fd, unsigned long request, ...) __THROW {
+	HOOK_SYS_FUNC(ioctl);
+	va_list va;
+	va_start(va, request);
+	void* arg = va_arg(va, void*);
+	va_end(va);
+
+	if (request == FIONBIO && arg) {
+		FdContext* c = fdGet(fd, false);
+		if (c && (c->flags & FD_SYS_NONBLOCK)) {
+			if (*(int*)arg) {
+				c->flags |= FD_USER_NONBLOCK;
+			} else {
+				c->flags &= ~FD_USER_NONBLOCK;
+			}
+			int on = 1;
+			return ioctl_f(fd, request, &on);
+		}
+	}
+	return ioctl_f(fd, request, arg);
+}
+
+int setsockopt(int fd, int level, int optname, const void* optval, socklen_t optlen) __THROW {
+	HOOK_SYS_FUNC(setsockopt);
+	int r = setsockopt_f(fd, level, optname, optval, optlen);
+	if (r == 0 && level == SOL_SOCKET && (optname == SO_RCVTIMEO || optname == SO_SNDTIMEO)
+			&& optlen >= sizeof(struct timeval)) {
+		FdContext* c = fdGet(fd, true);
+		if (c) {
+			const struct timeval* tv = (const struct timeval*)optval;
+			int ms = (int)(tv->tv_sec * 1000 + (tv->tv_usec + 999) / 1000);
+			if (optname == SO_RCVTIMEO) {
+				c->rcvTimeout = ms;
+			} else {
+				c->sndTimeout = ms;
+			}
+		}
+	}
+	return r;
+}
+
+int nanosleep(const struct timespec* req, struct timespec* rem) {
+	HOOK_SYS_FUNC(nanosleep);
+	if (!onFiber()) {
+		return nanosleep_f(req, rem);
+	}
+	if (!req || req->tv_nsec < 0 || req->tv_nsec >= 1000000000L) {
+		errno = EINVAL;
+		return -1;
+	}
+	sleepNanos(req->tv_sec * 1000000000LL + req->tv_nsec);
+	if (rem) {
+		rem->tv_sec = 0;
+		rem->tv_nsec = 0;
+	}
+	return 0;
+}
+
+int usleep(useconds_t usec) {
+	HOOK_SYS_FUNC(usleep);
+	if (!onFiber()) {
+		return usleep_f(usec);
+	}
+	sleepNanos(usec * 1000LL);
+	return 0;
+}
+
+unsigned int sleep(unsigned int seconds) {
+	HOOK_SYS_FUNC(sleep);
+	if (!onFiber()) {
+		return sleep_f(seconds);
+	}
+	sleepNanos(seconds * 1000000000LL);
+	return 0;
+}
+
+} //extern "C"
+
+#else //!
+
+namespace efc {
+namespace eco {
+
+void EHooker::init() {
+}
+
+} /* namespace eco */
+} /* namespace efc */
+
+#endif //!WIN32
@@ -0,0 +1,84 @@
+/*
+ * ELockSupportHook.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../inc/EFiberWorker.hh"
+
+/*
+ * ELockSupport lives in the prebuilt efc library, so its park and
+ * unpark are redirected at link time with
+ *
+ *   -Wl,--wrap=_ZN3efc12ELockSupport4parkEv
+ *   -Wl,--wrap=_ZN3efc12ELockSupport9parkNanosEx
+ *   -Wl,--wrap=_ZN3efc12ELockSupport9parkUntilEx
+ *   -Wl,--wrap=_ZN3efc12ELockSupport6unparkEPNS_7EThreadE
+ *
+ * which also covers the calls from inside the library (the locks,
+ * conditions and queues of the concurrent package).  This object is
+ * only linked into programs that pass those options; see EHooker.hh.
+ */
+
+#if defined(__linux__) && !defined(WIN32)
+
+using namespace efc;
+using namespace efc::eco;
+
+extern "C" {
+
+void __real__ZN3efc12ELockSupport4parkEv();
+void __real__ZN3efc12ELockSupport9parkNanosEx(llong nanos);
+void __real__ZN3efc12ELockSupport9parkUntilEx(llong deadline);
+void __real__ZN3efc12ELockSupport6unparkEPNS_7EThreadE(EThread* thread);
+
+static EFiberWorker* fiberCarrier() {
+	EFiberWorker* worker = EFiberWorker::current();
+	return (worker && worker->running()) ? worker : null;
+}
+
+void __wrap__ZN3efc12ELockSupport4parkEv() {
+	EFiberWorker* worker = fiberCarrier();
+	if (worker) {
+		worker->lockPark(-1);
+		return;
+	}
+	__real__ZN3efc12ELockSupport4parkEv();
+}
+
+void __wrap__ZN3efc12ELockSupport9parkNanosEx(llong nanos) {
+	EFiberWorker* worker = fiberCarrier();
+	if (worker) {
+		if (nanos > 0) {
+			worker->lockPark(nanos);
+		}
+		return;
+	}
+	__real__ZN3efc12ELockSupport9parkNanosEx(nanos);
+}
+
+void __wrap__ZN3efc12ELockSupport9parkUntilEx(llong deadline) {
+	EFiberWorker* worker = fiberCarrier();
+	if (worker) {
+		llong millis = deadline - ESystem::currentTimeMillis();
+		if (millis > 0) {
+			worker->lockPark(millis * 1000000LL);
+		}
+		return;
+	}
+	__real__ZN3efc12ELockSupport9parkUntilEx(deadline);
+}
+
+void __wrap__ZN3efc12ELockSupport6unparkEPNS_7EThreadE(EThread* thread) {
+	EFiberWorker* worker = EFiberWorker::carrierOf(thread);
+	if (worker) {
+		worker->lockUnpark();
+	}
+	// the carrier itself may be parked outside of any fiber
+	__real__ZN3efc12ELockSupport6unparkEPNS_7EThreadE(thread);
+}
+
+} /* extern "C" */
+
+#endif //__linux__
@@ -179,55 +179,7 @@ public:
 			len = _length;
 		}
 		rangeCheck(off, off + len);
-
-		if (len < INSERTIONSORT_THRESHOLD) {
-			for (int i = off; i < len + off; i++)
-				for (int j = i; j > off && _array[j - 1] > _array[j]; j--)
-					swap(j, j - 1);
-			return;
-		}
-
-		int m = off + (len >> 1);
-		if (len > INSERTIONSORT_THRESHOLD) {
-			int l = off;
-			int n = off + len - 1;
-			if (len > 40) {
-				int s = len / 8;
-				l = med3(l, l + s, l + 2 * s);
-				m = med3(m - s, m, m + s);
-				n = med3(n - 2 * s, n - s, n);
-			}
-			m = med3(l, m, n);
-		}
-		E v = _array[m];
-
-		int a = off, b = a, c = off + len - 1, d = c;
-		while (true) {
-			while (b <= c && _array[b] <= v) {
-				if (_array[b] == v)
-					swap(a++, b);
-				b++;
-			}
-			while (c >= b && _array[c] >= v) {
-				if (_array[c] == v)
-					swap(c, d--);
-				c--;
-			}
-			if (b > c)
-				break;
-			swap(b++, c--);
-		}
-
-		int s, n = off + len;
-		s = ES_MIN(a-off, b-a );
-		vecswap(off, b - s, s);
-		s = ES_MIN(d-c, n-d-1);
-		vecswap(b, n - s, s);
-
-		if ((s = b - a) > 1)
-			sort(off, s);
-		if ((s = d - c) > 1)
-			sort(n - s, s);
+		sort0(off, len, depthLimit(len));
 	}
 
 	EA<E>* clone(int offset=0, int newLength=-1) {
@@ -286,6 +238,106 @@ private:
 				(_array[b] < _array[c] ? b : _array[a] < _array[c] ? c : a) :
 				(_array[b] > _array[c] ? b : _array[a] > _array[c] ? c : a));
 	}
+
+	/**
+	 * Introsort: a tuned quicksort (Bentley and McIlroy) that switches
+	 * to heapsort once the recursion is deeper than 2*log2(len), so that
+	 * no input can make it quadratic.
+	 */
+	void sort0(int off, int len, int depth) {
+		if (len < INSERTIONSORT_THRESHOLD) {
+			for (int i = off; i < len + off; i++)
+				for (int j = i; j > off && _array[j - 1] > _array[j]; j--)
+					swap(j, j - 1);
+			return;
+		}
+
+		// Too many bad partitions, finish with heapsort
+		if (depth-- == 0) {
+			heapsort(off, len);
+			return;
+		}
+
+		int m = off + (len >> 1);
+		if (len > INSERTIONSORT_THRESHOLD) {
+			int l = off;
+			int n = off + len - 1;
+			if (len > 40) {
+				int s = len / 8;
+				l = med3(l, l + s, l + 2 * s);
+				m = med3(m - s, m, m + s);
+				n = med3(n - 2 * s, n - s, n);
+			}
+			m = med3(l, m, n);
+		}
+		E v = _array[m];
+
+		int a = off, b = a, c = off + len - 1, d = c;
+		while (true) {
+			while (b <= c && _array[b] <= v) {
+				if (_array[b] == v)
+					swap(a++, b);
+				b++;
+			}
+			while (c >= b && _array[c] >= v) {
+				if (_array[c] == v)
+					swap(c, d--);
+				c--;
+			}
+			if (b > c)
+				break;
+			swap(b++, c--);
+		}
+
+		int s, n = off + len;
+		s = ES_MIN(a-off, b-a );
+		vecswap(off, b - s, s);
+		s = ES_MIN(d-c, n-d-1);
+		vecswap(b, n - s, s);
+
+		if ((s = b - a) > 1)
+			sort0(off, s, depth);
+		if ((s = d - c) > 1)
+			sort0(n - s, s, depth);
+	}
+
+	static int depthLimit(int len) {
+		int depth = 0;
+		while (len > 1) {
+			len >>= 1;
+			depth += 2;
+		}
+		return depth;
+	}
+
+	/**
+	 * Sorts x[off .. (off+len-1)] with heapsort.
+	 */
+	void heapsort(int off, int len) {
+		for (int i = (len >> 1) - 1; i >= 0; i--)
+			siftDown(off, i, len);
+		for (int n = len - 1; n > 0; n--) {
+			swap(off, off + n);
+			siftDown(off, 0, n);
+		}
+	}
+
+	void siftDown(int off, int i, int n) {
+		for (int c; (c = 2 * i + 1) < n; i = c) {
+			if (c + 1 < n && less(off + c, off + c + 1))
+				c++;
+			if (!less(off + i, off + c))
+				break;
+			swap(off + i, off + c);
+		}
+	}
+
+	/**
+	 * Returns true if x[i] sorts before x[j].
+	 */
+	boolean less(int i, int j) {
+		return _array[i] < _array[j];
+	}
 };
 
 //=============================================================================
@@ -420,61 +472,7 @@ public:
 			len = _length;
 		}
 		rangeCheck(off, off + len);
-
-		// Insertion sort on smallest arrays
-		if (len < INSERTIONSORT_THRESHOLD) {
-			for (int i = off; i < len + off; i++)
-				for (int j = i; j > off && _array[j - 1] && _array[j - 1]->compareTo(_array[j]) > 0; j--)
-					swap(j, j - 1);
-			return;
-		}
-
-		// Choose a partition element, v
-		int m = off + (len >> 1); // Small arrays, middle element
-		if (len > INSERTIONSORT_THRESHOLD) {
-			int l = off;
-			int n = off + len - 1;
-			if (len > 40) { // Big arrays, pseudomedian of 9
-				int s = len / 8;
-				l = med3(l, l + s, l + 2 * s);
-				m = med3(m - s, m, m + s);
-				n = med3(n - 2 * s, n - s, n);
-			}
-			m = med3(l, m, n); // Mid-size, med of 3
-		}
-		E v = _array[m];
-
-		// Establish Invariant: v* (<v)* (>v)* v*
-		int a = off, b = a, c = off + len - 1, d = c;
-		int rbv, rcv;
-		while (true) {
-			while (b <= c && _array[b] && (rbv = _array[b]->compareTo(v)) <= 0) {
-				if (rbv == 0)
-					swap(a++, b);
-				b++;
-			}
-			while (c >= b && _array[c] && (rcv = _array[c]->compareTo(v)) >= 0) {
-				if (rcv == 0)
-					swap(c, d--);
-				c--;
-			}
-			if (b > c)
-				break;
-			swap(b++, c--);
-		}
-
-		// Swap partition elements back to middle
-		int s, n = off + len;
-		s = ES_MIN(a-off, b-a );
-		vecswap(off, b - s, s);
-		s = ES_MIN(d-c, n-d-1);
-		vecswap(b, n - s, s);
-
-		// Recursively sort non-partition-elements
-		if ((s = b - a) > 1)
-			sort(off, s);
-		if ((s = d - c) > 1)
-			sort(n - s, s);
+		sort0(off, len, depthLimit(len));
 	}
 
 	/**
@@ -565,6 +563,112 @@ private:
 				(_array[b] == null || _array[b]->compareTo(_array[c]) < 0 ? b : _array[a] == null || _array[a]->compareTo(_array[c]) < 0 ? c : a) :
 				(_array[b] != null && _array[b]->compareTo(_array[c]) > 0 ? b : _array[a] != null && _array[a]->compareTo(_array[c]) > 0 ? c : a));
 	}
+
+	/**
+	 * Introsort: a tuned quicksort (Bentley and McIlroy) that switches
+	 * to heapsort once the recursion is deeper than 2*log2(len), so that
+	 * no input can make it quadratic.
+	 */
+	void sort0(int off, int len, int depth) {
+		// Insertion sort on smallest arrays
+		if (len < INSERTIONSORT_THRESHOLD) {
+			for (int i = off; i < len + off; i++)
+				for (int j = i; j > off && _array[j - 1] && _array[j - 1]->compareTo(_array[j]) > 0; j--)
+					swap(j, j - 1);
+			return;
+		}
+
+		// Too many bad partitions, finish with heapsort
+		if (depth-- == 0) {
+			heapsort(off, len);
+			return;
+		}
+
+		// Choose a partition element, v
+		int m = off + (len >> 1); // Small arrays, middle element
+		if (len > INSERTIONSORT_THRESHOLD) {
+			int l = off;
+			int n = off + len - 1;
+			if (len > 40) { // Big arrays, pseudomedian of 9
+				int s = len / 8;
+				l = med3(l, l + s, l + 2 * s);
+				m = med3(m - s, m, m + s);
+				n = med3(n - 2 * s, n - s, n);
+			}
+			m = med3(l, m, n); // Mid-size, med of 3
+		}
+		E v = _array[m];
+
+		// Establish Invariant: v* (<v)* (>v)* v*
+		int a = off, b = a, c = off + len - 1, d = c;
+		int rbv, rcv;
+		while (true) {
+			while (b <= c && _array[b] && (rbv = _array[b]->compareTo(v)) <= 0) {
+				if (rbv == 0)
+					swap(a++, b);
+				b++;
+			}
+			while (c >= b && _array[c] && (rcv = _array[c]->compareTo(v)) >= 0) {
+				if (rcv == 0)
+					swap(c, d--);
+				c--;
+			}
+			if (b > c)
+				break;
+			swap(b++, c--);
+		}
+
+		// Swap partition elements back to middle
+		int s, n = off + len;
+		s = ES_MIN(a-off, b-a );
+		vecswap(off, b - s, s);
+		s = ES_MIN(d-c, n-d-1);
+		vecswap(b, n - s, s);
+
+		// Recursively sort non-partition-elements
+		if ((s = b - a) > 1)
+			sort0(off, s, depth);
+		if ((s = d - c) > 1)
+			sort0(n - s, s, depth);
+	}
+
+	static int depthLimit(int len) {
+		int depth = 0;
+		while (len > 1) {
+			len >>= 1;
+			depth += 2;
+		}
+		return depth;
+	}
+
+	/**
+	 * Sorts x[off .. (off+len-1)] with heapsort.
+	 */
+	void heapsort(int off, int len) {
+		for (int i = (len >> 1) - 1; i >= 0; i--)
+			siftDown(off, i, len);
+		for (int n = len - 1; n > 0; n--) {
+			swap(off, off + n);
+			siftDown(off, 0, n);
+		}
+	}
+
+	void siftDown(int off, int i, int n) {
+		for (int c; (c = 2 * i + 1) < n; i = c) {
+			if (c + 1 < n && less(off + c, off + c + 1))
+				c++;
+			if (!less(off + i, off + c))
+				break;
+			swap(off + i, off + c);
+		}
+	}
+
+	/**
+	 * Returns true if x[i] sorts before x[j].
+	 */
+	boolean less(int i, int j) {
+		return _array[j] != null && (_array[i] == null || _array[i]->compareTo(_array[j]) < 0);
+	}
 };
 
 //=============================================================================
@@ -704,61 +808,7 @@ public:
 			len = _length;
 		}
 		rangeCheck(off, off + len);
-
-		// Insertion sort on smallest arrays
-		if (len < INSERTIONSORT_THRESHOLD) {
-			for (int i = off; i < len + off; i++)
-				for (int j = i; j > off && (_array[j - 1] != null) && _array[j - 1]->compareTo(_array[j].get()) > 0; j--)
-					swap(j, j - 1);
-			return;
-		}
-
-		// Choose a partition element, v
-		int m = off + (len >> 1); // Small arrays, middle element
-		if (len > INSERTIONSORT_THRESHOLD) {
-			int l = off;
-			int n = off + len - 1;
-			if (len > 40) { // Big arrays, pseudomedian of 9
-				int s = len / 8;
-				l = med3(l, l + s, l + 2 * s);
-				m = med3(m - s, m, m + s);
-				n = med3(n - 2 * s, n - s, n);
-			}
-			m = med3(l, m, n); // Mid-size, med of 3
-		}
-		E v = _array[m];
-
-		// Establish Invariant: v* (<v)* (>v)* v*
-		int a = off, b = a, c = off + len - 1, d = c;
-		int rbv, rcv;
-		while (true) {
-			while (b <= c && (_array[b] != null) && (rbv = _array[b]->compareTo(v.get())) <= 0) {
-				if (rbv == 0)
-					swap(a++, b);
-				b++;
-			}
-			while (c >= b && (_array[c] != null) && (rcv = _array[c]->compareTo(v.get())) >= 0) {
-				if (rcv == 0)
-					swap(c, d--);
-				c--;
-			}
-			if (b > c)
-				break;
-			swap(b++, c--);
-		}
-
-		// Swap partition elements back to middle
-		int s, n = off + len;
-		s = ES_MIN(a-off, b-a );
-		vecswap(off, b - s, s);
-		s = ES_MIN(d-c, n-d-1);
-		vecswap(b, n - s, s);
-
-		// Recursively sort non-partition-elements
-		if ((s = b - a) > 1)
-			sort(off, s);
-		if ((s = d - c) > 1)
-			sort(n - s, s);
+		sort0(off, len, depthLimit(len));
 	}
 
 	E atomicGet(int index) THROWS(EIndexOutOfBoundsException) {
@@ -828,6 +878,112 @@ private:
 				(_array[b] == null || _array[b]->compareTo(_array[c].get()) < 0 ? b : _array[a] == null || _array[a]->compareTo(_array[c].get()) < 0 ? c : a) :
 				(_array[b] != null && _array[b]->compareTo(_array[c].get()) > 0 ? b : _array[a] != null && _array[a]->compareTo(_array[c].get()) > 0 ? c : a));
 	}
+
+	/**
+	 * Introsort: a tuned quicksort (Bentley and McIlroy) that switches
+	 * to heapsort once the recursion is deeper than 2*log2(len), so that
+	 * no input can make it quadratic.
+	 */
+	void sort0(int off, int len, int depth) {
+		// Insertion sort on smallest arrays
+		if (len < INSERTIONSORT_THRESHOLD) {
+			for (int i = off; i < len + off; i++)
+				for (int j = i; j > off && (_array[j - 1] != null) && _array[j - 1]->compareTo(_array[j].get()) > 0; j--)
+					swap(j, j - 1);
+			return;
+		}
+
+		// Too many bad partitions, finish with heapsort
+		if (depth-- == 0) {
+			heapsort(off, len);
+			return;
+		}
+
+		// Choose a partition element, v
+		int m = off + (len >> 1); // Small arrays, middle element
+		if (len > INSERTIONSORT_THRESHOLD) {
+			int l = off;
+			int n = off + len - 1;
+			if (len > 40) { // Big arrays, pseudomedian of 9
+				int s = len / 8;
+				l = med3(l, l + s, l + 2 * s);
+				m = med3(m - s, m, m + s);
+				n = med3(n - 2 * s, n - s, n);
+			}
+			m = med3(l, m, n); // Mid-size, med of 3
+		}
+		E v = _array[m];
+
+		// Establish Invariant: v* (<v)* (>v)* v*
+		int a = off, b = a, c = off + len - 1, d = c;
+		int rbv, rcv;
+		while (true) {
+			while (b <= c && (_array[b] != null) && (rbv = _array[b]->compareTo(v.get())) <= 0) {
+				if (rbv == 0)
+					swap(a++, b);
+				b++;
+			}
+			while (c >= b && (_array[c] != null) && (rcv = _array[c]->compareTo(v.get())) >= 0) {
+				if (rcv == 0)
+					swap(c, d--);
+				c--;
+			}
+			if (b > c)
+				break;
+			swap(b++, c--);
+		}
+
+		// Swap partition elements back to middle
+		int s, n = off + len;
+		s = ES_MIN(a-off, b-a );
+		vecswap(off, b - s, s);
+		s = ES_MIN(d-c, n-d-1);
+		vecswap(b, n - s, s);
+
+		// Recursively sort non-partition-elements
+		if ((s = b - a) > 1)
+			sort0(off, s, depth);
+		if ((s = d - c) > 1)
+			sort0(n - s, s, depth);
+	}
+
+	static int depthLimit(int len) {
+		int depth = 0;
+		while (len > 1) {
+			len >>= 1;
+			depth += 2;
+		}
+		return depth;
+	}
+
+	/**
+	 * Sorts x[off .. (off+len-1)] with heapsort.
+	 */
+	void heapsort(int off, int len) {
+		for (int i = (len >> 1) - 1; i >= 0; i--)
+			siftDown(off, i, len);
+		for (int n = len - 1; n > 0; n--) {
+			swap(off, off + n);
+			siftDown(off, 0, n);
+		}
+	}
+
+	void siftDown(int off, int i, int n) {
+		for (int c; (c = 2 * i + 1) < n; i = c) {
+			if (c + 1 < n && less(off + c, off + c + 1))
+				c++;
+			if (!less(off + i, off + c))
+				break;
+			swap(off + i, off + c);
+		}
+	}
+
+	/**
+	 * Returns true if x[i] sorts before x[j].
+	 */
+	boolean less(int i, int j) {
+		return _array[j] != null && (_array[i] == null || _array[i]->compareTo(_array[j].get()) < 0);
+	}
 };
 
 } /* namespace efc */
@@ -995,12 +995,6 @@ protected:
 
 public:
 	virtual ~EAbstractMap() {
-		if (_keySet) {
-			delete _keySet;
-		}
-		if (_values) {
-			delete _values;
-		}
 	}
 
 	// Query Operations
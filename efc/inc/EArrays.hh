@@ -9,9 +9,12 @@
 #define EARRAYS_HH_
 
 #include "EBase.hh"
+#include "EA.hh"
 #include "EComparable.hh"
 #include "EIndexOutOfBoundsException.hh"
 #include "EIllegalArgumentException.hh"
+#include "./concurrent/EForkJoinPool.hh"
+#include "./concurrent/ERecursiveAction.hh"
 
 namespace efc {
 
@@ -72,6 +75,138 @@ public:
 		a->sort(fromIndex, toIndex-fromIndex);
 	}
 
+	/**
+	 * Sorts the specified range of the array into ascending numerical
+	 * order.
+	 *
+	 * <p>Ranges of at least {@link #RADIX_SORT_THRESHOLD} elements are
+	 * sorted with an LSD radix sort over 8-bit digits, which takes a
+	 * temporary buffer of the range's size and skips every digit that is
+	 * the same in all elements (the high bytes of timestamps, say);
+	 * smaller ranges use the introsort of {@link EA#sort}.
+	 *
+	 * @param a the array to be sorted
+	 * @param fromIndex the index of the first element, inclusive, to be sorted
+	 * @param toIndex the index of the last element, exclusive, to be sorted
+	 * @throws IllegalArgumentException if <tt>fromIndex &gt; toIndex</tt>
+	 * @throws ArrayIndexOutOfBoundsException if <tt>fromIndex &lt; 0</tt> or
+	 * <tt>toIndex &gt; a.length</tt>
+	 */
+	static void sort(EA<int>* a, int fromIndex, int toIndex) {
+		int n = rangeCheck(a->length(), fromIndex, toIndex);
+		if (n < RADIX_SORT_THRESHOLD) {
+			a->sort(fromIndex, n);
+			return;
+		}
+		uint* x = (uint*)(a->address() + fromIndex);
+		for (int i = 0; i < n; i++) x[i] ^= 0x80000000U;
+		radixSort(x, n);
+		for (int i = 0; i < n; i++) x[i] ^= 0x80000000U;
+	}
+
+	static void sort(EA<llong>* a, int fromIndex, int toIndex) {
+		int n = rangeCheck(a->length(), fromIndex, toIndex);
+		if (n < RADIX_SORT_THRESHOLD) {
+			a->sort(fromIndex, n);
+			return;
+		}
+		ullong* x = (ullong*)(a->address() + fromIndex);
+		for (int i = 0; i < n; i++) x[i] ^= LLONG_SIGN;
+		radixSort(x, n);
+		for (int i = 0; i < n; i++) x[i] ^= LLONG_SIGN;
+	}
+
+	/**
+	 * Sorts the specified range of the array into ascending numerical
+	 * order as {@link #sort(EA<int>*, int, int)} does.
+	 *
+	 * <p>Ranges of any size are ordered like {@code Float.compare}:
+	 * -0.0f sorts before 0.0f, and NaNs (whatever their sign bit) are
+	 * moved behind all numbers before the rest is sorted.
+	 */
+	static void sort(EA<float>* a, int fromIndex, int toIndex) {
+		int n = rangeCheck(a->length(), fromIndex, toIndex);
+		uint* x = (uint*)(a->address() + fromIndex);
+		n = moveNaNsLast(x, n, 0x7F800000U);
+		if (n < RADIX_SORT_THRESHOLD) {
+			sortBits((int*)x, n, 0x7FFFFFFF);
+			return;
+		}
+		for (int i = 0; i < n; i++) x[i] = (x[i] & 0x80000000U) ? ~x[i] : (x[i] | 0x80000000U);
+		radixSort(x, n);
+		for (int i = 0; i < n; i++) x[i] = (x[i] & 0x80000000U) ? (x[i] & 0x7FFFFFFFU) : ~x[i];
+	}
+
+	static void sort(EA<double>* a, int fromIndex, int toIndex) {
+		int n = rangeCheck(a->length(), fromIndex, toIndex);
+		ullong* x = (ullong*)(a->address() + fromIndex);
+		n = moveNaNsLast(x, n, DOUBLE_INFINITY);
+		if (n < RADIX_SORT_THRESHOLD) {
+			sortBits((llong*)x, n, (llong)~LLONG_SIGN);
+			return;
+		}
+		for (int i = 0; i < n; i++) x[i] = (x[i] & LLONG_SIGN) ? ~x[i] : (x[i] | LLONG_SIGN);
+		radixSort(x, n);
+		for (int i = 0; i < n; i++) x[i] = (x[i] & LLONG_SIGN) ? (x[i] & ~LLONG_SIGN) : ~x[i];
+	}
+
+	/**
+	 * Sorts the specified range of the array into ascending numerical
+	 * order, using the common {@link EForkJoinPool}.
+	 *
+	 * <p>The range is split into sub-arrays that are themselves sorted
+	 * with {@link #sort} and then merged, both in parallel, through a
+	 * working buffer the size of the range; merges split the larger run
+	 * at its middle and binary-search the other, so they stay parallel
+	 * down to the granularity.  When the range has fewer than
+	 * {@link #MIN_ARRAY_SORT_GRAN} elements or the pool has a parallelism
+	 * of one, this is just {@link #sort}.
+	 *
+	 * <p>Only the primitive overloads exist: the buffer holds plain
+	 * copies of the elements, which an array of owned pointers must not
+	 * have, and pointers would be merged by address.
+	 *
+	 * @param a the array to be sorted
+	 * @param fromIndex the index of the first element, inclusive, to be sorted
+	 * @param toIndex the index of the last element, exclusive, to be sorted
+	 * @throws IllegalArgumentException if <tt>fromIndex &gt; toIndex</tt>
+	 * @throws ArrayIndexOutOfBoundsException if <tt>fromIndex &lt; 0</tt> or
+	 * <tt>toIndex &gt; a.length</tt>
+	 *
+	 * @since 1.8
+	 */
+	static void parallelSort(EA<int>* a, int fromIndex, int toIndex) {
+		parallelSort0(a, fromIndex, toIndex);
+	}
+
+	static void parallelSort(EA<llong>* a, int fromIndex, int toIndex) {
+		parallelSort0(a, fromIndex, toIndex);
+	}
+
+	static void parallelSort(EA<float>* a, int fromIndex, int toIndex) {
+		parallelSort0(a, fromIndex, toIndex);
+	}
+
+	static void parallelSort(EA<double>* a, int fromIndex, int toIndex) {
+		parallelSort0(a, fromIndex, toIndex);
+	}
+
+	static void parallelSort(EA<int>* a) {
+		parallelSort0(a, 0, a->length());
+	}
+
+	static void parallelSort(EA<llong>* a) {
+		parallelSort0(a, 0, a->length());
+	}
+
+	static void parallelSort(EA<float>* a) {
+		parallelSort0(a, 0, a->length());
+	}
+
+	static void parallelSort(EA<double>* a) {
+		parallelSort0(a, 0, a->length());
+	}
+
 	// Cloning
 	/**
 	 * Copies the specified array, truncating or padding with nulls (if necessary)
@@ -133,10 +268,257 @@ public:
 		return original->clone(fromIndex, toIndex - fromIndex);
 	}
 
+	/**
+	 * The minimum array length below which a parallel sorting
+	 * algorithm will not further partition the sorting task.
+	 */
+	static const int MIN_ARRAY_SORT_GRAN = 1 << 13;
+
+	/**
+	 * The minimum range length from which the primitive {@link #sort}
+	 * overloads use radix sort.  MUST be at most MIN_ARRAY_SORT_GRAN / 2,
+	 * so that {@link #parallelSort} leaves are radix sorted and merged in
+	 * the same order.
+	 */
+	static const int RADIX_SORT_THRESHOLD = 1 << 12;
+
 private:
 	// Suppresses default constructor, ensuring non-instantiability.
 	EArrays() {
 	}
+
+	static const ullong LLONG_SIGN = 0x8000000000000000ULL;
+	static const ullong DOUBLE_INFINITY = 0x7FF0000000000000ULL;
+
+	static int rangeCheck(int length, int fromIndex, int toIndex) {
+		if (fromIndex > toIndex) {
+			EString msg = EString::formatOf("fromIndex(%d) > toIndex(%d)", fromIndex, toIndex);
+			throw EIllegalArgumentException(__FILE__, __LINE__, msg.c_str());
+		}
+		if (fromIndex < 0) {
+			throw EIndexOutOfBoundsException(__FILE__, __LINE__,
+					EString::formatOf("fromIndex(%d)", fromIndex).c_str());
+		}
+		if (toIndex > length) {
+			throw EIndexOutOfBoundsException(__FILE__, __LINE__,
+					EString::formatOf("toIndex(%d)", toIndex).c_str());
+		}
+		return toIndex - fromIndex;
+	}
+
+	/**
+	 * Sorts a primitive range as described at {@link #parallelSort}.
+	 * The working buffer holds raw copies of the elements, and
+	 * {@link Merger} compares them with <tt>&lt;</tt> (or the float
+	 * ordering of {@link #sort}), so T must be one of the radix sorted
+	 * primitive types.
+	 */
+	template<typename T>
+	static void parallelSort0(EA<T>* a, int fromIndex, int toIndex) {
+		int n = rangeCheck(a->length(), fromIndex, toIndex), p, g;
+		if (n <= MIN_ARRAY_SORT_GRAN ||
+				(p = EForkJoinPool::getCommonPoolParallelism()) == 1) {
+			sort(a, fromIndex, toIndex);
+		} else {
+			g = n / (p << 2);
+			EA<T> w(n);
+			EForkJoinPool::commonPool()->invoke<EObject>(new Sorter<T>(a,
+					w.address(), fromIndex, 0, n,
+					(g <= MIN_ARRAY_SORT_GRAN) ? MIN_ARRAY_SORT_GRAN : g, false));
+		}
+	}
+
+	/**
+	 * LSD radix sort of unsigned keys, one byte per pass.  All byte
+	 * histograms are counted in one read of the input, and a pass whose
+	 * byte is the same in every key is skipped.
+	 */
+	template<typename U>
+	static void radixSort(U* x, int n) {
+		const int passes = sizeof(U);
+		EA<int> counts(passes * 256);
+		int* c = counts.address();
+		for (int i = 0; i < n; i++) {
+			U v = x[i];
+			for (int p = 0; p < passes; p++) {
+				c[(p << 8) + (int)((v >> (p << 3)) & 0xFF)]++;
+			}
+		}
+		EA<U> buffer(n);
+		U* src = x;
+		U* dst = buffer.address();
+		for (int p = 0; p < passes; p++) {
+			int* cp = c + (p << 8);
+			if (cp[(int)((x[0] >> (p << 3)) & 0xFF)] == n)
+				continue; // all keys share this byte
+			for (int i = 0, sum = 0; i < 256; i++) {
+				int t = cp[i];
+				cp[i] = sum;
+				sum += t;
+			}
+			int shift = p << 3;
+			for (int i = 0; i < n; i++) {
+				U v = src[i];
+				dst[cp[(int)((v >> shift) & 0xFF)]++] = v;
+			}
+			U* t = src;
+			src = dst;
+			dst = t;
+		}
+		if (src != x) {
+			eso_memcpy(x, src, n * sizeof(U));
+		}
+	}
+
+	/**
+	 * Moves the NaNs among the bits of n floats or doubles to the end,
+	 * where {@code inf} is the bits of positive infinity, and returns
+	 * the number of the other values.
+	 */
+	template<typename U>
+	static int moveNaNsLast(U* x, int n, U inf) {
+		for (int i = n - 1; i >= 0; i--) {
+			if ((U)(x[i] << 1) > (U)(inf << 1)) {
+				U t = x[i]; x[i] = x[--n]; x[n] = t;
+			}
+		}
+		return n;
+	}
+
+	/**
+	 * Sorts the bits of floats (S = int) or doubles (S = llong) in the
+	 * order of their radix keys.  Flipping all but the sign bit of the
+	 * negative values turns them into integers that compare like the
+	 * keys; the flip is its own inverse.
+	 */
+	template<typename S>
+	static void sortBits(S* x, int n, S mask) {
+		for (int i = 0; i < n; i++) if (x[i] < 0) x[i] ^= mask;
+		EA<S> keys(x, n, false, MEM_NEW);
+		keys.sort();
+		for (int i = 0; i < n; i++) if (x[i] < 0) x[i] ^= mask;
+	}
+
+	/**
+	 * Returns true if a sorts before b in the order of {@link #sort}.
+	 */
+	template<typename T>
+	static boolean lessThan(T a, T b) {
+		return a < b;
+	}
+	static boolean lessThan(float a, float b) {
+		uint x, y;
+		eso_memcpy(&x, &a, sizeof(x));
+		eso_memcpy(&y, &b, sizeof(y));
+		x = (x << 1 > 0x7F800000U << 1) ? ~0U : (x & 0x80000000U) ? ~x : (x | 0x80000000U);
+		y = (y << 1 > 0x7F800000U << 1) ? ~0U : (y & 0x80000000U) ? ~y : (y | 0x80000000U);
+		return x < y;
+	}
+	static boolean lessThan(double a, double b) {
+		ullong x, y;
+		eso_memcpy(&x, &a, sizeof(x));
+		eso_memcpy(&y, &b, sizeof(y));
+		x = (x << 1 > DOUBLE_INFINITY << 1) ? ~0ULL : (x & LLONG_SIGN) ? ~x : (x | LLONG_SIGN);
+		y = (y << 1 > DOUBLE_INFINITY << 1) ? ~0ULL : (y & LLONG_SIGN) ? ~y : (y | LLONG_SIGN);
+		return x < y;
+	}
+
+	//@see: openjdk-8/src/share/classes/java/util/ArraysParallelSortHelpers.java
+
+	/**
+	 * Sorts a[origin+base .. origin+base+size), leaving the result there
+	 * or, if intoW, in w[base .. base+size).  The two halves are sorted
+	 * into the other buffer, so that merging them lands in the right
+	 * one and only leaves ever copy.
+	 */
+	template<typename T>
+	class Sorter: public ERecursiveAction {
+	public:
+		Sorter(EA<T>* a, T* w, int origin, int base, int size, int gran,
+				boolean intoW) :
+				a(a), w(w), origin(origin), base(base), size(size),
+				gran(gran), intoW(intoW) {
+		}
+	protected:
+		void compute() {
+			if (size <= gran) {
+				EArrays::sort(a, origin + base, origin + base + size);
+				if (intoW) {
+					eso_memcpy(w + base, a->address() + origin + base, size * sizeof(T));
+				}
+				return;
+			}
+			int h = size >> 1;
+			invokeAll(new Sorter<T>(a, w, origin, base, h, gran, !intoW),
+					new Sorter<T>(a, w, origin, base + h, size - h, gran, !intoW));
+			T* x = a->address() + origin;
+			T* src = intoW ? x : w;
+			T* dst = intoW ? w : x;
+			sp<Merger<T> > m = new Merger<T>(src, dst, base, h, base + h,
+					size - h, base, gran);
+			m->invoke();
+		}
+	private:
+		EA<T>* a;
+		T* w;
+		int origin, base, size, gran;
+		boolean intoW;
+	};
+
+	/**
+	 * Merges the sorted runs src[lo1 .. lo1+n1) and src[lo2 .. lo2+n2)
+	 * into dst starting at k.
+	 */
+	template<typename T>
+	class Merger: public ERecursiveAction {
+	public:
+		Merger(T* src, T* dst, int lo1, int n1, int lo2, int n2, int k,
+				int gran) :
+				src(src), dst(dst), lo1(lo1), n1(n1), lo2(lo2), n2(n2),
+				k(k), gran(gran) {
+		}
+	protected:
+		void compute() {
+			if (n1 < n2) { // split the larger run
+				int t = lo1; lo1 = lo2; lo2 = t;
+				t = n1; n1 = n2; n2 = t;
+			}
+			if (n1 + n2 <= gran || n2 == 0) {
+				merge();
+				return;
+			}
+			int h = n1 >> 1;
+			T split = src[lo1 + h];
+			int lo = 0, hi = n2;
+			while (lo < hi) {
+				int mid = (lo + hi) >> 1;
+				if (lessThan(src[lo2 + mid], split))
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+			invokeAll(new Merger<T>(src, dst, lo1, h, lo2, lo, k, gran),
+					new Merger<T>(src, dst, lo1 + h, n1 - h, lo2 + lo,
+							n2 - lo, k + h + lo, gran));
+		}
+	private:
+		T* src;
+		T* dst;
+		int lo1, n1, lo2, n2, k, gran;
+
+		void merge() {
+			int i = lo1, e1 = lo1 + n1, j = lo2, e2 = lo2 + n2;
+			T* d = dst + k;
+			while (i < e1 && j < e2) {
+				*d++ = lessThan(src[j], src[i]) ? src[j++] : src[i++];
+			}
+			if (i < e1) {
+				eso_memcpy(d, src + i, (e1 - i) * sizeof(T));
+			} else if (j < e2) {
+				eso_memcpy(d, src + j, (e2 - j) * sizeof(T));
+			}
+		}
+	};
 };
 
 } /* namespace efc */
@@ -0,0 +1,1839 @@
+/*
+ * EBTreeMap.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EBTREEMAP_HH_
+#define EBTREEMAP_HH_
+
+#include "EA.hh"
+#include "EFlatHashMap.hh"
+#include "ENavigableMap.hh"
+#include "ENavigableSet.hh"
+#include "EComparator.hh"
+#include "EComparable.hh"
+#include "ENullPointerException.hh"
+#include "ENoSuchElementException.hh"
+#include "EIllegalStateException.hh"
+#include "EIllegalArgumentException.hh"
+#include "EUnsupportedOperationException.hh"
+#include "EConcurrentModificationException.hh"
+
+namespace efc {
+
+/**
+ * Key ordering for the B-tree containers, on top of the hashing traits of
+ * the flat containers (used for entry equality and hash codes).
+ *
+ * <p>Primitive keys compare with <tt>&lt;</tt> and are searched inside a
+ * node with a branch-free binary search; native and shared pointer keys
+ * use their <tt>compareTo</tt>, as {@link ETreeMap} does.  When a query
+ * finds no key, <tt>nil()</tt> returns <tt>null</tt> for pointer keys and
+ * throws <tt>ENoSuchElementException</tt> for primitive keys, which have
+ * no <tt>null</tt>.
+ */
+template<typename T>
+struct EBTreeKeyTraits: public EFlatHashTraits<T> {
+	static int compare(EComparator<T>* c, T a, const T& b) {
+		if (c != null)
+			return c->compare(a, b);
+		return (a < b) ? -1 : ((b < a) ? 1 : 0);
+	}
+	// The loops always run log2(n) steps and the comparison compiles to
+	// a conditional move, so a node search has no mispredicted branch.
+	static int search(const T* a, int n, T k, boolean upper) {
+		if (n == 0)
+			return 0;
+		const T* base = a;
+		if (upper) {
+			while (n > 1) {
+				int half = n >> 1;
+				base = (k < base[half]) ? base : base + half;
+				n -= half;
+			}
+			return (int)(base - a) + !(k < *base);
+		}
+		while (n > 1) {
+			int half = n >> 1;
+			base = (base[half] < k) ? base + half : base;
+			n -= half;
+		}
+		return (int)(base - a) + (*base < k);
+	}
+	static T nil() {
+		throw ENoSuchElementException(__FILE__, __LINE__);
+	}
+};
+
+template<typename T>
+struct EBTreeKeyTraits<T*>: public EFlatHashTraits<T*> {
+	static int compare(EComparator<T*>* c, T* a, T* b) {
+		if (c != null)
+			return c->compare(a, b);
+		if (a == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		return ((EComparable<T*>*)a)->compareTo(b);
+	}
+	static int search(T* const* a, int n, T* k, boolean upper) {
+		if (k == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		EComparable<T*>* c = (EComparable<T*>*)k;
+		int lo = 0, hi = n;
+		while (lo < hi) {
+			int mid = (lo + hi) >> 1;
+			int r = c->compareTo(a[mid]);
+			if (r > 0 || (upper && r == 0))
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+	static T* nil() {
+		return null;
+	}
+};
+
+template<typename T>
+struct EBTreeKeyTraits<sp<T> >: public EFlatHashTraits<sp<T> > {
+	static int compare(EComparator<sp<T> >* c, T* a, const sp<T>& b) {
+		if (c != null)
+			return c->compare(sp<T>(sp<T>(), a), b); // not owning
+		if (a == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		return ((EComparable<T*>*)a)->compareTo(b.get());
+	}
+	static int search(const sp<T>* a, int n, T* k, boolean upper) {
+		if (k == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		EComparable<T*>* c = (EComparable<T*>*)k;
+		int lo = 0, hi = n;
+		while (lo < hi) {
+			int mid = (lo + hi) >> 1;
+			int r = c->compareTo(a[mid].get());
+			if (r > 0 || (upper && r == 0))
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+	static sp<T> nil() {
+		return null;
+	}
+};
+
+/**
+ * The B+tree behind {@link EBTreeMap} and {@link EBTreeSet}.
+ *
+ * <p>All mappings live in the leaves, which are chained in key order;
+ * inner nodes only hold separators, each the smallest key of the subtree
+ * to its right.  A node keeps its keys in one array sized to about four
+ * cache lines (between 8 and 64 keys), so a lookup touches a few
+ * contiguous arrays instead of one heap node per comparison, and a range
+ * scan walks leaf arrays.  Nodes other than the root are kept at least
+ * half full, except that an insert at the very end of the tree (as with
+ * ascending timestamps) splits off the new key alone and leaves the old
+ * leaf full.
+ *
+ * <p>Nodes have no parent links: updates record the path on the way down.
+ */
+template<typename K, typename V>
+class EBTreeTable {
+public:
+	typedef EBTreeKeyTraits<K> Traits;
+	typedef typename Traits::indexType idxK;
+
+	static const int SLOTS = (256 / sizeof(K) > 64) ? 64 :
+			((256 / sizeof(K) < 8) ? 8 : (int)(256 / sizeof(K)));
+	static const int MIN_SLOTS = SLOTS / 2;
+	static const int MAX_HEIGHT = 40;
+
+	// Each array has one spare slot, so that a full node takes the new
+	// key first and is split afterwards.
+	struct Node {
+		int count;
+		boolean leaf;
+		K keys[SLOTS + 1];
+	};
+
+	struct Leaf: public Node {
+		V values[SLOTS + 1];
+		Leaf* prev;
+		Leaf* next;
+	};
+
+	struct Inner: public Node {
+		Node* children[SLOTS + 2];
+	};
+
+	/**
+	 * A mapping's place in the tree; <tt>leaf</tt> is null for none.
+	 */
+	struct Pos {
+		Leaf* leaf;
+		int index;
+		Pos(Leaf* leaf = null, int index = 0) : leaf(leaf), index(index) {
+		}
+		const K& key() const {
+			return leaf->keys[index];
+		}
+		V& value() const {
+			return leaf->values[index];
+		}
+	};
+
+	Node* root;
+	Leaf* head;
+	Leaf* tail;
+	int size;
+	int modCount;
+	EComparator<K>* comparator;
+
+	explicit EBTreeTable(EComparator<K>* comparator) :
+			root(null), head(null), tail(null), size(0), modCount(0),
+			comparator(comparator) {
+	}
+
+	~EBTreeTable() {
+		destroy(root);
+	}
+
+	int compare(idxK a, const K& b) {
+		return Traits::compare(comparator, a, b);
+	}
+
+	/**
+	 * Returns the index of the first key in a[0..n) that is not less
+	 * than (or, if upper, greater than) k.
+	 */
+	int search(const K* a, int n, idxK k, boolean upper) {
+		if (comparator == null)
+			return Traits::search(a, n, k, upper);
+		int lo = 0, hi = n;
+		while (lo < hi) {
+			int mid = (lo + hi) >> 1;
+			int r = Traits::compare(comparator, k, a[mid]);
+			if (r > 0 || (upper && r == 0))
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+
+	Leaf* findLeaf(idxK k) {
+		Node* n = root;
+		while (!n->leaf) {
+			Inner* in = (Inner*)n;
+			n = in->children[search(in->keys, in->count, k, true)];
+		}
+		return (Leaf*)n;
+	}
+
+	Pos find(idxK k) {
+		if (root == null)
+			return Pos();
+		Leaf* l = findLeaf(k);
+		int i = search(l->keys, l->count, k, false);
+		if (i < l->count && compare(k, l->keys[i]) == 0)
+			return Pos(l, i);
+		return Pos();
+	}
+
+	// The least key greater than or equal to (or, if !inclusive, greater than) k.
+	Pos ceiling(idxK k, boolean inclusive) {
+		if (root == null)
+			return Pos();
+		Leaf* l = findLeaf(k);
+		int i = search(l->keys, l->count, k, !inclusive);
+		if (i < l->count)
+			return Pos(l, i);
+		return Pos(l->next, 0);
+	}
+
+	// The greatest key less than or equal to (or, if !inclusive, less than) k.
+	Pos floor(idxK k, boolean inclusive) {
+		if (root == null)
+			return Pos();
+		Leaf* l = findLeaf(k);
+		int i = search(l->keys, l->count, k, inclusive) - 1;
+		if (i >= 0)
+			return Pos(l, i);
+		l = l->prev;
+		return (l == null) ? Pos() : Pos(l, l->count - 1);
+	}
+
+	Pos first() {
+		return Pos(head, 0);
+	}
+
+	Pos last() {
+		return (tail == null) ? Pos() : Pos(tail, tail->count - 1);
+	}
+
+	static void next(Pos& p) {
+		if (++p.index >= p.leaf->count) {
+			p.leaf = p.leaf->next;
+			p.index = 0;
+		}
+	}
+
+	static void prev(Pos& p) {
+		if (--p.index < 0) {
+			p.leaf = p.leaf->prev;
+			p.index = (p.leaf == null) ? 0 : p.leaf->count - 1;
+		}
+	}
+
+	/**
+	 * Inserts the mapping unless the key is present, in which case
+	 * existing is set to it and nothing changes.
+	 */
+	boolean insert(const K& key, const V& value, Pos& existing) {
+		idxK k = Traits::index(key);
+		if (root == null) {
+			Leaf* l = newLeaf();
+			l->keys[0] = key;
+			l->values[0] = value;
+			l->count = 1;
+			root = head = tail = l;
+			size = 1;
+			modCount++;
+			return true;
+		}
+
+		Inner* path[MAX_HEIGHT];
+		int slots[MAX_HEIGHT];
+		int depth = 0;
+		Node* n = root;
+		while (!n->leaf) {
+			Inner* in = (Inner*)n;
+			int i = search(in->keys, in->count, k, true);
+			path[depth] = in;
+			slots[depth++] = i;
+			n = in->children[i];
+		}
+		Leaf* l = (Leaf*)n;
+		int i = search(l->keys, l->count, k, false);
+		if (i < l->count && compare(k, l->keys[i]) == 0) {
+			existing = Pos(l, i);
+			return false;
+		}
+		for (int j = l->count; j > i; j--) {
+			l->keys[j] = l->keys[j - 1];
+			l->values[j] = l->values[j - 1];
+		}
+		l->keys[i] = key;
+		l->values[i] = value;
+		l->count++;
+		size++;
+		modCount++;
+		if (l->count > SLOTS) {
+			splitLeaf(l, i, path, slots, depth);
+		}
+		return true;
+	}
+
+	/**
+	 * Removes the mapping for k if present and hands its key and value
+	 * out, to be released by the caller once k is no longer needed.
+	 */
+	boolean remove(idxK k, K& oldKey, V& oldValue) {
+		if (root == null)
+			return false;
+
+		Inner* path[MAX_HEIGHT];
+		int slots[MAX_HEIGHT];
+		int depth = 0;
+		Node* n = root;
+		while (!n->leaf) {
+			Inner* in = (Inner*)n;
+			int i = search(in->keys, in->count, k, true);
+			path[depth] = in;
+			slots[depth++] = i;
+			n = in->children[i];
+		}
+		Leaf* l = (Leaf*)n;
+		int i = search(l->keys, l->count, k, false);
+		if (i >= l->count || compare(k, l->keys[i]) != 0)
+			return false;
+
+		oldKey = l->keys[i];
+		oldValue = l->values[i];
+		for (int j = i + 1; j < l->count; j++) {
+			l->keys[j - 1] = l->keys[j];
+			l->values[j - 1] = l->values[j];
+		}
+		l->count--;
+		l->keys[l->count] = K();
+		l->values[l->count] = V();
+		size--;
+		modCount++;
+
+		if (depth == 0) {
+			if (l->count == 0) {
+				delete l;
+				root = head = tail = null;
+			}
+			return true;
+		}
+
+		// The leaf's smallest key is also the separator in the deepest
+		// ancestor that was left by a right turn; it must not outlive
+		// the key.
+		K* separator = null;
+		if (i == 0) {
+			for (int d = depth - 1; d >= 0; d--) {
+				if (slots[d] > 0) {
+					separator = &path[d]->keys[slots[d] - 1];
+					break;
+				}
+			}
+		}
+		if (separator != null && l->count > 0) {
+			*separator = l->keys[0];
+			separator = null;
+		}
+		if (l->count < MIN_SLOTS) {
+			// an emptied leaf that is not a first child takes its
+			// separator, which is in the parent, along with it.
+			if (slots[depth - 1] > 0) {
+				separator = null;
+			}
+			boolean merged = rebalanceLeaf(l, path, slots, depth);
+			// before the inner nodes, and so the separator, move
+			if (separator != null) {
+				*separator = l->keys[0];
+			}
+			if (merged) {
+				rebalanceInner(path, slots, depth - 1);
+			}
+		}
+		return true;
+	}
+
+	void clear() {
+		destroy(root);
+		root = head = tail = null;
+		size = 0;
+		modCount++;
+	}
+
+	/**
+	 * Builds the tree bottom up from n ascending keys (and values, unless
+	 * null), packing the leaves full.  The tree must be empty.
+	 */
+	void build(const K* keys, const V* values, int n) {
+		if (n == 0)
+			return;
+		int count = (n + SLOTS - 1) / SLOTS;
+		Node** level = new Node*[count];
+		K* mins = new K[count];
+		Leaf* prev = null;
+		for (int c = 0, off = 0; c < count; c++) {
+			// spread the remainder so that no leaf is underfull
+			int m = n / count + (c < n % count ? 1 : 0);
+			Leaf* l = newLeaf();
+			for (int j = 0; j < m; j++) {
+				l->keys[j] = keys[off + j];
+				if (values != null) {
+					l->values[j] = values[off + j];
+				}
+			}
+			l->count = m;
+			l->prev = prev;
+			if (prev != null) {
+				prev->next = l;
+			}
+			prev = l;
+			level[c] = l;
+			mins[c] = keys[off];
+			off += m;
+		}
+		head = (Leaf*)level[0];
+		tail = prev;
+		while (count > 1) {
+			int parents = (count + SLOTS) / (SLOTS + 1);
+			for (int c = 0, off = 0; c < parents; c++) {
+				int m = count / parents + (c < count % parents ? 1 : 0);
+				Inner* in = newInner();
+				for (int j = 0; j < m; j++) {
+					in->children[j] = level[off + j];
+					if (j > 0) {
+						in->keys[j - 1] = mins[off + j];
+					}
+				}
+				in->count = m - 1;
+				level[c] = in;
+				mins[c] = mins[off];
+				off += m;
+			}
+			count = parents;
+		}
+		root = level[0];
+		size = n;
+		modCount++;
+		delete[] level;
+		delete[] mins;
+	}
+
+private:
+	static Leaf* newLeaf() {
+		Leaf* l = new Leaf();
+		l->leaf = true;
+		l->count = 0;
+		l->prev = l->next = null;
+		return l;
+	}
+
+	static Inner* newInner() {
+		Inner* in = new Inner();
+		in->leaf = false;
+		in->count = 0;
+		return in;
+	}
+
+	static void destroy(Node* n) {
+		if (n == null)
+			return;
+		if (n->leaf) {
+			delete (Leaf*)n;
+			return;
+		}
+		Inner* in = (Inner*)n;
+		for (int i = 0; i <= in->count; i++) {
+			destroy(in->children[i]);
+		}
+		delete in;
+	}
+
+	void splitLeaf(Leaf* l, int pos, Inner** path, int* slots, int depth) {
+		int count = l->count;
+		boolean append = (pos == count - 1 && l->next == null);
+		int s = append ? count - 1 : count / 2;
+		Leaf* r = newLeaf();
+		for (int j = s; j < count; j++) {
+			r->keys[j - s] = l->keys[j];
+			r->values[j - s] = l->values[j];
+			l->keys[j] = K();
+			l->values[j] = V();
+		}
+		r->count = count - s;
+		l->count = s;
+		r->next = l->next;
+		r->prev = l;
+		if (l->next != null) {
+			l->next->prev = r;
+		} else {
+			tail = r;
+		}
+		l->next = r;
+		insertChild(r->keys[0], r, path, slots, depth, append);
+	}
+
+	void insertChild(const K& separator, Node* child, Inner** path, int* slots,
+			int depth, boolean append) {
+		if (depth == 0) {
+			Inner* r = newInner();
+			r->keys[0] = separator;
+			r->children[0] = root;
+			r->children[1] = child;
+			r->count = 1;
+			root = r;
+			return;
+		}
+		Inner* p = path[depth - 1];
+		int i = slots[depth - 1];
+		for (int j = p->count; j > i; j--) {
+			p->keys[j] = p->keys[j - 1];
+			p->children[j + 1] = p->children[j];
+		}
+		p->keys[i] = separator;
+		p->children[i + 1] = child;
+		p->count++;
+		if (p->count <= SLOTS)
+			return;
+
+		int count = p->count;
+		int s = append ? count - 2 : count / 2;
+		Inner* r = newInner();
+		K up = p->keys[s];
+		for (int j = s + 1; j < count; j++) {
+			r->keys[j - s - 1] = p->keys[j];
+			p->keys[j] = K();
+		}
+		for (int j = s + 1; j <= count; j++) {
+			r->children[j - s - 1] = p->children[j];
+		}
+		p->keys[s] = K();
+		r->count = count - s - 1;
+		p->count = s;
+		insertChild(up, r, path, slots, depth - 1, append);
+	}
+
+	// Drops keys[j - 1] and children[j].
+	static void removeChild(Inner* p, int j) {
+		for (int x = j; x < p->count; x++) {
+			p->keys[x - 1] = p->keys[x];
+			p->children[x] = p->children[x + 1];
+		}
+		p->count--;
+		p->keys[p->count] = K();
+	}
+
+	// Returns whether two leaves were merged, leaving the parent a child short.
+	boolean rebalanceLeaf(Leaf* l, Inner** path, int* slots, int depth) {
+		Inner* p = path[depth - 1];
+		int j = slots[depth - 1];
+		if (j > 0) {
+			Leaf* left = (Leaf*)p->children[j - 1];
+			if (left->count > MIN_SLOTS) {
+				for (int x = l->count; x > 0; x--) {
+					l->keys[x] = l->keys[x - 1];
+					l->values[x] = l->values[x - 1];
+				}
+				int last = --left->count;
+				l->keys[0] = left->keys[last];
+				l->values[0] = left->values[last];
+				left->keys[last] = K();
+				left->values[last] = V();
+				l->count++;
+				p->keys[j - 1] = l->keys[0];
+				return false;
+			}
+			for (int x = 0; x < l->count; x++) {
+				left->keys[left->count + x] = l->keys[x];
+				left->values[left->count + x] = l->values[x];
+			}
+			left->count += l->count;
+			unlink(l);
+			removeChild(p, j);
+			delete l;
+		} else {
+			Leaf* right = (Leaf*)p->children[1];
+			if (right->count > MIN_SLOTS) {
+				l->keys[l->count] = right->keys[0];
+				l->values[l->count] = right->values[0];
+				l->count++;
+				for (int x = 1; x < right->count; x++) {
+					right->keys[x - 1] = right->keys[x];
+					right->values[x - 1] = right->values[x];
+				}
+				int last = --right->count;
+				right->keys[last] = K();
+				right->values[last] = V();
+				p->keys[0] = right->keys[0];
+				return false;
+			}
+			for (int x = 0; x < right->count; x++) {
+				l->keys[l->count + x] = right->keys[x];
+				l->values[l->count + x] = right->values[x];
+			}
+			l->count += right->count;
+			unlink(right);
+			removeChild(p, 1);
+			delete right;
+		}
+		return true;
+	}
+
+	void unlink(Leaf* l) {
+		if (l->prev != null) {
+			l->prev->next = l->next;
+		} else {
+			head = l->next;
+		}
+		if (l->next != null) {
+			l->next->prev = l->prev;
+		} else {
+			tail = l->prev;
+		}
+	}
+
+	void rebalanceInner(Inner** path, int* slots, int d) {
+		for (;;) {
+			Inner* n = path[d];
+			if (d == 0) {
+				if (n->count == 0) {
+					root = n->children[0];
+					delete n;
+				}
+				return;
+			}
+			if (n->count >= MIN_SLOTS)
+				return;
+			Inner* p = path[d - 1];
+			int j = slots[d - 1];
+			if (j > 0) {
+				Inner* left = (Inner*)p->children[j - 1];
+				if (left->count > MIN_SLOTS) {
+					// rotate one child over through the parent
+					n->children[n->count + 1] = n->children[n->count];
+					for (int x = n->count; x > 0; x--) {
+						n->keys[x] = n->keys[x - 1];
+						n->children[x] = n->children[x - 1];
+					}
+					n->keys[0] = p->keys[j - 1];
+					n->children[0] = left->children[left->count];
+					n->count++;
+					int last = --left->count;
+					p->keys[j - 1] = left->keys[last];
+					left->keys[last] = K();
+					return;
+				}
+				left->keys[left->count] = p->keys[j - 1];
+				for (int x = 0; x < n->count; x++) {
+					left->keys[left->count + 1 + x] = n->keys[x];
+				}
+				for (int x = 0; x <= n->count; x++) {
+					left->children[left->count + 1 + x] = n->children[x];
+				}
+				left->count += n->count + 1;
+				removeChild(p, j);
+				delete n;
+			} else {
+				Inner* right = (Inner*)p->children[1];
+				if (right->count > MIN_SLOTS) {
+					n->keys[n->count] = p->keys[0];
+					n->children[n->count + 1] = right->children[0];
+					n->count++;
+					p->keys[0] = right->keys[0];
+					for (int x = 1; x < right->count; x++) {
+						right->keys[x - 1] = right->keys[x];
+					}
+					for (int x = 1; x <= right->count; x++) {
+						right->children[x - 1] = right->children[x];
+					}
+					int last = --right->count;
+					right->keys[last] = K();
+					return;
+				}
+				n->keys[n->count] = p->keys[0];
+				for (int x = 0; x < right->count; x++) {
+					n->keys[n->count + 1 + x] = right->keys[x];
+				}
+				for (int x = 0; x <= right->count; x++) {
+					n->children[n->count + 1 + x] = right->children[x];
+				}
+				n->count += right->count + 1;
+				removeChild(p, 1);
+				delete right;
+			}
+			d--;
+		}
+	}
+};
+
+/**
+ * A B+tree based {@link ENavigableMap} implementation, and a cache
+ * friendly alternative to the red-black {@link ETreeMap}.
+ *
+ * <p>A red-black tree spends a heap node and three links per mapping and
+ * takes a likely cache miss at every level of a lookup.  This map keeps
+ * up to 64 keys of a node in one contiguous array (see
+ * {@link EBTreeTable}), so a lookup in a million mappings visits four or
+ * five nodes, and iteration and range scans walk chained leaf arrays.
+ * Costs are O(log n) for <tt>get</tt>, <tt>put</tt> and <tt>remove</tt>,
+ * and {@link #bulkLoad} builds a map from sorted input in linear time.
+ *
+ * <p>Keys may be primitives, native pointers or shared pointers, ordered
+ * by their natural ordering or by a comparator; values native or shared
+ * pointers.  Native pointers are owned by the map when <tt>autoFree</tt>
+ * is set.  For primitive keys the key queries (<tt>lowerKey</tt> and the
+ * like) throw <tt>ENoSuchElementException</tt> where a <tt>null</tt> key
+ * would be returned.
+ *
+ * <p>Unlike in {@link ETreeMap}, mappings move between nodes, so the
+ * entries returned by the navigation methods (<tt>firstEntry</tt>,
+ * <tt>ceilingEntry</tt>, ...) are immutable snapshots owned by the map,
+ * valid until the next such call; <tt>pollFirstEntry</tt> and
+ * <tt>pollLastEntry</tt> hand the removed key and value over to the
+ * caller.  The views returned by <tt>subMap</tt>, <tt>headMap</tt>,
+ * <tt>tailMap</tt> and <tt>descendingMap</tt> are backed by this map and
+ * are deleted by the caller.  Iterators are fail-fast.
+ *
+ * <p><strong>Note that this implementation is not synchronized.</strong>
+ *
+ * @param <K> the type of keys maintained by this map
+ * @param <V> the type of mapped values
+ */
+template<typename K, typename V>
+class EBTreeMap: public EAbstractMap<K, V>, virtual public ENavigableMap<K, V> {
+public:
+	typedef typename EMap<K, V>::idxK idxK;
+	typedef typename EMap<K, V>::idxV idxV;
+
+	virtual ~EBTreeMap() {
+		releaseAll();
+	}
+
+	/**
+	 * Constructs a new, empty map, sorted according to the natural
+	 * ordering of its keys.
+	 */
+	explicit
+	EBTreeMap(boolean autoFree = true) :
+			table(null), all(), _autoFree(autoFree) {
+	}
+
+	/**
+	 * Constructs a new, empty map, ordered according to the given
+	 * comparator, which the map does not own.
+	 */
+	explicit
+	EBTreeMap(EComparator<K>* comparator, boolean autoFree = true) :
+			table(comparator), all(), _autoFree(autoFree) {
+	}
+
+	int size() {
+		return table.size;
+	}
+
+	boolean isEmpty() {
+		return table.size == 0;
+	}
+
+	/**
+	 * Returns the value to which the specified key is mapped, or
+	 * {@code null} if this map contains no mapping for the key.
+	 */
+	V get(idxK key) {
+		Pos p = table.find(key);
+		return (p.leaf == null) ? V() : p.value();
+	}
+
+	boolean containsKey(idxK key) {
+		return table.find(key).leaf != null;
+	}
+
+	boolean containsValue(idxV value) {
+		for (Pos p = table.first(); p.leaf != null; Table::next(p)) {
+			if (VTraits::equals(value, VTraits::index(p.value())))
+				return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Associates the specified value with the specified key in this map.
+	 * If the map previously contained a mapping for the key, the old
+	 * value is replaced and returned, and the new key is released.
+	 *
+	 * @throws NullPointerException if the key is null and the map uses
+	 *         natural ordering
+	 */
+	V put(K key, V value, boolean *absent=null) {
+		Pos p;
+		if (table.insert(key, value, p)) {
+			if (absent) *absent = true;
+			return V();
+		}
+		if (absent) *absent = false;
+		V oldValue = p.value();
+		p.value() = value;
+		if (_autoFree && KTraits::index(p.key()) != KTraits::index(key)) {
+			KTraits::release(key);
+		}
+		return oldValue;
+	}
+
+	/**
+	 * Removes the mapping for the specified key from this map if present,
+	 * and returns its value, which the caller then owns.
+	 */
+	V remove(idxK key) {
+		K k;
+		V v;
+		if (!table.remove(key, k, v))
+			return V();
+		if (_autoFree) {
+			KTraits::release(k);
+		}
+		return v;
+	}
+
+	void clear() {
+		releaseAll();
+		table.clear();
+	}
+
+	/**
+	 * Replaces the contents of this empty map with the given mappings, in
+	 * linear time; with no values, every key maps to <tt>null</tt>.  With
+	 * <tt>autoFree</tt> the map takes native pointer keys and values over,
+	 * so the arrays must not free them.
+	 *
+	 * @throws IllegalStateException if the map is not empty
+	 * @throws IllegalArgumentException if the arrays differ in length or
+	 *         the keys are not strictly ascending
+	 */
+	void bulkLoad(EA<K>* keys, EA<V>* values = null) {
+		if (table.size != 0)
+			throw EIllegalStateException(__FILE__, __LINE__, "map is not empty");
+		if (values != null && keys->length() != values->length())
+			throw EIllegalArgumentException(__FILE__, __LINE__);
+		checkAscending(keys);
+		table.build(keys->address(), (values != null) ? values->address() : null,
+				keys->length());
+	}
+
+	EComparator<K>* comparator() {
+		return table.comparator;
+	}
+
+	/**
+	 * @throws NoSuchElementException if this map is empty
+	 */
+	K firstKey() {
+		return key(table.first());
+	}
+
+	/**
+	 * @throws NoSuchElementException if this map is empty
+	 */
+	K lastKey() {
+		return key(table.last());
+	}
+
+	// NavigableMap API methods
+
+	EMapEntry<K,V>* firstEntry() {
+		return exportEntry(table.first());
+	}
+
+	EMapEntry<K,V>* lastEntry() {
+		return exportEntry(table.last());
+	}
+
+	EMapEntry<K,V>* pollFirstEntry() {
+		return pollEntry(table.first());
+	}
+
+	EMapEntry<K,V>* pollLastEntry() {
+		return pollEntry(table.last());
+	}
+
+	EMapEntry<K,V>* lowerEntry(K key) {
+		return exportEntry(table.floor(KTraits::index(key), false));
+	}
+
+	K lowerKey(K key) {
+		return keyOrNil(table.floor(KTraits::index(key), false));
+	}
+
+	EMapEntry<K,V>* floorEntry(K key) {
+		return exportEntry(table.floor(KTraits::index(key), true));
+	}
+
+	K floorKey(K key) {
+		return keyOrNil(table.floor(KTraits::index(key), true));
+	}
+
+	EMapEntry<K,V>* ceilingEntry(K key) {
+		return exportEntry(table.ceiling(KTraits::index(key), true));
+	}
+
+	K ceilingKey(K key) {
+		return keyOrNil(table.ceiling(KTraits::index(key), true));
+	}
+
+	EMapEntry<K,V>* higherEntry(K key) {
+		return exportEntry(table.ceiling(KTraits::index(key), false));
+	}
+
+	K higherKey(K key) {
+		return keyOrNil(table.ceiling(KTraits::index(key), false));
+	}
+
+	// Views
+
+	sp<ESet<K> > keySet() {
+		return navigableKeySet();
+	}
+
+	sp<ENavigableSet<K> > navigableKeySet() {
+		if (!_navigableKeySet) {
+			_navigableKeySet = new KeySet(this, all, false, this, false);
+		}
+		return _navigableKeySet;
+	}
+
+	sp<ENavigableSet<K> > descendingKeySet() {
+		return new KeySet(this, all, true, descendingMap(), true);
+	}
+
+	/**
+	 * Returns a collection view of the values, in ascending key order.
+	 */
+	sp<ECollection<V> > values() {
+		if (!EAbstractMap<K,V>::_values) {
+			EAbstractMap<K,V>::_values = new Values(this, all, false, this);
+		}
+		return EAbstractMap<K,V>::_values;
+	}
+
+	/**
+	 * Returns a set view of the mappings, in ascending key order.  Its
+	 * iterator returns itself as the entry, valid until the next call to
+	 * <tt>next</tt>.
+	 */
+	sp<ESet<EMapEntry<K,V>*> > entrySet() {
+		if (!_entrySet) {
+			_entrySet = new EntrySet(this, all, false, this);
+		}
+		return _entrySet;
+	}
+
+	ENavigableMap<K,V>* descendingMap() {
+		return new SubMap(this, all, true);
+	}
+
+	/**
+	 * @throws IllegalArgumentException if fromKey is greater than toKey
+	 */
+	ENavigableMap<K,V>* subMap(K fromKey, boolean fromInclusive,
+			K toKey, boolean toInclusive) {
+		if (KTraits::compare(table.comparator, KTraits::index(fromKey), toKey) > 0)
+			throw EIllegalArgumentException(__FILE__, __LINE__, "fromKey > toKey");
+		Range r;
+		r.setLow(fromKey, fromInclusive);
+		r.setHigh(toKey, toInclusive);
+		return new SubMap(this, r, false);
+	}
+
+	ENavigableMap<K,V>* headMap(K toKey, boolean inclusive) {
+		Range r;
+		r.setHigh(toKey, inclusive);
+		return new SubMap(this, r, false);
+	}
+
+	ENavigableMap<K,V>* tailMap(K fromKey, boolean inclusive) {
+		Range r;
+		r.setLow(fromKey, inclusive);
+		return new SubMap(this, r, false);
+	}
+
+	ESortedMap<K,V>* subMap(K fromKey, K toKey) {
+		return subMap(fromKey, true, toKey, false);
+	}
+
+	ESortedMap<K,V>* headMap(K toKey) {
+		return headMap(toKey, false);
+	}
+
+	ESortedMap<K,V>* tailMap(K fromKey) {
+		return tailMap(fromKey, true);
+	}
+
+	sp<EIterator<K> > keyIterator() {
+		return new KeyIterator(this, all, false);
+	}
+
+	sp<EIterator<K> > descendingKeyIterator() {
+		return new KeyIterator(this, all, true);
+	}
+
+	void setAutoFree(boolean autoFree = true) {
+		_autoFree = autoFree;
+	}
+
+	boolean getAutoFree() {
+		return _autoFree;
+	}
+
+private:
+	typedef EBTreeKeyTraits<K> KTraits;
+	typedef EFlatHashTraits<V> VTraits;
+	typedef EBTreeTable<K, V> Table;
+	typedef typename Table::Pos Pos;
+
+	/**
+	 * The key bounds of a view; unbounded on a side that is "open".
+	 */
+	struct Range {
+		K lo;
+		K hi;
+		boolean fromStart;
+		boolean loInclusive;
+		boolean toEnd;
+		boolean hiInclusive;
+
+		Range() : lo(), hi(), fromStart(true), loInclusive(false),
+				toEnd(true), hiInclusive(false) {
+		}
+		void setLow(const K& k, boolean inclusive) {
+			lo = k;
+			fromStart = false;
+			loInclusive = inclusive;
+		}
+		void setHigh(const K& k, boolean inclusive) {
+			hi = k;
+			toEnd = false;
+			hiInclusive = inclusive;
+		}
+	};
+
+	/**
+	 * Immutable entry handed out by the navigation methods.
+	 */
+	class Snapshot: public EMapEntry<K,V> {
+	public:
+		K key;
+		V value;
+
+		Snapshot() : key(), value() {
+		}
+		K getKey() {
+			return key;
+		}
+		V getValue() {
+			return value;
+		}
+		V setValue(V value) {
+			throw EUnsupportedOperationException(__FILE__, __LINE__);
+		}
+		boolean equals(EMapEntry<K,V>* e) {
+			return KTraits::equals(KTraits::index(key), KTraits::index(e->getKey()))
+					&& VTraits::equals(VTraits::index(value), VTraits::index(e->getValue()));
+		}
+		virtual int hashCode() {
+			return (int)KTraits::hash(KTraits::index(key))
+					^ (int)VTraits::hash(VTraits::index(value));
+		}
+	};
+
+	Table table;
+
+	/**
+	 * The unbounded range of the map itself.
+	 */
+	Range all;
+
+	/**
+	 * The entry last returned by a navigation method.
+	 */
+	Snapshot exported;
+
+	/**
+	 * Auto free object flag
+	 */
+	boolean _autoFree;
+
+	/**
+	 * Views, created on first use.
+	 */
+	sp<ESet<EMapEntry<K,V>*> > _entrySet;
+	sp<ENavigableSet<K> > _navigableKeySet;
+
+	// unsupported.
+	EBTreeMap(const EBTreeMap<K, V>& that);
+	EBTreeMap<K, V>& operator= (const EBTreeMap<K, V>& that);
+
+	void releaseAll() {
+		if (!_autoFree)
+			return;
+		for (Pos p = table.first(); p.leaf != null; Table::next(p)) {
+			KTraits::release(p.leaf->keys[p.index]);
+			VTraits::release(p.value());
+		}
+	}
+
+	void checkAscending(EA<K>* keys) {
+		for (int i = 1; i < keys->length(); i++) {
+			if (KTraits::compare(table.comparator, KTraits::index((*keys)[i - 1]), (*keys)[i]) >= 0)
+				throw EIllegalArgumentException(__FILE__, __LINE__, "keys are not ascending");
+		}
+	}
+
+	static K key(const Pos& p) {
+		if (p.leaf == null)
+			throw ENoSuchElementException(__FILE__, __LINE__);
+		return p.key();
+	}
+
+	static K keyOrNil(const Pos& p) {
+		return (p.leaf == null) ? KTraits::nil() : p.key();
+	}
+
+	EMapEntry<K,V>* exportEntry(const Pos& p) {
+		if (p.leaf == null)
+			return null;
+		exported.key = p.key();
+		exported.value = p.value();
+		return &exported;
+	}
+
+	EMapEntry<K,V>* pollEntry(const Pos& p) {
+		if (p.leaf == null)
+			return null;
+		exported.key = p.key();
+		exported.value = p.value();
+		K k;
+		V v;
+		table.remove(KTraits::index(exported.key), k, v);
+		return &exported;
+	}
+
+	// Range checks and bounded navigation shared by the views
+
+	boolean tooLow(const Range& r, idxK k) {
+		if (r.fromStart)
+			return false;
+		int c = table.compare(k, r.lo);
+		return c < 0 || (c == 0 && !r.loInclusive);
+	}
+
+	boolean tooHigh(const Range& r, idxK k) {
+		if (r.toEnd)
+			return false;
+		int c = table.compare(k, r.hi);
+		return c > 0 || (c == 0 && !r.hiInclusive);
+	}
+
+	boolean inRange(const Range& r, idxK k) {
+		return !tooLow(r, k) && !tooHigh(r, k);
+	}
+
+	// a bound of a nested view may equal an exclusive bound of its parent
+	boolean inClosedRange(const Range& r, idxK k) {
+		return (r.fromStart || table.compare(k, r.lo) >= 0)
+				&& (r.toEnd || table.compare(k, r.hi) <= 0);
+	}
+
+	Pos lowest(const Range& r) {
+		Pos p = r.fromStart ? table.first() :
+				table.ceiling(KTraits::index(r.lo), r.loInclusive);
+		return (p.leaf == null || tooHigh(r, KTraits::index(p.key()))) ? Pos() : p;
+	}
+
+	Pos highest(const Range& r) {
+		Pos p = r.toEnd ? table.last() :
+				table.floor(KTraits::index(r.hi), r.hiInclusive);
+		return (p.leaf == null || tooLow(r, KTraits::index(p.key()))) ? Pos() : p;
+	}
+
+	Pos ceiling(const Range& r, idxK k, boolean inclusive) {
+		if (tooLow(r, k))
+			return lowest(r);
+		Pos p = table.ceiling(k, inclusive);
+		return (p.leaf == null || tooHigh(r, KTraits::index(p.key()))) ? Pos() : p;
+	}
+
+	Pos floor(const Range& r, idxK k, boolean inclusive) {
+		if (tooHigh(r, k))
+			return highest(r);
+		Pos p = table.floor(k, inclusive);
+		return (p.leaf == null || tooLow(r, KTraits::index(p.key()))) ? Pos() : p;
+	}
+
+	// Counts whole leaves between the ends of the range.
+	int count(const Range& r) {
+		Pos lo = lowest(r);
+		if (lo.leaf == null)
+			return 0;
+		Pos hi = highest(r);
+		if (lo.leaf == hi.leaf)
+			return hi.index - lo.index + 1;
+		int n = lo.leaf->count - lo.index + hi.index + 1;
+		for (typename Table::Leaf* l = lo.leaf->next; l != hi.leaf; l = l->next) {
+			n += l->count;
+		}
+		return n;
+	}
+
+	template<typename T>
+	class Itr: public EIterator<T> {
+	protected:
+		EBTreeMap<K,V>* m;
+		Range r;
+		boolean descending;
+		Pos nextPos;
+		Pos lastPos;
+		int expectedModCount;
+
+		Pos& advance() {
+			if (m->table.modCount != expectedModCount)
+				throw EConcurrentModificationException(__FILE__, __LINE__);
+			if (nextPos.leaf == null)
+				throw ENoSuchElementException(__FILE__, __LINE__);
+			lastPos = nextPos;
+			if (descending) {
+				Table::prev(nextPos);
+				if (nextPos.leaf != null && m->tooLow(r, KTraits::index(nextPos.key())))
+					nextPos = Pos();
+			} else {
+				Table::next(nextPos);
+				if (nextPos.leaf != null && m->tooHigh(r, KTraits::index(nextPos.key())))
+					nextPos = Pos();
+			}
+			return lastPos;
+		}
+
+		Pos& current() {
+			if (lastPos.leaf == null)
+				throw EIllegalStateException(__FILE__, __LINE__, "Entry was removed");
+			return lastPos;
+		}
+
+		// Removes the last returned mapping.  Removal may move the
+		// following mapping to another leaf, so it is looked up again.
+		void removeLast(K& k, V& v) {
+			if (lastPos.leaf == null)
+				throw EIllegalStateException(__FILE__, __LINE__);
+			if (m->table.modCount != expectedModCount)
+				throw EConcurrentModificationException(__FILE__, __LINE__);
+			boolean more = (nextPos.leaf != null);
+			K nk = more ? nextPos.key() : K();
+			m->table.remove(KTraits::index(lastPos.key()), k, v);
+			if (more) {
+				nextPos = m->table.find(KTraits::index(nk));
+			}
+			lastPos = Pos();
+			expectedModCount = m->table.modCount;
+		}
+
+	public:
+		Itr(EBTreeMap<K,V>* m, const Range& r, boolean descending) :
+				m(m), r(r), descending(descending) {
+			expectedModCount = m->table.modCount;
+			nextPos = descending ? m->highest(r) : m->lowest(r);
+		}
+
+		boolean hasNext() {
+			return nextPos.leaf != null;
+		}
+
+		void remove() {
+			K k;
+			V v;
+			removeLast(k, v);
+			if (m->_autoFree) {
+				KTraits::release(k);
+				VTraits::release(v);
+			}
+		}
+	};
+
+	class KeyIterator: public Itr<K> {
+	public:
+		KeyIterator(EBTreeMap<K,V>* m, const Range& r, boolean descending) :
+				Itr<K>(m, r, descending) {
+		}
+		K next() {
+			return this->advance().key();
+		}
+		K moveOut() {
+			K k;
+			V v;
+			this->removeLast(k, v);
+			if (this->m->_autoFree) {
+				VTraits::release(v);
+			}
+			return k;
+		}
+	};
+
+	class ValueIterator: public Itr<V> {
+	public:
+		ValueIterator(EBTreeMap<K,V>* m, const Range& r, boolean descending) :
+				Itr<V>(m, r, descending) {
+		}
+		V next() {
+			return this->advance().value();
+		}
+		V moveOut() {
+			K k;
+			V v;
+			this->removeLast(k, v);
+			if (this->m->_autoFree) {
+				KTraits::release(k);
+			}
+			return v;
+		}
+	};
+
+	class EntryIterator: public Itr<EMapEntry<K,V>*>, public EMapEntry<K,V> {
+	public:
+		EntryIterator(EBTreeMap<K,V>* m, const Range& r, boolean descending) :
+				Itr<EMapEntry<K,V>*>(m, r, descending) {
+		}
+		EMapEntry<K,V>* next() {
+			this->advance();
+			return this;
+		}
+		EMapEntry<K,V>* moveOut() {
+			throw EUnsupportedOperationException(__FILE__, __LINE__);
+		}
+		K getKey() {
+			return this->current().key();
+		}
+		V getValue() {
+			return this->current().value();
+		}
+		V setValue(V value) {
+			V& slot = this->current().value();
+			V oldValue = slot;
+			slot = value;
+			return oldValue;
+		}
+		boolean equals(EMapEntry<K,V>* e) {
+			return KTraits::equals(KTraits::index(getKey()), KTraits::index(e->getKey()))
+					&& VTraits::equals(VTraits::index(getValue()), VTraits::index(e->getValue()));
+		}
+		virtual int hashCode() {
+			return (int)KTraits::hash(KTraits::index(getKey()))
+					^ (int)VTraits::hash(VTraits::index(getValue()));
+		}
+	};
+
+	/**
+	 * The map restricted to a key range, ascending or descending; also
+	 * the descending view of the whole map.
+	 */
+	class SubMap: public EAbstractMap<K,V>, virtual public ENavigableMap<K,V> {
+	public:
+		EBTreeMap<K,V>* m;
+		Range r;
+		boolean descending;
+
+		SubMap(EBTreeMap<K,V>* m, const Range& r, boolean descending) :
+				m(m), r(r), descending(descending), reverse(m->comparator()) {
+		}
+
+		int size() {
+			return (r.fromStart && r.toEnd) ? m->size() : m->count(r);
+		}
+
+		boolean isEmpty() {
+			return m->lowest(r).leaf == null;
+		}
+
+		V get(idxK key) {
+			return m->inRange(r, key) ? m->get(key) : V();
+		}
+
+		boolean containsKey(idxK key) {
+			return m->inRange(r, key) && m->containsKey(key);
+		}
+
+		boolean containsValue(idxV value) {
+			Pos p = m->lowest(r);
+			for (; p.leaf != null && !m->tooHigh(r, KTraits::index(p.key())); Table::next(p)) {
+				if (VTraits::equals(value, VTraits::index(p.value())))
+					return true;
+			}
+			return false;
+		}
+
+		/**
+		 * @throws IllegalArgumentException if the key is out of range
+		 */
+		V put(K key, V value, boolean *absent=null) {
+			if (!m->inRange(r, KTraits::index(key)))
+				throw EIllegalArgumentException(__FILE__, __LINE__, "key out of range");
+			return m->put(key, value, absent);
+		}
+
+		V remove(idxK key) {
+			return m->inRange(r, key) ? m->remove(key) : V();
+		}
+
+		void clear() {
+			for (Pos p = m->lowest(r); p.leaf != null; p = m->lowest(r)) {
+				K k;
+				V v;
+				m->table.remove(KTraits::index(p.key()), k, v);
+				if (m->_autoFree) {
+					KTraits::release(k);
+					VTraits::release(v);
+				}
+			}
+		}
+
+		EComparator<K>* comparator() {
+			return descending ? &reverse : m->comparator();
+		}
+
+		K firstKey() {
+			return key(first());
+		}
+
+		K lastKey() {
+			return key(last());
+		}
+
+		EMapEntry<K,V>* firstEntry() {
+			return m->exportEntry(first());
+		}
+
+		EMapEntry<K,V>* lastEntry() {
+			return m->exportEntry(last());
+		}
+
+		EMapEntry<K,V>* pollFirstEntry() {
+			return m->pollEntry(first());
+		}
+
+		EMapEntry<K,V>* pollLastEntry() {
+			return m->pollEntry(last());
+		}
+
+		EMapEntry<K,V>* lowerEntry(K key) {
+			return m->exportEntry(lower(KTraits::index(key), false));
+		}
+
+		K lowerKey(K key) {
+			return keyOrNil(lower(KTraits::index(key), false));
+		}
+
+		EMapEntry<K,V>* floorEntry(K key) {
+			return m->exportEntry(lower(KTraits::index(key), true));
+		}
+
+		K floorKey(K key) {
+			return keyOrNil(lower(KTraits::index(key), true));
+		}
+
+		EMapEntry<K,V>* ceilingEntry(K key) {
+			return m->exportEntry(higher(KTraits::index(key), true));
+		}
+
+		K ceilingKey(K key) {
+			return keyOrNil(higher(KTraits::index(key), true));
+		}
+
+		EMapEntry<K,V>* higherEntry(K key) {
+			return m->exportEntry(higher(KTraits::index(key), false));
+		}
+
+		K higherKey(K key) {
+			return keyOrNil(higher(KTraits::index(key), false));
+		}
+
+		sp<ESet<K> > keySet() {
+			return navigableKeySet();
+		}
+
+		sp<ENavigableSet<K> > navigableKeySet() {
+			if (!_navigableKeySet) {
+				_navigableKeySet = new KeySet(m, r, descending, this, false);
+			}
+			return _navigableKeySet;
+		}
+
+		sp<ENavigableSet<K> > descendingKeySet() {
+			return new KeySet(m, r, !descending, descendingMap(), true);
+		}
+
+		sp<ECollection<V> > values() {
+			if (!EAbstractMap<K,V>::_values) {
+				EAbstractMap<K,V>::_values = new Values(m, r, descending, this);
+			}
+			return EAbstractMap<K,V>::_values;
+		}
+
+		sp<ESet<EMapEntry<K,V>*> > entrySet() {
+			if (!_entrySet) {
+				_entrySet = new EntrySet(m, r, descending, this);
+			}
+			return _entrySet;
+		}
+
+		ENavigableMap<K,V>* descendingMap() {
+			return new SubMap(m, r, !descending);
+		}
+
+		ENavigableMap<K,V>* subMap(K fromKey, boolean fromInclusive,
+				K toKey, boolean toInclusive) {
+			if (descending) {
+				return newSubMap(toKey, toInclusive, fromKey, fromInclusive);
+			}
+			return newSubMap(fromKey, fromInclusive, toKey, toInclusive);
+		}
+
+		ENavigableMap<K,V>* headMap(K toKey, boolean inclusive) {
+			if (descending) {
+				return newTailMap(toKey, inclusive);
+			}
+			return newHeadMap(toKey, inclusive);
+		}
+
+		ENavigableMap<K,V>* tailMap(K fromKey, boolean inclusive) {
+			if (descending) {
+				return newHeadMap(fromKey, inclusive);
+			}
+			return newTailMap(fromKey, inclusive);
+		}
+
+		ESortedMap<K,V>* subMap(K fromKey, K toKey) {
+			return subMap(fromKey, true, toKey, false);
+		}
+
+		ESortedMap<K,V>* headMap(K toKey) {
+			return headMap(toKey, false);
+		}
+
+		ESortedMap<K,V>* tailMap(K fromKey) {
+			return tailMap(fromKey, true);
+		}
+
+	private:
+		class Reverse: public EComparator<K> {
+		public:
+			EComparator<K>* c;
+			Reverse(EComparator<K>* c) : c(c) {
+			}
+			int compare(K o1, K o2) {
+				return KTraits::compare(c, KTraits::index(o2), o1);
+			}
+		};
+
+		Reverse reverse;
+		sp<ESet<EMapEntry<K,V>*> > _entrySet;
+		sp<ENavigableSet<K> > _navigableKeySet;
+
+		Pos first() {
+			return descending ? m->highest(r) : m->lowest(r);
+		}
+
+		Pos last() {
+			return descending ? m->lowest(r) : m->highest(r);
+		}
+
+		// lower and higher in the order of this view
+		Pos lower(idxK k, boolean inclusive) {
+			return descending ? m->ceiling(r, k, inclusive) : m->floor(r, k, inclusive);
+		}
+
+		Pos higher(idxK k, boolean inclusive) {
+			return descending ? m->floor(r, k, inclusive) : m->ceiling(r, k, inclusive);
+		}
+
+		void checkBound(const K& k, boolean inclusive) {
+			idxK i = KTraits::index(k);
+			if (inclusive ? !m->inRange(r, i) : !m->inClosedRange(r, i))
+				throw EIllegalArgumentException(__FILE__, __LINE__, "key out of range");
+		}
+
+		// arguments in ascending key order
+		SubMap* newSubMap(K lo, boolean loInclusive, K hi, boolean hiInclusive) {
+			if (m->table.compare(KTraits::index(lo), hi) > 0)
+				throw EIllegalArgumentException(__FILE__, __LINE__, "fromKey > toKey");
+			checkBound(lo, loInclusive);
+			checkBound(hi, hiInclusive);
+			Range nr;
+			nr.setLow(lo, loInclusive);
+			nr.setHigh(hi, hiInclusive);
+			return new SubMap(m, nr, descending);
+		}
+
+		SubMap* newHeadMap(K hi, boolean inclusive) {
+			checkBound(hi, inclusive);
+			Range nr = r;
+			nr.setHigh(hi, inclusive);
+			return new SubMap(m, nr, descending);
+		}
+
+		SubMap* newTailMap(K lo, boolean inclusive) {
+			checkBound(lo, inclusive);
+			Range nr = r;
+			nr.setLow(lo, inclusive);
+			return new SubMap(m, nr, descending);
+		}
+	};
+
+	/**
+	 * Key set view of the map or of one of its sub maps (nav).
+	 */
+	class KeySet: public EAbstractSet<K>, virtual public ENavigableSet<K> {
+	private:
+		EBTreeMap<K,V>* m;
+		Range r;
+		boolean descending;
+		ENavigableMap<K,V>* nav;
+		boolean ownsNav;
+
+	public:
+		KeySet(EBTreeMap<K,V>* m, const Range& r, boolean descending,
+				ENavigableMap<K,V>* nav, boolean ownsNav) :
+				m(m), r(r), descending(descending), nav(nav), ownsNav(ownsNav) {
+		}
+
+		~KeySet() {
+			if (ownsNav) {
+				delete nav;
+			}
+		}
+
+		sp<EIterator<K> > iterator(int index=0) {
+			return new KeyIterator(m, r, descending);
+		}
+
+		sp<EIterator<K> > descendingIterator() {
+			return new KeyIterator(m, r, !descending);
+		}
+
+		int size() { return nav->size(); }
+		boolean isEmpty() { return nav->isEmpty(); }
+		boolean contains(idxK o) { return nav->containsKey(o); }
+		void clear() { nav->clear(); }
+		K lower(K e) { return nav->lowerKey(e); }
+		K floor(K e) { return nav->floorKey(e); }
+		K ceiling(K e) { return nav->ceilingKey(e); }
+		K higher(K e) { return nav->higherKey(e); }
+		K first() { return nav->firstKey(); }
+		K last() { return nav->lastKey(); }
+		EComparator<K>* comparator() { return nav->comparator(); }
+
+		boolean add(K e) {
+			throw EUnsupportedOperationException(__FILE__, __LINE__);
+		}
+
+		boolean remove(idxK o) {
+			if (!nav->containsKey(o))
+				return false;
+			V v = nav->remove(o);
+			if (m->_autoFree) {
+				VTraits::release(v);
+			}
+			return true;
+		}
+
+		/**
+		 * The polled key is handed over to the caller.
+		 */
+		K pollFirst() {
+			return pollKey(nav->pollFirstEntry());
+		}
+
+		K pollLast() {
+			return pollKey(nav->pollLastEntry());
+		}
+
+		ENavigableSet<K>* descendingSet() {
+			return new KeySet(m, r, !descending, nav->descendingMap(), true);
+		}
+
+		ENavigableSet<K>* subSet(K fromElement, boolean fromInclusive,
+				K toElement, boolean toInclusive) {
+			return keySetOf(nav->subMap(fromElement, fromInclusive, toElement, toInclusive));
+		}
+
+		ENavigableSet<K>* headSet(K toElement, boolean inclusive) {
+			return keySetOf(nav->headMap(toElement, inclusive));
+		}
+
+		ENavigableSet<K>* tailSet(K fromElement, boolean inclusive) {
+			return keySetOf(nav->tailMap(fromElement, inclusive));
+		}
+
+		ESortedSet<K>* subSet(K fromElement, K toElement) {
+			return subSet(fromElement, true, toElement, false);
+		}
+
+		ESortedSet<K>* headSet(K toElement) {
+			return headSet(toElement, false);
+		}
+
+		ESortedSet<K>* tailSet(K fromElement) {
+			return tailSet(fromElement, true);
+		}
+
+	private:
+		K pollKey(EMapEntry<K,V>* e) {
+			if (e == null)
+				return KTraits::nil();
+			if (m->_autoFree) {
+				VTraits::release(m->exported.value);
+			}
+			return e->getKey();
+		}
+
+		static KeySet* keySetOf(ENavigableMap<K,V>* sub) {
+			SubMap* s = dynamic_cast<SubMap*>(sub);
+			return new KeySet(s->m, s->r, s->descending, s, true);
+		}
+	};
+
+	class Values: public EAbstractCollection<V> {
+	private:
+		EBTreeMap<K,V>* m;
+		Range r;
+		boolean descending;
+		ENavigableMap<K,V>* nav;
+
+	public:
+		Values(EBTreeMap<K,V>* m, const Range& r, boolean descending,
+				ENavigableMap<K,V>* nav) :
+				m(m), r(r), descending(descending), nav(nav) {
+		}
+		sp<EIterator<V> > iterator(int index=0) {
+			return new ValueIterator(m, r, descending);
+		}
+		int size() {
+			return nav->size();
+		}
+		boolean contains(idxV o) {
+			return nav->containsValue(o);
+		}
+		void clear() {
+			nav->clear();
+		}
+	};
+
+	class EntrySet: public EAbstractSet<EMapEntry<K,V>*> {
+	private:
+		EBTreeMap<K,V>* m;
+		Range r;
+		boolean descending;
+		ENavigableMap<K,V>* nav;
+
+		Pos find(EMapEntry<K,V>* e) {
+			idxK k = KTraits::index(e->getKey());
+			if (!m->inRange(r, k))
+				return Pos();
+			Pos p = m->table.find(k);
+			if (p.leaf == null || !VTraits::equals(VTraits::index(e->getValue()),
+					VTraits::index(p.value())))
+				return Pos();
+			return p;
+		}
+
+	public:
+		EntrySet(EBTreeMap<K,V>* m, const Range& r, boolean descending,
+				ENavigableMap<K,V>* nav) :
+				m(m), r(r), descending(descending), nav(nav) {
+		}
+		sp<EIterator<EMapEntry<K,V>*> > iterator(int index=0) {
+			return new EntryIterator(m, r, descending);
+		}
+		boolean contains(EMapEntry<K,V>* e) {
+			return find(e).leaf != null;
+		}
+		boolean remove(EMapEntry<K,V>* e) {
+			Pos p = find(e);
+			if (p.leaf == null)
+				return false;
+			K k;
+			V v;
+			m->table.remove(KTraits::index(p.key()), k, v);
+			if (m->_autoFree) {
+				KTraits::release(k);
+				VTraits::release(v);
+			}
+			return true;
+		}
+		int size() {
+			return nav->size();
+		}
+		void clear() {
+			nav->clear();
+		}
+	};
+};
+
+} /* namespace efc */
+#endif /* EBTREEMAP_HH_ */
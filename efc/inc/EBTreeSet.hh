@@ -0,0 +1,230 @@
+/*
+ * EBTreeSet.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EBTREESET_HH_
+#define EBTREESET_HH_
+
+#include "EBTreeMap.hh"
+
+namespace efc {
+
+/**
+ * The placeholder value type of the map behind a set: EAbstractMap pairs
+ * shared pointer keys only with shared pointer values.
+ */
+template<typename E>
+struct EBTreeSetValue {
+	typedef EObject* type;
+};
+
+template<typename T>
+struct EBTreeSetValue<sp<T> > {
+	typedef sp<EObject> type;
+};
+
+/**
+ * A {@link ENavigableSet} implementation based on an {@link EBTreeMap},
+ * as {@link ETreeSet} is based on {@link ETreeMap}: elements are kept in
+ * the contiguous key arrays of B+tree nodes, ordered by their natural
+ * ordering or by a comparator.
+ *
+ * <p>Elements may be primitives, native pointers (owned by the set when
+ * <tt>autoFree</tt> is set) or shared pointers.  For primitive elements
+ * <tt>lower</tt>, <tt>pollFirst</tt> and the like throw
+ * <tt>ENoSuchElementException</tt> where Java returns <tt>null</tt>.  The
+ * sets returned by <tt>subSet</tt>, <tt>headSet</tt>, <tt>tailSet</tt> and
+ * <tt>descendingSet</tt> are backed by this set and deleted by the caller.
+ *
+ * <p><strong>Note that this implementation is not synchronized.</strong>
+ *
+ * @param <E> the type of elements maintained by this set
+ */
+template<typename E>
+class EBTreeSet: public EAbstractSet<E>, virtual public ENavigableSet<E> {
+public:
+	typedef typename ETraits<E>::indexType idxE;
+	typedef typename EBTreeSetValue<E>::type V;
+
+	virtual ~EBTreeSet() {
+		delete map_;
+	}
+
+	/**
+	 * Constructs a new, empty set, sorted according to the natural
+	 * ordering of its elements.
+	 */
+	explicit
+	EBTreeSet(boolean autoFree = true) {
+		map_ = tree_ = new EBTreeMap<E, V>(autoFree);
+	}
+
+	/**
+	 * Constructs a new, empty set, sorted according to the specified
+	 * comparator, which the set does not own.
+	 */
+	explicit
+	EBTreeSet(EComparator<E>* comparator, boolean autoFree = true) {
+		map_ = tree_ = new EBTreeMap<E, V>(comparator, autoFree);
+	}
+
+	/**
+	 * Constructs a new set containing the elements in the specified
+	 * collection, which keeps owning them.
+	 */
+	explicit
+	EBTreeSet(ECollection<E>* c) {
+		map_ = tree_ = new EBTreeMap<E, V>(false);
+		sp<EIterator<E> > it = c->iterator();
+		while (it->hasNext()) {
+			add(it->next());
+		}
+	}
+
+	sp<EIterator<E> > iterator(int index=0) {
+		return map_->navigableKeySet()->iterator();
+	}
+
+	sp<EIterator<E> > descendingIterator() {
+		return map_->navigableKeySet()->descendingIterator();
+	}
+
+	ENavigableSet<E>* descendingSet() {
+		return new EBTreeSet<E>(map_->descendingMap());
+	}
+
+	int size() {
+		return map_->size();
+	}
+
+	boolean isEmpty() {
+		return map_->isEmpty();
+	}
+
+	boolean contains(idxE o) {
+		return map_->containsKey(o);
+	}
+
+	/**
+	 * Adds the specified element to this set if it is not already present.
+	 * If it is, the set is unchanged, the new element is released and
+	 * <tt>false</tt> is returned.
+	 */
+	boolean add(E e) {
+		boolean absent;
+		map_->put(e, null, &absent);
+		return absent;
+	}
+
+	boolean remove(idxE o) {
+		return map_->navigableKeySet()->remove(o);
+	}
+
+	void clear() {
+		map_->clear();
+	}
+
+	/**
+	 * Replaces the contents of this empty set with the given ascending
+	 * elements, in linear time.
+	 *
+	 * @throws IllegalStateException if the set is not empty, or is a view
+	 * @throws IllegalArgumentException if the elements are not strictly
+	 *         ascending
+	 */
+	void bulkLoad(EA<E>* elements) {
+		if (tree_ == null)
+			throw EIllegalStateException(__FILE__, __LINE__, "set is a view");
+		tree_->bulkLoad(elements);
+	}
+
+	ENavigableSet<E>* subSet(E fromElement, boolean fromInclusive,
+			E toElement, boolean toInclusive) {
+		return new EBTreeSet<E>(map_->subMap(fromElement, fromInclusive,
+				toElement, toInclusive));
+	}
+
+	ENavigableSet<E>* headSet(E toElement, boolean inclusive) {
+		return new EBTreeSet<E>(map_->headMap(toElement, inclusive));
+	}
+
+	ENavigableSet<E>* tailSet(E fromElement, boolean inclusive) {
+		return new EBTreeSet<E>(map_->tailMap(fromElement, inclusive));
+	}
+
+	ESortedSet<E>* subSet(E fromElement, E toElement) {
+		return subSet(fromElement, true, toElement, false);
+	}
+
+	ESortedSet<E>* headSet(E toElement) {
+		return headSet(toElement, false);
+	}
+
+	ESortedSet<E>* tailSet(E fromElement) {
+		return tailSet(fromElement, true);
+	}
+
+	EComparator<E>* comparator() {
+		return map_->comparator();
+	}
+
+	E first() {
+		return map_->firstKey();
+	}
+
+	E last() {
+		return map_->lastKey();
+	}
+
+	// NavigableSet API methods
+
+	E lower(E e) {
+		return map_->lowerKey(e);
+	}
+
+	E floor(E e) {
+		return map_->floorKey(e);
+	}
+
+	E ceiling(E e) {
+		return map_->ceilingKey(e);
+	}
+
+	E higher(E e) {
+		return map_->higherKey(e);
+	}
+
+	/**
+	 * The polled element is handed over to the caller.
+	 */
+	E pollFirst() {
+		return map_->navigableKeySet()->pollFirst();
+	}
+
+	E pollLast() {
+		return map_->navigableKeySet()->pollLast();
+	}
+
+private:
+	ENavigableMap<E, V>* map_;
+
+	/**
+	 * The backing tree, or null if this set is a view.
+	 */
+	EBTreeMap<E, V>* tree_;
+
+	// a view backed by a sub map, which it owns.
+	explicit
+	EBTreeSet(ENavigableMap<E, V>* map) : map_(map), tree_(null) {
+	}
+
+	// unsupported.
+	EBTreeSet(const EBTreeSet<E>& that);
+	EBTreeSet<E>& operator= (const EBTreeSet<E>& that);
+};
+
+} /* namespace efc */
+#endif /* EBTREESET_HH_ */
@@ -10,6 +10,7 @@
 
 #include "EObject.hh"
 #include "EString.hh"
+#include "EBitWords.hh"
 #include "EIndexOutOfBoundsException.hh"
 
 namespace efc {
@@ -244,6 +245,25 @@ public:
      */
     int cardinality();
 
+    /**
+     * Returns the number of bits set to <tt>true</tt> in both this
+     * <code>BitSet</code> and the bit set argument, as
+     * <code>cardinality()</code> of their <b>AND</b> would, without
+     * modifying or copying either set.
+     *
+     * @param   set   a bit set.
+     */
+    int andCardinality(EBitSet* set) {
+        int n = ES_MIN(_nbytes, set->_nbytes);
+        int words = n >> 3;
+        llong c = EBitWords::andCardinality((const ullong*)_bits,
+                (const ullong*)set->_bits, words);
+        for (int i = words << 3; i < n; i++) {
+            c += EBitWords::bitCount((ubyte)(_bits[i] & set->_bits[i]));
+        }
+        return (int)c;
+    }
+
     /**
      * Performs a logical <b>AND</b> of this target bit set with the
      * argument bit set. This bit set is modified so that each bit in it
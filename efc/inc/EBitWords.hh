@@ -0,0 +1,514 @@
+/*
+ * EBitWords.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EBITWORDS_HH_
+#define EBITWORDS_HH_
+
+#include "EBase.hh"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || \
+		(defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#include <immintrin.h>
+#define EBIT_WORDS_X86
+#define EBIT_WORDS_AVX2 __attribute__((target("avx2")))
+#define EBIT_WORDS_POPCNT __attribute__((target("popcnt")))
+#define EBIT_WORDS_SSE42 __attribute__((target("sse4.2,popcnt")))
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace efc {
+
+/**
+ * Bulk kernels over arrays of 64-bit words, the storage of bitsets and of
+ * the dense containers of {@link ERoaringBitmap}.
+ *
+ * <p>Every kernel has a portable version, a version using the POPCNT
+ * instruction and an AVX2 version that processes four words per step and
+ * counts bits with the nibble lookup (<tt>vpshufb</tt>) method.  Sorted
+ * arrays of 16-bit values are intersected eight by eight with the SSE4.2
+ * string compare (<tt>pcmpestrm</tt>).  The version is picked once at run
+ * time from the CPU features, so callers need no special compiler flags.
+ * Arrays need no particular alignment.
+ */
+
+class EBitWords {
+public:
+	enum Op {
+		AND, OR, XOR, AND_NOT
+	};
+
+	/**
+	 * Kernel levels, as returned by {@link #level()}.
+	 */
+	enum {
+		LEVEL_PORTABLE = 0,
+		LEVEL_SSE42 = 1,
+		LEVEL_AVX2 = 2
+	};
+
+	/**
+	 * Returns the kernel level used on this CPU.
+	 */
+	static int level() {
+		static int level_ = -1;
+		if (level_ < 0) {
+			level_ = detect();
+		}
+		return level_;
+	}
+
+	/**
+	 * Returns the number of one-bits in the word.
+	 */
+	static int bitCount(ullong w) {
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_popcountll(w);
+#else
+		w = w - ((w >> 1) & 0x5555555555555555ULL);
+		w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+		w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+		return (int)((w * 0x0101010101010101ULL) >> 56);
+#endif
+	}
+
+	/**
+	 * Returns the index of the lowest one-bit of a non-zero word.
+	 */
+	static int numberOfTrailingZeros(ullong w) {
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_ctzll(w);
+#elif defined(_MSC_VER) && defined(_M_X64)
+		unsigned long i;
+		_BitScanForward64(&i, w);
+		return (int)i;
+#else
+		int n = 0;
+		if ((w & 0xffffffffULL) == 0) { n += 32; w >>= 32; }
+		if ((w & 0xffffULL) == 0) { n += 16; w >>= 16; }
+		if ((w & 0xffULL) == 0) { n += 8; w >>= 8; }
+		if ((w & 0xfULL) == 0) { n += 4; w >>= 4; }
+		if ((w & 0x3ULL) == 0) { n += 2; w >>= 2; }
+		return n + (int)((~w) & 1);
+#endif
+	}
+
+	/**
+	 * Returns the index of the highest one-bit of a non-zero word.
+	 */
+	static int highestBit(ullong w) {
+#if defined(__GNUC__) || defined(__clang__)
+		return 63 - __builtin_clzll(w);
+#else
+		int n = 0;
+		if (w >> 32) { n += 32; w >>= 32; }
+		if (w >> 16) { n += 16; w >>= 16; }
+		if (w >> 8) { n += 8; w >>= 8; }
+		if (w >> 4) { n += 4; w >>= 4; }
+		if (w >> 2) { n += 2; w >>= 2; }
+		return n + (int)(w >> 1);
+#endif
+	}
+
+	/**
+	 * Returns the number of one-bits in words[0..n).
+	 */
+	static llong cardinality(const ullong* words, int n) {
+#ifdef EBIT_WORDS_X86
+		switch (level()) {
+		case LEVEL_AVX2: return cardinalityAVX2(words, n);
+		case LEVEL_SSE42: return cardinalityPOPCNT(words, n);
+		}
+#endif
+		return cardinalityPortable(words, n);
+	}
+
+	/**
+	 * Returns the number of one-bits in (a & b), without storing it.
+	 */
+	static llong andCardinality(const ullong* a, const ullong* b, int n) {
+#ifdef EBIT_WORDS_X86
+		switch (level()) {
+		case LEVEL_AVX2: return andCardinalityAVX2(a, b, n);
+		case LEVEL_SSE42: return andCardinalityPOPCNT(a, b, n);
+		}
+#endif
+		return andCardinalityPortable(a, b, n);
+	}
+
+	/**
+	 * Returns true if a and b have a one-bit in common.
+	 */
+	static boolean intersects(const ullong* a, const ullong* b, int n) {
+		int i = 0;
+#ifdef EBIT_WORDS_X86
+		if (level() == LEVEL_AVX2) {
+			i = intersectsAVX2(a, b, n);
+			if (i < 0) return true;
+		}
+#endif
+		for (; i < n; i++) {
+			if ((a[i] & b[i]) != 0) return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Stores (a op b) into dst, which may be a or b, and returns the number
+	 * of one-bits in the result.
+	 */
+	static llong apply(Op op, ullong* dst, const ullong* a, const ullong* b, int n) {
+#ifdef EBIT_WORDS_X86
+		if (level() == LEVEL_AVX2) {
+			switch (op) {
+			case AND: return applyAVX2<AND>(dst, a, b, n);
+			case OR: return applyAVX2<OR>(dst, a, b, n);
+			case XOR: return applyAVX2<XOR>(dst, a, b, n);
+			default: return applyAVX2<AND_NOT>(dst, a, b, n);
+			}
+		}
+		if (level() == LEVEL_SSE42) {
+			switch (op) {
+			case AND: return applyPOPCNT<AND>(dst, a, b, n);
+			case OR: return applyPOPCNT<OR>(dst, a, b, n);
+			case XOR: return applyPOPCNT<XOR>(dst, a, b, n);
+			default: return applyPOPCNT<AND_NOT>(dst, a, b, n);
+			}
+		}
+#endif
+		switch (op) {
+		case AND: return applyPortable<AND>(dst, a, b, n);
+		case OR: return applyPortable<OR>(dst, a, b, n);
+		case XOR: return applyPortable<XOR>(dst, a, b, n);
+		default: return applyPortable<AND_NOT>(dst, a, b, n);
+		}
+	}
+
+	/**
+	 * Intersects the strictly ascending arrays a[0..na) and b[0..nb) into
+	 * out, which may be a, or only counts the common values if out is null.
+	 *
+	 * @return the number of common values
+	 */
+	static int intersect(const ushort* a, int na, const ushort* b, int nb, ushort* out) {
+		int i = 0, j = 0, k = 0;
+#ifdef EBIT_WORDS_X86
+		if (level() >= LEVEL_SSE42) {
+			k = intersectSSE42(a, na, b, nb, out, i, j);
+		}
+#endif
+		while (i < na && j < nb) {
+			ushort x = a[i], y = b[j];
+			if (x == y) {
+				if (out) out[k] = x;
+				k++;
+			}
+			i += x <= y;
+			j += y <= x;
+		}
+		return k;
+	}
+
+	/**
+	 * Returns the index of the first one-bit at or after fromIndex, or -1.
+	 */
+	static int nextSetBit(const ullong* words, int n, int fromIndex) {
+		int u = fromIndex >> 6;
+		if (u >= n) return -1;
+		ullong w = words[u] & (~0ULL << (fromIndex & 63));
+		while (w == 0) {
+			u = skipZeros(words, u + 1, n);
+			if (u == n) return -1;
+			w = words[u];
+		}
+		return (u << 6) + numberOfTrailingZeros(w);
+	}
+
+	/**
+	 * Returns the index of the first zero-bit at or after fromIndex, or
+	 * n * 64 if there is none.
+	 */
+	static int nextClearBit(const ullong* words, int n, int fromIndex) {
+		int u = fromIndex >> 6;
+		if (u >= n) return n << 6;
+		ullong w = ~words[u] & (~0ULL << (fromIndex & 63));
+		while (w == 0) {
+			if (++u == n) return n << 6;
+			w = ~words[u];
+		}
+		return (u << 6) + numberOfTrailingZeros(w);
+	}
+
+	/**
+	 * Returns the index of the first non-zero word in words[from..n), or n.
+	 */
+	static int skipZeros(const ullong* words, int from, int n) {
+#ifdef EBIT_WORDS_X86
+		if (level() == LEVEL_AVX2) {
+			from = skipZerosAVX2(words, from, n);
+		}
+#endif
+		while (from < n && words[from] == 0) {
+			from++;
+		}
+		return from;
+	}
+
+private:
+	static int detect() {
+#ifdef EBIT_WORDS_X86
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2")) return LEVEL_AVX2;
+		if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) return LEVEL_SSE42;
+#endif
+		return LEVEL_PORTABLE;
+	}
+
+	template<int OP>
+	static ullong combine(ullong a, ullong b) {
+		switch (OP) {
+		case AND: return a & b;
+		case OR: return a | b;
+		case XOR: return a ^ b;
+		default: return a & ~b;
+		}
+	}
+
+	static llong cardinalityPortable(const ullong* w, int n) {
+		llong c = 0;
+		for (int i = 0; i < n; i++) {
+			c += bitCount(w[i]);
+		}
+		return c;
+	}
+
+	static llong andCardinalityPortable(const ullong* a, const ullong* b, int n) {
+		llong c = 0;
+		for (int i = 0; i < n; i++) {
+			c += bitCount(a[i] & b[i]);
+		}
+		return c;
+	}
+
+	template<int OP>
+	static llong applyPortable(ullong* dst, const ullong* a, const ullong* b, int n) {
+		llong c = 0;
+		for (int i = 0; i < n; i++) {
+			ullong w = combine<OP>(a[i], b[i]);
+			dst[i] = w;
+			c += bitCount(w);
+		}
+		return c;
+	}
+
+#ifdef EBIT_WORDS_X86
+	// The same loops, compiled to the POPCNT instruction.
+
+	EBIT_WORDS_POPCNT
+	static llong cardinalityPOPCNT(const ullong* w, int n) {
+		llong c0 = 0, c1 = 0;
+		int i = 0;
+		for (; i + 2 <= n; i += 2) {
+			c0 += __builtin_popcountll(w[i]);
+			c1 += __builtin_popcountll(w[i + 1]);
+		}
+		if (i < n) c0 += __builtin_popcountll(w[i]);
+		return c0 + c1;
+	}
+
+	EBIT_WORDS_POPCNT
+	static llong andCardinalityPOPCNT(const ullong* a, const ullong* b, int n) {
+		llong c0 = 0, c1 = 0;
+		int i = 0;
+		for (; i + 2 <= n; i += 2) {
+			c0 += __builtin_popcountll(a[i] & b[i]);
+			c1 += __builtin_popcountll(a[i + 1] & b[i + 1]);
+		}
+		if (i < n) c0 += __builtin_popcountll(a[i] & b[i]);
+		return c0 + c1;
+	}
+
+	template<int OP>
+	EBIT_WORDS_POPCNT
+	static llong applyPOPCNT(ullong* dst, const ullong* a, const ullong* b, int n) {
+		llong c = 0;
+		for (int i = 0; i < n; i++) {
+			ullong w = combine<OP>(a[i], b[i]);
+			dst[i] = w;
+			c += __builtin_popcountll(w);
+		}
+		return c;
+	}
+
+	// AVX2: per-byte counts from a nibble lookup are summed for up to 31
+	// vectors (at most 8 per byte each) before being widened by vpsadbw.
+
+	EBIT_WORDS_AVX2
+	static __m256i byteCounts(__m256i v) {
+		const __m256i lookup = _mm256_setr_epi8(
+				0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+				0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+		const __m256i low = _mm256_set1_epi8(0x0f);
+		__m256i lo = _mm256_and_si256(v, low);
+		__m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+		return _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+				_mm256_shuffle_epi8(lookup, hi));
+	}
+
+	EBIT_WORDS_AVX2
+	static llong sum(__m256i acc) {
+		ullong lanes[4];
+		_mm256_storeu_si256((__m256i*)lanes, acc);
+		return (llong)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+	}
+
+	template<int OP>
+	EBIT_WORDS_AVX2
+	static __m256i combine(__m256i a, __m256i b) {
+		switch (OP) {
+		case AND: return _mm256_and_si256(a, b);
+		case OR: return _mm256_or_si256(a, b);
+		case XOR: return _mm256_xor_si256(a, b);
+		default: return _mm256_andnot_si256(b, a);
+		}
+	}
+
+	EBIT_WORDS_AVX2
+	static llong cardinalityAVX2(const ullong* w, int n) {
+		__m256i total = _mm256_setzero_si256();
+		int i = 0;
+		while (i + 4 <= n) {
+			__m256i bytes = _mm256_setzero_si256();
+			int end = i + 4 * 31 <= n ? i + 4 * 31 : n - ((n - i) & 3);
+			for (; i < end; i += 4) {
+				__m256i v = _mm256_loadu_si256((const __m256i*)(w + i));
+				bytes = _mm256_add_epi8(bytes, byteCounts(v));
+			}
+			total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+		}
+		llong c = sum(total);
+		for (; i < n; i++) {
+			c += __builtin_popcountll(w[i]);
+		}
+		return c;
+	}
+
+	EBIT_WORDS_AVX2
+	static llong andCardinalityAVX2(const ullong* a, const ullong* b, int n) {
+		__m256i total = _mm256_setzero_si256();
+		int i = 0;
+		while (i + 4 <= n) {
+			__m256i bytes = _mm256_setzero_si256();
+			int end = i + 4 * 31 <= n ? i + 4 * 31 : n - ((n - i) & 3);
+			for (; i < end; i += 4) {
+				__m256i v = _mm256_and_si256(
+						_mm256_loadu_si256((const __m256i*)(a + i)),
+						_mm256_loadu_si256((const __m256i*)(b + i)));
+				bytes = _mm256_add_epi8(bytes, byteCounts(v));
+			}
+			total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+		}
+		llong c = sum(total);
+		for (; i < n; i++) {
+			c += __builtin_popcountll(a[i] & b[i]);
+		}
+		return c;
+	}
+
+	template<int OP>
+	EBIT_WORDS_AVX2
+	static llong applyAVX2(ullong* dst, const ullong* a, const ullong* b, int n) {
+		__m256i total = _mm256_setzero_si256();
+		int i = 0;
+		while (i + 4 <= n) {
+			__m256i bytes = _mm256_setzero_si256();
+			int end = i + 4 * 31 <= n ? i + 4 * 31 : n - ((n - i) & 3);
+			for (; i < end; i += 4) {
+				__m256i v = combine<OP>(
+						_mm256_loadu_si256((const __m256i*)(a + i)),
+						_mm256_loadu_si256((const __m256i*)(b + i)));
+				_mm256_storeu_si256((__m256i*)(dst + i), v);
+				bytes = _mm256_add_epi8(bytes, byteCounts(v));
+			}
+			total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+		}
+		llong c = sum(total);
+		for (; i < n; i++) {
+			ullong w = combine<OP>(a[i], b[i]);
+			dst[i] = w;
+			c += __builtin_popcountll(w);
+		}
+		return c;
+	}
+
+	// compares blocks of eight values of a and b for equality all against
+	// all, and advances the block(s) with the lower maximum; i and j are
+	// left where the scalar merge has to go on.
+	EBIT_WORDS_SSE42
+	static int intersectSSE42(const ushort* a, int na, const ushort* b, int nb,
+			ushort* out, int& i, int& j) {
+		const int ea = na & ~7, eb = nb & ~7;
+		int k = 0;
+		if (ea == 0 || eb == 0)
+			return 0;
+		__m128i va = _mm_loadu_si128((const __m128i*)a);
+		__m128i vb = _mm_loadu_si128((const __m128i*)b);
+		for (;;) {
+			__m128i m = _mm_cmpestrm(vb, 8, va, 8,
+					_SIDD_UWORD_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK);
+			int r = _mm_cvtsi128_si32(m);
+			if (r != 0) {
+				if (out) {
+					for (int bits = r; bits != 0; bits &= bits - 1) {
+						out[k++] = a[i + __builtin_ctz(bits)];
+					}
+				} else {
+					k += __builtin_popcount(r);
+				}
+			}
+			ushort amax = a[i + 7], bmax = b[j + 7];
+			if (amax <= bmax) {
+				i += 8;
+				if (i == ea) break;
+				va = _mm_loadu_si128((const __m128i*)(a + i));
+			}
+			if (bmax <= amax) {
+				j += 8;
+				if (j == eb) break;
+				vb = _mm_loadu_si128((const __m128i*)(b + j));
+			}
+		}
+		return k;
+	}
+
+	// returns -1 as soon as a common bit is seen, else the index reached.
+	EBIT_WORDS_AVX2
+	static int intersectsAVX2(const ullong* a, const ullong* b, int n) {
+		int i = 0;
+		for (; i + 4 <= n; i += 4) {
+			__m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+			__m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+			if (!_mm256_testz_si256(x, y)) return -1;
+		}
+		return i;
+	}
+
+	EBIT_WORDS_AVX2
+	static int skipZerosAVX2(const ullong* words, int from, int n) {
+		for (; from + 4 <= n; from += 4) {
+			__m256i v = _mm256_loadu_si256((const __m256i*)(words + from));
+			if (!_mm256_testz_si256(v, v)) break;
+		}
+		return from;
+	}
+#endif //!EBIT_WORDS_X86
+};
+
+} /* namespace efc */
+#endif /* EBITWORDS_HH_ */
@@ -0,0 +1,829 @@
+/*
+ * EFlatHashMap.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EFLATHASHMAP_HH_
+#define EFLATHASHMAP_HH_
+
+#include "EAbstractMap.hh"
+#include "ELLong.hh"
+#include "EIllegalStateException.hh"
+#include "ENoSuchElementException.hh"
+#include "EUnsupportedOperationException.hh"
+#include "EConcurrentModificationException.hh"
+
+#include <new>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define EFLAT_HASH_SSE2
+#endif
+
+namespace efc {
+
+/**
+ * Key hashing and equality for the flat hash containers.
+ *
+ * <p>Primitive keys hash by value and compare with <tt>==</tt>; native and
+ * shared pointer keys use <tt>hashCode()</tt> and <tt>equals()</tt> as
+ * {@link EHashMap} does, and are looked up by raw pointer.
+ */
+template<typename T>
+struct EFlatHashTraits {
+	typedef T indexType;
+	static llong hash(T k) {
+		return (llong)k;
+	}
+	static boolean equals(T a, T b) {
+		return a == b;
+	}
+	static T index(const T& t) {
+		return t;
+	}
+	static void release(T& t) {
+	}
+};
+
+template<typename T>
+struct EFlatHashTraits<T*> {
+	typedef T* indexType;
+	static llong hash(T* k) {
+		return (k == null) ? 0 : k->hashCode();
+	}
+	static boolean equals(T* a, T* b) {
+		return a == b || (a != null && a->equals(b));
+	}
+	static T* index(T* t) {
+		return t;
+	}
+	static void release(T*& t) {
+		delete t;
+		t = null;
+	}
+};
+
+template<typename T>
+struct EFlatHashTraits<sp<T> > {
+	typedef T* indexType;
+	static llong hash(T* k) {
+		return (k == null) ? 0 : k->hashCode();
+	}
+	static boolean equals(T* a, T* b) {
+		return a == b || (a != null && a->equals(b));
+	}
+	static T* index(const sp<T>& t) {
+		return t.get();
+	}
+	static void release(sp<T>& t) {
+	}
+};
+
+/**
+ * A group of control bytes probed together: 16 with one SSE2 compare,
+ * otherwise 8 packed in a 64-bit word and matched with bit tricks.
+ * Match results are bit masks whose set bits map to slots through
+ * {@link #lowest}.
+ */
+struct EFlatHashGroup {
+	static const byte EMPTY = -128;
+	static const byte DELETED = -2;
+
+#ifdef EFLAT_HASH_SSE2
+	static const int WIDTH = 16;
+
+	__m128i ctrl;
+
+	explicit EFlatHashGroup(const byte* p) {
+		ctrl = _mm_loadu_si128((const __m128i*)p);
+	}
+	ullong match(byte h2) const {
+		return (ullong)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl));
+	}
+	ullong matchEmpty() const {
+		return match(EMPTY);
+	}
+	// empty and deleted are the only negative control bytes.
+	ullong matchEmptyOrDeleted() const {
+		return (ullong)_mm_movemask_epi8(ctrl);
+	}
+	static int lowest(ullong mask) {
+		return ctz(mask);
+	}
+	static int highest(ullong mask) {
+		return 63 - clz(mask);
+	}
+#else
+	static const int WIDTH = 8;
+
+	ullong ctrl;
+
+	explicit EFlatHashGroup(const byte* p) {
+		const ubyte* b = (const ubyte*)p;
+		ctrl = 0;
+		for (int i = WIDTH - 1; i >= 0; i--) {
+			ctrl = (ctrl << 8) | b[i];
+		}
+	}
+	// may report a false positive next to a real match; callers
+	// compare keys anyway.
+	ullong match(byte h2) const {
+		ullong x = ctrl ^ (LSBS * (ubyte)h2);
+		return (x - LSBS) & ~x & MSBS;
+	}
+	ullong matchEmpty() const {
+		return ctrl & (~ctrl << 6) & MSBS;
+	}
+	ullong matchEmptyOrDeleted() const {
+		return ctrl & (~ctrl << 7) & MSBS;
+	}
+	static int lowest(ullong mask) {
+		return ctz(mask) >> 3;
+	}
+	static int highest(ullong mask) {
+		return (63 - clz(mask)) >> 3;
+	}
+
+	static const ullong LSBS = 0x0101010101010101ULL;
+	static const ullong MSBS = 0x8080808080808080ULL;
+#endif
+
+	static int ctz(ullong x) {
+#if defined(__GNUC__)
+		return __builtin_ctzll(x);
+#else
+		return ELLong::numberOfTrailingZeros((llong)x);
+#endif
+	}
+	static int clz(ullong x) {
+#if defined(__GNUC__)
+		return __builtin_clzll(x);
+#else
+		return ELLong::numberOfLeadingZeros((llong)x);
+#endif
+	}
+};
+
+/**
+ * The open addressing table behind {@link EFlatHashMap} and
+ * {@link EFlatHashSet}.
+ *
+ * <p>Each slot has one control byte: EMPTY, DELETED, or the low 7 bits of
+ * the key's hash when full.  A lookup hashes once, then probes groups of
+ * control bytes (quadratically, group by group) for the 7-bit tag and
+ * only compares keys on a tag hit, stopping at the first group with an
+ * empty byte.  Keys and values live in the slot array itself, so an
+ * entry costs its own size plus one byte.  The first WIDTH control bytes
+ * are mirrored past the end so that a group load never wraps.
+ *
+ * <p>The table is kept at most 7/8 full; removal leaves a tombstone
+ * unless no probe can have passed over the slot, and tombstones are
+ * dropped by rehashing in place when they, not live entries, fill it.
+ */
+template<typename K, typename Slot>
+class EFlatHashTable {
+public:
+	typedef EFlatHashTraits<K> Traits;
+	typedef typename Traits::indexType idxK;
+	typedef EFlatHashGroup Group;
+
+	/**
+	 * The maximum capacity, MUST be a power of two <= 1<<30.
+	 */
+	static const int MAXIMUM_CAPACITY = (1 << 30);
+
+	/**
+	 * The minimum capacity, MUST be a power of two >= Group::WIDTH.
+	 */
+	static const int MINIMUM_CAPACITY = 16;
+
+	byte* ctrl;
+	Slot* slots;
+	uint capacity;
+	int size;
+	int growthLeft;
+	int modCount;
+
+	explicit EFlatHashTable(int expectedSize) : size(0), modCount(0) {
+		allocate(capacityFor(expectedSize));
+	}
+
+	~EFlatHashTable() {
+		destroyAll();
+		deallocate(ctrl, slots);
+	}
+
+	/**
+	 * Spreads the key hash over 64 bits: the low 7 bits become the control
+	 * byte tag and the rest picks the first group.
+	 */
+	static ullong hash(idxK key) {
+		ullong h = (ullong)Traits::hash(key);
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		return h;
+	}
+
+	static byte h2(ullong h) {
+		return (byte)(h & 0x7F);
+	}
+
+	static uint capacityFor(int expectedSize) {
+		uint cap = MINIMUM_CAPACITY;
+		while (cap < (uint)MAXIMUM_CAPACITY && maxLoad(cap) < (uint)expectedSize)
+			cap <<= 1;
+		return cap;
+	}
+
+	static uint maxLoad(uint cap) {
+		return cap - cap / 8;
+	}
+
+	/**
+	 * Returns the slot holding key, or -1.
+	 */
+	int find(idxK key, ullong h) {
+		uint mask = capacity - 1;
+		uint offset = (uint)(h >> 7) & mask;
+		byte tag = h2(h);
+		for (uint step = Group::WIDTH;; step += Group::WIDTH) {
+			Group g(ctrl + offset);
+			for (ullong m = g.match(tag); m != 0; m &= m - 1) {
+				uint i = (offset + Group::lowest(m)) & mask;
+				if (Traits::equals(key, Traits::index(slots[i].key)))
+					return i;
+			}
+			if (g.matchEmpty() != 0)
+				return -1;
+			offset = (offset + step) & mask;
+		}
+		//always not reach here.
+		return -1;
+	}
+
+	int find(idxK key) {
+		return find(key, hash(key));
+	}
+
+	/**
+	 * Claims a free slot for a key of hash h that is known to be absent,
+	 * growing the table first if needed; the caller constructs the slot.
+	 */
+	int prepareInsert(ullong h) {
+		int i = findFirstNonFull(h);
+		if (growthLeft == 0 && ctrl[i] != Group::DELETED) {
+			if ((uint)size <= maxLoad(capacity) / 2) {
+				rehash(capacity); // mostly tombstones
+			} else {
+				if (capacity >= (uint)MAXIMUM_CAPACITY)
+					throw EIllegalStateException(__FILE__, __LINE__, "Capacity exhausted.");
+				rehash(capacity << 1);
+			}
+			i = findFirstNonFull(h);
+		}
+		if (ctrl[i] == Group::EMPTY)
+			growthLeft--;
+		setCtrl(i, h2(h));
+		size++;
+		modCount++;
+		return i;
+	}
+
+	/**
+	 * Destroys the slot at i and frees it.
+	 */
+	void erase(int i) {
+		slots[i].~Slot();
+		uint mask = capacity - 1;
+		ullong emptyAfter = Group(ctrl + i).matchEmpty();
+		ullong emptyBefore = Group(ctrl + ((i - Group::WIDTH) & mask)).matchEmpty();
+		// if the full run around i is shorter than a group, no probe ever
+		// saw a full group here and the slot can become empty again.
+		boolean wasNeverFull = emptyAfter != 0 && emptyBefore != 0
+				&& Group::lowest(emptyAfter)
+						+ (Group::WIDTH - 1 - Group::highest(emptyBefore))
+						< Group::WIDTH;
+		if (wasNeverFull) {
+			setCtrl(i, Group::EMPTY);
+			growthLeft++;
+		} else {
+			setCtrl(i, Group::DELETED);
+		}
+		size--;
+		modCount++;
+	}
+
+	boolean isFull(int i) {
+		return ctrl[i] >= 0;
+	}
+
+	/**
+	 * Returns the first full slot at or after i, or capacity.
+	 */
+	int nextFull(int i) {
+		while (i < (int)capacity && ctrl[i] < 0)
+			i++;
+		return i;
+	}
+
+	void clear() {
+		destroyAll();
+		memset(ctrl, Group::EMPTY, capacity + Group::WIDTH);
+		size = 0;
+		growthLeft = maxLoad(capacity);
+		modCount++;
+	}
+
+	/**
+	 * Makes room for expectedSize entries without further rehashing.
+	 */
+	void reserve(int expectedSize) {
+		uint cap = capacityFor(expectedSize);
+		if (cap > capacity)
+			rehash(cap);
+	}
+
+private:
+	void allocate(uint cap) {
+		capacity = cap;
+		ctrl = new byte[cap + Group::WIDTH];
+		memset(ctrl, Group::EMPTY, cap + Group::WIDTH);
+		slots = (Slot*)::operator new(sizeof(Slot) * cap);
+		growthLeft = maxLoad(cap) - size;
+	}
+
+	static void deallocate(byte* c, Slot* s) {
+		delete[] c;
+		::operator delete(s);
+	}
+
+	void destroyAll() {
+		for (uint i = 0; i < capacity; i++) {
+			if (ctrl[i] >= 0)
+				slots[i].~Slot();
+		}
+	}
+
+	void setCtrl(uint i, byte c) {
+		ctrl[i] = c;
+		if (i < (uint)Group::WIDTH)
+			ctrl[capacity + i] = c;
+	}
+
+	int findFirstNonFull(ullong h) {
+		uint mask = capacity - 1;
+		uint offset = (uint)(h >> 7) & mask;
+		for (uint step = Group::WIDTH;; step += Group::WIDTH) {
+			ullong m = Group(ctrl + offset).matchEmptyOrDeleted();
+			if (m != 0)
+				return (offset + Group::lowest(m)) & mask;
+			offset = (offset + step) & mask;
+		}
+		//always not reach here.
+		return -1;
+	}
+
+	void rehash(uint newCapacity) {
+		byte* oldCtrl = ctrl;
+		Slot* oldSlots = slots;
+		uint oldCapacity = capacity;
+
+		allocate(newCapacity);
+		for (uint i = 0; i < oldCapacity; i++) {
+			if (oldCtrl[i] >= 0) {
+				ullong h = hash(Traits::index(oldSlots[i].key));
+				int j = findFirstNonFull(h);
+				setCtrl(j, h2(h));
+				new (slots + j) Slot(oldSlots[i]);
+				oldSlots[i].~Slot();
+			}
+		}
+		deallocate(oldCtrl, oldSlots);
+		modCount++;
+	}
+};
+
+/**
+ * Hash table based implementation of the <tt>Map</tt> interface using open
+ * addressing, for maps with many small entries.
+ *
+ * <p>Unlike {@link EHashMap}, which allocates one chained entry per key,
+ * this map keeps keys and values inline in a single slot array indexed by
+ * a parallel array of one-byte control tags (the "Swiss table" layout).
+ * A lookup is one hash, one or two vector compares of 16 control bytes
+ * (SSE2; 8 bytes in a 64-bit word elsewhere) and normally a single key
+ * comparison, and <tt>put</tt> of a new key allocates nothing unless the
+ * table grows.  The load factor is fixed at 7/8.
+ *
+ * <p>Keys may be primitives, native pointers or shared pointers, and
+ * values native or shared pointers, as for {@link EHashMap}; native
+ * pointers are owned by the map when <tt>autoFree</tt> is set.
+ * <tt>null</tt> keys and values are permitted.
+ *
+ * <p>The entries returned by the entry set iterator are views owned by
+ * that iterator and only valid until its next call to <tt>next</tt>.
+ * Iterators are fail-fast.  Removing an entry never moves the others, so
+ * removal through an iterator keeps the iteration valid.
+ *
+ * <p><strong>Note that this implementation is not synchronized.</strong>
+ *
+ * @param <K> the type of keys maintained by this map
+ * @param <V> the type of mapped values
+ */
+template<typename K, typename V>
+class EFlatHashMap: public EAbstractMap<K, V>, virtual public EMap<K, V> {
+public:
+	typedef typename EMap<K, V>::idxK idxK;
+	typedef typename EMap<K, V>::idxV idxV;
+
+	virtual ~EFlatHashMap() {
+		releaseAll();
+	}
+
+	/**
+	 * Constructs an empty map with room for expectedSize mappings before
+	 * it has to grow.
+	 *
+	 * @param expectedSize the expected number of mappings
+	 * @param autoFree whether native pointer keys and values are deleted
+	 *        by the map
+	 */
+	explicit
+	EFlatHashMap(int expectedSize = 16, boolean autoFree = true) :
+			table(expectedSize), _autoFree(autoFree) {
+	}
+
+	int size() {
+		return table.size;
+	}
+
+	boolean isEmpty() {
+		return table.size == 0;
+	}
+
+	/**
+	 * Returns the value to which the specified key is mapped, or
+	 * {@code null} if this map contains no mapping for the key.
+	 */
+	V get(idxK key) {
+		int i = table.find(key);
+		return (i < 0) ? V() : table.slots[i].value;
+	}
+
+	boolean containsKey(idxK key) {
+		return table.find(key) >= 0;
+	}
+
+	/**
+	 * Returns <tt>true</tt> if this map maps one or more keys to the
+	 * specified value; this scans every slot.
+	 */
+	boolean containsValue(idxV value) {
+		for (int i = table.nextFull(0); i < (int)table.capacity; i = table.nextFull(i + 1)) {
+			if (VTraits::equals(value, VTraits::index(table.slots[i].value)))
+				return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Associates the specified value with the specified key in this map.
+	 * If the map previously contained a mapping for the key, the old
+	 * value is replaced and returned, and the new key is released.
+	 */
+	V put(K key, V value, boolean *absent=null) {
+		idxK k = KTraits::index(key);
+		ullong h = Table::hash(k);
+		int i = table.find(k, h);
+		if (i >= 0) {
+			if (absent) *absent = false;
+			Slot& s = table.slots[i];
+			V oldValue = s.value;
+			s.value = value;
+			if (_autoFree && KTraits::index(s.key) != k) {
+				KTraits::release(key);
+			}
+			return oldValue;
+		}
+		if (absent) *absent = true;
+		i = table.prepareInsert(h);
+		new (table.slots + i) Slot(key, value);
+		return V();
+	}
+
+	/**
+	 * Removes the mapping for the specified key from this map if present,
+	 * and returns its value, which the caller then owns.
+	 */
+	V remove(idxK key) {
+		int i = table.find(key);
+		if (i < 0) {
+			return V();
+		}
+		return removeAt(i, false);
+	}
+
+	void clear() {
+		releaseAll();
+		table.clear();
+	}
+
+	/**
+	 * Makes room for expectedSize mappings without further rehashing.
+	 */
+	void reserve(int expectedSize) {
+		table.reserve(expectedSize);
+	}
+
+	/**
+	 * Returns the number of slots in the table.
+	 */
+	int capacity() {
+		return table.capacity;
+	}
+
+	sp<ESet<K> > keySet() {
+		if (!EAbstractMap<K,V>::_keySet) {
+			EAbstractMap<K,V>::_keySet = new KeySet(this);
+		}
+		return EAbstractMap<K,V>::_keySet;
+	}
+
+	sp<ECollection<V> > values() {
+		if (!EAbstractMap<K,V>::_values) {
+			EAbstractMap<K,V>::_values = new Values(this);
+		}
+		return EAbstractMap<K,V>::_values;
+	}
+
+	sp<ESet<EMapEntry<K, V>*> > entrySet() {
+		if (!_entrySet) {
+			_entrySet = new EntrySet(this);
+		}
+		return _entrySet;
+	}
+
+	void setAutoFree(boolean autoFree = true) {
+		_autoFree = autoFree;
+	}
+
+	boolean getAutoFree() {
+		return _autoFree;
+	}
+
+private:
+	typedef EFlatHashTraits<K> KTraits;
+	typedef EFlatHashTraits<V> VTraits;
+
+	struct Slot {
+		K key;
+		V value;
+		Slot(const K& k, const V& v) : key(k), value(v) {
+		}
+	};
+
+	typedef EFlatHashTable<K, Slot> Table;
+
+	Table table;
+
+	/**
+	 * Auto free object flag
+	 */
+	boolean _autoFree;
+
+	/**
+	 * The entry set view, created on first use.
+	 */
+	sp<ESet<EMapEntry<K, V>*> > _entrySet;
+
+	// unsupported.
+	EFlatHashMap(const EFlatHashMap<K, V>& that);
+	EFlatHashMap<K, V>& operator= (const EFlatHashMap<K, V>& that);
+
+	V removeAt(int i, boolean freeValue) {
+		Slot& s = table.slots[i];
+		V v = s.value;
+		if (_autoFree) {
+			KTraits::release(s.key);
+			if (freeValue) {
+				VTraits::release(v);
+			}
+		}
+		table.erase(i);
+		return v;
+	}
+
+	void releaseAll() {
+		if (!_autoFree)
+			return;
+		for (int i = table.nextFull(0); i < (int)table.capacity; i = table.nextFull(i + 1)) {
+			KTraits::release(table.slots[i].key);
+			VTraits::release(table.slots[i].value);
+		}
+	}
+
+	template<typename T>
+	class FlatIterator: public EIterator<T> {
+	protected:
+		EFlatHashMap<K,V>* m;
+		int index;
+		int lastReturned;
+		int expectedModCount;
+
+		int nextIndex() {
+			if (m->table.modCount != expectedModCount)
+				throw EConcurrentModificationException(__FILE__, __LINE__);
+			index = m->table.nextFull(index);
+			if (index >= (int)m->table.capacity)
+				throw ENoSuchElementException(__FILE__, __LINE__);
+			lastReturned = index++;
+			return lastReturned;
+		}
+
+		Slot& current() {
+			if (lastReturned < 0)
+				throw EIllegalStateException(__FILE__, __LINE__, "Entry was removed");
+			return m->table.slots[lastReturned];
+		}
+
+		void checkRemove() {
+			if (lastReturned < 0)
+				throw EIllegalStateException(__FILE__, __LINE__);
+			if (m->table.modCount != expectedModCount)
+				throw EConcurrentModificationException(__FILE__, __LINE__);
+		}
+
+		void removed() {
+			lastReturned = -1;
+			expectedModCount = m->table.modCount;
+		}
+
+	public:
+		FlatIterator(EFlatHashMap<K,V>* m) : m(m), index(0), lastReturned(-1) {
+			expectedModCount = m->table.modCount;
+		}
+
+		boolean hasNext() {
+			index = m->table.nextFull(index);
+			return index < (int)m->table.capacity;
+		}
+
+		void remove() {
+			checkRemove();
+			m->removeAt(lastReturned, true);
+			removed();
+		}
+	};
+
+	class KeyIterator: public FlatIterator<K> {
+	public:
+		KeyIterator(EFlatHashMap<K,V>* m) : FlatIterator<K>(m) {
+		}
+		K next() {
+			return this->m->table.slots[this->nextIndex()].key;
+		}
+		K moveOut() {
+			this->checkRemove();
+			Slot& s = this->m->table.slots[this->lastReturned];
+			K k = s.key;
+			if (this->m->_autoFree) {
+				VTraits::release(s.value);
+			}
+			this->m->table.erase(this->lastReturned);
+			this->removed();
+			return k;
+		}
+	};
+
+	class ValueIterator: public FlatIterator<V> {
+	public:
+		ValueIterator(EFlatHashMap<K,V>* m) : FlatIterator<V>(m) {
+		}
+		V next() {
+			return this->m->table.slots[this->nextIndex()].value;
+		}
+		V moveOut() {
+			this->checkRemove();
+			V v = this->m->removeAt(this->lastReturned, false);
+			this->removed();
+			return v;
+		}
+	};
+
+	class EntryIterator: public FlatIterator<EMapEntry<K,V>*>, public EMapEntry<K,V> {
+	public:
+		EntryIterator(EFlatHashMap<K,V>* m) : FlatIterator<EMapEntry<K,V>*>(m) {
+		}
+		EMapEntry<K,V>* next() {
+			this->nextIndex();
+			return this;
+		}
+		EMapEntry<K,V>* moveOut() {
+			throw EUnsupportedOperationException(__FILE__, __LINE__);
+		}
+		K getKey() {
+			return this->current().key;
+		}
+		V getValue() {
+			return this->current().value;
+		}
+		V setValue(V value) {
+			Slot& s = this->current();
+			V oldValue = s.value;
+			s.value = value;
+			return oldValue;
+		}
+		boolean equals(EMapEntry<K,V>* e) {
+			return KTraits::equals(KTraits::index(getKey()), KTraits::index(e->getKey()))
+					&& VTraits::equals(VTraits::index(getValue()), VTraits::index(e->getValue()));
+		}
+		virtual int hashCode() {
+			return (int)KTraits::hash(KTraits::index(getKey()))
+					^ (int)VTraits::hash(VTraits::index(getValue()));
+		}
+	};
+
+	class KeySet: public EAbstractSet<K> {
+	private:
+		EFlatHashMap<K,V>* _map;
+	public:
+		KeySet(EFlatHashMap<K,V>* map) : _map(map) {
+		}
+		sp<EIterator<K> > iterator(int index = 0) {
+			return new KeyIterator(_map);
+		}
+		int size() {
+			return _map->size();
+		}
+		boolean contains(idxK o) {
+			return _map->containsKey(o);
+		}
+		boolean remove(idxK o) {
+			int i = _map->table.find(o);
+			if (i < 0)
+				return false;
+			_map->removeAt(i, true);
+			return true;
+		}
+		void clear() {
+			_map->clear();
+		}
+	};
+
+	class Values: public EAbstractCollection<V> {
+	private:
+		EFlatHashMap<K,V>* _map;
+	public:
+		Values(EFlatHashMap<K,V>* map) : _map(map) {
+		}
+		sp<EIterator<V> > iterator(int index = 0) {
+			return new ValueIterator(_map);
+		}
+		int size() {
+			return _map->size();
+		}
+		boolean contains(idxV o) {
+			return _map->containsValue(o);
+		}
+		void clear() {
+			_map->clear();
+		}
+	};
+
+	class EntrySet: public EAbstractSet<EMapEntry<K,V>*> {
+	private:
+		EFlatHashMap<K,V>* _map;
+	public:
+		EntrySet(EFlatHashMap<K,V>* map) : _map(map) {
+		}
+		sp<EIterator<EMapEntry<K,V>*> > iterator(int index = 0) {
+			return new EntryIterator(_map);
+		}
+		boolean contains(EMapEntry<K,V>* e) {
+			int i = _map->table.find(KTraits::index(e->getKey()));
+			return i >= 0 && VTraits::equals(VTraits::index(e->getValue()),
+					VTraits::index(_map->table.slots[i].value));
+		}
+		boolean remove(EMapEntry<K,V>* e) {
+			int i = _map->table.find(KTraits::index(e->getKey()));
+			if (i < 0 || !VTraits::equals(VTraits::index(e->getValue()),
+					VTraits::index(_map->table.slots[i].value)))
+				return false;
+			_map->removeAt(i, true);
+			return true;
+		}
+		int size() {
+			return _map->size();
+		}
+		void clear() {
+			_map->clear();
+		}
+	};
+};
+
+} /* namespace efc */
+#endif /* EFLATHASHMAP_HH_ */
@@ -0,0 +1,223 @@
+/*
+ * EFlatHashSet.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EFLATHASHSET_HH_
+#define EFLATHASHSET_HH_
+
+#include "EFlatHashMap.hh"
+
+namespace efc {
+
+/**
+ * This class implements the <tt>Set</tt> interface with the open
+ * addressing table of {@link EFlatHashMap}: elements are stored inline in
+ * the slot array, with no value and no per-element allocation, so a set
+ * of <tt>int</tt> costs about five bytes per element at full load.
+ *
+ * <p>Elements may be primitives, native pointers (owned by the set when
+ * <tt>autoFree</tt> is set) or shared pointers.  Iterators are fail-fast,
+ * and removal through an iterator keeps the iteration valid.
+ *
+ * <p><strong>Note that this implementation is not synchronized.</strong>
+ *
+ * @param <E> the type of elements maintained by this set
+ */
+template<typename E>
+class EFlatHashSet: public EAbstractSet<E> {
+public:
+	typedef typename ETraits<E>::indexType idxE;
+
+	virtual ~EFlatHashSet() {
+		releaseAll();
+	}
+
+	/**
+	 * Constructs an empty set with room for expectedSize elements before
+	 * it has to grow.
+	 *
+	 * @param expectedSize the expected number of elements
+	 * @param autoFree whether native pointer elements are deleted by the set
+	 */
+	explicit
+	EFlatHashSet(int expectedSize = 16, boolean autoFree = true) :
+			table(expectedSize), _autoFree(autoFree) {
+	}
+
+	/**
+	 * Constructs a new set containing the elements in the specified
+	 * collection.
+	 */
+	explicit
+	EFlatHashSet(ECollection<E>* c) : table(c->size()), _autoFree(false) {
+		sp<EIterator<E> > it = c->iterator();
+		while (it->hasNext()) {
+			add(it->next());
+		}
+	}
+
+	sp<EIterator<E> > iterator(int index=0) {
+		return new Itr(this);
+	}
+
+	int size() {
+		return table.size;
+	}
+
+	boolean isEmpty() {
+		return table.size == 0;
+	}
+
+	boolean contains(idxE o) {
+		return table.find(o) >= 0;
+	}
+
+	/**
+	 * Adds the specified element to this set if it is not already present.
+	 * If it is, the set is unchanged, the new element is released and
+	 * <tt>false</tt> is returned.
+	 */
+	boolean add(E e) {
+		idxE k = Traits::index(e);
+		ullong h = Table::hash(k);
+		int i = table.find(k, h);
+		if (i >= 0) {
+			if (_autoFree && Traits::index(table.slots[i].key) != k) {
+				Traits::release(e);
+			}
+			return false;
+		}
+		i = table.prepareInsert(h);
+		new (table.slots + i) Slot(e);
+		return true;
+	}
+
+	boolean remove(idxE o) {
+		int i = table.find(o);
+		if (i < 0)
+			return false;
+		removeAt(i);
+		return true;
+	}
+
+	void clear() {
+		releaseAll();
+		table.clear();
+	}
+
+	/**
+	 * Makes room for expectedSize elements without further rehashing.
+	 */
+	void reserve(int expectedSize) {
+		table.reserve(expectedSize);
+	}
+
+	/**
+	 * Returns the number of slots in the table.
+	 */
+	int capacity() {
+		return table.capacity;
+	}
+
+	void setAutoFree(boolean autoFree = true) {
+		_autoFree = autoFree;
+	}
+
+	boolean getAutoFree() {
+		return _autoFree;
+	}
+
+private:
+	typedef EFlatHashTraits<E> Traits;
+
+	struct Slot {
+		E key;
+		explicit Slot(const E& k) : key(k) {
+		}
+	};
+
+	typedef EFlatHashTable<E, Slot> Table;
+
+	Table table;
+
+	/**
+	 * Auto free object flag
+	 */
+	boolean _autoFree;
+
+	// unsupported.
+	EFlatHashSet(const EFlatHashSet<E>& that);
+	EFlatHashSet<E>& operator= (const EFlatHashSet<E>& that);
+
+	void removeAt(int i) {
+		if (_autoFree) {
+			Traits::release(table.slots[i].key);
+		}
+		table.erase(i);
+	}
+
+	void releaseAll() {
+		if (!_autoFree)
+			return;
+		for (int i = table.nextFull(0); i < (int)table.capacity; i = table.nextFull(i + 1)) {
+			Traits::release(table.slots[i].key);
+		}
+	}
+
+	class Itr: public EIterator<E> {
+	private:
+		EFlatHashSet<E>* s;
+		int index;
+		int lastReturned;
+		int expectedModCount;
+
+		void checkRemove() {
+			if (lastReturned < 0)
+				throw EIllegalStateException(__FILE__, __LINE__);
+			if (s->table.modCount != expectedModCount)
+				throw EConcurrentModificationException(__FILE__, __LINE__);
+		}
+
+	public:
+		Itr(EFlatHashSet<E>* s) : s(s), index(0), lastReturned(-1) {
+			expectedModCount = s->table.modCount;
+		}
+
+		boolean hasNext() {
+			index = s->table.nextFull(index);
+			return index < (int)s->table.capacity;
+		}
+
+		E next() {
+			if (s->table.modCount != expectedModCount)
+				throw EConcurrentModificationException(__FILE__, __LINE__);
+			index = s->table.nextFull(index);
+			if (index >= (int)s->table.capacity)
+				throw ENoSuchElementException(__FILE__, __LINE__);
+			lastReturned = index++;
+			return s->table.slots[lastReturned].key;
+		}
+
+		void remove() {
+			checkRemove();
+			s->removeAt(lastReturned);
+			lastReturned = -1;
+			expectedModCount = s->table.modCount;
+		}
+
+		E moveOut() {
+			checkRemove();
+			E e = s->table.slots[lastReturned].key;
+			s->table.erase(lastReturned);
+			lastReturned = -1;
+			expectedModCount = s->table.modCount;
+			return e;
+		}
+	};
+};
+
+} /* namespace efc */
+#endif /* EFLATHASHSET_HH_ */
@@ -23,7 +23,7 @@ namespace efc {
 #define SCOPED_SLOCK0(p) SSYNCBLOCKFOR(0, p) //0 for sp!!!
 #define SCOPED_SLOCK1(p) SSYNCBLOCKFOR(1, p) //1 for nio!!!
 
-#define SCOPED_SLOCK2(p) SSYNCBLOCKFOR(2, p) //2 for ?
+#define SCOPED_SLOCK2(p) SSYNCBLOCKFOR(2, p) //2 for rc!!!
 #define SCOPED_SLOCK3(p) SSYNCBLOCKFOR(3, p) //3 for ?
 #define SCOPED_SLOCK4(p) SSYNCBLOCKFOR(4, p) //4 for ?
 #define SCOPED_SLOCK5(p) SSYNCBLOCKFOR(5, p) //5 for ?
@@ -0,0 +1,59 @@
+/*
+ * ELongBinaryOperator.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ELONGBINARYOPERATOR_HH_
+#define ELONGBINARYOPERATOR_HH_
+
+#include "EObject.hh"
+
+#ifdef CPP11_SUPPORT
+#include <functional>
+#endif
+
+namespace efc {
+
+//@see: openjdk-8/src/share/classes/java/util/function/LongBinaryOperator.java
+
+/**
+ * Represents an operation upon two {@code llong}-valued operands and producing an
+ * {@code llong}-valued result.
+ *
+ * @since 1.8
+ */
+
+interface ELongBinaryOperator : virtual public EObject {
+	virtual ~ELongBinaryOperator() {
+	}
+
+	/**
+	 * Applies this operator to the given operands.
+	 *
+	 * @param left the first operand
+	 * @param right the second operand
+	 * @return the operator result
+	 */
+	virtual llong applyAsLong(llong left, llong right) = 0;
+};
+
+#ifdef CPP11_SUPPORT
+class ELongBinaryOperatorTarget: virtual public ELongBinaryOperator {
+public:
+	virtual ~ELongBinaryOperatorTarget(){}
+
+	ELongBinaryOperatorTarget(std::function<llong(llong, llong)>& f) {
+		this->f = f;
+	}
+	virtual llong applyAsLong(llong left, llong right) {
+		return f(left, right);
+	}
+private:
+	std::function<llong(llong, llong)> f;
+};
+#endif
+
+} /* namespace efc */
+#endif /* ELONGBINARYOPERATOR_HH_ */
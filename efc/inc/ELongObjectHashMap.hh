@@ -0,0 +1,46 @@
+/*
+ * ELongObjectHashMap.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ELONGOBJECTHASHMAP_HH_
+#define ELONGOBJECTHASHMAP_HH_
+
+#include "EFlatHashMap.hh"
+
+namespace efc {
+
+/**
+ * A hash map from <tt>llong</tt> keys to objects.
+ *
+ * <p>This is an {@link EFlatHashMap} with primitive keys: each key is
+ * stored unboxed next to its value in the slot array, so an entry costs
+ * the key, the value pointer and one control byte, instead of an
+ * <tt>ELLong</tt> key object plus a chained entry as in
+ * <tt>EHashMap&lt;ELLong*, V&gt;</tt>.  Values are native pointers, owned
+ * by the map when <tt>autoFree</tt> is set, or shared pointers.
+ *
+ * <p><strong>Note that this implementation is not synchronized.</strong>
+ *
+ * @param <V> the type of mapped values
+ */
+template<typename V>
+class ELongObjectHashMap : public EFlatHashMap<llong, V> {
+public:
+	/**
+	 * Constructs an empty map with room for expectedSize mappings before
+	 * it has to grow.
+	 *
+	 * @param expectedSize the expected number of mappings
+	 * @param autoFree whether native pointer values are deleted by the map
+	 */
+	explicit
+	ELongObjectHashMap(int expectedSize = 16, boolean autoFree = true) :
+			EFlatHashMap<llong, V>(expectedSize, autoFree) {
+	}
+};
+
+} /* namespace efc */
+#endif /* ELONGOBJECTHASHMAP_HH_ */
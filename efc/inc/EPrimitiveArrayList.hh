@@ -0,0 +1,384 @@
+/*
+ * EPrimitiveArrayList.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EPRIMITIVEARRAYLIST_HH_
+#define EPRIMITIVEARRAYLIST_HH_
+
+#include "EA.hh"
+#include "EArrays.hh"
+#include "EString.hh"
+#include "EOutOfMemoryError.hh"
+#include "EIndexOutOfBoundsException.hh"
+#include "EIllegalArgumentException.hh"
+
+namespace efc {
+
+/**
+ * Resizable array of a primitive type, with the element storage of a
+ * plain C array.
+ *
+ * <p>{@link EArrayList} holds numbers either through <tt>eso_array</tt>
+ * calls behind a virtual list interface or, for <tt>EInteger*</tt> and
+ * <tt>sp&lt;EInteger&gt;</tt>, as one heap object per element.  This list
+ * keeps the values themselves in one contiguous block: <tt>add</tt> and
+ * <tt>getAt</tt> are inline, a list of n ints takes 4n bytes plus the
+ * growth slack, and {@link #data} exposes the block for bulk work.
+ *
+ * <p>Use the {@link EIntArrayList} and {@link ELongArrayList} classes.
+ *
+ * <p><strong>Note that this implementation is not synchronized.</strong>
+ *
+ * @param <E> the primitive element type
+ */
+template<typename E>
+class EPrimitiveArrayList : public EObject {
+public:
+	virtual ~EPrimitiveArrayList() {
+		eso_free(elementData);
+	}
+
+	/**
+	 * Constructs an empty list with the specified initial capacity.
+	 */
+	explicit
+	EPrimitiveArrayList(int initialCapacity = 16) :
+			elementData(null), _size(0), _capacity(0) {
+		if (initialCapacity < 0) {
+			throw EIllegalArgumentException(__FILE__, __LINE__,
+					EString::formatOf("Illegal Capacity: %d", initialCapacity).c_str());
+		}
+		grow(initialCapacity);
+	}
+
+	/**
+	 * Constructs a list containing the n values starting at a.
+	 */
+	EPrimitiveArrayList(const E* a, int n) :
+			elementData(null), _size(0), _capacity(0) {
+		addAll(a, n);
+	}
+
+	EPrimitiveArrayList(const EPrimitiveArrayList<E>& that) :
+			elementData(null), _size(0), _capacity(0) {
+		addAll(that.elementData, that._size);
+	}
+
+	EPrimitiveArrayList<E>& operator= (const EPrimitiveArrayList<E>& that) {
+		if (this != &that) {
+			_size = 0;
+			addAll(that.elementData, that._size);
+		}
+		return *this;
+	}
+
+	/**
+	 * Appends the specified element to the end of this list.
+	 */
+	void add(E e) {
+		if (_size == _capacity)
+			grow(_size + 1);
+		elementData[_size++] = e;
+	}
+
+	/**
+	 * Inserts the specified element at the specified position in this
+	 * list, shifting the following elements to the right.
+	 */
+	void addAt(int index, E e) THROWS(EIndexOutOfBoundsException) {
+		rangeCheckForAdd(index);
+		if (_size == _capacity)
+			grow(_size + 1);
+		eso_memmove(elementData + index + 1, elementData + index, (_size - index) * sizeof(E));
+		elementData[index] = e;
+		_size++;
+	}
+
+	/**
+	 * Appends the n values starting at a, which may point into this
+	 * list's own storage.
+	 */
+	void addAll(const E* a, int n) {
+		if (n <= 0)
+			return;
+		if (_size + n > _capacity) {
+			// a moves with the storage if it points into it
+			if (a >= elementData && a < elementData + _size) {
+				int offset = (int)(a - elementData);
+				grow(_size + n);
+				a = elementData + offset;
+			} else {
+				grow(_size + n);
+			}
+		}
+		eso_memcpy(elementData + _size, a, n * sizeof(E));
+		_size += n;
+	}
+
+	void addAll(EA<E>* a) {
+		addAll(a->address(), a->length());
+	}
+
+	E getAt(int index) THROWS(EIndexOutOfBoundsException) {
+		rangeCheck(index);
+		return elementData[index];
+	}
+
+	E& operator [](int index) THROWS(EIndexOutOfBoundsException) {
+		rangeCheck(index);
+		return elementData[index];
+	}
+
+	/**
+	 * Replaces the element at the specified position in this list and
+	 * returns the previous one.
+	 */
+	E setAt(int index, E e) THROWS(EIndexOutOfBoundsException) {
+		rangeCheck(index);
+		E old = elementData[index];
+		elementData[index] = e;
+		return old;
+	}
+
+	/**
+	 * Removes the element at the specified position in this list,
+	 * shifting the following elements to the left, and returns it.
+	 */
+	E removeAt(int index) THROWS(EIndexOutOfBoundsException) {
+		rangeCheck(index);
+		E old = elementData[index];
+		eso_memmove(elementData + index, elementData + index + 1, (_size - index - 1) * sizeof(E));
+		_size--;
+		return old;
+	}
+
+	/**
+	 * Removes the first occurrence of the specified element, if present.
+	 */
+	boolean remove(E e) {
+		int i = indexOf(e);
+		if (i < 0)
+			return false;
+		removeAt(i);
+		return true;
+	}
+
+	/**
+	 * Removes the elements from fromIndex, inclusive, to toIndex,
+	 * exclusive.
+	 */
+	void removeRange(int fromIndex, int toIndex) THROWS(EIndexOutOfBoundsException) {
+		if (fromIndex < 0 || toIndex > _size || fromIndex > toIndex) {
+			throw EIndexOutOfBoundsException(__FILE__, __LINE__,
+					EString::formatOf("fromIndex(%d), toIndex(%d), Size: %d", fromIndex, toIndex, _size).c_str());
+		}
+		eso_memmove(elementData + fromIndex, elementData + toIndex, (_size - toIndex) * sizeof(E));
+		_size -= toIndex - fromIndex;
+	}
+
+	int indexOf(E e) {
+		for (int i = 0; i < _size; i++) {
+			if (elementData[i] == e)
+				return i;
+		}
+		return -1;
+	}
+
+	int lastIndexOf(E e) {
+		for (int i = _size - 1; i >= 0; i--) {
+			if (elementData[i] == e)
+				return i;
+		}
+		return -1;
+	}
+
+	boolean contains(E e) {
+		return indexOf(e) >= 0;
+	}
+
+	int size() {
+		return _size;
+	}
+
+	boolean isEmpty() {
+		return _size == 0;
+	}
+
+	int capacity() {
+		return _capacity;
+	}
+
+	/**
+	 * Removes all of the elements from this list; the capacity is kept.
+	 */
+	void clear() {
+		_size = 0;
+	}
+
+	/**
+	 * Increases the capacity, if necessary, to hold at least minCapacity
+	 * elements.
+	 */
+	void ensureCapacity(int minCapacity) {
+		if (minCapacity > _capacity)
+			grow(minCapacity);
+	}
+
+	/**
+	 * Trims the capacity of this list to its current size.
+	 */
+	void trimToSize() {
+		if (_size < _capacity)
+			resize(_size);
+	}
+
+	/**
+	 * Sorts this list into ascending order, with the radix sort of
+	 * {@link EArrays#sort} for large lists.
+	 */
+	void sort() {
+		EA<E> view(elementData, _size, false, MEM_MALLOC);
+		EArrays::sort(&view, 0, _size);
+	}
+
+	/**
+	 * Searches this list, which must be sorted, for the specified value.
+	 *
+	 * @return index of the value, if it is contained in the list;
+	 *         otherwise, <tt>(-(<i>insertion point</i>) - 1)</tt>
+	 */
+	int binarySearch(E key) {
+		int low = 0, high = _size - 1;
+		while (low <= high) {
+			int mid = (int)((uint)(low + high) >> 1);
+			E v = elementData[mid];
+			if (v < key)
+				low = mid + 1;
+			else if (v > key)
+				high = mid - 1;
+			else
+				return mid;
+		}
+		return -(low + 1);
+	}
+
+	/**
+	 * Returns the element storage, valid until the list is next resized.
+	 */
+	E* data() {
+		return elementData;
+	}
+
+	EA<E> toArray() {
+		return EA<E>(elementData, _size);
+	}
+
+	boolean equals(EPrimitiveArrayList<E>* that) {
+		if (that == this)
+			return true;
+		if (that == null || that->_size != _size)
+			return false;
+		for (int i = 0; i < _size; i++) {
+			if (elementData[i] != that->elementData[i])
+				return false;
+		}
+		return true;
+	}
+
+	virtual boolean equals(EObject* obj) {
+		return equals(dynamic_cast<EPrimitiveArrayList<E>*>(obj));
+	}
+
+	virtual int hashCode() {
+		int hashCode = 1;
+		for (int i = 0; i < _size; i++) {
+			llong v = (llong)elementData[i];
+			hashCode = 31 * hashCode + (int)(v ^ (v >> 32));
+		}
+		return hashCode;
+	}
+
+	virtual EStringBase toString() {
+		EStringBase sb;
+		sb.append('[');
+		for (int i = 0; i < _size; i++) {
+			if (i > 0)
+				sb.append(", ");
+			sb.append(elementData[i]);
+		}
+		return sb.append(']');
+	}
+
+protected:
+	E* elementData;
+	int _size;
+	int _capacity;
+
+	void grow(int minCapacity) {
+		int newCapacity = _capacity + (_capacity >> 1) + 1;
+		if (newCapacity < minCapacity)
+			newCapacity = minCapacity;
+		resize(newCapacity);
+	}
+
+	void resize(int newCapacity) {
+		if (newCapacity > 0) {
+			E* p = (E*)eso_realloc(elementData, newCapacity * sizeof(E));
+			if (!p) {
+				throw EOutOfMemoryError(__FILE__, __LINE__);
+			}
+			elementData = p;
+		}
+		_capacity = newCapacity;
+	}
+
+	void rangeCheck(int index) {
+		if (index < 0 || index >= _size) {
+			throw EIndexOutOfBoundsException(__FILE__, __LINE__,
+					EString::formatOf("Index: %d, Size: %d", index, _size).c_str());
+		}
+	}
+
+	void rangeCheckForAdd(int index) {
+		if (index < 0 || index > _size) {
+			throw EIndexOutOfBoundsException(__FILE__, __LINE__,
+					EString::formatOf("Index: %d, Size: %d", index, _size).c_str());
+		}
+	}
+};
+
+/**
+ * A resizable array of <tt>int</tt> values.
+ */
+class EIntArrayList : public EPrimitiveArrayList<int> {
+public:
+	explicit
+	EIntArrayList(int initialCapacity = 16) :
+			EPrimitiveArrayList<int>(initialCapacity) {
+	}
+
+	EIntArrayList(const int* a, int n) :
+			EPrimitiveArrayList<int>(a, n) {
+	}
+};
+
+/**
+ * A resizable array of <tt>llong</tt> values.
+ */
+class ELongArrayList : public EPrimitiveArrayList<llong> {
+public:
+	explicit
+	ELongArrayList(int initialCapacity = 16) :
+			EPrimitiveArrayList<llong>(initialCapacity) {
+	}
+
+	ELongArrayList(const llong* a, int n) :
+			EPrimitiveArrayList<llong>(a, n) {
+	}
+};
+
+} /* namespace efc */
+#endif /* EPRIMITIVEARRAYLIST_HH_ */
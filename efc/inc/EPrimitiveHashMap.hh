@@ -0,0 +1,330 @@
+/*
+ * EPrimitiveHashMap.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EPRIMITIVEHASHMAP_HH_
+#define EPRIMITIVEHASHMAP_HH_
+
+#include "EFlatHashMap.hh"
+
+namespace efc {
+
+/**
+ * Hash map from a primitive key type to a primitive value type, on the
+ * open addressing table of {@link EFlatHashMap}.
+ *
+ * <p>{@link EMap} values are objects, so a map of numbers to numbers
+ * would box every value.  Here key and value sit side by side in the
+ * slot array: an <tt>int</tt> to <tt>int</tt> map costs nine bytes per
+ * slot at a load factor of at most 7/8, and nothing is allocated per
+ * entry.  Lookups of absent keys return the map's <i>no entry value</i>
+ * (0 unless given to the constructor), so use {@link #containsKey} when
+ * that value can also be stored.
+ *
+ * <p>The {@link Iterator} is a value object, not an <tt>EIterator</tt>;
+ * it is fail-fast and may remove the current entry.
+ *
+ * <p>Use the {@link EIntIntHashMap} class.
+ *
+ * <p><strong>Note that this implementation is not synchronized.</strong>
+ *
+ * @param <K> the primitive key type
+ * @param <V> the primitive value type
+ */
+template<typename K, typename V>
+class EPrimitiveHashMap : public EObject {
+private:
+	struct Slot {
+		K key;
+		V value;
+		Slot(K k, V v) : key(k), value(v) {
+		}
+	};
+
+	typedef EFlatHashTable<K, Slot> Table;
+
+public:
+	/**
+	 * Iterates the entries of the map.
+	 */
+	class Iterator {
+	public:
+		boolean hasNext() {
+			index = m->table.nextFull(index);
+			return index < (int)m->table.capacity;
+		}
+
+		/**
+		 * Advances to the next entry and returns its key.
+		 */
+		K next() {
+			if (m->table.modCount != expectedModCount)
+				throw EConcurrentModificationException(__FILE__, __LINE__);
+			index = m->table.nextFull(index);
+			if (index >= (int)m->table.capacity)
+				throw ENoSuchElementException(__FILE__, __LINE__);
+			lastReturned = index++;
+			return m->table.slots[lastReturned].key;
+		}
+
+		K key() {
+			return current().key;
+		}
+
+		V value() {
+			return current().value;
+		}
+
+		void setValue(V value) {
+			current().value = value;
+		}
+
+		/**
+		 * Removes the current entry from the map.
+		 */
+		void remove() {
+			current();
+			m->table.erase(lastReturned);
+			lastReturned = -1;
+			expectedModCount = m->table.modCount;
+		}
+
+	private:
+		friend class EPrimitiveHashMap<K, V>;
+
+		EPrimitiveHashMap<K, V>* m;
+		int index;
+		int lastReturned;
+		int expectedModCount;
+
+		explicit Iterator(EPrimitiveHashMap<K, V>* m) :
+				m(m), index(0), lastReturned(-1), expectedModCount(m->table.modCount) {
+		}
+
+		Slot& current() {
+			if (lastReturned < 0)
+				throw EIllegalStateException(__FILE__, __LINE__);
+			if (m->table.modCount != expectedModCount)
+				throw EConcurrentModificationException(__FILE__, __LINE__);
+			return m->table.slots[lastReturned];
+		}
+	};
+
+	virtual ~EPrimitiveHashMap() {
+	}
+
+	/**
+	 * Constructs an empty map with room for expectedSize mappings before
+	 * it has to grow.
+	 *
+	 * @param expectedSize the expected number of mappings
+	 * @param noEntryValue the value returned for absent keys
+	 */
+	explicit
+	EPrimitiveHashMap(int expectedSize = 16, V noEntryValue = 0) :
+			table(expectedSize), noEntryValue(noEntryValue) {
+	}
+
+	int size() {
+		return table.size;
+	}
+
+	boolean isEmpty() {
+		return table.size == 0;
+	}
+
+	/**
+	 * Returns the value to which the specified key is mapped, or the no
+	 * entry value.
+	 */
+	V get(K key) {
+		int i = table.find(key);
+		return (i < 0) ? noEntryValue : table.slots[i].value;
+	}
+
+	/**
+	 * Returns the value to which the specified key is mapped, or
+	 * defaultValue.
+	 */
+	V get(K key, V defaultValue) {
+		int i = table.find(key);
+		return (i < 0) ? defaultValue : table.slots[i].value;
+	}
+
+	boolean containsKey(K key) {
+		return table.find(key) >= 0;
+	}
+
+	/**
+	 * Returns <tt>true</tt> if some key maps to the value; this scans
+	 * every slot.
+	 */
+	boolean containsValue(V value) {
+		for (int i = table.nextFull(0); i < (int)table.capacity; i = table.nextFull(i + 1)) {
+			if (table.slots[i].value == value)
+				return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Associates the specified value with the specified key, and returns
+	 * the previous value or the no entry value.
+	 */
+	V put(K key, V value, boolean *absent=null) {
+		ullong h = Table::hash(key);
+		int i = table.find(key, h);
+		if (i >= 0) {
+			if (absent) *absent = false;
+			V oldValue = table.slots[i].value;
+			table.slots[i].value = value;
+			return oldValue;
+		}
+		if (absent) *absent = true;
+		i = table.prepareInsert(h);
+		new (table.slots + i) Slot(key, value);
+		return noEntryValue;
+	}
+
+	/**
+	 * Adds delta to the value of the key, which is put with the value
+	 * delta if absent, and returns the new value.
+	 */
+	V addTo(K key, V delta) {
+		ullong h = Table::hash(key);
+		int i = table.find(key, h);
+		if (i >= 0) {
+			return table.slots[i].value += delta;
+		}
+		i = table.prepareInsert(h);
+		new (table.slots + i) Slot(key, delta);
+		return delta;
+	}
+
+	/**
+	 * Removes the mapping for the key, and returns its value or the no
+	 * entry value.
+	 */
+	V remove(K key) {
+		int i = table.find(key);
+		if (i < 0)
+			return noEntryValue;
+		V oldValue = table.slots[i].value;
+		table.erase(i);
+		return oldValue;
+	}
+
+	void clear() {
+		table.clear();
+	}
+
+	/**
+	 * Makes room for expectedSize mappings without further rehashing.
+	 */
+	void reserve(int expectedSize) {
+		table.reserve(expectedSize);
+	}
+
+	/**
+	 * Returns the number of slots in the table.
+	 */
+	int capacity() {
+		return table.capacity;
+	}
+
+	V getNoEntryValue() {
+		return noEntryValue;
+	}
+
+	Iterator iterator() {
+		return Iterator(this);
+	}
+
+	/**
+	 * Returns the keys, in iteration order.
+	 */
+	EA<K> keys() {
+		EA<K> a(table.size);
+		int n = 0;
+		for (int i = table.nextFull(0); i < (int)table.capacity; i = table.nextFull(i + 1)) {
+			a[n++] = table.slots[i].key;
+		}
+		return a;
+	}
+
+	/**
+	 * Returns the values, in iteration order.
+	 */
+	EA<V> values() {
+		EA<V> a(table.size);
+		int n = 0;
+		for (int i = table.nextFull(0); i < (int)table.capacity; i = table.nextFull(i + 1)) {
+			a[n++] = table.slots[i].value;
+		}
+		return a;
+	}
+
+	boolean equals(EPrimitiveHashMap<K, V>* that) {
+		if (that == this)
+			return true;
+		if (that == null || that->size() != size())
+			return false;
+		for (int i = table.nextFull(0); i < (int)table.capacity; i = table.nextFull(i + 1)) {
+			int j = that->table.find(table.slots[i].key);
+			if (j < 0 || that->table.slots[j].value != table.slots[i].value)
+				return false;
+		}
+		return true;
+	}
+
+	virtual boolean equals(EObject* obj) {
+		return equals(dynamic_cast<EPrimitiveHashMap<K, V>*>(obj));
+	}
+
+	virtual int hashCode() {
+		int h = 0;
+		for (int i = table.nextFull(0); i < (int)table.capacity; i = table.nextFull(i + 1)) {
+			llong k = (llong)table.slots[i].key;
+			llong v = (llong)table.slots[i].value;
+			h += (int)(k ^ (k >> 32)) ^ (int)(v ^ (v >> 32));
+		}
+		return h;
+	}
+
+	virtual EStringBase toString() {
+		EStringBase sb;
+		sb.append('{');
+		for (int i = table.nextFull(0); i < (int)table.capacity; i = table.nextFull(i + 1)) {
+			if (sb.length() > 1)
+				sb.append(", ");
+			sb.append(table.slots[i].key).append('=').append(table.slots[i].value);
+		}
+		return sb.append('}');
+	}
+
+private:
+	Table table;
+
+	V noEntryValue;
+
+	// unsupported.
+	EPrimitiveHashMap(const EPrimitiveHashMap<K, V>& that);
+	EPrimitiveHashMap<K, V>& operator= (const EPrimitiveHashMap<K, V>& that);
+};
+
+/**
+ * A hash map from <tt>int</tt> keys to <tt>int</tt> values.
+ */
+class EIntIntHashMap : public EPrimitiveHashMap<int, int> {
+public:
+	explicit
+	EIntIntHashMap(int expectedSize = 16, int noEntryValue = 0) :
+			EPrimitiveHashMap<int, int>(expectedSize, noEntryValue) {
+	}
+};
+
+} /* namespace efc */
+#endif /* EPRIMITIVEHASHMAP_HH_ */
@@ -0,0 +1,251 @@
+/*
+ * EPrimitiveHashSet.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EPRIMITIVEHASHSET_HH_
+#define EPRIMITIVEHASHSET_HH_
+
+#include "EFlatHashMap.hh"
+
+namespace efc {
+
+/**
+ * Hash set of a primitive type, on the open addressing table of
+ * {@link EFlatHashMap}.
+ *
+ * <p>Values are stored inline in the slot array, so a set of
+ * <tt>int</tt> costs five bytes per slot at a load factor of at most 7/8
+ * and allocates nothing per element.  Unlike {@link EFlatHashSet}, which
+ * implements the <tt>Set</tt> interface for any element type, the
+ * methods here are not virtual and the {@link Iterator} is a value
+ * object rather than a shared <tt>EIterator</tt>; it is fail-fast and may
+ * remove the current element.
+ *
+ * <p>Use the {@link EIntHashSet} class.
+ *
+ * <p><strong>Note that this implementation is not synchronized.</strong>
+ *
+ * @param <E> the primitive element type
+ */
+template<typename E>
+class EPrimitiveHashSet : public EObject {
+private:
+	struct Slot {
+		E key;
+		explicit Slot(E k) : key(k) {
+		}
+	};
+
+	typedef EFlatHashTable<E, Slot> Table;
+
+public:
+	/**
+	 * Iterates the elements of the set.
+	 */
+	class Iterator {
+	public:
+		boolean hasNext() {
+			index = s->table.nextFull(index);
+			return index < (int)s->table.capacity;
+		}
+
+		E next() {
+			if (s->table.modCount != expectedModCount)
+				throw EConcurrentModificationException(__FILE__, __LINE__);
+			index = s->table.nextFull(index);
+			if (index >= (int)s->table.capacity)
+				throw ENoSuchElementException(__FILE__, __LINE__);
+			lastReturned = index++;
+			return s->table.slots[lastReturned].key;
+		}
+
+		/**
+		 * Removes the element last returned by next().
+		 */
+		void remove() {
+			if (lastReturned < 0)
+				throw EIllegalStateException(__FILE__, __LINE__);
+			if (s->table.modCount != expectedModCount)
+				throw EConcurrentModificationException(__FILE__, __LINE__);
+			s->table.erase(lastReturned);
+			lastReturned = -1;
+			expectedModCount = s->table.modCount;
+		}
+
+	private:
+		friend class EPrimitiveHashSet<E>;
+
+		EPrimitiveHashSet<E>* s;
+		int index;
+		int lastReturned;
+		int expectedModCount;
+
+		explicit Iterator(EPrimitiveHashSet<E>* s) :
+				s(s), index(0), lastReturned(-1), expectedModCount(s->table.modCount) {
+		}
+	};
+
+	virtual ~EPrimitiveHashSet() {
+	}
+
+	/**
+	 * Constructs an empty set with room for expectedSize elements before
+	 * it has to grow.
+	 */
+	explicit
+	EPrimitiveHashSet(int expectedSize = 16) : table(expectedSize) {
+	}
+
+	/**
+	 * Constructs a set of the n values starting at a.
+	 */
+	EPrimitiveHashSet(const E* a, int n) : table(n) {
+		addAll(a, n);
+	}
+
+	int size() {
+		return table.size;
+	}
+
+	boolean isEmpty() {
+		return table.size == 0;
+	}
+
+	boolean contains(E e) {
+		return table.find(e) >= 0;
+	}
+
+	/**
+	 * Adds the specified element if it is not already present.
+	 *
+	 * @return <tt>true</tt> if the set did not already contain it
+	 */
+	boolean add(E e) {
+		ullong h = Table::hash(e);
+		if (table.find(e, h) >= 0)
+			return false;
+		int i = table.prepareInsert(h);
+		new (table.slots + i) Slot(e);
+		return true;
+	}
+
+	/**
+	 * Adds the n values starting at a.
+	 *
+	 * @return the number of values that were not already present
+	 */
+	int addAll(const E* a, int n) {
+		table.reserve(table.size + n);
+		int added = 0;
+		for (int i = 0; i < n; i++) {
+			added += add(a[i]);
+		}
+		return added;
+	}
+
+	boolean remove(E e) {
+		int i = table.find(e);
+		if (i < 0)
+			return false;
+		table.erase(i);
+		return true;
+	}
+
+	void clear() {
+		table.clear();
+	}
+
+	/**
+	 * Makes room for expectedSize elements without further rehashing.
+	 */
+	void reserve(int expectedSize) {
+		table.reserve(expectedSize);
+	}
+
+	/**
+	 * Returns the number of slots in the table.
+	 */
+	int capacity() {
+		return table.capacity;
+	}
+
+	Iterator iterator() {
+		return Iterator(this);
+	}
+
+	/**
+	 * Returns the elements, in iteration order.
+	 */
+	EA<E> toArray() {
+		EA<E> a(table.size);
+		int n = 0;
+		for (int i = table.nextFull(0); i < (int)table.capacity; i = table.nextFull(i + 1)) {
+			a[n++] = table.slots[i].key;
+		}
+		return a;
+	}
+
+	boolean equals(EPrimitiveHashSet<E>* that) {
+		if (that == this)
+			return true;
+		if (that == null || that->size() != size())
+			return false;
+		for (int i = table.nextFull(0); i < (int)table.capacity; i = table.nextFull(i + 1)) {
+			if (!that->contains(table.slots[i].key))
+				return false;
+		}
+		return true;
+	}
+
+	virtual boolean equals(EObject* obj) {
+		return equals(dynamic_cast<EPrimitiveHashSet<E>*>(obj));
+	}
+
+	virtual int hashCode() {
+		int h = 0;
+		for (int i = table.nextFull(0); i < (int)table.capacity; i = table.nextFull(i + 1)) {
+			llong v = (llong)table.slots[i].key;
+			h += (int)(v ^ (v >> 32));
+		}
+		return h;
+	}
+
+	virtual EStringBase toString() {
+		EStringBase sb;
+		sb.append('[');
+		for (int i = table.nextFull(0); i < (int)table.capacity; i = table.nextFull(i + 1)) {
+			if (sb.length() > 1)
+				sb.append(", ");
+			sb.append(table.slots[i].key);
+		}
+		return sb.append(']');
+	}
+
+private:
+	Table table;
+
+	// unsupported.
+	EPrimitiveHashSet(const EPrimitiveHashSet<E>& that);
+	EPrimitiveHashSet<E>& operator= (const EPrimitiveHashSet<E>& that);
+};
+
+/**
+ * A hash set of <tt>int</tt> values.
+ */
+class EIntHashSet : public EPrimitiveHashSet<int> {
+public:
+	explicit
+	EIntHashSet(int expectedSize = 16) :
+			EPrimitiveHashSet<int>(expectedSize) {
+	}
+
+	EIntHashSet(const int* a, int n) :
+			EPrimitiveHashSet<int>(a, n) {
+	}
+};
+
+} /* namespace efc */
+#endif /* EPRIMITIVEHASHSET_HH_ */
@@ -0,0 +1,1136 @@
+/*
+ * ERoaringBitmap.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EROARINGBITMAP_HH_
+#define EROARINGBITMAP_HH_
+
+#include "EBitSet.hh"
+#include "EBitWords.hh"
+#include "EInteger.hh"
+#include "EByteBuffer.hh"
+#include "ESharedPtr.hh"
+#include "EIllegalArgumentException.hh"
+#include "EIndexOutOfBoundsException.hh"
+
+#include <string.h>
+
+namespace efc {
+
+/**
+ * A compressed bitset with the API of {@link EBitSet}, for sparse sets of
+ * non-negative <tt>int</tt> bit indices.
+ *
+ * <p>Bit indices are split on their high 16 bits into chunks of 65536
+ * bits.  Each non-empty chunk is a container: a sorted array of its low
+ * 16 bits while it holds at most 4096 of them, or a plain 8KB bitmap once
+ * it holds more.  A sparse bitmap thus costs about two bytes per set bit
+ * whatever its length, and bulk operations only visit chunks present in
+ * both operands; bitmap containers go through the {@link EBitWords}
+ * kernels.  Use {@link #andCardinality} to count an intersection without
+ * building it.
+ *
+ * <p>{@link #serialize} writes the portable Roaring format shared by the
+ * CRoaring and Java implementations; {@link #deserialize} also reads the
+ * run containers those implementations may write.
+ *
+ * <p><strong>Note that this implementation is not synchronized.</strong>
+ */
+
+class ERoaringBitmap : public EObject {
+public:
+	virtual ~ERoaringBitmap() {
+		clear();
+		delete[] keys_;
+		delete[] conts_;
+	}
+
+	/**
+	 * Creates a new, empty bitmap.
+	 */
+	ERoaringBitmap() :
+			keys_(null), conts_(null), size_(0), capacity_(0) {
+	}
+
+	ERoaringBitmap(const ERoaringBitmap& that) :
+			keys_(null), conts_(null), size_(0), capacity_(0) {
+		copyFrom(that);
+	}
+
+	/**
+	 * Creates a bitmap holding the bits set in the specified bitset.
+	 */
+	explicit
+	ERoaringBitmap(EBitSet* bits) :
+			keys_(null), conts_(null), size_(0), capacity_(0) {
+		for (int i = bits->nextSetBit(0); i >= 0; i = bits->nextSetBit(i + 1)) {
+			add(i);
+		}
+	}
+
+	ERoaringBitmap& operator= (const ERoaringBitmap& that) {
+		if (this != &that) {
+			clear();
+			copyFrom(that);
+		}
+		return *this;
+	}
+
+	void flip(int bitIndex) {
+		if (get(bitIndex))
+			clear(bitIndex);
+		else
+			add(bitIndex);
+	}
+
+	void flip(int fromIndex, int toIndex) THROWS(EIndexOutOfBoundsException) {
+		rangeOp(fromIndex, toIndex, RANGE_FLIP);
+	}
+
+	void set(int bitIndex, boolean value=true) {
+		if (value) {
+			checkIndex(bitIndex);
+			add(bitIndex);
+		} else {
+			clear(bitIndex);
+		}
+	}
+
+	void set(int fromIndex, int toIndex, boolean value) THROWS(EIndexOutOfBoundsException) {
+		rangeOp(fromIndex, toIndex, value ? RANGE_SET : RANGE_CLEAR);
+	}
+
+	void clear(int bitIndex) {
+		checkIndex(bitIndex);
+		int i = indexOf(bitIndex >> 16);
+		if (i >= 0 && removeFrom(conts_[i], bitIndex & 0xFFFF) && conts_[i].card == 0) {
+			removeAt(i);
+		}
+	}
+
+	void clear(int fromIndex, int toIndex) THROWS(EIndexOutOfBoundsException) {
+		rangeOp(fromIndex, toIndex, RANGE_CLEAR);
+	}
+
+	void clear() {
+		for (int i = 0; i < size_; i++) {
+			release(conts_[i]);
+		}
+		size_ = 0;
+	}
+
+	boolean get(int bitIndex) {
+		checkIndex(bitIndex);
+		int i = indexOf(bitIndex >> 16);
+		return i >= 0 && contains(conts_[i], bitIndex & 0xFFFF);
+	}
+
+	/**
+	 * Returns the index of the first bit that is set to true that occurs
+	 * on or after the specified starting index, or -1 if there is none.
+	 */
+	int nextSetBit(int fromIndex) {
+		checkIndex(fromIndex);
+		int key = fromIndex >> 16;
+		int i = indexOf(key);
+		if (i >= 0) {
+			int v = next(conts_[i], fromIndex & 0xFFFF);
+			if (v >= 0)
+				return (key << 16) | v;
+			i++;
+		} else {
+			i = -i - 1;
+		}
+		return i < size_ ? (keys_[i] << 16) | next(conts_[i], 0) : -1;
+	}
+
+	/**
+	 * Returns the index of the first bit that is set to false that occurs
+	 * on or after the specified starting index, or -1 if every bit up to
+	 * <tt>Integer.MAX_VALUE</tt> is set.
+	 */
+	int nextClearBit(int fromIndex) {
+		checkIndex(fromIndex);
+		for (;;) {
+			int key = fromIndex >> 16;
+			int i = indexOf(key);
+			if (i < 0)
+				return fromIndex;
+			int v = nextClear(conts_[i], fromIndex & 0xFFFF);
+			if (v < 0x10000)
+				return (key << 16) | v;
+			if (key == 0x7FFF)
+				return -1;
+			fromIndex = (key + 1) << 16;
+		}
+	}
+
+	/**
+	 * Returns the index of the highest set bit plus one.
+	 */
+	int length() {
+		if (size_ == 0)
+			return 0;
+		Container& c = conts_[size_ - 1];
+		int last;
+		if (c.words) {
+			int u = WORDS - 1;
+			while (c.words[u] == 0) u--;
+			last = (u << 6) + EBitWords::highestBit(c.words[u]);
+		} else {
+			last = c.array[c.card - 1];
+		}
+		return ((keys_[size_ - 1] << 16) | last) + 1;
+	}
+
+	boolean isEmpty() {
+		return size_ == 0;
+	}
+
+	boolean intersects(ERoaringBitmap* set) {
+		for (int i = 0, j = 0; i < size_ && j < set->size_;) {
+			if (keys_[i] < set->keys_[j]) {
+				i++;
+			} else if (keys_[i] > set->keys_[j]) {
+				j++;
+			} else {
+				if (intersects(conts_[i], set->conts_[j]))
+					return true;
+				i++;
+				j++;
+			}
+		}
+		return false;
+	}
+
+	int cardinality() {
+		int n = 0;
+		for (int i = 0; i < size_; i++) {
+			n += conts_[i].card;
+		}
+		return n;
+	}
+
+	/**
+	 * Returns the number of bits set in both this and the specified bitmap,
+	 * without modifying either of them.
+	 */
+	int andCardinality(ERoaringBitmap* set) {
+		int n = 0;
+		for (int i = 0, j = 0; i < size_ && j < set->size_;) {
+			if (keys_[i] < set->keys_[j]) {
+				i++;
+			} else if (keys_[i] > set->keys_[j]) {
+				j++;
+			} else {
+				n += andCardinality(conts_[i], set->conts_[j]);
+				i++;
+				j++;
+			}
+		}
+		return n;
+	}
+
+	void and_(ERoaringBitmap* set) {
+		if (set == this)
+			return;
+		int w = 0;
+		for (int i = 0, j = 0; i < size_; i++) {
+			while (j < set->size_ && set->keys_[j] < keys_[i]) {
+				j++;
+			}
+			if (j < set->size_ && set->keys_[j] == keys_[i]) {
+				and_(conts_[i], set->conts_[j]);
+				j++;
+			} else {
+				release(conts_[i]);
+			}
+			keep(i, w);
+		}
+		size_ = w;
+	}
+
+	void or_(ERoaringBitmap* set) {
+		if (set != this)
+			merge(set, OR);
+	}
+
+	void xor_(ERoaringBitmap* set) {
+		if (set == this)
+			clear();
+		else
+			merge(set, XOR);
+	}
+
+	void andNot(ERoaringBitmap* set) {
+		if (set == this) {
+			clear();
+			return;
+		}
+		int w = 0;
+		for (int i = 0, j = 0; i < size_; i++) {
+			while (j < set->size_ && set->keys_[j] < keys_[i]) {
+				j++;
+			}
+			if (j < set->size_ && set->keys_[j] == keys_[i]) {
+				andNot(conts_[i], set->conts_[j]);
+			}
+			keep(i, w);
+		}
+		size_ = w;
+	}
+
+	virtual int hashCode() {
+		ullong h = 1234;
+		for (int i = 0; i < size_; i++) {
+			Container& c = conts_[i];
+			h = h * 31 + keys_[i];
+			h = h * 31 + c.card;
+			if (c.words) {
+				for (int u = 0; u < WORDS; u++) {
+					h = h * 31 + c.words[u];
+				}
+			} else {
+				for (int k = 0; k < c.card; k++) {
+					h = h * 31 + c.array[k];
+				}
+			}
+		}
+		return (int)((h >> 32) ^ h);
+	}
+
+	/**
+	 * Returns the number of bits of space actually in use by this bitmap
+	 * to represent bit values.
+	 */
+	int size() {
+		int n = 0;
+		for (int i = 0; i < size_; i++) {
+			n += conts_[i].words ? WORDS * 64 : conts_[i].card * 16;
+		}
+		return n;
+	}
+
+	boolean equals(ERoaringBitmap* set) {
+		if (set == this)
+			return true;
+		if (set == null || set->size_ != size_)
+			return false;
+		for (int i = 0; i < size_; i++) {
+			Container& a = conts_[i];
+			Container& b = set->conts_[i];
+			if (keys_[i] != set->keys_[i] || a.card != b.card)
+				return false;
+			// the container kind follows from the cardinality.
+			if (a.words ? memcmp(a.words, b.words, WORDS * sizeof(ullong)) != 0
+					: memcmp(a.array, b.array, a.card * sizeof(ushort)) != 0)
+				return false;
+		}
+		return true;
+	}
+
+	virtual boolean equals(EObject* obj) {
+		return equals(dynamic_cast<ERoaringBitmap*>(obj));
+	}
+
+	ERoaringBitmap* clone() {
+		return new ERoaringBitmap(*this);
+	}
+
+	virtual EStringBase toString() {
+		EStringBase sb;
+		sb.append('{');
+		for (int i = nextSetBit(0); i >= 0; i = nextSetBit(i + 1)) {
+			if (sb.length() > 1)
+				sb.append(", ");
+			sb.append(i);
+			if (i == EInteger::MAX_VALUE)
+				break;
+		}
+		return sb.append('}');
+	}
+
+	/**
+	 * Returns the number of bytes written by {@link #serialize}.
+	 */
+	int serializedSizeInBytes() {
+		int n = 8 + 8 * size_;
+		for (int i = 0; i < size_; i++) {
+			n += bytesOf(conts_[i]);
+		}
+		return n;
+	}
+
+	/**
+	 * Appends this bitmap to the buffer in the portable Roaring format.
+	 */
+	void serialize(EByteBuffer* out) {
+		int header = 8 + 8 * size_;
+		byte* h = new byte[header];
+		putInt(h, 0, SERIAL_COOKIE_NO_RUNCONTAINER);
+		putInt(h, 4, size_);
+		int offset = header;
+		for (int i = 0; i < size_; i++) {
+			putShort(h + 8 + 4 * i, keys_[i]);
+			putShort(h + 10 + 4 * i, conts_[i].card - 1);
+			putInt(h, 8 + 4 * size_ + 4 * i, offset);
+			offset += bytesOf(conts_[i]);
+		}
+		out->append(h, header);
+		delete[] h;
+
+		ushort probe = 1;
+		boolean littleEndian = *(byte*)&probe == 1;
+		byte scratch[WORDS * 8];
+		for (int i = 0; i < size_; i++) {
+			Container& c = conts_[i];
+			if (littleEndian) {
+				out->append(c.words ? (void*)c.words : (void*)c.array, bytesOf(c));
+			} else if (c.words) {
+				for (int u = 0; u < WORDS; u++) {
+					putInt(scratch, u * 8, (int)c.words[u]);
+					putInt(scratch, u * 8 + 4, (int)(c.words[u] >> 32));
+				}
+				out->append(scratch, bytesOf(c));
+			} else {
+				for (int k = 0; k < c.card; k++) {
+					putShort(scratch + 2 * k, c.array[k]);
+				}
+				out->append(scratch, bytesOf(c));
+			}
+		}
+	}
+
+	/**
+	 * Reads a bitmap in the portable Roaring format.
+	 *
+	 * @throws IllegalArgumentException if the data is truncated or is not
+	 *         a valid bitmap of non-negative int indices
+	 */
+	static sp<ERoaringBitmap> deserialize(const void* data, int size) THROWS(EIllegalArgumentException) {
+		const byte* p = (const byte*)data;
+		check(size >= 4);
+		uint cookie = getInt(p, 0);
+		int n, pos;
+		const byte* runs = null;
+		boolean hasOffsets = true;
+		if (cookie == SERIAL_COOKIE_NO_RUNCONTAINER) {
+			check(size >= 8);
+			n = (int)getInt(p, 4);
+			check(n >= 0 && n <= 0x8000);
+			pos = 8;
+		} else if ((cookie & 0xFFFF) == SERIAL_COOKIE) {
+			n = (int)(cookie >> 16) + 1;
+			runs = p + 4;
+			pos = 4 + (n + 7) / 8;
+			hasOffsets = n >= NO_OFFSET_THRESHOLD;
+			check(n <= 0x8000);
+		} else {
+			throw EIllegalArgumentException(__FILE__, __LINE__, "not a roaring bitmap");
+		}
+		int header = pos;
+		pos += 4 * n + (hasOffsets ? 4 * n : 0);
+		check(pos <= size);
+
+		sp<ERoaringBitmap> r = new ERoaringBitmap();
+		r->ensureCapacity(n);
+		for (int i = 0; i < n; i++) {
+			int key = getShort(p + header + 4 * i);
+			int card = getShort(p + header + 4 * i + 2) + 1;
+			check(key < 0x8000 && (i == 0 || key > r->keys_[i - 1]));
+			Container c = { 0, 0, null, null };
+			if (runs != null && ((runs[i >> 3] >> (i & 7)) & 1)) {
+				check(pos + 2 <= size);
+				int nruns = getShort(p + pos);
+				pos += 2;
+				check(pos + 4 * nruns <= size);
+				// runs are (start, length - 1) pairs, ascending and disjoint.
+				int total = 0, end = 0;
+				for (int k = 0; k < nruns; k++) {
+					int start = getShort(p + pos + 4 * k);
+					int len = getShort(p + pos + 4 * k + 2) + 1;
+					check(start >= end && start + len <= 0x10000);
+					end = start + len;
+					total += len;
+				}
+				check(total > 0);
+				if (total > ARRAY_MAX) {
+					c.words = new ullong[WORDS]();
+				} else {
+					c.array = new ushort[total];
+					c.capacity = total;
+				}
+				for (int k = 0; k < nruns; k++) {
+					int start = getShort(p + pos + 4 * k);
+					int len = getShort(p + pos + 4 * k + 2) + 1;
+					if (c.words) {
+						fill(c.words, start, start + len, RANGE_SET);
+					} else {
+						for (int v = start; v < start + len; v++) {
+							c.array[c.card++] = (ushort)v;
+						}
+					}
+				}
+				c.card = total;
+				pos += 4 * nruns;
+			} else if (card > ARRAY_MAX) {
+				check(pos + WORDS * 8 <= size);
+				c.words = new ullong[WORDS];
+				for (int u = 0; u < WORDS; u++) {
+					c.words[u] = getInt(p, pos + u * 8) | ((ullong)getInt(p, pos + u * 8 + 4) << 32);
+				}
+				c.card = (int)EBitWords::cardinality(c.words, WORDS);
+				pos += WORDS * 8;
+				if (c.card <= ARRAY_MAX) {
+					if (c.card == 0) {
+						release(c);
+						check(false);
+					}
+					toArray(c);
+				}
+			} else {
+				check(pos + 2 * card <= size);
+				c.array = new ushort[card];
+				c.capacity = card;
+				for (int k = 0; k < card; k++) {
+					c.array[k] = (ushort)getShort(p + pos + 2 * k);
+					if (k > 0 && c.array[k] <= c.array[k - 1]) {
+						release(c);
+						check(false);
+					}
+				}
+				c.card = card;
+				pos += 2 * card;
+			}
+			r->keys_[i] = (ushort)key;
+			r->conts_[i] = c;
+			r->size_ = i + 1;
+		}
+		return r;
+	}
+
+	/**
+	 * Reads a bitmap from the start of the buffer.
+	 */
+	static sp<ERoaringBitmap> deserialize(EByteBuffer* in) THROWS(EIllegalArgumentException) {
+		return deserialize(in->data(), in->size());
+	}
+
+private:
+	static const int ARRAY_MAX = 4096;
+	static const int WORDS = 1024;
+
+	static const uint SERIAL_COOKIE_NO_RUNCONTAINER = 12346;
+	static const uint SERIAL_COOKIE = 12347;
+	static const int NO_OFFSET_THRESHOLD = 4;
+
+	enum { RANGE_SET, RANGE_CLEAR, RANGE_FLIP };
+	enum { OR, XOR };
+
+	/**
+	 * A chunk of 65536 bits: a sorted array of at most ARRAY_MAX values,
+	 * or a bitmap of WORDS words when it holds more.
+	 */
+	struct Container {
+		int card;
+		int capacity;
+		ushort* array;
+		ullong* words;
+	};
+
+	ushort* keys_;
+	Container* conts_;
+	int size_;
+	int capacity_;
+
+	static void checkIndex(int bitIndex) {
+		if (bitIndex < 0)
+			throw EIndexOutOfBoundsException(__FILE__, __LINE__, "bitIndex < 0");
+	}
+
+	static void check(boolean valid) {
+		if (!valid)
+			throw EIllegalArgumentException(__FILE__, __LINE__, "corrupted roaring bitmap");
+	}
+
+	// little-endian fields of the serialized format.
+
+	static int getShort(const byte* p) {
+		const ubyte* u = (const ubyte*)p;
+		return u[0] | (u[1] << 8);
+	}
+
+	static uint getInt(const byte* p, int off) {
+		const ubyte* u = (const ubyte*)p + off;
+		return u[0] | (u[1] << 8) | (u[2] << 16) | ((uint)u[3] << 24);
+	}
+
+	static void putShort(byte* p, int v) {
+		p[0] = (byte)v;
+		p[1] = (byte)(v >> 8);
+	}
+
+	static void putInt(byte* p, int off, int v) {
+		p += off;
+		p[0] = (byte)v;
+		p[1] = (byte)(v >> 8);
+		p[2] = (byte)(v >> 16);
+		p[3] = (byte)(v >> 24);
+	}
+
+	static int bytesOf(const Container& c) {
+		return c.words ? WORDS * 8 : c.card * 2;
+	}
+
+	// the index of key, or -(insertion point) - 1.
+	int indexOf(int key) {
+		if (size_ > 0 && keys_[size_ - 1] == key)
+			return size_ - 1;
+		int lo = 0, hi = size_ - 1;
+		while (lo <= hi) {
+			int mid = (lo + hi) >> 1;
+			if (keys_[mid] < key)
+				lo = mid + 1;
+			else if (keys_[mid] > key)
+				hi = mid - 1;
+			else
+				return mid;
+		}
+		return -(lo + 1);
+	}
+
+	void ensureCapacity(int minCapacity) {
+		if (capacity_ >= minCapacity)
+			return;
+		int cap = ES_MAX(ES_MAX(minCapacity, capacity_ * 2), 4);
+		ushort* keys = new ushort[cap];
+		Container* conts = new Container[cap];
+		if (size_ > 0) {
+			memcpy(keys, keys_, size_ * sizeof(ushort));
+			memcpy(conts, conts_, size_ * sizeof(Container));
+		}
+		delete[] keys_;
+		delete[] conts_;
+		keys_ = keys;
+		conts_ = conts;
+		capacity_ = cap;
+	}
+
+	// inserts an empty container for key at index i.
+	Container& insertAt(int i, int key) {
+		ensureCapacity(size_ + 1);
+		memmove(keys_ + i + 1, keys_ + i, (size_ - i) * sizeof(ushort));
+		memmove(conts_ + i + 1, conts_ + i, (size_ - i) * sizeof(Container));
+		keys_[i] = (ushort)key;
+		Container c = { 0, 0, null, null };
+		conts_[i] = c;
+		size_++;
+		return conts_[i];
+	}
+
+	void removeAt(int i) {
+		release(conts_[i]);
+		memmove(keys_ + i, keys_ + i + 1, (size_ - i - 1) * sizeof(ushort));
+		memmove(conts_ + i, conts_ + i + 1, (size_ - i - 1) * sizeof(Container));
+		size_--;
+	}
+
+	// compaction step of in-place bulk operations: keeps container i at w
+	// unless it became empty.
+	void keep(int i, int& w) {
+		if (conts_[i].card == 0) {
+			release(conts_[i]);
+		} else {
+			keys_[w] = keys_[i];
+			conts_[w++] = conts_[i];
+		}
+	}
+
+	void add(int bitIndex) {
+		int key = bitIndex >> 16;
+		int i = indexOf(key);
+		Container& c = i >= 0 ? conts_[i] : insertAt(-i - 1, key);
+		addTo(c, bitIndex & 0xFFFF);
+	}
+
+	void copyFrom(const ERoaringBitmap& that) {
+		ensureCapacity(that.size_);
+		for (int i = 0; i < that.size_; i++) {
+			keys_[i] = that.keys_[i];
+			copy(conts_[i], that.conts_[i]);
+		}
+		size_ = that.size_;
+	}
+
+	void rangeOp(int fromIndex, int toIndex, int mode) {
+		if (fromIndex < 0)
+			throw EIndexOutOfBoundsException(__FILE__, __LINE__, "fromIndex < 0");
+		if (toIndex < 0)
+			throw EIndexOutOfBoundsException(__FILE__, __LINE__, "toIndex < 0");
+		if (fromIndex > toIndex)
+			throw EIndexOutOfBoundsException(__FILE__, __LINE__, "fromIndex > toIndex");
+		if (fromIndex == toIndex)
+			return;
+		int first = fromIndex >> 16, last = (toIndex - 1) >> 16;
+		for (int key = first; key <= last; key++) {
+			int lo = key == first ? fromIndex & 0xFFFF : 0;
+			int hi = key == last ? ((toIndex - 1) & 0xFFFF) + 1 : 0x10000;
+			int i = indexOf(key);
+			if (i < 0) {
+				if (mode == RANGE_CLEAR)
+					continue;
+				i = -i - 1;
+				insertAt(i, key);
+			}
+			Container& c = conts_[i];
+			if (c.words == null && hi - lo <= 64) {
+				for (int v = lo; v < hi; v++) {
+					if (mode == RANGE_SET || (mode == RANGE_FLIP && !contains(c, v)))
+						addTo(c, v);
+					else
+						removeFrom(c, v);
+				}
+			} else {
+				if (c.words == null)
+					toWords(c);
+				fill(c.words, lo, hi, mode);
+				c.card = (int)EBitWords::cardinality(c.words, WORDS);
+				normalize(c);
+			}
+			if (c.card == 0)
+				removeAt(i);
+		}
+	}
+
+	// or_ and xor_: both need containers of either operand.
+	void merge(ERoaringBitmap* set, int op) {
+		int cap = size_ + set->size_;
+		ushort* keys = new ushort[cap];
+		Container* conts = new Container[cap];
+		int k = 0, i = 0, j = 0;
+		while (i < size_ || j < set->size_) {
+			if (j == set->size_ || (i < size_ && keys_[i] < set->keys_[j])) {
+				keys[k] = keys_[i];
+				conts[k++] = conts_[i++];
+			} else if (i == size_ || set->keys_[j] < keys_[i]) {
+				keys[k] = set->keys_[j];
+				copy(conts[k++], set->conts_[j++]);
+			} else {
+				Container c = conts_[i];
+				if (op == OR)
+					or_(c, set->conts_[j]);
+				else
+					xor_(c, set->conts_[j]);
+				if (c.card == 0) {
+					release(c);
+				} else {
+					keys[k] = keys_[i];
+					conts[k++] = c;
+				}
+				i++;
+				j++;
+			}
+		}
+		delete[] keys_;
+		delete[] conts_;
+		keys_ = keys;
+		conts_ = conts;
+		size_ = k;
+		capacity_ = cap;
+	}
+
+	//=========================================================================
+	// containers
+
+	static void release(Container& c) {
+		delete[] c.array;
+		delete[] c.words;
+		c.array = null;
+		c.words = null;
+		c.card = c.capacity = 0;
+	}
+
+	static void copy(Container& d, const Container& s) {
+		d.card = s.card;
+		d.capacity = 0;
+		d.array = null;
+		d.words = null;
+		if (s.words) {
+			d.words = new ullong[WORDS];
+			memcpy(d.words, s.words, WORDS * sizeof(ullong));
+		} else {
+			d.capacity = s.card;
+			d.array = new ushort[s.card];
+			memcpy(d.array, s.array, s.card * sizeof(ushort));
+		}
+	}
+
+	static boolean bit(const ullong* words, int v) {
+		return (words[v >> 6] >> (v & 63)) & 1;
+	}
+
+	// the first index of a[0..n) not less than v.
+	static int lowerBound(const ushort* a, int n, int v) {
+		int lo = 0;
+		while (n > 0) {
+			int half = n >> 1;
+			if (a[lo + half] < v) {
+				lo += half + 1;
+				n -= half + 1;
+			} else {
+				n = half;
+			}
+		}
+		return lo;
+	}
+
+	static boolean contains(const Container& c, int v) {
+		if (c.words)
+			return bit(c.words, v);
+		int p = lowerBound(c.array, c.card, v);
+		return p < c.card && c.array[p] == v;
+	}
+
+	static boolean addTo(Container& c, int v) {
+		if (c.words) {
+			if (bit(c.words, v))
+				return false;
+			c.words[v >> 6] |= 1ULL << (v & 63);
+			c.card++;
+			return true;
+		}
+		int p = (c.card > 0 && c.array[c.card - 1] < v) ? c.card : lowerBound(c.array, c.card, v);
+		if (p < c.card && c.array[p] == v)
+			return false;
+		if (c.card == ARRAY_MAX) {
+			toWords(c);
+			c.words[v >> 6] |= 1ULL << (v & 63);
+			c.card++;
+			return true;
+		}
+		if (c.card == c.capacity) {
+			int cap = c.capacity < 64 ? ES_MAX(c.capacity * 2, 4)
+					: (c.capacity < 1024 ? c.capacity * 3 / 2 : c.capacity * 5 / 4);
+			if (cap > ARRAY_MAX)
+				cap = ARRAY_MAX;
+			ushort* a = new ushort[cap];
+			memcpy(a, c.array, p * sizeof(ushort));
+			memcpy(a + p + 1, c.array + p, (c.card - p) * sizeof(ushort));
+			delete[] c.array;
+			c.array = a;
+			c.capacity = cap;
+		} else {
+			memmove(c.array + p + 1, c.array + p, (c.card - p) * sizeof(ushort));
+		}
+		c.array[p] = (ushort)v;
+		c.card++;
+		return true;
+	}
+
+	static boolean removeFrom(Container& c, int v) {
+		if (c.words) {
+			if (!bit(c.words, v))
+				return false;
+			c.words[v >> 6] &= ~(1ULL << (v & 63));
+			c.card--;
+			normalize(c);
+			return true;
+		}
+		int p = lowerBound(c.array, c.card, v);
+		if (p == c.card || c.array[p] != v)
+			return false;
+		memmove(c.array + p, c.array + p + 1, (c.card - p - 1) * sizeof(ushort));
+		c.card--;
+		return true;
+	}
+
+	static void toWords(Container& c) {
+		ullong* w = new ullong[WORDS]();
+		for (int k = 0; k < c.card; k++) {
+			w[c.array[k] >> 6] |= 1ULL << (c.array[k] & 63);
+		}
+		delete[] c.array;
+		c.array = null;
+		c.capacity = 0;
+		c.words = w;
+	}
+
+	static void toArray(Container& c) {
+		ushort* a = new ushort[c.card];
+		int k = 0;
+		for (int u = 0; u < WORDS; u++) {
+			for (ullong w = c.words[u]; w != 0; w &= w - 1) {
+				a[k++] = (ushort)((u << 6) + EBitWords::numberOfTrailingZeros(w));
+			}
+		}
+		delete[] c.words;
+		c.words = null;
+		c.array = a;
+		c.capacity = c.card;
+	}
+
+	// keeps a bitmap only while it holds more than ARRAY_MAX values.
+	static void normalize(Container& c) {
+		if (c.words && c.card <= ARRAY_MAX)
+			toArray(c);
+	}
+
+	static void fill(ullong* words, int lo, int hi, int mode) {
+		int first = lo >> 6, last = (hi - 1) >> 6;
+		for (int u = first; u <= last; u++) {
+			ullong mask = ~0ULL;
+			if (u == first)
+				mask &= ~0ULL << (lo & 63);
+			if (u == last)
+				mask &= ~0ULL >> (63 - ((hi - 1) & 63));
+			if (mode == RANGE_SET)
+				words[u] |= mask;
+			else if (mode == RANGE_CLEAR)
+				words[u] &= ~mask;
+			else
+				words[u] ^= mask;
+		}
+	}
+
+	static int next(const Container& c, int v) {
+		if (c.words)
+			return EBitWords::nextSetBit(c.words, WORDS, v);
+		int p = lowerBound(c.array, c.card, v);
+		return p < c.card ? c.array[p] : -1;
+	}
+
+	static int nextClear(const Container& c, int v) {
+		if (c.words)
+			return EBitWords::nextClearBit(c.words, WORDS, v);
+		for (int p = lowerBound(c.array, c.card, v); p < c.card && c.array[p] == v; p++) {
+			v++;
+		}
+		return v;
+	}
+
+	// a[0..na) & b[0..nb) into out, which may be a; returns its size.
+	// A much smaller side is looked up in the other by binary search.
+	static int intersect(const ushort* a, int na, const ushort* b, int nb, ushort* out) {
+		int k = 0;
+		if (na * 32 < nb || nb * 32 < na) {
+			boolean small = na < nb;
+			const ushort* s = small ? a : b;
+			const ushort* l = small ? b : a;
+			int ns = small ? na : nb, nl = small ? nb : na, p = 0;
+			for (int i = 0; i < ns && p < nl; i++) {
+				p += lowerBound(l + p, nl - p, s[i]);
+				if (p < nl && l[p] == s[i]) {
+					if (out) out[k] = s[i];
+					k++;
+				}
+			}
+			return k;
+		}
+		return EBitWords::intersect(a, na, b, nb, out);
+	}
+
+	static int unite(const ushort* a, int na, const ushort* b, int nb, ushort* out) {
+		int i = 0, j = 0, k = 0;
+		while (i < na && j < nb) {
+			ushort x = a[i], y = b[j];
+			out[k++] = x <= y ? x : y;
+			i += x <= y;
+			j += y <= x;
+		}
+		while (i < na) out[k++] = a[i++];
+		while (j < nb) out[k++] = b[j++];
+		return k;
+	}
+
+	static int symmetricDifference(const ushort* a, int na, const ushort* b, int nb, ushort* out) {
+		int i = 0, j = 0, k = 0;
+		while (i < na && j < nb) {
+			ushort x = a[i], y = b[j];
+			if (x < y) {
+				out[k++] = x;
+				i++;
+			} else if (y < x) {
+				out[k++] = y;
+				j++;
+			} else {
+				i++;
+				j++;
+			}
+		}
+		while (i < na) out[k++] = a[i++];
+		while (j < nb) out[k++] = b[j++];
+		return k;
+	}
+
+	// a[0..na) - b[0..nb) into out, which may be a; returns its size.
+	static int difference(const ushort* a, int na, const ushort* b, int nb, ushort* out) {
+		int i = 0, j = 0, k = 0;
+		while (i < na) {
+			while (j < nb && b[j] < a[i]) j++;
+			if (j == nb || b[j] != a[i])
+				out[k++] = a[i];
+			i++;
+		}
+		return k;
+	}
+
+	// replaces the values of c by a new array.
+	static void assign(Container& c, ushort* a, int capacity, int card) {
+		release(c);
+		c.array = a;
+		c.capacity = capacity;
+		c.card = card;
+	}
+
+	// a bitmap copy of a, with the values of b toggled or set.
+	static void toggle(Container& a, const Container& b, boolean set) {
+		for (int k = 0; k < b.card; k++) {
+			int v = b.array[k];
+			ullong m = 1ULL << (v & 63);
+			if (a.words[v >> 6] & m) {
+				if (!set) {
+					a.words[v >> 6] ^= m;
+					a.card--;
+				}
+			} else {
+				a.words[v >> 6] |= m;
+				a.card++;
+			}
+		}
+	}
+
+	static boolean intersects(const Container& a, const Container& b) {
+		if (a.words && b.words)
+			return EBitWords::intersects(a.words, b.words, WORDS);
+		if (a.words || b.words) {
+			const Container& s = a.words ? b : a;
+			const ullong* w = a.words ? a.words : b.words;
+			for (int k = 0; k < s.card; k++) {
+				if (bit(w, s.array[k]))
+					return true;
+			}
+			return false;
+		}
+		return intersect(a.array, a.card, b.array, b.card, null) > 0;
+	}
+
+	static int andCardinality(const Container& a, const Container& b) {
+		if (a.words && b.words)
+			return (int)EBitWords::andCardinality(a.words, b.words, WORDS);
+		if (a.words || b.words) {
+			const Container& s = a.words ? b : a;
+			const ullong* w = a.words ? a.words : b.words;
+			int n = 0;
+			for (int k = 0; k < s.card; k++) {
+				n += bit(w, s.array[k]);
+			}
+			return n;
+		}
+		return intersect(a.array, a.card, b.array, b.card, null);
+	}
+
+	static void and_(Container& a, const Container& b) {
+		if (a.words && b.words) {
+			a.card = (int)EBitWords::apply(EBitWords::AND, a.words, a.words, b.words, WORDS);
+			normalize(a);
+		} else if (a.words) {
+			ushort* r = new ushort[b.card];
+			int k = 0;
+			for (int i = 0; i < b.card; i++) {
+				if (bit(a.words, b.array[i]))
+					r[k++] = b.array[i];
+			}
+			assign(a, r, b.card, k);
+		} else if (b.words) {
+			int k = 0;
+			for (int i = 0; i < a.card; i++) {
+				if (bit(b.words, a.array[i]))
+					a.array[k++] = a.array[i];
+			}
+			a.card = k;
+		} else {
+			a.card = intersect(a.array, a.card, b.array, b.card, a.array);
+		}
+	}
+
+	static void or_(Container& a, const Container& b) {
+		if (a.words && b.words) {
+			a.card = (int)EBitWords::apply(EBitWords::OR, a.words, a.words, b.words, WORDS);
+		} else if (a.words) {
+			toggle(a, b, true);
+		} else if (b.words || a.card + b.card > ARRAY_MAX) {
+			if (b.words) {
+				Container r;
+				copy(r, b);
+				toggle(r, a, true);
+				release(a);
+				a = r;
+			} else {
+				toWords(a);
+				toggle(a, b, true);
+			}
+			normalize(a);
+		} else {
+			int cap = a.card + b.card;
+			ushort* r = new ushort[cap];
+			int k = unite(a.array, a.card, b.array, b.card, r);
+			assign(a, r, cap, k);
+		}
+	}
+
+	static void xor_(Container& a, const Container& b) {
+		if (a.words && b.words) {
+			a.card = (int)EBitWords::apply(EBitWords::XOR, a.words, a.words, b.words, WORDS);
+		} else if (a.words) {
+			toggle(a, b, false);
+		} else if (b.words) {
+			Container r;
+			copy(r, b);
+			toggle(r, a, false);
+			release(a);
+			a = r;
+		} else if (a.card + b.card > ARRAY_MAX) {
+			toWords(a);
+			toggle(a, b, false);
+		} else {
+			int cap = a.card + b.card;
+			ushort* r = new ushort[cap];
+			int k = symmetricDifference(a.array, a.card, b.array, b.card, r);
+			assign(a, r, cap, k);
+			return;
+		}
+		normalize(a);
+	}
+
+	static void andNot(Container& a, const Container& b) {
+		if (a.words && b.words) {
+			a.card = (int)EBitWords::apply(EBitWords::AND_NOT, a.words, a.words, b.words, WORDS);
+			normalize(a);
+		} else if (a.words) {
+			for (int k = 0; k < b.card; k++) {
+				int v = b.array[k];
+				ullong m = 1ULL << (v & 63);
+				if (a.words[v >> 6] & m) {
+					a.words[v >> 6] ^= m;
+					a.card--;
+				}
+			}
+			normalize(a);
+		} else if (b.words) {
+			int k = 0;
+			for (int i = 0; i < a.card; i++) {
+				if (!bit(b.words, a.array[i]))
+					a.array[k++] = a.array[i];
+			}
+			a.card = k;
+		} else {
+			a.card = difference(a.array, a.card, b.array, b.card, a.array);
+		}
+	}
+};
+
+} /* namespace efc */
+#endif /* EROARINGBITMAP_HH_ */
@@ -21,40 +21,229 @@ extern ELock* gRCLock;
 //placement new class with reference count: __NEWRC(classT)(arg1, arg2);
 #define NEWRC(T) new (eso_calloc(sizeof(T) + sizeof(int))) T
 
+//hazard slots of NEWRC readers, shared by all threads.
+#define RC_HAZARD_SLOTS 128
+//retired objects queued before a retire scans the slots, more than
+//RC_HAZARD_SLOTS so that every scan frees at least the difference.
+#define RC_RECLAIM_THRESHOLD (RC_HAZARD_SLOTS * 2)
+
+/**
+ * Lock-free reclamation for NEWRC objects.
+ *
+ * A reader claims a slot, publishes the pointer it is about to use and
+ * re-reads the source; once the source still holds it the object can't
+ * be freed under the reader.  The DELRC that drops the last reference
+ * retires the object, and it's freed only when no slot publishes it.
+ * Objects that are still published are queued, and the queue is
+ * scanned by the retire that fills it to RC_RECLAIM_THRESHOLD, so
+ * readers never take the pool lock.  Slots are cache-line aligned and
+ * picked by the caller's stack address, so concurrent readers don't
+ * share cache lines.
+ *
+ * Pool 0 is for NEWRC objects, pool 1 for EAtomicSharedPtr.
+ */
+template< int I > class ERCHazardPool
+{
+public:
+	struct ES_CACHELINE_ALIGNED Slot {
+		void* volatile ptr;
+		volatile es_int32_t busy;
+	};
+
+	static Slot* acquire()
+	{
+		int anchor; // stacks of different threads are far apart
+		es_size_t h = (reinterpret_cast<es_size_t>(&anchor) >> 12) * 0x9E3779B1U;
+		for (;;) {
+			for (int i = 0; i < RC_HAZARD_SLOTS; i++) {
+				Slot* s = &slots_[(h + i) % RC_HAZARD_SLOTS];
+				if (s->busy == 0 && eso_atomic_compare_and_swap32(&s->busy, 0, 1)) {
+					return s;
+				}
+			}
+			eso_thread_yield();
+		}
+	}
+
+	template<typename T>
+	static T* protect(Slot* s, T* volatile& p0)
+	{
+		T* p = p0;
+		for (;;) {
+			s->ptr = p;
+			eso_atomic_synchronize();
+			T* q = p0;
+			if (q == p) {
+				return p;
+			}
+			p = q;
+		}
+	}
+
+	static void release(Slot* s)
+	{
+		eso_atomic_synchronize();
+		s->ptr = NULL;
+		eso_atomic_test_and_set32(&s->busy, 0);
+	}
+
+	static void retire(void* p, void (*deleter)(void*))
+	{
+		eso_atomic_synchronize();
+		if (!isHazard(p)) {
+			deleter(p);
+		} else {
+			Retired* r = (Retired*)eso_malloc(sizeof(Retired));
+			r->ptr = p;
+			r->deleter = deleter;
+			es_int32_t pending;
+			SCOPED_SLOCK2(&retired_) {
+				r->next = retired_;
+				retired_ = r;
+				pending = eso_atomic_add_and_fetch32(&retiredCount_, 1);
+			}}
+			if (pending >= RC_RECLAIM_THRESHOLD) {
+				reclaim();
+			}
+		}
+	}
+
+private:
+	struct Retired {
+		void* ptr;
+		void (*deleter)(void*);
+		Retired* next;
+	};
+
+	static Slot slots_[RC_HAZARD_SLOTS];
+	static Retired* retired_;
+	static volatile es_int32_t retiredCount_;
+
+	static boolean isHazard(void* p)
+	{
+		for (int i = 0; i < RC_HAZARD_SLOTS; i++) {
+			if (slots_[i].ptr == p) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static void reclaim()
+	{
+		Retired* list;
+		SCOPED_SLOCK2(&retired_) {
+			list = retired_;
+			retired_ = NULL;
+			eso_atomic_test_and_set32(&retiredCount_, 0);
+		}}
+		eso_atomic_synchronize();
+		Retired* keep = NULL;
+		Retired* last = NULL;
+		int kept = 0;
+		while (list) {
+			Retired* next = list->next;
+			if (isHazard(list->ptr)) {
+				if (!keep) last = list;
+				list->next = keep;
+				keep = list;
+				kept++;
+			} else {
+				list->deleter(list->ptr);
+				eso_free(list);
+			}
+			list = next;
+		}
+		if (keep) {
+			SCOPED_SLOCK2(&retired_) {
+				last->next = retired_;
+				retired_ = keep;
+				eso_atomic_add_and_fetch32(&retiredCount_, kept);
+			}}
+		}
+	}
+};
+
+template< int I > typename ERCHazardPool< I >::Slot ERCHazardPool< I >::slots_[RC_HAZARD_SLOTS];
+template< int I > typename ERCHazardPool< I >::Retired* ERCHazardPool< I >::retired_ = NULL;
+template< int I > volatile es_int32_t ERCHazardPool< I >::retiredCount_ = 0;
+
+template<typename T>
+inline void __DESTROYRC(void* p)
+{
+	((T*)p)->~T();
+	eso_free(p);
+}
+
 template<typename T>
 inline T* GETRC(T* volatile& p0)
 {
-	SYNCBLOCK(gRCLock) {
-		T* p = p0;
+	typename ERCHazardPool<0>::Slot* s = ERCHazardPool<0>::acquire();
+	T* p;
+	for (;;) {
+		p = ERCHazardPool<0>::protect(s, p0);
 		if (!p) {
-			return NULL;
+			break;
+		}
+		volatile es_int32_t* refs = (volatile es_int32_t*)((char*)p + sizeof(T));
+		es_int32_t n = *refs;
+		// a negative count means the last reference is gone, so p0 has moved on.
+		while (n >= 0 && !eso_atomic_compare_and_swap32(refs, n, n + 1)) {
+			n = *refs;
 		}
-		int* refs = (int*)((char*)p + sizeof(T));
-		(*refs)++;
-		return p;
-    }}
+		if (n >= 0) {
+			break;
+		}
+	}
+	ERCHazardPool<0>::release(s);
+	return p;
 }
 
 //placement delete class with reference count
 template<typename T>
 inline void DELRC(T* volatile& p0)
 {
-	T* p;
-	int n;
-	SYNCBLOCK(gRCLock) {
-		p = p0;
-		if (!p) {
-			return;
-		}
-		int* refs = (int*)((char*)p + sizeof(T));
-		n = (*refs)--;
-    }}
-	if (n == 0) {
-		p->~T();
-		eso_free(p);
+	T* p = p0;
+	if (!p) {
+		return;
+	}
+	volatile es_int32_t* refs = (volatile es_int32_t*)((char*)p + sizeof(T));
+	if (eso_atomic_sub_and_fetch32(refs, 1) < 0) {
+		ERCHazardPool<0>::retire(p, &__DESTROYRC<T>);
 	}
 }
 
+/**
+ * Borrows the NEWRC object in p0 for the current scope without touching
+ * its reference count, so short reads don't write to the shared object.
+ * Don't keep the pointer beyond the guard; take a GETRC for that.
+ */
+template<typename T>
+class ERCGuard
+{
+public:
+	explicit ERCGuard(T* volatile& p0) : slot_(ERCHazardPool<0>::acquire())
+	{
+		p_ = ERCHazardPool<0>::protect(slot_, p0);
+	}
+
+	~ERCGuard()
+	{
+		ERCHazardPool<0>::release(slot_);
+	}
+
+	T* get() const { return p_; }
+	T* operator->() const { return p_; }
+	T& operator*() const { return *p_; }
+
+private:
+	typename ERCHazardPool<0>::Slot* slot_;
+	T* p_;
+
+	ERCGuard(const ERCGuard&);
+	ERCGuard& operator=(const ERCGuard&);
+};
+
 } // namespace efc
 
 //=============================================================================
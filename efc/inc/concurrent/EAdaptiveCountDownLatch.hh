@@ -0,0 +1,62 @@
+/*
+ * EAdaptiveCountDownLatch.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EADAPTIVECOUNTDOWNLATCH_HH_
+#define EADAPTIVECOUNTDOWNLATCH_HH_
+
+#include "./ECountDownLatch.hh"
+#include "./ESpinControl.hh"
+
+namespace efc {
+
+/**
+ * An {@link ECountDownLatch} whose {@link #await} methods watch the
+ * count for a while, as directed by an {@link ESpinControl} policy,
+ * before they enqueue and park.  This pays off when the last
+ * {@code countDown} is known to come within microseconds, such as in
+ * short fork/join style hand-offs.
+ *
+ * <p>The await methods hide, rather than override, those of
+ * {@link ECountDownLatch}; call them through this class.
+ */
+
+class EAdaptiveCountDownLatch: public ECountDownLatch {
+public:
+	virtual ~EAdaptiveCountDownLatch();
+
+	/**
+	 * Constructs an {@code EAdaptiveCountDownLatch} initialized with the
+	 * given count and spin policy.
+	 *
+	 * @param count the number of times {@link #countDown} must be invoked
+	 *        before threads can pass through {@link #await}
+	 * @param policy the spin policy used before parking
+	 * @param maxSpins upper bound of spin iterations per await
+	 * @throws IllegalArgumentException if {@code count} is negative
+	 */
+	EAdaptiveCountDownLatch(int count,
+			ESpinControl::Policy policy=ESpinControl::ADAPTIVE,
+			int maxSpins=ESpinControl::DEFAULT_MAX_SPINS);
+
+	void await() THROWS(EInterruptedException);
+	boolean await(llong timeout, ETimeUnit* unit) THROWS(EInterruptedException);
+
+	/**
+	 * Returns the spin statistics of this latch.
+	 */
+	ESpinControl* getSpinControl();
+
+	virtual EStringBase toString();
+
+private:
+	ESpinControl spin;
+
+	boolean spinAwait();
+};
+
+} /* namespace efc */
+#endif /* EADAPTIVECOUNTDOWNLATCH_HH_ */
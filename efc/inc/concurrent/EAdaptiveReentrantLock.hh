@@ -0,0 +1,77 @@
+/*
+ * EAdaptiveReentrantLock.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EADAPTIVEREENTRANTLOCK_HH_
+#define EADAPTIVEREENTRANTLOCK_HH_
+
+#include "./EReentrantLock.hh"
+#include "./ESpinControl.hh"
+
+namespace efc {
+
+/**
+ * An {@link EReentrantLock} that spins for a while before it parks.
+ *
+ * <p>A lock that is held for a few hundred nanoseconds is usually
+ * released long before a parked thread would even be rescheduled, so
+ * going straight to {@code futex} costs two context switches for
+ * nothing.  When {@link #lock} misses, this lock retries according to
+ * its {@link ESpinControl} policy and only then enqueues and parks
+ * like its base class.  With the {@code ADAPTIVE} policy the spin
+ * budget follows recent successful spins and the sampled average hold
+ * time of this lock (time spent in {@link ECondition#await} does not
+ * count as holding).
+ *
+ * <p>A fair lock only spins while no thread is queued, so fairness is
+ * preserved.  Conditions must be created with {@link #newCondition}
+ * of this lock.
+ */
+
+class EAdaptiveReentrantLock: public EReentrantLock {
+public:
+	virtual ~EAdaptiveReentrantLock();
+
+	/**
+	 * Creates an instance of {@code EAdaptiveReentrantLock}.
+	 *
+	 * @param fair {@code true} if this lock should use a fair ordering policy
+	 * @param policy the spin policy used before parking
+	 * @param maxSpins upper bound of spin iterations per acquire
+	 */
+	EAdaptiveReentrantLock(boolean fair=false,
+			ESpinControl::Policy policy=ESpinControl::ADAPTIVE,
+			int maxSpins=ESpinControl::DEFAULT_MAX_SPINS);
+
+	virtual void lock();
+	virtual void lockInterruptibly() THROWS(EInterruptedException);
+	virtual boolean tryLock();
+	virtual boolean tryLock(llong timeout, ETimeUnit* unit) THROWS(EInterruptedException);
+	virtual void unlock();
+	virtual ECondition* newCondition();
+
+	boolean hasWaiters(ECondition* condition);
+	int getWaitQueueLength(ECondition* condition);
+
+	/**
+	 * Returns the spin statistics of this lock.
+	 */
+	ESpinControl* getSpinControl();
+
+	virtual EStringBase toString();
+
+private:
+	class Condition;
+	friend class Condition;
+
+	boolean fair;
+	ESpinControl spin;
+
+	boolean spinAcquire();
+};
+
+} /* namespace efc */
+#endif /* EADAPTIVEREENTRANTLOCK_HH_ */
@@ -0,0 +1,64 @@
+/*
+ * EAdaptiveSemaphore.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EADAPTIVESEMAPHORE_HH_
+#define EADAPTIVESEMAPHORE_HH_
+
+#include "./ESemaphore.hh"
+#include "./ESpinControl.hh"
+
+namespace efc {
+
+/**
+ * An {@link ESemaphore} whose blocking acquires spin for a while, as
+ * directed by an {@link ESpinControl} policy, before they enqueue and
+ * park.  A fair semaphore only spins while no thread is queued.
+ *
+ * <p>The acquire methods hide, rather than override, those of
+ * {@link ESemaphore}; call them through this class.
+ */
+
+class EAdaptiveSemaphore: public ESemaphore {
+public:
+	virtual ~EAdaptiveSemaphore();
+
+	/**
+	 * Creates an {@code EAdaptiveSemaphore} with the given number of
+	 * permits, fairness setting and spin policy.
+	 *
+	 * @param permits the initial number of permits available.
+	 * @param fair {@code true} if this semaphore will guarantee
+	 *        first-in first-out granting of permits under contention,
+	 *        else {@code false}
+	 * @param policy the spin policy used before parking
+	 * @param maxSpins upper bound of spin iterations per acquire
+	 */
+	EAdaptiveSemaphore(int permits, boolean fair=false,
+			ESpinControl::Policy policy=ESpinControl::ADAPTIVE,
+			int maxSpins=ESpinControl::DEFAULT_MAX_SPINS);
+
+	void acquire() THROWS(EInterruptedException);
+	void acquire(int permits) THROWS(EInterruptedException);
+	void acquireUninterruptibly();
+	void acquireUninterruptibly(int permits);
+
+	/**
+	 * Returns the spin statistics of this semaphore.
+	 */
+	ESpinControl* getSpinControl();
+
+	virtual EStringBase toString();
+
+private:
+	boolean fair;
+	ESpinControl spin;
+
+	boolean spinAcquire(int permits);
+};
+
+} /* namespace efc */
+#endif /* EADAPTIVESEMAPHORE_HH_ */
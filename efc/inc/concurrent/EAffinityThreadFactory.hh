@@ -0,0 +1,84 @@
+/*
+ * EAffinityThreadFactory.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EAFFINITYTHREADFACTORY_HH_
+#define EAFFINITYTHREADFACTORY_HH_
+
+#include "../EA.hh"
+#include "./EThreadFactory.hh"
+
+namespace efc {
+
+/**
+ * A {@link EThreadFactory} that pins each thread it creates to one
+ * processor, assigning the given processors round-robin.  Thread
+ * creation itself is delegated to another factory, by default
+ * {@link EExecutors#defaultThreadFactory}.
+ *
+ * <p>A pool whose workers stay on their cores keeps their caches
+ * warm; combined with an {@link EWorkerLocalQueue} the work a worker
+ * submits for itself also runs on the same core.  Pinning is done by
+ * the new thread as the first step of its run, on Linux and Windows;
+ * elsewhere threads are created unpinned.
+ *
+ * <pre> {@code
+ * new EThreadPoolExecutor(n, n, 0, ETimeUnit::MILLISECONDS,
+ *         new ELinkedBlockingQueue<ERunnable>(),
+ *         new EAffinityThreadFactory());
+ * }</pre>
+ */
+
+class EAffinityThreadFactory: public EThreadFactory {
+public:
+	virtual ~EAffinityThreadFactory();
+
+	/**
+	 * Creates a factory that uses all available processors.
+	 */
+	EAffinityThreadFactory();
+
+	/**
+	 * Creates a factory that uses all available processors and lets
+	 * {@code factory} create the threads.
+	 *
+	 * @throws NullPointerException if {@code factory} is null
+	 */
+	EAffinityThreadFactory(sp<EThreadFactory> factory);
+
+	/**
+	 * Creates a factory that uses the given processors, in order, and
+	 * lets {@code factory} create the threads.
+	 *
+	 * @param factory the factory creating the threads
+	 * @param cpus the processor numbers to assign
+	 * @throws NullPointerException if an argument is null
+	 * @throws IllegalArgumentException if {@code cpus} is empty
+	 */
+	EAffinityThreadFactory(sp<EThreadFactory> factory, EA<int>* cpus);
+
+	/**
+	 * Creates a thread that pins itself to the next processor before
+	 * running {@code r}.
+	 */
+	virtual EThread* newThread(sp<ERunnable> r);
+
+	/**
+	 * Pins the calling thread to the given processor.
+	 *
+	 * @return {@code true} if the platform supports pinning and the
+	 *         processor was accepted
+	 */
+	static boolean pinCurrentThread(int cpu);
+
+private:
+	sp<EThreadFactory> factory;
+	EA<int> cpus;
+	volatile int next;
+};
+
+} /* namespace efc */
+#endif /* EAFFINITYTHREADFACTORY_HH_ */
@@ -0,0 +1,665 @@
+/*
+ * EArrayBlockingQueue.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EARRAYBLOCKINGQUEUE_HH_
+#define EARRAYBLOCKINGQUEUE_HH_
+
+#include "../EInteger.hh"
+#include "../ETimeUnit.hh"
+#include "./EBlockingQueue.hh"
+#include "./EReentrantLock.hh"
+#include "./EAbstractConcurrentQueue.hh"
+#include "../EInterruptedException.hh"
+#include "../ENullPointerException.hh"
+#include "../EIllegalArgumentException.hh"
+#include "../ENoSuchElementException.hh"
+
+namespace efc {
+
+//@see: openjdk-8/src/share/classes/java/util/concurrent/ArrayBlockingQueue.java
+
+/**
+ * A bounded {@linkplain BlockingQueue blocking queue} backed by an
+ * array.  This queue orders elements FIFO (first-in-first-out).  The
+ * <em>head</em> of the queue is that element that has been on the
+ * queue the longest time.  The <em>tail</em> of the queue is that
+ * element that has been on the queue the shortest time. New elements
+ * are inserted at the tail of the queue, and the queue retrieval
+ * operations obtain elements at the head of the queue.
+ *
+ * <p>This is a classic &quot;bounded buffer&quot;, in which a
+ * fixed-sized array holds elements inserted by producers and
+ * extracted by consumers.  Once created, the capacity cannot be
+ * changed.  Attempts to {@code put} an element into a full queue
+ * will result in the operation blocking; attempts to {@code take} an
+ * element from an empty queue will similarly block.
+ *
+ * <p>Unlike {@link ELinkedBlockingQueue}, no node is allocated on
+ * insertion: the element is stored straight into its array slot.
+ *
+ * <p>This class supports an optional fairness policy for ordering
+ * waiting producer and consumer threads.  By default, this ordering
+ * is not guaranteed. However, a queue constructed with fairness set
+ * to {@code true} grants threads access in FIFO order. Fairness
+ * generally decreases throughput but reduces variability and avoids
+ * starvation.
+ *
+ * <p>The iterator of this class works on a snapshot of the queue
+ * taken when it was created; {@code Iterator.remove} removes the
+ * returned element from the live queue if it is still present.
+ *
+ * @since 1.5
+ * @param <E> the type of elements held in this collection
+ */
+
+template<typename E>
+class EArrayBlockingQueue: virtual public EAbstractConcurrentQueue<E>,
+		virtual public EBlockingQueue<E>, public EBatchOfferQueue<E> {
+public:
+	virtual ~EArrayBlockingQueue() {
+		delete[] items;
+		delete notEmpty;
+		delete notFull;
+	}
+
+	/**
+	 * Creates an {@code ArrayBlockingQueue} with the given (fixed)
+	 * capacity and default access policy.
+	 *
+	 * @param capacity the capacity of this queue
+	 * @throws IllegalArgumentException if {@code capacity < 1}
+	 */
+	EArrayBlockingQueue(int capacity) : lock(false) {
+		init(capacity);
+	}
+
+	/**
+	 * Creates an {@code ArrayBlockingQueue} with the given (fixed)
+	 * capacity and the specified access policy.
+	 *
+	 * @param capacity the capacity of this queue
+	 * @param fair if {@code true} then queue accesses for threads blocked
+	 *        on insertion or removal, are processed in FIFO order;
+	 *        if {@code false} the access order is unspecified.
+	 * @throws IllegalArgumentException if {@code capacity < 1}
+	 */
+	EArrayBlockingQueue(int capacity, boolean fair) : lock(fair) {
+		init(capacity);
+	}
+
+	/**
+	 * Inserts the specified element at the tail of this queue if it is
+	 * possible to do so immediately without exceeding the queue's capacity,
+	 * returning {@code true} upon success and {@code false} if this queue
+	 * is full.  This method is generally preferable to method {@link #add},
+	 * which can fail to insert an element only by throwing an exception.
+	 *
+	 * @throws NullPointerException if the specified element is null
+	 */
+	virtual boolean offer(E* e) {
+		sp<E> x(e);
+		boolean r = offer(x);
+		if (!r) {
+			x.dismiss();
+		}
+		return r;
+	}
+	virtual boolean offer(sp<E> e) {
+		if (e == null) throw ENullPointerException(__FILE__, __LINE__);
+		boolean r = false;
+		SYNCBLOCK(&lock) {
+			if (count != capacity_) {
+				enqueue(e);
+				r = true;
+			}
+		}}
+		return r;
+	}
+
+	/**
+	 * Inserts the run under a single acquisition of the lock.
+	 *
+	 * @throws NullPointerException {@inheritDoc}
+	 */
+	virtual int offerAll(EList<sp<E> >* c, int offset) {
+		if (c == null) throw ENullPointerException(__FILE__, __LINE__);
+		int n = 0;
+		sp<EListIterator<sp<E> > > it = c->listIterator(offset);
+		SYNCBLOCK(&lock) {
+			while (count != capacity_ && it->hasNext()) {
+				sp<E> e = it->next();
+				if (e == null) throw ENullPointerException(__FILE__, __LINE__);
+				enqueue(e);
+				n++;
+			}
+		}}
+		return n;
+	}
+
+	/**
+	 * Inserts the specified element at the tail of this queue, waiting
+	 * for space to become available if the queue is full.
+	 *
+	 * @throws InterruptedException {@inheritDoc}
+	 * @throws NullPointerException {@inheritDoc}
+	 */
+	virtual void put(E* e) THROWS(EInterruptedException) {
+		sp<E> x(e);
+		put(x);
+	}
+	virtual void put(sp<E> e) THROWS(EInterruptedException) {
+		if (e == null) throw ENullPointerException(__FILE__, __LINE__);
+		lock.lockInterruptibly();
+		try {
+			while (count == capacity_)
+				notFull->await();
+			enqueue(e);
+		} catch (...) {
+			lock.unlock();
+			throw; //!
+		} finally {
+			lock.unlock();
+		}
+	}
+
+	/**
+	 * Inserts the specified element at the tail of this queue, waiting
+	 * up to the specified wait time for space to become available if
+	 * the queue is full.
+	 *
+	 * @throws InterruptedException {@inheritDoc}
+	 * @throws NullPointerException {@inheritDoc}
+	 */
+	virtual boolean offer(E* e, llong timeout, ETimeUnit* unit)
+			THROWS(EInterruptedException) {
+		sp<E> x(e);
+		boolean r = offer(x, timeout, unit);
+		if (!r) {
+			x.dismiss();
+		}
+		return r;
+	}
+	virtual boolean offer(sp<E> e, llong timeout, ETimeUnit* unit)
+			THROWS(EInterruptedException) {
+		if (e == null) throw ENullPointerException(__FILE__, __LINE__);
+		llong nanos = unit->toNanos(timeout);
+		boolean r = true;
+		lock.lockInterruptibly();
+		try {
+			while (count == capacity_) {
+				if (nanos <= 0) {
+					r = false;
+					goto FINALLY;
+				}
+				nanos = notFull->awaitNanos(nanos);
+			}
+			enqueue(e);
+		} catch (...) {
+			lock.unlock();
+			throw; //!
+		}
+		FINALLY:
+		finally {
+			lock.unlock();
+		}
+		return r;
+	}
+
+	virtual sp<E> poll() {
+		sp<E> x;
+		SYNCBLOCK(&lock) {
+			if (count != 0)
+				x = dequeue();
+		}}
+		return x;
+	}
+
+	virtual sp<E> take() THROWS(EInterruptedException) {
+		sp<E> x;
+		lock.lockInterruptibly();
+		try {
+			while (count == 0)
+				notEmpty->await();
+			x = dequeue();
+		} catch (...) {
+			lock.unlock();
+			throw; //!
+		} finally {
+			lock.unlock();
+		}
+		return x;
+	}
+
+	virtual sp<E> poll(llong timeout, ETimeUnit* unit) THROWS(EInterruptedException) {
+		sp<E> x;
+		llong nanos = unit->toNanos(timeout);
+		lock.lockInterruptibly();
+		try {
+			while (count == 0) {
+				if (nanos <= 0)
+					goto FINALLY;
+				nanos = notEmpty->awaitNanos(nanos);
+			}
+			x = dequeue();
+		} catch (...) {
+			lock.unlock();
+			throw; //!
+		}
+		FINALLY:
+		finally {
+			lock.unlock();
+		}
+		return x;
+	}
+
+	virtual sp<E> peek() {
+		sp<E> x;
+		SYNCBLOCK(&lock) {
+			x = items[takeIndex]; // null when queue is empty
+		}}
+		return x;
+	}
+
+	// this doc comment is overridden to remove the reference to collections
+	// greater in size than Integer.MAX_VALUE
+	/**
+	 * Returns the number of elements in this queue.
+	 *
+	 * @return the number of elements in this queue
+	 */
+	virtual int size() {
+		int n;
+		SYNCBLOCK(&lock) {
+			n = count;
+		}}
+		return n;
+	}
+
+	// this doc comment is a modified copy of the inherited doc comment,
+	// without the reference to unlimited queues.
+	/**
+	 * Returns the number of additional elements that this queue can ideally
+	 * (in the absence of memory or resource constraints) accept without
+	 * blocking. This is always equal to the initial capacity of this queue
+	 * less the current {@code size} of this queue.
+	 *
+	 * <p>Note that you <em>cannot</em> always tell if an attempt to insert
+	 * an element will succeed by inspecting {@code remainingCapacity}
+	 * because it may be the case that another thread is about to
+	 * insert or remove an element.
+	 */
+	virtual int remainingCapacity() {
+		int n;
+		SYNCBLOCK(&lock) {
+			n = capacity_ - count;
+		}}
+		return n;
+	}
+
+	virtual int capacity() {
+		return capacity_;
+	}
+
+	/**
+	 * Removes a single instance of the specified element from this queue,
+	 * if it is present.  More formally, removes an element {@code e} such
+	 * that {@code o.equals(e)}, if this queue contains one or more such
+	 * elements.
+	 * Returns {@code true} if this queue contained the specified element
+	 * (or equivalently, if this queue changed as a result of the call).
+	 *
+	 * <p>Removal of interior elements in circular array based queues
+	 * is an intrinsically slow and disruptive operation, so should
+	 * be undertaken only in exceptional circumstances, ideally
+	 * only when the queue is known not to be accessible by other
+	 * threads.
+	 *
+	 * @param o element to be removed from this queue, if present
+	 * @return {@code true} if this queue changed as a result of the call
+	 */
+	virtual boolean remove(E* o) {
+		if (o == null) return false;
+		boolean removed = false;
+		SYNCBLOCK(&lock) {
+			if (count > 0) {
+				int i = takeIndex;
+				do {
+					if (o->equals(items[i].get())) {
+						removeAt(i);
+						removed = true;
+						break;
+					}
+					if (++i == capacity_)
+						i = 0;
+				} while (i != putIndex);
+			}
+		}}
+		return removed;
+	}
+
+	/**
+	 * Returns {@code true} if this queue contains the specified element.
+	 * More formally, returns {@code true} if and only if this queue contains
+	 * at least one element {@code e} such that {@code o.equals(e)}.
+	 *
+	 * @param o object to be checked for containment in this queue
+	 * @return {@code true} if this queue contains the specified element
+	 */
+	virtual boolean contains(E* o) {
+		if (o == null) return false;
+		boolean r = false;
+		SYNCBLOCK(&lock) {
+			if (count > 0) {
+				int i = takeIndex;
+				do {
+					if (o->equals(items[i].get())) {
+						r = true;
+						break;
+					}
+					if (++i == capacity_)
+						i = 0;
+				} while (i != putIndex);
+			}
+		}}
+		return r;
+	}
+
+	/**
+	 * Returns an array containing all of the elements in this queue, in
+	 * proper sequence.
+	 *
+	 * @return an array containing all of the elements in this queue
+	 */
+	virtual EA<sp<E> > toArray() {
+		lock.lock();
+		EA<sp<E> > a(count);
+		try {
+			for (int k = 0, i = takeIndex; k < count; k++) {
+				a[k] = items[i];
+				if (++i == capacity_)
+					i = 0;
+			}
+		} catch (...) {
+			lock.unlock();
+			throw; //!
+		} finally {
+			lock.unlock();
+		}
+		return a;
+	}
+
+	/**
+	 * Atomically removes all of the elements from this queue.
+	 * The queue will be empty after this call returns.
+	 */
+	virtual void clear() {
+		SYNCBLOCK(&lock) {
+			int k = count;
+			if (k > 0) {
+				int i = takeIndex;
+				do {
+					items[i] = null;
+					if (++i == capacity_)
+						i = 0;
+				} while (i != putIndex);
+				takeIndex = putIndex;
+				count = 0;
+				notFull->signalAll();
+			}
+		}}
+	}
+
+	/**
+	 * @throws UnsupportedOperationException {@inheritDoc}
+	 * @throws ClassCastException            {@inheritDoc}
+	 * @throws NullPointerException          {@inheritDoc}
+	 * @throws IllegalArgumentException      {@inheritDoc}
+	 */
+	virtual int drainTo(EConcurrentCollection<E>* c) {
+		return drainTo(c, EInteger::MAX_VALUE);
+	}
+	virtual int drainTo(ECollection<sp<E> >* c) {
+		return drainTo(c, EInteger::MAX_VALUE);
+	}
+
+	/**
+	 * @throws UnsupportedOperationException {@inheritDoc}
+	 * @throws ClassCastException            {@inheritDoc}
+	 * @throws NullPointerException          {@inheritDoc}
+	 * @throws IllegalArgumentException      {@inheritDoc}
+	 */
+	virtual int drainTo(EConcurrentCollection<E>* c, int maxElements) {
+		if (c == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		if (c == dynamic_cast<EConcurrentCollection<E>*>(this))
+			throw EIllegalArgumentException(__FILE__, __LINE__);
+		return drainTo0(c, maxElements);
+	}
+	virtual int drainTo(ECollection<sp<E> >* c, int maxElements) {
+		if (c == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		return drainTo0(c, maxElements);
+	}
+
+	virtual boolean add(E* e) {
+		return EAbstractConcurrentQueue<E>::add(e);
+	}
+	virtual boolean add(sp<E> e) {
+		return EAbstractConcurrentQueue<E>::add(e);
+	}
+
+	virtual sp<E> remove() {
+		return EAbstractConcurrentQueue<E>::remove();
+	}
+
+	virtual sp<E> element() {
+		return EAbstractConcurrentQueue<E>::element();
+	}
+
+	virtual boolean isEmpty() {
+		return size() == 0;
+	}
+
+	/**
+	 * Returns an iterator over the elements in this queue in proper sequence.
+	 * The elements will be returned in order from first (head) to last (tail).
+	 *
+	 * <p>The returned iterator traverses a snapshot of the queue taken
+	 * at the time it was created.
+	 *
+	 * @return an iterator over the elements in this queue in proper sequence
+	 */
+	virtual sp<EConcurrentIterator<E> > iterator() {
+		return new Itr(this);
+	}
+
+private:
+	/** The queued items */
+	sp<E>* items;
+
+	/** The capacity bound */
+	int capacity_;
+
+	/** items index for next take, poll, peek or remove */
+	int takeIndex;
+
+	/** items index for next put, offer, or add */
+	int putIndex;
+
+	/** Number of elements in the queue */
+	int count;
+
+	/*
+	 * Concurrency control uses the classic two-condition algorithm
+	 * found in any textbook.
+	 */
+
+	/** Main lock guarding all access */
+	EReentrantLock lock;
+
+	/** Condition for waiting takes */
+	ECondition* notEmpty;
+
+	/** Condition for waiting puts */
+	ECondition* notFull;
+
+	void init(int capacity) {
+		if (capacity <= 0)
+			throw EIllegalArgumentException(__FILE__, __LINE__);
+		capacity_ = capacity;
+		items = new sp<E>[capacity];
+		takeIndex = putIndex = count = 0;
+		notEmpty = lock.newCondition();
+		notFull = lock.newCondition();
+	}
+
+	/**
+	 * Inserts element at current put position, advances, and signals.
+	 * Call only when holding lock.
+	 */
+	void enqueue(sp<E>& x) {
+		// assert lock.getHoldCount() == 1;
+		// assert items[putIndex] == null;
+		items[putIndex] = x;
+		if (++putIndex == capacity_)
+			putIndex = 0;
+		count++;
+		notEmpty->signal();
+	}
+
+	/**
+	 * Extracts element at current take position, advances, and signals.
+	 * Call only when holding lock.
+	 */
+	sp<E> dequeue() {
+		// assert lock.getHoldCount() == 1;
+		// assert items[takeIndex] != null;
+		sp<E> x = items[takeIndex];
+		items[takeIndex] = null;
+		if (++takeIndex == capacity_)
+			takeIndex = 0;
+		count--;
+		notFull->signal();
+		return x;
+	}
+
+	/**
+	 * Deletes item at array index removeIndex.
+	 * Utility for remove(Object) and iterator.remove.
+	 * Call only when holding lock.
+	 */
+	void removeAt(int removeIndex) {
+		// assert lock.getHoldCount() == 1;
+		// assert items[removeIndex] != null;
+		// assert removeIndex >= 0 && removeIndex < items.length;
+		if (removeIndex == takeIndex) {
+			// removing front item; just advance
+			items[takeIndex] = null;
+			if (++takeIndex == capacity_)
+				takeIndex = 0;
+			count--;
+		} else {
+			// an "interior" remove
+
+			// slide over all others up through putIndex.
+			for (int i = removeIndex;;) {
+				int next = i + 1;
+				if (next == capacity_)
+					next = 0;
+				if (next != putIndex) {
+					items[i] = items[next];
+					i = next;
+				} else {
+					items[i] = null;
+					putIndex = i;
+					break;
+				}
+			}
+			count--;
+		}
+		notFull->signal();
+	}
+
+	template<typename C>
+	int drainTo0(C* c, int maxElements) {
+		int n = 0;
+		SYNCBLOCK(&lock) {
+			n = ES_MIN(maxElements, count);
+			int take = takeIndex;
+			int i = 0;
+			try {
+				while (i < n) {
+					c->add(items[take]);
+					items[take] = null;
+					if (++take == capacity_)
+						take = 0;
+					i++;
+				}
+			} catch (...) {
+				// Restore invariants even if c.add() threw
+				n = i;
+				count -= i;
+				takeIndex = take;
+				if (i > 0)
+					notFull->signalAll();
+				throw; //!
+			}
+			if (i > 0) {
+				count -= i;
+				takeIndex = take;
+				notFull->signalAll();
+			}
+		}}
+		return n;
+	}
+
+	class Itr : public EConcurrentIterator<E> {
+	private:
+		EArrayBlockingQueue<E>* self;
+		EA<sp<E> > snapshot;
+		int cursor;
+		sp<E> lastRet;
+
+	public:
+		Itr(EArrayBlockingQueue<E>* s) : self(s), snapshot(s->toArray()), cursor(0) {
+		}
+
+		boolean hasNext() {
+			return cursor < snapshot.length();
+		}
+
+		sp<E> next() {
+			if (cursor >= snapshot.length())
+				throw ENoSuchElementException(__FILE__, __LINE__);
+			lastRet = snapshot[cursor++];
+			return lastRet;
+		}
+
+		void remove() {
+			if (lastRet == null)
+				throw EIllegalStateException(__FILE__, __LINE__);
+			sp<E> x = lastRet;
+			lastRet = null;
+			SYNCBLOCK(&self->lock) {
+				if (self->count > 0) {
+					int i = self->takeIndex;
+					do {
+						if (self->items[i] == x) {
+							self->removeAt(i);
+							break;
+						}
+						if (++i == self->capacity_)
+							i = 0;
+					} while (i != self->putIndex);
+				}
+			}}
+		}
+	};
+};
+
+} /* namespace efc */
+#endif /* EARRAYBLOCKINGQUEUE_HH_ */
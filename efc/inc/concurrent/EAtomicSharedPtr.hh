@@ -0,0 +1,307 @@
+/*
+ * EAtomicSharedPtr.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EATOMICSHAREDPTR_HH_
+#define EATOMICSHAREDPTR_HH_
+
+#include "../EString.hh"
+#include "../ESharedPtr.hh"
+
+namespace efc {
+
+/**
+ * A {@code sp<T>} that may be read and replaced atomically without
+ * locks.
+ *
+ * <p>The {@code atomic_load/atomic_store/atomic_exchange/
+ * atomic_compare_exchange} functions of {@code sp<T>} hash the
+ * pointer's address into {@code ESpinLockPool<0>}, so every load
+ * takes a spin lock that unrelated pointers may share.  This class
+ * instead publishes an immutable holder of the current {@code sp<T>}
+ * through one pointer-sized word: writers swap the word with a single
+ * atomic instruction, and readers protect the holder with a hazard
+ * slot (see {@code ERCHazardPool}) while they copy the value out.
+ * A reader therefore writes only its own hazard slot and the
+ * reference count of the object it returns; readers never wait for
+ * each other or for writers.  A replaced holder is freed once no
+ * reader publishes it.
+ *
+ * <p>{@link #load} must still bump the shared reference count, which
+ * is a contended write when many threads read the same value.
+ * {@link #read} and {@link Guard} use the object under the hazard
+ * slot alone and leave the count untouched.
+ *
+ * <p>The same free functions are overloaded for this type, so code
+ * switches from a plain {@code sp<T>} by changing the declaration:
+ *
+ * <pre> {@code
+ * EAtomicSharedPtr<RouteTable> routes;
+ *
+ * // publisher
+ * atomic_store(&routes, sp<RouteTable>(newTable));
+ *
+ * // readers
+ * sp<RouteTable> snapshot = atomic_load(&routes);
+ *
+ * // hot readers
+ * EAtomicSharedPtr<RouteTable>::Guard g(&routes);
+ * lookup(g.get(), addr);
+ * }</pre>
+ *
+ * @param <T> the type of object referred to by the pointer
+ */
+
+template<typename T>
+class EAtomicSharedPtr: public EObject {
+public:
+	/**
+	 * Keeps the current value alive for its own lifetime, without
+	 * taking a reference.  A guard occupies one of the
+	 * {@code RC_HAZARD_SLOTS} hazard slots, so keep it on the stack
+	 * and short-lived; the pointer must not escape it.
+	 */
+	class Guard {
+	public:
+		explicit Guard(const EAtomicSharedPtr<T>* p) :
+				s(ERCHazardPool<1>::acquire()),
+				h(ERCHazardPool<1>::protect(s, p->holder_)) {
+		}
+		~Guard() {
+			ERCHazardPool<1>::release(s);
+		}
+		T* get() const {
+			return h ? h->value.get() : null;
+		}
+		T* operator->() const {
+			return get();
+		}
+		T& operator*() const {
+			return *get();
+		}
+	private:
+		typename ERCHazardPool<1>::Slot* s;
+		typename EAtomicSharedPtr<T>::Holder* h;
+
+		Guard(const Guard&);
+		Guard& operator=(const Guard&);
+	};
+
+	virtual ~EAtomicSharedPtr() {
+		delete holder_;
+	}
+
+	/**
+	 * Creates an empty pointer.
+	 */
+	EAtomicSharedPtr() : holder_(null) {
+	}
+
+	/**
+	 * Creates a pointer holding the given initial value.
+	 *
+	 * @param initialValue the initial value
+	 */
+	explicit EAtomicSharedPtr(sp<T> initialValue) : holder_(wrap(initialValue)) {
+	}
+
+	/**
+	 * Always {@code true}.
+	 */
+	boolean is_lock_free() const {
+		return true;
+	}
+
+	/**
+	 * Returns a copy of the current value.
+	 */
+	sp<T> load() const {
+		typename ERCHazardPool<1>::Slot* s = ERCHazardPool<1>::acquire();
+		Holder* h = ERCHazardPool<1>::protect(s, holder_);
+		sp<T> r;
+		if (h) {
+			r = h->value;
+		}
+		ERCHazardPool<1>::release(s);
+		return r;
+	}
+
+	/**
+	 * Calls {@code reader(T*)} with the current value, or with null if
+	 * empty, under a {@link Guard}.  The object stays alive until the
+	 * reader returns even if a concurrent store replaces it, but the
+	 * pointer is not counted: a reader that needs the object longer
+	 * must use {@link #load} instead of keeping the raw pointer.  The
+	 * reader holds one of the shared hazard slots, so it must not block
+	 * or nest further reads of this or other pointers.
+	 *
+	 * @param reader the function to call with the value
+	 */
+	template<typename F>
+	void read(F& reader) const {
+		Guard g(this);
+		reader(g.get());
+	}
+
+	/**
+	 * Sets to the given value.
+	 *
+	 * @param r the new value
+	 */
+	void store(sp<T> r) {
+		Holder* h = swap(wrap(r));
+		if (h) {
+			retire(h);
+		}
+	}
+
+	/**
+	 * Atomically sets to the given value and returns the old value.
+	 *
+	 * @param r the new value
+	 * @return the previous value
+	 */
+	sp<T> exchange(sp<T> r) {
+		Holder* h = swap(wrap(r));
+		sp<T> old;
+		if (h) {
+			old = h->value; // readers may still be copying it too
+			retire(h);
+		}
+		return old;
+	}
+
+	/**
+	 * Atomically sets the value to {@code w} if the current value is
+	 * equivalent to {@code *v} (same pointer and same ownership);
+	 * otherwise stores the current value into {@code *v}.
+	 *
+	 * @param v the expected value, updated on failure
+	 * @param w the new value
+	 * @return {@code true} if successful
+	 */
+	bool compare_exchange(sp<T>* v, sp<T> w) {
+		Holder* n = null;
+		boolean wrapped = false;
+		typename ERCHazardPool<1>::Slot* s = ERCHazardPool<1>::acquire();
+		for (;;) {
+			Holder* h = ERCHazardPool<1>::protect(s, holder_);
+			if (h ? h->value._internal_equiv(*v) : v->_internal_equiv(sp<T>())) {
+				if (!wrapped) {
+					n = wrap(w);
+					wrapped = true;
+				}
+				// h is protected, so it can't be recycled in between (no ABA)
+				if (eso_atomic_compare_and_swapptr((void * volatile *)&holder_, h, n)) {
+					ERCHazardPool<1>::release(s);
+					if (h) {
+						retire(h);
+					}
+					return true;
+				}
+				continue;
+			}
+			sp<T> tmp;
+			if (h) {
+				tmp = h->value;
+			}
+			ERCHazardPool<1>::release(s);
+			delete n;
+			tmp.swap(*v);
+			return false;
+		}
+	}
+
+	virtual EStringBase toString() {
+		sp<T> r = load();
+		return EStringBase::valueOf((llong)r.get());
+	}
+
+private:
+	friend class Guard;
+
+	struct Holder {
+		sp<T> value;
+		Holder(const sp<T>& v) : value(v) {
+		}
+	};
+
+	mutable Holder* volatile holder_;
+
+	EAtomicSharedPtr(const EAtomicSharedPtr&);
+	EAtomicSharedPtr& operator=(const EAtomicSharedPtr&);
+
+	static Holder* wrap(const sp<T>& r) {
+		return r._internal_equiv(sp<T>()) ? null : new Holder(r);
+	}
+
+	Holder* swap(Holder* n) {
+		return (Holder*)eso_atomic_test_and_setptr((volatile es_intptr_t*)&holder_, (es_intptr_t*)n);
+	}
+
+	static void destroy(void* p) {
+		delete (Holder*)p;
+	}
+
+	static void retire(Holder* h) {
+		ERCHazardPool<1>::retire(h, &destroy);
+	}
+};
+
+// atomic access, same as for sp<T>
+
+template<class T> inline bool atomic_is_lock_free( EAtomicSharedPtr<T> const * /*p*/ )
+{
+    return true;
+}
+
+template<class T> inline sp<T> atomic_load( EAtomicSharedPtr<T> const * p )
+{
+    return p->load();
+}
+
+template<class T> inline sp<T> atomic_load_explicit( EAtomicSharedPtr<T> const * p, memory_order /*mo*/ )
+{
+    return p->load();
+}
+
+template<class T> inline void atomic_store( EAtomicSharedPtr<T> * p, sp<T> r )
+{
+    p->store( r );
+}
+
+template<class T> inline void atomic_store( EAtomicSharedPtr<T> * p, detail::sp_nullptr_t )
+{
+    p->store( sp<T>() );
+}
+
+template<class T> inline void atomic_store_explicit( EAtomicSharedPtr<T> * p, sp<T> r, memory_order /*mo*/ )
+{
+    p->store( r );
+}
+
+template<class T> inline sp<T> atomic_exchange( EAtomicSharedPtr<T> * p, sp<T> r )
+{
+    return p->exchange( r );
+}
+
+template<class T> inline sp<T> atomic_exchange_explicit( EAtomicSharedPtr<T> * p, sp<T> r, memory_order /*mo*/ )
+{
+    return p->exchange( r );
+}
+
+template<class T> inline bool atomic_compare_exchange( EAtomicSharedPtr<T> * p, sp<T> * v, sp<T> w )
+{
+    return p->compare_exchange( v, w );
+}
+
+template<class T> inline bool atomic_compare_exchange_explicit( EAtomicSharedPtr<T> * p, sp<T> * v, sp<T> w, memory_order /*success*/, memory_order /*failure*/ )
+{
+    return p->compare_exchange( v, w );
+}
+
+} /* namespace efc */
+#endif /* EATOMICSHAREDPTR_HH_ */
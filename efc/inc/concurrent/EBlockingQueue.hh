@@ -9,8 +9,10 @@
 #define EBLOCKINGQUEUE_HH_
 
 #include "../ECollection.hh"
+#include "../EList.hh"
 #include "./EConcurrentQueue.hh"
 #include "../EInterruptedException.hh"
+#include "../ENullPointerException.hh"
 
 namespace efc {
 
@@ -154,6 +156,26 @@ namespace efc {
  * @param <E> the type of elements held in this collection
  */
 
+/**
+ * The batch insertion of a blocking queue, behind
+ * {@link EBlockingQueue#offerAll}.  It is a separate interface, found
+ * with <tt>dynamic_cast</tt>, because code built against the original
+ * <tt>EBlockingQueue</tt> vtable (the prebuilt efc library) must keep
+ * calling the right slots.
+ *
+ * @param <E> the type of elements held in the queue
+ */
+template<typename E>
+interface EBatchOfferQueue
+{
+	virtual ~EBatchOfferQueue(){}
+
+	/**
+	 * See {@link EBlockingQueue#offerAll}.
+	 */
+	virtual int offerAll(EList<sp<E> >* c, int offset) = 0;
+};
+
 template<typename E>
 interface EBlockingQueue : virtual public EConcurrentQueue<E>
 {
@@ -236,6 +258,36 @@ interface EBlockingQueue : virtual public EConcurrentQueue<E>
 	virtual boolean offer(E* e, llong timeout, ETimeUnit* unit) THROWS(EInterruptedException) = 0;
 	virtual boolean offer(sp<E> e, llong timeout, ETimeUnit* unit) THROWS(EInterruptedException) = 0;
 
+	/**
+	 * Inserts the elements of the given list, in list order and starting
+	 * at <tt>offset</tt>, for as long as this is possible immediately
+	 * without violating capacity restrictions; stops at the first element
+	 * that does not fit.  Queues that guard insertion with a lock
+	 * implement {@link EBatchOfferQueue} and take it once for the whole
+	 * run, so handing over a batch this way costs one synchronization
+	 * instead of one per element; other queues get one
+	 * <tt>offer</tt> per element.
+	 *
+	 * @param c the elements to insert
+	 * @param offset index in <tt>c</tt> of the first element to insert
+	 * @return the number of elements inserted
+	 * @throws NullPointerException if the list or an element to be
+	 *         inserted is null
+	 */
+	int offerAll(EList<sp<E> >* c, int offset) {
+		EBatchOfferQueue<E>* bq = dynamic_cast<EBatchOfferQueue<E>*>(this);
+		if (bq != null) {
+			return bq->offerAll(c, offset);
+		}
+		if (c == null) throw ENullPointerException(__FILE__, __LINE__);
+		int n = 0;
+		sp<EListIterator<sp<E> > > it = c->listIterator(offset);
+		while (it->hasNext() && offer(it->next())) {
+			n++;
+		}
+		return n;
+	}
+
 	/**
 	 * Retrieves and removes the head of this queue, waiting if necessary
 	 * until an element becomes available.
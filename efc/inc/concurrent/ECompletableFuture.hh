@@ -0,0 +1,1105 @@
+/*
+ * ECompletableFuture.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ECOMPLETABLEFUTURE_HH_
+#define ECOMPLETABLEFUTURE_HH_
+
+#include "./EFuture.hh"
+#include "./EExecutor.hh"
+#include "./ECompletionException.hh"
+#include "./ECancellationException.hh"
+#include "./EExecutionException.hh"
+#include "./ETimeoutException.hh"
+#include "../EInterruptedException.hh"
+#include "../ECollection.hh"
+#include "../ERunnable.hh"
+#include "../ESharedPtr.hh"
+#include "../EThrowable.hh"
+#include "../ETimeUnit.hh"
+#include "../ENullPointerException.hh"
+#include "../ERuntimeException.hh"
+
+namespace efc {
+
+//@see: openjdk-9/src/java.base/share/classes/java/util/concurrent/CompletableFuture.java
+
+template<typename T> class ECompletableFuture;
+class ECompletableFutureType;
+
+namespace cf {
+
+class AnyRelay;
+
+/**
+ * A dependent action pushed on a future, fired exactly once when
+ * that future completes.  A completion first captures the outcome of
+ * its source; it is then run either directly by the completing thread
+ * or, if it has an executor, as a task of that executor.
+ */
+abstract class Completion : public ERunnable {
+public:
+	virtual ~Completion() {
+	}
+
+	Completion(EExecutor* executor) : executor(executor) {
+	}
+
+	/**
+	 * Captures the outcome of the (completed) source. The source is
+	 * only guaranteed to be alive during this call.
+	 *
+	 * @return false if there is nothing left to run
+	 */
+	virtual boolean capture(ECompletableFutureType* src) = 0;
+
+	/**
+	 * Called instead of run() when the executor rejected this completion.
+	 */
+	virtual void reject(EThrowable& ex) = 0;
+
+protected:
+	friend class efc::ECompletableFutureType;
+
+	EExecutor* executor;   // null to run in the completing thread
+	sp<Completion> next;   // Treiber stack link, guarded by the owner
+};
+
+/**
+ * A timeout action scheduled by orTimeout or completeOnTimeout. Either
+ * the timer fires it or the future's completion cancels it, whichever
+ * claims it first; the loser does nothing.
+ */
+class Timeout : public ERunnable {
+public:
+	virtual ~Timeout();
+
+	Timeout(sp<ECompletableFutureType> f);
+
+	virtual void run();
+
+	/**
+	 * Disarms this timeout, drops its reference to the future and
+	 * takes it off the timer.
+	 */
+	void cancel();
+
+	/**
+	 * Schedules the given timeout to run after the given delay on the
+	 * shared daemon timer thread.
+	 */
+	static void delay(sp<Timeout> t, llong nanos);
+
+protected:
+	/**
+	 * Completes f on timeout; the default completes it with an
+	 * {@link ETimeoutException}.
+	 */
+	virtual void onTimeout(ECompletableFutureType* f);
+
+private:
+	friend class Delayer;
+
+	volatile int state;    // 0: armed, 1: fired, 2: cancelled
+	int heapIndex;         // in the timer heap, or -1; guarded by its lock
+	llong deadline;        // in ESystem::nanoTime(), set by delay
+	sp<ECompletableFutureType> f;
+};
+
+} /* namespace cf */
+
+/**
+ * The result-type independent part of {@link ECompletableFuture}:
+ * completion status, the stack of dependent actions, threads blocked
+ * in {@code get()}, and the static combinators {@link #allOf} and
+ * {@link #anyOf} that operate on futures of different result types.
+ */
+
+abstract class ECompletableFutureType : virtual public EObject,
+		public enable_shared_from_this<ECompletableFutureType> {
+public:
+	virtual ~ECompletableFutureType();
+
+	/**
+	 * Returns {@code true} if completed in any fashion: normally,
+	 * exceptionally, or via cancellation.
+	 *
+	 * @return {@code true} if completed
+	 */
+	boolean isDone();
+
+	/**
+	 * Returns {@code true} if this CompletableFuture was cancelled
+	 * before it completed normally.
+	 *
+	 * @return {@code true} if this CompletableFuture was cancelled
+	 * before it completed normally
+	 */
+	boolean isCancelled();
+
+	/**
+	 * Returns {@code true} if this CompletableFuture completed
+	 * exceptionally, in any way. Possible causes include
+	 * cancellation, explicit invocation of {@code
+	 * completeExceptionally}, and abrupt termination of a
+	 * CompletionStage action.
+	 *
+	 * @return {@code true} if this CompletableFuture completed
+	 * exceptionally
+	 */
+	boolean isCompletedExceptionally();
+
+	/**
+	 * If not already completed, causes invocations of {@link #get()}
+	 * and related methods to throw the given exception.
+	 *
+	 * @param ex the exception
+	 * @return {@code true} if this invocation caused this CompletableFuture
+	 * to transition to a completed state, else {@code false}
+	 */
+	boolean completeExceptionally(EThrowable& ex);
+
+	/**
+	 * If not already completed, completes this CompletableFuture with
+	 * a {@link ECancellationException}. Dependent CompletableFutures
+	 * that have not already completed will also complete
+	 * exceptionally, with that exception as cause.
+	 *
+	 * @param mayInterruptIfRunning this value has no effect in this
+	 * implementation because interrupts are not used to control
+	 * processing.
+	 *
+	 * @return {@code true} if this task is now cancelled
+	 */
+	boolean cancel(boolean mayInterruptIfRunning);
+
+	/**
+	 * Returns the exception this future completed with, or null if it
+	 * is not done or completed normally.
+	 */
+	sp<EThrowable> getException();
+
+	/**
+	 * Returns the estimated number of CompletableFutures whose
+	 * completions are awaiting completion of this CompletableFuture.
+	 * This method is designed for use in monitoring system state, not
+	 * for synchronization control.
+	 *
+	 * @return the number of dependent CompletableFutures
+	 */
+	int getNumberOfDependents();
+
+	/**
+	 * Returns a new CompletableFuture that is completed when all of
+	 * the given CompletableFutures complete.  If any of the given
+	 * CompletableFutures complete exceptionally, then the returned
+	 * CompletableFuture also does so, with the first such exception
+	 * observed as its cause.  Otherwise, the results, if any, of the
+	 * given CompletableFutures are not reflected in the returned
+	 * CompletableFuture, but may be obtained by inspecting them
+	 * individually. If no CompletableFutures are provided, returns a
+	 * CompletableFuture completed with the value {@code null}.
+	 *
+	 * <p>Waiting on the returned future holds no thread: each input
+	 * only decrements a shared counter as it completes.
+	 *
+	 * @param cfs the CompletableFutures
+	 * @return a new CompletableFuture that is completed when all of the
+	 * given CompletableFutures complete
+	 * @throws ENullPointerException if the collection or any of its
+	 * elements are {@code null}
+	 */
+	static sp<ECompletableFuture<EObject> > allOf(
+			ECollection<sp<ECompletableFutureType> >* cfs);
+
+	/**
+	 * Returns a new CompletableFuture that is completed when any of
+	 * the given CompletableFutures complete, with the same result.
+	 * Otherwise, if it completed exceptionally, the returned
+	 * CompletableFuture also does so, with the same exception as its
+	 * cause.  If no CompletableFutures are provided, returns an
+	 * incomplete CompletableFuture.
+	 *
+	 * @param cfs the CompletableFutures
+	 * @return a new CompletableFuture that is completed with the
+	 * result or exception of any of the given CompletableFutures when
+	 * one completes
+	 * @throws ENullPointerException if the collection or any of its
+	 * elements are {@code null}
+	 */
+	static sp<ECompletableFuture<EObject> > anyOf(
+			ECollection<sp<ECompletableFutureType> >* cfs);
+
+	/**
+	 * Returns the default Executor used for async methods that do not
+	 * specify an Executor: the {@link EForkJoinPool#commonPool()}.
+	 *
+	 * @return the executor
+	 */
+	static EExecutor* defaultExecutor();
+
+protected:
+	template<typename> friend class ECompletableFuture;
+	friend class cf::Timeout;
+	friend class cf::AnyRelay;
+
+	/*
+	 * Status values; a future leaves NEW exactly once, by the thread
+	 * that wins the CAS to COMPLETING. That thread then sets the
+	 * outcome and publishes one of the final states.
+	 */
+	static const int NEW         = 0;
+	static const int COMPLETING  = 1;
+	static const int NORMAL      = 2;
+	static const int EXCEPTIONAL = 3;
+	static const int CANCELLED   = 4;
+
+	volatile int status;
+
+	/** The exception of an EXCEPTIONAL or CANCELLED future. */
+	sp<EThrowable> exception;
+
+	ECompletableFutureType();
+
+	/**
+	 * Claims the right to set the outcome of this future.
+	 */
+	boolean beginCompletion();
+
+	/**
+	 * Publishes the final state, then wakes up waiting threads and
+	 * fires all dependent actions.  Futures completed by those
+	 * actions have their own dependents fired by the same loop, not
+	 * by a nested call.
+	 */
+	void endCompletion(int state);
+
+	/**
+	 * Completes with the given (shared) exception, if not already completed.
+	 */
+	boolean completeThrowable(sp<EThrowable> x, int state = EXCEPTIONAL);
+
+	/**
+	 * Pushes the given completion, or fires it now if already completed.
+	 */
+	void push(sp<cf::Completion> c);
+
+	/**
+	 * Captures, then runs or dispatches, the given completion.
+	 */
+	void fire(sp<cf::Completion> c);
+
+	/**
+	 * Waits for completion, returning the final status, or a
+	 * non-final status on timeout or interrupt.
+	 */
+	int awaitDone(boolean interruptible, boolean timed, llong nanos)
+			THROWS(EInterruptedException);
+
+	/**
+	 * Throws the exception a non-normal get() reports.
+	 */
+	void reportGet(int s) THROWS(EExecutionException);
+
+	/**
+	 * Throws the exception a non-normal join() reports.
+	 */
+	void reportJoin(int s);
+
+	/**
+	 * Returns the result as an EObject, used by anyOf.
+	 */
+	virtual sp<EObject> rawResult() = 0;
+
+	/**
+	 * Copies the given exception, the way futures store them.
+	 */
+	static sp<EThrowable> copyOf(EThrowable& ex);
+
+private:
+	struct WaitNode {
+		EThread* volatile thread;
+		WaitNode* next;
+	};
+
+	volatile int waitLock;
+	sp<cf::Completion> stack;  // dependents, guarded by waitLock
+	WaitNode* waiters;         // threads in get(), guarded by waitLock
+
+	void lockWaiters();
+	void unlockWaiters();
+
+	// unsupported.
+	ECompletableFutureType(const ECompletableFutureType& that);
+	ECompletableFutureType& operator= (const ECompletableFutureType& that);
+};
+
+/**
+ * A {@link EFuture} that may be explicitly completed (setting its
+ * value and status), and may be used as a completion stage,
+ * supporting dependent functions and actions that trigger upon its
+ * completion.
+ *
+ * <p>When two or more threads attempt to
+ * {@link #complete complete},
+ * {@link #completeExceptionally completeExceptionally}, or
+ * {@link #cancel cancel}
+ * a CompletableFuture, only one of them succeeds.
+ *
+ * <p>Dependent actions never block a thread while waiting: each one
+ * is pushed on the future it depends on and is fired by whichever
+ * thread completes that future.
+ * <ul>
+ *
+ * <li>Actions supplied for dependent completions of
+ * <em>non-async</em> methods are performed by the thread that
+ * completes the current CompletableFuture, or by the caller of a
+ * completion method if it is already complete.  For {@link
+ * #orTimeout} this is the shared timer thread, so anything but short
+ * actions should use the async variants.
+ *
+ * <li>All <em>async</em> methods without an explicit Executor
+ * argument are performed using the {@link EForkJoinPool#commonPool()}.
+ * Those with an executor argument hand the action to that executor
+ * (for example an {@link EExecutorService}) only once its inputs are
+ * available.
+ *
+ * <li>If a source stage completed exceptionally, dependent stages
+ * complete exceptionally with the same exception without running
+ * their function, except for {@link #exceptionally}.
+ * </ul>
+ *
+ * <p>Functions are template parameters: any function object (or a
+ * lambda in C++11) with the documented call signature can be passed.
+ * Result types that cannot be deduced are given explicitly, as in
+ * {@code f->thenApply<EString>(fn)}.  Values are passed as {@code
+ * sp<T>}, and exceptions as {@code sp<EThrowable>}.  Since futures
+ * refer to themselves when scheduling timeouts, they must be owned
+ * by an {@code sp<>}.
+ *
+ * <p>Methods {@link #get()} and {@link #get(llong, ETimeUnit*)} throw
+ * an {@link EExecutionException} for exceptional completion, while
+ * {@link #join()} and {@link #getNow} throw an {@link
+ * ECompletionException}; in both cases the message and source
+ * location are those of the underlying exception.
+ *
+ * @param <T> The result type returned by this future's {@code join}
+ * and {@code get} methods
+ * @since 1.8
+ */
+
+template<typename T>
+class ECompletableFuture : public ECompletableFutureType, virtual public EFuture<T> {
+public:
+	virtual ~ECompletableFuture() {
+	}
+
+	/**
+	 * Creates a new incomplete CompletableFuture.
+	 */
+	ECompletableFuture() {
+	}
+
+	/**
+	 * Returns a new CompletableFuture that is already completed with
+	 * the given value.
+	 *
+	 * @param value the value
+	 * @return the completed CompletableFuture
+	 */
+	static sp<ECompletableFuture<T> > completedFuture(sp<T> value) {
+		sp<ECompletableFuture<T> > d = new ECompletableFuture<T>();
+		d->complete(value);
+		return d;
+	}
+
+	/**
+	 * Returns a new CompletableFuture that is already completed
+	 * exceptionally with the given exception.
+	 *
+	 * @param ex the exception
+	 * @return the exceptionally completed CompletableFuture
+	 * @since 9
+	 */
+	static sp<ECompletableFuture<T> > failedFuture(EThrowable& ex) {
+		sp<ECompletableFuture<T> > d = new ECompletableFuture<T>();
+		d->completeExceptionally(ex);
+		return d;
+	}
+
+	/**
+	 * Returns a new CompletableFuture that is asynchronously completed
+	 * by a task running in the given executor with the value obtained
+	 * by calling the given supplier.
+	 *
+	 * @param supplier a function returning the {@code sp<T>} value to
+	 * be used to complete the returned CompletableFuture, invoked as
+	 * {@code supplier()}
+	 * @param executor the executor to use for asynchronous execution
+	 * @return the new CompletableFuture
+	 */
+	template<typename F>
+	static sp<ECompletableFuture<T> > supplyAsync(F supplier,
+			EExecutor* executor = defaultExecutor()) {
+		if (executor == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		sp<ECompletableFuture<T> > d = new ECompletableFuture<T>();
+		sp<AsyncSupply<F> > c = new AsyncSupply<F>(d, supplier, executor);
+		try {
+			executor->execute(c);
+		} catch (EThrowable& ex) {
+			c->reject(ex);
+		}
+		return d;
+	}
+
+	/**
+	 * If not already completed, sets the value returned by {@link
+	 * #get()} and related methods to the given value.
+	 *
+	 * @param value the result value
+	 * @return {@code true} if this invocation caused this CompletableFuture
+	 * to transition to a completed state, else {@code false}
+	 */
+	boolean complete(sp<T> value) {
+		if (!beginCompletion())
+			return false;
+		result = value;
+		endCompletion(NORMAL);
+		return true;
+	}
+
+	virtual boolean cancel(boolean mayInterruptIfRunning) {
+		return ECompletableFutureType::cancel(mayInterruptIfRunning);
+	}
+
+	virtual boolean isCancelled() {
+		return ECompletableFutureType::isCancelled();
+	}
+
+	virtual boolean isDone() {
+		return ECompletableFutureType::isDone();
+	}
+
+	/**
+	 * Waits if necessary for this future to complete, and then
+	 * returns its result.
+	 *
+	 * @return the result value
+	 * @throws ECancellationException if this future was cancelled
+	 * @throws EExecutionException if this future completed exceptionally
+	 * @throws EInterruptedException if the current thread was interrupted
+	 * while waiting
+	 */
+	virtual sp<T> get() THROWS2(EInterruptedException, EExecutionException) {
+		int s = awaitDone(true, false, 0L);
+		if (s != NORMAL)
+			reportGet(s);
+		return result;
+	}
+
+	/**
+	 * Waits if necessary for at most the given time for this future
+	 * to complete, and then returns its result, if available.
+	 *
+	 * @param timeout the maximum time to wait
+	 * @param unit the time unit of the timeout argument
+	 * @return the result value
+	 * @throws ECancellationException if this future was cancelled
+	 * @throws EExecutionException if this future completed exceptionally
+	 * @throws EInterruptedException if the current thread was interrupted
+	 * while waiting
+	 * @throws ETimeoutException if the wait timed out
+	 */
+	virtual sp<T> get(llong timeout, ETimeUnit* unit)
+		THROWS3(EInterruptedException, EExecutionException, ETimeoutException) {
+		if (unit == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		int s = awaitDone(true, true, unit->toNanos(timeout));
+		if (s < NORMAL)
+			throw ETimeoutException(__FILE__, __LINE__);
+		if (s != NORMAL)
+			reportGet(s);
+		return result;
+	}
+
+	/**
+	 * Returns the result value when complete, or throws an
+	 * (unchecked) exception if completed exceptionally. To better
+	 * conform with the use of common functional forms, if a
+	 * computation involved in the completion of this
+	 * CompletableFuture threw an exception, this method throws an
+	 * (unchecked) {@link ECompletionException} with the underlying
+	 * exception as its cause.
+	 *
+	 * @return the result value
+	 * @throws ECancellationException if the computation was cancelled
+	 * @throws ECompletionException if this future completed
+	 * exceptionally or a completion computation threw an exception
+	 */
+	sp<T> join() {
+		int s = awaitDone(false, false, 0L);
+		if (s != NORMAL)
+			reportJoin(s);
+		return result;
+	}
+
+	/**
+	 * Returns the result value (or throws any encountered exception)
+	 * if completed, else returns the given valueIfAbsent.
+	 *
+	 * @param valueIfAbsent the value to return if not completed
+	 * @return the result value, if completed, else the given valueIfAbsent
+	 * @throws ECancellationException if the computation was cancelled
+	 * @throws ECompletionException if this future completed
+	 * exceptionally or a completion computation threw an exception
+	 */
+	sp<T> getNow(sp<T> valueIfAbsent) {
+		int s = status;
+		if (s < NORMAL)
+			return valueIfAbsent;
+		if (s != NORMAL)
+			reportJoin(s);
+		return result;
+	}
+
+	/**
+	 * Returns a new CompletableFuture that, when this one completes
+	 * normally, is completed with the result of the given function
+	 * applied to this future's result.
+	 *
+	 * @param fn the function to use to compute the value of the
+	 * returned CompletableFuture, invoked as {@code fn(sp<T>)} and
+	 * returning {@code sp<U>}
+	 * @return the new CompletableFuture
+	 */
+	template<typename U, typename F>
+	sp<ECompletableFuture<U> > thenApply(F fn) {
+		return uniApplyStage<U>(null, fn);
+	}
+
+	/**
+	 * Same as {@link #thenApply}, but the function is executed using
+	 * the given executor (by default the common pool).
+	 */
+	template<typename U, typename F>
+	sp<ECompletableFuture<U> > thenApplyAsync(F fn,
+			EExecutor* executor = defaultExecutor()) {
+		if (executor == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		return uniApplyStage<U>(executor, fn);
+	}
+
+	/**
+	 * Returns a new CompletableFuture that is completed with the same
+	 * value as the CompletableFuture returned by the given function,
+	 * applied to this future's result when it completes normally.
+	 *
+	 * @param fn the function returning another
+	 * {@code sp<ECompletableFuture<U> >}, invoked as {@code fn(sp<T>)}
+	 * @return the new CompletableFuture
+	 */
+	template<typename U, typename F>
+	sp<ECompletableFuture<U> > thenCompose(F fn) {
+		return uniComposeStage<U>(null, fn);
+	}
+
+	/**
+	 * Same as {@link #thenCompose}, but the function is executed using
+	 * the given executor (by default the common pool).
+	 */
+	template<typename U, typename F>
+	sp<ECompletableFuture<U> > thenComposeAsync(F fn,
+			EExecutor* executor = defaultExecutor()) {
+		if (executor == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		return uniComposeStage<U>(executor, fn);
+	}
+
+	/**
+	 * Returns a new CompletableFuture that, when this and the other
+	 * given future both complete normally, is completed with the
+	 * result of the given function applied to the two results.
+	 *
+	 * @param other the other CompletableFuture
+	 * @param fn the function to use to compute the value of the
+	 * returned CompletableFuture, invoked as {@code fn(sp<T>, sp<U>)}
+	 * and returning {@code sp<V>}
+	 * @return the new CompletableFuture
+	 */
+	template<typename V, typename U, typename F>
+	sp<ECompletableFuture<V> > thenCombine(sp<ECompletableFuture<U> > other,
+			F fn) {
+		return biApplyStage<V>(null, other, fn);
+	}
+
+	/**
+	 * Same as {@link #thenCombine}, but the function is executed using
+	 * the given executor (by default the common pool).
+	 */
+	template<typename V, typename U, typename F>
+	sp<ECompletableFuture<V> > thenCombineAsync(
+			sp<ECompletableFuture<U> > other, F fn,
+			EExecutor* executor = defaultExecutor()) {
+		if (executor == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		return biApplyStage<V>(executor, other, fn);
+	}
+
+	/**
+	 * Returns a new CompletableFuture that, when this one completes
+	 * exceptionally, is completed with the result of the given
+	 * function of the exception; otherwise it is completed with the
+	 * same value as this one.
+	 *
+	 * @param fn the function to use to compute the value of the
+	 * returned CompletableFuture if this CompletableFuture completed
+	 * exceptionally, invoked as {@code fn(sp<EThrowable>)} and
+	 * returning {@code sp<T>}
+	 * @return the new CompletableFuture
+	 */
+	template<typename F>
+	sp<ECompletableFuture<T> > exceptionally(F fn) {
+		sp<ECompletableFuture<T> > d = new ECompletableFuture<T>();
+		push(sp<cf::Completion>(new UniExceptionally<F>(d, fn)));
+		return d;
+	}
+
+	/**
+	 * Exceptionally completes this CompletableFuture with
+	 * a {@link ETimeoutException} if not otherwise completed
+	 * before the given timeout.
+	 *
+	 * @param timeout how long to wait before completing exceptionally
+	 *        with a ETimeoutException, in units of {@code unit}
+	 * @param unit a {@code ETimeUnit} determining how to interpret the
+	 *        {@code timeout} parameter
+	 * @return this CompletableFuture
+	 * @since 9
+	 */
+	ECompletableFuture<T>* orTimeout(llong timeout, ETimeUnit* unit) {
+		if (unit == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		if (status == NEW)
+			arm(new cf::Timeout(shared_from_this()), unit->toNanos(timeout));
+		return this;
+	}
+
+	/**
+	 * Completes this CompletableFuture with the given value if not
+	 * otherwise completed before the given timeout.
+	 *
+	 * @param value the value to use upon timeout
+	 * @param timeout how long to wait before completing normally
+	 *        with the given value, in units of {@code unit}
+	 * @param unit a {@code ETimeUnit} determining how to interpret the
+	 *        {@code timeout} parameter
+	 * @return this CompletableFuture
+	 * @since 9
+	 */
+	ECompletableFuture<T>* completeOnTimeout(sp<T> value, llong timeout,
+			ETimeUnit* unit) {
+		if (unit == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		if (status == NEW)
+			arm(sp<cf::Timeout>(new DelayedCompleter(shared_from_this(), value)),
+					unit->toNanos(timeout));
+		return this;
+	}
+
+	/**
+	 * Returns a string identifying this CompletableFuture, as well as
+	 * its completion state.
+	 */
+	virtual EStringBase toString() {
+		int s = status;
+		int count = 0;
+		EStringBase str("ECompletableFuture");
+		if (s == NORMAL)
+			str.append("[Completed normally]");
+		else if (s > NORMAL)
+			str.append("[Completed exceptionally]");
+		else if ((count = getNumberOfDependents()) == 0)
+			str.append("[Incomplete]");
+		else
+			str.append("[Not completed, ").append(count).append(" dependents]");
+		return str;
+	}
+
+protected:
+	template<typename> friend class ECompletableFuture;
+
+	/** The result of a NORMAL future. */
+	sp<T> result;
+
+	virtual sp<EObject> rawResult() {
+		return result;
+	}
+
+	/**
+	 * Completion for supplyAsync.
+	 */
+	template<typename F>
+	class AsyncSupply : public cf::Completion {
+	public:
+		AsyncSupply(sp<ECompletableFuture<T> >& dst, F& fn, EExecutor* e) :
+				cf::Completion(e), dst(dst), fn(fn) {
+		}
+		virtual boolean capture(ECompletableFutureType* src) {
+			return true;
+		}
+		virtual void run() {
+			try {
+				dst->complete(fn());
+			} catch (EThrowable& ex) {
+				dst->completeExceptionally(ex);
+			} catch (...) {
+				ERuntimeException ex(__FILE__, __LINE__, "unknown exception in supplier");
+				dst->completeExceptionally(ex);
+			}
+			dst = null;
+		}
+		virtual void reject(EThrowable& ex) {
+			dst->completeExceptionally(ex);
+			dst = null;
+		}
+	private:
+		sp<ECompletableFuture<T> > dst;
+		F fn;
+	};
+
+	/**
+	 * Completion for thenApply.
+	 */
+	template<typename U, typename F>
+	class UniApply : public cf::Completion {
+	public:
+		UniApply(sp<ECompletableFuture<U> >& dst, F& fn, EExecutor* e) :
+				cf::Completion(e), dst(dst), fn(fn) {
+		}
+		virtual boolean capture(ECompletableFutureType* src) {
+			ECompletableFuture<T>* a = static_cast<ECompletableFuture<T>*>(src);
+			if (a->status != NORMAL) {
+				dst->completeThrowable(a->exception);
+				dst = null;
+				return false;
+			}
+			r = a->result;
+			return true;
+		}
+		virtual void run() {
+			try {
+				dst->complete(fn(r));
+			} catch (EThrowable& ex) {
+				dst->completeExceptionally(ex);
+			} catch (...) {
+				ERuntimeException ex(__FILE__, __LINE__, "unknown exception in function");
+				dst->completeExceptionally(ex);
+			}
+			dst = null;
+			r = null;
+		}
+		virtual void reject(EThrowable& ex) {
+			dst->completeExceptionally(ex);
+			dst = null;
+			r = null;
+		}
+	private:
+		sp<ECompletableFuture<U> > dst;
+		F fn;
+		sp<T> r;
+	};
+
+	/**
+	 * Completes dst with the outcome of its source; used by
+	 * thenCompose to relay the future returned by the function.
+	 */
+	class UniRelay : public cf::Completion {
+	public:
+		UniRelay(sp<ECompletableFuture<T> >& dst) :
+				cf::Completion(null), dst(dst) {
+		}
+		virtual boolean capture(ECompletableFutureType* src) {
+			ECompletableFuture<T>* a = static_cast<ECompletableFuture<T>*>(src);
+			if (a->status != NORMAL)
+				dst->completeThrowable(a->exception);
+			else
+				dst->complete(a->result);
+			dst = null;
+			return false;
+		}
+		virtual void run() {
+		}
+		virtual void reject(EThrowable& ex) {
+		}
+	private:
+		sp<ECompletableFuture<T> > dst;
+	};
+
+	/**
+	 * Completion for thenCompose.
+	 */
+	template<typename U, typename F>
+	class UniCompose : public cf::Completion {
+	public:
+		UniCompose(sp<ECompletableFuture<U> >& dst, F& fn, EExecutor* e) :
+				cf::Completion(e), dst(dst), fn(fn) {
+		}
+		virtual boolean capture(ECompletableFutureType* src) {
+			ECompletableFuture<T>* a = static_cast<ECompletableFuture<T>*>(src);
+			if (a->status != NORMAL) {
+				dst->completeThrowable(a->exception);
+				dst = null;
+				return false;
+			}
+			r = a->result;
+			return true;
+		}
+		virtual void run() {
+			try {
+				sp<ECompletableFuture<U> > g = fn(r);
+				if (g == null)
+					throw ENullPointerException(__FILE__, __LINE__);
+				g->push(sp<cf::Completion>(new typename ECompletableFuture<U>::UniRelay(dst)));
+			} catch (EThrowable& ex) {
+				dst->completeExceptionally(ex);
+			} catch (...) {
+				ERuntimeException ex(__FILE__, __LINE__, "unknown exception in function");
+				dst->completeExceptionally(ex);
+			}
+			dst = null;
+			r = null;
+		}
+		virtual void reject(EThrowable& ex) {
+			dst->completeExceptionally(ex);
+			dst = null;
+			r = null;
+		}
+	private:
+		sp<ECompletableFuture<U> > dst;
+		F fn;
+		sp<T> r;
+	};
+
+	/**
+	 * Shared state of thenCombine: the two outcomes, and a countdown
+	 * of the sources still pending. The side that completes last runs
+	 * (or dispatches) the function.
+	 */
+	template<typename U, typename V, typename F>
+	class BiApply : public ERunnable {
+	public:
+		BiApply(sp<ECompletableFuture<V> >& dst, F& fn, EExecutor* e) :
+				dst(dst), fn(fn), executor(e), pending(2) {
+		}
+		virtual void run() {
+			try {
+				dst->complete(fn(r, s));
+			} catch (EThrowable& ex) {
+				dst->completeExceptionally(ex);
+			} catch (...) {
+				ERuntimeException ex(__FILE__, __LINE__, "unknown exception in function");
+				dst->completeExceptionally(ex);
+			}
+			dst = null;
+			r = null;
+			s = null;
+		}
+		/**
+		 * Called by each side once its outcome is recorded.
+		 */
+		void arrive(sp<BiApply<U,V,F> >& self) {
+			if (eso_atomic_add_and_fetch32(&pending, -1) != 0)
+				return;
+			if (x != null || y != null) {
+				dst->completeThrowable((x != null) ? x : y);
+				dst = null;
+			}
+			else if (executor == null)
+				run();
+			else {
+				try {
+					executor->execute(self);
+				} catch (EThrowable& ex) {
+					dst->completeExceptionally(ex);
+					dst = null;
+				}
+			}
+		}
+
+		sp<ECompletableFuture<V> > dst;
+		F fn;
+		EExecutor* executor;
+		volatile es_int32_t pending;
+		sp<T> r;
+		sp<U> s;
+		sp<EThrowable> x;    // first exception by source order
+		sp<EThrowable> y;
+	};
+
+	template<typename U, typename V, typename F>
+	class BiLeft : public cf::Completion {
+	public:
+		BiLeft(sp<BiApply<U,V,F> >& bi) : cf::Completion(null), bi(bi) {
+		}
+		virtual boolean capture(ECompletableFutureType* src) {
+			ECompletableFuture<T>* a = static_cast<ECompletableFuture<T>*>(src);
+			if (a->status != NORMAL)
+				bi->x = a->exception;
+			else
+				bi->r = a->result;
+			bi->arrive(bi);
+			bi = null;
+			return false;
+		}
+		virtual void run() {
+		}
+		virtual void reject(EThrowable& ex) {
+		}
+	private:
+		sp<BiApply<U,V,F> > bi;
+	};
+
+	/**
+	 * Completion for exceptionally.
+	 */
+	template<typename F>
+	class UniExceptionally : public cf::Completion {
+	public:
+		UniExceptionally(sp<ECompletableFuture<T> >& dst, F& fn) :
+				cf::Completion(null), dst(dst), fn(fn) {
+		}
+		virtual boolean capture(ECompletableFutureType* src) {
+			ECompletableFuture<T>* a = static_cast<ECompletableFuture<T>*>(src);
+			if (a->status == NORMAL) {
+				dst->complete(a->result);
+				dst = null;
+				return false;
+			}
+			x = a->exception;
+			return true;
+		}
+		virtual void run() {
+			try {
+				dst->complete(fn(x));
+			} catch (EThrowable& ex) {
+				dst->completeExceptionally(ex);
+			} catch (...) {
+				ERuntimeException ex(__FILE__, __LINE__, "unknown exception in function");
+				dst->completeExceptionally(ex);
+			}
+			dst = null;
+			x = null;
+		}
+		virtual void reject(EThrowable& ex) {
+		}
+	private:
+		sp<ECompletableFuture<T> > dst;
+		F fn;
+		sp<EThrowable> x;
+	};
+
+	/**
+	 * Timeout action of completeOnTimeout.
+	 */
+	class DelayedCompleter : public cf::Timeout {
+	public:
+		DelayedCompleter(sp<ECompletableFutureType> f, sp<T>& value) :
+				cf::Timeout(f), value(value) {
+		}
+	protected:
+		virtual void onTimeout(ECompletableFutureType* f) {
+			static_cast<ECompletableFuture<T>*>(f)->complete(value);
+		}
+	private:
+		sp<T> value;
+	};
+
+	/**
+	 * Cancels a pending timeout once its future completes, so that the
+	 * timer does not keep the future alive.
+	 */
+	class Canceller : public cf::Completion {
+	public:
+		Canceller(sp<cf::Timeout>& t) : cf::Completion(null), t(t) {
+		}
+		virtual boolean capture(ECompletableFutureType* src) {
+			t->cancel();
+			t = null;
+			return false;
+		}
+		virtual void run() {
+		}
+		virtual void reject(EThrowable& ex) {
+		}
+	private:
+		sp<cf::Timeout> t;
+	};
+
+	template<typename U, typename F>
+	sp<ECompletableFuture<U> > uniApplyStage(EExecutor* e, F& fn) {
+		sp<ECompletableFuture<U> > d = new ECompletableFuture<U>();
+		push(sp<cf::Completion>(new UniApply<U,F>(d, fn, e)));
+		return d;
+	}
+
+	template<typename U, typename F>
+	sp<ECompletableFuture<U> > uniComposeStage(EExecutor* e, F& fn) {
+		sp<ECompletableFuture<U> > d = new ECompletableFuture<U>();
+		push(sp<cf::Completion>(new UniCompose<U,F>(d, fn, e)));
+		return d;
+	}
+
+	template<typename V, typename U, typename F>
+	sp<ECompletableFuture<V> > biApplyStage(EExecutor* e,
+			sp<ECompletableFuture<U> >& other, F& fn) {
+		if (other == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		sp<ECompletableFuture<V> > d = new ECompletableFuture<V>();
+		sp<BiApply<U,V,F> > bi = new BiApply<U,V,F>(d, fn, e);
+		push(sp<cf::Completion>(new BiLeft<U,V,F>(bi)));
+		other->push(sp<cf::Completion>(new typename ECompletableFuture<U>::template
+				BiRight<T,V,F>(bi)));
+		return d;
+	}
+
+	/**
+	 * Right side of a thenCombine started on an
+	 * ECompletableFuture<L>; this future is the other input.
+	 */
+	template<typename L, typename V, typename F>
+	class BiRight : public cf::Completion {
+	public:
+		typedef typename ECompletableFuture<L>::template BiApply<T,V,F> Bi;
+
+		BiRight(sp<Bi>& bi) : cf::Completion(null), bi(bi) {
+		}
+		virtual boolean capture(ECompletableFutureType* src) {
+			ECompletableFuture<T>* b = static_cast<ECompletableFuture<T>*>(src);
+			if (b->status != NORMAL)
+				bi->y = b->exception;
+			else
+				bi->s = b->result;
+			bi->arrive(bi);
+			bi = null;
+			return false;
+		}
+		virtual void run() {
+		}
+		virtual void reject(EThrowable& ex) {
+		}
+	private:
+		sp<Bi> bi;
+	};
+
+	void arm(sp<cf::Timeout> t, llong nanos) {
+		cf::Timeout::delay(t, nanos);
+		push(sp<cf::Completion>(new Canceller(t)));
+	}
+};
+
+} /* namespace efc */
+#endif /* ECOMPLETABLEFUTURE_HH_ */
@@ -0,0 +1,79 @@
+/*
+ * ECompletionException.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ECOMPLETIONEXCEPTION_HH_
+#define ECOMPLETIONEXCEPTION_HH_
+
+#include "../ERuntimeException.hh"
+
+namespace efc {
+
+#define ECOMPLETIONEXCEPTION       ECompletionException(__FILE__, __LINE__, errno)
+#define ECOMPLETIONEXCEPTIONS(msg) ECompletionException(__FILE__, __LINE__, msg)
+
+/**
+ * Exception thrown when an error or other exception is encountered
+ * in the course of completing a result or task.
+ *
+ * @since 1.8
+ */
+
+class ECompletionException: public ERuntimeException {
+public:
+	/**
+	 * Constructs an <code>ECompletionException</code> with no
+	 * detail message.
+	 *
+	 * @param   _file_   __FILE__
+	 * @param   _line_   __LINE__
+	 * @param   errn     errno
+	 */
+	ECompletionException(const char *_file_, int _line_, int errn = 0) :
+			ERuntimeException(_file_, _line_, errn) {
+	}
+
+	/**
+	 * Constructs an <code>ECompletionException</code> with the
+	 * specified detail message.
+	 *
+	 * @param   _file_   __FILE__.
+	 * @param   _line_   __LINE__.
+	 * @param   s   the detail message.
+	 */
+	ECompletionException(const char *_file_, int _line_, const char *s, int errn = 0) :
+			ERuntimeException(_file_, _line_, s, errn) {
+	}
+
+	/**
+	 * Constructs an <code>ECompletionException</code> with the specified cause.
+	 *
+	 * @param   _file_   __FILE__
+	 * @param   _line_   __LINE__
+	 * @param   cause    the cause (which is saved for later retrieval by the
+	 *         {@link #getCause()} method).
+	 */
+	ECompletionException(const char *_file_, int _line_, EThrowable* cause) :
+			ERuntimeException(_file_, _line_, cause) {
+	}
+
+	/**
+	 * Constructs an <code>ECompletionException</code> with the specified
+	 * detail message and cause.
+	 *
+	 * @param   _file_   __FILE__
+	 * @param   _line_   __LINE__
+	 * @param   s   the detail message.
+	 * @param   cause    the cause (which is saved for later retrieval by the
+	 *         {@link #getCause()} method).
+	 */
+	ECompletionException(const char *_file_, int _line_, const char *s, EThrowable* cause) :
+			ERuntimeException(_file_, _line_, s, cause) {
+	}
+};
+
+} /* namespace efc */
+#endif /* ECOMPLETIONEXCEPTION_HH_ */
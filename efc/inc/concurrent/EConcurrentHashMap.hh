@@ -10,13 +10,22 @@
 
 #include "../EMap.hh"
 #include "../EMath.hh"
+#include "../EThread.hh"
 #include "../EInteger.hh"
+#include "../ELLong.hh"
+#include "../EFloat.hh"
+#include "../EDouble.hh"
+#include "./EUnsafe.hh"
+#include "./EOrderAccess.hh"
+#include "./EThreadLocalRandom.hh"
+#include "./EForkJoinPool.hh"
+#include "./ERecursiveTask.hh"
+#include "./ERecursiveAction.hh"
 #include "./EConcurrentSet.hh"
 #include "./EConcurrentMap.hh"
 #include "./EAbstractConcurrentCollection.hh"
 #include "./EConcurrentIterator.hh"
 #include "./EConcurrentEnumeration.hh"
-#include "./EReentrantLock.hh"
 #include "../ENullPointerException.hh"
 #include "../EIllegalArgumentException.hh"
 #include "../ENoSuchElementException.hh"
@@ -25,58 +34,69 @@
 
 namespace efc {
 
+//@see: openjdk-8/src/share/classes/java/util/concurrent/ConcurrentHashMap.java
+
 /**
  * A hash table supporting full concurrency of retrievals and
- * adjustable expected concurrency for updates. This class obeys the
+ * high expected concurrency for updates. This class obeys the
  * same functional specification as {@link java.util.Hashtable}, and
  * includes versions of methods corresponding to each method of
- * <tt>Hashtable</tt>. However, even though all operations are
+ * {@code Hashtable}. However, even though all operations are
  * thread-safe, retrieval operations do <em>not</em> entail locking,
  * and there is <em>not</em> any support for locking the entire table
  * in a way that prevents all access.  This class is fully
- * interoperable with <tt>Hashtable</tt> in programs that rely on its
+ * interoperable with {@code Hashtable} in programs that rely on its
  * thread safety but not on its synchronization details.
  *
- * <p> Retrieval operations (including <tt>get</tt>) generally do not
- * block, so may overlap with update operations (including
- * <tt>put</tt> and <tt>remove</tt>). Retrievals reflect the results
- * of the most recently <em>completed</em> update operations holding
- * upon their onset.  For aggregate operations such as <tt>putAll</tt>
- * and <tt>clear</tt>, concurrent retrievals may reflect insertion or
- * removal of only some entries.  Similarly, Iterators and
- * Enumerations return elements reflecting the state of the hash table
- * at some point at or since the creation of the iterator/enumeration.
- * They do <em>not</em> throw {@link ConcurrentModificationException}.
- * However, iterators are designed to be used by only one thread at a time.
+ * <p>Retrieval operations (including {@code get}) generally do not
+ * block, so may overlap with update operations (including {@code put}
+ * and {@code remove}). Retrievals reflect the results of the most
+ * recently <em>completed</em> update operations holding upon their
+ * onset. (More formally, an update operation for a given key bears a
+ * <em>happens-before</em> relation with any (non-null) retrieval for
+ * that key reporting the updated value.)  For aggregate operations
+ * such as {@code putAll} and {@code clear}, concurrent retrievals may
+ * reflect insertion or removal of only some entries.  Similarly,
+ * Iterators and Enumerations return elements reflecting the state of
+ * the hash table at some point at or since the creation of the
+ * iterator/enumeration.  They do <em>not</em> throw {@link
+ * EConcurrentModificationException}.  However, iterators are designed
+ * to be used by only one thread at a time.  Bear in mind that the
+ * results of aggregate status methods including {@code size} and
+ * {@code isEmpty} are typically useful only when a map is not undergoing
+ * concurrent updates in other threads.  Otherwise the results of these
+ * methods reflect transient states that may be adequate for monitoring
+ * or estimation purposes, but not for program control.
  *
- * <p> The allowed concurrency among update operations is guided by
- * the optional <tt>concurrencyLevel</tt> constructor argument
- * (default <tt>16</tt>), which is used as a hint for internal sizing.  The
- * table is internally partitioned to try to permit the indicated
- * number of concurrent updates without contention. Because placement
- * in hash tables is essentially random, the actual concurrency will
- * vary.  Ideally, you should choose a value to accommodate as many
- * threads as will ever concurrently modify the table. Using a
- * significantly higher value than you need can waste space and time,
- * and a significantly lower value can lead to thread contention. But
- * overestimates and underestimates within an order of magnitude do
- * not usually have much noticeable impact. A value of one is
- * appropriate when it is known that only one thread will modify and
- * all others will only read. Also, resizing this or any other kind of
- * hash table is a relatively slow operation, so, when possible, it is
- * a good idea to provide estimates of expected table sizes in
- * constructors.
+ * <p>The table is dynamically expanded when there are too many
+ * collisions (i.e., keys that have distinct hash codes but fall into
+ * the same slot modulo the table size), with the expected average
+ * effect of maintaining roughly two bins per mapping (corresponding
+ * to a 0.75 load factor threshold for resizing). There may be much
+ * variance around this average as mappings are added and removed, but
+ * overall, this maintains a commonly accepted time/space tradeoff for
+ * hash tables.  However, resizing this or any other kind of hash
+ * table may be a relatively slow operation. When possible, it is a
+ * good idea to provide a size estimate as an optional {@code
+ * initialCapacity} constructor argument. An additional optional
+ * {@code loadFactor} constructor argument provides a further means of
+ * customizing initial table capacity by specifying the table density
+ * to be used in calculating the amount of space to allocate for the
+ * given number of elements.  Also, for compatibility with previous
+ * versions of this class, constructors may optionally specify an
+ * expected {@code concurrencyLevel} as an additional hint for
+ * internal sizing.  Note that using many keys with exactly the same
+ * {@code hashCode()} is a sure way to slow down performance of any
+ * hash table; bins that grow too long are converted into balanced
+ * trees ordered by hash, so lookups in them degrade to O(log n)
+ * rather than O(n).
  *
  * <p>This class and its views and iterators implement all of the
- * <em>optional</em> methods of the {@link Map} and {@link Iterator}
+ * <em>optional</em> methods of the {@link EMap} and {@link EIterator}
  * interfaces.
  *
- * <p> Like {@link Hashtable} but unlike {@link HashMap}, this class
- * does <em>not</em> allow <tt>null</tt> to be used as a key or value.
- *
- * <p>This class is a member of the
- * <a href="{@docRoot}/../technotes/guides/collections/index.html">
- * Java Collections Framework</a>.
+ * <p>Like {@link EHashtable} but unlike {@link EHashMap}, this class
+ * does <em>not</em> allow {@code null} to be used as a key or value.
  *
  * @since 1.5
  * @param <K> the type of keys maintained by this map
@@ -86,649 +106,1141 @@ namespace efc {
 /* ---------------- Constants -------------- */
 
 /**
- * The default initial capacity for this table,
- * used when not otherwise specified in a constructor.
+ * The default initial table capacity.  Must be a power of 2
+ * (i.e., at least 1) and at most MAXIMUM_CAPACITY.
  */
 #define CHM_DEFAULT_INITIAL_CAPACITY	16
 
 /**
- * The default load factor for this table, used when not
- * otherwise specified in a constructor.
+ * The load factor for this table. Overrides of this value in
+ * constructors affect only the initial table capacity.  The
+ * actual floating point value isn't normally used -- it is
+ * simpler to use expressions such as {@code n - (n >>> 2)} for
+ * the associated resizing threshold.
  */
 #define CHM_DEFAULT_LOAD_FACTOR			0.75f
 
 /**
- * The default concurrency level for this table, used when not
- * otherwise specified in a constructor.
+ * The default concurrency level for this table. Unused but
+ * defined for compatibility with previous versions of this class.
  */
 #define CHM_DEFAULT_CONCURRENCY_LEVEL	16
 
 /**
- * The maximum capacity, used if a higher value is implicitly
- * specified by either of the constructors with arguments.  MUST
- * be a power of two <= 1<<30 to ensure that entries are indexable
- * using ints.
+ * The largest possible table capacity.  This value must be
+ * exactly 1<<30 to stay within array allocation and indexing
+ * bounds for power of two table sizes, and is further required
+ * because the top two bits of 32bit hash fields are used for
+ * control purposes.
  */
 #define CHM_MAXIMUM_CAPACITY		(1 << 30)
 
 /**
- * The maximum number of segments to allow; used to bound
- * constructor arguments.
+ * The bin count threshold for using a tree rather than list for a
+ * bin.  Bins are converted to trees when adding an element to a
+ * bin with at least this many nodes. The value must be greater
+ * than 2, and should be at least 8 to mesh with assumptions in
+ * tree removal about conversion back to plain bins upon
+ * shrinkage.
+ */
+#define CHM_TREEIFY_THRESHOLD		8
+
+/**
+ * The bin count threshold for untreeifying a (split) bin during a
+ * resize operation. Should be less than TREEIFY_THRESHOLD, and at
+ * most 6 to mesh with shrinkage detection under removal.
+ */
+#define CHM_UNTREEIFY_THRESHOLD		6
+
+/**
+ * The smallest table capacity for which bins may be treeified.
+ * (Otherwise the table is resized if too many nodes in a bin.)
+ * The value should be at least 4 * TREEIFY_THRESHOLD to avoid
+ * conflicts between resizing and treeification thresholds.
+ */
+#define CHM_MIN_TREEIFY_CAPACITY	64
+
+/**
+ * Minimum number of rebinnings per transfer step. Ranges are
+ * subdivided to allow multiple resizer threads.  This value
+ * serves as a lower bound to avoid resizers encountering
+ * excessive memory contention.  The value should be at least
+ * DEFAULT_CAPACITY.
+ */
+#define CHM_MIN_TRANSFER_STRIDE		16
+
+/**
+ * The number of bits used for generation stamp in sizeCtl.
+ * Must be at least 6 for 32bit arrays.
+ */
+#define CHM_RESIZE_STAMP_BITS		16
+
+/**
+ * The maximum number of threads that can help resize.
+ * Must fit in 32 - RESIZE_STAMP_BITS bits.
+ */
+#define CHM_MAX_RESIZERS			((1 << (32 - CHM_RESIZE_STAMP_BITS)) - 1)
+
+/**
+ * The bit shift for recording size stamp in sizeCtl.
+ */
+#define CHM_RESIZE_STAMP_SHIFT		(32 - CHM_RESIZE_STAMP_BITS)
+
+/*
+ * Encodings for Node hash fields. See above for explanation.
+ */
+#define CHM_MOVED		-1 // hash for forwarding nodes
+#define CHM_TREEBIN		-2 // hash for roots of trees
+#define CHM_HASH_BITS	0x7fffffff // usable bits of normal node hash
+
+namespace chm {
+
+/**
+ * Key adapters: object keys are held by sp<> and compared with
+ * {@code equals}, primitive keys are held by value.
+ */
+template<typename K>
+struct KeyTraits {
+	typedef sp<K> stored_type;
+	typedef K* arg_type;
+
+	static boolean isNull(K* k) {
+		return k == null;
+	}
+	static int hash(K* k) {
+		return k->hashCode();
+	}
+	static boolean equals(K* k, const sp<K>& s) {
+		return k == s.get() || k->equals(s.get());
+	}
+	static boolean same(const sp<K>& a, const sp<K>& b) {
+		return a.get() == b.get() || (a != null && a->equals(b.get()));
+	}
+	static int hashOf(const sp<K>& s) {
+		return (s == null) ? 0 : s->hashCode();
+	}
+	static K* ref(const sp<K>& s) {
+		return s.get();
+	}
+	static sp<K> wrap(K* k) {
+		return sp<K>(k);
+	}
+};
+
+#define CHM_KEYTRAITS_DECLARE(K, H) template<> \
+struct KeyTraits<K> { \
+	typedef K stored_type; \
+	typedef K arg_type; \
+	static boolean isNull(K k) { \
+		return false; \
+	} \
+	static int hash(K k) { \
+		return (H); \
+	} \
+	static boolean equals(K k, K s) { \
+		return k == s; \
+	} \
+	static boolean same(K a, K b) { \
+		return a == b; \
+	} \
+	static int hashOf(K k) { \
+		return hash(k); \
+	} \
+	static K ref(K k) { \
+		return k; \
+	} \
+	static K wrap(K k) { \
+		return k; \
+	} \
+};
+
+CHM_KEYTRAITS_DECLARE(byte, (int)k)
+CHM_KEYTRAITS_DECLARE(char, (int)k)
+CHM_KEYTRAITS_DECLARE(int, k)
+CHM_KEYTRAITS_DECLARE(short, (int)k)
+CHM_KEYTRAITS_DECLARE(long, (int)((llong)k ^ (llong)((ullong)k >> 32)))
+CHM_KEYTRAITS_DECLARE(llong, (int)(k ^ (llong)((ullong)k >> 32)))
+CHM_KEYTRAITS_DECLARE(float, EFloat::floatToIntBits(k))
+CHM_KEYTRAITS_DECLARE(double, (int)(EDouble::doubleToLLongBits(k) ^
+		(llong)((ullong)EDouble::doubleToLLongBits(k) >> 32)))
+
+/**
+ * Deferred reclamation for nodes unlinked from a map.
+ *
+ * Readers never lock, so a node or value removed by a writer may
+ * still be in use by a concurrent reader. Every access to the table
+ * runs inside a short read section; retired memory is released only
+ * after all sections that could have observed it have finished.
+ * Sections are counted per stripe (selected by a per-thread probe)
+ * and per epoch parity, so entering one costs a single uncontended
+ * atomic increment.
  */
-#define CHM_MAX_SEGMENTS			(1 << 16) // slightly conservative
+class Reclaimer {
+public:
+	typedef void (*Deleter)(void* p);
+
+	~Reclaimer();
+	Reclaimer();
+
+	/**
+	 * Enters a read section, returns the slot to pass to exit().
+	 */
+	int enter();
+
+	/**
+	 * Leaves a read section; may reclaim retired memory.
+	 */
+	void exit(int slot);
+
+	/**
+	 * Schedules p to be released by d once no read section can
+	 * still observe it.
+	 */
+	void retire(void* p, Deleter d);
+
+	/**
+	 * Number of CPUS, to place bounds on some sizings.
+	 */
+	static int getNCPU();
+
+private:
+	struct Stripe;
+	struct Retired;
+
+	Stripe* stripes;
+	int mask;
+	volatile int epoch;
+	volatile int reclaiming;
+	Retired* volatile retired;
+	volatile int pending;
+
+	void reclaim();
+	static void freeAll(Retired* list);
+
+	// unsupported.
+	Reclaimer(const Reclaimer& that);
+	Reclaimer& operator= (const Reclaimer& that);
+};
 
 /**
- * Number of unsynchronized retries in size and containsValue
- * methods before resorting to locking. This is used to avoid
- * unbounded retries if tables undergo continuous modification
- * which would make it impossible to obtain an accurate result.
+ * Scoped read section.
  */
-#define CHM_RETRIES_BEFORE_LOCK		2
+class ReadGuard {
+public:
+	ReadGuard(Reclaimer* r) : r(r), slot(r->enter()) {
+	}
+	~ReadGuard() {
+		r->exit(slot);
+	}
+private:
+	Reclaimer* r;
+	int slot;
+};
+
+} /* namespace chm */
 
 template<typename K, typename V>
 class EConcurrentHashMap: public EConcurrentMap<K, V> {
 public:
-	/* ---------------- Inner Classes -------------- */
+	typedef chm::KeyTraits<K> KT;
+	typedef typename KT::stored_type S; // sp<K> or K
+	typedef typename KT::arg_type A;    // K* or K
+
+	/* ---------------- Nodes -------------- */
 
 	/**
-	 * ConcurrentHashMap list entry. Note that this is never exported
-	 * out as a user-visible Map.Entry.
-	 *
-	 * Because the value field is volatile, not final, it is legal wrt
-	 * the Java Memory Model for an unsynchronized reader to see null
-	 * instead of initial value when read via a data race.  Although a
-	 * reordering leading to this is not likely to ever actually
-	 * occur, the Segment.readValueUnderLock method is used as a
-	 * backup in case a null (pre-initialized) value is ever seen in
-	 * an unsynchronized access method.
-	 */
-	class HashEntry {
-	public:
-		sp<K> key;
-		sp<V> value; //volatile?
-		sp<HashEntry> next; //volatile?
+	 * Key-value entry.  Nodes with a negative hash field are special:
+	 * ForwardingNode (MOVED) and TreeBin (TREEBIN).  The value is
+	 * held in a separately allocated box so that it can be swapped
+	 * atomically and read without locking.  Bins are locked through
+	 * the lock word of their first node.
+	 */
+	struct Node {
 		int hash;
+		volatile int lock;
+		S key;
+		sp<V>* volatile val;
+		Node* volatile next;
 
-		~HashEntry() {
-			//
+		Node(int hash, S key, sp<V>* val, Node* next) :
+			hash(hash), lock(0), key(key), val(val), next(next) {
 		}
+	};
 
-		HashEntry(sp<K>& key, int hash,
-				sp<HashEntry>& next,
-				sp<V> value) {
-			this->key = key;
-			this->hash = hash;
-			this->next = next;
-			this->value = value;
-		}
+	/**
+	 * Nodes for use in TreeBins.
+	 */
+	struct TreeNode : public Node {
+		TreeNode* parent;  // red-black tree links
+		TreeNode* left;
+		TreeNode* right;
+		TreeNode* prev;    // needed to unlink next upon deletion
+		boolean red;
 
-		static EA<sp<HashEntry> >* newArray(int i) {
-			return NEWRC(EA<sp<HashEntry> >)(i);
+		TreeNode(int hash, S key, sp<V>* val, Node* next, TreeNode* parent) :
+			Node(hash, key, val, next), parent(parent), left(null),
+			right(null), prev(null), red(false) {
 		}
 	};
 
+	struct ForwardingNode;
+
 	/**
-	 * Segments are specialized versions of hash tables.  This
-	 * subclasses from ReentrantLock opportunistically, just to
-	 * simplify some locking and avoid separate construction.
+	 * A power of two sized array of bins.  Tables replaced by a
+	 * resize are retained until the map is destroyed, so traversals
+	 * may hold table references outside of read sections.
 	 */
-	class Segment : public EReentrantLock {
-	public:
-		/*
-		 * Segments maintain a table of entry lists that are ALWAYS
-		 * kept in a consistent state, so can be read without locking.
-		 * Next fields of nodes are immutable (final).  All list
-		 * additions are performed at the front of each bin. This
-		 * makes it easy to check changes, and also fast to traverse.
-		 * When nodes would otherwise be changed, new nodes are
-		 * created to replace them. This works well for hash tables
-		 * since the bin lists tend to be short. (The average length
-		 * is less than two for the default load factor threshold.)
-		 *
-		 * Read operations can thus proceed without locking, but rely
-		 * on selected uses of volatiles to ensure that completed
-		 * write operations performed by other threads are
-		 * noticed. For most purposes, the "count" field, tracking the
-		 * number of elements, serves as that volatile variable
-		 * ensuring visibility.  This is convenient because this field
-		 * needs to be read in many read operations anyway:
-		 *
-		 *   - All (unsynchronized) read operations must first read the
-		 *     "count" field, and should not look at table entries if
-		 *     it is 0.
-		 *
-		 *   - All (synchronized) write operations should write to
-		 *     the "count" field after structurally changing any bin.
-		 *     The operations must not take any action that could even
-		 *     momentarily cause a concurrent read operation to see
-		 *     inconsistent data. This is made easier by the nature of
-		 *     the read operations in Map. For example, no operation
-		 *     can reveal that the table has grown but the threshold
-		 *     has not yet been updated, so there are no atomicity
-		 *     requirements for this with respect to reads.
-		 *
-		 * As a guide, all critical volatile reads and writes to the
-		 * count field are marked in code comments.
-		 */
+	struct Table {
+		int length;
+		Table* prev;         // older tables
+		ForwardingNode* fwd; // marks bins transferred out of this table
+		Node* volatile bins[1];
+	};
 
-		/**
-		 * The number of elements in this segment's region.
-		 */
-		volatile int count;
+	/**
+	 * A node inserted at head of bins during transfer operations.
+	 */
+	struct ForwardingNode : public Node {
+		Table* nextTable;
 
-		/**
-		 * Number of updates that alter the size of the table. This is
-		 * used during bulk-read methods to make sure they see a
-		 * consistent snapshot: If modCounts change during a traversal
-		 * of segments computing size or checking containsValue, then
-		 * we might have an inconsistent view of state so (usually)
-		 * must retry.
-		 */
-		int modCount;
+		ForwardingNode(Table* tab) : Node(CHM_MOVED, S(), null, null), nextTable(tab) {
+		}
+	};
 
-		/**
-		 * The table is rehashed when its size exceeds this threshold.
-		 * (The value of this field is always <tt>(int)(capacity *
-		 * loadFactor)</tt>.)
-		 */
-		int threshold;
+	/**
+	 * TreeNodes used at the heads of bins. TreeBins do not hold user
+	 * keys or values, but instead point to list of TreeNodes and
+	 * their root. They also maintain a parasitic read-write lock
+	 * forcing writers (who hold bin lock) to wait for readers (who do
+	 * not) to complete before tree restructuring operations.
+	 */
+	struct TreeBin : public Node {
+		TreeNode* root;
+		TreeNode* volatile first;
+		volatile int lockState;
 
-		/**
-		 * The per-segment table.
-		 */
-		EA<sp<HashEntry> >* volatile table;
+		// values for lockState
+		static const int WRITER = 1; // set while holding write lock
+		static const int WAITER = 2; // set when waiting for write lock
+		static const int READER = 4; // increment value for setting read lock
 
 		/**
-		 * The load factor for the hash table.  Even though this value
-		 * is same for all segments, it is replicated to avoid needing
-		 * links to outer object.
-		 * @serial
+		 * Creates bin with initial set of nodes headed by b.
 		 */
-		float loadFactor;
-
-		EConcurrentHashMap<K,V>* chm;
-
-		~Segment() {
-			DELRC(table);
-		}
-
-		Segment(int initialCapacity, float lf,
-				EConcurrentHashMap<K, V>* chm) :
-				count(0), modCount(0), threshold(0), table(null), chm(chm) {
-			loadFactor = lf;
-			setTable(HashEntry::newArray(initialCapacity));
-		}
-
-		static EA<Segment*>* newArray(int i) {
-			return new EA<Segment*>(i);
+		TreeBin(TreeNode* b) : Node(CHM_TREEBIN, S(), null, null), root(null),
+				first(b), lockState(0) {
+			TreeNode* r = null;
+			for (TreeNode* x = b, *next; x != null; x = next) {
+				next = (TreeNode*)x->next;
+				x->left = x->right = null;
+				if (r == null) {
+					x->parent = null;
+					x->red = false;
+					r = x;
+				}
+				else {
+					int h = x->hash;
+					for (TreeNode* p = r;;) {
+						// equal hashes go left; lookups search both subtrees
+						int dir = (p->hash < h) ? 1 : -1;
+						TreeNode* xp = p;
+						if ((p = (dir <= 0) ? p->left : p->right) == null) {
+							x->parent = xp;
+							if (dir <= 0)
+								xp->left = x;
+							else
+								xp->right = x;
+							r = balanceInsertion(r, x);
+							break;
+						}
+					}
+				}
+			}
+			this->root = r;
 		}
 
 		/**
-		 * Sets table to new HashEntry array.
-		 * Call only while holding lock or in constructor.
+		 * Acquires write lock for tree restructuring.
 		 */
-		void setTable(EA<sp<HashEntry> >* newTable) {
-			threshold = (int)(newTable->length() * loadFactor);
-			EA<sp<HashEntry> >* oldTable = GETRC(table);
-			table = newTable;
-			DELRC(oldTable); //!
+		void lockRoot() {
+			if (!EUnsafe::compareAndSwapInt(&lockState, 0, WRITER))
+				contendedLock(); // offload to separate method
 		}
 
 		/**
-		 * Returns properly casted first entry of bin for given hash.
+		 * Releases write lock for tree restructuring.
 		 */
-		sp<HashEntry> getFirst(int hash) {
-			EA<sp<HashEntry> >* tab = GETRC(table);
-			sp<HashEntry> e = tab->atomicGet(hash & (tab->length() - 1));
-			DELRC(tab);
-			return e;
+		void unlockRoot() {
+			EOrderAccess::release_store(&lockState, 0);
 		}
 
 		/**
-		 * Reads value field of an entry under lock. Called if value
-		 * field ever appears to be null. This is possible only if a
-		 * compiler happens to reorder a HashEntry initialization with
-		 * its table assignment, which is legal under memory model
-		 * but is not known to ever occur.
+		 * Possibly blocks awaiting root lock.  Readers that see the
+		 * WAITER bit fall back to the linear list, so the wait is
+		 * short.
 		 */
-		sp<V> readValueUnderLock(sp<HashEntry>& e) {
-			sp<V> v;
-			SYNCBLOCK(this) {
-				v = atomic_load(&e->value);
-            }}
-			return v;
+		void contendedLock() {
+			for (int s;;) {
+				if (((s = lockState) & ~WAITER) == 0) {
+					if (EUnsafe::compareAndSwapInt(&lockState, s, WRITER))
+						return;
+				}
+				else if ((s & WAITER) == 0) {
+					EUnsafe::compareAndSwapInt(&lockState, s, s | WAITER);
+				}
+				else {
+					EThread::yield();
+				}
+			}
 		}
 
-		/* Specialized implementations of map methods */
-
-		sp<V> get(K* key, int hash) {
-			if (count != 0) { // read-volatile
-				sp<HashEntry> e = getFirst(hash);
-				while (e != null) {
-					if (e->hash == hash && e->key->equals(key)) {
-						sp<V> v = atomic_load(&e->value);
-						if (v != null)
-							return v;
-						return readValueUnderLock(e); // recheck
-					}
+		/**
+		 * Returns matching node or null if none. Tries to search
+		 * using tree comparisons from root, but continues linear
+		 * search when lock not available.
+		 */
+		Node* find(int h, A k) {
+			for (Node* e = first; e != null; ) {
+				int s;
+				if (((s = lockState) & (WAITER|WRITER)) != 0) {
+					if (e->hash == h && KT::equals(k, e->key))
+						return e;
 					e = e->next;
 				}
+				else if (EUnsafe::compareAndSwapInt(&lockState, s, s + READER)) {
+					TreeNode* r = root;
+					TreeNode* p = (r == null) ? null : findTreeNode(r, h, k);
+					eso_atomic_add_and_fetch32(&lockState, -READER);
+					return p;
+				}
 			}
 			return null;
 		}
 
-		boolean containsKey(K* key, int hash) {
-			if (count != 0) { // read-volatile
-				sp<HashEntry> e = getFirst(hash);
-				while (e != null) {
-					if (e->hash == hash && e->key->equals(key))
-						return true;
-					e = e->next;
+		/**
+		 * Finds or adds a node.
+		 * @return null if added
+		 */
+		TreeNode* putTreeVal(int h, S k, sp<V>* v) {
+			boolean searched = false;
+			for (TreeNode* p = root;;) {
+				int dir, ph;
+				if (p == null) {
+					TreeNode* x = new TreeNode(h, k, v, null, null);
+					root = x;
+					EOrderAccess::release_store_ptr(&first, x);
+					break;
+				}
+				else if ((ph = p->hash) > h)
+					dir = -1;
+				else if (ph < h)
+					dir = 1;
+				else if (KT::equals(KT::ref(k), p->key))
+					return p;
+				else {
+					if (!searched) {
+						TreeNode* q, *ch;
+						searched = true;
+						if (((ch = p->left) != null &&
+							 (q = findTreeNode(ch, h, KT::ref(k))) != null) ||
+							((ch = p->right) != null &&
+							 (q = findTreeNode(ch, h, KT::ref(k))) != null))
+							return q;
+					}
+					dir = -1;
 				}
-			}
-			return false;
-		}
 
-		boolean containsValue(V* value) {
-			if (count != 0) { // read-volatile
-				EA<sp<HashEntry> >* tab = GETRC(table);
-				int len = tab->length();
-				for (int i = 0 ; i < len; i++) {
-					for (sp<HashEntry> e = tab->atomicGet(i); e != null; e = e->next) {
-						sp<V> v = atomic_load(&e->value);
-						if (v == null) // recheck
-							v = readValueUnderLock(e);
-						if (v->equals(value)) {
-							DELRC(tab);
-							return true;
-						}
+				TreeNode* xp = p;
+				if ((p = (dir <= 0) ? p->left : p->right) == null) {
+					TreeNode* x, *f = first;
+					x = new TreeNode(h, k, v, f, xp);
+					EOrderAccess::release_store_ptr(&first, x);
+					if (f != null)
+						f->prev = x;
+					if (dir <= 0)
+						xp->left = x;
+					else
+						xp->right = x;
+					if (!xp->red)
+						x->red = true;
+					else {
+						lockRoot();
+						root = balanceInsertion(root, x);
+						unlockRoot();
 					}
+					break;
 				}
-				DELRC(tab);
 			}
-			return false;
+			return null;
 		}
 
-		boolean replace(K* key, int hash, V* oldValue, sp<V> newValue) {
-			boolean rv;
+		/**
+		 * Removes the given node, that must be present before this
+		 * call.  This is messier than typical red-black deletion code
+		 * because we cannot swap the contents of an interior node
+		 * with a leaf successor that is pinned by "next" pointers
+		 * that are accessible independently of lock. So instead we
+		 * swap the tree linkages.
+		 *
+		 * @return true if now too small, so should be untreeified
+		 */
+		boolean removeTreeNode(TreeNode* p) {
+			TreeNode* next = (TreeNode*)p->next;
+			TreeNode* pred = p->prev;  // unlink traversal pointers
+			TreeNode* r, *rl;
+			if (pred == null)
+				EOrderAccess::release_store_ptr(&first, next);
+			else
+				EOrderAccess::release_store_ptr(&pred->next, next);
+			if (next != null)
+				next->prev = pred;
+			if (first == null) {
+				root = null;
+				return true;
+			}
+			if ((r = root) == null || r->right == null || // too small
+				(rl = r->left) == null || rl->left == null)
+				return true;
+			lockRoot();
+			TreeNode* replacement;
+			TreeNode* pl = p->left;
+			TreeNode* pr = p->right;
+			if (pl != null && pr != null) {
+				TreeNode* s = pr, *sl;
+				while ((sl = s->left) != null) // find successor
+					s = sl;
+				boolean c = s->red; s->red = p->red; p->red = c; // swap colors
+				TreeNode* sr = s->right;
+				TreeNode* pp = p->parent;
+				if (s == pr) { // p was s's direct parent
+					p->parent = s;
+					s->right = p;
+				}
+				else {
+					TreeNode* sp_ = s->parent;
+					if ((p->parent = sp_) != null) {
+						if (s == sp_->left)
+							sp_->left = p;
+						else
+							sp_->right = p;
+					}
+					if ((s->right = pr) != null)
+						pr->parent = s;
+				}
+				p->left = null;
+				if ((p->right = sr) != null)
+					sr->parent = p;
+				if ((s->left = pl) != null)
+					pl->parent = s;
+				if ((s->parent = pp) == null)
+					r = s;
+				else if (p == pp->left)
+					pp->left = s;
+				else
+					pp->right = s;
+				if (sr != null)
+					replacement = sr;
+				else
+					replacement = p;
+			}
+			else if (pl != null)
+				replacement = pl;
+			else if (pr != null)
+				replacement = pr;
+			else
+				replacement = p;
+			if (replacement != p) {
+				TreeNode* pp = replacement->parent = p->parent;
+				if (pp == null)
+					r = replacement;
+				else if (p == pp->left)
+					pp->left = replacement;
+				else
+					pp->right = replacement;
+				p->left = p->right = p->parent = null;
+			}
 
-			SYNCBLOCK(this) {
-				sp<HashEntry> e = getFirst(hash);
-				while (e != null && (e->hash != hash || !e->key->equals(key)))
-					e = e->next;
+			root = (p->red) ? r : balanceDeletion(r, replacement);
 
-				boolean replaced = false;
-				if (e != null && e->value->equals(oldValue)) {
-					replaced = true;
-					e->value = newValue;
+			if (p == replacement) {  // detach pointers
+				TreeNode* pp;
+				if ((pp = p->parent) != null) {
+					if (p == pp->left)
+						pp->left = null;
+					else if (p == pp->right)
+						pp->right = null;
+					p->parent = null;
 				}
-				rv = replaced;
-            }}
-
-			return rv;
+			}
+			unlockRoot();
+			return false;
 		}
 
-		sp<V> replace(K* key, int hash, sp<V> newValue) {
-			sp<V> rv;
-
-			SYNCBLOCK(this) {
-				sp<HashEntry> e = getFirst(hash);
-				while (e != null && (e->hash != hash || !e->key->equals(key)))
-					e = e->next;
+		/* ------------------------------------------------------------ */
+		// Red-black tree methods, all adapted from CLR
+
+		static TreeNode* rotateLeft(TreeNode* root, TreeNode* p) {
+			TreeNode* r, *pp, *rl;
+			if (p != null && (r = p->right) != null) {
+				if ((rl = p->right = r->left) != null)
+					rl->parent = p;
+				if ((pp = r->parent = p->parent) == null)
+					(root = r)->red = false;
+				else if (pp->left == p)
+					pp->left = r;
+				else
+					pp->right = r;
+				r->left = p;
+				p->parent = r;
+			}
+			return root;
+		}
+
+		static TreeNode* rotateRight(TreeNode* root, TreeNode* p) {
+			TreeNode* l, *pp, *lr;
+			if (p != null && (l = p->left) != null) {
+				if ((lr = p->left = l->right) != null)
+					lr->parent = p;
+				if ((pp = l->parent = p->parent) == null)
+					(root = l)->red = false;
+				else if (pp->right == p)
+					pp->right = l;
+				else
+					pp->left = l;
+				l->right = p;
+				p->parent = l;
+			}
+			return root;
+		}
 
-				sp<V> oldValue = null;
-				if (e != null) {
-					oldValue = e->value;
-					e->value = newValue;
+		static TreeNode* balanceInsertion(TreeNode* root, TreeNode* x) {
+			x->red = true;
+			for (TreeNode* xp, *xpp, *xppl, *xppr;;) {
+				if ((xp = x->parent) == null) {
+					x->red = false;
+					return x;
 				}
-				rv = oldValue;
-            }}
-
-			return rv;
-		}
-
-		sp<V> put(sp<K>& key, int hash, sp<V>& value, boolean onlyIfAbsent) {
-			SYNCBLOCK(this) {
-				int c = count;
-				if (c++ > threshold) // ensure capacity
-					rehash();
-				EA<sp<HashEntry> >* tab = GETRC(table);
-				int index = hash & (tab->length() - 1);
-				sp<HashEntry> first = tab->atomicGet(index);
-				sp<HashEntry> e = first;
-				while (e != null && (e->hash != hash || !e->key->equals(key.get())))
-					e = e->next;
-
-				sp<V> oldValue;
-				if (e != null) {
-					oldValue = atomic_load(&e->value);
-					if (!onlyIfAbsent) {
-						atomic_store(&e->value, value);
+				else if (!xp->red || (xpp = xp->parent) == null)
+					return root;
+				if (xp == (xppl = xpp->left)) {
+					if ((xppr = xpp->right) != null && xppr->red) {
+						xppr->red = false;
+						xp->red = false;
+						xpp->red = true;
+						x = xpp;
+					}
+					else {
+						if (x == xp->right) {
+							root = rotateLeft(root, x = xp);
+							xpp = (xp = x->parent) == null ? null : xp->parent;
+						}
+						if (xp != null) {
+							xp->red = false;
+							if (xpp != null) {
+								xpp->red = true;
+								root = rotateRight(root, xpp);
+							}
+						}
 					}
 				}
 				else {
-					++modCount;
-					sp<HashEntry> newEntry(new HashEntry(key, hash, first, value));
-					tab->atomicSet(index, newEntry);
-					count = c; // write-volatile
+					if (xppl != null && xppl->red) {
+						xppl->red = false;
+						xp->red = false;
+						xpp->red = true;
+						x = xpp;
+					}
+					else {
+						if (x == xp->left) {
+							root = rotateRight(root, x = xp);
+							xpp = (xp = x->parent) == null ? null : xp->parent;
+						}
+						if (xp != null) {
+							xp->red = false;
+							if (xpp != null) {
+								xpp->red = true;
+								root = rotateLeft(root, xpp);
+							}
+						}
+					}
 				}
-				DELRC(tab);
-				return oldValue;
-            }}
-		}
-
-		void rehash() {
-			EA<sp<HashEntry> >* oldTable = GETRC(table);
-			int oldCapacity = oldTable->length();
-			if (oldCapacity >= CHM_MAXIMUM_CAPACITY) {
-				DELRC(oldTable);
-				return;
 			}
+		}
 
-			/*
-			 * Reclassify nodes in each list to new Map.  Because we are
-			 * using power-of-two expansion, the elements from each bin
-			 * must either stay at same index, or move with a power of two
-			 * offset. We eliminate unnecessary node creation by catching
-			 * cases where old nodes can be reused because their next
-			 * fields won't change. Statistically, at the default
-			 * threshold, only about one-sixth of them need cloning when
-			 * a table doubles. The nodes they replace will be garbage
-			 * collectable as soon as they are no longer referenced by any
-			 * reader thread that may be in the midst of traversing table
-			 * right now.
-			 */
-
-			EA<sp<HashEntry> >* newTable = HashEntry::newArray(oldCapacity<<1);
-			threshold = (int)(newTable->length() * loadFactor);
-			int sizeMask = newTable->length() - 1;
-			for (int i = 0; i < oldCapacity ; i++) {
-				// We need to guarantee that any existing reads of old Map can
-				//  proceed. So we cannot yet null out each bin.
-				sp<HashEntry> e = oldTable->atomicGet(i);
-
-				if (e != null) {
-					sp<HashEntry> next = e->next;
-					int idx = e->hash & sizeMask;
-
-					//  Single node on list
-					if (next == null)
-						(*newTable)[idx] = e;
-
+		static TreeNode* balanceDeletion(TreeNode* root, TreeNode* x) {
+			for (TreeNode* xp, *xpl, *xpr;;) {
+				if (x == null || x == root)
+					return root;
+				else if ((xp = x->parent) == null) {
+					x->red = false;
+					return x;
+				}
+				else if (x->red) {
+					x->red = false;
+					return root;
+				}
+				else if ((xpl = xp->left) == x) {
+					if ((xpr = xp->right) != null && xpr->red) {
+						xpr->red = false;
+						xp->red = true;
+						root = rotateLeft(root, xp);
+						xpr = (xp = x->parent) == null ? null : xp->right;
+					}
+					if (xpr == null)
+						x = xp;
 					else {
-						// Reuse trailing consecutive sequence at same slot
-						sp<HashEntry> lastRun = e;
-						int lastIdx = idx;
-						for (sp<HashEntry> last = next;
-							 last != null;
-							 last = last->next) {
-							int k = last->hash & sizeMask;
-							if (k != lastIdx) {
-								lastIdx = k;
-								lastRun = last;
+						TreeNode* sl = xpr->left, *sr = xpr->right;
+						if ((sr == null || !sr->red) &&
+							(sl == null || !sl->red)) {
+							xpr->red = true;
+							x = xp;
+						}
+						else {
+							if (sr == null || !sr->red) {
+								if (sl != null)
+									sl->red = false;
+								xpr->red = true;
+								root = rotateRight(root, xpr);
+								xpr = (xp = x->parent) == null ?
+									null : xp->right;
 							}
+							if (xpr != null) {
+								xpr->red = (xp == null) ? false : xp->red;
+								if ((sr = xpr->right) != null)
+									sr->red = false;
+							}
+							if (xp != null) {
+								xp->red = false;
+								root = rotateLeft(root, xp);
+							}
+							x = root;
+						}
+					}
+				}
+				else { // symmetric
+					if (xpl != null && xpl->red) {
+						xpl->red = false;
+						xp->red = true;
+						root = rotateRight(root, xp);
+						xpl = (xp = x->parent) == null ? null : xp->left;
+					}
+					if (xpl == null)
+						x = xp;
+					else {
+						TreeNode* sl = xpl->left, *sr = xpl->right;
+						if ((sl == null || !sl->red) &&
+							(sr == null || !sr->red)) {
+							xpl->red = true;
+							x = xp;
 						}
-						(*newTable)[lastIdx] = lastRun;
-
-						// Clone all remaining nodes
-						for (sp<HashEntry> p = e; p != lastRun; p = p->next) {
-							int k = p->hash & sizeMask;
-							sp<HashEntry> n = (*newTable)[k];
-							sp<HashEntry> newEntry(new HashEntry(p->key, p->hash, n, atomic_load(&p->value)));
-							(*newTable)[k] = newEntry;
+						else {
+							if (sl == null || !sl->red) {
+								if (sr != null)
+									sr->red = false;
+								xpl->red = true;
+								root = rotateLeft(root, xpl);
+								xpl = (xp = x->parent) == null ?
+									null : xp->left;
+							}
+							if (xpl != null) {
+								xpl->red = (xp == null) ? false : xp->red;
+								if ((sl = xpl->left) != null)
+									sl->red = false;
+							}
+							if (xp != null) {
+								xp->red = false;
+								root = rotateRight(root, xp);
+							}
+							x = root;
 						}
 					}
 				}
 			}
-			table = newTable;
+		}
+	};
+
+	/**
+	 * Returns the TreeNode (or null if not found) for the given key
+	 * starting at given root.
+	 */
+	static TreeNode* findTreeNode(TreeNode* p, int h, A k) {
+		do {
+			int ph;
+			TreeNode* q;
+			TreeNode* pl = p->left, *pr = p->right;
+			if ((ph = p->hash) > h)
+				p = pl;
+			else if (ph < h)
+				p = pr;
+			else if (KT::equals(k, p->key))
+				return p;
+			else if (pl == null)
+				p = pr;
+			else if (pr == null)
+				p = pl;
+			else if ((q = findTreeNode(pr, h, k)) != null)
+				return q;
+			else
+				p = pl;
+		} while (p != null);
+		return null;
+	}
 
-			//free old table
-			DELRC(oldTable);
-			DELRC(oldTable);
+	/**
+	 * A padded cell for distributing counts.
+	 */
+	struct CounterCell {
+		volatile llong value;
+		char pad[ES_CACHE_LINE_SIZE - sizeof(llong)];
+		CounterCell(llong x) : value(x) {
 		}
+	};
 
-		/**
-		 * Remove; match on key only if value null, else match both.
-		 */
-		sp<V> remove(K* key, int hash, V* value) {
-			sp<V> rv;
-
-			SYNCBLOCK(this) {
-				int c = count - 1;
-				EA<sp<HashEntry> >* tab = GETRC(table);
-				int index = hash & (tab->length() - 1);
-				sp<HashEntry> first = tab->atomicGet(index);
-				sp<HashEntry> e = first;
-				while (e != null && (e->hash != hash || !key->equals(e->key.get())))
-					e = e->next;
+	struct CounterCells {
+		int length;
+		CounterCell* volatile cells[1];
+	};
 
-				sp<V> oldValue = null;
-				if (e != null) {
-					sp<V> v = atomic_load(&e->value);
-					if (value == null || value->equals(v.get())) {
-						oldValue = v;
-						// All entries following removed node can stay
-						// in list, but all preceding ones need to be
-						// cloned.
-						++modCount;
-						sp<HashEntry> newFirst = e->next;
-						for (sp<HashEntry> p = first; p != e; p = p->next) {
-							newFirst = new HashEntry(p->key, p->hash,
-													newFirst, atomic_load(&p->value));
-						}
-						tab->atomicSet(index, newFirst);
-						count = c; // write-volatile
-					}
-				}
-				rv = oldValue;
-				DELRC(tab);
-            }}
+	/* ---------------- Traversal -------------- */
+
+	/**
+	 * Encapsulates traversal for methods such as containsValue; also
+	 * serves as a base class for other iterators.
+	 *
+	 * Method advance visits once each still-valid node that was
+	 * reachable upon iterator construction. It might miss some that
+	 * were added to a bin after the bin was visited, which is OK wrt
+	 * consistency guarantees. Maintaining this property in the face
+	 * of possible ongoing resizes requires a fair amount of
+	 * bookkeeping state that is difficult to optimize away amidst
+	 * volatile accesses.
+	 *
+	 * Bins are copied out as a whole inside a read section, so no
+	 * node pointer is ever held between calls.
+	 *
+	 * Normally, iteration proceeds bin-by-bin traversing lists.
+	 * However, if the table has been resized, then all future steps
+	 * must traverse both the bin at the current index as well as at
+	 * (index + baseSize); and so on for further resizings. To
+	 * paranoically cope with potential sharing by users of iterators
+	 * across threads, iteration terminates if a bounds checks fails
+	 * for a table read.
+	 */
+	class Traverser {
+	public:
+		struct Entry {
+			S key;
+			sp<V> val;
+		};
+
+		virtual ~Traverser() {
+			delete[] buf;
+			TableStack* s;
+			while ((s = stack) != null) {
+				stack = s->next;
+				delete s;
+			}
+			while ((s = spare) != null) {
+				spare = s->next;
+				delete s;
+			}
+		}
 
-			return rv;
+		Traverser(EConcurrentHashMap<K,V>* map, Table* tab, int size,
+				int index, int limit) :
+				map(map), tab(tab), stack(null), spare(null), index(index),
+				baseIndex(index), baseLimit(limit), baseSize(size),
+				buf(null), bufCap(0), bufLen(0), bufPos(0) {
 		}
 
-		void clear() {
-			if (count != 0) {
-				SYNCBLOCK(this) {
-					EA<sp<HashEntry> >* tab = GETRC(table);
-					for (int i = 0; i < tab->length() ; i++) {
-						sp<HashEntry> nullPtr;
-						tab->atomicSet(i, nullPtr);
+		/**
+		 * Advances if possible, returning next valid entry, or null
+		 * if none.  The returned entry is valid until the next call.
+		 */
+		Entry* advance() {
+			for (;;) {
+				Table* t; int i, n;
+				if (bufPos < bufLen)
+					return &buf[bufPos++];
+				if (baseIndex >= baseLimit || (t = tab) == null ||
+					(n = t->length) <= (i = index) || i < 0)
+					return null;
+				chm::ReadGuard g(&map->reclaimer);
+				Node* e = tabAt(t, i);
+				if (e != null && e->hash < 0) {
+					if (e->hash == CHM_MOVED) {
+						tab = ((ForwardingNode*)e)->nextTable;
+						pushState(t, i, n);
+						continue;
 					}
-					++modCount;
-					count = 0; // write-volatile
-					DELRC(tab);
-                }}
+					else if (e->hash == CHM_TREEBIN)
+						e = ((TreeBin*)e)->first;
+					else
+						e = null;
+				}
+				fill(e);
+				if (stack != null)
+					recoverState(n);
+				else if ((index = i + baseSize) >= n)
+					index = ++baseIndex; // visit upper slots if present
 			}
 		}
-	};
 
-	/* ---------------- Iterator Support -------------- */
+	protected:
+		/**
+		 * Records traversal state upon encountering a forwarding node.
+		 */
+		struct TableStack {
+			int length;
+			int index;
+			Table* tab;
+			TableStack* next;
+		};
+
+		EConcurrentHashMap<K,V>* map;
+		Table* tab;          // current table; updated if resized
+		TableStack* stack;   // to save/restore on ForwardingNodes
+		TableStack* spare;
+		int index;           // index of bin to use next
+		int baseIndex;       // current index of initial table
+		int baseLimit;       // index bound for initial table
+		const int baseSize;  // initial table size
+		Entry* buf;          // copy of the current bin
+		int bufCap;
+		int bufLen;
+		int bufPos;
 
-	abstract class HashIterator {
-		EConcurrentHashMap<K,V>* chm;
-		int nextSegmentIndex;
-		int nextTableIndex;
-		EA<sp<HashEntry> >* currentTable;
-		sp<HashEntry> nextEntry_;
-		sp<HashEntry> lastReturned;
-
-		void advance() {
-			if (nextEntry_ != null && (nextEntry_ = nextEntry_->next) != null)
-				return;
+		/**
+		 * Saves traversal state upon encountering a forwarding node.
+		 */
+		void pushState(Table* t, int i, int n) {
+			TableStack* s = spare;  // reuse if possible
+			if (s != null)
+				spare = s->next;
+			else
+				s = new TableStack();
+			s->tab = t;
+			s->length = n;
+			s->index = i;
+			s->next = stack;
+			stack = s;
+		}
 
-			while (nextTableIndex >= 0) {
-				if ( (nextEntry_ = (*currentTable)[nextTableIndex--]) != null)
-					return;
+		/**
+		 * Possibly pops traversal state.
+		 *
+		 * @param n length of current table
+		 */
+		void recoverState(int n) {
+			TableStack* s; int len;
+			while ((s = stack) != null && (index += (len = s->length)) >= n) {
+				n = len;
+				index = s->index;
+				tab = s->tab;
+				s->tab = null;
+				TableStack* next = s->next;
+				s->next = spare; // save for reuse
+				stack = next;
+				spare = s;
 			}
+			if (s == null && (index += baseSize) >= n)
+				index = ++baseIndex;
+		}
 
-			while (nextSegmentIndex >= 0) {
-				Segment* seg = (*chm->segments_)[nextSegmentIndex--];
-				if (seg->count != 0) {
-					DELRC(currentTable); //!
-					currentTable = GETRC(seg->table);
-					for (int j = currentTable->length() - 1; j >= 0; --j) {
-						if ( (nextEntry_ = (*currentTable)[j]) != null) {
-							nextTableIndex = j - 1;
-							return;
-						}
+		/**
+		 * Copies the entries of the list headed by e into buf.
+		 */
+		void fill(Node* e) {
+			int last = bufLen;
+			bufLen = bufPos = 0;
+			for (; e != null; e = e->next) {
+				if (bufLen == bufCap) {
+					int cap = (bufCap == 0) ? 4 : bufCap << 1;
+					Entry* nb = new Entry[cap];
+					for (int j = 0; j < bufLen; j++) {
+						nb[j] = buf[j];
 					}
+					delete[] buf;
+					buf = nb;
+					bufCap = cap;
+					last = 0;
 				}
+				buf[bufLen].key = e->key;
+				buf[bufLen].val = *valOf(e);
+				bufLen++;
+			}
+			for (int j = bufLen; j < last; j++) { // release stale refs
+				buf[j].key = S();
+				buf[j].val = null;
 			}
 		}
+	};
 
+	/**
+	 * Base of key, value, and entry Iterators. Adds fields to
+	 * Traverser to support iterator.remove.
+	 */
+	class BaseIterator : public Traverser {
 	public:
-		HashIterator(EConcurrentHashMap<K,V>* chm) : chm(chm) {
-			nextSegmentIndex = chm->segments_->length() - 1;
-			nextTableIndex = -1;
-			currentTable = null;
-			advance();
+		BaseIterator(EConcurrentHashMap<K,V>* map, Table* tab, int size) :
+				Traverser(map, tab, size, 0, size), hasLast(false) {
+			nextEntry = this->advance();
 		}
 
-		virtual ~HashIterator() {
-			DELRC(currentTable);
-		}
-
-		sp<HashEntry> nextEntry() {
-			if (nextEntry_ == null)
-				throw ENoSuchElementException(__FILE__, __LINE__);
-			lastReturned = nextEntry_;
-			advance();
-			return lastReturned;
-		}
+	protected:
+		typename Traverser::Entry* nextEntry;
+		S lastKey;
+		boolean hasLast;
 
-		boolean hasMoreElements() {
-			return hasNext();
+		boolean hasMore() {
+			return nextEntry != null;
 		}
 
-		boolean hasNext() {
-			return nextEntry_ != null;
+		/**
+		 * Copies out the pending entry and moves to the next one.
+		 */
+		void step(S* k, sp<V>* v) {
+			typename Traverser::Entry* p = nextEntry;
+			if (p == null)
+				throw ENoSuchElementException(__FILE__, __LINE__);
+			lastKey = p->key;
+			hasLast = true;
+			if (k != null)
+				*k = p->key;
+			if (v != null)
+				*v = p->val;
+			nextEntry = this->advance();
 		}
 
-		void remove() {
-			if (lastReturned == null)
+		void removeLast() {
+			if (!hasLast)
 				throw EIllegalStateException(__FILE__, __LINE__);
-			chm->remove(lastReturned->key.get());
-			lastReturned = null;
+			hasLast = false;
+			S k = lastKey;
+			lastKey = S();
+			this->map->replaceNode(KT::ref(k), null, null);
 		}
 	};
 
-	class KeyIterator: public HashIterator, public EConcurrentIterator<
-	K>, public EConcurrentEnumeration<K> {
+	class KeyIterator: public BaseIterator,
+			public EConcurrentIterator<K>,
+			public EConcurrentEnumeration<K> {
 	public:
-		KeyIterator(EConcurrentHashMap<K,V>* chm) : HashIterator(chm) {}
-		boolean hasMoreElements()    { return HashIterator::hasMoreElements();  }
-		boolean hasNext()            { return HashIterator::hasNext();          }
-		sp<K> next()        { return HashIterator::nextEntry()->key; }
-		sp<K> nextElement() { return HashIterator::nextEntry()->key; }
-		void remove()                { HashIterator::remove();                  }
-	};
-
-	class ValueIterator: public HashIterator, public EConcurrentIterator<
-	V>, public EConcurrentEnumeration<V> {
+		KeyIterator(EConcurrentHashMap<K,V>* map, Table* tab, int size) :
+				BaseIterator(map, tab, size) {
+		}
+		S next() {
+			S k;
+			this->step(&k, null);
+			return k;
+		}
+		S nextElement() {
+			return next();
+		}
+		boolean hasNext() {
+			return this->hasMore();
+		}
+		boolean hasMoreElements() {
+			return this->hasMore();
+		}
+		void remove() {
+			this->removeLast();
+		}
+	};
+
+	class ValueIterator: public BaseIterator,
+			public EConcurrentIterator<V>,
+			public EConcurrentEnumeration<V> {
 	public:
-		ValueIterator(EConcurrentHashMap<K,V>* chm) : HashIterator(chm) {}
-		boolean hasMoreElements()      { return HashIterator::hasMoreElements();  }
-		boolean hasNext()              { return HashIterator::hasNext();          }
-		sp<V> next()        { return HashIterator::nextEntry()->value; }
-		sp<V> nextElement() { return HashIterator::nextEntry()->value; }
-		void remove()                  { HashIterator::remove();                  }
+		ValueIterator(EConcurrentHashMap<K,V>* map, Table* tab, int size) :
+				BaseIterator(map, tab, size) {
+		}
+		sp<V> next() {
+			sp<V> v;
+			this->step(null, &v);
+			return v;
+		}
+		sp<V> nextElement() {
+			return next();
+		}
+		boolean hasNext() {
+			return this->hasMore();
+		}
+		boolean hasMoreElements() {
+			return this->hasMore();
+		}
+		void remove() {
+			this->removeLast();
+		}
 	};
 
 	/**
-	 * Custom Entry class used by EntryIterator.next(), that relays
-	 * setValue changes to the underlying map.
+	 * Exported Entry for EntryIterator
 	 */
-	class WriteThroughEntry: public EConcurrentMapEntry<K, V> {
+	class MapEntry: public EConcurrentMapEntry<K, V> {
 	private:
-		sp<K> key;
-		sp<V> value;
-		EConcurrentHashMap<K, V>* chm;
-
-		static boolean eq(EObject* o1, EObject* o2) {
-			return o1 == null ? o2 == null : o1->equals(o2);
-		}
+		S key;
+		sp<V> val;
+		EConcurrentHashMap<K,V>* map;
 	public:
-		/**
-		 * Creates an entry representing a mapping from the specified
-		 * key to the specified value.
-		 *
-		 * @param key the key represented by this entry
-		 * @param value the value represented by this entry
-		 */
-		WriteThroughEntry(sp<K>& key, sp<V>& value,
-				EConcurrentHashMap<K, V>* chm) : chm(chm) {
-			this->key = key;
-			this->value = value;
+		MapEntry(S key, sp<V> val, EConcurrentHashMap<K,V>* map) :
+				key(key), val(val), map(map) {
 		}
-
-		/**
-		 * Returns the key corresponding to this entry.
-		 *
-		 * @return the key corresponding to this entry
-		 */
-		sp<K> getKey() {
+		S getKey() {
 			return key;
 		}
-
-		/**
-		 * Returns the value corresponding to this entry.
-		 *
-		 * @return the value corresponding to this entry
-		 */
 		sp<V> getValue() {
-			return value;
+			return val;
+		}
+		int hashCode() {
+			return KT::hashOf(key) ^ val->hashCode();
+		}
+		boolean equals(sp<EConcurrentMapEntry<K, V> > o) {
+			sp<V> v = o->getValue();
+			return (v != null && KT::same(key, o->getKey()) &&
+					(v == val || v->equals(val.get())));
 		}
 
 		/**
-		 * Set our entry's value and write through to the map. The
-		 * value to return is somewhat arbitrary here. Since a
-		 * WriteThroughEntry does not necessarily track asynchronous
-		 * changes, the most recent "previous" value could be
-		 * different from what we return (or could even have been
-		 * removed in which case the put will re-establish). We do not
-		 * and cannot guarantee more.
+		 * Sets our entry's value and writes through to the map. The
+		 * value to return is somewhat arbitrary here. Since we do not
+		 * necessarily track asynchronous changes, the most recent
+		 * "previous" value could be different from what we return (or
+		 * could even have been removed, in which case the put will
+		 * re-establish). We do not and cannot guarantee more.
 		 */
 		sp<V> setValue(sp<V> value) {
 			if (value == null)
 				throw ENullPointerException(__FILE__, __LINE__);
-
-			sp<V> oldValue = this->value;
-			this->value = value;
-			return oldValue;
-		}
-
-		boolean equals(sp<EConcurrentMapEntry<K, V> > o) {
-			return eq(key.get(), o->getKey().get()) && eq(value.get(), o->getValue().get());
-		}
-
-		virtual int hashCode() {
-			return (key   == null ? 0 : key->hashCode()) ^
-					(value == null ? 0 : value->hashCode());
+			sp<V> v = val;
+			val = value;
+			map->put(key, value);
+			return v;
 		}
 	};
 
-	class EntryIterator: public HashIterator,
-	                     public EConcurrentIterator<EConcurrentMapEntry<K, V> >
-	{
-	private:
-		EConcurrentHashMap<K, V>* chm;
+	class EntryIterator: public BaseIterator,
+			public EConcurrentIterator<EConcurrentMapEntry<K, V> > {
 	public:
-		EntryIterator(EConcurrentHashMap<K, V>* chm) :
-				HashIterator(chm), chm(chm) {
+		EntryIterator(EConcurrentHashMap<K,V>* map, Table* tab, int size) :
+				BaseIterator(map, tab, size) {
 		}
 		sp<EConcurrentMapEntry<K, V> > next() {
-			sp<HashEntry> e = HashIterator::nextEntry();
-			return new WriteThroughEntry(e->key, e->value, chm);
+			S k;
+			sp<V> v;
+			this->step(&k, &v);
+			return new MapEntry(k, v, this->map);
 		}
 		boolean hasNext() {
-			return HashIterator::hasNext();
+			return this->hasMore();
 		}
 		void remove() {
-			HashIterator::remove();
+			this->removeLast();
 		}
 	};
 
+	/* ---------------- Views -------------- */
+
 	class KeySet : public EConcurrentSet<K> {
 	private:
 		EConcurrentHashMap<K,V>* chm;
@@ -736,7 +1248,7 @@ public:
 		KeySet(EConcurrentHashMap<K,V>* chm) : chm(chm) {
 		}
 		sp<EConcurrentIterator<K> > iterator() {
-			return new KeyIterator(chm);
+			return chm->newKeyIterator();
 		}
 		int size() {
 			return chm->size();
@@ -744,16 +1256,16 @@ public:
 		boolean isEmpty() {
 			return chm->isEmpty();
 		}
-		boolean contains(K* o) {
+		boolean contains(A o) {
 			return chm->containsKey(o);
 		}
-		boolean remove(K* o) {
+		boolean remove(A o) {
 			return chm->remove(o) != null;
 		}
 		void clear() {
 			chm->clear();
 		}
-		boolean add(K* e) {
+		boolean add(A e) {
 			throw EUnsupportedOperationException(__FILE__, __LINE__);
 		}
 		boolean add(sp<K> e) {
@@ -768,7 +1280,7 @@ public:
 		Values(EConcurrentHashMap<K,V>* chm) : chm(chm) {
 		}
 		sp<EConcurrentIterator<V> > iterator() {
-			return new ValueIterator(chm);
+			return chm->newValueIterator();
 		}
 		int size() {
 			return chm->size();
@@ -782,22 +1294,6 @@ public:
 		void clear() {
 			chm->clear();
 		}
-//		boolean add(V* e) {
-//			throw EUnsupportedOperationException(__FILE__, __LINE__);
-//		}
-//		boolean add(sp<V> e) {
-//			throw EUnsupportedOperationException(__FILE__, __LINE__);
-//		}
-//		boolean remove(V* o) {
-//			sp<EConcurrentIterator<V> > e = iterator();
-//			while (e->hasNext()) {
-//				if (o->equals(e->next().get())) {
-//					e->remove();
-//					return true;
-//				}
-//			}
-//			return false;
-//		}
 	};
 
 	class EntrySet : public EConcurrentSet<EConcurrentMapEntry<K,V> > {
@@ -807,14 +1303,15 @@ public:
 		EntrySet(EConcurrentHashMap<K,V>* chm) : chm(chm) {
 		}
 		sp<EConcurrentIterator<EConcurrentMapEntry<K,V> > > iterator() {
-			return new EntryIterator(chm);
+			return chm->newEntryIterator();
 		}
 		boolean contains(EConcurrentMapEntry<K,V>* e) {
-			sp<V> v = chm->get(e->getKey().get());
-			return v != null && v->equals(e->getValue().get());
+			sp<V> v = chm->get(KT::ref(e->getKey()));
+			sp<V> o = e->getValue();
+			return v != null && o != null && (v == o || v->equals(o.get()));
 		}
 		boolean remove(EConcurrentMapEntry<K,V>* e) {
-			return chm->remove(e->getKey().get(), e->getValue().get());
+			return chm->remove(KT::ref(e->getKey()), e->getValue().get());
 		}
 		int size() {
 			return chm->size();
@@ -833,182 +1330,394 @@ public:
 		}
 	};
 
+
+	/* ---------------- Bulk Tasks -------------- */
+
+	/**
+	 * Base for bulk tasks. Each task covers the bins [baseIndex,
+	 * baseLimit) of the table it was started on, and while its batch
+	 * count allows, hands the upper half of its range to a forked
+	 * subtask before traversing what is left.
+	 */
+	class BulkTask {
+	protected:
+		EConcurrentHashMap<K,V>* map;
+		Table* tab;
+		int batch;          // split control
+		int baseIndex;
+		int baseLimit;
+
+		BulkTask(EConcurrentHashMap<K,V>* map, int b, int i, int f, Table* t) :
+				map(map), tab(t), batch(b), baseIndex(i),
+				baseLimit((t == null) ? 0 : f) {
+		}
+
+		/**
+		 * Gives away the upper half of the remaining range, if the
+		 * batch count still allows splitting.
+		 *
+		 * @return {@code true} if [index, limit) was handed out
+		 */
+		boolean trySplit(int& index, int& limit) {
+			int i = baseIndex, f = baseLimit, h;
+			if (batch <= 0 || (h = (int)((unsigned)(f + i) >> 1)) <= i)
+				return false;
+			batch = (int)((unsigned)batch >> 1);
+			baseLimit = h;
+			index = h;
+			limit = f;
+			return true;
+		}
+
+		int baseSize() {
+			return (tab == null) ? 0 : tab->length;
+		}
+	};
+
+	template<typename F>
+	class ForEachTask : public ERecursiveAction, public BulkTask {
+	public:
+		ForEachTask(EConcurrentHashMap<K,V>* map, int b, int i, int f,
+				Table* t, F& action) :
+				BulkTask(map, b, i, f, t), action(action) {
+		}
+		sp<ForEachTask<F> > nextRight;
+	protected:
+		F action;
+
+		void compute() {
+			sp<ForEachTask<F> > rights;
+			int i, f;
+			while (this->trySplit(i, f)) {
+				sp<ForEachTask<F> > r = new ForEachTask<F>(this->map,
+						this->batch, i, f, this->tab, action);
+				r->nextRight = rights;
+				rights = r;
+				r->fork();
+			}
+			try {
+				Traverser it(this->map, this->tab, this->baseSize(),
+						this->baseIndex, this->baseLimit);
+				for (typename Traverser::Entry* p; (p = it.advance()) != null; )
+					action(p->key, p->val);
+			} catch (...) {
+				quietlyJoinAll(rights);
+				throw;
+			}
+			for (; rights != null; rights = rights->nextRight)
+				rights->join();
+		}
+	};
+
+	/**
+	 * Result slot shared by all tasks of one search.
+	 */
+	template<typename U>
+	class SearchResult : public EObject {
+	public:
+		volatile int found;
+		sp<U> result;
+		SearchResult() : found(0) {
+		}
+	};
+
+	template<typename U, typename F>
+	class SearchTask : public ERecursiveAction, public BulkTask {
+	public:
+		SearchTask(EConcurrentHashMap<K,V>* map, int b, int i, int f,
+				Table* t, F& searchFunction, sp<SearchResult<U> > result) :
+				BulkTask(map, b, i, f, t), searchFunction(searchFunction),
+				result(result) {
+		}
+		sp<SearchTask<U,F> > nextRight;
+	protected:
+		F searchFunction;
+		sp<SearchResult<U> > result;
+
+		void compute() {
+			sp<SearchTask<U,F> > rights;
+			int i, f;
+			while (this->trySplit(i, f)) {
+				if (result->found != 0)
+					break;
+				sp<SearchTask<U,F> > r = new SearchTask<U,F>(this->map,
+						this->batch, i, f, this->tab, searchFunction, result);
+				r->nextRight = rights;
+				rights = r;
+				r->fork();
+			}
+			try {
+				Traverser it(this->map, this->tab, this->baseSize(),
+						this->baseIndex, this->baseLimit);
+				for (typename Traverser::Entry* p;
+						result->found == 0 && (p = it.advance()) != null; ) {
+					sp<U> u = searchFunction(p->key, p->val);
+					if (u != null) {
+						if (EUnsafe::compareAndSwapInt(&result->found, 0, 1))
+							result->result = u;
+						break;
+					}
+				}
+			} catch (...) {
+				quietlyJoinAll(rights);
+				throw;
+			}
+			for (; rights != null; rights = rights->nextRight)
+				rights->join();
+		}
+	};
+
+	template<typename U, typename T, typename R>
+	class MapReduceTask : public ERecursiveTask<U>, public BulkTask {
+	public:
+		MapReduceTask(EConcurrentHashMap<K,V>* map, int b, int i, int f,
+				Table* t, T& transformer, R& reducer) :
+				BulkTask(map, b, i, f, t), transformer(transformer),
+				reducer(reducer) {
+		}
+		sp<MapReduceTask<U,T,R> > nextRight;
+	protected:
+		T transformer;
+		R reducer;
+
+		sp<U> compute() {
+			sp<MapReduceTask<U,T,R> > rights;
+			int i, f;
+			while (this->trySplit(i, f)) {
+				sp<MapReduceTask<U,T,R> > r = new MapReduceTask<U,T,R>(
+						this->map, this->batch, i, f, this->tab,
+						transformer, reducer);
+				r->nextRight = rights;
+				rights = r;
+				r->fork();
+			}
+			sp<U> r;
+			try {
+				Traverser it(this->map, this->tab, this->baseSize(),
+						this->baseIndex, this->baseLimit);
+				for (typename Traverser::Entry* p; (p = it.advance()) != null; ) {
+					sp<U> u = transformer(p->key, p->val);
+					if (u != null)
+						r = (r == null) ? u : reducer(r, u);
+				}
+			} catch (...) {
+				quietlyJoinAll(rights);
+				throw;
+			}
+			for (; rights != null; rights = rights->nextRight) {
+				sp<U> sr = rights->join();
+				if (sr != null)
+					r = (r == null) ? sr : reducer(r, sr);
+			}
+			return r;
+		}
+	};
+
+	template<typename T, typename R>
+	class MapReduceToLongTask : public ERecursiveAction, public BulkTask {
+	public:
+		MapReduceToLongTask(EConcurrentHashMap<K,V>* map, int b, int i,
+				int f, Table* t, T& transformer, llong basis, R& reducer) :
+				BulkTask(map, b, i, f, t), transformer(transformer),
+				basis(basis), reducer(reducer), result(basis) {
+		}
+		llong getResult() {
+			return result;
+		}
+		sp<MapReduceToLongTask<T,R> > nextRight;
+	protected:
+		T transformer;
+		llong basis;
+		R reducer;
+		llong result;
+
+		void compute() {
+			sp<MapReduceToLongTask<T,R> > rights;
+			int i, f;
+			while (this->trySplit(i, f)) {
+				sp<MapReduceToLongTask<T,R> > t = new MapReduceToLongTask<T,R>(
+						this->map, this->batch, i, f, this->tab,
+						transformer, basis, reducer);
+				t->nextRight = rights;
+				rights = t;
+				t->fork();
+			}
+			llong r = basis;
+			try {
+				Traverser it(this->map, this->tab, this->baseSize(),
+						this->baseIndex, this->baseLimit);
+				for (typename Traverser::Entry* p; (p = it.advance()) != null; )
+					r = reducer(r, transformer(p->key, p->val));
+			} catch (...) {
+				quietlyJoinAll(rights);
+				throw;
+			}
+			for (; rights != null; rights = rights->nextRight) {
+				rights->join();
+				r = reducer(r, rights->result);
+			}
+			result = r;
+		}
+	};
+
+	/**
+	 * Waits for the forked subtasks of a task that is about to fail,
+	 * since they still reference the task's arguments.
+	 */
+	template<typename TASK>
+	static void quietlyJoinAll(sp<TASK> rights) {
+		for (; rights != null; rights = rights->nextRight)
+			rights->quietlyJoin();
+	}
+
 public:
 	/* ---------------- Public operations -------------- */
 
 	~EConcurrentHashMap() {
-		delete segments_;
+		Table* tab = table;
+		if (tab != null) {
+			for (int i = 0; i < tab->length; i++) {
+				Node* f = tab->bins[i];
+				if (f == null || f->hash == CHM_MOVED)
+					continue;
+				if (f->hash == CHM_TREEBIN)
+					destroyTreeBin(f);
+				else
+					destroyList(f);
+			}
+			freeTable(tab);
+		}
+		Table* nt = nextTable;
+		if (nt != null && nt != tab)
+			freeTable(nt);
+		for (Table* t = oldTables, *prev; t != null; t = prev) {
+			prev = t->prev;
+			freeTable(t);
+		}
+		CounterCells* cs = counterCells;
+		if (cs != null) {
+			for (int i = 0; i < cs->length; i++)
+				delete cs->cells[i];
+			eso_free(cs);
+		}
 	}
 
 	/**
-	 * Creates a new, empty map with the specified initial
-	 * capacity, load factor and concurrency level.
-	 *
-	 * @param initialCapacity the initial capacity. The implementation
-	 * performs internal sizing to accommodate this many elements.
-	 * @param loadFactor  the load factor threshold, used to control resizing.
-	 * Resizing may be performed when the average number of elements per
-	 * bin exceeds this threshold.
-	 * @param concurrencyLevel the estimated number of concurrently
-	 * updating threads. The implementation performs internal sizing
-	 * to try to accommodate this many threads.
-	 * @throws IllegalArgumentException if the initial capacity is
-	 * negative or the load factor or concurrencyLevel are
-	 * nonpositive.
+	 * Creates a new, empty map with the default initial table size (16).
 	 */
-	EConcurrentHashMap(int initialCapacity, float loadFactor, int concurrencyLevel) {
-		init(initialCapacity, loadFactor, concurrencyLevel);
+	EConcurrentHashMap() {
+		init(0);
 	}
 
 	/**
-	 * Creates a new, empty map with the specified initial capacity
-	 * and load factor and with the default concurrencyLevel (16).
+	 * Creates a new, empty map with an initial table size
+	 * accommodating the specified number of elements without the need
+	 * to dynamically resize.
 	 *
 	 * @param initialCapacity The implementation performs internal
 	 * sizing to accommodate this many elements.
-	 * @param loadFactor  the load factor threshold, used to control resizing.
-	 * Resizing may be performed when the average number of elements per
-	 * bin exceeds this threshold.
 	 * @throws IllegalArgumentException if the initial capacity of
-	 * elements is negative or the load factor is nonpositive
-	 *
-	 * @since 1.6
+	 * elements is negative
 	 */
-	EConcurrentHashMap(int initialCapacity, float loadFactor) {
-		init(initialCapacity, loadFactor, CHM_DEFAULT_CONCURRENCY_LEVEL);
+	EConcurrentHashMap(int initialCapacity) {
+		if (initialCapacity < 0)
+			throw EIllegalArgumentException(__FILE__, __LINE__);
+		int cap = ((initialCapacity >= (CHM_MAXIMUM_CAPACITY >> 1)) ?
+				   CHM_MAXIMUM_CAPACITY :
+				   tableSizeFor(initialCapacity + (initialCapacity >> 1) + 1));
+		init(cap);
 	}
 
 	/**
-	 * Creates a new, empty map with the specified initial capacity,
-	 * and with default load factor (0.75) and concurrencyLevel (16).
+	 * Creates a new, empty map with an initial table size based on
+	 * the given number of elements ({@code initialCapacity}) and
+	 * initial table density ({@code loadFactor}).
 	 *
 	 * @param initialCapacity the initial capacity. The implementation
-	 * performs internal sizing to accommodate this many elements.
+	 * performs internal sizing to accommodate this many elements,
+	 * given the specified load factor.
+	 * @param loadFactor the load factor (table density) for
+	 * establishing the initial table size
 	 * @throws IllegalArgumentException if the initial capacity of
-	 * elements is negative.
+	 * elements is negative or the load factor is nonpositive
+	 *
+	 * @since 1.6
 	 */
-	EConcurrentHashMap(int initialCapacity) {
-		init(initialCapacity, CHM_DEFAULT_LOAD_FACTOR, CHM_DEFAULT_CONCURRENCY_LEVEL);
+	EConcurrentHashMap(int initialCapacity, float loadFactor) {
+		init(initialCapacity, loadFactor, 1);
 	}
 
 	/**
-	 * Creates a new, empty map with a default initial capacity (16),
-	 * load factor (0.75) and concurrencyLevel (16).
+	 * Creates a new, empty map with an initial table size based on
+	 * the given number of elements ({@code initialCapacity}), table
+	 * density ({@code loadFactor}), and number of concurrently
+	 * updating threads ({@code concurrencyLevel}).
+	 *
+	 * @param initialCapacity the initial capacity. The implementation
+	 * performs internal sizing to accommodate this many elements,
+	 * given the specified load factor.
+	 * @param loadFactor the load factor (table density) for
+	 * establishing the initial table size
+	 * @param concurrencyLevel the estimated number of concurrently
+	 * updating threads. The implementation may use this value as
+	 * a sizing hint.
+	 * @throws IllegalArgumentException if the initial capacity is
+	 * negative or the load factor or concurrencyLevel are
+	 * nonpositive
 	 */
-	EConcurrentHashMap() {
-		init(CHM_DEFAULT_INITIAL_CAPACITY, CHM_DEFAULT_LOAD_FACTOR, CHM_DEFAULT_CONCURRENCY_LEVEL);
+	EConcurrentHashMap(int initialCapacity, float loadFactor, int concurrencyLevel) {
+		init(initialCapacity, loadFactor, concurrencyLevel);
 	}
 
 	/**
 	 * Creates a new map with the same mappings as the given map.
-	 * The map is created with a capacity of 1.5 times the number
-	 * of mappings in the given map or 16 (whichever is greater),
-	 * and a default load factor (0.75) and concurrencyLevel (16).
 	 *
 	 * @param m the map
 	 */
-	EConcurrentHashMap(EMap<K, V>* m) :
-			segmentMask(0), segmentShift(0), segments_(null) {
-		this(EMath::max((int) (m->size() / CHM_DEFAULT_LOAD_FACTOR) + 1,
-						CHM_DEFAULT_INITIAL_CAPACITY), CHM_DEFAULT_LOAD_FACTOR,
-				CHM_DEFAULT_CONCURRENCY_LEVEL);
+	EConcurrentHashMap(EMap<A, V*>* m) {
+		init(CHM_DEFAULT_INITIAL_CAPACITY);
 		putAll(m);
 	}
 
+	// Original (since JDK1.2) Map methods
+
+	/**
+	 * Returns the number of key-value mappings in this map.  If the
+	 * map contains more than <tt>Integer.MAX_VALUE</tt> elements, returns
+	 * <tt>Integer.MAX_VALUE</tt>.
+	 *
+	 * @return the number of key-value mappings in this map
+	 */
+	int size() {
+		llong n = mappingCount();
+		return ((n < 0L) ? 0 :
+				(n > (llong)EInteger::MAX_VALUE) ? EInteger::MAX_VALUE :
+				(int)n);
+	}
+
 	/**
 	 * Returns <tt>true</tt> if this map contains no key-value mappings.
 	 *
 	 * @return <tt>true</tt> if this map contains no key-value mappings
 	 */
 	boolean isEmpty() {
-		EA<Segment*>* segments = this->segments_;
-		/*
-		 * We keep track of per-segment modCounts to avoid ABA
-		 * problems in which an element in one segment was added and
-		 * in another removed during traversal, in which case the
-		 * table was never actually empty at any point. Note the
-		 * similar use of modCounts in the size() and containsValue()
-		 * methods, which are the only other methods also susceptible
-		 * to ABA problems.
-		 */
-		int* mc = new int[segments->length()]();
-		int mcsum = 0;
-		for (int i = 0; i < segments->length(); ++i) {
-			if ((*segments)[i]->count != 0) {
-				delete[] mc;
-				return false;
-			} else {
-				mcsum += mc[i] = (*segments)[i]->modCount;
-			}
-		}
-		// If mcsum happens to be zero, then we know we got a snapshot
-		// before any modifications at all were made.  This is
-		// probably common enough to bother tracking.
-		if (mcsum != 0) {
-			for (int i = 0; i < segments->length(); ++i) {
-				if ((*segments)[i]->count != 0 ||
-					mc[i] != (*segments)[i]->modCount) {
-					delete[] mc;
-					return false;
-				}
-			}
-		}
-		delete[] mc;
-		return true;
+		return mappingCount() <= 0L; // ignore transient negative values
 	}
 
 	/**
-	 * Returns the number of key-value mappings in this map.  If the
-	 * map contains more than <tt>Integer.MAX_VALUE</tt> elements, returns
-	 * <tt>Integer.MAX_VALUE</tt>.
+	 * Returns the number of mappings. This method should be used
+	 * instead of {@link #size} because a ConcurrentHashMap may
+	 * contain more mappings than can be represented as an int. The
+	 * value returned is an estimate; the actual count may differ if
+	 * there are concurrent insertions or removals.
 	 *
-	 * @return the number of key-value mappings in this map
+	 * @return the number of mappings
+	 * @since 1.8
 	 */
-	int size() {
-		EA<Segment*>* segments = this->segments_;
-		long sum = 0;
-		long check = 0;
-		int* mc = new int[segments->length()]();
-		// Try a few times to get accurate count. On failure due to
-		// continuous async changes in table, resort to locking.
-		for (int k = 0; k < CHM_RETRIES_BEFORE_LOCK; ++k) {
-			check = 0;
-			sum = 0;
-			int mcsum = 0;
-			for (int i = 0; i < segments->length(); ++i) {
-				sum += (*segments)[i]->count;
-				mcsum += mc[i] = (*segments)[i]->modCount;
-			}
-			if (mcsum != 0) {
-				for (int i = 0; i < segments->length(); ++i) {
-					check += (*segments)[i]->count;
-					if (mc[i] != (*segments)[i]->modCount) {
-						check = -1; // force retry
-						break;
-					}
-				}
-			}
-			if (check == sum)
-				break;
-		}
-		if (check != sum) { // Resort to locking all segments
-			sum = 0;
-			int i;
-			for (i = 0; i < segments->length(); ++i)
-				(*segments)[i]->lock();
-			for (i = 0; i < segments->length(); ++i)
-				sum += (*segments)[i]->count;
-			for (i = 0; i < segments->length(); ++i)
-				(*segments)[i]->unlock();
-		}
-		if (sum > EInteger::MAX_VALUE) {
-			delete[] mc;
-			return EInteger::MAX_VALUE;
-		}
-		else {
-			delete[] mc;
-			return (int)sum;
-		}
+	llong mappingCount() {
+		chm::ReadGuard g(&reclaimer);
+		llong n = sumCount();
+		return (n < 0L) ? 0L : n; // ignore transient negative values
 	}
 
 	/**
@@ -1022,9 +1731,39 @@ public:
 	 *
 	 * @throws NullPointerException if the specified key is null
 	 */
-	sp<V> get(K* key) {
-		int hash = hashIt(key->hashCode());
-		return segmentFor(hash)->get(key, hash);
+	sp<V> get(A key) {
+		if (KT::isNull(key))
+			throw ENullPointerException(__FILE__, __LINE__);
+		chm::ReadGuard g(&reclaimer);
+		Node* p = findNode(key);
+		return (p != null) ? *valOf(p) : null;
+	}
+
+	/**
+	 * Calls {@code reader(V*)} with the value to which the specified
+	 * key is mapped, if any, inside a read section of this map.  A
+	 * concurrent put or remove may unlink the mapping, but the value
+	 * is freed only after every section open at that time has closed;
+	 * unlike {@link #get}, no reference is taken, so the reader must
+	 * not keep the pointer past its return.  The reader must not call
+	 * back into this map either: a nested call may start a reclamation
+	 * pass, which waits for the open section of its own thread.
+	 *
+	 * @param key the key whose mapped value is to be read
+	 * @param reader the function to call with the value
+	 * @return <tt>true</tt> if the key was present and reader was called
+	 * @throws NullPointerException if the specified key is null
+	 */
+	template<typename F>
+	boolean read(A key, F& reader) {
+		if (KT::isNull(key))
+			throw ENullPointerException(__FILE__, __LINE__);
+		chm::ReadGuard g(&reclaimer);
+		Node* p = findNode(key);
+		if (p == null)
+			return false;
+		reader(valOf(p)->get());
+		return true;
 	}
 
 	/**
@@ -1036,16 +1775,17 @@ public:
 	 *         <tt>equals</tt> method; <tt>false</tt> otherwise.
 	 * @throws NullPointerException if the specified key is null
 	 */
-	boolean containsKey(K* key) {
-		int hash = hashIt(key->hashCode());
-		return segmentFor(hash)->containsKey(key, hash);
+	boolean containsKey(A key) {
+		if (KT::isNull(key))
+			throw ENullPointerException(__FILE__, __LINE__);
+		chm::ReadGuard g(&reclaimer);
+		return findNode(key) != null;
 	}
 
 	/**
 	 * Returns <tt>true</tt> if this map maps one or more keys to the
-	 * specified value. Note: This method requires a full internal
-	 * traversal of the hash table, and so is much slower than
-	 * method <tt>containsKey</tt>.
+	 * specified value. Note: This method may require a full traversal
+	 * of the map, and is much slower than method {@code containsKey}.
 	 *
 	 * @param value value whose presence in this map is to be tested
 	 * @return <tt>true</tt> if this map maps one or more keys to the
@@ -1055,60 +1795,16 @@ public:
 	boolean containsValue(V* value) {
 		if (value == null)
 			throw ENullPointerException(__FILE__, __LINE__);
-
-		// See explanation of modCount use above
-
-		EA<Segment*>* segments = this->segments_;
-		int* mc = new int[segments->length()]();
-
-		// Try a few times without locking
-		for (int k = 0; k < CHM_RETRIES_BEFORE_LOCK; ++k) {
-			int mcsum = 0;
-			for (int i = 0; i < segments->length(); ++i) {
-				mcsum += mc[i] = (*segments)[i]->modCount;
-				if ((*segments)[i]->containsValue(value)) {
-					delete[] mc;
+		Table* t = (Table*)EOrderAccess::load_ptr_acquire(&table);
+		if (t != null) {
+			Traverser it(this, t, t->length, 0, t->length);
+			for (typename Traverser::Entry* p; (p = it.advance()) != null; ) {
+				V* v = p->val.get();
+				if (v == value || value->equals(v))
 					return true;
-				}
-			}
-			boolean cleanSweep = true;
-			if (mcsum != 0) {
-				for (int i = 0; i < segments->length(); ++i) {
-					if (mc[i] != (*segments)[i]->modCount) {
-						cleanSweep = false;
-						break;
-					}
-				}
-			}
-			if (cleanSweep) {
-				delete[] mc;
-				return false;
-			}
-		}
-		// Resort to locking all segments
-		for (int i = 0; i < segments->length(); ++i)
-			(*segments)[i]->lock();
-		boolean found = false;
-		try {
-			for (int i = 0; i < segments->length(); ++i) {
-				if ((*segments)[i]->containsValue(value)) {
-					found = true;
-					break;
-				}
-			}
-		} catch(...) {
-			finally {
-				for (int i = 0; i < segments->length(); ++i)
-					(*segments)[i]->unlock();
 			}
-			delete[] mc;
-			throw; //!
-		} finally {
-			for (int i = 0; i < segments->length(); ++i)
-				(*segments)[i]->unlock();
 		}
-		delete[] mc;
-		return found;
+		return false;
 	}
 
 	/**
@@ -1118,7 +1814,7 @@ public:
 	 * full compatibility with class {@link java.util.Hashtable},
 	 * which supported this method prior to introduction of the
 	 * Java Collections framework.
-
+	 *
 	 * @param  value a value to search for
 	 * @return <tt>true</tt> if and only if some key maps to the
 	 *         <tt>value</tt> argument in this table as
@@ -1143,16 +1839,11 @@ public:
 	 *         <tt>null</tt> if there was no mapping for <tt>key</tt>
 	 * @throws NullPointerException if the specified key or value is null
 	 */
-	sp<V> put(K* key, V* value) {
-		sp<K> k(key);
-		sp<V> v(value);
-		return put(k, v);
+	sp<V> put(A key, V* value) {
+		return put(KT::wrap(key), sp<V>(value));
 	}
-	sp<V> put(sp<K> key, sp<V> value) {
-		if (value == null)
-			throw ENullPointerException(__FILE__, __LINE__);
-		int hash = hashIt(key->hashCode());
-		return segmentFor(hash)->put(key, hash, value, false);
+	sp<V> put(S key, sp<V> value) {
+		return putVal(key, value, false);
 	}
 
 	/**
@@ -1162,16 +1853,11 @@ public:
 	 *         or <tt>null</tt> if there was no mapping for the key
 	 * @throws NullPointerException if the specified key or value is null
 	 */
-	sp<V> putIfAbsent(K* key, V* value) {
-		sp<K> k(key);
-		sp<V> v(value);
-		return putIfAbsent(k, v);
+	sp<V> putIfAbsent(A key, V* value) {
+		return putIfAbsent(KT::wrap(key), sp<V>(value));
 	}
-	sp<V> putIfAbsent(sp<K> key, sp<V> value) {
-		if (value == null)
-			throw ENullPointerException(__FILE__, __LINE__);
-		int hash = hashIt(key->hashCode());
-		return segmentFor(hash)->put(key, hash, value, true);
+	sp<V> putIfAbsent(S key, sp<V> value) {
+		return putVal(key, value, true);
 	}
 
 	/**
@@ -1181,10 +1867,14 @@ public:
 	 *
 	 * @param m mappings to be stored in this map
 	 */
-	void putAll(EMap<K*, V*>* m) {
-		sp<EIterator<EMapEntry<K*,V*>*> > it = m->entrySet()->iterator();
+	void putAll(EMap<A, V*>* m) {
+		{
+			chm::ReadGuard g(&reclaimer);
+			tryPresize(m->size());
+		}
+		sp<EIterator<EMapEntry<A,V*>*> > it = m->entrySet()->iterator();
 		while (it->hasNext()) {
-			EMapEntry<K*,V*>* e = it->next();
+			EMapEntry<A,V*>* e = it->next();
 			put(e->getKey(), e->getValue());
 		}
 	}
@@ -1198,9 +1888,8 @@ public:
 	 *         <tt>null</tt> if there was no mapping for <tt>key</tt>
 	 * @throws NullPointerException if the specified key is null
 	 */
-	sp<V> remove(K* key) {
-		int hash = hashIt(key->hashCode());
-		return segmentFor(hash)->remove(key, hash, null);
+	sp<V> remove(A key) {
+		return replaceNode(key, null, null);
 	}
 
 	/**
@@ -1208,11 +1897,10 @@ public:
 	 *
 	 * @throws NullPointerException if the specified key is null
 	 */
-	boolean remove(K* key, V* value) {
-		int hash = hashIt(key->hashCode());
-		if (value == null)
-			return false;
-		return segmentFor(hash)->remove(key, hash, value) != null;
+	boolean remove(A key, V* value) {
+		if (KT::isNull(key))
+			throw ENullPointerException(__FILE__, __LINE__);
+		return value != null && replaceNode(key, null, value) != null;
 	}
 
 	/**
@@ -1220,15 +1908,13 @@ public:
 	 *
 	 * @throws NullPointerException if any of the arguments are null
 	 */
-	boolean replace(K* key, V* oldValue, V* newValue) {
-		sp<V> nv(newValue);
-		return replace(key, oldValue, nv);
+	boolean replace(A key, V* oldValue, V* newValue) {
+		return replace(key, oldValue, sp<V>(newValue));
 	}
-	boolean replace(K* key, V* oldValue, sp<V> newValue) {
-		if (oldValue == null || newValue == null)
+	boolean replace(A key, V* oldValue, sp<V> newValue) {
+		if (KT::isNull(key) || oldValue == null || newValue == null)
 			throw ENullPointerException(__FILE__, __LINE__);
-		int hash = hashIt(key->hashCode());
-		return segmentFor(hash)->replace(key, hash, oldValue, newValue);
+		return replaceNode(key, newValue, oldValue) != null;
 	}
 
 	/**
@@ -1238,23 +1924,53 @@ public:
 	 *         or <tt>null</tt> if there was no mapping for the key
 	 * @throws NullPointerException if the specified key or value is null
 	 */
-	sp<V> replace(K* key, V* value) {
-		sp<V> v(value);
-		return replace(key, v);
+	sp<V> replace(A key, V* value) {
+		return replace(key, sp<V>(value));
 	}
-	sp<V> replace(K* key, sp<V> value) {
-		if (value == null)
+	sp<V> replace(A key, sp<V> value) {
+		if (KT::isNull(key) || value == null)
 			throw ENullPointerException(__FILE__, __LINE__);
-		int hash = hashIt(key->hashCode());
-		return segmentFor(hash)->replace(key, hash, value);
+		return replaceNode(key, value, null);
 	}
 
 	/**
 	 * Removes all of the mappings from this map.
 	 */
 	void clear() {
-		for (int i = 0; i < segments_->length(); ++i)
-			(*segments_)[i]->clear();
+		chm::ReadGuard g(&reclaimer);
+		llong delta = 0L; // negative number of deletions
+		int i = 0;
+		Table* tab = table;
+		while (tab != null && i < tab->length) {
+			int fh;
+			Node* f = tabAt(tab, i);
+			if (f == null)
+				++i;
+			else if ((fh = f->hash) == CHM_MOVED) {
+				tab = helpTransfer(tab, f);
+				i = 0; // restart
+			}
+			else {
+				lockBin(f);
+				if (tabAt(tab, i) == f) {
+					Node* p = (fh >= 0 ? f :
+							   (fh == CHM_TREEBIN) ?
+							   (Node*)((TreeBin*)f)->first : null);
+					while (p != null) {
+						--delta;
+						p = p->next;
+					}
+					setTabAt(tab, i++, null);
+					if (fh == CHM_TREEBIN)
+						reclaimer.retire(f, &destroyTreeBin);
+					else
+						reclaimer.retire(f, &destroyList);
+				}
+				unlockBin(f);
+			}
+		}
+		if (delta != 0L)
+			addCount(delta, -1);
 	}
 
 	/**
@@ -1331,10 +2047,11 @@ public:
 	 *
 	 * @return an enumeration of the keys in this table
 	 * @see #keySet()
-	 *
 	 */
 	sp<EConcurrentEnumeration<K> > keys() {
-		return new KeyIterator(this);
+		Table* t = (Table*)EOrderAccess::load_ptr_acquire(&table);
+		int f = (t == null) ? 0 : t->length;
+		return new KeyIterator(this, t, f);
 	}
 
 	/**
@@ -1342,963 +2059,1049 @@ public:
 	 *
 	 * @return an enumeration of the values in this table
 	 * @see #values()
-	 *
 	 */
 	sp<EConcurrentEnumeration<V> > elements() {
-		return new ValueIterator(this);
+		Table* t = (Table*)EOrderAccess::load_ptr_acquire(&table);
+		int f = (t == null) ? 0 : t->length;
+		return new ValueIterator(this, t, f);
 	}
 
-protected:
-	friend class HashIterator;
+	// ConcurrentHashMap-only methods
+
+	/*
+	 * The following bulk operations accept a parallelismThreshold
+	 * argument. Methods proceed sequentially if the current map size is
+	 * estimated to be less than the given threshold. Using a value of
+	 * ELLong::MAX_VALUE suppresses all parallelism.  Using a value of
+	 * 1 results in maximal parallelism by partitioning into enough
+	 * subtasks to fully utilize the EForkJoinPool::commonPool() that
+	 * is used for all parallel computations. Normally, you would
+	 * initially choose one of these extreme values, and then measure
+	 * performance of using in-between values that trade off overhead
+	 * versus throughput.
+	 *
+	 * The functions are any callables (function objects, or lambdas
+	 * in C++11) and are invoked as f(key, value) with the key as
+	 * stored by the map (a sp<K>, or the value itself for primitive
+	 * keys) and the value as a sp<V>. They should not rely on any
+	 * particular ordering, and since they may run concurrently in
+	 * several threads they must not update shared state without
+	 * synchronization.
+	 *
+	 * Like iterators, bulk operations reflect the state of the map at
+	 * some point at or since their start and never throw
+	 * EConcurrentModificationException. They may freely update the
+	 * map, including removing the entry being processed. An
+	 * exception thrown by a function is rethrown to the caller after
+	 * all subtasks have finished, and the results of other subtasks
+	 * are then discarded.
+	 */
 
+	/**
+	 * Performs the given action for each (key, value).
+	 *
+	 * @param parallelismThreshold the (estimated) number of elements
+	 * needed for this operation to be executed in parallel
+	 * @param action the action, invoked as {@code action(key, value)}
+	 * @since 1.8
+	 */
+	template<typename F>
+	void forEach(llong parallelismThreshold, F action) {
+		Table* t = (Table*)EOrderAccess::load_ptr_acquire(&table);
+		int n = (t == null) ? 0 : t->length;
+		sp<ForEachTask<F> > task = new ForEachTask<F>(this,
+				batchFor(parallelismThreshold), 0, n, t, action);
+		task->invoke();
+	}
+
+	/**
+	 * Returns a non-null result from applying the given search
+	 * function on each (key, value), or null if none.  Upon
+	 * success, further element processing is suppressed and the
+	 * results of any other parallel invocations of the search
+	 * function are ignored.
+	 *
+	 * <p>The result type must be given explicitly, as in
+	 * {@code map.search<EString>(1, f)}.
+	 *
+	 * @param parallelismThreshold the (estimated) number of elements
+	 * needed for this operation to be executed in parallel
+	 * @param searchFunction a function returning a non-null
+	 * {@code sp<U>} on success, else null
+	 * @return a non-null result from applying the given search
+	 * function on each (key, value), or null if none
+	 * @since 1.8
+	 */
+	template<typename U, typename F>
+	sp<U> search(llong parallelismThreshold, F searchFunction) {
+		Table* t = (Table*)EOrderAccess::load_ptr_acquire(&table);
+		int n = (t == null) ? 0 : t->length;
+		sp<SearchResult<U> > result = new SearchResult<U>();
+		sp<SearchTask<U,F> > task = new SearchTask<U,F>(this,
+				batchFor(parallelismThreshold), 0, n, t, searchFunction,
+				result);
+		task->invoke();
+		return result->result;
+	}
+
+	/**
+	 * Returns the result of accumulating the given transformation
+	 * of all (key, value) pairs using the given reducer to
+	 * combine values, or null if none.
+	 *
+	 * <p>The result type must be given explicitly, as in
+	 * {@code map.reduce<EInteger>(1, transformer, reducer)}.
+	 *
+	 * @param parallelismThreshold the (estimated) number of elements
+	 * needed for this operation to be executed in parallel
+	 * @param transformer a function returning the {@code sp<U>}
+	 * transformation for an element, or null if there is no
+	 * transformation (in which case it is not combined)
+	 * @param reducer a commutative associative combining function,
+	 * invoked as {@code reducer(sp<U>, sp<U>)}
+	 * @return the result of accumulating the given transformation
+	 * of all (key, value) pairs
+	 * @since 1.8
+	 */
+	template<typename U, typename T, typename R>
+	sp<U> reduce(llong parallelismThreshold, T transformer, R reducer) {
+		Table* t = (Table*)EOrderAccess::load_ptr_acquire(&table);
+		int n = (t == null) ? 0 : t->length;
+		sp<MapReduceTask<U,T,R> > task = new MapReduceTask<U,T,R>(this,
+				batchFor(parallelismThreshold), 0, n, t, transformer,
+				reducer);
+		return task->invoke();
+	}
+
+	/**
+	 * Returns the result of accumulating the given transformation
+	 * of all (key, value) pairs using the given reducer to
+	 * combine values, and the given basis as an identity value.
+	 *
+	 * @param parallelismThreshold the (estimated) number of elements
+	 * needed for this operation to be executed in parallel
+	 * @param transformer a function returning the {@code llong}
+	 * transformation for an element
+	 * @param basis the identity (initial default value) for the reduction
+	 * @param reducer a commutative associative combining function,
+	 * invoked as {@code reducer(llong, llong)}
+	 * @return the result of accumulating the given transformation
+	 * of all (key, value) pairs
+	 * @since 1.8
+	 */
+	template<typename T, typename R>
+	llong reduceToLong(llong parallelismThreshold, T transformer,
+			llong basis, R reducer) {
+		Table* t = (Table*)EOrderAccess::load_ptr_acquire(&table);
+		int n = (t == null) ? 0 : t->length;
+		sp<MapReduceToLongTask<T,R> > task = new MapReduceToLongTask<T,R>(
+				this, batchFor(parallelismThreshold), 0, n, t, transformer,
+				basis, reducer);
+		task->invoke();
+		return task->getResult();
+	}
+
+protected:
 	/* ---------------- Fields -------------- */
 
 	/**
-	 * Mask value for indexing into segments. The upper bits of a
-	 * key's hash code are used to choose the segment.
+	 * The array of bins. Lazily initialized upon first insertion.
+	 * Size is always a power of two.
+	 */
+	Table* volatile table;
+
+	/**
+	 * The next table to use; non-null only while resizing.
+	 */
+	Table* volatile nextTable;
+
+	/**
+	 * Tables replaced by completed resizes, freed with the map.
+	 */
+	Table* oldTables;
+
+	/**
+	 * Base counter value, used mainly when there is no contention,
+	 * but also as a fallback during table initialization
+	 * races. Updated via CAS.
+	 */
+	volatile llong baseCount;
+
+	/**
+	 * Table initialization and resizing control.  When negative, the
+	 * table is being initialized or resized: -1 for initialization,
+	 * else -(1 + the number of active resizing threads).  Otherwise,
+	 * when table is null, holds the initial table size to use upon
+	 * creation, or 0 for default. After initialization, holds the
+	 * next element count value upon which to resize the table.
 	 */
-	int segmentMask;
+	volatile int sizeCtl;
 
 	/**
-	 * Shift value for indexing within segments.
+	 * The next table index (plus one) to split while resizing.
 	 */
-	int segmentShift;
+	volatile int transferIndex;
 
 	/**
-	 * The segments, each of which is a specialized hash table
+	 * Spinlock (locked via CAS) used when resizing and/or creating CounterCells.
 	 */
-	EA<Segment*>* segments_;
+	volatile int cellsBusy;
 
+	/**
+	 * Table of counter cells. When non-null, size is a power of 2.
+	 */
+	CounterCells* volatile counterCells;
+
+	/**
+	 * Deferred release of unlinked nodes, values and cell tables.
+	 */
+	chm::Reclaimer reclaimer;
+
+	// views
 	sp<EConcurrentSet<EConcurrentMapEntry<K,V> > > entrySet_;
 	sp<EConcurrentSet<K> > keySet_;
 	sp<EConcurrentCollection<V> > values_;
 
-private:
+	/* ---------------- Table element access -------------- */
+
+	static Node* tabAt(Table* tab, int i) {
+		return (Node*)EOrderAccess::load_ptr_acquire(&tab->bins[i]);
+	}
+
+	static boolean casTabAt(Table* tab, int i, Node* c, Node* v) {
+		return EUnsafe::compareAndSwapObject(&tab->bins[i], c, v);
+	}
+
+	static void setTabAt(Table* tab, int i, Node* v) {
+		EOrderAccess::release_store_ptr(&tab->bins[i], v);
+	}
+
+	static sp<V>* valOf(Node* e) {
+		return (sp<V>*)EOrderAccess::load_ptr_acquire(&e->val);
+	}
+
+	/**
+	 * Bins are locked through their first node; writers hold the
+	 * lock only for short list or tree updates, so spin then yield.
+	 */
+	static void lockBin(Node* f) {
+		for (int spins = 0; f->lock != 0 ||
+				!EUnsafe::compareAndSwapInt(&f->lock, 0, 1); ) {
+			if (++spins > 64) {
+				spins = 0;
+				EThread::yield();
+			}
+		}
+	}
+
+	static void unlockBin(Node* f) {
+		EOrderAccess::release_store(&f->lock, 0);
+	}
+
+	/* ---------------- Small Utilities -------------- */
+
+	/**
+	 * Spreads (XORs) higher bits of hash to lower and also forces top
+	 * bit to 0. Because the table uses power-of-two masking, sets of
+	 * hashes that vary only in bits above the current mask will
+	 * always collide. (Among known examples are sets of Float keys
+	 * holding consecutive whole numbers in small tables.)  So we
+	 * apply a transform that spreads the impact of higher bits
+	 * downward. There is a tradeoff between speed, utility, and
+	 * quality of bit-spreading. Because many common sets of hashes
+	 * are already reasonably distributed (so don't benefit from
+	 * spreading), and because we use trees to handle large sets of
+	 * collisions in bins, we just XOR some shifted bits in the
+	 * cheapest possible way to reduce systematic lossage, as well as
+	 * to incorporate impact of the highest bits that would otherwise
+	 * never be used in index calculations because of table bounds.
+	 */
+	static int spread(int h) {
+		return (h ^ (int)(((unsigned)h) >> 16)) & CHM_HASH_BITS;
+	}
+
+	/**
+	 * Returns a power of two table size for the given desired capacity.
+	 */
+	static int tableSizeFor(int c) {
+		int n = c - 1;
+		n |= (int)(((unsigned)n) >> 1);
+		n |= (int)(((unsigned)n) >> 2);
+		n |= (int)(((unsigned)n) >> 4);
+		n |= (int)(((unsigned)n) >> 8);
+		n |= (int)(((unsigned)n) >> 16);
+		return (n < 0) ? 1 : (n >= CHM_MAXIMUM_CAPACITY) ? CHM_MAXIMUM_CAPACITY : n + 1;
+	}
+
+	/**
+	 * Returns the stamp bits for resizing a table of size n, already
+	 * shifted into the high half of sizeCtl.
+	 * Must be negative when shifted left by RESIZE_STAMP_SHIFT.
+	 */
+	static int resizeStamp(int n) {
+		return (int)(((unsigned)(EInteger::numberOfLeadingZeros(n) |
+				(1 << (CHM_RESIZE_STAMP_BITS - 1)))) << CHM_RESIZE_STAMP_SHIFT);
+	}
+
+	static Table* newTable(int n) {
+		Table* t = (Table*)eso_calloc(sizeof(Table) + (n - 1) * sizeof(Node*));
+		t->length = n;
+		return t;
+	}
+
+	static void freeTable(Table* t) {
+		delete t->fwd;
+		eso_free(t);
+	}
+
+	/* ---------------- Reclamation -------------- */
+
+	static void destroyBox(void* p) {
+		delete (sp<V>*)p;
+	}
+
+	// a node whose value box has been handed to a replacement node
+	static void destroyShell(void* p) {
+		delete (Node*)p;
+	}
+
+	static void destroyNode(void* p) {
+		Node* e = (Node*)p;
+		delete e->val;
+		delete e;
+	}
+
+	static void destroyTreeNode(void* p) {
+		TreeNode* e = (TreeNode*)p;
+		delete e->val;
+		delete e;
+	}
+
+	static void destroyList(void* p) {
+		for (Node* e = (Node*)p, *next; e != null; e = next) {
+			next = e->next;
+			destroyNode(e);
+		}
+	}
+
+	static void destroyTreeShells(TreeNode* e) {
+		for (TreeNode* next; e != null; e = next) {
+			next = (TreeNode*)e->next;
+			delete e;
+		}
+	}
+
+	// a bin whose tree nodes have all been copied to another bin
+	static void destroyTreeBinShell(void* p) {
+		TreeBin* t = (TreeBin*)p;
+		destroyTreeShells(t->first);
+		delete t;
+	}
+
+	static void destroyTreeBin(void* p) {
+		TreeBin* t = (TreeBin*)p;
+		for (TreeNode* e = t->first, *next; e != null; e = next) {
+			next = (TreeNode*)e->next;
+			destroyTreeNode(e);
+		}
+		delete t;
+	}
+
+	static void destroyCells(void* p) {
+		eso_free(p);
+	}
 
-	void init(int initialCapacity, float loadFactor,
-			int concurrencyLevel)
-	{
-		if (!(loadFactor > 0) || initialCapacity < 0 || concurrencyLevel <= 0)
+	/* ---------------- Internal operations -------------- */
+
+	void init(int cap) {
+		table = null;
+		nextTable = null;
+		oldTables = null;
+		baseCount = 0L;
+		sizeCtl = cap;
+		transferIndex = 0;
+		cellsBusy = 0;
+		counterCells = null;
+	}
+
+	void init(int initialCapacity, float loadFactor, int concurrencyLevel) {
+		if (!(loadFactor > 0.0f) || initialCapacity < 0 || concurrencyLevel <= 0)
 			throw EIllegalArgumentException(__FILE__, __LINE__);
+		if (initialCapacity < concurrencyLevel)   // Use at least as many bins
+			initialCapacity = concurrencyLevel;   // as estimated threads
+		llong size = (llong)(1.0 + (llong)initialCapacity / loadFactor);
+		int cap = (size >= (llong)CHM_MAXIMUM_CAPACITY) ?
+			CHM_MAXIMUM_CAPACITY : tableSizeFor((int)size);
+		init(cap);
+	}
 
-		if (concurrencyLevel > CHM_MAX_SEGMENTS)
-			concurrencyLevel = CHM_MAX_SEGMENTS;
+	/**
+	 * Returns the node for key, or null; caller holds a read section.
+	 */
+	Node* findNode(A key) {
+		int h = spread(KT::hash(key));
+		Table* tab; Node* e; int n, eh;
+		if ((tab = table) != null && (n = tab->length) > 0 &&
+			(e = tabAt(tab, (n - 1) & h)) != null) {
+			if ((eh = e->hash) == h) {
+				if (KT::equals(key, e->key))
+					return e;
+			}
+			else if (eh < 0)
+				return findSpecial(e, h, key);
+			while ((e = e->next) != null) {
+				if (e->hash == h && KT::equals(key, e->key))
+					return e;
+			}
+		}
+		return null;
+	}
 
-		// Find power-of-two sizes best matching arguments
-		int sshift = 0;
-		int ssize = 1;
-		while (ssize < concurrencyLevel) {
-			++sshift;
-			ssize <<= 1;
+	/**
+	 * Lookup in a bin headed by a ForwardingNode or TreeBin.
+	 */
+	Node* findSpecial(Node* e, int h, A k) {
+		if (e->hash == CHM_TREEBIN)
+			return ((TreeBin*)e)->find(h, k);
+		// loop to avoid arbitrarily deep recursion on forwarding nodes
+		Table* tab = ((ForwardingNode*)e)->nextTable;
+		for (;;) {
+			int n;
+			if (tab == null || (n = tab->length) == 0 ||
+				(e = tabAt(tab, (n - 1) & h)) == null)
+				return null;
+			for (;;) {
+				int eh;
+				if ((eh = e->hash) == h && KT::equals(k, e->key))
+					return e;
+				if (eh < 0) {
+					if (eh == CHM_MOVED) {
+						tab = ((ForwardingNode*)e)->nextTable;
+						break;
+					}
+					else if (eh == CHM_TREEBIN)
+						return ((TreeBin*)e)->find(h, k);
+					else
+						return null;
+				}
+				if ((e = e->next) == null)
+					return null;
+			}
 		}
-		segmentShift = 32 - sshift;
-		segmentMask = ssize - 1;
-		this->segments_ = Segment::newArray(ssize);
+	}
 
-		if (initialCapacity > CHM_MAXIMUM_CAPACITY)
-			initialCapacity = CHM_MAXIMUM_CAPACITY;
-		int c = initialCapacity / ssize;
-		if (c * ssize < initialCapacity)
-			++c;
-		int cap = 1;
-		while (cap < c)
-			cap <<= 1;
+	/**
+	 * Implementation for put and putIfAbsent.
+	 */
+	sp<V> putVal(S key, sp<V> value, boolean onlyIfAbsent) {
+		if (KT::isNull(KT::ref(key)) || value == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		int hash = spread(KT::hash(KT::ref(key)));
+		int binCount = 0;
+		chm::ReadGuard g(&reclaimer);
+		for (Table* tab = table;;) {
+			Node* f; int n, i, fh;
+			if (tab == null || (n = tab->length) == 0)
+				tab = initTable();
+			else if ((f = tabAt(tab, i = (n - 1) & hash)) == null) {
+				Node* nn = new Node(hash, key, new sp<V>(value), null);
+				if (casTabAt(tab, i, null, nn))
+					break;                   // no lock when adding to empty bin
+				destroyNode(nn);             // never published
+			}
+			else if ((fh = f->hash) == CHM_MOVED)
+				tab = helpTransfer(tab, f);
+			else {
+				sp<V> oldVal;
+				lockBin(f);
+				if (tabAt(tab, i) == f) {
+					if (fh >= 0) {
+						binCount = 1;
+						for (Node* e = f;; ++binCount) {
+							if (e->hash == hash && KT::equals(KT::ref(key), e->key)) {
+								oldVal = *e->val;
+								if (!onlyIfAbsent)
+									setVal(e, value);
+								break;
+							}
+							Node* pred = e;
+							if ((e = e->next) == null) {
+								EOrderAccess::release_store_ptr(&pred->next,
+										new Node(hash, key, new sp<V>(value), null));
+								break;
+							}
+						}
+					}
+					else if (fh == CHM_TREEBIN) {
+						Node* p;
+						binCount = 2;
+						sp<V>* box = new sp<V>(value);
+						if ((p = ((TreeBin*)f)->putTreeVal(hash, key, box)) != null) {
+							delete box;
+							oldVal = *p->val;
+							if (!onlyIfAbsent)
+								setVal(p, value);
+						}
+					}
+				}
+				unlockBin(f);
+				if (binCount != 0) {
+					if (binCount >= CHM_TREEIFY_THRESHOLD)
+						treeifyBin(tab, i);
+					if (oldVal != null)
+						return oldVal;
+					break;
+				}
+			}
+		}
+		addCount(1L, binCount);
+		return null;
+	}
 
-		for (int i = 0; i < this->segments_->length(); ++i)
-			(*this->segments_)[i] = new Segment(cap, loadFactor, this);
+	/**
+	 * Publishes a new value box for e and retires the old one;
+	 * caller holds the bin lock.
+	 */
+	void setVal(Node* e, sp<V>& value) {
+		sp<V>* old = e->val;
+		EOrderAccess::release_store_ptr(&e->val, new sp<V>(value));
+		reclaimer.retire(old, &destroyBox);
 	}
 
-	/* ---------------- Small Utilities -------------- */
+	/**
+	 * Implementation for the four public remove/replace methods:
+	 * Replaces node value with v, conditional upon match of cv if
+	 * non-null.  If resulting value is null, delete.
+	 */
+	sp<V> replaceNode(A key, sp<V> value, V* cv) {
+		if (KT::isNull(key))
+			throw ENullPointerException(__FILE__, __LINE__);
+		int hash = spread(KT::hash(key));
+		chm::ReadGuard g(&reclaimer);
+		for (Table* tab = table;;) {
+			Node* f; int n, i, fh;
+			if (tab == null || (n = tab->length) == 0 ||
+				(f = tabAt(tab, i = (n - 1) & hash)) == null)
+				break;
+			else if ((fh = f->hash) == CHM_MOVED)
+				tab = helpTransfer(tab, f);
+			else {
+				sp<V> oldVal;
+				boolean validated = false;
+				lockBin(f);
+				if (tabAt(tab, i) == f) {
+					if (fh >= 0) {
+						validated = true;
+						for (Node* e = f, *pred = null;;) {
+							if (e->hash == hash && KT::equals(key, e->key)) {
+								V* ev = e->val->get();
+								if (cv == null || cv == ev || cv->equals(ev)) {
+									oldVal = *e->val;
+									if (value != null)
+										setVal(e, value);
+									else {
+										if (pred != null)
+											EOrderAccess::release_store_ptr(&pred->next, e->next);
+										else
+											setTabAt(tab, i, e->next);
+										reclaimer.retire(e, &destroyNode);
+									}
+								}
+								break;
+							}
+							pred = e;
+							if ((e = e->next) == null)
+								break;
+						}
+					}
+					else if (fh == CHM_TREEBIN) {
+						validated = true;
+						TreeBin* t = (TreeBin*)f;
+						TreeNode* r, *p;
+						if ((r = t->root) != null &&
+							(p = findTreeNode(r, hash, key)) != null) {
+							V* pv = p->val->get();
+							if (cv == null || cv == pv || cv->equals(pv)) {
+								oldVal = *p->val;
+								if (value != null)
+									setVal(p, value);
+								else {
+									if (t->removeTreeNode(p)) {
+										setTabAt(tab, i, untreeify(t->first));
+										reclaimer.retire(t, &destroyTreeBinShell);
+									}
+									reclaimer.retire(p, &destroyTreeNode);
+								}
+							}
+						}
+					}
+				}
+				unlockBin(f);
+				if (validated) {
+					if (oldVal != null) {
+						if (value == null)
+							addCount(-1L, -1);
+						return oldVal;
+					}
+					break;
+				}
+			}
+		}
+		return null;
+	}
+
+	/**
+	 * Initializes table, using the size recorded in sizeCtl.
+	 */
+	Table* initTable() {
+		Table* tab; int sc;
+		while ((tab = table) == null || tab->length == 0) {
+			if ((sc = sizeCtl) < 0)
+				EThread::yield(); // lost initialization race; just spin
+			else if (EUnsafe::compareAndSwapInt(&sizeCtl, sc, -1)) {
+				if ((tab = table) == null || tab->length == 0) {
+					int n = (sc > 0) ? sc : CHM_DEFAULT_INITIAL_CAPACITY;
+					tab = newTable(n);
+					EOrderAccess::release_store_ptr(&table, tab);
+					sc = n - (int)(((unsigned)n) >> 2);
+				}
+				EOrderAccess::release_store(&sizeCtl, sc);
+				break;
+			}
+		}
+		return tab;
+	}
+
+	/**
+	 * Adds to count, and if table is too small and not already
+	 * resizing, initiates transfer. If already resizing, helps
+	 * perform transfer if work is available.  Rechecks occupancy
+	 * after a transfer to see if another resize is already needed
+	 * because resizings are lagging additions.
+	 *
+	 * @param x the count to add
+	 * @param check if <0, don't check resize, if <= 1 only check if uncontended
+	 */
+	void addCount(llong x, int check) {
+		CounterCells* as; llong b = baseCount, s = b + x;
+		if ((as = counterCells) != null ||
+			!EUnsafe::compareAndSwapLLong(&baseCount, b, s)) {
+			CounterCell* a; llong v; int m;
+			boolean uncontended = true;
+			if (as == null || (m = as->length - 1) < 0 ||
+				(a = as->cells[EThreadLocalRandom::getProbe() & m]) == null ||
+				!(uncontended =
+				  ((v = a->value), EUnsafe::compareAndSwapLLong(&a->value, v, v + x)))) {
+				fullAddCount(x, uncontended);
+				return;
+			}
+			if (check <= 1)
+				return;
+			s = sumCount();
+		}
+		if (check >= 0) {
+			Table* tab, *nt; int n, sc;
+			while (s >= (llong)(sc = sizeCtl) && (tab = table) != null &&
+				   (n = tab->length) < CHM_MAXIMUM_CAPACITY) {
+				int rs = resizeStamp(n);
+				if (sc < 0) {
+					if (sc == rs + CHM_MAX_RESIZERS || sc == rs + 1 ||
+						(nt = nextTable) == null || transferIndex <= 0)
+						break;
+					if (EUnsafe::compareAndSwapInt(&sizeCtl, sc, sc + 1))
+						transfer(tab, nt);
+				}
+				else if (EUnsafe::compareAndSwapInt(&sizeCtl, sc, rs + 2))
+					transfer(tab, null);
+				s = sumCount();
+			}
+		}
+	}
 
 	/**
-	 * Applies a supplemental hash function to a given hashCode, which
-	 * defends against poor quality hash functions.  This is critical
-	 * because ConcurrentHashMap uses power-of-two length hash tables,
-	 * that otherwise encounter collisions for hashCodes that do not
-	 * differ in lower or upper bits.
+	 * Helps transfer if a resize is in progress.
 	 */
-	static int hashIt(int h) {
-		// Spread bits to regularize both segment and index locations,
-		// using variant of single-word Wang/Jenkins hash.
-		h += (h <<  15) ^ 0xffffcd7d;
-		h ^= (((unsigned)h) >> 10);
-		h += (h <<   3);
-		h ^= (((unsigned)h) >>  6);
-		h += (h <<   2) + (h << 14);
-		return h ^ (((unsigned)h) >> 16);
+	Table* helpTransfer(Table* tab, Node* f) {
+		Table* nextTab; int sc;
+		if (tab != null && f->hash == CHM_MOVED &&
+			(nextTab = ((ForwardingNode*)f)->nextTable) != null) {
+			int rs = resizeStamp(tab->length);
+			while (nextTab == nextTable && table == tab &&
+				   (sc = sizeCtl) < 0) {
+				if (sc == rs + CHM_MAX_RESIZERS || sc == rs + 1 ||
+					transferIndex <= 0)
+					break;
+				if (EUnsafe::compareAndSwapInt(&sizeCtl, sc, sc + 1)) {
+					transfer(tab, nextTab);
+					break;
+				}
+			}
+			return nextTab;
+		}
+		return table;
 	}
 
 	/**
-	 * Returns the segment that should be used for key with given hash
-	 * @param hash the hash code for the key
-	 * @return the segment
+	 * Tries to presize table to accommodate the given number of elements.
+	 *
+	 * @param size number of elements (doesn't need to be perfectly accurate)
 	 */
-	Segment* segmentFor(int hash) {
-		return (*segments_)[(((unsigned)hash) >> segmentShift) & segmentMask];
+	void tryPresize(int size) {
+		int c = (size >= (int)(((unsigned)CHM_MAXIMUM_CAPACITY) >> 1)) ? CHM_MAXIMUM_CAPACITY :
+			tableSizeFor(size + (int)(((unsigned)size) >> 1) + 1);
+		int sc;
+		while ((sc = sizeCtl) >= 0) {
+			Table* tab = table; int n;
+			if (tab == null || (n = tab->length) == 0) {
+				n = (sc > c) ? sc : c;
+				if (EUnsafe::compareAndSwapInt(&sizeCtl, sc, -1)) {
+					if (table == tab) {
+						EOrderAccess::release_store_ptr(&table, newTable(n));
+						sc = n - (int)(((unsigned)n) >> 2);
+					}
+					EOrderAccess::release_store(&sizeCtl, sc);
+				}
+			}
+			else if (c <= sc || n >= CHM_MAXIMUM_CAPACITY)
+				break;
+			else if (tab == table) {
+				int rs = resizeStamp(n);
+				if (EUnsafe::compareAndSwapInt(&sizeCtl, sc, rs + 2))
+					transfer(tab, null);
+			}
+		}
 	}
-};
 
-//=============================================================================
-
-#define ECHM_DECLARE(K) template<typename V> \
-class EConcurrentHashMap<K, V>: public EConcurrentMap<K, V> { \
-public: \
-	class HashEntry { \
-	public: \
-		K key; \
-		sp<V> value; \
-		sp<HashEntry> next; \
-		int hash; \
- \
-		HashEntry(K key, int hash, \
-				sp<HashEntry>& next, \
-				sp<V> value) { \
-			this->key = key; \
-			this->hash = hash; \
-			this->next = next; \
-			this->value = value; \
-		} \
- \
-		static EA<sp<HashEntry> >* newArray(int i) { \
-			return NEWRC(EA<sp<HashEntry> >)(i); \
-		} \
-	}; \
- \
-	class Segment : public EReentrantLock { \
-	public: \
-		volatile int count; \
-		int modCount; \
-		int threshold; \
-		EA<sp<HashEntry> >* volatile table; \
-		float loadFactor; \
- \
-		EConcurrentHashMap<K,V>* chm; \
- \
-		~Segment() { \
-			DELRC(table); \
-		} \
- \
-		Segment(int initialCapacity, float lf, \
-				EConcurrentHashMap<K, V>* chm) : \
-				count(0), modCount(0), threshold(0), table(null), chm(chm) { \
-			loadFactor = lf; \
-			setTable(HashEntry::newArray(initialCapacity)); \
-		} \
- \
-		static EA<Segment*>* newArray(int i) { \
-			return new EA<Segment*>(i); \
-		} \
- \
-		void setTable(EA<sp<HashEntry> >* newTable) { \
-			threshold = (int)(newTable->length() * loadFactor); \
-			EA<sp<HashEntry> >* oldTable = GETRC(table); \
-			table = newTable; \
-			DELRC(oldTable); \
-		} \
- \
-		sp<HashEntry> getFirst(int hash) { \
-			EA<sp<HashEntry> >* tab = GETRC(table); \
-			sp<HashEntry> e = tab->atomicGet(hash & (tab->length() - 1)); \
-			DELRC(tab); \
-			return e; \
-		} \
- \
-		sp<V> readValueUnderLock(sp<HashEntry>& e) { \
-			sp<V> v; \
-			SYNCBLOCK(this) { \
-				v = atomic_load(&e->value); \
-            }} \
-			return v; \
-		} \
- \
-		sp<V> get(K key, int hash) { \
-			if (count != 0) { \
-				sp<HashEntry> e = getFirst(hash); \
-				while (e != null) { \
-					if (e->hash == hash && e->key == key) { \
-						sp<V> v = atomic_load(&e->value); \
-						if (v != null) \
-							return v; \
-						return readValueUnderLock(e); \
-					} \
-					e = e->next; \
-				} \
-			} \
-			return null; \
-		} \
- \
-		boolean containsKey(K key, int hash) { \
-			if (count != 0) { \
-				sp<HashEntry> e = getFirst(hash); \
-				while (e != null) { \
-					if (e->hash == hash && e->key == key) \
-						return true; \
-					e = e->next; \
-				} \
-			} \
-			return false; \
-		} \
- \
-		boolean containsValue(V* value) { \
-			if (count != 0) { \
-				EA<sp<HashEntry> >* tab = GETRC(table); \
-				int len = tab->length(); \
-				for (int i = 0 ; i < len; i++) { \
-					for (sp<HashEntry> e = tab->atomicGet(i); e != null; e = e->next) { \
-						sp<V> v = atomic_load(&e->value); \
-						if (v == null) \
-							v = readValueUnderLock(e); \
-						if (v->equals(value)) { \
-							DELRC(tab); \
-							return true; \
-						} \
-					} \
-				} \
-				DELRC(tab); \
-			} \
-			return false; \
-		} \
- \
-		boolean replace(K key, int hash, V* oldValue, sp<V> newValue) { \
-			boolean rv; \
- \
-			SYNCBLOCK(this) { \
-				sp<HashEntry> e = getFirst(hash); \
-				while (e != null && (e->hash != hash || e->key != key)) \
-					e = e->next; \
- \
-				boolean replaced = false; \
-				if (e != null && e->value->equals(oldValue)) { \
-					replaced = true; \
-					e->value = newValue; \
-				} \
-				rv = replaced; \
-            }} \
- \
-			return rv; \
-		} \
- \
-		sp<V> replace(K key, int hash, sp<V> newValue) { \
-			sp<V> rv; \
- \
-			SYNCBLOCK(this) { \
-				sp<HashEntry> e = getFirst(hash); \
-				while (e != null && (e->hash != hash || e->key != key)) \
-					e = e->next; \
- \
-				sp<V> oldValue = null; \
-				if (e != null) { \
-					oldValue = e->value; \
-					e->value = newValue; \
-				} \
-				rv = oldValue; \
-            }} \
- \
-			return rv; \
-		} \
- \
-		sp<V> put(K key, int hash, sp<V>& value, boolean onlyIfAbsent) { \
-			SYNCBLOCK(this) { \
-				int c = count; \
-				if (c++ > threshold) \
-					rehash(); \
-				EA<sp<HashEntry> >* tab = GETRC(table); \
-				int index = hash & (tab->length() - 1); \
-				sp<HashEntry> first = tab->atomicGet(index); \
-				sp<HashEntry> e = first; \
-				while (e != null && (e->hash != hash || (e->key != key))) \
-					e = e->next; \
- \
-				sp<V> oldValue; \
-				if (e != null) { \
-					oldValue = atomic_load(&e->value); \
-					if (!onlyIfAbsent) { \
-						atomic_store(&e->value, value); \
-					} \
-				} \
-				else { \
-					++modCount; \
-					sp<HashEntry> newEntry(new HashEntry(key, hash, first, value)); \
-					tab->atomicSet(index, newEntry); \
-					count = c; \
-				} \
-				DELRC(tab); \
-				return oldValue; \
-            }} \
-		} \
- \
-		void rehash() { \
-			EA<sp<HashEntry> >* oldTable = GETRC(table); \
-			int oldCapacity = oldTable->length(); \
-			if (oldCapacity >= CHM_MAXIMUM_CAPACITY) { \
-				DELRC(oldTable); \
-				return; \
-			} \
- \
-			EA<sp<HashEntry> >* newTable = HashEntry::newArray(oldCapacity<<1); \
-			threshold = (int)(newTable->length() * loadFactor); \
-			int sizeMask = newTable->length() - 1; \
-			for (int i = 0; i < oldCapacity ; i++) { \
-				sp<HashEntry> e = oldTable->atomicGet(i); \
- \
-				if (e != null) { \
-					sp<HashEntry> next = e->next; \
-					int idx = e->hash & sizeMask; \
- \
-					if (next == null) \
-						(*newTable)[idx] = e; \
- \
-					else { \
-						sp<HashEntry> lastRun = e; \
-						int lastIdx = idx; \
-						for (sp<HashEntry> last = next; \
-							 last != null; \
-							 last = last->next) { \
-							int k = last->hash & sizeMask; \
-							if (k != lastIdx) { \
-								lastIdx = k; \
-								lastRun = last; \
-							} \
-						} \
-						(*newTable)[lastIdx] = lastRun; \
- \
-						for (sp<HashEntry> p = e; p != lastRun; p = p->next) { \
-							int k = p->hash & sizeMask; \
-							sp<HashEntry> n = (*newTable)[k]; \
-							sp<HashEntry> newEntry(new HashEntry(p->key, p->hash, n, atomic_load(&p->value))); \
-							(*newTable)[k] = newEntry; \
-						} \
-					} \
-				} \
-			} \
-			table = newTable; \
- \
-			DELRC(oldTable); \
-			DELRC(oldTable); \
-		} \
- \
-		sp<V> remove(K key, int hash, V* value) { \
-			sp<V> rv; \
- \
-			SYNCBLOCK(this) { \
-				int c = count - 1; \
-				EA<sp<HashEntry> >* tab = GETRC(table); \
-				int index = hash & (tab->length() - 1); \
-				sp<HashEntry> first = tab->atomicGet(index); \
-				sp<HashEntry> e = first; \
-				while (e != null && (e->hash != hash || (key != e->key))) \
-					e = e->next; \
- \
-				sp<V> oldValue = null; \
-				if (e != null) { \
-					sp<V> v = atomic_load(&e->value); \
-					if (value == null || value->equals(v.get())) { \
-						oldValue = v; \
-						++modCount; \
-						sp<HashEntry> newFirst = e->next; \
-						for (sp<HashEntry> p = first; p != e; p = p->next) { \
-							newFirst = new HashEntry(p->key, p->hash, \
-													newFirst, atomic_load(&p->value)); \
-						} \
-						tab->atomicSet(index, newFirst); \
-						count = c; \
-					} \
-				} \
-				rv = oldValue; \
-				DELRC(tab); \
-            }} \
- \
-			return rv; \
-		} \
- \
-		void clear() { \
-			if (count != 0) { \
-				SYNCBLOCK(this) { \
-					EA<sp<HashEntry> >* tab = GETRC(table); \
-					for (int i = 0; i < tab->length() ; i++) { \
-						sp<HashEntry> nullPtr; \
-						tab->atomicSet(i, nullPtr); \
-					} \
-					++modCount; \
-					count = 0; \
-					DELRC(tab); \
-                }} \
-			} \
-		} \
-	}; \
- \
-	abstract class HashIterator { \
-		EConcurrentHashMap<K,V>* chm; \
-		int nextSegmentIndex; \
-		int nextTableIndex; \
-		EA<sp<HashEntry> >* currentTable; \
-		sp<HashEntry> nextEntry_; \
-		sp<HashEntry> lastReturned; \
- \
-		void advance() { \
-			if (nextEntry_ != null && (nextEntry_ = nextEntry_->next) != null) \
-				return; \
- \
-			while (nextTableIndex >= 0) { \
-				if ( (nextEntry_ = (*currentTable)[nextTableIndex--]) != null) \
-					return; \
-			} \
- \
-			while (nextSegmentIndex >= 0) { \
-				Segment* seg = (*chm->segments_)[nextSegmentIndex--]; \
-				if (seg->count != 0) { \
-					DELRC(currentTable); \
-					currentTable = GETRC(seg->table); \
-					for (int j = currentTable->length() - 1; j >= 0; --j) { \
-						if ( (nextEntry_ = (*currentTable)[j]) != null) { \
-							nextTableIndex = j - 1; \
-							return; \
-						} \
-					} \
-				} \
-			} \
-		} \
- \
-	public: \
-		HashIterator(EConcurrentHashMap<K,V>* chm) : chm(chm) { \
-			nextSegmentIndex = chm->segments_->length() - 1; \
-			nextTableIndex = -1; \
-			currentTable = null; \
-			advance(); \
-		} \
- \
-		virtual ~HashIterator() { \
-			DELRC(currentTable); \
-		} \
- \
-		sp<HashEntry> nextEntry() { \
-			if (nextEntry_ == null) \
-				throw ENoSuchElementException(__FILE__, __LINE__); \
-			lastReturned = nextEntry_; \
-			advance(); \
-			return lastReturned; \
-		} \
- \
-		boolean hasMoreElements() { \
-			return hasNext(); \
-		} \
- \
-		boolean hasNext() { \
-			return nextEntry_ != null; \
-		} \
- \
-		void remove() { \
-			if (lastReturned == null) \
-				throw EIllegalStateException(__FILE__, __LINE__); \
-			chm->remove(lastReturned->key); \
-			lastReturned = null; \
-		} \
-	}; \
- \
-	class KeyIterator: public HashIterator, public EConcurrentIterator< \
-	K>, public EConcurrentEnumeration<K> { \
-	public: \
-		KeyIterator(EConcurrentHashMap<K,V>* chm) : HashIterator(chm) {} \
-		boolean hasMoreElements()    { return HashIterator::hasMoreElements();  } \
-		boolean hasNext()            { return HashIterator::hasNext();          } \
-		K next()        { return HashIterator::nextEntry()->key; } \
-		K nextElement() { return HashIterator::nextEntry()->key; } \
-		void remove()                { HashIterator::remove();                  } \
-	}; \
- \
-	class ValueIterator: public HashIterator, public EConcurrentIterator< \
-	V>, public EConcurrentEnumeration<V> { \
-	public: \
-		ValueIterator(EConcurrentHashMap<K,V>* chm) : HashIterator(chm) {} \
-		boolean hasMoreElements()      { return HashIterator::hasMoreElements();  } \
-		boolean hasNext()              { return HashIterator::hasNext();          } \
-		sp<V> next()        { return HashIterator::nextEntry()->value; } \
-		sp<V> nextElement() { return HashIterator::nextEntry()->value; } \
-		void remove()                  { HashIterator::remove();                  } \
-	}; \
- \
-	class WriteThroughEntry: public EConcurrentMapEntry<K, V> { \
-	private: \
-		K key; \
-		sp<V> value; \
-		EConcurrentHashMap<K, V>* chm; \
- \
-		static boolean eq(EObject* o1, EObject* o2) { \
-			return o1 == null ? o2 == null : o1->equals(o2); \
-		} \
-	public: \
-		WriteThroughEntry(K key, sp<V>& value, \
-				EConcurrentHashMap<K, V>* chm) : chm(chm) { \
-			this->key = key; \
-			this->value = value; \
-		} \
- \
-		K getKey() { \
-			return key; \
-		} \
- \
-		sp<V> getValue() { \
-			return value; \
-		} \
- \
-		sp<V> setValue(sp<V> value) { \
-			if (value == null) \
-				throw ENullPointerException(__FILE__, __LINE__); \
- \
-			sp<V> oldValue = this->value; \
-			this->value = value; \
-			return oldValue; \
-		} \
- \
-		boolean equals(sp<EConcurrentMapEntry<K, V> > o) { \
-			return (key == o->getKey()) && eq(value.get(), o->getValue().get()); \
-		} \
- \
-		virtual int hashCode() { \
-			return (key) ^ \
-					(value == null ? 0 : value->hashCode()); \
-		} \
-	}; \
- \
-	class EntryIterator: public HashIterator, \
-	                     public EConcurrentIterator<EConcurrentMapEntry<K, V> > \
-	{ \
-	private: \
-		EConcurrentHashMap<K, V>* chm; \
-	public: \
-		EntryIterator(EConcurrentHashMap<K, V>* chm) : \
-				HashIterator(chm), chm(chm) { \
-		} \
-		sp<EConcurrentMapEntry<K, V> > next() { \
-			sp<HashEntry> e = HashIterator::nextEntry(); \
-			return new WriteThroughEntry(e->key, e->value, chm); \
-		} \
-		boolean hasNext() { \
-			return HashIterator::hasNext(); \
-		} \
-		void remove() { \
-			HashIterator::remove(); \
-		} \
-	}; \
- \
-	class KeySet : public EConcurrentSet<K> { \
-	private: \
-		EConcurrentHashMap<K,V>* chm; \
-	public: \
-		KeySet(EConcurrentHashMap<K,V>* chm) : chm(chm) { \
-		} \
-		sp<EConcurrentIterator<K> > iterator() { \
-			return new KeyIterator(chm); \
-		} \
-		int size() { \
-			return chm->size(); \
-		} \
-		boolean isEmpty() { \
-			return chm->isEmpty(); \
-		} \
-		boolean contains(K o) { \
-			return chm->containsKey(o); \
-		} \
-		boolean remove(K o) { \
-			return chm->remove(o) != null; \
-		} \
-		void clear() { \
-			chm->clear(); \
-		} \
-		boolean add(K e) { \
-			throw EUnsupportedOperationException(__FILE__, __LINE__); \
-		} \
-	}; \
- \
-	class Values : public EAbstractConcurrentCollection<V> { \
-	private: \
-		EConcurrentHashMap<K,V>* chm; \
-	public: \
-		Values(EConcurrentHashMap<K,V>* chm) : chm(chm) { \
-		} \
-		sp<EConcurrentIterator<V> > iterator() { \
-			return new ValueIterator(chm); \
-		} \
-		int size() { \
-			return chm->size(); \
-		} \
-		boolean isEmpty() { \
-			return chm->isEmpty(); \
-		} \
-		boolean contains(V* o) { \
-			return chm->containsValue(o); \
-		} \
-		void clear() { \
-			chm->clear(); \
-		} \
-	}; \
- \
-	class EntrySet : public EConcurrentSet<EConcurrentMapEntry<K,V> > { \
-	private: \
-		EConcurrentHashMap<K,V>* chm; \
-	public: \
-		EntrySet(EConcurrentHashMap<K,V>* chm) : chm(chm) { \
-		} \
-		sp<EConcurrentIterator<EConcurrentMapEntry<K,V> > > iterator() { \
-			return new EntryIterator(chm); \
-		} \
-		boolean contains(EConcurrentMapEntry<K,V>* e) { \
-			sp<V> v = chm->get(e->getKey()); \
-			return v != null && v->equals(e->getValue().get()); \
-		} \
-		boolean remove(EConcurrentMapEntry<K,V>* e) { \
-			return chm->remove(e->getKey(), e->getValue().get()); \
-		} \
-		int size() { \
-			return chm->size(); \
-		} \
-		boolean isEmpty() { \
-			return chm->isEmpty(); \
-		} \
-		void clear() { \
-			chm->clear(); \
-		} \
-		boolean add(EConcurrentMapEntry<K,V>* e) { \
-			throw EUnsupportedOperationException(__FILE__, __LINE__); \
-		} \
-		boolean add(sp<EConcurrentMapEntry<K,V> > e) { \
-			throw EUnsupportedOperationException(__FILE__, __LINE__); \
-		} \
-	}; \
- \
-public: \
-	~EConcurrentHashMap() { \
-		delete segments_; \
-	} \
- \
-	EConcurrentHashMap(int initialCapacity, float loadFactor, int concurrencyLevel) { \
-		init(initialCapacity, loadFactor, concurrencyLevel); \
-	} \
- \
-	EConcurrentHashMap(int initialCapacity, float loadFactor) { \
-		init(initialCapacity, loadFactor, CHM_DEFAULT_CONCURRENCY_LEVEL); \
-	} \
- \
-	EConcurrentHashMap(int initialCapacity) { \
-		init(initialCapacity, CHM_DEFAULT_LOAD_FACTOR, CHM_DEFAULT_CONCURRENCY_LEVEL); \
-	} \
- \
-	EConcurrentHashMap() { \
-		init(CHM_DEFAULT_INITIAL_CAPACITY, CHM_DEFAULT_LOAD_FACTOR, CHM_DEFAULT_CONCURRENCY_LEVEL); \
-	} \
- \
-	EConcurrentHashMap(EMap<K, V>* m) : \
-			segmentMask(0), segmentShift(0), segments_(null) { \
-		this(EMath::max((int) (m->size() / CHM_DEFAULT_LOAD_FACTOR) + 1, \
-						CHM_DEFAULT_INITIAL_CAPACITY), CHM_DEFAULT_LOAD_FACTOR, \
-				CHM_DEFAULT_CONCURRENCY_LEVEL); \
-		putAll(m); \
-	} \
- \
-	boolean isEmpty() { \
-		EA<Segment*>* segments = this->segments_; \
-		int* mc = new int[segments->length()](); \
-		int mcsum = 0; \
-		for (int i = 0; i < segments->length(); ++i) { \
-			if ((*segments)[i]->count != 0) { \
-				delete[] mc; \
-				return false; \
-			} else { \
-				mcsum += mc[i] = (*segments)[i]->modCount; \
-			} \
-		} \
-		if (mcsum != 0) { \
-			for (int i = 0; i < segments->length(); ++i) { \
-				if ((*segments)[i]->count != 0 || \
-					mc[i] != (*segments)[i]->modCount) { \
-					delete[] mc; \
-					return false; \
-				} \
-			} \
-		} \
-		delete[] mc; \
-		return true; \
-	} \
- \
-	int size() { \
-		EA<Segment*>* segments = this->segments_; \
-		long sum = 0; \
-		long check = 0; \
-		int* mc = new int[segments->length()](); \
-		for (int k = 0; k < CHM_RETRIES_BEFORE_LOCK; ++k) { \
-			check = 0; \
-			sum = 0; \
-			int mcsum = 0; \
-			for (int i = 0; i < segments->length(); ++i) { \
-				sum += (*segments)[i]->count; \
-				mcsum += mc[i] = (*segments)[i]->modCount; \
-			} \
-			if (mcsum != 0) { \
-				for (int i = 0; i < segments->length(); ++i) { \
-					check += (*segments)[i]->count; \
-					if (mc[i] != (*segments)[i]->modCount) { \
-						check = -1; \
-						break; \
-					} \
-				} \
-			} \
-			if (check == sum) \
-				break; \
-		} \
-		if (check != sum) { \
-			sum = 0; \
-			int i; \
-			for (i = 0; i < segments->length(); ++i) \
-				(*segments)[i]->lock(); \
-			for (i = 0; i < segments->length(); ++i) \
-				sum += (*segments)[i]->count; \
-			for (i = 0; i < segments->length(); ++i) \
-				(*segments)[i]->unlock(); \
-		} \
-		if (sum > EInteger::MAX_VALUE) { \
-			delete[] mc; \
-			return EInteger::MAX_VALUE; \
-		} \
-		else { \
-			delete[] mc; \
-			return (int)sum; \
-		} \
-	} \
- \
-	sp<V> get(K key) { \
-		int hash = hashIt(key); \
-		return segmentFor(hash)->get(key, hash); \
-	} \
- \
-	boolean containsKey(K key) { \
-		int hash = hashIt(key); \
-		return segmentFor(hash)->containsKey(key, hash); \
-	} \
- \
-	boolean containsValue(V* value) { \
-		if (value == null) \
-			throw ENullPointerException(__FILE__, __LINE__); \
- \
-		EA<Segment*>* segments = this->segments_; \
-		int* mc = new int[segments->length()](); \
- \
-		for (int k = 0; k < CHM_RETRIES_BEFORE_LOCK; ++k) { \
-			int mcsum = 0; \
-			for (int i = 0; i < segments->length(); ++i) { \
-				mcsum += mc[i] = (*segments)[i]->modCount; \
-				if ((*segments)[i]->containsValue(value)) { \
-					delete[] mc; \
-					return true; \
-				} \
-			} \
-			boolean cleanSweep = true; \
-			if (mcsum != 0) { \
-				for (int i = 0; i < segments->length(); ++i) { \
-					if (mc[i] != (*segments)[i]->modCount) { \
-						cleanSweep = false; \
-						break; \
-					} \
-				} \
-			} \
-			if (cleanSweep) { \
-				delete[] mc; \
-				return false; \
-			} \
-		} \
-		for (int i = 0; i < segments->length(); ++i) \
-			(*segments)[i]->lock(); \
-		boolean found = false; \
-		try { \
-			for (int i = 0; i < segments->length(); ++i) { \
-				if ((*segments)[i]->containsValue(value)) { \
-					found = true; \
-					break; \
-				} \
-			} \
-		} catch(...) { \
-			finally { \
-				for (int i = 0; i < segments->length(); ++i) \
-					(*segments)[i]->unlock(); \
-			} \
-			delete[] mc; \
-			throw; \
-		} finally { \
-			for (int i = 0; i < segments->length(); ++i) \
-				(*segments)[i]->unlock(); \
-		} \
-		delete[] mc; \
-		return found; \
-	} \
- \
-	boolean contains(V* value) { \
-		return containsValue(value); \
-	} \
- \
-	sp<V> put(K key, V* value) { \
-		K k(key); \
-		sp<V> v(value); \
-		return put(k, v); \
-	} \
-	sp<V> put(K key, sp<V> value) { \
-		if (value == null) \
-			throw ENullPointerException(__FILE__, __LINE__); \
-		int hash = hashIt(key); \
-		return segmentFor(hash)->put(key, hash, value, false); \
-	} \
- \
-	sp<V> putIfAbsent(K key, V* value) { \
-		K k(key); \
-		sp<V> v(value); \
-		return putIfAbsent(k, v); \
-	} \
-	sp<V> putIfAbsent(K key, sp<V> value) { \
-		if (value == null) \
-			throw ENullPointerException(__FILE__, __LINE__); \
-		int hash = hashIt(key); \
-		return segmentFor(hash)->put(key, hash, value, true); \
-	} \
- \
-	void putAll(EMap<K, V*>* m) { \
-		sp<EIterator<EMapEntry<K,V*>*> > it = m->entrySet()->iterator(); \
-		while (it->hasNext()) { \
-			EMapEntry<K,V*>* e = it->next(); \
-			put(e->getKey(), e->getValue()); \
-		} \
-	} \
- \
-	sp<V> remove(K key) { \
-		int hash = hashIt(key); \
-		return segmentFor(hash)->remove(key, hash, null); \
-	} \
- \
-	boolean remove(K key, V* value) { \
-		int hash = hashIt(key); \
-		if (value == null) \
-			return false; \
-		return segmentFor(hash)->remove(key, hash, value) != null; \
-	} \
- \
-	boolean replace(K key, V* oldValue, V* newValue) { \
-		sp<V> nv(newValue); \
-		return replace(key, oldValue, nv); \
-	} \
-	boolean replace(K key, V* oldValue, sp<V> newValue) { \
-		if (oldValue == null || newValue == null) \
-			throw ENullPointerException(__FILE__, __LINE__); \
-		int hash = hashIt(key); \
-		return segmentFor(hash)->replace(key, hash, oldValue, newValue); \
-	} \
- \
-	sp<V> replace(K key, V* value) { \
-		sp<V> v(value); \
-		return replace(key, v); \
-	} \
-	sp<V> replace(K key, sp<V> value) { \
-		if (value == null) \
-			throw ENullPointerException(__FILE__, __LINE__); \
-		int hash = hashIt(key); \
-		return segmentFor(hash)->replace(key, hash, value); \
-	} \
- \
-	void clear() { \
-		for (int i = 0; i < segments_->length(); ++i) \
-			(*segments_)[i]->clear(); \
-	} \
- \
-	sp<EConcurrentSet<K> > keySet() { \
-		if (!keySet_) { \
-			keySet_ = new KeySet(this); \
-		} \
-		return keySet_; \
-	} \
- \
-	sp<EConcurrentCollection<V> > values() { \
-		if (!values_) { \
-			values_ = new Values(this); \
-		} \
-		return values_; \
-	} \
- \
-	sp<EConcurrentSet<EConcurrentMapEntry<K,V> > > entrySet() { \
-		if (!entrySet_) { \
-			entrySet_ = new EntrySet(this); \
-		} \
-		return entrySet_; \
-	} \
- \
-	sp<EConcurrentEnumeration<K> > keys() { \
-		return new KeyIterator(this); \
-	} \
- \
-	sp<EConcurrentEnumeration<V> > elements() { \
-		return new ValueIterator(this); \
-	} \
- \
-protected: \
-	friend class HashIterator; \
-	int segmentMask; \
-	int segmentShift; \
-	EA<Segment*>* segments_; \
-	sp<EConcurrentSet<EConcurrentMapEntry<K,V> > > entrySet_; \
-	sp<EConcurrentSet<K> > keySet_; \
-	sp<EConcurrentCollection<V> > values_; \
- \
-private: \
- \
-	void init(int initialCapacity, float loadFactor, \
-			int concurrencyLevel) \
-	{ \
-		if (!(loadFactor > 0) || initialCapacity < 0 || concurrencyLevel <= 0) \
-			throw EIllegalArgumentException(__FILE__, __LINE__); \
- \
-		if (concurrencyLevel > CHM_MAX_SEGMENTS) \
-			concurrencyLevel = CHM_MAX_SEGMENTS; \
- \
-		int sshift = 0; \
-		int ssize = 1; \
-		while (ssize < concurrencyLevel) { \
-			++sshift; \
-			ssize <<= 1; \
-		} \
-		segmentShift = 32 - sshift; \
-		segmentMask = ssize - 1; \
-		this->segments_ = Segment::newArray(ssize); \
- \
-		if (initialCapacity > CHM_MAXIMUM_CAPACITY) \
-			initialCapacity = CHM_MAXIMUM_CAPACITY; \
-		int c = initialCapacity / ssize; \
-		if (c * ssize < initialCapacity) \
-			++c; \
-		int cap = 1; \
-		while (cap < c) \
-			cap <<= 1; \
- \
-		for (int i = 0; i < this->segments_->length(); ++i) \
-			(*this->segments_)[i] = new Segment(cap, loadFactor, this); \
-	} \
- \
-	static int hashIt(int h) { \
-		h += (h <<  15) ^ 0xffffcd7d; \
-		h ^= (((unsigned)h) >> 10); \
-		h += (h <<   3); \
-		h ^= (((unsigned)h) >>  6); \
-		h += (h <<   2) + (h << 14); \
-		return h ^ (((unsigned)h) >> 16); \
-	} \
- \
-	Segment* segmentFor(int hash) { \
-		return (*segments_)[(((unsigned)hash) >> segmentShift) & segmentMask]; \
-	} \
-};
+	/**
+	 * Moves and/or copies the nodes in each bin to new table. See
+	 * above for explanation.
+	 */
+	void transfer(Table* tab, Table* nextTab) {
+		int n = tab->length, stride;
+		int ncpu = chm::Reclaimer::getNCPU();
+		if ((stride = (ncpu > 1) ? (int)(((unsigned)n) >> 3) / ncpu : n) < CHM_MIN_TRANSFER_STRIDE)
+			stride = CHM_MIN_TRANSFER_STRIDE; // subdivide range
+		if (nextTab == null) {            // initiating
+			nextTab = newTable(n << 1);
+			tab->fwd = new ForwardingNode(nextTab);
+			EOrderAccess::release_store_ptr(&nextTable, nextTab);
+			EOrderAccess::release_store(&transferIndex, n);
+		}
+		int nextn = nextTab->length;
+		ForwardingNode* fwd = tab->fwd;
+		boolean advance = true;
+		boolean finishing = false; // to ensure sweep before committing nextTab
+		for (int i = 0, bound = 0;;) {
+			Node* f; int fh;
+			while (advance) {
+				int nextIndex, nextBound;
+				if (--i >= bound || finishing)
+					advance = false;
+				else if ((nextIndex = transferIndex) <= 0) {
+					i = -1;
+					advance = false;
+				}
+				else if (EUnsafe::compareAndSwapInt(&transferIndex, nextIndex,
+						nextBound = (nextIndex > stride ?
+									 nextIndex - stride : 0))) {
+					bound = nextBound;
+					i = nextIndex - 1;
+					advance = false;
+				}
+			}
+			if (i < 0 || i >= n || i + n >= nextn) {
+				int sc;
+				if (finishing) {
+					tab->prev = oldTables;
+					oldTables = tab;
+					EOrderAccess::release_store_ptr(&nextTable, null);
+					EOrderAccess::release_store_ptr(&table, nextTab);
+					EOrderAccess::release_store(&sizeCtl, (n << 1) - (int)(((unsigned)n) >> 1));
+					return;
+				}
+				if (((sc = sizeCtl), EUnsafe::compareAndSwapInt(&sizeCtl, sc, sc - 1))) {
+					if ((sc - 2) != resizeStamp(n))
+						return;
+					finishing = advance = true;
+					i = n; // recheck before commit
+				}
+			}
+			else if ((f = tabAt(tab, i)) == null)
+				advance = casTabAt(tab, i, null, fwd);
+			else if ((fh = f->hash) == CHM_MOVED)
+				advance = true; // already processed
+			else {
+				lockBin(f);
+				if (tabAt(tab, i) == f) {
+					Node* ln, *hn;
+					if (fh >= 0) {
+						int runBit = fh & n;
+						Node* lastRun = f;
+						for (Node* p = f->next; p != null; p = p->next) {
+							int b = p->hash & n;
+							if (b != runBit) {
+								runBit = b;
+								lastRun = p;
+							}
+						}
+						if (runBit == 0) {
+							ln = lastRun;
+							hn = null;
+						}
+						else {
+							hn = lastRun;
+							ln = null;
+						}
+						for (Node* p = f; p != lastRun; p = p->next) {
+							int ph = p->hash;
+							if ((ph & n) == 0)
+								ln = new Node(ph, p->key, p->val, ln);
+							else
+								hn = new Node(ph, p->key, p->val, hn);
+						}
+						setTabAt(nextTab, i, ln);
+						setTabAt(nextTab, i + n, hn);
+						setTabAt(tab, i, fwd);
+						for (Node* p = f; p != lastRun; p = p->next)
+							reclaimer.retire(p, &destroyShell);
+						advance = true;
+					}
+					else if (fh == CHM_TREEBIN) {
+						TreeBin* t = (TreeBin*)f;
+						TreeNode* lo = null, *loTail = null;
+						TreeNode* hi = null, *hiTail = null;
+						int lc = 0, hc = 0;
+						for (Node* e = t->first; e != null; e = e->next) {
+							int h = e->hash;
+							TreeNode* p = new TreeNode(h, e->key, e->val, null, null);
+							if ((h & n) == 0) {
+								if ((p->prev = loTail) == null)
+									lo = p;
+								else
+									loTail->next = p;
+								loTail = p;
+								++lc;
+							}
+							else {
+								if ((p->prev = hiTail) == null)
+									hi = p;
+								else
+									hiTail->next = p;
+								hiTail = p;
+								++hc;
+							}
+						}
+						if (lc <= CHM_UNTREEIFY_THRESHOLD) {
+							ln = untreeify(lo);
+							destroyTreeShells(lo);
+						}
+						else if (hc != 0)
+							ln = new TreeBin(lo);
+						else {
+							ln = t;
+							destroyTreeShells(lo);
+						}
+						if (hc <= CHM_UNTREEIFY_THRESHOLD) {
+							hn = untreeify(hi);
+							destroyTreeShells(hi);
+						}
+						else if (lc != 0)
+							hn = new TreeBin(hi);
+						else {
+							hn = t;
+							destroyTreeShells(hi);
+						}
+						setTabAt(nextTab, i, ln);
+						setTabAt(nextTab, i + n, hn);
+						setTabAt(tab, i, fwd);
+						if (ln != t && hn != t)
+							reclaimer.retire(t, &destroyTreeBinShell);
+						advance = true;
+					}
+				}
+				unlockBin(f);
+			}
+		}
+	}
+
+	/* ---------------- Counter support -------------- */
+
+	llong sumCount() {
+		CounterCells* as = counterCells; CounterCell* a;
+		llong sum = baseCount;
+		if (as != null) {
+			for (int i = 0; i < as->length; ++i) {
+				if ((a = as->cells[i]) != null)
+					sum += a->value;
+			}
+		}
+		return sum;
+	}
 
-ECHM_DECLARE(byte)
-ECHM_DECLARE(char)
-ECHM_DECLARE(int)
-ECHM_DECLARE(short)
-ECHM_DECLARE(long)
-ECHM_DECLARE(llong)
-ECHM_DECLARE(float)
-ECHM_DECLARE(double)
+	/**
+	 * Computes initial batch value for bulk tasks. The returned value
+	 * is approximately exp2 of the number of times (minus one) to
+	 * split task by two before executing leaf action. This value is
+	 * faster to compute and more convenient to use as a guide to
+	 * splitting than is the depth, since it is used while dividing by
+	 * two anyway.
+	 */
+	int batchFor(llong b) {
+		llong n;
+		if (b == ELLong::MAX_VALUE || (n = mappingCount()) <= 1L || n < b)
+			return 0;
+		int par = EForkJoinPool::getCommonPoolParallelism() << 2; // slack of 4
+		return (b <= 0L || (n /= b) >= par) ? par : (int)n;
+	}
+
+	static CounterCells* newCells(int n) {
+		CounterCells* cs = (CounterCells*)eso_calloc(sizeof(CounterCells) +
+				(n - 1) * sizeof(CounterCell*));
+		cs->length = n;
+		return cs;
+	}
+
+	// See LongAdder version for explanation
+	void fullAddCount(llong x, boolean wasUncontended) {
+		int h;
+		if ((h = EThreadLocalRandom::getProbe()) == 0) {
+			EThreadLocalRandom::localInit();      // force initialization
+			h = EThreadLocalRandom::getProbe();
+			wasUncontended = true;
+		}
+		int ncpu = chm::Reclaimer::getNCPU();
+		boolean collide = false;                // True if last slot nonempty
+		for (;;) {
+			CounterCells* as; CounterCell* a; int n; llong v;
+			if ((as = counterCells) != null && (n = as->length) > 0) {
+				if ((a = as->cells[(n - 1) & h]) == null) {
+					if (cellsBusy == 0) {            // Try to attach new Cell
+						if (cellsBusy == 0 &&
+							EUnsafe::compareAndSwapInt(&cellsBusy, 0, 1)) {
+							boolean created = false;
+							CounterCells* rs; int m, j;
+							if ((rs = counterCells) != null &&
+								(m = rs->length) > 0 &&
+								rs->cells[j = (m - 1) & h] == null) {
+								EOrderAccess::release_store_ptr(&rs->cells[j], new CounterCell(x));
+								created = true;
+							}
+							EOrderAccess::release_store(&cellsBusy, 0);
+							if (created)
+								break;
+							continue;           // Slot is now non-empty
+						}
+					}
+					collide = false;
+				}
+				else if (!wasUncontended)       // CAS already known to fail
+					wasUncontended = true;      // Continue after rehash
+				else if (((v = a->value), EUnsafe::compareAndSwapLLong(&a->value, v, v + x)))
+					break;
+				else if (counterCells != as || n >= ncpu)
+					collide = false;            // At max size or stale
+				else if (!collide)
+					collide = true;
+				else if (cellsBusy == 0 &&
+						 EUnsafe::compareAndSwapInt(&cellsBusy, 0, 1)) {
+					if (counterCells == as) {// Expand table unless stale
+						CounterCells* rs = newCells(n << 1);
+						for (int i = 0; i < n; ++i)
+							rs->cells[i] = as->cells[i];
+						EOrderAccess::release_store_ptr(&counterCells, rs);
+						reclaimer.retire(as, &destroyCells);
+					}
+					EOrderAccess::release_store(&cellsBusy, 0);
+					collide = false;
+					continue;                   // Retry with expanded table
+				}
+				h = EThreadLocalRandom::advanceProbe(h);
+			}
+			else if (cellsBusy == 0 && counterCells == as &&
+					 EUnsafe::compareAndSwapInt(&cellsBusy, 0, 1)) {
+				boolean init = false;
+				if (counterCells == as) {
+					CounterCells* rs = newCells(2);
+					rs->cells[h & 1] = new CounterCell(x);
+					EOrderAccess::release_store_ptr(&counterCells, rs);
+					init = true;
+				}
+				EOrderAccess::release_store(&cellsBusy, 0);
+				if (init)
+					break;
+			}
+			else if (((v = baseCount), EUnsafe::compareAndSwapLLong(&baseCount, v, v + x)))
+				break;                          // Fall back on using base
+		}
+	}
+
+	/* ---------------- Conversion from/to TreeBins -------------- */
+
+	/**
+	 * Replaces all linked nodes in bin at given index unless table is
+	 * too small, in which case resizes instead.
+	 */
+	void treeifyBin(Table* tab, int index) {
+		Node* b; int n;
+		if (tab != null) {
+			if ((n = tab->length) < CHM_MIN_TREEIFY_CAPACITY)
+				tryPresize(n << 1);
+			else if ((b = tabAt(tab, index)) != null && b->hash >= 0) {
+				lockBin(b);
+				if (tabAt(tab, index) == b) {
+					TreeNode* hd = null, *tl = null;
+					for (Node* e = b; e != null; e = e->next) {
+						TreeNode* p = new TreeNode(e->hash, e->key, e->val, null, null);
+						if ((p->prev = tl) == null)
+							hd = p;
+						else
+							tl->next = p;
+						tl = p;
+					}
+					setTabAt(tab, index, new TreeBin(hd));
+					for (Node* e = b; e != null; e = e->next)
+						reclaimer.retire(e, &destroyShell);
+				}
+				unlockBin(b);
+			}
+		}
+	}
+
+	/**
+	 * Returns a list on non-TreeNodes replacing those in given list.
+	 * The value boxes move to the new nodes.
+	 */
+	static Node* untreeify(Node* b) {
+		Node* hd = null, *tl = null;
+		for (Node* q = b; q != null; q = q->next) {
+			Node* p = new Node(q->hash, q->key, q->val, null);
+			if (tl == null)
+				hd = p;
+			else
+				tl->next = p;
+			tl = p;
+		}
+		return hd;
+	}
+
+	sp<EConcurrentIterator<K> > newKeyIterator() {
+		Table* t = (Table*)EOrderAccess::load_ptr_acquire(&table);
+		int f = (t == null) ? 0 : t->length;
+		return new KeyIterator(this, t, f);
+	}
+
+	sp<EConcurrentIterator<V> > newValueIterator() {
+		Table* t = (Table*)EOrderAccess::load_ptr_acquire(&table);
+		int f = (t == null) ? 0 : t->length;
+		return new ValueIterator(this, t, f);
+	}
+
+	sp<EConcurrentIterator<EConcurrentMapEntry<K,V> > > newEntryIterator() {
+		Table* t = (Table*)EOrderAccess::load_ptr_acquire(&table);
+		int f = (t == null) ? 0 : t->length;
+		return new EntryIterator(this, t, f);
+	}
+};
 
 } /* namespace efc */
 #endif /* ECONCURRENTHASHMAP_HH_ */
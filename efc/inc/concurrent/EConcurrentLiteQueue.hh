@@ -10,6 +10,7 @@
 
 #include "../ESpinLock.hh"
 #include "./EAtomicCounter.hh"
+#include "./EPadded.hh"
 #include "./EConcurrentQueue.hh"
 #include "../ENoSuchElementException.hh"
 #include "../ENullPointerException.hh"
@@ -102,7 +103,7 @@ public:
 		tl.lock();
 			tail->next = node;
 			tail = node;
-			size_++;
+			(*size_)++;
 		tl.unlock();
 		return true;
     }
@@ -120,7 +121,7 @@ public:
 			v = new_head->value;
 			head = new_head;
 			head->value = null;
-			size_--;
+			(*size_)--;
 		hl.unlock();
 		delete node;
 		return v;
@@ -169,7 +170,7 @@ public:
      * @return the number of elements in this queue
      */
     int size() {
-        return size_.value();
+        return size_->value();
     }
 
     /**
@@ -262,19 +263,27 @@ public:
 	}
 
 private:
+	/*
+	 * Consumers write head, producers write tail, and both sides
+	 * update size_, which is padded and sits between the two, so the
+	 * pointers stay on separate cache lines.  hl and tl are handles;
+	 * the spin state they guard is allocated by the lock itself.
+	 */
+
+	LOCK hl;
+
     /**
 	 * Pointer to header node, initialized to a dummy node.  The first
 	 * actual node is at head.getNext().
 	 */
 	Node *head;
 
-	/** Pointer to last node on list **/
-	Node* tail;// = head;
+	EPadded<EAtomicCounter> size_;
 
-	LOCK hl;
 	LOCK tl;
 
-	EAtomicCounter size_;
+	/** Pointer to last node on list **/
+	Node* tail;// = head;
 };
 
 } /* namespace efc */
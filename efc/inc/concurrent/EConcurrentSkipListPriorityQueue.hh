@@ -0,0 +1,563 @@
+/*
+ * EConcurrentSkipListPriorityQueue.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ECONCURRENTSKIPLISTPRIORITYQUEUE_HH_
+#define ECONCURRENTSKIPLISTPRIORITYQUEUE_HH_
+
+#include "../EArrayList.hh"
+#include "../EInteger.hh"
+#include "../EComparator.hh"
+#include "../EComparable.hh"
+#include "./EConcurrentQueue.hh"
+#include "./EEpochManager.hh"
+#include "./ELongAdder.hh"
+#include "./EOrderAccess.hh"
+#include "./EThreadLocalRandom.hh"
+#include "./EUnsafe.hh"
+#include "../EClassCastException.hh"
+#include "../ENullPointerException.hh"
+#include "../ENoSuchElementException.hh"
+#include "../EIllegalStateException.hh"
+
+namespace efc {
+
+/**
+ * An unbounded lock-free priority queue backed by a skip list, for
+ * many threads inserting and removing at once.  Elements are ordered
+ * by the given comparator, or by their {@link EComparable} natural
+ * ordering; the head of the queue is the least element.  Null
+ * elements are not permitted.
+ *
+ * <p>This is the priority queue of Lindén and Jonsson ("A Skiplist-
+ * Based Concurrent Priority Queue with Minimal Memory Contention",
+ * 2013).  Removing the head only marks the lowest bit of the link to
+ * it, so the removed elements form a prefix of the bottom list that
+ * inserts step over.  The prefix is cut off with one CAS on the head
+ * once it is longer than a bound, and its nodes are then reclaimed
+ * through {@link EEpochManager}.  Most removals therefore write one
+ * word, and no two operations ever wait for each other.
+ *
+ * <p>When the queue is created with a {@code sprayThreads} hint
+ * greater than one, {@link #poll} is <em>relaxed</em> as in the
+ * SprayList of Alistarh et al. (2015): it starts a random walk a few
+ * levels up the skip list and claims the first free element where the
+ * walk lands, which is among the O(p log p) least elements for
+ * {@code p} threads.  Concurrent pollers then take different elements
+ * instead of all competing for the head.  {@link #pollFirst} always
+ * removes the least element.
+ *
+ * <p>Elements of equal priority are not ordered.  {@link #remove(E*)}
+ * and iterator removal take the element out at once; its node is
+ * reclaimed when the head passes it.  Iterators return the elements
+ * present when they were created, in ascending order.  {@link #size}
+ * is a sum over striped counters and is only an estimate while the
+ * queue changes.
+ *
+ * @param <E> the type of elements held in this collection
+ */
+
+template<typename E>
+class EConcurrentSkipListPriorityQueue: public EConcurrentQueue<E> {
+public:
+	virtual ~EConcurrentSkipListPriorityQueue() {
+		Node* p = unmarked(head->next[0]);
+		while (p != null) {
+			Node* n = unmarked(p->next[0]);
+			delete p;
+			p = n;
+		}
+		delete head;
+	}
+
+	/**
+	 * Creates an empty queue.
+	 *
+	 * @param comparator the comparator that will be used to order this
+	 *        queue, or null for the natural ordering of the elements
+	 * @param sprayThreads the expected number of concurrent pollers for
+	 *        a relaxed {@link #poll}, or 0 for an exact one
+	 */
+	explicit EConcurrentSkipListPriorityQueue(EComparator<E*>* comparator = null,
+			int sprayThreads = 0) :
+			comparator(comparator), em(EEpochManager::getInstance()),
+			sprayHeight(0), sprayJump(0) {
+		head = new Node(null, MAX_LEVEL);
+		head->inserting = 0;
+		if (sprayThreads > 1) {
+			int log = 0;
+			while ((1 << (log + 1)) <= sprayThreads && log < MAX_LEVEL - 2)
+				log++;
+			sprayHeight = log + 1;
+			sprayJump = log + 1;
+		}
+	}
+
+	boolean add(E* e) {
+		return offer(e);
+	}
+	boolean add(sp<E> e) {
+		return offer(e);
+	}
+
+	/**
+	 * Inserts the specified element into this queue.  As the queue is
+	 * unbounded, this method will never return {@code false}.
+	 *
+	 * @throws ClassCastException if the element cannot be compared
+	 * @throws NullPointerException if the specified element is null
+	 */
+	boolean offer(E* e) {
+		sp<E> x(e);
+		return offer(x);
+	}
+	boolean offer(sp<E> e) {
+		if (e == null) throw ENullPointerException(__FILE__, __LINE__);
+		Node* preds[MAX_LEVEL];
+		Node* succs[MAX_LEVEL];
+		int height = randomLevel();
+		Node* n = new Node(e, height);
+		EEpochManager::Guard g(em);
+		Node* del;
+		for (;;) {
+			del = locatePreds(e.get(), preds, succs);
+			n->next[0] = succs[0];
+			if (casNext(preds[0], 0, succs[0], n))
+				break;
+		}
+		// the element is in; the index levels are only shortcuts
+		for (int i = 1; i < height; i++) {
+			for (;;) {
+				n->next[i] = succs[i];
+				if (isMarked(n->next[0]) ||
+						(succs[i] != null && (isMarked(succs[i]->next[0]) || del == succs[i])))
+					goto DONE;
+				if (casNext(preds[i], i, succs[i], n))
+					break;
+				del = locatePreds(e.get(), preds, succs);
+				if (succs[0] != n)
+					goto DONE;
+			}
+		}
+		DONE:
+		EOrderAccess::release_store(&n->inserting, 0);
+		count.increment();
+		return true;
+	}
+
+	/**
+	 * Retrieves and removes the head of this queue, or returns
+	 * {@code null} if this queue is empty.  If the queue was created
+	 * with a {@code sprayThreads} hint, the element removed is one of
+	 * the least elements rather than the least.
+	 */
+	sp<E> poll() {
+		if (sprayHeight == 0)
+			return pollFirst();
+		sp<E> x = spray();
+		return (x != null) ? x : pollFirst();
+	}
+
+	/**
+	 * Retrieves and removes the least element of this queue, or
+	 * returns {@code null} if this queue is empty.
+	 */
+	sp<E> pollFirst() {
+		sp<E> result;
+		EEpochManager::Guard g(em);
+		Node* x = head;
+		Node* obshead = head->next[0];
+		Node* newhead = null;
+		int offset = 0;
+		for (;;) {
+			Node* nxt = x->next[0];
+			Node* c = unmarked(nxt);
+			if (c == null)
+				return null;
+			if (newhead == null && x->inserting)
+				newhead = x;
+			if (isMarked(nxt)) { // c has been removed
+				offset++;
+				x = c;
+				continue;
+			}
+			if (!casNext(x, 0, nxt, marked(nxt)))
+				continue; // an insert got in before c
+			offset++;
+			x = c;
+			// the mark made c part of the removed prefix; it is ours
+			// unless an out-of-order removal took it first
+			if (c->claim()) {
+				result = c->item;
+				break;
+			}
+		}
+		count.decrement();
+		if (offset > BOUND_OFFSET)
+			cutPrefix(obshead, (newhead != null) ? newhead : x);
+		return result;
+	}
+
+	/**
+	 * Retrieves, but does not remove, the least element of this queue,
+	 * or returns {@code null} if this queue is empty.
+	 */
+	sp<E> peek() {
+		EEpochManager::Guard g(em);
+		Node* c = firstNode();
+		return (c != null) ? c->item : null;
+	}
+
+	sp<E> remove() {
+		sp<E> x = poll();
+		if (x == null) throw ENoSuchElementException(__FILE__, __LINE__);
+		return x;
+	}
+
+	sp<E> element() {
+		sp<E> x = peek();
+		if (x == null) throw ENoSuchElementException(__FILE__, __LINE__);
+		return x;
+	}
+
+	int size() {
+		llong n = count.sum();
+		return (n < 0) ? 0 : (n > EInteger::MAX_VALUE ? EInteger::MAX_VALUE : (int)n);
+	}
+
+	boolean isEmpty() {
+		return peek() == null;
+	}
+
+	boolean contains(E* o) {
+		if (o == null) return false;
+		EEpochManager::Guard g(em);
+		for (Node* c = firstNode(); c != null; c = unmarked(c->next[0])) {
+			if (!c->taken && o->equals(c->item.get()))
+				return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Removes a single instance of the specified element from this
+	 * queue, if it is present.
+	 *
+	 * @return {@code true} if this queue changed as a result of the call
+	 */
+	boolean remove(E* o) {
+		if (o == null) return false;
+		EEpochManager::Guard g(em);
+		for (Node* c = firstNode(); c != null; c = unmarked(c->next[0])) {
+			if (!c->taken && o->equals(c->item.get()) && c->claim()) {
+				count.decrement();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void clear() {
+		while (pollFirst() != null)
+			;
+	}
+
+	sp<EConcurrentIterator<E> > iterator() {
+		return new Itr(this);
+	}
+
+	/**
+	 * Returns the elements of this queue in ascending order.
+	 */
+	EA<sp<E> > toArray() {
+		EArrayList<sp<E> > al;
+		EEpochManager::Guard g(em);
+		for (Node* c = firstNode(); c != null; c = unmarked(c->next[0])) {
+			if (!c->taken)
+				al.add(c->item);
+		}
+		return al.toArray();
+	}
+
+	/**
+	 * Returns the comparator used to order the elements, or null if
+	 * they use their natural ordering.
+	 */
+	EComparator<E*>* getComparator() {
+		return comparator;
+	}
+
+private:
+	static const int MAX_LEVEL = 24;
+
+	/**
+	 * Length of removed prefix at which a remover cuts it off.  Longer
+	 * prefixes mean fewer writes to the head but longer walks.
+	 */
+	static const int BOUND_OFFSET = 32;
+
+	/**
+	 * Nodes are linked at the bottom level through next[0], whose
+	 * lowest bit set means that the successor has been removed.  The
+	 * index links next[1..] are never marked.
+	 */
+	struct Node {
+		sp<E> item; // immutable, released when the node is freed
+		Node* volatile* next;
+		int level;
+		volatile int taken;
+		volatile int inserting;
+
+		Node(sp<E> item, int level) :
+				item(item), level(level), taken(0), inserting(1) {
+			next = new Node* volatile[level];
+			for (int i = 0; i < level; i++)
+				next[i] = null;
+		}
+		~Node() {
+			delete[] next;
+		}
+
+		boolean claim() {
+			return taken == 0 && EUnsafe::compareAndSwapInt(&taken, 0, 1);
+		}
+	};
+
+	class Itr: public EConcurrentIterator<E> {
+	public:
+		Itr(EConcurrentSkipListPriorityQueue* queue) :
+				queue(queue), items(queue->toArray()), index(0) {
+		}
+
+		boolean hasNext() {
+			return index < items.length();
+		}
+
+		sp<E> next() {
+			if (index >= items.length()) throw ENoSuchElementException(__FILE__, __LINE__);
+			lastRet = items[index++];
+			return lastRet;
+		}
+
+		void remove() {
+			if (lastRet == null) throw EIllegalStateException(__FILE__, __LINE__);
+			queue->removeSame(lastRet.get());
+			lastRet = null;
+		}
+
+	private:
+		EConcurrentSkipListPriorityQueue* queue;
+		EA<sp<E> > items;
+		int index;
+		sp<E> lastRet;
+	};
+
+	EComparator<E*>* comparator;
+	EEpochManager* em;
+	Node* head;
+	ELongAdder count;
+	int sprayHeight;
+	int sprayJump;
+
+	static boolean isMarked(Node* p) {
+		return ((es_intptr_t)p & 1) != 0;
+	}
+
+	static Node* unmarked(Node* p) {
+		return (Node*)((es_intptr_t)p & ~(es_intptr_t)1);
+	}
+
+	static Node* marked(Node* p) {
+		return (Node*)((es_intptr_t)p | 1);
+	}
+
+	static boolean casNext(Node* node, int level, Node* cmp, Node* val) {
+		return EUnsafe::compareAndSwapObject(&node->next[level], cmp, val);
+	}
+
+	int cpr(E* x, E* y) {
+		if (comparator != null)
+			return comparator->compare(x, y);
+		EComparable<E*>* cc = dynamic_cast<EComparable<E*>*>(x);
+		if (!cc) throw EClassCastException(__FILE__, __LINE__);
+		return cc->compareTo(y);
+	}
+
+	/**
+	 * Returns a height in [1, MAX_LEVEL] with geometric distribution.
+	 */
+	static int randomLevel() {
+		unsigned int rnd = (unsigned int)EThreadLocalRandom::current()->nextInt();
+		int level = 1;
+		while ((rnd & 1) != 0 && level < MAX_LEVEL) {
+			level++;
+			rnd >>= 1;
+		}
+		return level;
+	}
+
+	/**
+	 * Fills in the predecessors and successors of a new element at
+	 * every level.  At the bottom level the walk steps over the removed
+	 * prefix, so an element is never linked behind a removed one.
+	 *
+	 * @return the last removed node seen, or null
+	 */
+	Node* locatePreds(E* e, Node** preds, Node** succs) {
+		Node* pred = head;
+		Node* del = null;
+		for (int i = MAX_LEVEL - 1; i >= 0; i--) {
+			Node* cur = pred->next[i];
+			boolean d = isMarked(cur);
+			cur = unmarked(cur);
+			while (cur != null && ((d && i == 0) || isMarked(cur->next[0]) ||
+					cpr(cur->item.get(), e) < 0)) {
+				if (d && i == 0)
+					del = cur;
+				pred = cur;
+				cur = pred->next[i];
+				d = isMarked(cur);
+				cur = unmarked(cur);
+			}
+			preds[i] = pred;
+			succs[i] = cur;
+		}
+		return del;
+	}
+
+	/**
+	 * Returns the first node after the removed prefix that has not been
+	 * taken out of order, or null.
+	 */
+	Node* firstNode() {
+		Node* x = head;
+		for (;;) {
+			Node* nxt = x->next[0];
+			Node* c = unmarked(nxt);
+			if (c == null)
+				return null;
+			if (!isMarked(nxt) && !c->taken)
+				return c;
+			x = c;
+		}
+	}
+
+	/**
+	 * Unlinks the removed prefix from the head, and retires its nodes
+	 * up to {@code newhead}, which stays as the last removed node.
+	 * Nodes still being inserted are never retired, since their
+	 * inserter may yet link them at higher levels.
+	 */
+	void cutPrefix(Node* obshead, Node* newhead) {
+		if (!casNext(head, 0, obshead, marked(newhead)))
+			return; // another remover did it
+		restructure();
+		Node* cur = unmarked(obshead);
+		while (cur != newhead) {
+			Node* n = unmarked(cur->next[0]);
+			em->retire(cur);
+			cur = n;
+		}
+	}
+
+	/**
+	 * Moves the index links of the head past the removed prefix.
+	 */
+	void restructure() {
+		Node* pred = head;
+		for (int i = MAX_LEVEL - 1; i > 0;) {
+			Node* h = head->next[i];
+			if (h == null || !isMarked(h->next[0])) {
+				i--;
+				continue;
+			}
+			Node* cur = pred->next[i];
+			while (cur != null && isMarked(cur->next[0])) {
+				pred = cur;
+				cur = pred->next[i];
+			}
+			if (casNext(head, i, h, cur))
+				i--;
+		}
+	}
+
+	/**
+	 * Relaxed removal: walks sprayHeight levels down from the head,
+	 * jumping a random number of nodes on each level, and claims the
+	 * first free node from where the walk lands.
+	 */
+	sp<E> spray() {
+		EThreadLocalRandom* rnd = EThreadLocalRandom::current();
+		EEpochManager::Guard g(em);
+		Node* x = head;
+		for (int i = sprayHeight - 1; i >= 0; i--) {
+			for (int j = rnd->nextInt(sprayJump + 1); j > 0; j--) {
+				Node* n = unmarked(x->next[i]);
+				if (n == null)
+					break;
+				x = n;
+			}
+		}
+		Node* c = (x == head) ? unmarked(head->next[0]) : x;
+		for (; c != null; c = unmarked(c->next[0])) {
+			if (c->claim()) {
+				sp<E> r = c->item;
+				count.decrement();
+				markTaken();
+				return r;
+			}
+		}
+		return null;
+	}
+
+	/**
+	 * Appends the nodes taken out of order at the front to the removed
+	 * prefix, and cuts the prefix off when it is long, as pollFirst
+	 * does; without this only pollFirst would ever reclaim nodes.
+	 */
+	void markTaken() {
+		Node* x = head;
+		Node* obshead = head->next[0];
+		Node* newhead = null;
+		int offset = 0;
+		for (;;) {
+			Node* nxt = x->next[0];
+			Node* c = unmarked(nxt);
+			if (c == null)
+				break;
+			if (newhead == null && x->inserting)
+				newhead = x;
+			if (!isMarked(nxt)) {
+				if (!c->taken)
+					break;
+				if (!casNext(x, 0, nxt, marked(nxt)))
+					continue;
+			}
+			offset++;
+			x = c;
+		}
+		if (offset > BOUND_OFFSET)
+			cutPrefix(obshead, (newhead != null) ? newhead : x);
+	}
+
+	boolean removeSame(E* o) {
+		EEpochManager::Guard g(em);
+		for (Node* c = firstNode(); c != null; c = unmarked(c->next[0])) {
+			if (c->item.get() == o && c->claim()) {
+				count.decrement();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// unsupported.
+	EConcurrentSkipListPriorityQueue(const EConcurrentSkipListPriorityQueue&);
+	EConcurrentSkipListPriorityQueue& operator=(const EConcurrentSkipListPriorityQueue&);
+};
+
+} /* namespace efc */
+#endif /* ECONCURRENTSKIPLISTPRIORITYQUEUE_HH_ */
@@ -105,11 +105,8 @@ public:
 	 * @return the number of elements in this list
 	 */
 	int size() {
-		int n;
-		EA<sp<E> >* elements = GETRC(array_);
-		n = elements->length();
-		DELRC(elements);
-		return n;
+		ERCGuard<EA<sp<E> > > elements(array_);
+		return elements->length();
 	}
 
 	/**
@@ -131,20 +128,16 @@ public:
 	 * @return <tt>true</tt> if this list contains the specified element
 	 */
 	boolean contains(E* o) {
-		EA<sp<E> >* elements = GETRC(array_);
-		boolean b = (indexOf(o, elements, 0, elements->length()) >= 0);
-		DELRC(elements);
-		return b;
+		ERCGuard<EA<sp<E> > > elements(array_);
+		return (indexOf(o, elements.get(), 0, elements->length()) >= 0);
 	}
 
 	/**
 	 * {@inheritDoc}
 	 */
 	int indexOf(E* o) {
-		EA<sp<E> >* elements = GETRC(array_);
-		int i = indexOf(o, elements, 0, elements->length());
-		DELRC(elements);
-		return i;
+		ERCGuard<EA<sp<E> > > elements(array_);
+		return indexOf(o, elements.get(), 0, elements->length());
 	}
 
 	/**
@@ -163,20 +156,16 @@ public:
 	 * @throws IndexOutOfBoundsException if the specified index is negative
 	 */
 	int indexOf(E* e, int index) {
-		EA<sp<E> >* elements = GETRC(array_);
-		int i = indexOf(e, elements, index, elements->length());
-		DELRC(elements);
-		return i;
+		ERCGuard<EA<sp<E> > > elements(array_);
+		return indexOf(e, elements.get(), index, elements->length());
 	}
 
 	/**
 	 * {@inheritDoc}
 	 */
 	int lastIndexOf(E* o) {
-		EA<sp<E> >* elements = GETRC(array_);
-		int i = lastIndexOf(o, elements, elements->length() - 1);
-		DELRC(elements);
-		return i;
+		ERCGuard<EA<sp<E> > > elements(array_);
+		return lastIndexOf(o, elements.get(), elements->length() - 1);
 	}
 
 	/**
@@ -196,10 +185,8 @@ public:
 	 *         than or equal to the current size of this list
 	 */
 	int lastIndexOf(E* e, int index) {
-		EA<sp<E> >* elements = GETRC(array_);
-		int i = lastIndexOf(e, elements, index);
-		DELRC(elements);
-		return i;
+		ERCGuard<EA<sp<E> > > elements(array_);
+		return lastIndexOf(e, elements.get(), index);
 	}
 
 	/**
@@ -226,12 +213,11 @@ public:
 	 * @return an array containing all the elements in this list
 	 */
 	EA<sp<E> > toArray() {
-		EA<sp<E> >* elements = GETRC(array_);
+		ERCGuard<EA<sp<E> > > elements(array_);
 		EArrayList<sp<E> > r(elements->length());
 		for (int i=0; i<elements->length(); i++) {
 			r.add((*elements)[i]);
 		}
-		DELRC(elements);
 		return r.toArray();
 	}
 
@@ -241,11 +227,8 @@ public:
 	 * @throws IndexOutOfBoundsException {@inheritDoc}
 	 */
 	sp<E> getAt(int index) {
-		sp<E> e;
-		EA<sp<E> >* elements = GETRC(array_);
-		e = getAt(elements, index);
-		DELRC(elements);
-		return e;
+		ERCGuard<EA<sp<E> > > elements(array_);
+		return getAt(elements.get(), index);
 	}
 
 	/**
@@ -270,7 +253,7 @@ public:
 				setArray(newElements);
 			} else {
 				// Not quite a no-op; ensures volatile write semantics
-				setArray(elements);
+				setArray(GETRC(elements)); // setArray() takes over a reference
 			}
 
 			DELRC(elements);
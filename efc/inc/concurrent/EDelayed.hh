@@ -0,0 +1,44 @@
+/*
+ * EDelayed.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EDELAYED_HH_
+#define EDELAYED_HH_
+
+#include "../EComparable.hh"
+#include "../ETimeUnit.hh"
+
+namespace efc {
+
+//@see: openjdk-8/src/share/classes/java/util/concurrent/Delayed.java
+
+/**
+ * A mix-in style interface for marking objects that should be
+ * acted upon after a given delay.
+ *
+ * <p>An implementation of this interface must define a
+ * {@code compareTo} method that provides an ordering consistent with
+ * its {@code getDelay} method.
+ *
+ * @since 1.5
+ */
+
+interface EDelayed : virtual public EComparable<EDelayed*> {
+	virtual ~EDelayed(){}
+
+	/**
+	 * Returns the remaining delay associated with this object, in the
+	 * given time unit.
+	 *
+	 * @param unit the time unit
+	 * @return the remaining delay; zero or negative values indicate
+	 * that the delay has already elapsed
+	 */
+	virtual llong getDelay(ETimeUnit* unit) = 0;
+};
+
+} /* namespace efc */
+#endif /* EDELAYED_HH_ */
@@ -0,0 +1,126 @@
+/*
+ * EDoubleAdder.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EDOUBLEADDER_HH_
+#define EDOUBLEADDER_HH_
+
+#include "./EStriped64.hh"
+#include "../EString.hh"
+
+namespace efc {
+
+//@see: openjdk-8/src/share/classes/java/util/concurrent/atomic/DoubleAdder.java
+
+/**
+ * One or more variables that together maintain an initially zero
+ * {@code double} sum.  When updates (method {@link #add}) are
+ * contended across threads, the set of variables may grow dynamically
+ * to reduce contention.  Method {@link #sum} (or, equivalently {@link
+ * #doubleValue}) returns the current total combined across the
+ * variables maintaining the sum. The order of accumulation within or
+ * across threads is not guaranteed. Thus, this class may not be
+ * applicable if numerical stability is required, especially when
+ * combining values of substantially different orders of magnitude.
+ *
+ * <p>This class is usually preferable to alternatives when multiple
+ * threads update a common value that is used for purposes such as
+ * summary statistics that are frequently updated but less frequently
+ * read.
+ *
+ * <p>This class extends {@link ENumber}, but does <em>not</em> define
+ * methods such as {@code equals}, {@code hashCode} and {@code
+ * compareTo} because instances are expected to be mutated, and so are
+ * not useful as collection keys.
+ *
+ * @since 1.8
+ */
+
+class EDoubleAdder : public EStriped64 {
+public:
+	virtual ~EDoubleAdder();
+
+	/**
+	 * Creates a new adder with initial sum of zero.
+	 */
+	EDoubleAdder();
+
+	/**
+	 * Adds the given value.
+	 *
+	 * @param x the value to add
+	 */
+	void add(double x);
+
+	/**
+	 * Returns the current sum.  The returned value is <em>NOT</em> an
+	 * atomic snapshot; invocation in the absence of concurrent
+	 * updates returns an accurate result, but concurrent updates that
+	 * occur while the sum is being calculated might not be
+	 * incorporated.  Also, because floating-point arithmetic is not
+	 * strictly associative, the returned result need not be
+	 * identical to the value that would be obtained in a sequential
+	 * series of updates to a single variable.
+	 *
+	 * @return the sum
+	 */
+	double sum();
+
+	/**
+	 * Resets variables maintaining the sum to zero.  This method may
+	 * be a useful alternative to creating a new adder, but is only
+	 * effective if there are no concurrent updates.  Because this
+	 * method is intrinsically racy, it should only be used when it is
+	 * known that no threads are concurrently updating.
+	 */
+	void reset();
+
+	/**
+	 * Equivalent in effect to {@link #sum} followed by {@link
+	 * #reset}. This method may apply for example during quiescent
+	 * points between multithreaded computations.  If there are
+	 * updates concurrent with this method, the returned value is
+	 * <em>not</em> guaranteed to be the final value occurring before
+	 * the reset.
+	 *
+	 * @return the sum
+	 */
+	double sumThenReset();
+
+	/**
+	 * Returns the String representation of the {@link #sum}.
+	 * @return the String representation of the {@link #sum}
+	 */
+	virtual EStringBase toString();
+
+	/**
+	 * Equivalent to {@link #sum}.
+	 *
+	 * @return the sum
+	 */
+	virtual double doubleValue();
+
+	/**
+	 * Returns the {@link #sum} as an {@code llong} after a
+	 * narrowing primitive conversion.
+	 */
+	virtual llong llongValue();
+
+	/**
+	 * Returns the {@link #sum} as an {@code int} after a
+	 * narrowing primitive conversion.
+	 */
+	virtual int intValue();
+
+	/**
+	 * Returns the {@link #sum} as a {@code float}
+	 * after a narrowing primitive conversion.
+	 */
+	virtual float floatValue();
+};
+
+} /* namespace efc */
+#endif /* EDOUBLEADDER_HH_ */
@@ -0,0 +1,302 @@
+/*
+ * EEpochLinkedQueue.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EEPOCHLINKEDQUEUE_HH_
+#define EEPOCHLINKEDQUEUE_HH_
+
+#include "../EArrayList.hh"
+#include "./EConcurrentQueue.hh"
+#include "./EEpochManager.hh"
+#include "./EUnsafe.hh"
+#include "../ENoSuchElementException.hh"
+#include "../ENullPointerException.hh"
+#include "../EIllegalStateException.hh"
+
+namespace efc {
+
+/**
+ * An unbounded lock-free FIFO queue with the same contract as
+ * {@link EConcurrentLinkedQueue}, whose nodes are linked by raw
+ * pointers and reclaimed through {@link EEpochManager}.
+ *
+ * <p>{@code EConcurrentLinkedQueue} links its nodes with
+ * {@code sp<Node>}, so every step of every traversal copies a shared
+ * pointer under the lock pool of {@code atomic_load}.  Here an
+ * operation enters one read section and then follows plain pointer
+ * loads; the only atomic writes are the CASes of the Michael-Scott
+ * algorithm itself.  Nodes leave the list only at the head, which
+ * makes the thread whose CAS advanced the head the single owner that
+ * retires the old dummy node.
+ *
+ * <p>{@link #remove(E*)} and iterator removal mark the node as taken
+ * instead of unlinking it; {@link #poll} skips taken nodes, and they
+ * are reclaimed when the head moves past them.  A polled element is
+ * released together with its node, after a grace period.
+ *
+ * <p>Iterators are weakly consistent: they return the elements
+ * present at the time the iterator was created, and removal through
+ * an iterator removes that element from the queue if it is still
+ * present.  Like {@code EConcurrentLinkedQueue}, {@link #size} is
+ * not a constant-time operation.
+ *
+ * @param <E> the type of elements held in this collection
+ */
+
+template<typename E>
+class EEpochLinkedQueue: public EConcurrentQueue<E> {
+public:
+	virtual ~EEpochLinkedQueue() {
+		Node* p = head;
+		while (p != null) {
+			Node* n = p->next;
+			delete p;
+			p = n;
+		}
+	}
+
+	/**
+	 * Creates an empty queue.
+	 */
+	EEpochLinkedQueue() : em(EEpochManager::getInstance()) {
+		head = tail = new Node(null);
+	}
+
+	boolean add(E* e) {
+		return offer(e);
+	}
+	boolean add(sp<E> e) {
+		return offer(e);
+	}
+
+	/**
+	 * Inserts the specified element at the tail of this queue.
+	 * As the queue is unbounded, this method will never return {@code false}.
+	 *
+	 * @return {@code true} (as specified by {@link Queue#offer})
+	 * @throws NullPointerException if the specified element is null
+	 */
+	boolean offer(E* e) {
+		sp<E> x(e);
+		boolean r = offer(x);
+		if (!r) {
+			x.dismiss();
+		}
+		return r;
+	}
+	boolean offer(sp<E> e) {
+		if (e == null) throw ENullPointerException(__FILE__, __LINE__);
+		Node* n = new Node(e);
+		EEpochManager::Guard g(em);
+		for (;;) {
+			Node* t = tail;
+			Node* next = t->next;
+			if (t != tail)
+				continue;
+			if (next == null) {
+				if (t->casNext(null, n)) {
+					casTail(t, n);
+					return true;
+				}
+			} else {
+				casTail(t, next); // help a lagging tail
+			}
+		}
+	}
+
+	sp<E> poll() {
+		EEpochManager::Guard g(em);
+		for (;;) {
+			Node* h = head;
+			Node* t = tail;
+			Node* first = h->next;
+			if (h != head)
+				continue;
+			if (first == null)
+				return null;
+			if (h == t) {
+				// never let head pass tail: tail must not point to a retired node
+				casTail(t, first);
+				continue;
+			}
+			if (casHead(h, first)) {
+				em->retire(h, &EEpochManager::deleteObject<Node>);
+				if (first->claim())
+					return first->item;
+			}
+		}
+	}
+
+	sp<E> peek() {
+		EEpochManager::Guard g(em);
+		for (Node* p = head->next; p != null; p = p->next) {
+			if (!p->taken)
+				return p->item;
+		}
+		return null;
+	}
+
+	sp<E> element() {
+		sp<E> x = peek();
+		if (x != null)
+			return x;
+		else
+			throw ENoSuchElementException(__FILE__, __LINE__);
+	}
+
+	sp<E> remove() {
+		sp<E> x = poll();
+		if (x != null)
+			return x;
+		else
+			throw ENoSuchElementException(__FILE__, __LINE__);
+	}
+
+	/**
+	 * Returns {@code true} if this queue contains no elements.
+	 */
+	boolean isEmpty() {
+		EEpochManager::Guard g(em);
+		for (Node* p = head->next; p != null; p = p->next) {
+			if (!p->taken)
+				return false;
+		}
+		return true;
+	}
+
+	/**
+	 * Returns the number of elements in this queue.  This is not a
+	 * constant-time operation; the result may be inaccurate if the
+	 * queue is modified during traversal.
+	 */
+	int size() {
+		int count = 0;
+		EEpochManager::Guard g(em);
+		for (Node* p = head->next; p != null; p = p->next) {
+			if (!p->taken) {
+				// Collection.size() spec says to max out
+				if (++count == EInteger::MAX_VALUE)
+					break;
+			}
+		}
+		return count;
+	}
+
+	boolean contains(E* o) {
+		if (o == null) return false;
+		EEpochManager::Guard g(em);
+		for (Node* p = head->next; p != null; p = p->next) {
+			if (!p->taken && o->equals(p->item.get()))
+				return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Removes a single instance of the specified element from this
+	 * queue, if it is present.
+	 *
+	 * @return {@code true} if this queue changed as a result of the call
+	 */
+	boolean remove(E* o) {
+		if (o == null) return false;
+		EEpochManager::Guard g(em);
+		for (Node* p = head->next; p != null; p = p->next) {
+			if (!p->taken && o->equals(p->item.get()) && p->claim())
+				return true;
+		}
+		return false;
+	}
+
+	void clear() {
+		while (poll() != null)
+			;
+	}
+
+	sp<EConcurrentIterator<E> > iterator() {
+		return new Itr(this);
+	}
+
+	EA<sp<E> > toArray() {
+		EArrayList<sp<E> > al;
+		EEpochManager::Guard g(em);
+		for (Node* p = head->next; p != null; p = p->next) {
+			if (!p->taken)
+				al.add(p->item);
+		}
+		return al.toArray();
+	}
+
+private:
+	struct Node {
+		sp<E> item; // immutable, released when the node is freed
+		Node* volatile next;
+		volatile int taken;
+
+		Node(sp<E> item) : item(item), next(null), taken(0) {
+		}
+
+		boolean casNext(Node* cmp, Node* val) {
+			return EUnsafe::compareAndSwapObject(&next, cmp, val);
+		}
+
+		boolean claim() {
+			return taken == 0 && EUnsafe::compareAndSwapInt(&taken, 0, 1);
+		}
+	};
+
+	class Itr: public EConcurrentIterator<E> {
+	public:
+		Itr(EEpochLinkedQueue* queue) : queue(queue), items(queue->toArray()), index(0) {
+		}
+
+		boolean hasNext() {
+			return index < items.length();
+		}
+
+		sp<E> next() {
+			if (index >= items.length()) throw ENoSuchElementException(__FILE__, __LINE__);
+			lastRet = items[index++];
+			return lastRet;
+		}
+
+		void remove() {
+			if (lastRet == null) throw EIllegalStateException(__FILE__, __LINE__);
+			queue->removeSame(lastRet.get());
+			lastRet = null;
+		}
+
+	private:
+		EEpochLinkedQueue* queue;
+		EA<sp<E> > items;
+		int index;
+		sp<E> lastRet;
+	};
+
+	EEpochManager* em;
+	Node* volatile head;
+	Node* volatile tail;
+
+	boolean casHead(Node* cmp, Node* val) {
+		return EUnsafe::compareAndSwapObject(&head, cmp, val);
+	}
+
+	boolean casTail(Node* cmp, Node* val) {
+		return EUnsafe::compareAndSwapObject(&tail, cmp, val);
+	}
+
+	boolean removeSame(E* o) {
+		EEpochManager::Guard g(em);
+		for (Node* p = head->next; p != null; p = p->next) {
+			if (p->item.get() == o && p->claim())
+				return true;
+		}
+		return false;
+	}
+};
+
+} /* namespace efc */
+#endif /* EEPOCHLINKEDQUEUE_HH_ */
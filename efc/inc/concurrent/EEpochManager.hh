@@ -0,0 +1,191 @@
+/*
+ * EEpochManager.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EEPOCHMANAGER_HH_
+#define EEPOCHMANAGER_HH_
+
+#include "../EString.hh"
+#include "../EThreadLocal.hh"
+#include "../EIllegalStateException.hh"
+
+namespace efc {
+
+/**
+ * Epoch-based memory reclamation for lock-free data structures.
+ *
+ * <p>A thread that traverses a shared structure through raw pointers
+ * brackets the traversal with {@link #enter} and {@link #exit} (or a
+ * scoped {@link Guard}).  A thread that unlinks a node hands it to
+ * {@link #retire} instead of deleting it.  The node is freed once
+ * every thread that could have loaded a pointer to it has left its
+ * read section, so readers need neither reference counts nor any
+ * write to the nodes they visit: a read section costs one store and
+ * one fence on a per-thread word, independent of how many nodes are
+ * visited.
+ *
+ * <p>The manager keeps a global epoch.  A thread entering a read
+ * section announces the epoch it observed; the epoch may advance
+ * only once every thread inside a read section has announced the
+ * current one.  Retired objects are kept in per-thread bags tagged
+ * with the epoch at retirement and are freed in batches when the
+ * global epoch is two ahead of that tag.
+ *
+ * <p>Each thread is registered on first use through an
+ * {@link EThreadLocal}; when the {@link EThread} terminates its
+ * registration record is recycled for later threads and any objects
+ * it had not yet freed are handed over to the surviving threads.
+ *
+ * <p>A thread that blocks, or runs for a long time, inside a read
+ * section delays all reclamation.  Read sections should cover single
+ * operations; they may be nested.
+ *
+ * <pre> {@code
+ * {
+ *     EEpochManager::Guard g;
+ *     for (Node* p = head; p != null; p = p->next)
+ *         ...;
+ * }
+ * ...
+ * if (casNext(pred, node, node->next))
+ *     EEpochManager::getInstance()->retire(node);
+ * }</pre>
+ *
+ * @see EHazardPointer
+ */
+
+class EEpochManager {
+private:
+	struct Record;
+	struct Bag;
+	class Lease;
+	class Participant;
+
+public:
+	typedef void (*Deleter)(void* p);
+
+	/**
+	 * Scoped read section.
+	 */
+	class Guard {
+	public:
+		Guard() : m(getInstance()), r(m->enterRecord()) {
+		}
+		explicit Guard(EEpochManager* m) : m(m), r(m->enterRecord()) {
+		}
+		~Guard() {
+			m->exitRecord(r);
+		}
+	private:
+		EEpochManager* m;
+		Record* r;
+
+		Guard(const Guard&);
+		Guard& operator=(const Guard&);
+	};
+
+	/**
+	 * Returns the process-wide manager.  It is created on first use
+	 * and never destroyed, so objects may be retired from static
+	 * destructors and from threads that outlive {@code main}.
+	 */
+	static EEpochManager* getInstance();
+
+	/**
+	 * Enters a read section of the calling thread.
+	 */
+	void enter();
+
+	/**
+	 * Leaves the innermost read section of the calling thread, and
+	 * may free objects retired by it.
+	 *
+	 * @throws IllegalStateException if not in a read section
+	 */
+	void exit();
+
+	/**
+	 * Returns true if the calling thread is inside a read section.
+	 */
+	boolean inCriticalSection();
+
+	/**
+	 * Schedules {@code p} to be released by {@code d} once no read
+	 * section can still observe it.  The object must already be
+	 * unreachable from the shared structure.  May be called inside
+	 * or outside a read section.
+	 */
+	void retire(void* p, Deleter d);
+
+	template<typename T>
+	void retire(T* p) {
+		retire(p, &deleteObject<T>);
+	}
+
+	/**
+	 * Tries to advance the epoch and frees everything the calling
+	 * thread, or a terminated thread, retired that is now safe.
+	 */
+	void reclaim();
+
+	/**
+	 * Blocks until everything the calling thread has retired, and
+	 * everything left behind by terminated threads, is freed.  Must not be called inside a read section, and only
+	 * returns once every other thread has left the read sections it
+	 * was in at the time of the call.
+	 *
+	 * @throws IllegalStateException if called inside a read section
+	 */
+	void barrier();
+
+	/**
+	 * Returns the current global epoch.
+	 */
+	llong getEpoch();
+
+	/**
+	 * Returns the number of threads currently registered.
+	 */
+	int getRegisteredThreads();
+
+	/**
+	 * Returns an estimate of the number of retired objects not yet
+	 * freed.
+	 */
+	llong getPendingCount();
+
+	EStringBase toString();
+
+	template<typename T>
+	static void deleteObject(void* p) {
+		delete (T*)p;
+	}
+
+private:
+	volatile llong epoch;
+	Record* volatile records;
+	Bag* volatile orphans;
+	volatile int orphanCount;
+	EThreadLocalVariable<Participant, Lease>* local;
+
+	EEpochManager();
+	~EEpochManager();
+	EEpochManager(const EEpochManager&);
+	EEpochManager& operator=(const EEpochManager&);
+
+	Record* current();
+	Record* enterRecord();
+	void exitRecord(Record* r);
+	Record* acquireRecord();
+	void releaseRecord(Record* r);
+	boolean tryAdvance();
+	void collect(Record* r);
+	void collectOrphans(llong e);
+	static void freeBag(Bag* b);
+};
+
+} /* namespace efc */
+#endif /* EEPOCHMANAGER_HH_ */
@@ -0,0 +1,479 @@
+/*
+ * EEpochSkipListMap.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EEPOCHSKIPLISTMAP_HH_
+#define EEPOCHSKIPLISTMAP_HH_
+
+#include "../EComparator.hh"
+#include "../EComparable.hh"
+#include "../EClassCastException.hh"
+#include "../ENullPointerException.hh"
+#include "../ENoSuchElementException.hh"
+#include "./EEpochManager.hh"
+#include "./ESpinControl.hh"
+#include "./EUnsafe.hh"
+#include "./EOrderAccess.hh"
+#include "./EThreadLocalRandom.hh"
+
+namespace efc {
+
+/**
+ * A sorted concurrent map whose lookups are wait-free and consist of
+ * plain pointer loads only, with nodes reclaimed through
+ * {@link EEpochManager}.
+ *
+ * <p>This is the lazy skip list of Herlihy, Lev, Luchangco and
+ * Shavit ("A Simple Optimistic Skiplist Algorithm", 2007).  Updates
+ * lock the few predecessor nodes they change, validate, and link or
+ * unlink a node at all of its levels at once; a removed node is
+ * first marked, then unlinked, and its unlinking thread is the only
+ * one that retires it.  Lookups take no locks and never write shared
+ * memory: they enter one read section and walk the levels.
+ *
+ * <p>{@link EConcurrentSkipListMap} instead reads values through
+ * {@code atomic_load} of {@code sp<V>}, which takes a pooled spin
+ * lock per visited value, and must delete nodes while other threads
+ * may still traverse them.  Use this class for read-mostly sorted
+ * maps with the basic map operations below; it does not implement
+ * the navigable map views.
+ *
+ * <p>Values are held in immutable boxes, so {@link #put} replaces a
+ * value with one pointer store and {@link #get} never sees a torn
+ * {@code sp<V>}.  Keys are ordered by the given comparator, or by
+ * their {@link EComparable} natural ordering.  Null keys and values
+ * are not permitted.  {@link #size} is a constant-time estimate.
+ *
+ * @param <K> the type of keys maintained by this map
+ * @param <V> the type of mapped values
+ */
+
+template<typename K, typename V>
+class EEpochSkipListMap: public EObject {
+public:
+	virtual ~EEpochSkipListMap() {
+		Node* p = head;
+		while (p != null) {
+			Node* n = p->next[0];
+			delete p;
+			p = n;
+		}
+	}
+
+	/**
+	 * Constructs a new, empty map, sorted according to the specified
+	 * comparator, or the natural ordering of the keys if null.
+	 */
+	explicit EEpochSkipListMap(EComparator<K*>* comparator = null) :
+			comparator(comparator), em(EEpochManager::getInstance()),
+			count(0) {
+		head = new Node(null, null, MAX_LEVEL - 1);
+		head->fullyLinked = 1;
+	}
+
+	/**
+	 * Returns the value to which the specified key is mapped, or
+	 * {@code null} if this map contains no mapping for the key.
+	 *
+	 * @throws ClassCastException if the key cannot be compared
+	 * @throws NullPointerException if the specified key is null
+	 */
+	sp<V> get(K* key) {
+		if (key == null) throw ENullPointerException(__FILE__, __LINE__);
+		EEpochManager::Guard g(em);
+		Node* n = findNode(key);
+		if (n != null) {
+			Box* b = n->value;
+			return b->value;
+		}
+		return null;
+	}
+
+	/**
+	 * Returns {@code true} if this map contains a mapping for the
+	 * specified key.
+	 */
+	boolean containsKey(K* key) {
+		if (key == null) throw ENullPointerException(__FILE__, __LINE__);
+		EEpochManager::Guard g(em);
+		return findNode(key) != null;
+	}
+
+	/**
+	 * Associates the specified value with the specified key, replacing
+	 * any previous value.
+	 *
+	 * @return the previous value, or {@code null} if there was none
+	 */
+	sp<V> put(K* key, V* value) {
+		sp<K> k(key);
+		sp<V> v(value);
+		return put(k, v);
+	}
+	sp<V> put(sp<K> key, sp<V> value) {
+		return doPut(key, value, false);
+	}
+
+	/**
+	 * If the specified key is not already associated with a value,
+	 * associates it with the given value.
+	 *
+	 * @return the current value, or {@code null} if there was none
+	 */
+	sp<V> putIfAbsent(sp<K> key, sp<V> value) {
+		return doPut(key, value, true);
+	}
+
+	/**
+	 * Removes the mapping for the specified key if present.
+	 *
+	 * @return the previous value, or {@code null} if there was none
+	 */
+	sp<V> remove(K* key) {
+		if (key == null) throw ENullPointerException(__FILE__, __LINE__);
+		Node* preds[MAX_LEVEL];
+		Node* succs[MAX_LEVEL];
+		Node* victim = null;
+		boolean isMarked = false;
+		int topLevel = -1;
+		EEpochManager::Guard g(em);
+		for (;;) {
+			int lf = find(key, preds, succs);
+			if (lf != -1)
+				victim = succs[lf];
+			if (!isMarked) {
+				if (lf == -1 || !victim->fullyLinked || victim->topLevel != lf || victim->marked)
+					return null;
+				topLevel = victim->topLevel;
+				victim->lock();
+				if (victim->marked) {
+					victim->unlock();
+					return null;
+				}
+				victim->marked = 1;
+				isMarked = true;
+			}
+			int highestLocked = -1;
+			boolean valid = true;
+			for (int level = 0; valid && level <= topLevel; level++) {
+				Node* pred = preds[level];
+				if (level == 0 || pred != preds[level - 1]) {
+					pred->lock();
+					highestLocked = level;
+				}
+				valid = !pred->marked && pred->next[level] == victim;
+			}
+			if (!valid) {
+				unlockPreds(preds, highestLocked);
+				continue;
+			}
+			for (int level = topLevel; level >= 0; level--) {
+				EOrderAccess::release_store_ptr(&preds[level]->next[level], victim->next[level]);
+			}
+			sp<V> old = victim->value->value;
+			victim->unlock();
+			unlockPreds(preds, highestLocked);
+			eso_atomic_sub_and_fetch32(&count, 1);
+			em->retire(victim, &EEpochManager::deleteObject<Node>);
+			return old;
+		}
+	}
+
+	/**
+	 * Returns an estimate of the number of mappings.
+	 */
+	int size() {
+		return count;
+	}
+
+	boolean isEmpty() {
+		EEpochManager::Guard g(em);
+		return firstNode() == null;
+	}
+
+	/**
+	 * Removes all of the mappings from this map.
+	 */
+	void clear() {
+		for (;;) {
+			sp<K> k;
+			{
+				EEpochManager::Guard g(em);
+				Node* n = firstNode();
+				if (n == null)
+					return;
+				k = n->key;
+			}
+			remove(k.get());
+		}
+	}
+
+	/**
+	 * Returns the first (lowest) key currently in this map.
+	 *
+	 * @throws NoSuchElementException if this map is empty
+	 */
+	sp<K> firstKey() {
+		EEpochManager::Guard g(em);
+		Node* n = firstNode();
+		if (n == null) throw ENoSuchElementException(__FILE__, __LINE__);
+		return n->key;
+	}
+
+	/**
+	 * Returns the last (highest) key currently in this map.
+	 *
+	 * @throws NoSuchElementException if this map is empty
+	 */
+	sp<K> lastKey() {
+		EEpochManager::Guard g(em);
+		Node* pred = head;
+		for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+			Node* curr;
+			while ((curr = pred->next[level]) != null)
+				pred = curr;
+		}
+		if (pred != head && pred->fullyLinked && !pred->marked)
+			return pred->key;
+		// the last node is being added or removed; scan the bottom level
+		Node* last = null;
+		for (Node* p = head->next[0]; p != null; p = p->next[0]) {
+			if (p->fullyLinked && !p->marked)
+				last = p;
+		}
+		if (last == null) throw ENoSuchElementException(__FILE__, __LINE__);
+		return last->key;
+	}
+
+	/**
+	 * Returns the least key greater than or equal to the given key,
+	 * or {@code null} if there is no such key.
+	 */
+	sp<K> ceilingKey(K* key) {
+		if (key == null) throw ENullPointerException(__FILE__, __LINE__);
+		EEpochManager::Guard g(em);
+		Node* pred = head;
+		for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+			Node* curr;
+			while ((curr = pred->next[level]) != null && cpr(key, curr->key.get()) > 0)
+				pred = curr;
+		}
+		for (Node* p = pred->next[0]; p != null; p = p->next[0]) {
+			if (p->fullyLinked && !p->marked)
+				return p->key;
+		}
+		return null;
+	}
+
+	/**
+	 * Returns the comparator used to order the keys, or null if the
+	 * keys use their natural ordering.
+	 */
+	EComparator<K*>* getComparator() {
+		return comparator;
+	}
+
+private:
+	static const int MAX_LEVEL = 24;
+
+	/**
+	 * Immutable holder of a value, replaced as a whole.
+	 */
+	struct Box {
+		sp<V> value;
+		Box(sp<V> v) : value(v) {
+		}
+	};
+
+	struct Node {
+		sp<K> key;
+		Box* volatile value;
+		Node* volatile* next;
+		int topLevel;
+		volatile int marked;
+		volatile int fullyLinked;
+		volatile int locked;
+
+		Node(sp<K> k, Box* v, int topLevel) :
+				key(k), value(v), topLevel(topLevel), marked(0),
+				fullyLinked(0), locked(0) {
+			next = new Node* volatile[topLevel + 1];
+			for (int i = 0; i <= topLevel; i++)
+				next[i] = null;
+		}
+		~Node() {
+			delete value;
+			delete[] next;
+		}
+
+		void lock() {
+			for (int spins = 0;; spins++) {
+				if (locked == 0 && EUnsafe::compareAndSwapInt(&locked, 0, 1))
+					return;
+				if (spins < 64)
+					ESpinControl::pause();
+				else
+					EThread::yield();
+			}
+		}
+		void unlock() {
+			EOrderAccess::release_store(&locked, 0);
+		}
+	};
+
+	EComparator<K*>* comparator;
+	EEpochManager* em;
+	Node* head;
+	volatile int count;
+
+	int cpr(K* x, K* y) {
+		if (comparator != null)
+			return comparator->compare(x, y);
+		EComparable<K*>* cc = dynamic_cast<EComparable<K*>*>(x);
+		if (!cc) throw EClassCastException(__FILE__, __LINE__);
+		return cc->compareTo(y);
+	}
+
+	/**
+	 * Returns a level in [0, MAX_LEVEL) with geometric distribution,
+	 * from the per-thread generator so inserters share no seed.
+	 */
+	int randomLevel() {
+		unsigned int x = (unsigned int)EThreadLocalRandom::current()->nextInt();
+		int level = 0;
+		while ((x & 1) != 0 && level < MAX_LEVEL - 1) {
+			level++;
+			x >>= 1;
+		}
+		return level;
+	}
+
+	/**
+	 * Fills in the predecessors and successors of key at every level,
+	 * returning the highest level at which key was found, or -1.
+	 */
+	int find(K* key, Node** preds, Node** succs) {
+		int lf = -1;
+		Node* pred = head;
+		for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+			Node* curr = pred->next[level];
+			int c = 1;
+			while (curr != null && (c = cpr(key, curr->key.get())) > 0) {
+				pred = curr;
+				curr = pred->next[level];
+			}
+			if (lf == -1 && curr != null && c == 0)
+				lf = level;
+			preds[level] = pred;
+			succs[level] = curr;
+		}
+		return lf;
+	}
+
+	/**
+	 * Returns the live node for key, or null.
+	 */
+	Node* findNode(K* key) {
+		Node* pred = head;
+		for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+			Node* curr = pred->next[level];
+			int c = 1;
+			while (curr != null && (c = cpr(key, curr->key.get())) > 0) {
+				pred = curr;
+				curr = pred->next[level];
+			}
+			if (curr != null && c == 0)
+				return (curr->fullyLinked && !curr->marked) ? curr : null;
+		}
+		return null;
+	}
+
+	Node* firstNode() {
+		for (Node* p = head->next[0]; p != null; p = p->next[0]) {
+			if (p->fullyLinked && !p->marked)
+				return p;
+		}
+		return null;
+	}
+
+	static void unlockPreds(Node** preds, int highestLocked) {
+		for (int level = 0; level <= highestLocked; level++) {
+			if (level == 0 || preds[level] != preds[level - 1])
+				preds[level]->unlock();
+		}
+	}
+
+	static void deleteBox(void* p) {
+		delete (Box*)p;
+	}
+
+	sp<V> doPut(sp<K> key, sp<V> value, boolean onlyIfAbsent) {
+		if (key == null || value == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		Node* preds[MAX_LEVEL];
+		Node* succs[MAX_LEVEL];
+		int topLevel = randomLevel();
+		EEpochManager::Guard g(em);
+		for (;;) {
+			int lf = find(key.get(), preds, succs);
+			if (lf != -1) {
+				Node* found = succs[lf];
+				if (!found->marked) {
+					while (!found->fullyLinked)
+						ESpinControl::pause();
+					if (onlyIfAbsent) {
+						Box* b = found->value;
+						return b->value;
+					}
+					found->lock();
+					if (found->marked) {
+						found->unlock();
+						continue;
+					}
+					Box* old = found->value;
+					EOrderAccess::release_store_ptr(&found->value, new Box(value));
+					found->unlock();
+					sp<V> r = old->value;
+					em->retire(old, &deleteBox);
+					return r;
+				}
+				continue; // being removed, retry
+			}
+			int highestLocked = -1;
+			boolean valid = true;
+			for (int level = 0; valid && level <= topLevel; level++) {
+				Node* pred = preds[level];
+				Node* succ = succs[level];
+				if (level == 0 || pred != preds[level - 1]) {
+					pred->lock();
+					highestLocked = level;
+				}
+				valid = !pred->marked && (succ == null || !succ->marked) &&
+						pred->next[level] == succ;
+			}
+			if (!valid) {
+				unlockPreds(preds, highestLocked);
+				continue;
+			}
+			Node* n = new Node(key, new Box(value), topLevel);
+			for (int level = 0; level <= topLevel; level++)
+				n->next[level] = succs[level];
+			for (int level = 0; level <= topLevel; level++)
+				EOrderAccess::release_store_ptr(&preds[level]->next[level], n);
+			n->fullyLinked = 1;
+			unlockPreds(preds, highestLocked);
+			eso_atomic_add_and_fetch32(&count, 1);
+			return null;
+		}
+	}
+
+	// unsupported.
+	EEpochSkipListMap(const EEpochSkipListMap&);
+	EEpochSkipListMap& operator=(const EEpochSkipListMap&);
+};
+
+} /* namespace efc */
+#endif /* EEPOCHSKIPLISTMAP_HH_ */
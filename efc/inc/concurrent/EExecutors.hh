@@ -11,6 +11,12 @@
 #include "../EString.hh"
 #include "../ETimeUnit.hh"
 #include "./EThreadPoolExecutor.hh"
+#include "./EForkJoinPool.hh"
+#include "./EScheduledThreadPoolExecutor.hh"
+#include "./ELinkedBlockingQueue.hh"
+#include "./EWorkerLocalQueue.hh"
+#include "./EAffinityThreadFactory.hh"
+#include "../ERuntime.hh"
 
 namespace efc {
 
@@ -81,6 +87,33 @@ public:
 	 */
 	static EExecutorService* newFixedThreadPool(int nThreads);
 
+	/**
+	 * Creates a thread pool that maintains enough threads to support
+	 * the given parallelism level, and may use multiple queues to
+	 * reduce contention. The parallelism level corresponds to the
+	 * maximum number of threads actively engaged in, or available to
+	 * engage in, task processing. The actual number of threads may
+	 * grow and shrink dynamically. A work-stealing pool makes no
+	 * guarantees about the order in which submitted tasks are
+	 * executed.
+	 *
+	 * @param parallelism the targeted parallelism level
+	 * @return the newly created thread pool
+	 * @throws EIllegalArgumentException if {@code parallelism <= 0}
+	 * @since 1.8
+	 */
+	static EExecutorService* newWorkStealingPool(int parallelism);
+
+	/**
+	 * Creates a work-stealing thread pool using all
+	 * {@link ERuntime#availableProcessors available processors}
+	 * as its target parallelism level.
+	 * @return the newly created thread pool
+	 * @see #newWorkStealingPool(int)
+	 * @since 1.8
+	 */
+	static EExecutorService* newWorkStealingPool();
+
 	/**
 	 * Creates a thread pool that reuses a fixed number of threads
 	 * operating off a shared unbounded queue, using the provided
@@ -102,6 +135,20 @@ public:
 	 */
 	static EExecutorService* newFixedThreadPool(int nThreads, sp<EThreadFactory> threadFactory);
 
+	/**
+	 * Creates a fixed-size thread pool tuned for cache locality.  Each
+	 * worker is pinned to one of the available processors by an
+	 * {@link EAffinityThreadFactory}, and the tasks a worker submits
+	 * while running are cached for that worker by an
+	 * {@link EWorkerLocalQueue} in front of a shared unbounded queue.
+	 *
+	 * @param nThreads the number of threads in the pool
+	 * @param pinThreads whether to pin the workers to processors
+	 * @return the newly created thread pool
+	 * @throws IllegalArgumentException if {@code nThreads <= 0}
+	 */
+	static EExecutorService* newAffinityThreadPool(int nThreads, boolean pinThreads = true);
+
 	/**
 	 * Creates an Executor that uses a single worker thread operating
 	 * off an unbounded queue. (Note however that if this single
@@ -162,72 +209,54 @@ public:
 	 */
 	static EExecutorService* newCachedThreadPool(sp<EThreadFactory> threadFactory);
 
-//	    /**
-//	     * Creates a single-threaded executor that can schedule commands
-//	     * to run after a given delay, or to execute periodically.
-//	     * (Note however that if this single
-//	     * thread terminates due to a failure during execution prior to
-//	     * shutdown, a new one will take its place if needed to execute
-//	     * subsequent tasks.)  Tasks are guaranteed to execute
-//	     * sequentially, and no more than one task will be active at any
-//	     * given time. Unlike the otherwise equivalent
-//	     * <tt>newScheduledThreadPool(1)</tt> the returned executor is
-//	     * guaranteed not to be reconfigurable to use additional threads.
-//	     * @return the newly created scheduled executor
-//	     */
-//	    public static ScheduledExecutorService newSingleThreadScheduledExecutor() {
-//	        return new DelegatedScheduledExecutorService
-//	            (new ScheduledThreadPoolExecutor(1));
-//	    }
-//
-//	    /**
-//	     * Creates a single-threaded executor that can schedule commands
-//	     * to run after a given delay, or to execute periodically.  (Note
-//	     * however that if this single thread terminates due to a failure
-//	     * during execution prior to shutdown, a new one will take its
-//	     * place if needed to execute subsequent tasks.)  Tasks are
-//	     * guaranteed to execute sequentially, and no more than one task
-//	     * will be active at any given time. Unlike the otherwise
-//	     * equivalent <tt>newScheduledThreadPool(1, threadFactory)</tt>
-//	     * the returned executor is guaranteed not to be reconfigurable to
-//	     * use additional threads.
-//	     * @param threadFactory the factory to use when creating new
-//	     * threads
-//	     * @return a newly created scheduled executor
-//	     * @throws NullPointerException if threadFactory is null
-//	     */
-//	    public static ScheduledExecutorService newSingleThreadScheduledExecutor(ThreadFactory threadFactory) {
-//	        return new DelegatedScheduledExecutorService
-//	            (new ScheduledThreadPoolExecutor(1, threadFactory));
-//	    }
-//
-//	    /**
-//	     * Creates a thread pool that can schedule commands to run after a
-//	     * given delay, or to execute periodically.
-//	     * @param corePoolSize the number of threads to keep in the pool,
-//	     * even if they are idle.
-//	     * @return a newly created scheduled thread pool
-//	     * @throws IllegalArgumentException if {@code corePoolSize < 0}
-//	     */
-//	    public static ScheduledExecutorService newScheduledThreadPool(int corePoolSize) {
-//	        return new ScheduledThreadPoolExecutor(corePoolSize);
-//	    }
-//
-//	    /**
-//	     * Creates a thread pool that can schedule commands to run after a
-//	     * given delay, or to execute periodically.
-//	     * @param corePoolSize the number of threads to keep in the pool,
-//	     * even if they are idle.
-//	     * @param threadFactory the factory to use when the executor
-//	     * creates a new thread.
-//	     * @return a newly created scheduled thread pool
-//	     * @throws IllegalArgumentException if {@code corePoolSize < 0}
-//	     * @throws NullPointerException if threadFactory is null
-//	     */
-//	    public static ScheduledExecutorService newScheduledThreadPool(
-//	            int corePoolSize, ThreadFactory threadFactory) {
-//	        return new ScheduledThreadPoolExecutor(corePoolSize, threadFactory);
-//	    }
+	/**
+	 * Creates a single-threaded executor that can schedule commands
+	 * to run after a given delay, or to execute periodically.
+	 * (Note however that if this single
+	 * thread terminates due to a failure during execution prior to
+	 * shutdown, a new one will take its place if needed to execute
+	 * subsequent tasks.)  Tasks are guaranteed to execute
+	 * sequentially, and no more than one task will be active at any
+	 * given time.
+	 * @return the newly created scheduled executor
+	 */
+	static EScheduledExecutorService* newSingleThreadScheduledExecutor();
+
+	/**
+	 * Creates a single-threaded executor that can schedule commands
+	 * to run after a given delay, or to execute periodically, using
+	 * the provided ThreadFactory to create the thread.
+	 * @param threadFactory the factory to use when creating new
+	 * threads
+	 * @return a newly created scheduled executor
+	 * @throws NullPointerException if threadFactory is null
+	 */
+	static EScheduledExecutorService* newSingleThreadScheduledExecutor(sp<EThreadFactory> threadFactory);
+
+	/**
+	 * Creates a thread pool that can schedule commands to run after a
+	 * given delay, or to execute periodically.
+	 * @param corePoolSize the number of threads to keep in the pool,
+	 * even if they are idle.
+	 * @return a newly created scheduled thread pool
+	 * @throws IllegalArgumentException if {@code corePoolSize < 0}
+	 */
+	static EScheduledExecutorService* newScheduledThreadPool(int corePoolSize);
+
+	/**
+	 * Creates a thread pool that can schedule commands to run after a
+	 * given delay, or to execute periodically.
+	 * @param corePoolSize the number of threads to keep in the pool,
+	 * even if they are idle.
+	 * @param threadFactory the factory to use when the executor
+	 * creates a new thread.
+	 * @return a newly created scheduled thread pool
+	 * @throws IllegalArgumentException if {@code corePoolSize < 0}
+	 * @throws NullPointerException if threadFactory is null
+	 */
+	static EScheduledExecutorService* newScheduledThreadPool(
+			int corePoolSize, sp<EThreadFactory> threadFactory);
+
 //
 //
 //	    /**
@@ -449,5 +478,43 @@ public:
 #endif
 };
 
+//=============================================================================
+
+inline EExecutorService* EExecutors::newWorkStealingPool(int parallelism) {
+	return new EForkJoinPool(parallelism,
+			EForkJoinPool::defaultForkJoinWorkerThreadFactory, true);
+}
+
+inline EExecutorService* EExecutors::newAffinityThreadPool(int nThreads, boolean pinThreads) {
+	sp<EThreadFactory> factory = pinThreads ?
+			sp<EThreadFactory>(new EAffinityThreadFactory()) : defaultThreadFactory();
+	return new EThreadPoolExecutor(nThreads, nThreads, 0L, ETimeUnit::MILLISECONDS,
+			new EWorkerLocalQueue<ERunnable>(new ELinkedBlockingQueue<ERunnable>()),
+			factory);
+}
+
+inline EExecutorService* EExecutors::newWorkStealingPool() {
+	return new EForkJoinPool(ERuntime::getRuntime()->availableProcessors(),
+			EForkJoinPool::defaultForkJoinWorkerThreadFactory, true);
+}
+
+inline EScheduledExecutorService* EExecutors::newSingleThreadScheduledExecutor() {
+	return new EScheduledThreadPoolExecutor(1);
+}
+
+inline EScheduledExecutorService* EExecutors::newSingleThreadScheduledExecutor(
+		sp<EThreadFactory> threadFactory) {
+	return new EScheduledThreadPoolExecutor(1, threadFactory);
+}
+
+inline EScheduledExecutorService* EExecutors::newScheduledThreadPool(int corePoolSize) {
+	return new EScheduledThreadPoolExecutor(corePoolSize);
+}
+
+inline EScheduledExecutorService* EExecutors::newScheduledThreadPool(
+		int corePoolSize, sp<EThreadFactory> threadFactory) {
+	return new EScheduledThreadPoolExecutor(corePoolSize, threadFactory);
+}
+
 } /* namespace efc */
 #endif /* EEXECUTORS_HH_ */
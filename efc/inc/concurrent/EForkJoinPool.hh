@@ -0,0 +1,556 @@
+/*
+ * EForkJoinPool.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EFORKJOINPOOL_HH_
+#define EFORKJOINPOOL_HH_
+
+#include "../ETimeUnit.hh"
+#include "../ERunnable.hh"
+#include "../ECondition.hh"
+#include "../ESimpleLock.hh"
+#include "../EArrayList.hh"
+#include "./EForkJoinTask.hh"
+#include "./EForkJoinWorkerThread.hh"
+#include "./EAbstractExecutorService.hh"
+#include "./ERejectedExecutionException.hh"
+#include "../EIllegalArgumentException.hh"
+
+namespace efc {
+
+//@see: openjdk-8/src/share/classes/java/util/concurrent/ForkJoinPool.java
+
+namespace fjp {
+	class WorkQueue;
+}
+
+/**
+ * An {@link EExecutorService} for running {@link EForkJoinTask}s.
+ * A {@code EForkJoinPool} provides the entry point for submissions
+ * from non-{@code EForkJoinTask} clients, as well as management and
+ * monitoring operations.
+ *
+ * <p>A {@code EForkJoinPool} differs from other kinds of {@link
+ * EExecutorService} mainly by virtue of employing
+ * <em>work-stealing</em>: all threads in the pool attempt to find and
+ * execute tasks submitted to the pool and/or created by other active
+ * tasks (eventually blocking waiting for work if none exist). This
+ * enables efficient processing when most tasks spawn other subtasks
+ * (as do most {@code EForkJoinTask}s), as well as when many small
+ * tasks are submitted to the pool from external clients.  Especially
+ * when setting <em>asyncMode</em> to true in constructors, {@code
+ * EForkJoinPool}s may also be appropriate for use with event-style
+ * tasks that are never joined.
+ *
+ * <p>A static {@link #commonPool()} is available and appropriate for
+ * most applications. The common pool is used by any EForkJoinTask that
+ * is not explicitly submitted to a specified pool.
+ *
+ * <p>For applications that require separate or custom pools, a {@code
+ * EForkJoinPool} may be constructed with a given target parallelism
+ * level; by default, equal to the number of available processors.
+ * The pool attempts to maintain enough active (or available) threads
+ * by dynamically adding, suspending, or resuming internal worker
+ * threads, even if some tasks are stalled waiting to join others.
+ *
+ * <p>Implementation overview: each worker owns a work queue that it
+ * uses as a stack (LIFO push/pop at the top) and that other workers
+ * steal from in FIFO order at the base.  Slots are claimed by CAS, so
+ * pushes and pops by the owner never lock and thieves only contend
+ * with each other on the slot they are trying to take.  External
+ * submissions go to a small set of shared queues guarded by a
+ * per-queue spin lock and selected by hashing the submitting thread.
+ * Idle workers scan all queues starting at a random index before
+ * parking; a worker blocked in {@link EForkJoinTask#join} first runs
+ * its own queued subtasks and then steals, so joins rarely block.
+ *
+ * <p><b>Implementation notes</b>: This implementation restricts the
+ * maximum number of running threads to 32767. Attempts to create
+ * pools with greater than the maximum number result in
+ * {@code EIllegalArgumentException}.
+ *
+ * <p>This implementation rejects submitted tasks (that is, by throwing
+ * {@link ERejectedExecutionException}) only when the pool is shut down.
+ *
+ * @since 1.7
+ */
+
+class EForkJoinPool: public EAbstractExecutorService {
+public:
+	DECLARE_STATIC_INITZZ;
+
+public:
+	/**
+	 * Factory for creating new {@link EForkJoinWorkerThread}s.
+	 * A {@code ForkJoinWorkerThreadFactory} must be defined and used
+	 * for {@code EForkJoinWorkerThread} subclasses that extend base
+	 * functionality or initialize threads with different contexts.
+	 */
+	interface ForkJoinWorkerThreadFactory : virtual public EObject {
+		virtual ~ForkJoinWorkerThreadFactory() {
+		}
+
+		/**
+		 * Returns a new worker thread operating in the given pool.
+		 *
+		 * @param pool the pool this thread works in
+		 * @return the new worker thread
+		 */
+		virtual EForkJoinWorkerThread* newThread(EForkJoinPool* pool) = 0;
+	};
+
+	/**
+	 * Creates a new EForkJoinWorkerThread. This factory is used unless
+	 * overridden in EForkJoinPool constructors.
+	 */
+	static sp<ForkJoinWorkerThreadFactory> defaultForkJoinWorkerThreadFactory;
+
+public:
+	virtual ~EForkJoinPool();
+
+	/**
+	 * Creates a {@code EForkJoinPool} with parallelism equal to {@link
+	 * ERuntime#availableProcessors}, using the {@linkplain
+	 * #defaultForkJoinWorkerThreadFactory default thread factory}
+	 * and LIFO processing of local tasks.
+	 */
+	EForkJoinPool();
+
+	/**
+	 * Creates a {@code EForkJoinPool} with the indicated parallelism
+	 * level, the {@linkplain #defaultForkJoinWorkerThreadFactory
+	 * default thread factory} and LIFO processing of local tasks.
+	 *
+	 * @param parallelism the parallelism level
+	 * @throws EIllegalArgumentException if parallelism less than or
+	 *         equal to zero, or greater than implementation limit
+	 */
+	EForkJoinPool(int parallelism);
+
+	/**
+	 * Creates a {@code EForkJoinPool} with the given parameters.
+	 *
+	 * @param parallelism the parallelism level. For default value,
+	 * use {@link ERuntime#availableProcessors}.
+	 * @param factory the factory for creating new threads. For default value,
+	 * use {@link #defaultForkJoinWorkerThreadFactory}.
+	 * @param asyncMode if true,
+	 * establishes local first-in-first-out scheduling mode for forked
+	 * tasks that are never joined. This mode may be more appropriate
+	 * than default locally stack-based mode in applications in which
+	 * worker threads only process event-style asynchronous tasks.
+	 * For default value, use {@code false}.
+	 * @throws EIllegalArgumentException if parallelism less than or
+	 *         equal to zero, or greater than implementation limit
+	 * @throws ENullPointerException if the factory is null
+	 */
+	EForkJoinPool(int parallelism, sp<ForkJoinWorkerThreadFactory> factory,
+			boolean asyncMode);
+
+	/**
+	 * Returns the common pool instance. This pool is statically
+	 * constructed; its run state is unaffected by attempts to {@link
+	 * #shutdown} or {@link #shutdownNow}. Its parallelism is one less
+	 * than the number of available processors (at least one), and its
+	 * worker threads are daemons.
+	 *
+	 * @return the common pool instance
+	 */
+	static EForkJoinPool* commonPool();
+
+	/**
+	 * Returns the targeted parallelism level of the common pool.
+	 *
+	 * @return the targeted parallelism level of the common pool
+	 */
+	static int getCommonPoolParallelism();
+
+	// Execution methods
+
+	/**
+	 * Performs the given task, returning its result upon completion.
+	 * If the computation encounters an unchecked Exception or Error,
+	 * it is rethrown as the outcome of this invocation.
+	 *
+	 * @param task the task
+	 * @return the task's result
+	 * @throws ENullPointerException if the task is null
+	 * @throws ERejectedExecutionException if the task cannot be
+	 *         scheduled for execution
+	 */
+	template<typename T>
+	sp<T> invoke(sp<EForkJoinTask<T> > task) {
+		if (task == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		externalPush(task);
+		return task->join();
+	}
+
+	/**
+	 * Arranges for (asynchronous) execution of the given command.
+	 * The command is wrapped in a {@code EForkJoinTask} that runs it.
+	 *
+	 * @throws ENullPointerException if the task is null
+	 * @throws ERejectedExecutionException if the task cannot be
+	 *         scheduled for execution
+	 */
+	virtual void execute(sp<ERunnable> task);
+
+	/**
+	 * Submits a EForkJoinTask for execution.
+	 *
+	 * @param task the task to submit
+	 * @return the task
+	 * @throws ENullPointerException if the task is null
+	 * @throws ERejectedExecutionException if the task cannot be
+	 *         scheduled for execution
+	 */
+	template<typename T>
+	sp<EForkJoinTask<T> > submit(sp<EForkJoinTask<T> > task) {
+		if (task == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		externalPush(task);
+		return task;
+	}
+
+	/**
+	 * {@inherit from super for c++ hides overloaded template function}
+	 */
+	using EAbstractExecutorService::submit;
+
+	/**
+	 * Returns the factory used for constructing new workers.
+	 *
+	 * @return the factory used for constructing new workers
+	 */
+	sp<ForkJoinWorkerThreadFactory> getFactory();
+
+	/**
+	 * Returns the targeted parallelism level of this pool.
+	 *
+	 * @return the targeted parallelism level of this pool
+	 */
+	int getParallelism();
+
+	/**
+	 * Returns the number of worker threads that have started but not
+	 * yet terminated.
+	 *
+	 * @return the number of worker threads
+	 */
+	int getPoolSize();
+
+	/**
+	 * Returns {@code true} if this pool uses local first-in-first-out
+	 * scheduling mode for forked tasks that are never joined.
+	 *
+	 * @return {@code true} if this pool uses async mode
+	 */
+	boolean getAsyncMode();
+
+	/**
+	 * Returns an estimate of the number of threads that are currently
+	 * stealing or executing tasks. This method may overestimate the
+	 * number of active threads.
+	 *
+	 * @return the number of active threads
+	 */
+	int getActiveThreadCount();
+
+	/**
+	 * Returns {@code true} if all worker threads are currently idle.
+	 * An idle worker is one that cannot obtain a task to execute
+	 * because none are available to steal from other threads, and
+	 * there are no pending submissions to the pool.
+	 *
+	 * @return {@code true} if all threads are currently idle
+	 */
+	boolean isQuiescent();
+
+	/**
+	 * Returns an estimate of the total number of tasks stolen from
+	 * one thread's work queue by another. The reported value
+	 * underestimates the actual total number of steals when the pool
+	 * is not quiescent. This value may be useful for monitoring and
+	 * tuning fork/join programs: in general, steal counts should be
+	 * high enough to keep threads busy, but low enough to avoid
+	 * overhead and contention across threads.
+	 *
+	 * @return the number of steals
+	 */
+	llong getStealCount();
+
+	/**
+	 * Returns an estimate of the total number of tasks currently held
+	 * in queues by worker threads (but not including tasks submitted
+	 * to the pool that have not begun executing).
+	 *
+	 * @return the number of queued tasks
+	 */
+	llong getQueuedTaskCount();
+
+	/**
+	 * Returns an estimate of the number of tasks submitted to this
+	 * pool that have not yet begun executing.  This method may take
+	 * time proportional to the number of submissions.
+	 *
+	 * @return the number of queued submissions
+	 */
+	int getQueuedSubmissionCount();
+
+	/**
+	 * Returns {@code true} if there are any tasks submitted to this
+	 * pool that have not yet begun executing.
+	 *
+	 * @return {@code true} if there are any queued submissions
+	 */
+	boolean hasQueuedSubmissions();
+
+	/**
+	 * Returns a string identifying this pool, as well as its state,
+	 * including indications of run state, parallelism level, and
+	 * worker and task counts.
+	 *
+	 * @return a string identifying this pool, as well as its state
+	 */
+	virtual EStringBase toString();
+
+	/**
+	 * Possibly initiates an orderly shutdown in which previously
+	 * submitted tasks are executed, but no new tasks will be
+	 * accepted. Invocation has no effect on execution state if this
+	 * is the {@link #commonPool()}, and no additional effect if
+	 * already shut down.  Tasks that are in the process of being
+	 * submitted concurrently during the course of this method may or
+	 * may not be rejected.
+	 */
+	virtual void shutdown();
+
+	/**
+	 * Possibly attempts to cancel and/or stop all tasks, and reject
+	 * all subsequently submitted tasks.  Invocation has no effect on
+	 * execution state if this is the {@link #commonPool()}, and no
+	 * additional effect if already shut down. Otherwise, tasks that
+	 * are in the process of being submitted or executed concurrently
+	 * during the course of this method may or may not be
+	 * rejected. This method cancels both existing and unexecuted
+	 * tasks, in order to permit termination in the presence of task
+	 * dependencies. So the method always returns an empty list
+	 * (unlike the case for some other Executors).
+	 *
+	 * @return an empty list
+	 */
+	virtual EArrayList<sp<ERunnable> > shutdownNow();
+
+	/**
+	 * Returns {@code true} if all tasks have completed following shut down.
+	 *
+	 * @return {@code true} if all tasks have completed following shut down
+	 */
+	virtual boolean isTerminated();
+
+	/**
+	 * Returns {@code true} if the process of termination has
+	 * commenced but not yet completed.
+	 *
+	 * @return {@code true} if terminating but not yet terminated
+	 */
+	boolean isTerminating();
+
+	/**
+	 * Returns {@code true} if this pool has been shut down.
+	 *
+	 * @return {@code true} if this pool has been shut down
+	 */
+	virtual boolean isShutdown();
+
+	/**
+	 * Blocks until all tasks have completed execution after a
+	 * shutdown request, or the timeout occurs, or the current thread
+	 * is interrupted, whichever happens first. Because the {@link
+	 * #commonPool()} never terminates until program shutdown, when
+	 * applied to the common pool, this method is equivalent to {@link
+	 * #awaitQuiescence(llong, ETimeUnit*)} but always returns {@code false}.
+	 *
+	 * @param timeout the maximum time to wait
+	 * @param unit the time unit of the timeout argument
+	 * @return {@code true} if this executor terminated and
+	 *         {@code false} if the timeout elapsed before termination
+	 * @throws EInterruptedException if interrupted while waiting
+	 */
+	virtual boolean awaitTermination() THROWS(EInterruptedException);
+	virtual boolean awaitTermination(llong timeout, ETimeUnit* unit) THROWS(EInterruptedException);
+
+	/**
+	 * If called by a EForkJoinTask operating in this pool, equivalent
+	 * in effect to {@link EForkJoinTask#helpQuiesce}. Otherwise,
+	 * waits and/or attempts to assist performing tasks until this
+	 * pool {@link #isQuiescent} or the indicated timeout elapses.
+	 *
+	 * @param timeout the maximum time to wait
+	 * @param unit the time unit of the timeout argument
+	 * @return {@code true} if quiescent; {@code false} if the
+	 * timeout elapsed.
+	 */
+	boolean awaitQuiescence(llong timeout, ETimeUnit* unit);
+
+protected:
+	friend class EForkJoinTaskType;
+	friend class EForkJoinWorkerThread;
+
+	/**
+	 * Pushes a possibly-external submission.
+	 */
+	void externalPush(sp<EForkJoinTaskType> task);
+
+	/**
+	 * Pushes a task forked by the given worker onto its own queue.
+	 */
+	void workerPush(fjp::WorkQueue* w, EForkJoinTaskType* task);
+
+	/**
+	 * Pops the given task only if it is at the current top of the
+	 * given worker's queue.
+	 */
+	boolean tryUnpush(fjp::WorkQueue* w, EForkJoinTaskType* task);
+
+	/**
+	 * Helps and/or blocks until the given task is done.  While
+	 * waiting, the worker runs its own queued subtasks and steals
+	 * from other queues.
+	 *
+	 * @param w caller
+	 * @param task the task
+	 * @return task status on exit
+	 */
+	int awaitJoin(fjp::WorkQueue* w, EForkJoinTaskType* task);
+
+	/**
+	 * Runs tasks until {@code isQuiescent()}.
+	 */
+	void helpQuiescePool(fjp::WorkQueue* w);
+
+	/**
+	 * Returns the number of tasks queued by the given worker, and the
+	 * surplus relative to the number of idle workers.
+	 */
+	int queuedCount(fjp::WorkQueue* w);
+	int surplusCount(fjp::WorkQueue* w);
+
+	/**
+	 * Returns the index of the given worker's queue in this pool.
+	 */
+	int workerIndex(fjp::WorkQueue* w);
+
+	/**
+	 * Top-level runloop for workers, called by EForkJoinWorkerThread::run.
+	 */
+	void runWorker(fjp::WorkQueue* w);
+
+	/**
+	 * Callback from EForkJoinWorkerThread constructor to establish and
+	 * record its WorkQueue.
+	 */
+	fjp::WorkQueue* registerWorker(EForkJoinWorkerThread* wt);
+
+	/**
+	 * Final callback from terminating worker.
+	 */
+	void deregisterWorker(EForkJoinWorkerThread* wt, EThrowable* ex);
+
+private:
+	// Bounds
+	static const int MAX_CAP = 0x7fff;        // max #workers - 1
+
+	// Run states
+	enum {
+		RUNNING    = 0,
+		SHUTDOWN   = 1,
+		STOP       = 2,
+		TERMINATED = 3
+	};
+
+	volatile int runState;
+	int parallelism;
+	boolean asyncMode;
+	boolean isCommon;
+	int poolNumber;             // for worker thread names
+	sp<ForkJoinWorkerThreadFactory> factory;
+
+	/**
+	 * Queues: indices [0, parallelism) belong to workers, the rest
+	 * are shared submission queues.  The array never changes after
+	 * construction so it can be scanned without locking.
+	 */
+	fjp::WorkQueue** workQueues;
+	int nQueues;
+	int submitMask;
+
+	/** Worker threads, joined and deleted on destruction. */
+	EForkJoinWorkerThread** workers;
+
+	volatile int started;
+	volatile int workerCount;   // registered and not yet deregistered
+
+	/** Guards the idle stack, startup and termination. */
+	ESimpleLock mainLock;
+	ECondition* termination;
+	fjp::WorkQueue* idleStack;
+	volatile int idleCount;
+
+	static EForkJoinPool* volatile common;
+
+	void init(int parallelism, sp<ForkJoinWorkerThreadFactory> factory,
+			boolean asyncMode);
+
+	/**
+	 * Creates and starts all workers on first use.
+	 */
+	void ensureStarted();
+
+	/**
+	 * Wakes an idle worker if there is one.
+	 */
+	void signalWork();
+
+	/**
+	 * Scans for and, if found, takes a task from some other queue.
+	 */
+	EForkJoinTaskType* scan(fjp::WorkQueue* w);
+
+	/**
+	 * Parks an idle worker until signalled.
+	 *
+	 * @return false if the worker should exit
+	 */
+	boolean awaitWork(fjp::WorkQueue* w);
+
+	/**
+	 * Returns true if any queue holds a task.
+	 */
+	boolean hasQueuedTasks();
+
+	/**
+	 * Transitions to STOP once shut down and quiescent; must be
+	 * called holding mainLock.
+	 */
+	void tryTerminateLocked(boolean now);
+
+	/**
+	 * Removes (and cancels) all queued tasks.
+	 */
+	void cancelAllQueued();
+
+	/**
+	 * Runs the given task removed from some queue.
+	 */
+	static void runTask(EForkJoinTaskType* t);
+
+	static int availableProcessors();
+};
+
+} /* namespace efc */
+#endif /* EFORKJOINPOOL_HH_ */
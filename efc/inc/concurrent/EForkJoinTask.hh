@@ -0,0 +1,556 @@
+/*
+ * EForkJoinTask.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EFORKJOINTASK_HH_
+#define EFORKJOINTASK_HH_
+
+#include "./EFuture.hh"
+#include "../ESharedPtr.hh"
+#include "../EThrowable.hh"
+#include "../ETimeUnit.hh"
+#include "../ERuntimeException.hh"
+#include "../ENullPointerException.hh"
+#include "../EInterruptedException.hh"
+#include "./EExecutionException.hh"
+#include "./ECancellationException.hh"
+#include "./ETimeoutException.hh"
+
+namespace efc {
+
+//@see: openjdk-8/src/share/classes/java/util/concurrent/ForkJoinTask.java
+
+class EForkJoinPool;
+class EForkJoinWorkerThread;
+
+/**
+ * The result-type independent part of {@link EForkJoinTask}: completion
+ * status, waiting joiners and the hooks used by {@link EForkJoinPool}
+ * to queue, steal and run tasks of any result type.
+ *
+ * <p>Tasks are queued by raw pointer inside the per-worker deques.
+ * While a task sits in a queue the pool keeps it alive through a
+ * reference taken from the task's owning {@code sp<>}, so tasks that
+ * are forked should always be created with {@code new} and held by an
+ * {@code sp<>}, as in {@code sp<Fib> f = new Fib(n - 1); f->fork();}.
+ */
+
+abstract class EForkJoinTaskType : virtual public EObject,
+		public enable_shared_from_this<EForkJoinTaskType> {
+public:
+	virtual ~EForkJoinTaskType();
+
+	EForkJoinTaskType();
+
+	/**
+	 * Arranges to asynchronously execute this task in the pool the
+	 * current task is running in, if applicable, or using the {@link
+	 * EForkJoinPool#commonPool()} if not {@link #inForkJoinPool}.
+	 * While it is not necessarily enforced, it is a usage error to
+	 * fork a task more than once unless it has completed and been
+	 * reinitialized.
+	 */
+	void forkTask();
+
+	/**
+	 * Returns {@code true} if this task completed.
+	 */
+	boolean isTaskDone();
+
+	/**
+	 * Returns {@code true} if this task was cancelled before it
+	 * completed normally.
+	 */
+	boolean isTaskCancelled();
+
+	/**
+	 * Returns {@code true} if this task threw an exception or was cancelled.
+	 *
+	 * @return {@code true} if this task threw an exception or was cancelled
+	 */
+	boolean isCompletedAbnormally();
+
+	/**
+	 * Returns {@code true} if this task completed without throwing an
+	 * exception and was not cancelled.
+	 *
+	 * @return {@code true} if this task completed without throwing an
+	 * exception and was not cancelled
+	 */
+	boolean isCompletedNormally();
+
+	/**
+	 * Returns the exception thrown by the base computation, or a
+	 * {@code ECancellationException} if cancelled, or {@code null} if
+	 * none or if the method has not yet completed.
+	 *
+	 * @return the exception, or {@code null} if none
+	 */
+	sp<EThrowable> getException();
+
+	/**
+	 * Attempts to cancel execution of this task. This attempt will
+	 * fail if the task has already completed or could not be
+	 * cancelled for some other reason.
+	 *
+	 * @param mayInterruptIfRunning this value has no effect in the
+	 * default implementation because interrupts are not used to
+	 * control cancellation.
+	 *
+	 * @return {@code true} if this task is now cancelled
+	 */
+	boolean cancelTask(boolean mayInterruptIfRunning);
+
+	/**
+	 * Joins this task, without returning its result or throwing its
+	 * exception. This method may be useful when processing
+	 * collections of tasks when some have been cancelled or otherwise
+	 * known to have aborted.
+	 */
+	void quietlyJoin();
+
+	/**
+	 * Commences performing this task and awaits its completion if
+	 * necessary, without returning its result or throwing its
+	 * exception.
+	 */
+	void quietlyInvoke();
+
+	/**
+	 * Tries to unschedule this task for execution. This method will
+	 * typically (but is not guaranteed to) succeed if this task is
+	 * the most recently forked task by the current thread, and has
+	 * not commenced executing in another thread.
+	 *
+	 * @return {@code true} if unforked
+	 */
+	boolean tryUnfork();
+
+	/**
+	 * Resets the internal bookkeeping state of this task, allowing a
+	 * subsequent {@code fork}. This method allows repeated reuse of
+	 * this task, but only if reuse occurs when this task has either
+	 * never been forked, or has been forked, then completed and all
+	 * outstanding joins of this task have also completed.
+	 */
+	virtual void reinitialize();
+
+	/**
+	 * Forks the given tasks, returning when {@code isDone} holds for
+	 * each task or an (unchecked) exception is encountered, in which
+	 * case the exception is rethrown.
+	 *
+	 * @param t1 the first task
+	 * @param t2 the second task
+	 * @throws ENullPointerException if any task is null
+	 */
+	static void invokeAll(sp<EForkJoinTaskType> t1, sp<EForkJoinTaskType> t2);
+
+	/**
+	 * Returns the pool hosting the current task execution, or null
+	 * if this task is executing outside of any EForkJoinPool.
+	 *
+	 * @return the pool, or {@code null} if none
+	 */
+	static EForkJoinPool* getPool();
+
+	/**
+	 * Returns {@code true} if the current thread is a {@link
+	 * EForkJoinWorkerThread} executing as a EForkJoinPool computation.
+	 *
+	 * @return {@code true} if the current thread is a {@link
+	 * EForkJoinWorkerThread} executing as a EForkJoinPool computation,
+	 * or {@code false} otherwise
+	 */
+	static boolean inForkJoinPool();
+
+	/**
+	 * Returns an estimate of the number of tasks that have been
+	 * forked by the current worker thread but not yet executed. This
+	 * value may be useful for heuristic decisions about whether to
+	 * fork other tasks.
+	 *
+	 * @return the number of tasks
+	 */
+	static int getQueuedTaskCount();
+
+	/**
+	 * Returns an estimate of how many more locally queued tasks are
+	 * held by the current worker thread than there are other worker
+	 * threads that might steal them, or zero if this thread is not
+	 * operating in a EForkJoinPool. This value may be useful for
+	 * heuristic decisions about whether to fork other tasks. In many
+	 * usages of EForkJoinTasks, at steady state, each worker should
+	 * aim to maintain a small constant surplus (for example, 3) of
+	 * tasks, and to process computations locally if this threshold
+	 * is exceeded.
+	 *
+	 * @return the surplus number of tasks, which may be negative
+	 */
+	static int getSurplusQueuedTaskCount();
+
+	/**
+	 * Possibly executes tasks until the pool hosting the current task
+	 * {@link EForkJoinPool#isQuiescent is quiescent}. This method may
+	 * be of use in designs in which many tasks are forked, but none
+	 * are explicitly joined, instead executing them until all are
+	 * processed.
+	 */
+	static void helpQuiesce();
+
+protected:
+	friend class EForkJoinPool;
+
+	/**
+	 * Immediately performs the base action of this task and returns
+	 * true if, upon return from this method, this task is guaranteed
+	 * to have completed normally. This method may return false
+	 * otherwise, to indicate that this task is not necessarily
+	 * complete (or is not known to be complete), for example in
+	 * asynchronous actions that require explicit invocations of
+	 * completion methods. This method may also throw an (unchecked)
+	 * exception to indicate abnormal exit.
+	 *
+	 * @return {@code true} if this task is known to have completed normally
+	 */
+	virtual boolean exec() = 0;
+
+	/**
+	 * Completes this task abnormally, and if not already aborted or
+	 * cancelled, causes it to throw the given exception upon
+	 * {@code join} and related operations.
+	 *
+	 * @param ex the exception to throw.
+	 */
+	void completeExceptionally(EThrowable& ex);
+
+	/**
+	 * Completes this task normally without setting a value.
+	 */
+	void quietlyComplete();
+
+	/*
+	 * The status field holds run control status bits packed into a
+	 * single int to minimize footprint and to ensure atomicity (via
+	 * CAS).  Status is initially zero, and takes on nonnegative
+	 * values until completed, upon which status (anded with
+	 * DONE_MASK) holds value NORMAL, CANCELLED, or EXCEPTIONAL. Tasks
+	 * undergoing blocking waits by other threads have the SIGNAL bit
+	 * set.
+	 */
+	volatile int status;
+
+	static const int DONE_MASK   = 0xf0000000;  // mask out non-completion bits
+	static const int NORMAL      = 0xf0000000;  // must be negative
+	static const int CANCELLED   = 0xc0000000;  // must be < NORMAL
+	static const int EXCEPTIONAL = 0x80000000;  // must be < CANCELLED
+	static const int SIGNAL      = 0x00010000;  // must be >= 1 << 16
+	static const int SMASK       = 0x0000ffff;  // short bits for tags
+
+	/**
+	 * Primary execution method for stolen tasks. Unless done, calls
+	 * exec and records status if completed, but doesn't wait for
+	 * completion otherwise.
+	 *
+	 * @return status on exit from this method
+	 */
+	int doExec();
+
+	/**
+	 * Implementation for join, get, quietlyJoin. Directly handles
+	 * only cases of already-completed, external wait, and
+	 * unfork+exec.  Others are relayed to EForkJoinPool::awaitJoin.
+	 *
+	 * @return status upon completion
+	 */
+	int doJoin();
+
+	/**
+	 * Implementation for invoke, quietlyInvoke.
+	 *
+	 * @return status upon completion
+	 */
+	int doInvoke();
+
+	/**
+	 * Blocks a non-worker-thread until completion, or until the
+	 * timeout (if timed) elapses.
+	 *
+	 * @return status upon completion, or the (non-negative) status
+	 * if the wait timed out
+	 */
+	int externalAwaitDone(boolean interruptible, boolean timed, llong nanos)
+			THROWS(EInterruptedException);
+
+	/**
+	 * Throws the exception associated with the given status, if any.
+	 */
+	void reportException(int s);
+
+	/**
+	 * Throws the exception associated with the given status for
+	 * {@link EFuture#get}, if any.
+	 */
+	void reportGetException(int s) THROWS(EExecutionException);
+
+private:
+	friend class EForkJoinWorkerThread;
+
+	/**
+	 * Nodes of threads blocked in join/get; they live on the waiting
+	 * thread's stack and are linked under {@code waitLock}.
+	 */
+	struct WaitNode {
+		EThread* volatile thread;
+		WaitNode* next;
+	};
+
+	/** Stack of waiting threads, guarded by waitLock. */
+	WaitNode* waiters;
+	volatile int waitLock;
+
+	/** The exception thrown by exec, or null. */
+	sp<EThrowable> exception;
+
+	/**
+	 * The reference that keeps this task alive while it is queued;
+	 * set by the thread that pushes it, taken over by the thread that
+	 * removes it from the queue.
+	 */
+	sp<EForkJoinTaskType> pinned;
+
+	/**
+	 * Marks completion and wakes up threads waiting to join this
+	 * task.
+	 *
+	 * @param completion one of NORMAL, CANCELLED, EXCEPTIONAL
+	 * @return completion status on exit
+	 */
+	int setCompletion(int completion);
+
+	/**
+	 * Records exception and sets status.
+	 *
+	 * @return status on exit
+	 */
+	int setExceptionalCompletion(EThrowable* ex);
+
+	/**
+	 * Takes a reference to this task for the duration it is queued.
+	 */
+	void pin();
+
+	/**
+	 * Releases the queued reference; the caller becomes responsible
+	 * for keeping the task alive while running it.
+	 */
+	sp<EForkJoinTaskType> unpin();
+
+	void lockWaiters();
+	void unlockWaiters();
+
+	/**
+	 * Blocks the current thread until this task is done or, if timed,
+	 * the timeout elapses.
+	 */
+	int awaitDone(boolean interruptible, boolean timed, llong nanos)
+			THROWS(EInterruptedException);
+
+	static EForkJoinWorkerThread* currentWorker();
+};
+
+/**
+ * Abstract base class for tasks that run within a {@link EForkJoinPool}.
+ * A {@code EForkJoinTask} is a thread-like entity that is much
+ * lighter weight than a normal thread.  Huge numbers of tasks and
+ * subtasks may be hosted by a small number of actual threads in a
+ * EForkJoinPool, at the price of some usage limitations.
+ *
+ * <p>A "main" {@code EForkJoinTask} begins execution when it is
+ * explicitly submitted to a {@link EForkJoinPool}, or, if not already
+ * engaged in a ForkJoin computation, commenced in the {@link
+ * EForkJoinPool#commonPool()} via {@link #fork}, or {@link #invoke}.
+ * Once started, it will usually in turn start other subtasks.  As
+ * indicated by the name of this class, many programs using {@code
+ * EForkJoinTask} employ only methods {@link #fork} and {@link
+ * #join}, or derivatives such as {@link #invokeAll(EForkJoinTask, EForkJoinTask)
+ * invokeAll}.
+ *
+ * <p>The primary coordination mechanisms are {@link #fork}, that
+ * arranges asynchronous execution, and {@link #join}, that doesn't
+ * proceed until the task's result has been computed.  Computations
+ * should ideally avoid {@code synchronized} methods or blocks, and
+ * should minimize other blocking synchronization apart from joining
+ * other tasks.
+ *
+ * <p>Most base support methods are {@code final}, to prevent
+ * overriding of implementations that are intrinsically tied to the
+ * underlying lightweight task scheduling framework.  Developers
+ * creating new basic styles of fork/join processing should minimally
+ * implement {@code protected} methods {@link #exec}, {@link
+ * #setRawResult}, and {@link #getRawResult}. Usually it is
+ * simpler to subclass {@link ERecursiveAction} or {@link ERecursiveTask}.
+ *
+ * <p>EForkJoinTasks should perform relatively small amounts of
+ * computation. Large tasks should be split into smaller subtasks,
+ * usually via recursive decomposition. As a very rough rule of thumb,
+ * a task should perform more than 100 and less than 10000 basic
+ * computational steps, and should avoid indefinite looping.
+ *
+ * @since 1.7
+ */
+
+template<typename V>
+abstract class EForkJoinTask : public EForkJoinTaskType, virtual public EFuture<V> {
+public:
+	virtual ~EForkJoinTask() {
+	}
+
+	/**
+	 * Arranges to asynchronously execute this task in the pool the
+	 * current task is running in, if applicable, or using the {@link
+	 * EForkJoinPool#commonPool()} if not {@link #inForkJoinPool}.
+	 *
+	 * @return {@code this}, to simplify usage
+	 */
+	EForkJoinTask<V>* fork() {
+		forkTask();
+		return this;
+	}
+
+	/**
+	 * Returns the result of the computation when it {@link #isDone is
+	 * done}.  This method differs from {@link #get()} in that
+	 * abnormal completion results in {@code ERuntimeException} or
+	 * {@code ECancellationException}, not {@code EExecutionException},
+	 * and that interrupts of the calling thread do <em>not</em> cause
+	 * the method to abruptly return by throwing {@code
+	 * EInterruptedException}.
+	 *
+	 * @return the computed result
+	 */
+	sp<V> join() {
+		int s;
+		if ((s = doJoin() & DONE_MASK) != NORMAL)
+			reportException(s);
+		return getRawResult();
+	}
+
+	/**
+	 * Commences performing this task, awaits its completion if
+	 * necessary, and returns its result, or throws an (unchecked)
+	 * {@code ERuntimeException} if the underlying computation did so.
+	 *
+	 * @return the computed result
+	 */
+	sp<V> invoke() {
+		int s;
+		if ((s = doInvoke() & DONE_MASK) != NORMAL)
+			reportException(s);
+		return getRawResult();
+	}
+
+	virtual boolean cancel(boolean mayInterruptIfRunning) {
+		return cancelTask(mayInterruptIfRunning);
+	}
+
+	virtual boolean isDone() {
+		return isTaskDone();
+	}
+
+	virtual boolean isCancelled() {
+		return isTaskCancelled();
+	}
+
+	/**
+	 * Waits if necessary for the computation to complete, and then
+	 * retrieves its result.
+	 *
+	 * @return the computed result
+	 * @throws ECancellationException if the computation was cancelled
+	 * @throws EExecutionException if the computation threw an
+	 * exception
+	 * @throws EInterruptedException if the current thread is not a
+	 * member of a EForkJoinPool and was interrupted while waiting
+	 */
+	virtual sp<V> get() THROWS2(EInterruptedException, EExecutionException) {
+		int s = inForkJoinPool() ? doJoin() :
+			externalAwaitDone(true, false, 0L);
+		if ((s &= DONE_MASK) != NORMAL)
+			reportGetException(s);
+		return getRawResult();
+	}
+
+	/**
+	 * Waits if necessary for at most the given time for the computation
+	 * to complete, and then retrieves its result, if available.
+	 *
+	 * @param timeout the maximum time to wait
+	 * @param unit the time unit of the timeout argument
+	 * @return the computed result
+	 * @throws ECancellationException if the computation was cancelled
+	 * @throws EExecutionException if the computation threw an
+	 * exception
+	 * @throws EInterruptedException if the current thread is not a
+	 * member of a EForkJoinPool and was interrupted while waiting
+	 * @throws ETimeoutException if the wait timed out
+	 */
+	virtual sp<V> get(llong timeout, ETimeUnit* unit)
+		THROWS3(EInterruptedException, EExecutionException, ETimeoutException) {
+		if (unit == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		int s = externalAwaitDone(true, true, unit->toNanos(timeout));
+		if (s >= 0)
+			throw ETimeoutException(__FILE__, __LINE__);
+		if ((s &= DONE_MASK) != NORMAL)
+			reportGetException(s);
+		return getRawResult();
+	}
+
+	/**
+	 * Completes this task, and if not already aborted or cancelled,
+	 * returning the given value as the result of subsequent
+	 * invocations of {@code join} and related operations. This method
+	 * may be used to provide results for asynchronous tasks, or to
+	 * provide alternative handling for tasks that would not otherwise
+	 * complete normally.
+	 *
+	 * @param value the result value for this task
+	 */
+	void complete(sp<V> value) {
+		try {
+			setRawResult(value);
+		} catch (EThrowable& rex) {
+			setExceptionalCompletion(&rex);
+			return;
+		}
+		quietlyComplete();
+	}
+
+	/**
+	 * Returns the result that would be returned by {@link #join}, even
+	 * if this task completed abnormally, or {@code null} if this task
+	 * is not known to have been completed.  This method is designed
+	 * to aid debugging, as well as to support extensions. Its use in
+	 * any other context is discouraged.
+	 *
+	 * @return the result, or {@code null} if not completed
+	 */
+	virtual sp<V> getRawResult() = 0;
+
+protected:
+	/**
+	 * Forces the given value to be returned as a result.  This method
+	 * is designed to support extensions, and should not in general be
+	 * called otherwise.
+	 *
+	 * @param value the value
+	 */
+	virtual void setRawResult(sp<V> value) = 0;
+};
+
+} /* namespace efc */
+#endif /* EFORKJOINTASK_HH_ */
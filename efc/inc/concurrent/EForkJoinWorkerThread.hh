@@ -0,0 +1,111 @@
+/*
+ * EForkJoinWorkerThread.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EFORKJOINWORKERTHREAD_HH_
+#define EFORKJOINWORKERTHREAD_HH_
+
+#include "../EThread.hh"
+
+namespace efc {
+
+//@see: openjdk-8/src/share/classes/java/util/concurrent/ForkJoinWorkerThread.java
+
+class EForkJoinPool;
+
+namespace fjp {
+	class WorkQueue;
+	class DefaultForkJoinWorkerThreadFactory;
+}
+
+/**
+ * A thread managed by a {@link EForkJoinPool}, which executes
+ * {@link EForkJoinTask}s.
+ * This class is subclassable solely for the sake of adding
+ * functionality -- there are no overridable methods dealing with
+ * scheduling or execution.  However, you can override initialization
+ * and termination methods surrounding the main task processing loop.
+ * If you do create such a subclass, you will also need to supply a
+ * custom {@link EForkJoinPool.ForkJoinWorkerThreadFactory} to
+ * {@linkplain EForkJoinPool#EForkJoinPool use it} in a {@code EForkJoinPool}.
+ *
+ * @since 1.7
+ */
+
+class EForkJoinWorkerThread: public EThread {
+public:
+	virtual ~EForkJoinWorkerThread();
+
+	/**
+	 * Returns the pool hosting this thread.
+	 *
+	 * @return the pool
+	 */
+	EForkJoinPool* getPool();
+
+	/**
+	 * Returns the unique index number of this thread in its pool.
+	 * The returned value ranges from zero to the maximum number of
+	 * threads (minus one) that may exist in the pool, and does not
+	 * change during the lifetime of the thread.  This method may be
+	 * useful for applications that track status or collect results
+	 * per-worker-thread rather than per-task.
+	 *
+	 * @return the index number
+	 */
+	int getPoolIndex();
+
+	/**
+	 * This method is required to be public, but should never be
+	 * called explicitly. It performs the main run loop to execute
+	 * {@link EForkJoinTask}s.
+	 */
+	virtual void run();
+
+protected:
+	friend class EForkJoinPool;
+	friend class EForkJoinTaskType;
+	friend class fjp::DefaultForkJoinWorkerThreadFactory;
+
+	/**
+	 * Creates a EForkJoinWorkerThread operating in the given pool.
+	 *
+	 * @param pool the pool this thread works in
+	 * @throws ENullPointerException if pool is null
+	 */
+	EForkJoinWorkerThread(EForkJoinPool* pool);
+
+	/**
+	 * Initializes internal state after construction but before
+	 * processing any tasks. If you override this method, you must
+	 * invoke {@code EForkJoinWorkerThread::onStart()} at the beginning
+	 * of the method.  Initialization requires care: Most fields must
+	 * have legal default values, to ensure that attempted accesses
+	 * from other threads work correctly even before this thread
+	 * starts processing tasks.
+	 */
+	virtual void onStart();
+
+	/**
+	 * Performs cleanup associated with termination of this worker
+	 * thread.  If you override this method, you must invoke
+	 * {@code EForkJoinWorkerThread::onTermination()} at the end of the
+	 * overridden method.
+	 *
+	 * @param exception the exception causing this thread to abort due
+	 * to an unrecoverable error, or {@code null} if completed normally
+	 */
+	virtual void onTermination(EThrowable* exception);
+
+private:
+	/** the pool this thread works in */
+	EForkJoinPool* pool;
+	/** work-stealing mechanics */
+	fjp::WorkQueue* workQueue;
+};
+
+} /* namespace efc */
+#endif /* EFORKJOINWORKERTHREAD_HH_ */
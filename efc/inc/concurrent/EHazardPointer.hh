@@ -0,0 +1,164 @@
+/*
+ * EHazardPointer.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EHAZARDPOINTER_HH_
+#define EHAZARDPOINTER_HH_
+
+#include "../EString.hh"
+#include "../EThreadLocal.hh"
+#include "../EIllegalStateException.hh"
+#include "./EUnsafe.hh"
+#include "./EOrderAccess.hh"
+
+namespace efc {
+
+/**
+ * A hazard pointer: a single-writer, multi-reader slot through which
+ * a thread announces the one object it is about to dereference.
+ *
+ * <p>An object handed to {@link #retire} is freed only after a scan
+ * of all hazard slots finds no thread announcing it.  Unlike
+ * {@link EEpochManager}, a reader that stalls keeps at most the
+ * objects it protects alive, not everything retired meanwhile; the
+ * price is a store and a fence for every pointer that is protected,
+ * so hazard pointers suit short hand-over-hand traversals and
+ * structures whose readers may block.
+ *
+ * <p>Each thread owns a record of {@link #SLOTS} slots, registered
+ * on first use through an {@link EThreadLocal}.  An
+ * {@code EHazardPointer} object borrows one slot of the calling
+ * thread for its lifetime, so it must be created and used on a
+ * single thread.  When the {@link EThread} terminates its record is
+ * recycled and its retired objects are adopted by the next scan of
+ * another thread.  Retired objects are buffered per thread and freed
+ * in batches once the buffer reaches a multiple of the total number
+ * of slots.
+ *
+ * <pre> {@code
+ * EHazardPointer hp;
+ * Node* h = hp.protect(head);
+ * // h may be dereferenced until hp is reset or destroyed
+ * ...
+ * if (casHead(h, h->next)) {
+ *     hp.clear();
+ *     EHazardPointer::retire(h);
+ * }
+ * }</pre>
+ *
+ * @see EEpochManager
+ */
+
+class EHazardPointer {
+public:
+	typedef void (*Deleter)(void* p);
+
+	/**
+	 * The number of slots of each thread.
+	 */
+	static const int SLOTS = 4;
+
+	/**
+	 * Borrows a slot of the calling thread.
+	 *
+	 * @throws IllegalStateException if all slots of the calling
+	 *         thread are in use
+	 */
+	EHazardPointer();
+
+	/**
+	 * Clears and returns the slot.
+	 */
+	~EHazardPointer();
+
+	/**
+	 * Loads {@code src} and announces the loaded pointer, retrying
+	 * until the announcement is known to precede any retirement of
+	 * the object.  The returned pointer stays valid until this slot
+	 * is changed.
+	 *
+	 * @param src the shared location to load from
+	 * @return the protected pointer, possibly null
+	 */
+	template<typename T>
+	T* protect(T* volatile const& src) {
+		T* p = src;
+		for (;;) {
+			*slot = p;
+			EUnsafe::fullFence();
+			T* q = src;
+			if (q == p)
+				return p;
+			p = q;
+		}
+	}
+
+	/**
+	 * Announces {@code p}.  The caller must validate afterwards
+	 * that {@code p} is still reachable.
+	 */
+	void set(void* p) {
+		*slot = p;
+		EUnsafe::fullFence();
+	}
+
+	/**
+	 * Returns the announced pointer.
+	 */
+	void* get() {
+		return *slot;
+	}
+
+	/**
+	 * Withdraws the announcement.
+	 */
+	void clear() {
+		EOrderAccess::release_store_ptr(slot, null);
+	}
+
+	/**
+	 * Schedules {@code p} to be released by {@code d} once no slot
+	 * announces it.  The object must already be unreachable from the
+	 * shared structure.
+	 */
+	static void retire(void* p, Deleter d);
+
+	template<typename T>
+	static void retire(T* p) {
+		retire(p, &deleteObject<T>);
+	}
+
+	/**
+	 * Scans all slots now and frees what the calling thread retired
+	 * that is no longer announced.
+	 */
+	static void reclaim();
+
+	/**
+	 * Returns an estimate of the number of retired objects not yet
+	 * freed.
+	 */
+	static llong getPendingCount();
+
+	template<typename T>
+	static void deleteObject(void* p) {
+		delete (T*)p;
+	}
+
+private:
+	struct Record;
+	class Domain;
+
+	Record* record;
+	void* volatile* slot;
+	int index;
+
+	EHazardPointer(const EHazardPointer&);
+	EHazardPointer& operator=(const EHazardPointer&);
+};
+
+} /* namespace efc */
+#endif /* EHAZARDPOINTER_HH_ */
@@ -12,6 +12,7 @@
 #include "../ETimeUnit.hh"
 #include "./EBlockingQueue.hh"
 #include "./EAtomicInteger.hh"
+#include "./EPadded.hh"
 #include "./EAbstractConcurrentQueue.hh"
 #include "../EInterruptedException.hh"
 #include "../EIllegalArgumentException.hh"
@@ -53,7 +54,7 @@ namespace efc {
 
 template<typename E>
 class ELinkedBlockingQueue: virtual public EAbstractConcurrentQueue<E>,
-		virtual public EBlockingQueue<E> {
+		virtual public EBlockingQueue<E>, public EBatchOfferQueue<E> {
 public:
 	/*
 	 * A variant of the "two lock queue" algorithm.  The putLock gates
@@ -130,7 +131,7 @@ public:
 	 * @return the number of elements in this queue
 	 */
 	virtual int size() {
-		return count.get();
+		return count->get();
 	}
 
 	// this doc comment is a modified copy of the inherited doc comment,
@@ -147,7 +148,7 @@ public:
 	 * insert or remove an element.
 	 */
 	virtual int remainingCapacity() {
-		return capacity_ - count.get();
+		return capacity_ - count->get();
 	}
 
 	virtual int capacity() {
@@ -181,11 +182,11 @@ public:
 			 * signalled if it ever changes from capacity. Similarly
 			 * for all other uses of count in other wait guards.
 			 */
-			while (count.get() == capacity_) {
+			while (count->get() == capacity_) {
 				notFull->await();
 			}
 			enqueue(node);
-			c = count.getAndIncrement();
+			c = count->getAndIncrement();
 			if (c + 1 < capacity_)
 				notFull->signal();
 		} catch(...) {
@@ -224,7 +225,7 @@ public:
 		putLock.lockInterruptibly();
 		boolean r = true;
 		try {
-			while (count.get() == capacity_) {
+			while (count->get() == capacity_) {
 				if (nanos <= 0) {
 					r = false;
 					goto FINALLY;
@@ -233,7 +234,7 @@ public:
 			}
 			sp<Node> x(new Node(e));
 			enqueue(x);
-			c = count.getAndIncrement();
+			c = count->getAndIncrement();
 			if (c + 1 < capacity_)
 				notFull->signal();
 		} catch(...) {
@@ -270,15 +271,15 @@ public:
 	}
 	virtual boolean offer(sp<E> e) {
 		if (e == null) throw ENullPointerException(__FILE__, __LINE__);
-		if (count.get() == capacity_)
+		if (count->get() == capacity_)
 			return false;
 		int c = -1;
 		sp<Node> node(new Node(e));
 		putLock.lock();
 		try {
-			if (count.get() < capacity_) {
+			if (count->get() < capacity_) {
 				enqueue(node);
-				c = count.getAndIncrement();
+				c = count->getAndIncrement();
 				if (c + 1 < capacity_)
 					notFull->signal();
 			}
@@ -293,16 +294,70 @@ public:
 		return c >= 0;
 	}
 
+	/**
+	 * Links the nodes for the run before taking the put lock, then
+	 * appends them in one step and signals a waiting taker at most
+	 * once; takers cascade further wakeups as usual.
+	 *
+	 * @throws NullPointerException {@inheritDoc}
+	 */
+	virtual int offerAll(EList<sp<E> >* c, int offset) {
+		if (c == null) throw ENullPointerException(__FILE__, __LINE__);
+		int n = ES_MIN(c->size() - offset, capacity_ - count->get());
+		if (n <= 0)
+			return 0;
+		sp<Node> first, tail;
+		sp<EListIterator<sp<E> > > it = c->listIterator(offset);
+		for (int i = 0; i < n; i++) {
+			sp<E> e = it->next();
+			if (e == null) throw ENullPointerException(__FILE__, __LINE__);
+			sp<Node> node(new Node(e));
+			if (first == null)
+				first = node;
+			else
+				tail->next = node;
+			tail = node;
+		}
+		int k = 0;
+		int cnt = -1;
+		putLock.lock();
+		try {
+			k = ES_MIN(n, capacity_ - count->get());
+			if (k > 0) {
+				if (k < n) {
+					// lost a race with other producers: cut the run short
+					tail = first;
+					for (int i = 1; i < k; i++)
+						tail = tail->next;
+					tail->next = null;
+				}
+				last->next = first;
+				last = tail;
+				cnt = count->getAndAdd(k);
+				if (cnt + k < capacity_)
+					notFull->signal();
+			}
+		} catch(...) {
+			putLock.unlock();
+			throw; //!
+		} finally {
+			putLock.unlock();
+		}
+		if (cnt == 0)
+			signalNotEmpty();
+		return k;
+	}
+
 	virtual sp<E> take() THROWS(EInterruptedException) {
 		sp<E> x;
 		int c = -1;
 		takeLock.lockInterruptibly();
 		try {
-			while (count.get() == 0) {
+			while (count->get() == 0) {
 				notEmpty->await();
 			}
 			x = dequeue();
-			c = count.getAndDecrement();
+			c = count->getAndDecrement();
 			if (c > 1)
 				notEmpty->signal();
 		} catch(...) {
@@ -322,7 +377,7 @@ public:
 		llong nanos = unit->toNanos(timeout);
 		takeLock.lockInterruptibly();
 		try {
-			while (count.get() == 0) {
+			while (count->get() == 0) {
 				if (nanos <= 0) {
 					x = null;
 					goto FINALLY;
@@ -330,7 +385,7 @@ public:
 				nanos = notEmpty->awaitNanos(nanos);
 			}
 			x = dequeue();
-			c = count.getAndDecrement();
+			c = count->getAndDecrement();
 			if (c > 1)
 				notEmpty->signal();
 		} catch(...) {
@@ -347,15 +402,15 @@ public:
 	}
 
 	virtual sp<E> poll() {
-		if (count.get() == 0)
+		if (count->get() == 0)
 			return null;
 		sp<E> x;
 		int c = -1;
 		takeLock.lock();
 		try {
-			if (count.get() > 0) {
+			if (count->get() > 0) {
 				x = dequeue();
-				c = count.getAndDecrement();
+				c = count->getAndDecrement();
 				if (c > 1)
 					notEmpty->signal();
 			}
@@ -371,7 +426,7 @@ public:
 	}
 
 	virtual sp<E> peek() {
-		if (count.get() == 0)
+		if (count->get() == 0)
 			return null;
 		takeLock.lock();
 		sp<E> p;
@@ -436,7 +491,7 @@ public:
 			}
 			head = last;
 			// assert head.item == null && head.next == null;
-			if (count.getAndSet(0) == capacity_)
+			if (count->getAndSet(0) == capacity_)
 				notFull->signal();
 		} catch(...) {
 			fullyUnlock();
@@ -472,7 +527,7 @@ public:
 			throw EIllegalArgumentException(__FILE__, __LINE__);
 		boolean signalNotFull_ = false;
 		takeLock.lock(); //lock!
-		int n = ES_MIN(maxElements, count.get());
+		int n = ES_MIN(maxElements, count->get());
 		// count.get provides visibility to first n Nodes
 		sp<Node> h = head;
 		int i = 0;
@@ -488,7 +543,7 @@ public:
 		} catch(...) {
 			if (i > 0) {
 				head = h;
-				signalNotFull_ = (count.getAndAdd(-i) == capacity_);
+				signalNotFull_ = (count->getAndAdd(-i) == capacity_);
 			}
 			takeLock.unlock(); //unlock!
 			if (signalNotFull_)
@@ -499,7 +554,7 @@ public:
 			if (i > 0) {
 				// assert h.item == null;
 				head = h;
-				signalNotFull_ = (count.getAndAdd(-i) == capacity_);
+				signalNotFull_ = (count->getAndAdd(-i) == capacity_);
 			}
 			takeLock.unlock(); //unlock!
 			if (signalNotFull_)
@@ -514,7 +569,7 @@ public:
 			throw EIllegalArgumentException(__FILE__, __LINE__);
 		boolean signalNotFull_ = false;
 		takeLock.lock(); //lock!
-		int n = ES_MIN(maxElements, count.get());
+		int n = ES_MIN(maxElements, count->get());
 		// count.get provides visibility to first n Nodes
 		sp<Node> h = head;
 		int i = 0;
@@ -530,7 +585,7 @@ public:
 		} catch(...) {
 			if (i > 0) {
 				head = h;
-				signalNotFull_ = (count.getAndAdd(-i) == capacity_);
+				signalNotFull_ = (count->getAndAdd(-i) == capacity_);
 			}
 			takeLock.unlock(); //unlock!
 			if (signalNotFull_)
@@ -541,7 +596,7 @@ public:
 			if (i > 0) {
 				// assert h.item == null;
 				head = h;
-				signalNotFull_ = (count.getAndAdd(-i) == capacity_);
+				signalNotFull_ = (count->getAndAdd(-i) == capacity_);
 			}
 			takeLock.unlock(); //unlock!
 			if (signalNotFull_)
@@ -658,7 +713,7 @@ public:
 	 */
 	virtual EA<sp<E> > toArray() {
 		fullyLock();
-		int size = count.get();
+		int size = count->get();
 		EA<sp<E> > a(size);
 		try {
 			int k = 0;
@@ -716,16 +771,27 @@ protected:
 		trail->next = p->next;
 		if (last == p)
 			last = trail;
-		if (count.getAndDecrement() == capacity_)
+		if (count->getAndDecrement() == capacity_)
 			notFull->signal();
 	}
 
 private:
+	/*
+	 * Consumers write head, producers write last, and both sides
+	 * update count.  The padded count sits between the two groups, so
+	 * that a put does not invalidate the line a concurrent take is
+	 * working on.  The lock members are only handles: their state is
+	 * allocated by EReentrantLock itself and cannot be padded here.
+	 */
+
 	/** The capacity bound, or Integer.MAX_VALUE if none */
 	int capacity_;
 
-	/** Current number of elements */
-	EAtomicInteger count;
+	/** Lock held by take, poll, etc */
+	EReentrantLock takeLock;
+
+	/** Wait queue for waiting takes */
+	ECondition* notEmpty;// = takeLock.newCondition();
 
 	/**
 	 * Head of linked list.
@@ -733,17 +799,8 @@ private:
 	 */
 	sp<Node> head;
 
-	/**
-	 * Tail of linked list.
-	 * Invariant: last.next == null
-	 */
-	sp<Node> last;
-
-	/** Lock held by take, poll, etc */
-	EReentrantLock takeLock;
-
-	/** Wait queue for waiting takes */
-	ECondition* notEmpty;// = takeLock.newCondition();
+	/** Current number of elements */
+	EPadded<EAtomicInteger> count;
 
 	/** Lock held by put, offer, etc */
 	EReentrantLock putLock;
@@ -751,6 +808,12 @@ private:
 	/** Wait queue for waiting puts */
 	ECondition* notFull;// = putLock.newCondition();
 
+	/**
+	 * Tail of linked list.
+	 * Invariant: last.next == null
+	 */
+	sp<Node> last;
+
 	void init(int capacity) {
 		if (capacity <= 0) throw EIllegalArgumentException(__FILE__, __LINE__);
 		this->capacity_ = capacity;
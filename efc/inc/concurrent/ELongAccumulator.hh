@@ -0,0 +1,156 @@
+/*
+ * ELongAccumulator.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ELONGACCUMULATOR_HH_
+#define ELONGACCUMULATOR_HH_
+
+#include "./EStriped64.hh"
+#include "../EString.hh"
+#include "../ESharedPtr.hh"
+
+namespace efc {
+
+//@see: openjdk-8/src/share/classes/java/util/concurrent/atomic/LongAccumulator.java
+
+/**
+ * One or more variables that together maintain a running {@code llong}
+ * value updated using a supplied function.  When updates (method
+ * {@link #accumulate}) are contended across threads, the set of variables
+ * may grow dynamically to reduce contention.  Method {@link #get}
+ * (or, equivalently, {@link #llongValue}) returns the current value
+ * across the variables maintaining updates.
+ *
+ * <p>This class is usually preferable to {@link EAtomicLLong} when
+ * multiple threads update a common value that is used for purposes such
+ * as collecting statistics, not for fine-grained synchronization
+ * control.  Under low update contention, the two classes have similar
+ * characteristics. But under high contention, expected throughput of
+ * this class is significantly higher, at the expense of higher space
+ * consumption.
+ *
+ * <p>The order of accumulation within or across threads is not
+ * guaranteed and cannot be depended upon, so this class is only
+ * applicable to functions for which the order of accumulation does
+ * not matter. The supplied accumulator function should be
+ * side-effect-free, since it may be re-applied when attempted updates
+ * fail due to contention among threads. The function is applied with
+ * the current value as its first argument, and the given update as
+ * the second argument.  For example, to maintain a running maximum
+ * value, you could supply a function returning the larger of its
+ * operands along with {@code ELLong::MIN_VALUE} as the identity.
+ *
+ * <p>Class {@link ELongAdder} provides analogs of the functionality of
+ * this class for the common special case of maintaining counts and
+ * sums.  The call {@code new ELongAdder()} is equivalent to {@code new
+ * ELongAccumulator(plus, 0L)} for a function {@code plus} that adds
+ * its operands.
+ *
+ * <p>This class extends {@link ENumber}, but does <em>not</em> define
+ * methods such as {@code equals}, {@code hashCode} and {@code
+ * compareTo} because instances are expected to be mutated, and so are
+ * not useful as collection keys.
+ *
+ * @since 1.8
+ */
+
+class ELongAccumulator : public EStriped64 {
+public:
+	virtual ~ELongAccumulator();
+
+	/**
+	 * Creates a new instance using the given accumulator function
+	 * and identity element.
+	 * @param accumulatorFunction a side-effect-free function of two arguments
+	 * @param identity identity (initial value) for the accumulator function
+	 * @throws ENullPointerException if accumulatorFunction is null
+	 */
+	ELongAccumulator(sp<ELongBinaryOperator> accumulatorFunction,
+			llong identity);
+
+#ifdef CPP11_SUPPORT
+	ELongAccumulator(std::function<llong(llong, llong)> accumulatorFunction,
+			llong identity);
+#endif
+
+	/**
+	 * Updates with the given value.
+	 *
+	 * @param x the value
+	 */
+	void accumulate(llong x);
+
+	/**
+	 * Returns the current value.  The returned value is <em>NOT</em>
+	 * an atomic snapshot; invocation in the absence of concurrent
+	 * updates returns an accurate result, but concurrent updates that
+	 * occur while the value is being calculated might not be
+	 * incorporated.
+	 *
+	 * @return the current value
+	 */
+	llong get();
+
+	/**
+	 * Resets variables maintaining updates to the identity value.
+	 * This method may be a useful alternative to creating a new
+	 * updater, but is only effective if there are no concurrent
+	 * updates.  Because this method is intrinsically racy, it should
+	 * only be used when it is known that no threads are concurrently
+	 * updating.
+	 */
+	void reset();
+
+	/**
+	 * Equivalent in effect to {@link #get} followed by {@link
+	 * #reset}. This method may apply for example during quiescent
+	 * points between multithreaded computations.  If there are
+	 * updates concurrent with this method, the returned value is
+	 * <em>not</em> guaranteed to be the final value occurring before
+	 * the reset.
+	 *
+	 * @return the value before reset
+	 */
+	llong getThenReset();
+
+	/**
+	 * Returns the String representation of the current value.
+	 * @return the String representation of the current value
+	 */
+	virtual EStringBase toString();
+
+	/**
+	 * Equivalent to {@link #get}.
+	 *
+	 * @return the current value
+	 */
+	virtual llong llongValue();
+
+	/**
+	 * Returns the {@linkplain #get current value} as an {@code int}
+	 * after a narrowing primitive conversion.
+	 */
+	virtual int intValue();
+
+	/**
+	 * Returns the {@linkplain #get current value} as a {@code float}
+	 * after a widening primitive conversion.
+	 */
+	virtual float floatValue();
+
+	/**
+	 * Returns the {@linkplain #get current value} as a {@code double}
+	 * after a widening primitive conversion.
+	 */
+	virtual double doubleValue();
+
+private:
+	sp<ELongBinaryOperator> function;
+	llong identity;
+};
+
+} /* namespace efc */
+#endif /* ELONGACCUMULATOR_HH_ */
@@ -0,0 +1,141 @@
+/*
+ * ELongAdder.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ELONGADDER_HH_
+#define ELONGADDER_HH_
+
+#include "./EStriped64.hh"
+#include "../EString.hh"
+
+namespace efc {
+
+//@see: openjdk-8/src/share/classes/java/util/concurrent/atomic/LongAdder.java
+
+/**
+ * One or more variables that together maintain an initially zero
+ * {@code llong} sum.  When updates (method {@link #add}) are contended
+ * across threads, the set of variables may grow dynamically to reduce
+ * contention. Method {@link #sum} (or, equivalently, {@link
+ * #llongValue}) returns the current total combined across the
+ * variables maintaining the sum.
+ *
+ * <p>This class is usually preferable to {@link EAtomicLLong} when
+ * multiple threads update a common sum that is used for purposes such
+ * as collecting statistics, not for fine-grained synchronization
+ * control.  Under low update contention, the two classes have similar
+ * characteristics. But under high contention, expected throughput of
+ * this class is significantly higher, at the expense of higher space
+ * consumption.
+ *
+ * <p>LongAdders can be used with a {@link EConcurrentHashMap} to
+ * maintain a scalable frequency map (a form of histogram or
+ * multiset).
+ *
+ * <p>This class extends {@link ENumber}, but does <em>not</em> define
+ * methods such as {@code equals}, {@code hashCode} and {@code
+ * compareTo} because instances are expected to be mutated, and so are
+ * not useful as collection keys.
+ *
+ * @since 1.8
+ */
+
+class ELongAdder : public EStriped64 {
+public:
+	virtual ~ELongAdder();
+
+	/**
+	 * Creates a new adder with initial sum of zero.
+	 */
+	ELongAdder();
+
+	/**
+	 * Adds the given value.
+	 *
+	 * @param x the value to add
+	 */
+	void add(llong x);
+
+	/**
+	 * Equivalent to {@code add(1)}.
+	 */
+	void increment();
+
+	/**
+	 * Equivalent to {@code add(-1)}.
+	 */
+	void decrement();
+
+	/**
+	 * Returns the current sum.  The returned value is <em>NOT</em> an
+	 * atomic snapshot; invocation in the absence of concurrent
+	 * updates returns an accurate result, but concurrent updates that
+	 * occur while the sum is being calculated might not be
+	 * incorporated.
+	 *
+	 * <p>The cost is one read per cell, and there are never more cells
+	 * than the next power of two of the number of CPUs, so this is
+	 * cheap enough to call from a stats endpoint.
+	 *
+	 * @return the sum
+	 */
+	llong sum();
+
+	/**
+	 * Resets variables maintaining the sum to zero.  This method may
+	 * be a useful alternative to creating a new adder, but is only
+	 * effective if there are no concurrent updates.  Because this
+	 * method is intrinsically racy, it should only be used when it is
+	 * known that no threads are concurrently updating.
+	 */
+	void reset();
+
+	/**
+	 * Equivalent in effect to {@link #sum} followed by {@link
+	 * #reset}. This method may apply for example during quiescent
+	 * points between multithreaded computations.  If there are
+	 * updates concurrent with this method, the returned value is
+	 * <em>not</em> guaranteed to be the final value occurring before
+	 * the reset.
+	 *
+	 * @return the sum
+	 */
+	llong sumThenReset();
+
+	/**
+	 * Returns the String representation of the {@link #sum}.
+	 * @return the String representation of the {@link #sum}
+	 */
+	virtual EStringBase toString();
+
+	/**
+	 * Equivalent to {@link #sum}.
+	 *
+	 * @return the sum
+	 */
+	virtual llong llongValue();
+
+	/**
+	 * Returns the {@link #sum} as an {@code int} after a narrowing
+	 * primitive conversion.
+	 */
+	virtual int intValue();
+
+	/**
+	 * Returns the {@link #sum} as a {@code float}
+	 * after a widening primitive conversion.
+	 */
+	virtual float floatValue();
+
+	/**
+	 * Returns the {@link #sum} as a {@code double} after a widening
+	 * primitive conversion.
+	 */
+	virtual double doubleValue();
+};
+
+} /* namespace efc */
+#endif /* ELONGADDER_HH_ */
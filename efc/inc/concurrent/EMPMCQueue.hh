@@ -0,0 +1,615 @@
+/*
+ * EMPMCQueue.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EMPMCQUEUE_HH_
+#define EMPMCQUEUE_HH_
+
+#include "../EThread.hh"
+#include "../EInteger.hh"
+#include "../ETimeUnit.hh"
+#include "../EArrayList.hh"
+#include "./EUnsafe.hh"
+#include "./EOrderAccess.hh"
+#include "./EBlockingQueue.hh"
+#include "./EReentrantLock.hh"
+#include "./EAbstractConcurrentQueue.hh"
+#include "../EInterruptedException.hh"
+#include "../ENullPointerException.hh"
+#include "../EIllegalArgumentException.hh"
+#include "../ENoSuchElementException.hh"
+#include "../EUnsupportedOperationException.hh"
+
+namespace efc {
+
+/**
+ * A bounded, lock-free, multi-producer multi-consumer
+ * {@linkplain EBlockingQueue blocking queue} backed by a ring of
+ * sequence-numbered slots (D. Vyukov's bounded MPMC queue).
+ * This queue orders elements FIFO (first-in-first-out).
+ *
+ * <p>Every slot carries a sequence number that tells producers and
+ * consumers whose turn it is.  {@code offer} and {@code poll} claim
+ * a slot with a single CAS on the enqueue or dequeue position, move
+ * the element in or out, and publish the slot by advancing its
+ * sequence.  Producers never touch the consumer position and vice
+ * versa, the two positions live on separate cache lines, and no
+ * memory is allocated after construction.
+ *
+ * <p>The blocking methods first retry the lock-free path for a short
+ * while and only then wait on a condition.  Waiters announce
+ * themselves in a counter that the non-blocking paths check after
+ * publishing a slot, so the lock is never taken while nobody waits.
+ *
+ * <p>This queue can be handed to {@link EThreadPoolExecutor} as its
+ * work queue.  The capacity is rounded up to a power of two.
+ *
+ * <p>Only the head/tail operations are lock-free.  {@code peek} is
+ * not supported.  {@code remove(Object)}, {@code contains},
+ * {@code toArray} and {@code iterator} briefly stop producers and
+ * consumers, by marking both positions, and work on the ring in
+ * place: they are O(n) and keep the FIFO order, but make every other
+ * thread using the queue wait, so they are meant for rare paths such
+ * as executor shutdown and purge.
+ *
+ * @param <E> the type of elements held in this collection
+ */
+
+template<typename E>
+class EMPMCQueue: virtual public EAbstractConcurrentQueue<E>,
+		virtual public EBlockingQueue<E> {
+public:
+	virtual ~EMPMCQueue() {
+		delete[] buffer;
+		delete notEmpty;
+		delete notFull;
+	}
+
+	/**
+	 * Creates an {@code EMPMCQueue} able to hold at least
+	 * {@code capacity} elements.
+	 *
+	 * @param capacity the minimal capacity of this queue, rounded up
+	 *        to the next power of two
+	 * @throws IllegalArgumentException if {@code capacity < 1}
+	 *         or too large
+	 */
+	EMPMCQueue(int capacity) {
+		if (capacity <= 0 || capacity > (1 << 30))
+			throw EIllegalArgumentException(__FILE__, __LINE__);
+		int n = 2;
+		while (n < capacity)
+			n <<= 1;
+		capacity_ = n;
+		mask = n - 1;
+		buffer = new Cell[n];
+		for (int i = 0; i < n; i++)
+			buffer[i].sequence = i;
+		enqueuePos = 0;
+		dequeuePos = 0;
+		takers = 0;
+		putters = 0;
+		notEmpty = lock.newCondition();
+		notFull = lock.newCondition();
+	}
+
+	virtual boolean offer(E* e) {
+		sp<E> x(e);
+		boolean r = offer(x);
+		if (!r) {
+			x.dismiss();
+		}
+		return r;
+	}
+	virtual boolean offer(sp<E> e) {
+		if (e == null) throw ENullPointerException(__FILE__, __LINE__);
+		if (!enqueue(e))
+			return false;
+		if (takers > 0)
+			signalNotEmpty();
+		return true;
+	}
+
+	virtual void put(E* e) THROWS(EInterruptedException) {
+		sp<E> x(e);
+		put(x);
+	}
+	virtual void put(sp<E> e) THROWS(EInterruptedException) {
+		offer(e, -1, null);
+	}
+
+	virtual boolean offer(E* e, llong timeout, ETimeUnit* unit)
+			THROWS(EInterruptedException) {
+		sp<E> x(e);
+		boolean r = offer(x, timeout, unit);
+		if (!r) {
+			x.dismiss();
+		}
+		return r;
+	}
+	virtual boolean offer(sp<E> e, llong timeout, ETimeUnit* unit)
+			THROWS(EInterruptedException) {
+		if (e == null) throw ENullPointerException(__FILE__, __LINE__);
+		for (int spins = SPINS; spins >= 0; spins--) {
+			if (enqueue(e)) {
+				if (takers > 0)
+					signalNotEmpty();
+				return true;
+			}
+		}
+		// unit == null means wait forever (see put)
+		llong nanos = (unit == null) ? 0 : unit->toNanos(timeout);
+		boolean r = true;
+		lock.lockInterruptibly();
+		eso_atomic_add_and_fetch32(&putters, 1);
+		EUnsafe::fullFence(); // pairs with the publishing fence in dequeue
+		try {
+			while (!enqueue(e)) {
+				if (unit == null) {
+					notFull->await();
+				} else {
+					if (nanos <= 0) {
+						r = false;
+						break;
+					}
+					nanos = notFull->awaitNanos(nanos);
+				}
+			}
+		} catch (...) {
+			eso_atomic_add_and_fetch32(&putters, -1);
+			lock.unlock();
+			throw; //!
+		}
+		eso_atomic_add_and_fetch32(&putters, -1);
+		lock.unlock();
+		if (r && takers > 0)
+			signalNotEmpty();
+		return r;
+	}
+
+	virtual sp<E> poll() {
+		sp<E> x = dequeue();
+		if (x != null && putters > 0)
+			signalNotFull();
+		return x;
+	}
+
+	virtual sp<E> take() THROWS(EInterruptedException) {
+		return poll(-1, null);
+	}
+
+	virtual sp<E> poll(llong timeout, ETimeUnit* unit) THROWS(EInterruptedException) {
+		sp<E> x;
+		for (int spins = SPINS; spins >= 0; spins--) {
+			if ((x = dequeue()) != null) {
+				if (putters > 0)
+					signalNotFull();
+				return x;
+			}
+		}
+		// unit == null means wait forever (see take)
+		llong nanos = (unit == null) ? 0 : unit->toNanos(timeout);
+		lock.lockInterruptibly();
+		eso_atomic_add_and_fetch32(&takers, 1);
+		EUnsafe::fullFence(); // pairs with the publishing fence in enqueue
+		try {
+			while ((x = dequeue()) == null) {
+				if (unit == null) {
+					notEmpty->await();
+				} else {
+					if (nanos <= 0)
+						break;
+					nanos = notEmpty->awaitNanos(nanos);
+				}
+			}
+		} catch (...) {
+			eso_atomic_add_and_fetch32(&takers, -1);
+			lock.unlock();
+			throw; //!
+		}
+		eso_atomic_add_and_fetch32(&takers, -1);
+		lock.unlock();
+		if (x != null && putters > 0)
+			signalNotFull();
+		return x;
+	}
+
+	/**
+	 * Not supported: a slot may be recycled by a consumer while it
+	 * is being read.
+	 *
+	 * @throws UnsupportedOperationException always
+	 */
+	virtual sp<E> peek() {
+		throw EUnsupportedOperationException(__FILE__, __LINE__);
+	}
+
+	/**
+	 * Returns the number of elements in this queue.  The value is
+	 * exact only while no other thread operates on the queue.
+	 *
+	 * @return the number of elements in this queue
+	 */
+	virtual int size() {
+		for (;;) {
+			llong d = EOrderAccess::load_acquire(&dequeuePos);
+			llong e = EOrderAccess::load_acquire(&enqueuePos);
+			if (d == EOrderAccess::load_acquire(&dequeuePos)) {
+				llong n = unfrozen(e) - unfrozen(d);
+				return (n < 0) ? 0 : (n > capacity_ ? capacity_ : (int)n);
+			}
+		}
+		//not reach here!
+		return 0;
+	}
+
+	virtual boolean isEmpty() {
+		return size() == 0;
+	}
+
+	virtual int remainingCapacity() {
+		return capacity_ - size();
+	}
+
+	virtual int capacity() {
+		return capacity_;
+	}
+
+	/**
+	 * Removes a single instance of the specified element from this
+	 * queue, if it is present.  See the class comment for the cost
+	 * of this operation.
+	 */
+	virtual boolean remove(E* o) {
+		if (o == null) return false;
+		return removeElement(o, false);
+	}
+
+	virtual boolean contains(E* o) {
+		if (o == null) return false;
+		EA<sp<E> > a = toArray();
+		for (int i = 0; i < a.length(); i++) {
+			if (o->equals(a[i].get()))
+				return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Returns an array containing all of the elements in this queue.
+	 * See the class comment for the cost of this operation.
+	 */
+	virtual EA<sp<E> > toArray() {
+		EArrayList<sp<E> > list;
+		SYNCBLOCK(&drainLock) {
+			llong d, e;
+			freeze(d, e);
+			try {
+				for (llong p = d; p < e; p++) {
+					list.add(buffer[p & mask].item);
+				}
+			} catch (...) {
+				unfreeze(d, e);
+				throw; //!
+			}
+			unfreeze(d, e);
+		}}
+		return list.toArray();
+	}
+
+	/**
+	 * Returns an iterator over a snapshot of the elements in this
+	 * queue; {@code Iterator.remove} removes the returned element from
+	 * the live queue.
+	 */
+	virtual sp<EConcurrentIterator<E> > iterator() {
+		return new Itr(this);
+	}
+
+	virtual void clear() {
+		while (poll() != null)
+			;
+	}
+
+	virtual int drainTo(EConcurrentCollection<E>* c) {
+		return drainTo(c, EInteger::MAX_VALUE);
+	}
+	virtual int drainTo(ECollection<sp<E> >* c) {
+		return drainTo(c, EInteger::MAX_VALUE);
+	}
+
+	/**
+	 * Removes at most the given number of available elements.  Runs of
+	 * published slots are claimed with a single CAS, so a consumer
+	 * that drains in batches pays the contended update once per batch.
+	 */
+	virtual int drainTo(EConcurrentCollection<E>* c, int maxElements) {
+		if (c == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		if (c == dynamic_cast<EConcurrentCollection<E>*>(this))
+			throw EIllegalArgumentException(__FILE__, __LINE__);
+		return drainTo0(c, maxElements);
+	}
+	virtual int drainTo(ECollection<sp<E> >* c, int maxElements) {
+		if (c == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		return drainTo0(c, maxElements);
+	}
+
+	virtual boolean add(E* e) {
+		return EAbstractConcurrentQueue<E>::add(e);
+	}
+	virtual boolean add(sp<E> e) {
+		return EAbstractConcurrentQueue<E>::add(e);
+	}
+
+	virtual sp<E> remove() {
+		return EAbstractConcurrentQueue<E>::remove();
+	}
+
+	virtual sp<E> element() {
+		return EAbstractConcurrentQueue<E>::element();
+	}
+
+private:
+	/**
+	 * A slot of the ring.  sequence == pos means free for the producer
+	 * at pos; sequence == pos + 1 means filled for the consumer at pos.
+	 */
+	struct Cell {
+		volatile llong sequence;
+		sp<E> item;
+	};
+
+	/** Number of lock-free retries before a blocking call waits. */
+	static const int SPINS = 64;
+
+	Cell* buffer;
+	llong mask;
+	int capacity_;
+
+	char pad0[ES_CACHE_LINE_SIZE];
+	/** Next position to be claimed by a producer */
+	volatile llong enqueuePos;
+	char pad1[ES_CACHE_LINE_SIZE - sizeof(llong)];
+	/** Next position to be claimed by a consumer */
+	volatile llong dequeuePos;
+	char pad2[ES_CACHE_LINE_SIZE - sizeof(llong)];
+
+	/** Threads blocked in take/poll(timeout) */
+	volatile es_int32_t takers;
+	/** Threads blocked in put/offer(timeout) */
+	volatile es_int32_t putters;
+
+	/** Lock only used for parking */
+	EReentrantLock lock;
+	ECondition* notEmpty;
+	ECondition* notFull;
+
+	/** Serializes the operations that freeze the positions */
+	EReentrantLock drainLock;
+
+	/**
+	 * Returns the position, waiting while a bulk operation has it
+	 * frozen (stored as its complement, so negative).
+	 */
+	static llong loadPos(volatile llong* p) {
+		llong pos;
+		while ((pos = EOrderAccess::load_acquire(p)) < 0)
+			EThread::yield();
+		return pos;
+	}
+
+	static llong unfrozen(llong pos) {
+		return (pos < 0) ? ~pos : pos;
+	}
+
+	/**
+	 * Stops producers, then consumers, and waits for the producers
+	 * that already claimed a slot to publish it.  The elements are
+	 * then exactly the items at positions [d, e), which nobody else
+	 * touches until unfreeze.  Called with drainLock held.
+	 */
+	void freeze(llong& d, llong& e) {
+		do {
+			e = EOrderAccess::load_acquire(&enqueuePos);
+		} while (!EUnsafe::compareAndSwapLLong(&enqueuePos, e, ~e));
+		do {
+			d = EOrderAccess::load_acquire(&dequeuePos);
+		} while (!EUnsafe::compareAndSwapLLong(&dequeuePos, d, ~d));
+		// a consumer still freeing a slot of an earlier lap shares it
+		// with a position in [d, e) whose producer waited for it.
+		for (llong p = d; p < e; p++) {
+			while (EOrderAccess::load_acquire(&buffer[p & mask].sequence) != p + 1)
+				EThread::yield();
+		}
+	}
+
+	void unfreeze(llong d, llong e) {
+		EOrderAccess::release_store(&dequeuePos, d);
+		EOrderAccess::release_store(&enqueuePos, e);
+	}
+
+	/**
+	 * Removes the first element equal to (or, if identity, the same
+	 * as) o, moving the elements behind it one slot forward.
+	 */
+	boolean removeElement(E* o, boolean identity) {
+		boolean removed = false;
+		sp<E> x;
+		SYNCBLOCK(&drainLock) {
+			llong d, e;
+			freeze(d, e);
+			try {
+				for (llong p = d; p < e; p++) {
+					E* y = buffer[p & mask].item.get();
+					if (identity ? (y == o) : o->equals(y)) {
+						for (; p < e - 1; p++) {
+							buffer[p & mask].item.swap(buffer[(p + 1) & mask].item);
+						}
+						// the last slot is now free for the producer at e - 1
+						x.swap(buffer[(e - 1) & mask].item);
+						EOrderAccess::release_store(&buffer[(e - 1) & mask].sequence, e - 1);
+						e--;
+						removed = true;
+						break;
+					}
+				}
+			} catch (...) {
+				unfreeze(d, e);
+				throw; //!
+			}
+			unfreeze(d, e);
+		}}
+		if (removed) {
+			EUnsafe::fullFence();
+			if (putters > 0)
+				signalNotFull();
+		}
+		return removed;
+	}
+
+	boolean enqueue(sp<E>& e) {
+		Cell* cell;
+		llong pos = loadPos(&enqueuePos);
+		for (;;) {
+			cell = &buffer[pos & mask];
+			llong dif = EOrderAccess::load_acquire(&cell->sequence) - pos;
+			if (dif == 0) {
+				if (EUnsafe::compareAndSwapLLong(&enqueuePos, pos, pos + 1))
+					break;
+				pos = loadPos(&enqueuePos);
+			} else if (dif < 0) {
+				return false; // full
+			} else {
+				pos = loadPos(&enqueuePos);
+			}
+		}
+		cell->item.swap(e);
+		// publish; the fence orders it before the read of takers
+		EOrderAccess::release_store_fence(&cell->sequence, pos + 1);
+		return true;
+	}
+
+	sp<E> dequeue() {
+		Cell* cell;
+		llong pos = loadPos(&dequeuePos);
+		for (;;) {
+			cell = &buffer[pos & mask];
+			llong dif = EOrderAccess::load_acquire(&cell->sequence) - (pos + 1);
+			if (dif == 0) {
+				if (EUnsafe::compareAndSwapLLong(&dequeuePos, pos, pos + 1))
+					break;
+				pos = loadPos(&dequeuePos);
+			} else if (dif < 0) {
+				return null; // empty
+			} else {
+				pos = loadPos(&dequeuePos);
+			}
+		}
+		sp<E> x;
+		x.swap(cell->item);
+		// free the slot; the fence orders it before the read of putters
+		EOrderAccess::release_store_fence(&cell->sequence, pos + mask + 1);
+		return x;
+	}
+
+	void signalNotEmpty() {
+		SYNCBLOCK(&lock) {
+			notEmpty->signal();
+		}}
+	}
+
+	void signalNotFull() {
+		SYNCBLOCK(&lock) {
+			notFull->signal();
+		}}
+	}
+
+	template<typename C>
+	int drainTo0(C* c, int maxElements) {
+		int n = 0;
+		while (n < maxElements) {
+			// count the run of published slots starting at the head
+			llong pos = loadPos(&dequeuePos);
+			int k = 0;
+			while (n + k < maxElements && k < capacity_ &&
+					EOrderAccess::load_acquire(&buffer[(pos + k) & mask].sequence) == pos + k + 1) {
+				k++;
+			}
+			if (k == 0)
+				break;
+			if (!EUnsafe::compareAndSwapLLong(&dequeuePos, pos, pos + k))
+				continue;
+			// slots [pos, pos + k) are ours now
+			int i = 0;
+			try {
+				for (; i < k; i++) {
+					Cell* cell = &buffer[(pos + i) & mask];
+					sp<E> x;
+					x.swap(cell->item);
+					EOrderAccess::release_store(&cell->sequence, pos + i + mask + 1);
+					c->add(x);
+				}
+			} catch (...) {
+				// release the remaining claimed slots, dropping their elements
+				for (i++; i < k; i++) {
+					Cell* cell = &buffer[(pos + i) & mask];
+					cell->item = null;
+					EOrderAccess::release_store(&cell->sequence, pos + i + mask + 1);
+				}
+				EUnsafe::fullFence();
+				if (putters > 0)
+					signalNotFull();
+				throw; //!
+			}
+			n += k;
+		}
+		if (n > 0) {
+			EUnsafe::fullFence();
+			if (putters > 0) {
+				SYNCBLOCK(&lock) {
+					notFull->signalAll();
+				}}
+			}
+		}
+		return n;
+	}
+
+	class Itr : public EConcurrentIterator<E> {
+	private:
+		EMPMCQueue<E>* self;
+		EA<sp<E> > snapshot;
+		int cursor;
+		sp<E> lastRet;
+
+	public:
+		Itr(EMPMCQueue<E>* s) : self(s), snapshot(s->toArray()), cursor(0) {
+		}
+
+		boolean hasNext() {
+			return cursor < snapshot.length();
+		}
+
+		sp<E> next() {
+			if (cursor >= snapshot.length())
+				throw ENoSuchElementException(__FILE__, __LINE__);
+			lastRet = snapshot[cursor++];
+			return lastRet;
+		}
+
+		void remove() {
+			if (lastRet == null)
+				throw EIllegalStateException(__FILE__, __LINE__);
+			sp<E> x = lastRet;
+			lastRet = null;
+			self->removeElement(x.get(), true);
+		}
+	};
+};
+
+} /* namespace efc */
+#endif /* EMPMCQUEUE_HH_ */
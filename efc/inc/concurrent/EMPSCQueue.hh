@@ -0,0 +1,275 @@
+/*
+ * EMPSCQueue.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EMPSCQUEUE_HH_
+#define EMPSCQUEUE_HH_
+
+#include "../EA.hh"
+#include "../EInteger.hh"
+#include "../ECollection.hh"
+#include "./EOrderAccess.hh"
+#include "./EConcurrentQueue.hh"
+#include "../ENoSuchElementException.hh"
+#include "../ENullPointerException.hh"
+#include "../EIllegalArgumentException.hh"
+#include "../EUnsupportedOperationException.hh"
+
+namespace efc {
+
+/**
+ * Link field of an element of {@link EMPSCQueue}.
+ */
+class EMPSCQueueLink {
+public:
+	EMPSCQueueLink() : mpsc_next(null) {
+	}
+
+protected:
+	template<typename E> friend class EMPSCQueue;
+
+	EMPSCQueueLink* volatile mpsc_next;
+};
+
+/**
+ * A helper class for the intrusive {@link EMPSCQueue}: element types
+ * derive (non-virtually) from <tt>EMPSCQueueEntry&lt;Self&gt;</tt>.
+ * The entry keeps the queue's reference to the element while it is
+ * queued, so an element can be in at most one such queue at a time.
+ */
+template<typename E>
+class EMPSCQueueEntry: public EMPSCQueueLink {
+protected:
+	template<typename T> friend class EMPSCQueue;
+
+	sp<E> mpsc_self;
+};
+
+/**
+ * An unbounded intrusive {@linkplain EConcurrentQueue queue} for any
+ * number of producer threads and exactly one consumer thread
+ * (D. Vyukov's intrusive MPSC node-based queue).  This queue orders
+ * elements FIFO (first-in-first-out) and does not permit <tt>null</tt>
+ * elements.
+ *
+ * <p>The link lives in the element itself (see {@link EMPSCQueueEntry}),
+ * so nothing is allocated per insertion.  A producer links its element
+ * with a single atomic exchange of the tail; the consumer unlinks with
+ * plain loads and stores, and only executes an atomic instruction when
+ * it takes the last element and has to put the stub node back.
+ *
+ * <p>A producer that has exchanged the tail but not yet linked its
+ * predecessor makes the queue briefly look empty to the consumer from
+ * that point on; {@link #poll} then returns <tt>null</tt> and the
+ * element is seen by a later call.
+ *
+ * <p>{@link #offer} may be called from any thread; {@link #poll},
+ * {@link #peek}, {@link #drainTo}, {@link #size}, {@link #isEmpty} and
+ * {@link #clear} only from the consumer thread.
+ */
+
+template<typename E>
+class EMPSCQueue: public EConcurrentQueue<E> {
+public:
+	~EMPSCQueue() {
+		// release the references held by queued entries
+		while (poll() != null)
+			;
+	}
+
+	/**
+	 * Creates an <tt>EMPSCQueue</tt> that is initially empty.
+	 */
+	EMPSCQueue() {
+		tail = head = &stub;
+	}
+
+	boolean add(E* e) {
+		return offer(e);
+	}
+	boolean add(sp<E> e) {
+		return offer(e);
+	}
+
+	/**
+	 * Inserts the specified element at the tail of this queue.
+	 *
+	 * @return <tt>true</tt> (as specified by {@link Queue#offer})
+	 * @throws NullPointerException if the specified element is null
+	 */
+	boolean offer(E* e) {
+		sp<E> x(e);
+		return offer(x);
+	}
+	boolean offer(sp<E> e) {
+		if (e == null) throw ENullPointerException(__FILE__, __LINE__);
+		EMPSCQueueEntry<E>* entry = e.get();
+		entry->mpsc_self.swap(e);
+		push(entry);
+		return true;
+	}
+
+	/**
+	 * Retrieves and removes the head of this queue, or returns
+	 * <tt>null</tt> if this queue is empty.  Consumer thread only.
+	 */
+	sp<E> poll() {
+		EMPSCQueueEntry<E>* entry = pop();
+		sp<E> x;
+		if (entry != null)
+			x.swap(entry->mpsc_self);
+		return x;
+	}
+
+	/**
+	 * Removes at most <tt>maxElements</tt> available elements and adds
+	 * them to the given collection.  Consumer thread only.
+	 *
+	 * @return the number of elements transferred
+	 */
+	int drainTo(ECollection<sp<E> >* c, int maxElements=EInteger::MAX_VALUE) {
+		return drainTo0(c, maxElements);
+	}
+	int drainTo(EConcurrentCollection<E>* c, int maxElements=EInteger::MAX_VALUE) {
+		if (c == dynamic_cast<EConcurrentCollection<E>*>(this))
+			throw EIllegalArgumentException(__FILE__, __LINE__);
+		return drainTo0(c, maxElements);
+	}
+
+	sp<E> element() {
+		sp<E> x = peek();
+		if (x != null)
+			return x;
+		else
+			throw ENoSuchElementException(__FILE__, __LINE__);
+	}
+
+	/**
+	 * Consumer thread only.
+	 */
+	sp<E> peek() {
+		EMPSCQueueLink* t = head;
+		if (t == &stub) {
+			t = (EMPSCQueueLink*)EOrderAccess::load_ptr_acquire(&t->mpsc_next);
+			if (t == null)
+				return null;
+		}
+		return static_cast<EMPSCQueueEntry<E>*>(t)->mpsc_self;
+	}
+
+	sp<E> remove() {
+		sp<E> x = poll();
+		if (x != null)
+			return x;
+		else
+			throw ENoSuchElementException(__FILE__, __LINE__);
+	}
+
+	/**
+	 * Consumer thread only.
+	 */
+	void clear() {
+		while (poll() != null)
+			;
+	}
+
+	/**
+	 * Consumer thread only.
+	 */
+	boolean isEmpty() {
+		return peek() == null;
+	}
+
+	/**
+	 * Returns the number of linked elements.  This is an O(n)
+	 * traversal.  Consumer thread only.
+	 */
+	int size() {
+		int n = 0;
+		for (EMPSCQueueLink* p = head; p != null;
+				p = (EMPSCQueueLink*)EOrderAccess::load_ptr_acquire(&p->mpsc_next)) {
+			if (p != &stub && ++n == EInteger::MAX_VALUE)
+				break;
+		}
+		return n;
+	}
+
+	boolean contains(E* o) {
+		throw EUnsupportedOperationException(__FILE__, __LINE__);
+	}
+
+	boolean remove(E* o) {
+		throw EUnsupportedOperationException(__FILE__, __LINE__);
+	}
+
+	sp<EConcurrentIterator<E> > iterator() {
+		throw EUnsupportedOperationException(__FILE__, __LINE__);
+	}
+
+	EA<sp<E> > toArray() {
+		throw EUnsupportedOperationException(__FILE__, __LINE__);
+	}
+
+private:
+	/** Last linked node; exchanged by producers */
+	EMPSCQueueLink* volatile tail;
+	char pad0[ES_CACHE_LINE_SIZE - sizeof(void*)];
+	/** Next node to consume; owned by the consumer */
+	EMPSCQueueLink* head;
+	EMPSCQueueLink stub;
+	char pad1[ES_CACHE_LINE_SIZE - 2 * sizeof(void*)];
+
+	void push(EMPSCQueueLink* n) {
+		n->mpsc_next = null;
+		EOrderAccess::release();
+		EMPSCQueueLink* prev = (EMPSCQueueLink*)eso_atomic_test_and_setptr(
+				(volatile es_intptr_t*)&tail, (es_intptr_t*)n);
+		EOrderAccess::release_store_ptr(&prev->mpsc_next, n);
+	}
+
+	EMPSCQueueEntry<E>* pop() {
+		EMPSCQueueLink* t = head;
+		EMPSCQueueLink* next = (EMPSCQueueLink*)EOrderAccess::load_ptr_acquire(&t->mpsc_next);
+		if (t == &stub) {
+			if (next == null)
+				return null;
+			head = next;
+			t = next;
+			next = (EMPSCQueueLink*)EOrderAccess::load_ptr_acquire(&next->mpsc_next);
+		}
+		if (next != null) {
+			head = next;
+			return static_cast<EMPSCQueueEntry<E>*>(t);
+		}
+		if (t != (EMPSCQueueLink*)EOrderAccess::load_ptr_acquire(&tail))
+			return null; // a producer is between exchange and link
+		push(&stub);
+		next = (EMPSCQueueLink*)EOrderAccess::load_ptr_acquire(&t->mpsc_next);
+		if (next != null) {
+			head = next;
+			return static_cast<EMPSCQueueEntry<E>*>(t);
+		}
+		return null;
+	}
+
+	template<typename C>
+	int drainTo0(C* c, int maxElements) {
+		if (c == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		int n = 0;
+		EMPSCQueueEntry<E>* entry;
+		while (n < maxElements && (entry = pop()) != null) {
+			sp<E> x;
+			x.swap(entry->mpsc_self);
+			n++;
+			c->add(x);
+		}
+		return n;
+	}
+};
+
+} /* namespace efc */
+#endif /* EMPSCQUEUE_HH_ */
@@ -0,0 +1,75 @@
+/*
+ * EPadded.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EPADDED_HH_
+#define EPADDED_HH_
+
+#include "../../EBase.hh"
+
+namespace efc {
+
+/**
+ * Holds a value of type {@code T} with a full cache line of padding
+ * on either side, so that writes to it never invalidate the cache
+ * line of a neighbouring field, and vice versa (false sharing).
+ *
+ * <p>Use it for counters and other plain fields of long-lived objects
+ * that are written by different threads, e.g. the element count that
+ * both the producer and the consumer side of a queue update.  Only
+ * the object itself is padded: for handle types whose state lives on
+ * the heap, such as {@link EReentrantLock} or {@link ESpinLock}, the
+ * wrapper gains nothing.  The padding does not depend on the alignment
+ * of the enclosing object, which {@code new} does not raise to a cache
+ * line before C++17; for static data {@link ES_CACHELINE_ALIGNED} is
+ * the cheaper tool (see {@code ERCHazardPool}).
+ *
+ * <pre> {@code
+ * EPadded<EAtomicInteger> count;
+ *
+ * count->getAndIncrement();
+ * }</pre>
+ *
+ * @param <T> the type of the padded value
+ */
+
+template<typename T>
+class EPadded {
+public:
+	EPadded() : value() {
+	}
+
+	/**
+	 * Creates the value from a single constructor argument.
+	 */
+	template<typename A>
+	explicit EPadded(const A& a) : value(a) {
+	}
+
+	T* get() {
+		return &value;
+	}
+
+	T* operator->() {
+		return &value;
+	}
+
+	T& operator*() {
+		return value;
+	}
+
+private:
+	char before[ES_CACHE_LINE_SIZE];
+	T value;
+	char after[ES_CACHE_LINE_SIZE];
+
+	// unsupported.
+	EPadded(const EPadded&);
+	EPadded& operator=(const EPadded&);
+};
+
+} /* namespace efc */
+#endif /* EPADDED_HH_ */
@@ -0,0 +1,504 @@
+/*
+ * EPhaser.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EPHASER_HH_
+#define EPHASER_HH_
+
+#include "../EThread.hh"
+#include "../ETimeUnit.hh"
+#include "../ESharedPtr.hh"
+#include "../ESynchronizeable.hh"
+#include "../EInterruptedException.hh"
+#include "../EIllegalStateException.hh"
+#include "../EIllegalArgumentException.hh"
+#include "./ETimeoutException.hh"
+
+namespace efc {
+
+namespace phaser {
+	class QNode;
+}
+
+//@see: openjdk-8/src/share/classes/java/util/concurrent/Phaser.java
+
+/**
+ * A reusable synchronization barrier, similar in functionality to
+ * {@link ECyclicBarrier} and {@link ECountDownLatch} but supporting
+ * more flexible usage.
+ *
+ * <p><b>Registration.</b> Unlike the case for other barriers, the
+ * number of parties <em>registered</em> to synchronize on a phaser
+ * may vary over time.  Tasks may be registered at any time (using
+ * methods {@link #register_}, {@link #bulkRegister}, or forms of
+ * constructors establishing initial numbers of parties), and
+ * optionally deregistered upon any arrival (using {@link
+ * #arriveAndDeregister}).  As is the case with most basic
+ * synchronization constructs, registration and deregistration affect
+ * only internal counts; they do not establish any further internal
+ * bookkeeping, so tasks cannot query whether they are registered.
+ *
+ * <p><b>Synchronization.</b> Like a {@code CyclicBarrier}, a {@code
+ * Phaser} may be repeatedly awaited.  Method {@link
+ * #arriveAndAwaitAdvance} has effect analogous to {@link
+ * ECyclicBarrier#await CyclicBarrier.await}. Each generation of a
+ * phaser has an associated phase number. The phase number starts at
+ * zero, and advances when all parties arrive at the phaser, wrapping
+ * around to zero after reaching {@code EInteger::MAX_VALUE}. The use
+ * of phase numbers enables independent control of actions upon
+ * arrival at a phaser and upon awaiting others, via two kinds of
+ * methods that may be invoked by any registered party:
+ *
+ * <ul>
+ *
+ *   <li> <b>Arrival.</b> Methods {@link #arrive} and
+ *       {@link #arriveAndDeregister} record arrival.  These methods
+ *       do not block, but return an associated <em>arrival phase
+ *       number</em>; that is, the phase number of the phaser to which
+ *       the arrival applied. When the final party for a given phase
+ *       arrives, an optional action is performed and the phase
+ *       advances.  These actions are performed by the party
+ *       triggering a phase advance, and are arranged by overriding
+ *       method {@link #onAdvance(int, int)}, which also controls
+ *       termination.
+ *
+ *   <li> <b>Waiting.</b> Method {@link #awaitAdvance} requires an
+ *       argument indicating an arrival phase number, and returns when
+ *       the phaser advances to (or is already at) a different phase.
+ *       Unlike similar constructions using {@code CyclicBarrier},
+ *       method {@code awaitAdvance} continues to wait even if the
+ *       waiting thread is interrupted. Interruptible and timeout
+ *       versions are also available, but exceptions encountered while
+ *       tasks wait interruptibly or with timeout do not change the
+ *       state of the phaser.
+ *
+ * </ul>
+ *
+ * <p><b>Termination.</b> A phaser may enter a <em>termination</em>
+ * state, that may be checked using method {@link #isTerminated}. Upon
+ * termination, all synchronization methods immediately return without
+ * waiting for advance, as indicated by a negative return value.
+ * Similarly, attempts to register upon termination have no effect.
+ * Termination is triggered when an invocation of {@code onAdvance}
+ * returns {@code true}. The default implementation returns {@code
+ * true} if a deregistration has caused the number of registered
+ * parties to become zero.  Method {@link #forceTermination} is also
+ * available to abruptly release waiting threads and allow them to
+ * terminate.
+ *
+ * <p><b>Tiering.</b> Phasers may be <em>tiered</em> (i.e.,
+ * constructed in tree structures) to reduce contention. Phasers with
+ * large numbers of parties that would otherwise experience heavy
+ * synchronization contention costs may instead be set up so that
+ * groups of sub-phasers share a common parent.  This may greatly
+ * increase throughput even though it incurs greater per-operation
+ * overhead.
+ *
+ * <p>In a tree of tiered phasers, registration and deregistration of
+ * child phasers with their parent are managed automatically.
+ * Whenever the number of registered parties of a child phaser becomes
+ * non-zero, the child is registered with its parent.  Whenever the
+ * number of registered parties becomes zero as the result of an
+ * invocation of {@link #arriveAndDeregister}, the child phaser is
+ * deregistered from its parent.
+ *
+ * <p><b>Waiting.</b> There is no lock.  All state lives in one 64-bit
+ * word that arrivals update with a CAS.  A thread that has to wait
+ * first spins, longer while other parties keep arriving.  It then
+ * pushes a node on the root's lock-free wait stack and parks.  The
+ * party that advances the phase detaches the whole stack and wakes
+ * it as a tree: every woken waiter is handed half of the remaining
+ * nodes to wake in turn.  Releasing {@code n} waiters therefore takes
+ * about {@code log2(n)} unpark latencies rather than {@code n}, and
+ * no lock is contended.
+ *
+ * <p><b>Monitoring.</b> While synchronization methods may be invoked
+ * only by registered parties, the current state of a phaser may be
+ * monitored by any caller.  At any given moment there are {@link
+ * #getRegisteredParties} parties in total, of which {@link
+ * #getArrivedParties} have arrived at the current phase ({@link
+ * #getPhase}).  When the remaining ({@link #getUnarrivedParties})
+ * parties arrive, the phase advances.
+ *
+ * <p><b>Sample usages:</b>
+ *
+ * <p>A {@code Phaser} may be used instead of a {@code CountDownLatch}
+ * to control a one-shot action serving a variable number of parties.
+ * The typical idiom is for the method setting this up to first
+ * register, then start the actions, then deregister, as in:
+ *
+ * <pre> {@code
+ * void runTasks(EList<sp<ERunnable> >* tasks) {
+ *   sp<EPhaser> phaser = new EPhaser(1); // "1" to register self
+ *   // create and start threads
+ *   sp<EIterator<sp<ERunnable> > > it = tasks->iterator();
+ *   while (it->hasNext()) {
+ *     sp<ERunnable> task = it->next();
+ *     phaser->register_();
+ *     EThread::executeX([phaser, task]() {
+ *       phaser->arriveAndAwaitAdvance(); // await all creation
+ *       task->run();
+ *     });
+ *   }
+ *
+ *   // allow threads to start and deregister self
+ *   phaser->arriveAndDeregister();
+ * }}</pre>
+ *
+ * <p>To create a set of {@code n} tasks using a tree of phasers, you
+ * could use code of the following form, assuming a Task class with a
+ * constructor accepting a {@code EPhaser} that it registers with upon
+ * construction. After invocation of {@code build(actions, 0, n, phaser)},
+ * these tasks could then be started, for example by submitting to a
+ * pool:
+ *
+ * <pre> {@code
+ * void build(EA<sp<Task> >* tasks, int lo, int hi, sp<EPhaser> ph) {
+ *   if (hi - lo > TASKS_PER_PHASER) {
+ *     for (int i = lo; i < hi; i += TASKS_PER_PHASER) {
+ *       int j = ES_MIN(i + TASKS_PER_PHASER, hi);
+ *       build(tasks, i, j, new EPhaser(ph));
+ *     }
+ *   } else {
+ *     for (int i = lo; i < hi; ++i)
+ *       (*tasks)[i] = new Task(ph);
+ *       // assumes new Task(ph) performs ph->register_()
+ *   }
+ * }}</pre>
+ *
+ * The best value of {@code TASKS_PER_PHASER} depends mainly on
+ * expected synchronization rates. A value as low as four may
+ * be appropriate for extremely small per-phase task bodies (thus
+ * high rates), or up to hundreds for extremely large ones.
+ *
+ * <p><b>Implementation notes</b>: This implementation restricts the
+ * maximum number of parties to 65535. Attempts to register additional
+ * parties result in {@code EIllegalStateException}. However, you can and
+ * should create tiered phasers to accommodate arbitrarily large sets
+ * of participants.
+ *
+ * <p>A child phaser keeps its parent alive; the tree is released when
+ * the last leaf goes away.
+ */
+
+class EPhaser: public ESynchronizeable {
+public:
+	virtual ~EPhaser();
+
+	/**
+	 * Creates a new phaser with the given parent and number of
+	 * registered unarrived parties.  When the given parent is non-null
+	 * and the given number of parties is greater than zero, this
+	 * child phaser is registered with its parent.
+	 *
+	 * @param parties the number of parties required to advance to the
+	 * next phase
+	 * @throws EIllegalArgumentException if parties less than zero
+	 * or greater than the maximum number of parties supported
+	 */
+	EPhaser(int parties=0) THROWS(EIllegalArgumentException);
+
+	/**
+	 * Creates a new phaser with the given parent and number of
+	 * registered unarrived parties.
+	 *
+	 * @param parent the parent phaser
+	 * @param parties the number of parties required to advance to the
+	 * next phase
+	 * @throws EIllegalArgumentException if parties less than zero
+	 * or greater than the maximum number of parties supported
+	 */
+	EPhaser(sp<EPhaser> parent, int parties=0) THROWS(EIllegalArgumentException);
+
+	/**
+	 * Adds a new unarrived party to this phaser.  If an ongoing
+	 * invocation of {@link #onAdvance} is in progress, this method
+	 * may await its completion before returning.  If this phaser has
+	 * a parent, and this phaser previously had no registered parties,
+	 * this child phaser is also registered with its parent. If
+	 * this phaser is terminated, the attempt to register has
+	 * no effect, and a negative value is returned.
+	 *
+	 * @return the arrival phase number to which this registration
+	 * applied.  If this value is negative, then this phaser has
+	 * terminated, in which case registration has no effect.
+	 * @throws EIllegalStateException if attempting to register more
+	 * than the maximum supported number of parties
+	 */
+	int register_() THROWS(EIllegalStateException);
+
+	/**
+	 * Adds the given number of new unarrived parties to this phaser.
+	 * If an ongoing invocation of {@link #onAdvance} is in progress,
+	 * this method may await its completion before returning.  If this
+	 * phaser has a parent, and the given number of parties is greater
+	 * than zero, and this phaser previously had no registered
+	 * parties, this child phaser is also registered with its parent.
+	 * If this phaser is terminated, the attempt to register has no
+	 * effect, and a negative value is returned.
+	 *
+	 * @param parties the number of additional parties required to
+	 * advance to the next phase
+	 * @return the arrival phase number to which this registration
+	 * applied.  If this value is negative, then this phaser has
+	 * terminated, in which case registration has no effect.
+	 * @throws EIllegalStateException if attempting to register more
+	 * than the maximum supported number of parties
+	 * @throws EIllegalArgumentException if {@code parties < 0}
+	 */
+	int bulkRegister(int parties) THROWS2(EIllegalStateException, EIllegalArgumentException);
+
+	/**
+	 * Arrives at this phaser, without waiting for others to arrive.
+	 *
+	 * <p>It is a usage error for an unregistered party to invoke this
+	 * method.  However, this error may result in an {@code
+	 * EIllegalStateException} only upon some subsequent operation on
+	 * this phaser, if ever.
+	 *
+	 * @return the arrival phase number, or a negative value if terminated
+	 * @throws EIllegalStateException if not terminated and the number
+	 * of unarrived parties would become negative
+	 */
+	int arrive() THROWS(EIllegalStateException);
+
+	/**
+	 * Arrives at this phaser and deregisters from it without waiting
+	 * for others to arrive. Deregistration reduces the number of
+	 * parties required to advance in future phases.  If this phaser
+	 * has a parent, and deregistration causes this phaser to have
+	 * zero parties, this phaser is also deregistered from its parent.
+	 *
+	 * @return the arrival phase number, or a negative value if terminated
+	 * @throws EIllegalStateException if not terminated and the number
+	 * of registered or unarrived parties would become negative
+	 */
+	int arriveAndDeregister() THROWS(EIllegalStateException);
+
+	/**
+	 * Arrives at this phaser and awaits others. Equivalent in effect
+	 * to {@code awaitAdvance(arrive())}.  If you need to await with
+	 * interruption or timeout, you can arrange this with an analogous
+	 * construction using one of the other forms of the {@code
+	 * awaitAdvance} method.  If instead you need to deregister upon
+	 * arrival, use {@code awaitAdvance(arriveAndDeregister())}.
+	 *
+	 * @return the arrival phase number, or the (negative)
+	 * {@linkplain #getPhase() current phase} if terminated
+	 * @throws EIllegalStateException if not terminated and the number
+	 * of unarrived parties would become negative
+	 */
+	int arriveAndAwaitAdvance() THROWS(EIllegalStateException);
+
+	/**
+	 * Awaits the phase of this phaser to advance from the given phase
+	 * value, returning immediately if the current phase is not equal
+	 * to the given phase value or this phaser is terminated.
+	 *
+	 * @param phase an arrival phase number, or negative value if
+	 * terminated; this argument is normally the value returned by a
+	 * previous call to {@code arrive} or {@code arriveAndDeregister}.
+	 * @return the next arrival phase number, or the argument if it is
+	 * negative, or the (negative) {@linkplain #getPhase() current phase}
+	 * if terminated
+	 */
+	int awaitAdvance(int phase);
+
+	/**
+	 * Awaits the phase of this phaser to advance from the given phase
+	 * value, throwing {@code EInterruptedException} if interrupted
+	 * while waiting, or returning immediately if the current phase is
+	 * not equal to the given phase value or this phaser is
+	 * terminated.
+	 *
+	 * @param phase an arrival phase number, or negative value if
+	 * terminated; this argument is normally the value returned by a
+	 * previous call to {@code arrive} or {@code arriveAndDeregister}.
+	 * @return the next arrival phase number, or the argument if it is
+	 * negative, or the (negative) {@linkplain #getPhase() current phase}
+	 * if terminated
+	 * @throws EInterruptedException if thread interrupted while waiting
+	 */
+	int awaitAdvanceInterruptibly(int phase) THROWS(EInterruptedException);
+
+	/**
+	 * Awaits the phase of this phaser to advance from the given phase
+	 * value or the given timeout to elapse, throwing {@code
+	 * EInterruptedException} if interrupted while waiting, or
+	 * returning immediately if the current phase is not equal to the
+	 * given phase value or this phaser is terminated.
+	 *
+	 * @param phase an arrival phase number, or negative value if
+	 * terminated; this argument is normally the value returned by a
+	 * previous call to {@code arrive} or {@code arriveAndDeregister}.
+	 * @param timeout how long to wait before giving up, in units of
+	 *        {@code unit}
+	 * @param unit a {@code ETimeUnit} determining how to interpret the
+	 *        {@code timeout} parameter
+	 * @return the next arrival phase number, or the argument if it is
+	 * negative, or the (negative) {@linkplain #getPhase() current phase}
+	 * if terminated
+	 * @throws EInterruptedException if thread interrupted while waiting
+	 * @throws ETimeoutException if timed out while waiting
+	 */
+	int awaitAdvanceInterruptibly(int phase, llong timeout, ETimeUnit* unit)
+			THROWS2(EInterruptedException, ETimeoutException);
+
+	/**
+	 * Forces this phaser to enter termination state.  Counts of
+	 * registered parties are unaffected.  If this phaser is a member
+	 * of a tiered set of phasers, then all of the phasers in the set
+	 * are terminated.  If this phaser is already terminated, this
+	 * method has no effect.  This method may be useful for
+	 * coordinating recovery after one or more tasks encounter
+	 * unexpected exceptions.
+	 */
+	void forceTermination();
+
+	/**
+	 * Returns the current phase number. The maximum phase number is
+	 * {@code EInteger::MAX_VALUE}, after which it restarts at
+	 * zero. Upon termination, the phase number is negative,
+	 * in which case the prevailing phase prior to termination
+	 * may be obtained via {@code getPhase() + EInteger::MIN_VALUE}.
+	 *
+	 * @return the phase number, or a negative value if terminated
+	 */
+	int getPhase();
+
+	/**
+	 * Returns the number of parties registered at this phaser.
+	 *
+	 * @return the number of parties
+	 */
+	int getRegisteredParties();
+
+	/**
+	 * Returns the number of registered parties that have arrived at
+	 * the current phase of this phaser. If this phaser has terminated,
+	 * the returned value is meaningless and arbitrary.
+	 *
+	 * @return the number of arrived parties
+	 */
+	int getArrivedParties();
+
+	/**
+	 * Returns the number of registered parties that have not yet
+	 * arrived at the current phase of this phaser. If this phaser has
+	 * terminated, the returned value is meaningless and arbitrary.
+	 *
+	 * @return the number of unarrived parties
+	 */
+	int getUnarrivedParties();
+
+	/**
+	 * Returns the parent of this phaser, or {@code null} if none.
+	 *
+	 * @return the parent of this phaser, or {@code null} if none
+	 */
+	sp<EPhaser> getParent();
+
+	/**
+	 * Returns the root ancestor of this phaser, which is the same as
+	 * this phaser if it has no parent.
+	 *
+	 * @return the root ancestor of this phaser
+	 */
+	EPhaser* getRoot();
+
+	/**
+	 * Returns {@code true} if this phaser has been terminated.
+	 *
+	 * @return {@code true} if this phaser has been terminated
+	 */
+	boolean isTerminated();
+
+	/**
+	 * Returns a string identifying this phaser, as well as its
+	 * state.  The state, in brackets, includes the String {@code
+	 * "phase = "} followed by the phase number, {@code "parties = "}
+	 * followed by the number of registered parties, and {@code
+	 * "arrived = "} followed by the number of arrived parties.
+	 *
+	 * @return a string identifying this phaser, as well as its state
+	 */
+	virtual EStringBase toString();
+
+protected:
+	/**
+	 * Overridable method to perform an action upon impending phase
+	 * advance, and to control termination. This method is invoked
+	 * upon arrival of the party advancing this phaser (when all other
+	 * waiting parties are dormant).  If this method returns {@code
+	 * true}, this phaser will be set to a final termination state
+	 * upon advance, and subsequent calls to {@link #isTerminated}
+	 * will return true. Any (unchecked) exception thrown by an
+	 * invocation of this method is propagated to the party attempting
+	 * to advance this phaser, in which case no advance occurs.
+	 *
+	 * <p>The arguments to this method provide the state of the phaser
+	 * prevailing for the current transition.  The effects of invoking
+	 * arrival, registration, and waiting methods on this phaser from
+	 * within {@code onAdvance} are unspecified and should not be
+	 * relied on.
+	 *
+	 * <p>If this phaser is a member of a tiered set of phasers, then
+	 * {@code onAdvance} is invoked only for its root phaser on each
+	 * advance.
+	 *
+	 * <p>The default implementation returns {@code true} when
+	 * registered parties has become zero.
+	 *
+	 * @param phase the current phase number on entry to this method,
+	 * before this phaser is advanced
+	 * @param registeredParties the current number of registered parties
+	 * @return {@code true} if this phaser should terminate
+	 */
+	virtual boolean onAdvance(int phase, int registeredParties);
+
+private:
+	/**
+	 * Primary state representation, holding four bit-fields:
+	 *
+	 * unarrived  -- the number of parties yet to hit barrier (bits  0-15)
+	 * parties    -- the number of parties to wait            (bits 16-31)
+	 * phase      -- the generation of the barrier            (bits 32-62)
+	 * terminated -- set if barrier is terminated             (bit  63 / sign)
+	 */
+	volatile llong state;
+
+	/**
+	 * The parent of this phaser, or null if none.
+	 */
+	sp<EPhaser> parent;
+
+	/**
+	 * The root of phaser tree. Equals this if not in a tree.
+	 */
+	EPhaser* root;
+
+	/**
+	 * Heads of the wait stacks of the root, for even and odd phases;
+	 * children use the root's.
+	 */
+	phaser::QNode* volatile evenQ_;
+	phaser::QNode* volatile oddQ_;
+	phaser::QNode* volatile* evenQ;
+	phaser::QNode* volatile* oddQ;
+
+	void init(int parties);
+	int doArrive(int adjust);
+	int doRegister(int registrations);
+	llong reconcileState();
+	void releaseWaiters(int phase);
+	int abortWait(int phase);
+	int internalAwaitAdvance(int phase, boolean interruptible, boolean timed,
+			llong nanos, boolean* interrupted);
+	EStringBase stateToString(llong s);
+};
+
+} /* namespace efc */
+#endif /* EPHASER_HH_ */
@@ -0,0 +1,688 @@
+/*
+ * EPriorityBlockingQueue.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EPRIORITYBLOCKINGQUEUE_HH_
+#define EPRIORITYBLOCKINGQUEUE_HH_
+
+#include "../EInteger.hh"
+#include "../EThread.hh"
+#include "../ETimeUnit.hh"
+#include "../EComparator.hh"
+#include "../EComparable.hh"
+#include "./EBlockingQueue.hh"
+#include "./EReentrantLock.hh"
+#include "./EAbstractConcurrentQueue.hh"
+#include "./EUnsafe.hh"
+#include "../EInterruptedException.hh"
+#include "../ENullPointerException.hh"
+#include "../EClassCastException.hh"
+#include "../EIllegalArgumentException.hh"
+#include "../EIllegalStateException.hh"
+#include "../ENoSuchElementException.hh"
+#include "../EOutOfMemoryError.hh"
+
+namespace efc {
+
+//@see: openjdk-8/src/share/classes/java/util/concurrent/PriorityBlockingQueue.java
+
+/**
+ * An unbounded {@linkplain BlockingQueue blocking queue} that uses
+ * the same ordering rules as class {@link EPriorityQueue} and supplies
+ * blocking retrieval operations.  While this queue is logically
+ * unbounded, attempted additions may fail due to resource exhaustion
+ * (causing {@code OutOfMemoryError}). This class does not permit
+ * {@code null} elements.  A priority queue relying on {@linkplain
+ * Comparable natural ordering} also does not permit insertion of
+ * non-comparable objects (doing so results in
+ * {@code ClassCastException}).
+ *
+ * <p>This class and its iterator implement all of the
+ * <em>optional</em> methods of the {@link Collection} and {@link
+ * Iterator} interfaces.  The Iterator provided in method {@link
+ * #iterator()} is <em>not</em> guaranteed to traverse the elements of
+ * the PriorityBlockingQueue in any particular order. If you need
+ * ordered traversal, consider using
+ * {@code EArrays::sort(pq.toArray())}.  Also, method {@code drainTo}
+ * can be used to <em>remove</em> some or all elements in priority
+ * order and place them in another collection.
+ *
+ * <p>Operations on this class make no guarantees about the ordering
+ * of elements with equal priority.
+ *
+ * <p>All operations hold one lock, which makes this queue a simple
+ * choice for a few producers and consumers.  When many threads insert
+ * and remove at once, {@link EConcurrentSkipListPriorityQueue} does
+ * not serialize them.
+ *
+ * @since 1.5
+ * @param <E> the type of elements held in this collection
+ */
+
+template<typename E>
+class EPriorityBlockingQueue: virtual public EAbstractConcurrentQueue<E>,
+		virtual public EBlockingQueue<E>, public EBatchOfferQueue<E> {
+public:
+	virtual ~EPriorityBlockingQueue() {
+		delete[] queue;
+		delete notEmpty;
+	}
+
+	/**
+	 * Creates a {@code PriorityBlockingQueue} with the specified initial
+	 * capacity that orders its elements according to the specified
+	 * comparator, or their {@linkplain Comparable natural ordering} if
+	 * the comparator is null.
+	 *
+	 * @param initialCapacity the initial capacity for this priority queue
+	 * @param  comparator the comparator that will be used to order this
+	 *         priority queue.  If {@code null}, the {@linkplain Comparable
+	 *         natural ordering} of the elements will be used.
+	 * @throws IllegalArgumentException if {@code initialCapacity} is less
+	 *         than 1
+	 */
+	explicit
+	EPriorityBlockingQueue(int initialCapacity = DEFAULT_INITIAL_CAPACITY,
+			EComparator<E*>* comparator = null) :
+			size_(0), cmp(comparator), allocationSpinLock(0) {
+		if (initialCapacity < 1)
+			throw EIllegalArgumentException(__FILE__, __LINE__);
+		queue = new sp<E>[initialCapacity];
+		capacity_ = initialCapacity;
+		notEmpty = lock.newCondition();
+	}
+
+	/**
+	 * Inserts the specified element into this priority queue.
+	 *
+	 * @param e the element to add
+	 * @return {@code true} (as specified by {@link Collection#add})
+	 * @throws ClassCastException if the specified element cannot be compared
+	 *         with elements currently in the priority queue according to the
+	 *         priority queue's ordering
+	 * @throws NullPointerException if the specified element is null
+	 */
+	virtual boolean add(E* e) {
+		return offer(e);
+	}
+	virtual boolean add(sp<E> e) {
+		return offer(e);
+	}
+
+	/**
+	 * Inserts the specified element into this priority queue.
+	 * As the queue is unbounded, this method will never return {@code false}.
+	 *
+	 * @param e the element to add
+	 * @return {@code true} (as specified by {@link Queue#offer})
+	 * @throws ClassCastException if the specified element cannot be compared
+	 *         with elements currently in the priority queue according to the
+	 *         priority queue's ordering
+	 * @throws NullPointerException if the specified element is null
+	 */
+	virtual boolean offer(E* e) {
+		sp<E> x(e);
+		return offer(x);
+	}
+	virtual boolean offer(sp<E> e) {
+		if (e == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		lock.lock();
+		try {
+			while (size_ >= capacity_)
+				tryGrow();
+			siftUp(size_, e);
+			size_++;
+			notEmpty->signal();
+		} catch (...) {
+			lock.unlock();
+			throw; //!
+		} finally {
+			lock.unlock();
+		}
+		return true;
+	}
+
+	/**
+	 * Inserts the run under a single acquisition of the lock, signalling
+	 * once per inserted element.
+	 *
+	 * @throws NullPointerException {@inheritDoc}
+	 */
+	virtual int offerAll(EList<sp<E> >* c, int offset) {
+		if (c == null) throw ENullPointerException(__FILE__, __LINE__);
+		int n = 0;
+		sp<EListIterator<sp<E> > > it = c->listIterator(offset);
+		lock.lock();
+		try {
+			while (it->hasNext()) {
+				sp<E> e = it->next();
+				if (e == null) throw ENullPointerException(__FILE__, __LINE__);
+				while (size_ >= capacity_)
+					tryGrow();
+				siftUp(size_, e);
+				size_++;
+				notEmpty->signal();
+				n++;
+			}
+		} catch (...) {
+			lock.unlock();
+			throw; //!
+		} finally {
+			lock.unlock();
+		}
+		return n;
+	}
+
+	/**
+	 * Inserts the specified element into this priority queue.
+	 * As the queue is unbounded, this method will never block.
+	 *
+	 * @param e the element to add
+	 * @throws ClassCastException if the specified element cannot be compared
+	 *         with elements currently in the priority queue according to the
+	 *         priority queue's ordering
+	 * @throws NullPointerException if the specified element is null
+	 */
+	virtual void put(E* e) THROWS(EInterruptedException) {
+		offer(e); // never need to block
+	}
+	virtual void put(sp<E> e) THROWS(EInterruptedException) {
+		offer(e); // never need to block
+	}
+
+	/**
+	 * Inserts the specified element into this priority queue.
+	 * As the queue is unbounded, this method will never block or
+	 * return {@code false}.
+	 *
+	 * @param e the element to add
+	 * @param timeout This parameter is ignored as the method never blocks
+	 * @param unit This parameter is ignored as the method never blocks
+	 * @return {@code true} (as specified by
+	 *  {@link BlockingQueue#offer(Object,long,TimeUnit) BlockingQueue.offer})
+	 * @throws ClassCastException if the specified element cannot be compared
+	 *         with elements currently in the priority queue according to the
+	 *         priority queue's ordering
+	 * @throws NullPointerException if the specified element is null
+	 */
+	virtual boolean offer(E* e, llong timeout, ETimeUnit* unit)
+			THROWS(EInterruptedException) {
+		return offer(e); // never need to block
+	}
+	virtual boolean offer(sp<E> e, llong timeout, ETimeUnit* unit)
+			THROWS(EInterruptedException) {
+		return offer(e); // never need to block
+	}
+
+	virtual sp<E> poll() {
+		sp<E> x;
+		SYNCBLOCK(&lock) {
+			x = dequeue();
+		}}
+		return x;
+	}
+
+	virtual sp<E> take() THROWS(EInterruptedException) {
+		sp<E> result;
+		lock.lockInterruptibly();
+		try {
+			while ( (result = dequeue()) == null)
+				notEmpty->await();
+		} catch (...) {
+			lock.unlock();
+			throw; //!
+		} finally {
+			lock.unlock();
+		}
+		return result;
+	}
+
+	virtual sp<E> poll(llong timeout, ETimeUnit* unit) THROWS(EInterruptedException) {
+		llong nanos = unit->toNanos(timeout);
+		sp<E> result;
+		lock.lockInterruptibly();
+		try {
+			while ( (result = dequeue()) == null && nanos > 0)
+				nanos = notEmpty->awaitNanos(nanos);
+		} catch (...) {
+			lock.unlock();
+			throw; //!
+		} finally {
+			lock.unlock();
+		}
+		return result;
+	}
+
+	virtual sp<E> peek() {
+		sp<E> x;
+		SYNCBLOCK(&lock) {
+			x = (size_ == 0) ? null : queue[0];
+		}}
+		return x;
+	}
+
+	/**
+	 * Returns the comparator used to order the elements in this queue,
+	 * or {@code null} if this queue uses the {@linkplain Comparable
+	 * natural ordering} of its elements.
+	 *
+	 * @return the comparator used to order the elements in this queue,
+	 *         or {@code null} if this queue uses the natural
+	 *         ordering of its elements
+	 */
+	EComparator<E*>* comparator() {
+		return cmp;
+	}
+
+	virtual int size() {
+		int n;
+		SYNCBLOCK(&lock) {
+			n = size_;
+		}}
+		return n;
+	}
+
+	/**
+	 * Always returns {@code Integer.MAX_VALUE} because
+	 * a {@code PriorityBlockingQueue} is not capacity constrained.
+	 * @return {@code Integer.MAX_VALUE} always
+	 */
+	virtual int remainingCapacity() {
+		return EInteger::MAX_VALUE;
+	}
+
+	/**
+	 * Removes a single instance of the specified element from this queue,
+	 * if it is present.  More formally, removes an element {@code e} such
+	 * that {@code o.equals(e)}, if this queue contains one or more such
+	 * elements.  Returns {@code true} if and only if this queue contained
+	 * the specified element (or equivalently, if this queue changed as a
+	 * result of the call).
+	 *
+	 * @param o element to be removed from this queue, if present
+	 * @return {@code true} if this queue changed as a result of the call
+	 */
+	virtual boolean remove(E* o) {
+		boolean r = false;
+		SYNCBLOCK(&lock) {
+			int i = indexOf(o);
+			if (i != -1) {
+				removeAt(i);
+				r = true;
+			}
+		}}
+		return r;
+	}
+
+	/**
+	 * Returns {@code true} if this queue contains the specified element.
+	 * More formally, returns {@code true} if and only if this queue contains
+	 * at least one element {@code e} such that {@code o.equals(e)}.
+	 *
+	 * @param o object to be checked for containment in this queue
+	 * @return {@code true} if this queue contains the specified element
+	 */
+	virtual boolean contains(E* o) {
+		boolean r;
+		SYNCBLOCK(&lock) {
+			r = indexOf(o) != -1;
+		}}
+		return r;
+	}
+
+	/**
+	 * Returns an array containing all of the elements in this queue.
+	 * The returned array elements are in no particular order.
+	 *
+	 * @return an array containing all of the elements in this queue
+	 */
+	virtual EA<sp<E> > toArray() {
+		lock.lock();
+		EA<sp<E> > a(size_);
+		try {
+			for (int i = 0; i < size_; i++)
+				a[i] = queue[i];
+		} catch (...) {
+			lock.unlock();
+			throw; //!
+		} finally {
+			lock.unlock();
+		}
+		return a;
+	}
+
+	/**
+	 * Atomically removes all of the elements from this queue.
+	 * The queue will be empty after this call returns.
+	 */
+	virtual void clear() {
+		SYNCBLOCK(&lock) {
+			for (int i = 0; i < size_; i++)
+				queue[i] = null;
+			size_ = 0;
+		}}
+	}
+
+	/**
+	 * @throws UnsupportedOperationException {@inheritDoc}
+	 * @throws ClassCastException            {@inheritDoc}
+	 * @throws NullPointerException          {@inheritDoc}
+	 * @throws IllegalArgumentException      {@inheritDoc}
+	 */
+	virtual int drainTo(EConcurrentCollection<E>* c) {
+		return drainTo(c, EInteger::MAX_VALUE);
+	}
+	virtual int drainTo(ECollection<sp<E> >* c) {
+		return drainTo(c, EInteger::MAX_VALUE);
+	}
+
+	/**
+	 * @throws UnsupportedOperationException {@inheritDoc}
+	 * @throws ClassCastException            {@inheritDoc}
+	 * @throws NullPointerException          {@inheritDoc}
+	 * @throws IllegalArgumentException      {@inheritDoc}
+	 */
+	virtual int drainTo(EConcurrentCollection<E>* c, int maxElements) {
+		if (c == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		if (c == dynamic_cast<EConcurrentCollection<E>*>(this))
+			throw EIllegalArgumentException(__FILE__, __LINE__);
+		return drainTo0(c, maxElements);
+	}
+	virtual int drainTo(ECollection<sp<E> >* c, int maxElements) {
+		if (c == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		return drainTo0(c, maxElements);
+	}
+
+	virtual sp<E> remove() {
+		return EAbstractConcurrentQueue<E>::remove();
+	}
+
+	virtual sp<E> element() {
+		return EAbstractConcurrentQueue<E>::element();
+	}
+
+	virtual boolean isEmpty() {
+		return size() == 0;
+	}
+
+	/**
+	 * Returns an iterator over the elements in this queue. The
+	 * iterator does not return the elements in any particular order.
+	 *
+	 * <p>The returned iterator is a "weakly consistent" iterator over
+	 * a snapshot of the queue taken when it was created.
+	 *
+	 * @return an iterator over the elements in this queue
+	 */
+	virtual sp<EConcurrentIterator<E> > iterator() {
+		return new Itr(this);
+	}
+
+private:
+	/**
+	 * Default array capacity.
+	 */
+	static const int DEFAULT_INITIAL_CAPACITY = 11;
+
+	/**
+	 * The maximum size of array to allocate.
+	 */
+	static const int MAX_ARRAY_SIZE = EInteger::MAX_VALUE - 8;
+
+	/**
+	 * Priority queue represented as a balanced binary heap: the two
+	 * children of queue[n] are queue[2*n+1] and queue[2*(n+1)].  The
+	 * priority queue is ordered by comparator, or by the elements'
+	 * natural ordering, if comparator is null: For each node n in the
+	 * heap and each descendant d of n, n <= d.  The element with the
+	 * lowest value is in queue[0], assuming the queue is nonempty.
+	 */
+	sp<E>* queue;
+	int capacity_;
+
+	/**
+	 * The number of elements in the priority queue.
+	 */
+	int size_;
+
+	/**
+	 * The comparator, or null if priority queue uses elements'
+	 * natural ordering.
+	 */
+	EComparator<E*>* cmp;
+
+	/**
+	 * Lock used for all public operations
+	 */
+	EReentrantLock lock;
+
+	/**
+	 * Condition for blocking when empty
+	 */
+	ECondition* notEmpty;
+
+	/**
+	 * Spinlock for allocation, acquired via CAS.
+	 */
+	volatile int allocationSpinLock;
+
+	int compare(E* x, E* y) {
+		if (cmp != null)
+			return cmp->compare(x, y);
+		EComparable<E*>* cc = dynamic_cast<EComparable<E*>*>(x);
+		if (!cc) throw EClassCastException(__FILE__, __LINE__);
+		return cc->compareTo(y);
+	}
+
+	/**
+	 * Tries to grow array to accommodate at least one more element
+	 * (but normally expand by about 50%), giving up (allowing retry)
+	 * on contention (which we expect to be rare). Call only while
+	 * holding lock.
+	 */
+	void tryGrow() {
+		lock.unlock(); // must release and then re-acquire main lock
+		sp<E>* newArray = null;
+		int newCap = 0;
+		int oldCap = capacity_;
+		if (allocationSpinLock == 0 &&
+			EUnsafe::compareAndSwapInt(&allocationSpinLock, 0, 1)) {
+			try {
+				newCap = oldCap + ((oldCap < 64) ?
+									   (oldCap + 2) : // grow faster if small
+									   (oldCap >> 1));
+				if (newCap - MAX_ARRAY_SIZE > 0 || newCap < 0) {    // possible overflow
+					int minCap = oldCap + 1;
+					if (minCap < 0 || minCap > MAX_ARRAY_SIZE)
+						throw EOutOfMemoryError(__FILE__, __LINE__);
+					newCap = MAX_ARRAY_SIZE;
+				}
+				if (newCap > oldCap && capacity_ == oldCap)
+					newArray = new sp<E>[newCap];
+			} catch (...) {
+				allocationSpinLock = 0;
+				lock.lock();
+				throw; //!
+			}
+			allocationSpinLock = 0;
+		}
+		if (newArray == null) // back off if another thread is allocating
+			EThread::yield();
+		lock.lock();
+		if (newArray != null && capacity_ == oldCap) {
+			for (int i = 0; i < size_; i++)
+				newArray[i] = queue[i];
+			delete[] queue;
+			queue = newArray;
+			capacity_ = newCap;
+		} else {
+			delete[] newArray;
+		}
+	}
+
+	/**
+	 * Mechanics for poll().  Call only while holding lock.
+	 */
+	sp<E> dequeue() {
+		int n = size_ - 1;
+		if (n < 0)
+			return null;
+		else {
+			sp<E> result = queue[0];
+			sp<E> x = queue[n];
+			queue[n] = null;
+			if (n > 0)
+				siftDown(0, x, n);
+			else
+				queue[0] = null;
+			size_ = n;
+			return result;
+		}
+	}
+
+	/**
+	 * Inserts item x at position k, maintaining heap invariant by
+	 * promoting x up the tree until it is greater than or equal to
+	 * its parent, or is the root.
+	 *
+	 * @param k the position to fill
+	 * @param x the item to insert
+	 */
+	void siftUp(int k, sp<E>& x) {
+		while (k > 0) {
+			int parent = (uint)(k - 1) >> 1;
+			if (compare(x.get(), queue[parent].get()) >= 0)
+				break;
+			queue[k] = queue[parent];
+			k = parent;
+		}
+		queue[k] = x;
+	}
+
+	/**
+	 * Inserts item x at position k, maintaining heap invariant by
+	 * demoting x down the tree repeatedly until it is less than or
+	 * equal to its children or is a leaf.
+	 *
+	 * @param k the position to fill
+	 * @param x the item to insert
+	 * @param n heap size
+	 */
+	void siftDown(int k, sp<E>& x, int n) {
+		int half = (uint)n >> 1;
+		while (k < half) {
+			int child = (k << 1) + 1;
+			int right = child + 1;
+			if (right < n &&
+				compare(queue[child].get(), queue[right].get()) > 0)
+				child = right;
+			if (compare(x.get(), queue[child].get()) <= 0)
+				break;
+			queue[k] = queue[child];
+			k = child;
+		}
+		queue[k] = x;
+	}
+
+	int indexOf(E* o) {
+		if (o != null) {
+			for (int i = 0; i < size_; i++)
+				if (o->equals(queue[i].get()))
+					return i;
+		}
+		return -1;
+	}
+
+	/**
+	 * Removes the ith element from queue.  Call only while holding lock.
+	 */
+	void removeAt(int i) {
+		int s = size_ - 1;
+		if (s == i) // removed last element
+			queue[i] = null;
+		else {
+			sp<E> moved = queue[s];
+			queue[s] = null;
+			siftDown(i, moved, s);
+			if (queue[i] == moved) {
+				siftUp(i, moved);
+			}
+		}
+		size_ = s;
+	}
+
+	/**
+	 * Identity-based version for use in Itr.remove
+	 */
+	void removeEQ(E* o) {
+		SYNCBLOCK(&lock) {
+			for (int i = 0; i < size_; i++) {
+				if (o == queue[i].get()) {
+					removeAt(i);
+					break;
+				}
+			}
+		}}
+	}
+
+	template<typename C>
+	int drainTo0(C* c, int maxElements) {
+		if (maxElements <= 0)
+			return 0;
+		int n = 0;
+		SYNCBLOCK(&lock) {
+			n = ES_MIN(size_, maxElements);
+			for (int i = 0; i < n; i++) {
+				c->add(queue[0]); // In this order, in case add() throws.
+				dequeue();
+			}
+		}}
+		return n;
+	}
+
+	/**
+	 * Snapshot iterator that works off copy of underlying q array.
+	 */
+	class Itr : public EConcurrentIterator<E> {
+	private:
+		EPriorityBlockingQueue<E>* self;
+		EA<sp<E> > array; // Array of all elements
+		int cursor;       // index of next element to return
+		sp<E> lastRet;
+
+	public:
+		Itr(EPriorityBlockingQueue<E>* s) : self(s), array(s->toArray()), cursor(0) {
+		}
+
+		boolean hasNext() {
+			return cursor < array.length();
+		}
+
+		sp<E> next() {
+			if (cursor >= array.length())
+				throw ENoSuchElementException(__FILE__, __LINE__);
+			lastRet = array[cursor++];
+			return lastRet;
+		}
+
+		void remove() {
+			if (lastRet == null)
+				throw EIllegalStateException(__FILE__, __LINE__);
+			self->removeEQ(lastRet.get());
+			lastRet = null;
+		}
+	};
+
+	// unsupported.
+	EPriorityBlockingQueue(const EPriorityBlockingQueue&);
+	EPriorityBlockingQueue& operator=(const EPriorityBlockingQueue&);
+};
+
+} /* namespace efc */
+#endif /* EPRIORITYBLOCKINGQUEUE_HH_ */
@@ -0,0 +1,84 @@
+/*
+ * ERecursiveAction.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ERECURSIVEACTION_HH_
+#define ERECURSIVEACTION_HH_
+
+#include "./EForkJoinTask.hh"
+
+namespace efc {
+
+//@see: openjdk-8/src/share/classes/java/util/concurrent/RecursiveAction.java
+
+/**
+ * A recursive resultless {@link EForkJoinTask}.  This class
+ * establishes conventions to parameterize resultless actions as
+ * {@code EObject}s, whose results are always {@code null}.
+ *
+ * <p><b>Sample Usages.</b> Here is a simple but complete ForkJoin
+ * sort that sorts a given {@code llong[]} array:
+ *
+ *  <pre> {@code
+ * class SortTask : public ERecursiveAction {
+ *   llong* array; int lo, hi;
+ * public:
+ *   SortTask(llong* array, int lo, int hi) {
+ *     this->array = array; this->lo = lo; this->hi = hi;
+ *   }
+ * protected:
+ *   void compute() {
+ *     if (hi - lo < THRESHOLD)
+ *       sortSequentially(lo, hi);
+ *     else {
+ *       int mid = (lo + hi) >> 1;
+ *       invokeAll(new SortTask(array, lo, mid),
+ *                 new SortTask(array, mid, hi));
+ *       merge(lo, mid, hi);
+ *     }
+ *   }
+ * }}</pre>
+ *
+ * @since 1.7
+ */
+
+abstract class ERecursiveAction : public EForkJoinTask<EObject> {
+public:
+	virtual ~ERecursiveAction() {
+	}
+
+	/**
+	 * Always returns {@code null}.
+	 *
+	 * @return {@code null} always
+	 */
+	virtual sp<EObject> getRawResult() {
+		return null;
+	}
+
+protected:
+	/**
+	 * The main computation performed by this task.
+	 */
+	virtual void compute() = 0;
+
+	/**
+	 * Requires null completion value.
+	 */
+	virtual void setRawResult(sp<EObject> mustBeNull) {
+	}
+
+	/**
+	 * Implements execution conventions for RecursiveActions.
+	 */
+	virtual boolean exec() {
+		compute();
+		return true;
+	}
+};
+
+} /* namespace efc */
+#endif /* ERECURSIVEACTION_HH_ */
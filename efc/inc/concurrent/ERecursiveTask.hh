@@ -0,0 +1,85 @@
+/*
+ * ERecursiveTask.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ERECURSIVETASK_HH_
+#define ERECURSIVETASK_HH_
+
+#include "./EForkJoinTask.hh"
+
+namespace efc {
+
+//@see: openjdk-8/src/share/classes/java/util/concurrent/RecursiveTask.java
+
+/**
+ * A recursive result-bearing {@link EForkJoinTask}.
+ *
+ * <p>For a classic example, here is a task computing Fibonacci numbers:
+ *
+ *  <pre> {@code
+ * class Fibonacci : public ERecursiveTask<EInteger> {
+ *   int n;
+ * public:
+ *   Fibonacci(int n) { this->n = n; }
+ * protected:
+ *   sp<EInteger> compute() {
+ *     if (n <= 1)
+ *       return new EInteger(n);
+ *     sp<Fibonacci> f1 = new Fibonacci(n - 1);
+ *     f1->fork();
+ *     sp<Fibonacci> f2 = new Fibonacci(n - 2);
+ *     return new EInteger(f2->compute()->intValue() + f1->join()->intValue());
+ *   }
+ * }}</pre>
+ *
+ * However, besides being a dumb way to compute Fibonacci functions
+ * (there is a simple fast linear algorithm that you'd use in
+ * practice), this is likely to perform poorly because the smallest
+ * subtasks are too small to be worthwhile splitting up. Instead, as
+ * is the case for nearly all fork/join applications, you'd pick some
+ * minimum granularity size (for example 10 here) for which you always
+ * sequentially solve rather than subdividing.
+ *
+ * @since 1.7
+ */
+
+template<typename V>
+abstract class ERecursiveTask : public EForkJoinTask<V> {
+public:
+	virtual ~ERecursiveTask() {
+	}
+
+	virtual sp<V> getRawResult() {
+		return result;
+	}
+
+protected:
+	/**
+	 * The result of the computation.
+	 */
+	sp<V> result;
+
+	/**
+	 * The main computation performed by this task.
+	 * @return the result of the computation
+	 */
+	virtual sp<V> compute() = 0;
+
+	virtual void setRawResult(sp<V> value) {
+		result = value;
+	}
+
+	/**
+	 * Implements execution conventions for RecursiveTask.
+	 */
+	virtual boolean exec() {
+		result = compute();
+		return true;
+	}
+};
+
+} /* namespace efc */
+#endif /* ERECURSIVETASK_HH_ */
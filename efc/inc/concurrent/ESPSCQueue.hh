@@ -0,0 +1,290 @@
+/*
+ * ESPSCQueue.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ESPSCQUEUE_HH_
+#define ESPSCQUEUE_HH_
+
+#include "../EA.hh"
+#include "../EInteger.hh"
+#include "../ECollection.hh"
+#include "./EOrderAccess.hh"
+#include "./EConcurrentQueue.hh"
+#include "../ENoSuchElementException.hh"
+#include "../ENullPointerException.hh"
+#include "../EIllegalStateException.hh"
+#include "../EIndexOutOfBoundsException.hh"
+#include "../EIllegalArgumentException.hh"
+#include "../EUnsupportedOperationException.hh"
+
+namespace efc {
+
+/**
+ * A bounded wait-free {@linkplain EConcurrentQueue queue} for exactly one
+ * producer thread and one consumer thread, backed by a ring buffer.
+ * This queue orders elements FIFO (first-in-first-out) and does not
+ * permit <tt>null</tt> elements.
+ *
+ * <p>The producer owns <tt>tail</tt> and the consumer owns <tt>head</tt>;
+ * each lives on its own cache line next to a private cached copy of
+ * the other side's index, so the other side's line is only read when the
+ * cached value says the ring looks full (or empty).  Indexes are
+ * published with plain release stores: no atomic read-modify-write
+ * instruction is executed by {@link #offer}, {@link #poll},
+ * {@link #offerAll} or {@link #drainTo}.  The batch methods move many
+ * elements and publish the index once.
+ *
+ * <p>{@link #offer} and {@link #offerAll} must only be called from the
+ * producer thread; {@link #poll}, {@link #peek}, {@link #drainTo} and
+ * {@link #clear} only from the consumer thread.  {@link #size} and
+ * {@link #isEmpty} may be called from any thread and are estimates.
+ * The capacity is rounded up to a power of two.
+ */
+
+template<typename E>
+class ESPSCQueue: public EConcurrentQueue<E> {
+public:
+	~ESPSCQueue() {
+		delete[] buffer;
+	}
+
+	/**
+	 * Creates an <tt>ESPSCQueue</tt> able to hold at least
+	 * <tt>capacity</tt> elements.
+	 *
+	 * @throws IllegalArgumentException if <tt>capacity < 1</tt> or too large
+	 */
+	ESPSCQueue(int capacity) {
+		if (capacity <= 0 || capacity > (1 << 30))
+			throw EIllegalArgumentException(__FILE__, __LINE__);
+		int n = 2;
+		while (n < capacity)
+			n <<= 1;
+		capacity_ = n;
+		mask = n - 1;
+		buffer = new sp<E>[n];
+		tail = head = 0;
+		headCache = tailCache = 0;
+	}
+
+	boolean add(E* e) {
+		sp<E> x(e);
+		return add(x);
+	}
+	boolean add(sp<E> e) {
+		if (offer(e))
+			return true;
+		else
+			throw EIllegalStateException(__FILE__, __LINE__, "Queue full");
+	}
+
+	/**
+	 * Inserts the specified element at the tail of this queue if the
+	 * ring is not full.  Producer thread only.
+	 *
+	 * @return <tt>true</tt> if the element was added, else <tt>false</tt>
+	 * @throws NullPointerException if the specified element is null
+	 */
+	boolean offer(E* e) {
+		sp<E> x(e);
+		boolean r = offer(x);
+		if (!r) {
+			x.dismiss();
+		}
+		return r;
+	}
+	boolean offer(sp<E> e) {
+		if (e == null) throw ENullPointerException(__FILE__, __LINE__);
+		llong t = tail;
+		if (t - headCache >= capacity_) {
+			headCache = EOrderAccess::load_acquire(&head);
+			if (t - headCache >= capacity_)
+				return false;
+		}
+		buffer[t & mask].swap(e);
+		EOrderAccess::release_store(&tail, t + 1);
+		return true;
+	}
+
+	/**
+	 * Moves as many elements of <tt>a[offset, offset + length)</tt> as
+	 * fit into this queue and publishes them at once.  Moved slots of
+	 * <tt>a</tt> are left null.  Producer thread only.
+	 *
+	 * @return the number of elements moved
+	 * @throws NullPointerException if a moved element is null
+	 */
+	int offerAll(EA<sp<E> >* a, int offset=0, int length=-1) {
+		if (a == null) throw ENullPointerException(__FILE__, __LINE__);
+		if (length < 0)
+			length = a->length() - offset;
+		if (offset < 0 || offset + length > a->length())
+			throw EIndexOutOfBoundsException(__FILE__, __LINE__);
+		llong t = tail;
+		llong free = capacity_ - (t - headCache);
+		if (free < length) {
+			headCache = EOrderAccess::load_acquire(&head);
+			free = capacity_ - (t - headCache);
+		}
+		int n = (int)ES_MIN(free, (llong)length);
+		sp<E>* src = a->address() + offset;
+		int i = 0;
+		for (; i < n; i++) {
+			if (src[i] == null)
+				break;
+			buffer[(t + i) & mask].swap(src[i]);
+		}
+		if (i > 0)
+			EOrderAccess::release_store(&tail, t + i);
+		if (i < n)
+			throw ENullPointerException(__FILE__, __LINE__);
+		return n;
+	}
+
+	/**
+	 * Retrieves and removes the head of this queue, or returns
+	 * <tt>null</tt> if this queue is empty.  Consumer thread only.
+	 */
+	sp<E> poll() {
+		llong h = head;
+		if (h >= tailCache) {
+			tailCache = EOrderAccess::load_acquire(&tail);
+			if (h >= tailCache)
+				return null;
+		}
+		sp<E> x;
+		x.swap(buffer[h & mask]);
+		EOrderAccess::release_store(&head, h + 1);
+		return x;
+	}
+
+	/**
+	 * Removes at most <tt>maxElements</tt> available elements, adds them
+	 * to the given collection and frees their slots at once.
+	 * Consumer thread only.
+	 *
+	 * @return the number of elements transferred
+	 */
+	int drainTo(ECollection<sp<E> >* c, int maxElements=EInteger::MAX_VALUE) {
+		return drainTo0(c, maxElements);
+	}
+	int drainTo(EConcurrentCollection<E>* c, int maxElements=EInteger::MAX_VALUE) {
+		if (c == dynamic_cast<EConcurrentCollection<E>*>(this))
+			throw EIllegalArgumentException(__FILE__, __LINE__);
+		return drainTo0(c, maxElements);
+	}
+
+	sp<E> element() {
+		sp<E> x = peek();
+		if (x != null)
+			return x;
+		else
+			throw ENoSuchElementException(__FILE__, __LINE__);
+	}
+
+	/**
+	 * Consumer thread only.
+	 */
+	sp<E> peek() {
+		llong h = head;
+		if (h >= tailCache) {
+			tailCache = EOrderAccess::load_acquire(&tail);
+			if (h >= tailCache)
+				return null;
+		}
+		return buffer[h & mask];
+	}
+
+	sp<E> remove() {
+		sp<E> x = poll();
+		if (x != null)
+			return x;
+		else
+			throw ENoSuchElementException(__FILE__, __LINE__);
+	}
+
+	/**
+	 * Consumer thread only.
+	 */
+	void clear() {
+		while (poll() != null)
+			;
+	}
+
+	boolean isEmpty() {
+		return size() == 0;
+	}
+
+	int size() {
+		llong h = EOrderAccess::load_acquire(&head);
+		llong t = EOrderAccess::load_acquire(&tail);
+		llong n = t - h;
+		return (n < 0) ? 0 : (n > capacity_ ? capacity_ : (int)n);
+	}
+
+	int capacity() {
+		return capacity_;
+	}
+
+	boolean contains(E* o) {
+		throw EUnsupportedOperationException(__FILE__, __LINE__);
+	}
+
+	boolean remove(E* o) {
+		throw EUnsupportedOperationException(__FILE__, __LINE__);
+	}
+
+	sp<EConcurrentIterator<E> > iterator() {
+		throw EUnsupportedOperationException(__FILE__, __LINE__);
+	}
+
+	EA<sp<E> > toArray() {
+		throw EUnsupportedOperationException(__FILE__, __LINE__);
+	}
+
+private:
+	sp<E>* buffer;
+	llong mask;
+	int capacity_;
+
+	char pad0[ES_CACHE_LINE_SIZE];
+	/** Next slot to fill; written by the producer only */
+	volatile llong tail;
+	/** Producer's last seen value of head */
+	llong headCache;
+	char pad1[ES_CACHE_LINE_SIZE - 2 * sizeof(llong)];
+	/** Next slot to empty; written by the consumer only */
+	volatile llong head;
+	/** Consumer's last seen value of tail */
+	llong tailCache;
+	char pad2[ES_CACHE_LINE_SIZE - 2 * sizeof(llong)];
+
+	template<typename C>
+	int drainTo0(C* c, int maxElements) {
+		if (c == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		llong h = head;
+		tailCache = EOrderAccess::load_acquire(&tail);
+		int n = (int)ES_MIN(tailCache - h, (llong)maxElements);
+		int i = 0;
+		try {
+			for (; i < n; i++) {
+				sp<E> x;
+				x.swap(buffer[(h + i) & mask]);
+				c->add(x);
+			}
+		} catch (...) {
+			EOrderAccess::release_store(&head, h + i + 1);
+			throw; //!
+		}
+		if (n > 0)
+			EOrderAccess::release_store(&head, h + n);
+		return n;
+	}
+};
+
+} /* namespace efc */
+#endif /* ESPSCQUEUE_HH_ */
@@ -0,0 +1,156 @@
+/*
+ * EScheduledExecutorService.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ESCHEDULEDEXECUTORSERVICE_HH_
+#define ESCHEDULEDEXECUTORSERVICE_HH_
+
+#include "./EExecutor.hh"
+#include "./EScheduledFuture.hh"
+#include "../EArrayList.hh"
+#include "../EInterruptedException.hh"
+
+namespace efc {
+
+//@see: openjdk-8/src/share/classes/java/util/concurrent/ScheduledExecutorService.java
+
+/**
+ * An {@link EExecutorService} that can schedule commands to run after a given
+ * delay, or to execute periodically.
+ *
+ * <p>The {@code schedule} methods create tasks with various delays
+ * and return a task object that can be used to cancel or check
+ * execution. The {@code scheduleAtFixedRate} and
+ * {@code scheduleWithFixedDelay} methods create and execute tasks
+ * that run periodically until cancelled.
+ *
+ * <p>Commands submitted using the {@link EExecutor#execute(sp<ERunnable>)} and
+ * {@link EExecutorService} {@code submit} methods are scheduled
+ * with a requested delay of zero. Zero and negative delays (but not
+ * periods) are also allowed in {@code schedule} methods, and are
+ * treated as requests for immediate execution.
+ *
+ * <p>All {@code schedule} methods accept <em>relative</em> delays and
+ * periods as arguments, not absolute times or dates. They are measured
+ * with {@link ESystem#nanoTime()}.
+ *
+ * <p>The {@link EExecutors} class provides convenient factory methods for
+ * the ScheduledExecutorService implementations provided in this package.
+ *
+ * <p>{@link EThreadPoolExecutor} derives from {@link EExecutorService}
+ * non-virtually, so this interface extends {@link EExecutor} and
+ * repeats the lifecycle methods of {@link EExecutorService} instead;
+ * an implementation overrides both with the same functions. Callable
+ * tasks are scheduled by the template {@code schedule} method of
+ * {@link EScheduledThreadPoolExecutor}, since templates cannot be
+ * virtual.
+ *
+ * @since 1.5
+ */
+
+interface EScheduledExecutorService : virtual public EExecutor {
+	virtual ~EScheduledExecutorService(){}
+
+	/**
+	 * @see EExecutorService#shutdown()
+	 */
+	virtual void shutdown() = 0;
+
+	/**
+	 * @see EExecutorService#shutdownNow()
+	 */
+	virtual EArrayList<sp<ERunnable> > shutdownNow() = 0;
+
+	/**
+	 * @see EExecutorService#isShutdown()
+	 */
+	virtual boolean isShutdown() = 0;
+
+	/**
+	 * @see EExecutorService#isTerminated()
+	 */
+	virtual boolean isTerminated() = 0;
+
+	/**
+	 * @see EExecutorService#awaitTermination()
+	 */
+	virtual boolean awaitTermination() THROWS(EInterruptedException) = 0;
+	virtual boolean awaitTermination(llong timeout, ETimeUnit* unit)
+	                                 THROWS(EInterruptedException) = 0;
+
+	/**
+	 * Creates and executes a one-shot action that becomes enabled
+	 * after the given delay.
+	 *
+	 * @param command the task to execute
+	 * @param delay the time from now to delay execution
+	 * @param unit the time unit of the delay parameter
+	 * @return a ScheduledFuture representing pending completion of
+	 *         the task and whose {@code get()} method will return
+	 *         {@code null} upon completion
+	 * @throws ERejectedExecutionException if the task cannot be
+	 *         scheduled for execution
+	 * @throws ENullPointerException if command is null
+	 */
+	virtual sp<EScheduledFuture<EObject> > schedule(sp<ERunnable> command,
+			llong delay, ETimeUnit* unit) = 0;
+
+	/**
+	 * Creates and executes a periodic action that becomes enabled first
+	 * after the given initial delay, and subsequently with the given
+	 * period; that is executions will commence after
+	 * {@code initialDelay} then {@code initialDelay+period}, then
+	 * {@code initialDelay + 2 * period}, and so on.
+	 * If any execution of the task
+	 * encounters an exception, subsequent executions are suppressed.
+	 * Otherwise, the task will only terminate via cancellation or
+	 * termination of the executor.  If any execution of this task
+	 * takes longer than its period, then subsequent executions
+	 * may start late, but will not concurrently execute.
+	 *
+	 * @param command the task to execute
+	 * @param initialDelay the time to delay first execution
+	 * @param period the period between successive executions
+	 * @param unit the time unit of the initialDelay and period parameters
+	 * @return a ScheduledFuture representing pending completion of
+	 *         the task, and whose {@code get()} method will throw an
+	 *         exception upon cancellation
+	 * @throws ERejectedExecutionException if the task cannot be
+	 *         scheduled for execution
+	 * @throws ENullPointerException if command is null
+	 * @throws EIllegalArgumentException if period less than or equal to zero
+	 */
+	virtual sp<EScheduledFuture<EObject> > scheduleAtFixedRate(sp<ERunnable> command,
+			llong initialDelay, llong period, ETimeUnit* unit) = 0;
+
+	/**
+	 * Creates and executes a periodic action that becomes enabled first
+	 * after the given initial delay, and subsequently with the
+	 * given delay between the termination of one execution and the
+	 * commencement of the next.  If any execution of the task
+	 * encounters an exception, subsequent executions are suppressed.
+	 * Otherwise, the task will only terminate via cancellation or
+	 * termination of the executor.
+	 *
+	 * @param command the task to execute
+	 * @param initialDelay the time to delay first execution
+	 * @param delay the delay between the termination of one
+	 * execution and the commencement of the next
+	 * @param unit the time unit of the initialDelay and delay parameters
+	 * @return a ScheduledFuture representing pending completion of
+	 *         the task, and whose {@code get()} method will throw an
+	 *         exception upon cancellation
+	 * @throws ERejectedExecutionException if the task cannot be
+	 *         scheduled for execution
+	 * @throws ENullPointerException if command is null
+	 * @throws EIllegalArgumentException if delay less than or equal to zero
+	 */
+	virtual sp<EScheduledFuture<EObject> > scheduleWithFixedDelay(sp<ERunnable> command,
+			llong initialDelay, llong delay, ETimeUnit* unit) = 0;
+};
+
+} /* namespace efc */
+#endif /* ESCHEDULEDEXECUTORSERVICE_HH_ */
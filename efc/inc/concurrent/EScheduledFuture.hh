@@ -0,0 +1,33 @@
+/*
+ * EScheduledFuture.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ESCHEDULEDFUTURE_HH_
+#define ESCHEDULEDFUTURE_HH_
+
+#include "./EDelayed.hh"
+#include "./EFuture.hh"
+
+namespace efc {
+
+//@see: openjdk-8/src/share/classes/java/util/concurrent/ScheduledFuture.java
+
+/**
+ * A delayed result-bearing action that can be cancelled.
+ * Usually a scheduled future is the result of scheduling
+ * a task with a {@link EScheduledExecutorService}.
+ *
+ * @since 1.5
+ * @param <V> The result type returned by this Future
+ */
+
+template<typename V>
+interface EScheduledFuture : virtual public EDelayed, virtual public EFuture<V> {
+	virtual ~EScheduledFuture(){}
+};
+
+} /* namespace efc */
+#endif /* ESCHEDULEDFUTURE_HH_ */
@@ -0,0 +1,629 @@
+/*
+ * EScheduledThreadPoolExecutor.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ESCHEDULEDTHREADPOOLEXECUTOR_HH_
+#define ESCHEDULEDTHREADPOOLEXECUTOR_HH_
+
+#include "./EThreadPoolExecutor.hh"
+#include "./EScheduledExecutorService.hh"
+#include "./ELinkedBlockingQueue.hh"
+#include "./EFutureTask.hh"
+#include "../ESimpleLock.hh"
+#include "../ECondition.hh"
+#include "../ESystem.hh"
+
+namespace efc {
+
+//@see: openjdk-8/src/share/classes/java/util/concurrent/ScheduledThreadPoolExecutor.java
+
+class EScheduledThreadPoolExecutor;
+
+namespace stpe {
+
+/**
+ * A task as linked into the timing wheel: the deadline, the links
+ * of its bucket, and the wheel's reference to the task while linked.
+ */
+class TimerEntry {
+public:
+	virtual ~TimerEntry() {
+	}
+
+	/**
+	 * Returns {@code true} if this is a periodic (not a one-shot) action.
+	 */
+	virtual boolean isPeriodic() = 0;
+
+	/**
+	 * Cancels the task, as by {@link EFuture#cancel}.
+	 */
+	virtual boolean cancel(boolean mayInterruptIfRunning) = 0;
+
+protected:
+	friend class TimingWheel;
+	friend class efc::EScheduledThreadPoolExecutor;
+
+	TimerEntry(llong deadline) :
+			deadline(deadline), expireTick(0), next(null), prev(null),
+			slot(null) {
+	}
+
+	/** The time the task is enabled to execute in nanoTime units */
+	llong deadline;
+
+private:
+	llong expireTick;       // deadline in wheel ticks, rounded up
+	TimerEntry* next;       // bucket links, guarded by the wheel lock
+	TimerEntry* prev;
+	TimerEntry** slot;      // head of the bucket, null when not linked
+	sp<ERunnable> self;     // the task, held by the wheel while linked
+	wp<ERunnable> owner;    // the task, to re-add a periodic one
+};
+
+/**
+ * A hierarchical timing wheel (Varghese & Lauck, scheme 7, in the form
+ * used by the Linux kernel timers): LEVELS wheels of WHEEL_SIZE
+ * buckets, each level spanning WHEEL_SIZE times the one below. A
+ * bucket is an intrusive doubly linked list, so adding and cancelling
+ * a timeout are O(1) regardless of how many are pending; cancelled
+ * entries are unlinked at once instead of waiting for their deadline.
+ *
+ * <p>A single ticker thread advances the wheel one tick at a time.
+ * Entries of level 0 whose tick has come are moved to the
+ * {@code expired} queue, where the pool's workers pick them up, so a
+ * slow task never delays the expiry of others. Whenever the lower
+ * levels wrap around, the next bucket of the level above is
+ * redistributed ("cascaded") into the levels below. The ticker sleeps
+ * while the wheel is empty.
+ *
+ * <p>With the default tick of one millisecond, the six levels span
+ * 2^36 ms (about two years); later deadlines are parked in the last
+ * bucket and re-inserted when they get there.
+ */
+class TimingWheel {
+public:
+	~TimingWheel();
+
+	/**
+	 * @param expired the queue receiving entries whose deadline has passed
+	 * @param tickNanos the resolution of the wheel
+	 */
+	TimingWheel(EBlockingQueue<ERunnable>* expired, llong tickNanos);
+
+	/**
+	 * Links the given entry, the wheel keeping task (the entry itself)
+	 * alive until it expires or is removed.
+	 */
+	void add(TimerEntry* e, sp<ERunnable> task);
+
+	/**
+	 * Unlinks the given entry if it is still waiting.
+	 *
+	 * @return {@code true} if the entry was removed
+	 */
+	boolean remove(TimerEntry* e);
+
+	/**
+	 * Removes all waiting periodic (or all waiting one-shot) entries,
+	 * adding their tasks to the given list.
+	 */
+	void removeAll(boolean periodic, EArrayList<sp<ERunnable> >* removed);
+
+	/**
+	 * Removes up to maxElements waiting entries, adding their tasks to c.
+	 */
+	int drainTo(ECollection<sp<ERunnable> >* c, int maxElements);
+
+	/**
+	 * Returns the number of waiting entries.
+	 */
+	int size();
+
+	/**
+	 * Stops the ticker thread (waiting for it to exit).
+	 */
+	void stop();
+
+private:
+	friend class Ticker;
+
+	static const int WHEEL_BITS = 6;
+	static const int WHEEL_SIZE = 1 << WHEEL_BITS;
+	static const int WHEEL_MASK = WHEEL_SIZE - 1;
+	static const int LEVELS = 6;
+
+	ESimpleLock lock;
+	ECondition* ticked;
+	TimerEntry* wheel[LEVELS][WHEEL_SIZE];
+	EBlockingQueue<ERunnable>* expired;
+	EThread* ticker;        // started with the first entry
+	llong startTime;
+	llong tickNanos;
+	llong currentTick;      // the next tick to process
+	int count;
+	boolean stopped;
+
+	void run();
+	void place(TimerEntry* e);
+	void unlink(TimerEntry* e);
+	TimerEntry* advance();
+};
+
+/**
+ * The work queue of EScheduledThreadPoolExecutor: tasks that are
+ * enabled wait here for a worker as in an ordinary thread pool,
+ * while delayed tasks wait in the timing wheel. Both count as
+ * queued, so the pool does not terminate while delayed tasks are
+ * pending, and draining the queue drains the wheel too.
+ */
+class DelayedWorkQueue : public ELinkedBlockingQueue<ERunnable> {
+public:
+	DelayedWorkQueue(llong tickNanos) :
+			wheel(this, tickNanos) {
+	}
+
+	virtual int size() {
+		return ELinkedBlockingQueue<ERunnable>::size() + wheel.size();
+	}
+
+	virtual boolean isEmpty() {
+		return size() == 0;
+	}
+
+	virtual boolean remove(ERunnable* o) {
+		TimerEntry* e = dynamic_cast<TimerEntry*>(o);
+		if (e != null && wheel.remove(e))
+			return true;
+		return ELinkedBlockingQueue<ERunnable>::remove(o);
+	}
+
+	virtual int drainTo(ECollection<sp<ERunnable> >* c, int maxElements) {
+		int n = ELinkedBlockingQueue<ERunnable>::drainTo(c, maxElements);
+		if (n < maxElements)
+			n += wheel.drainTo(c, maxElements - n);
+		return n;
+	}
+
+	virtual int drainTo(EConcurrentCollection<ERunnable>* c, int maxElements) {
+		int n = ELinkedBlockingQueue<ERunnable>::drainTo(c, maxElements);
+		if (n < maxElements) {
+			EArrayList<sp<ERunnable> > tasks;
+			wheel.drainTo(&tasks, maxElements - n);
+			for (int i = 0; i < tasks.size(); i++) {
+				c->add(tasks.getAt(i));
+			}
+			n += tasks.size();
+		}
+		return n;
+	}
+
+	TimingWheel wheel;
+};
+
+} /* namespace stpe */
+
+/**
+ * A {@link EThreadPoolExecutor} that can additionally schedule
+ * commands to run after a given delay, or to execute periodically.
+ * This class is preferable to {@link ETimer} when multiple worker
+ * threads are needed, or when the additional flexibility or
+ * capabilities of {@link EThreadPoolExecutor} (which this class
+ * extends) are required.
+ *
+ * <p>Delayed tasks execute no sooner than they are enabled, but
+ * without any real-time guarantees about when, after they are
+ * enabled, they will commence. Tasks scheduled for exactly the same
+ * execution time are enabled in no particular order.
+ *
+ * <p>Delayed tasks are kept in a hierarchical timing wheel with a
+ * resolution of one millisecond by default, so that scheduling and
+ * cancelling a task take constant time however many are pending,
+ * and a cancelled task is removed from the wheel immediately. This
+ * suits large numbers of timeouts that are mostly cancelled, such as
+ * per-connection idle timeouts. A single ticker thread moves enabled
+ * tasks to the pool's workers; it never runs tasks itself.
+ *
+ * <p>Successive executions of a periodic task scheduled via
+ * {@link #scheduleAtFixedRate} or
+ * {@link #scheduleWithFixedDelay} do not overlap.
+ *
+ * <p>While this class inherits from {@link EThreadPoolExecutor}, a few
+ * of the inherited tuning methods are not useful for it. In
+ * particular, because it acts as a fixed-sized pool using
+ * {@code corePoolSize} threads and an unbounded queue, adjustments
+ * to {@code maximumPoolSize} have no useful effect. Commands passed
+ * to {@link #execute} run immediately, as in the superclass.
+ *
+ * @since 1.5
+ */
+
+class EScheduledThreadPoolExecutor : public EThreadPoolExecutor,
+		virtual public EScheduledExecutorService {
+public:
+	virtual ~EScheduledThreadPoolExecutor();
+
+	/**
+	 * Creates a new {@code ScheduledThreadPoolExecutor} with the
+	 * given core pool size.
+	 *
+	 * @param corePoolSize the number of threads to keep in the pool, even
+	 *        if they are idle, unless {@code allowCoreThreadTimeOut} is set
+	 * @throws EIllegalArgumentException if {@code corePoolSize < 0}
+	 */
+	EScheduledThreadPoolExecutor(int corePoolSize);
+
+	/**
+	 * Creates a new {@code ScheduledThreadPoolExecutor} with the
+	 * given initial parameters.
+	 *
+	 * @param corePoolSize the number of threads to keep in the pool, even
+	 *        if they are idle, unless {@code allowCoreThreadTimeOut} is set
+	 * @param threadFactory the factory to use when the executor
+	 *        creates a new thread
+	 * @throws EIllegalArgumentException if {@code corePoolSize < 0}
+	 * @throws ENullPointerException if {@code threadFactory} is null
+	 */
+	EScheduledThreadPoolExecutor(int corePoolSize,
+			sp<EThreadFactory> threadFactory);
+
+	/**
+	 * Creates a new ScheduledThreadPoolExecutor with the given
+	 * initial parameters.
+	 *
+	 * @param corePoolSize the number of threads to keep in the pool, even
+	 *        if they are idle, unless {@code allowCoreThreadTimeOut} is set
+	 * @param handler the handler to use when execution is blocked
+	 *        because the thread bounds and queue capacities are reached
+	 * @throws EIllegalArgumentException if {@code corePoolSize < 0}
+	 * @throws ENullPointerException if {@code handler} is null
+	 */
+	EScheduledThreadPoolExecutor(int corePoolSize,
+			sp<ERejectedExecutionHandler> handler);
+
+	/**
+	 * Creates a new ScheduledThreadPoolExecutor with the given
+	 * initial parameters.
+	 *
+	 * @param corePoolSize the number of threads to keep in the pool, even
+	 *        if they are idle, unless {@code allowCoreThreadTimeOut} is set
+	 * @param threadFactory the factory to use when the executor
+	 *        creates a new thread
+	 * @param handler the handler to use when execution is blocked
+	 *        because the thread bounds and queue capacities are reached
+	 * @param tickNanos the resolution of the timing wheel, in nanoseconds
+	 * @throws EIllegalArgumentException if {@code corePoolSize < 0}
+	 *         or {@code tickNanos <= 0}
+	 * @throws ENullPointerException if {@code threadFactory} or
+	 *         {@code handler} is null
+	 */
+	EScheduledThreadPoolExecutor(int corePoolSize,
+			sp<EThreadFactory> threadFactory,
+			sp<ERejectedExecutionHandler> handler,
+			llong tickNanos = DEFAULT_TICK_NANOS);
+
+	/**
+	 * @throws ERejectedExecutionException {@inheritDoc}
+	 * @throws ENullPointerException       {@inheritDoc}
+	 */
+	virtual sp<EScheduledFuture<EObject> > schedule(sp<ERunnable> command,
+			llong delay, ETimeUnit* unit);
+
+	/**
+	 * Creates and executes a ScheduledFuture that becomes enabled after
+	 * the given delay.
+	 *
+	 * @param callable the function to execute
+	 * @param delay the time from now to delay execution
+	 * @param unit the time unit of the delay parameter
+	 * @return a ScheduledFuture that can be used to extract result or cancel
+	 * @throws ERejectedExecutionException if the task cannot be
+	 *         scheduled for execution
+	 * @throws ENullPointerException if callable is null
+	 */
+	template<typename V>
+	sp<EScheduledFuture<V> > schedule(sp<ECallable<V> > callable,
+			llong delay, ETimeUnit* unit) {
+		if (callable == null || unit == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		sp<ScheduledFutureTask<V> > t = new ScheduledFutureTask<V>(callable,
+				triggerTime(delay, unit), this);
+		delayedExecute(t, t.get());
+		return t;
+	}
+
+	/**
+	 * @throws ERejectedExecutionException {@inheritDoc}
+	 * @throws ENullPointerException       {@inheritDoc}
+	 * @throws EIllegalArgumentException   {@inheritDoc}
+	 */
+	virtual sp<EScheduledFuture<EObject> > scheduleAtFixedRate(sp<ERunnable> command,
+			llong initialDelay, llong period, ETimeUnit* unit);
+
+	/**
+	 * @throws ERejectedExecutionException {@inheritDoc}
+	 * @throws ENullPointerException       {@inheritDoc}
+	 * @throws EIllegalArgumentException   {@inheritDoc}
+	 */
+	virtual sp<EScheduledFuture<EObject> > scheduleWithFixedDelay(sp<ERunnable> command,
+			llong initialDelay, llong delay, ETimeUnit* unit);
+
+	/**
+	 * Sets the policy on whether to continue executing existing
+	 * periodic tasks even when this executor has been {@code shutdown}.
+	 * In this case, these tasks will only terminate upon
+	 * {@code shutdownNow} or after setting the policy to
+	 * {@code false} when already shutdown.
+	 * This value is by default {@code false}.
+	 *
+	 * @param value if {@code true}, continue after shutdown, else don't
+	 * @see #getContinueExistingPeriodicTasksAfterShutdownPolicy
+	 */
+	void setContinueExistingPeriodicTasksAfterShutdownPolicy(boolean value);
+
+	/**
+	 * Gets the policy on whether to continue executing existing
+	 * periodic tasks even when this executor has been {@code shutdown}.
+	 * This value is by default {@code false}.
+	 *
+	 * @return {@code true} if will continue after shutdown
+	 * @see #setContinueExistingPeriodicTasksAfterShutdownPolicy
+	 */
+	boolean getContinueExistingPeriodicTasksAfterShutdownPolicy();
+
+	/**
+	 * Sets the policy on whether to execute existing delayed
+	 * tasks even when this executor has been {@code shutdown}.
+	 * In this case, these tasks will only terminate upon
+	 * {@code shutdownNow}, or after setting the policy to
+	 * {@code false} when already shutdown.
+	 * This value is by default {@code true}.
+	 *
+	 * @param value if {@code true}, execute after shutdown, else don't
+	 * @see #getExecuteExistingDelayedTasksAfterShutdownPolicy
+	 */
+	void setExecuteExistingDelayedTasksAfterShutdownPolicy(boolean value);
+
+	/**
+	 * Gets the policy on whether to execute existing delayed
+	 * tasks even when this executor has been {@code shutdown}.
+	 * This value is by default {@code true}.
+	 *
+	 * @return {@code true} if will execute after shutdown
+	 * @see #setExecuteExistingDelayedTasksAfterShutdownPolicy
+	 */
+	boolean getExecuteExistingDelayedTasksAfterShutdownPolicy();
+
+	/**
+	 * Initiates an orderly shutdown in which previously submitted
+	 * tasks are executed, but no new tasks will be accepted.
+	 *
+	 * <p>If the {@code ExecuteExistingDelayedTasksAfterShutdownPolicy}
+	 * has been set {@code false}, existing delayed tasks whose delays
+	 * have not yet elapsed are cancelled.  And unless the {@code
+	 * ContinueExistingPeriodicTasksAfterShutdownPolicy} has been set
+	 * {@code true}, future executions of existing periodic tasks will
+	 * be cancelled.
+	 */
+	virtual void shutdown();
+
+	/**
+	 * Attempts to stop all actively executing tasks, halts the
+	 * processing of waiting tasks, and returns a list of the tasks
+	 * that were awaiting execution, including the delayed ones.
+	 *
+	 * @return list of tasks that never commenced execution.
+	 */
+	virtual EArrayList<sp<ERunnable> > shutdownNow();
+
+	virtual boolean isShutdown();
+	virtual boolean isTerminated();
+	virtual boolean awaitTermination() THROWS(EInterruptedException);
+	virtual boolean awaitTermination(llong timeout, ETimeUnit* unit) THROWS(EInterruptedException);
+
+	/**
+	 * Returns the number of delayed tasks waiting in the timing wheel.
+	 */
+	int getDelayedTaskCount();
+
+	/**
+	 * The default resolution of the timing wheel: one millisecond.
+	 */
+	static const llong DEFAULT_TICK_NANOS = 1000000L;
+
+protected:
+	/**
+	 * Cancels and clears the wheel of all tasks that should not be run
+	 * due to shutdown policy.
+	 */
+	virtual void onShutdown();
+
+	/**
+	 * Stops the ticker thread.
+	 */
+	virtual void terminated();
+
+	/**
+	 * A task scheduled by this executor: a future that also is an
+	 * entry of the timing wheel.
+	 */
+	template<typename V>
+	class ScheduledFutureTask : public EFutureTask<V>,
+			virtual public EScheduledFuture<V>, public stpe::TimerEntry {
+	public:
+		/**
+		 * Creates a one-shot action with given nanoTime-based trigger time.
+		 */
+		ScheduledFutureTask(sp<ECallable<V> > callable, llong ns,
+				EScheduledThreadPoolExecutor* executor) :
+				EFutureTask<V>(callable), stpe::TimerEntry(ns), period(0),
+				sequenceNumber(nextSequence()), executor(executor) {
+		}
+
+		/**
+		 * Creates a one-shot or periodic action with given nanoTime-based
+		 * initial trigger time and period (0 for one-shot, negative for
+		 * fixed-delay).
+		 */
+		ScheduledFutureTask(sp<ERunnable> r, sp<V> result, llong ns,
+				llong period, EScheduledThreadPoolExecutor* executor) :
+				EFutureTask<V>(r, result), stpe::TimerEntry(ns), period(period),
+				sequenceNumber(nextSequence()), executor(executor) {
+		}
+
+		virtual llong getDelay(ETimeUnit* unit) {
+			return unit->convert(deadline - ESystem::nanoTime(),
+					ETimeUnit::NANOSECONDS);
+		}
+
+		virtual int compareTo(EDelayed* other) {
+			if (other == this) // compare zero if same object
+				return 0;
+			ScheduledFutureTask<V>* x = dynamic_cast<ScheduledFutureTask<V>*>(other);
+			if (x != null) {
+				llong diff = deadline - x->deadline;
+				if (diff < 0)
+					return -1;
+				else if (diff > 0)
+					return 1;
+				else if (sequenceNumber < x->sequenceNumber)
+					return -1;
+				else
+					return 1;
+			}
+			llong diff = getDelay(ETimeUnit::NANOSECONDS) - other->getDelay(ETimeUnit::NANOSECONDS);
+			return (diff < 0) ? -1 : (diff > 0) ? 1 : 0;
+		}
+
+		virtual boolean isPeriodic() {
+			return period != 0;
+		}
+
+		/**
+		 * Removes the task from the timing wheel when cancelled.
+		 */
+		virtual boolean cancel(boolean mayInterruptIfRunning) {
+			boolean cancelled = EFutureTask<V>::cancel(mayInterruptIfRunning);
+			if (cancelled)
+				executor->removeDelayed(this);
+			return cancelled;
+		}
+
+		/**
+		 * Overrides FutureTask version so as to reset/requeue if periodic.
+		 */
+		virtual void run() {
+			boolean periodic = isPeriodic();
+			if (!executor->canRunInCurrentRunState(periodic))
+				cancel(false);
+			else if (!periodic)
+				EFutureTask<V>::run();
+			else if (this->runAndReset()) {
+				setNextRunTime();
+				executor->reExecutePeriodic(this);
+			}
+		}
+
+	private:
+		/**
+		 * Period in nanoseconds for repeating tasks.  A positive
+		 * value indicates fixed-rate execution.  A negative value
+		 * indicates fixed-delay execution.  A value of 0 indicates a
+		 * non-repeating task.
+		 */
+		llong period;
+
+		/** Sequence number to break ties FIFO */
+		llong sequenceNumber;
+
+		EScheduledThreadPoolExecutor* executor;
+
+		/**
+		 * Sets the next time to run for a periodic task.
+		 */
+		void setNextRunTime() {
+			llong p = period;
+			if (p > 0)
+				deadline += p;
+			else
+				deadline = executor->triggerTime(-p);
+		}
+	};
+
+private:
+	/**
+	 * False if should cancel/suppress periodic tasks on shutdown.
+	 */
+	volatile boolean continueExistingPeriodicTasksAfterShutdown;
+
+	/**
+	 * False if should cancel non-periodic tasks on shutdown.
+	 */
+	volatile boolean executeExistingDelayedTasksAfterShutdown;
+
+	/**
+	 * True once shutdownNow() was called.
+	 */
+	volatile boolean stopping;
+
+	/**
+	 * The work queue, also holding the timing wheel.
+	 */
+	sp<stpe::DelayedWorkQueue> delayedQueue;
+
+	static llong nextSequence();
+
+	/**
+	 * Returns true if can run a task given current run state
+	 * and run-after-shutdown parameters.
+	 *
+	 * @param periodic true if this task periodic, false if delayed
+	 */
+	boolean canRunInCurrentRunState(boolean periodic);
+
+	/**
+	 * Main execution method for delayed or periodic tasks.  If pool
+	 * is shut down, rejects the task. Otherwise adds task to the
+	 * timing wheel (or, if already enabled, to the queue of the
+	 * workers) and starts a thread, if necessary, to run it.  If the
+	 * pool is shut down while the task is being added, cancels and
+	 * removes it if required by state and run-after-shutdown
+	 * parameters.
+	 */
+	void delayedExecute(sp<ERunnable> task, stpe::TimerEntry* e);
+
+	/**
+	 * Requeues a periodic task unless current run state precludes it.
+	 * Same idea as delayedExecute except drops task rather than rejecting.
+	 */
+	void reExecutePeriodic(stpe::TimerEntry* e);
+
+	/**
+	 * Removes a cancelled task from the timing wheel, through
+	 * {@link #remove} so that a pool that was shut down terminates
+	 * once its last delayed task is gone.
+	 */
+	void removeDelayed(stpe::TimerEntry* e);
+
+	/**
+	 * Returns the trigger time of a delayed action.
+	 */
+	llong triggerTime(llong delay, ETimeUnit* unit);
+
+	/**
+	 * Returns the trigger time of a delayed action.
+	 */
+	llong triggerTime(llong delay);
+
+	static sp<EBlockingQueue<ERunnable> > newDelayedWorkQueue(llong tickNanos);
+
+	// unsupported.
+	EScheduledThreadPoolExecutor(const EScheduledThreadPoolExecutor& that);
+	EScheduledThreadPoolExecutor& operator= (const EScheduledThreadPoolExecutor& that);
+};
+
+} /* namespace efc */
+#endif /* ESCHEDULEDTHREADPOOLEXECUTOR_HH_ */
@@ -0,0 +1,122 @@
+/*
+ * ESpinControl.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ESPINCONTROL_HH_
+#define ESPINCONTROL_HH_
+
+#include "../EObject.hh"
+
+namespace efc {
+
+/**
+ * Spin-then-park tuning shared by the adaptive synchronizers
+ * ({@link EAdaptiveReentrantLock}, {@link EAdaptiveSemaphore},
+ * {@link EAdaptiveCountDownLatch}).
+ *
+ * <p>When an acquire misses, the synchronizer first retries for at most
+ * {@link #budget()} iterations, executing a CPU pause between
+ * attempts, and only then falls back to the queued, parking acquire of
+ * {@link EAbstractQueuedSynchronizer}.  The policy decides the budget:
+ * <ul>
+ * <li>{@code PARK}: no spinning, park at once (the behavior of the plain
+ *     synchronizers).
+ * <li>{@code FIXED}: always spin up to {@code maxSpins}.
+ * <li>{@code ADAPTIVE}: the budget follows the number of spins that
+ *     recently led to a successful acquire, shrinks when spinning
+ *     fails, and drops to zero while the sampled average hold time is
+ *     longer than a park/unpark round trip, because spinning cannot win
+ *     then.
+ * </ul>
+ * On a uniprocessor the budget is always zero.
+ *
+ * <p>The statistics are updated without atomic instructions; lost
+ * updates only make the heuristic slightly less precise.
+ */
+
+class ESpinControl: public EObject {
+public:
+	enum Policy {
+		PARK = 0,
+		FIXED = 1,
+		ADAPTIVE = 2
+	};
+
+	/** Default upper bound of spin iterations per acquire. */
+	static const int DEFAULT_MAX_SPINS = 1000;
+
+	/**
+	 * Average hold time above which ADAPTIVE stops spinning; roughly
+	 * the cost of a futex park plus the wake-up latency.
+	 */
+	static const llong PARK_THRESHOLD_NANOS = 20000L;
+
+	virtual ~ESpinControl();
+
+	/**
+	 * @param policy the spin policy
+	 * @param maxSpins the maximum number of spin iterations per acquire
+	 */
+	ESpinControl(Policy policy=ADAPTIVE, int maxSpins=DEFAULT_MAX_SPINS);
+
+	/**
+	 * Returns the number of spin iterations a missed acquire may spend
+	 * before parking.
+	 */
+	int budget();
+
+	/**
+	 * Feeds back the outcome of a spin phase.
+	 *
+	 * @param spins the iterations used
+	 * @param acquired whether the spin phase acquired
+	 */
+	void spun(int spins, boolean acquired);
+
+	/**
+	 * Called by the owner right after it acquired exclusively; samples
+	 * every eighth hold.
+	 */
+	void holdBegin();
+
+	/**
+	 * Called by the owner right before it releases.
+	 */
+	void holdEnd();
+
+	Policy getPolicy();
+	int getSpinLimit();
+	llong getAverageHoldNanos();
+
+	virtual EStringBase toString();
+
+	/**
+	 * Hints the processor that the caller is in a spin-wait loop.
+	 */
+	static inline void pause() {
+#if defined(__i386__) || defined(__x86_64__)
+		__asm__ __volatile__("pause" ::: "memory");
+#elif defined(__aarch64__)
+		__asm__ __volatile__("yield" ::: "memory");
+#elif defined(__GNUC__)
+		__asm__ __volatile__("" ::: "memory");
+#endif
+	}
+
+private:
+	Policy policy;
+	int maxSpins;
+	volatile int spinLimit;
+	volatile llong avgHoldNanos;
+	llong holdStamp;
+	uint holdSamples;
+
+	static int ncpu;
+	static int getNCPU();
+};
+
+} /* namespace efc */
+#endif /* ESPINCONTROL_HH_ */
@@ -0,0 +1,383 @@
+/*
+ * EStampedLock.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ESTAMPEDLOCK_HH_
+#define ESTAMPEDLOCK_HH_
+
+#include "../EString.hh"
+#include "../ETimeUnit.hh"
+#include "../EThread.hh"
+#include "../EInterruptedException.hh"
+#include "../EIllegalStateException.hh"
+
+namespace efc {
+	namespace stamped {
+		class Sync;
+	}
+}
+
+namespace efc {
+
+//@see: openjdk-8/src/share/classes/java/util/concurrent/locks/StampedLock.java
+
+/**
+ * A capability-based lock with three modes for controlling read/write
+ * access.  The state of a StampedLock consists of a version and mode.
+ * Lock acquisition methods return a stamp that represents and
+ * controls access with respect to a lock state; "try" versions of
+ * these methods may instead return the special value zero to
+ * represent failure to acquire access. Lock release and conversion
+ * methods require stamps as arguments, and fail if they do not match
+ * the state of the lock. The three modes are:
+ *
+ * <ul>
+ *
+ *  <li><b>Writing.</b> Method {@link #writeLock} possibly blocks
+ *   waiting for exclusive access, returning a stamp that can be used
+ *   in method {@link #unlockWrite} to release the lock. Untimed and
+ *   timed versions of {@code tryWriteLock} are also provided. When
+ *   the lock is held in write mode, no read locks may be obtained,
+ *   and all optimistic read validations will fail.  </li>
+ *
+ *  <li><b>Reading.</b> Method {@link #readLock} possibly blocks
+ *   waiting for non-exclusive access, returning a stamp that can be
+ *   used in method {@link #unlockRead} to release the lock. Untimed
+ *   and timed versions of {@code tryReadLock} are also provided. </li>
+ *
+ *  <li><b>Optimistic Reading.</b> Method {@link #tryOptimisticRead}
+ *   returns a non-zero stamp only if the lock is not currently held
+ *   in write mode. Method {@link #validate} returns true if the lock
+ *   has not been acquired in write mode since obtaining a given
+ *   stamp.  This mode can be thought of as an extremely weak version
+ *   of a read-lock, that can be broken by a writer at any time.  The
+ *   use of optimistic mode for short read-only code segments often
+ *   reduces contention and improves throughput: an optimistic reader
+ *   performs no writes to shared memory at all.  However, its use is
+ *   inherently fragile.  Optimistic read sections should only read
+ *   fields and hold them in local variables for later use after
+ *   validation. Fields read while in optimistic mode may be wildly
+ *   inconsistent, so usage applies only when you are familiar enough
+ *   with data representations to check consistency and/or repeatedly
+ *   invoke method {@code validate()}.  </li>
+ *
+ * </ul>
+ *
+ * <p>This class also supports methods that conditionally provide
+ * conversions across the three modes. For example, method {@link
+ * #tryConvertToWriteLock} attempts to "upgrade" a mode, returning
+ * a valid write stamp if (1) already in writing mode (2) in reading
+ * mode and there are no other readers or (3) in optimistic mode and
+ * the lock is available.
+ *
+ * <p>StampedLocks are designed for use as internal utilities in the
+ * development of thread-safe components. Their use relies on
+ * knowledge of the internal properties of the data, objects, and
+ * methods they are protecting.  They are not reentrant, so locked
+ * bodies should not call other unknown methods that may try to
+ * re-acquire locks (although you may pass a stamp to other methods
+ * that can use or convert it).  Unlike {@link EReentrantReadWriteLock},
+ * StampedLocks are not owned by threads, and do not support conditions.
+ *
+ * <p>Blocked threads are queued in an {@link EAbstractQueuedSynchronizer}
+ * and parked; uncontended acquire and release paths never touch that
+ * queue.  New readers do not overtake queued threads, so a waiting
+ * writer is not starved by a steady stream of readers.
+ *
+ * <p><b>Sample Usage.</b>
+ *
+ * <pre> {@code
+ * class Point {
+ *   double x, y;
+ *   EStampedLock sl;
+ *
+ *   void move(double deltaX, double deltaY) { // an exclusively locked method
+ *     llong stamp = sl.writeLock();
+ *     try {
+ *       x += deltaX;
+ *       y += deltaY;
+ *     } finally {
+ *       sl.unlockWrite(stamp);
+ *     }
+ *   }
+ *
+ *   double distanceFromOrigin() { // A read-only method
+ *     llong stamp = sl.tryOptimisticRead();
+ *     double currentX = x, currentY = y;
+ *     if (!sl.validate(stamp)) {
+ *        stamp = sl.readLock();
+ *        try {
+ *          currentX = x;
+ *          currentY = y;
+ *        } finally {
+ *           sl.unlockRead(stamp);
+ *        }
+ *     }
+ *     return EMath::sqrt(currentX * currentX + currentY * currentY);
+ *   }
+ * }}</pre>
+ *
+ * @since 1.8
+ */
+
+class EStampedLock: public EObject {
+public:
+	virtual ~EStampedLock();
+
+	/**
+	 * Creates a new lock, initially in unlocked state.
+	 */
+	EStampedLock();
+
+	/**
+	 * Exclusively acquires the lock, blocking if necessary
+	 * until available.
+	 *
+	 * @return a stamp that can be used to unlock or convert mode
+	 */
+	llong writeLock();
+
+	/**
+	 * Exclusively acquires the lock if it is immediately available.
+	 *
+	 * @return a stamp that can be used to unlock or convert mode,
+	 * or zero if the lock is not available
+	 */
+	llong tryWriteLock();
+
+	/**
+	 * Exclusively acquires the lock if it is available within the
+	 * given time and the current thread has not been interrupted.
+	 * Behavior under timeout and interruption matches that specified
+	 * for method {@link ELock#tryLock(llong,ETimeUnit*)}.
+	 *
+	 * @param time the maximum time to wait for the lock
+	 * @param unit the time unit of the {@code time} argument
+	 * @return a stamp that can be used to unlock or convert mode,
+	 * or zero if the lock is not available
+	 * @throws InterruptedException if the current thread is interrupted
+	 * before acquiring the lock
+	 */
+	llong tryWriteLock(llong time, ETimeUnit* unit) THROWS(EInterruptedException);
+
+	/**
+	 * Exclusively acquires the lock, blocking if necessary
+	 * until available or the current thread is interrupted.
+	 * Behavior under interruption matches that specified
+	 * for method {@link ELock#lockInterruptibly()}.
+	 *
+	 * @return a stamp that can be used to unlock or convert mode
+	 * @throws InterruptedException if the current thread is interrupted
+	 * before acquiring the lock
+	 */
+	llong writeLockInterruptibly() THROWS(EInterruptedException);
+
+	/**
+	 * Non-exclusively acquires the lock, blocking if necessary
+	 * until available.
+	 *
+	 * @return a stamp that can be used to unlock or convert mode
+	 */
+	llong readLock();
+
+	/**
+	 * Non-exclusively acquires the lock if it is immediately available.
+	 *
+	 * @return a stamp that can be used to unlock or convert mode,
+	 * or zero if the lock is not available
+	 */
+	llong tryReadLock();
+
+	/**
+	 * Non-exclusively acquires the lock if it is available within the
+	 * given time and the current thread has not been interrupted.
+	 * Behavior under timeout and interruption matches that specified
+	 * for method {@link ELock#tryLock(llong,ETimeUnit*)}.
+	 *
+	 * @param time the maximum time to wait for the lock
+	 * @param unit the time unit of the {@code time} argument
+	 * @return a stamp that can be used to unlock or convert mode,
+	 * or zero if the lock is not available
+	 * @throws InterruptedException if the current thread is interrupted
+	 * before acquiring the lock
+	 */
+	llong tryReadLock(llong time, ETimeUnit* unit) THROWS(EInterruptedException);
+
+	/**
+	 * Non-exclusively acquires the lock, blocking if necessary
+	 * until available or the current thread is interrupted.
+	 * Behavior under interruption matches that specified
+	 * for method {@link ELock#lockInterruptibly()}.
+	 *
+	 * @return a stamp that can be used to unlock or convert mode
+	 * @throws InterruptedException if the current thread is interrupted
+	 * before acquiring the lock
+	 */
+	llong readLockInterruptibly() THROWS(EInterruptedException);
+
+	/**
+	 * Returns a stamp that can later be validated, or zero
+	 * if exclusively locked.
+	 *
+	 * @return a stamp, or zero if exclusively locked
+	 */
+	llong tryOptimisticRead();
+
+	/**
+	 * Returns true if the lock has not been exclusively acquired
+	 * since issuance of the given stamp. Always returns false if the
+	 * stamp is zero. Always returns true if the stamp represents a
+	 * currently held lock. Invoking this method with a value not
+	 * obtained from {@link #tryOptimisticRead} or a locking method
+	 * for this lock has no defined effect or result.
+	 *
+	 * @param stamp a stamp
+	 * @return {@code true} if the lock has not been exclusively acquired
+	 * since issuance of the given stamp; else false
+	 */
+	boolean validate(llong stamp);
+
+	/**
+	 * If the lock state matches the given stamp, releases the
+	 * exclusive lock.
+	 *
+	 * @param stamp a stamp returned by a write-lock operation
+	 * @throws IllegalStateException if the stamp does
+	 * not match the current state of this lock
+	 */
+	void unlockWrite(llong stamp);
+
+	/**
+	 * If the lock state matches the given stamp, releases the
+	 * non-exclusive lock.
+	 *
+	 * @param stamp a stamp returned by a read-lock operation
+	 * @throws IllegalStateException if the stamp does
+	 * not match the current state of this lock
+	 */
+	void unlockRead(llong stamp);
+
+	/**
+	 * If the lock state matches the given stamp, releases the
+	 * corresponding mode of the lock.
+	 *
+	 * @param stamp a stamp returned by a lock operation
+	 * @throws IllegalStateException if the stamp does
+	 * not match the current state of this lock
+	 */
+	void unlock(llong stamp);
+
+	/**
+	 * If the lock state matches the given stamp, performs one of
+	 * the following actions. If the stamp represents holding a write
+	 * lock, returns it.  Or, if a read lock, if the write lock is
+	 * available, releases the read lock and returns a write stamp.
+	 * Or, if an optimistic read, returns a write stamp only if
+	 * immediately available. This method returns zero in all other
+	 * cases.
+	 *
+	 * @param stamp a stamp
+	 * @return a valid write stamp, or zero on failure
+	 */
+	llong tryConvertToWriteLock(llong stamp);
+
+	/**
+	 * If the lock state matches the given stamp, performs one of
+	 * the following actions. If the stamp represents holding a write
+	 * lock, releases it and obtains a read lock.  Or, if a read lock,
+	 * returns it. Or, if an optimistic read, acquires a read lock and
+	 * returns a read stamp only if immediately available. This method
+	 * returns zero in all other cases.
+	 *
+	 * @param stamp a stamp
+	 * @return a valid read stamp, or zero on failure
+	 */
+	llong tryConvertToReadLock(llong stamp);
+
+	/**
+	 * If the lock state matches the given stamp then, if the stamp
+	 * represents holding a lock, releases it and returns an
+	 * observation stamp.  Or, if an optimistic read, returns it if
+	 * validated. This method returns zero in all other cases, and so
+	 * may be useful as a form of "tryUnlock".
+	 *
+	 * @param stamp a stamp
+	 * @return a valid optimistic read stamp, or zero on failure
+	 */
+	llong tryConvertToOptimisticRead(llong stamp);
+
+	/**
+	 * Releases the write lock if it is held, without requiring a
+	 * stamp value. This method may be useful for recovery after
+	 * errors.
+	 *
+	 * @return {@code true} if the lock was held, else false
+	 */
+	boolean tryUnlockWrite();
+
+	/**
+	 * Releases one hold of the read lock if it is held, without
+	 * requiring a stamp value. This method may be useful for recovery
+	 * after errors.
+	 *
+	 * @return {@code true} if the read lock was held, else false
+	 */
+	boolean tryUnlockRead();
+
+	/**
+	 * Returns {@code true} if the lock is currently held exclusively.
+	 *
+	 * @return {@code true} if the lock is currently held exclusively
+	 */
+	boolean isWriteLocked();
+
+	/**
+	 * Returns {@code true} if the lock is currently held non-exclusively.
+	 *
+	 * @return {@code true} if the lock is currently held non-exclusively
+	 */
+	boolean isReadLocked();
+
+	/**
+	 * Queries the number of read locks held for this lock. This
+	 * method is designed for use in monitoring system state, not for
+	 * synchronization control.
+	 * @return the number of read locks held
+	 */
+	int getReadLockCount();
+
+	/**
+	 * Returns a string identifying this lock, as well as its lock
+	 * state.  The state, in brackets, includes the String {@code
+	 * "Unlocked"} or the String {@code "Write-locked"} or the String
+	 * {@code "Read-locks:"} followed by the current number of
+	 * read-locks held.
+	 *
+	 * @return a string identifying this lock, as well as its lock state
+	 */
+	virtual EStringBase toString();
+
+private:
+	friend class stamped::Sync;
+
+	/** Lock state: version, write bit and reader count. */
+	volatile llong state;
+	/** extra reader count when state read count saturated */
+	int readerOverflow;
+	/** Threads inside the queued acquire path. */
+	volatile int waiters;
+	/** Wait queue of blocked readers and writers. */
+	stamped::Sync* sync;
+
+	llong tryIncReaderOverflow(llong s);
+	llong tryDecReaderOverflow(llong s);
+	int getReadLockCount(llong s);
+	void wakeWaiters();
+	llong readStamp();
+};
+
+} /* namespace efc */
+#endif /* ESTAMPEDLOCK_HH_ */
@@ -0,0 +1,166 @@
+/*
+ * EStriped64.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ESTRIPED64_HH_
+#define ESTRIPED64_HH_
+
+#include "../ENumber.hh"
+#include "../ELongBinaryOperator.hh"
+
+namespace efc {
+
+//@see: openjdk-8/src/share/classes/java/util/concurrent/atomic/Striped64.java
+
+/**
+ * A base class holding common representation and mechanics
+ * for classes supporting dynamic striping on 64bit values. The class
+ * extends ENumber so that concrete subclasses must publicly do so.
+ *
+ * This class maintains a lazily-initialized table of atomically
+ * updated variables, plus an extra "base" field. The table size
+ * is a power of two. Indexing uses masked per-thread hash codes
+ * (see EThreadLocalRandom::getProbe()).
+ *
+ * Table entries are of class Cell; a variant of EAtomicLLong padded
+ * to reduce cache contention. Padding is overkill for most Atomics
+ * because they are usually irregularly scattered in memory and thus
+ * don't interfere much with each other. But Atomic objects residing
+ * in arrays will tend to be placed adjacent to each other, and so
+ * will most often share cache lines (with a huge negative
+ * performance impact) without this precaution.
+ *
+ * In part because Cells are relatively large, we avoid creating
+ * them until they are needed.  When there is no contention, all
+ * updates are made to the base field.  Upon first contention (a
+ * failed CAS on base update), the table is initialized to size 2.
+ * The table size is doubled upon further contention until
+ * reaching the nearest power of two greater than or equal to the
+ * number of CPUS. Table slots remain empty (null) until they are
+ * needed.
+ *
+ * A single spinlock ("cellsBusy") is used for initializing and
+ * resizing the table, as well as populating slots with new Cells.
+ * There is no need for a blocking lock; when the lock is not
+ * available, threads try other slots (or the base).  During these
+ * retries, there is increased contention and reduced locality,
+ * which is still better than alternatives.
+ *
+ * Cells are never removed before the owner is destroyed, and a
+ * replaced (smaller) table is kept until then too, since a
+ * concurrent sum() may still be walking it. There are at most
+ * log2(NCPU) such tables, so the cost is negligible.
+ *
+ * Accumulations that find their cell and CAS it on the first try
+ * never touch shared state other than that cell, so the common
+ * contended path is a single uncontended CAS on a private cache line.
+ */
+
+abstract class EStriped64 : public ENumber {
+public:
+	virtual ~EStriped64();
+
+protected:
+	/**
+	 * Padded variant of EAtomicLLong supporting only raw accesses
+	 * plus CAS. The value sits alone on its own cache line.
+	 */
+	struct Cell {
+		llong p0, p1, p2, p3, p4, p5, p6;
+		volatile llong value;
+		llong q0, q1, q2, q3, q4, q5, q6;
+
+		Cell(llong x) : value(x) {
+		}
+		boolean cas(llong cmp, llong val);
+	};
+
+	/**
+	 * Table of cells, variable length.
+	 */
+	struct Cells {
+		int length;
+		Cells* prev;            // replaced tables, freed with the owner
+		Cell* volatile cells[1];
+	};
+
+	/**
+	 * Table of cells. When non-null, size is a power of 2.
+	 */
+	Cells* volatile cells;
+
+	/**
+	 * Base value, used mainly when there is no contention, but also as
+	 * a fallback during table initialization races. Updated via CAS.
+	 */
+	volatile llong base;
+
+	/**
+	 * Spinlock (locked via CAS) used when resizing and/or creating Cells.
+	 */
+	volatile int cellsBusy;
+
+	/**
+	 * Default constructor for subclasses.
+	 */
+	EStriped64();
+
+	/**
+	 * CASes the base field.
+	 */
+	boolean casBase(llong cmp, llong val);
+
+	/**
+	 * CASes the cellsBusy field from 0 to 1 to acquire lock.
+	 */
+	boolean casCellsBusy();
+
+	/**
+	 * Handles cases of updates involving initialization, resizing,
+	 * creating new Cells, and/or contention. See above for
+	 * explanation. This method suffers the usual non-modularity
+	 * problems of optimistic retry code, relying on rechecked sets of
+	 * reads.
+	 *
+	 * @param x the value
+	 * @param fn the update function, or null for add (this convention
+	 * avoids the need for an extra field or function in LongAdder).
+	 * @param wasUncontended false if CAS failed before call
+	 */
+	void longAccumulate(llong x, ELongBinaryOperator* fn,
+			boolean wasUncontended);
+
+	/**
+	 * Same as longAccumulate, but adding doubles whose raw bits are
+	 * stored in the llong cells, as used by EDoubleAdder.
+	 */
+	void doubleAccumulate(double x, boolean wasUncontended);
+
+	static llong doubleToRawBits(double d) {
+		union { double d; llong l; } u;
+		u.d = d;
+		return u.l;
+	}
+
+	static double rawBitsToDouble(llong l) {
+		union { double d; llong l; } u;
+		u.l = l;
+		return u.d;
+	}
+
+	/** Number of CPUS, to place bound on table size */
+	static int NCPU();
+
+private:
+	static Cells* newCells(int n);
+
+	// unsupported.
+	EStriped64(const EStriped64& that);
+	EStriped64& operator= (const EStriped64& that);
+};
+
+} /* namespace efc */
+#endif /* ESTRIPED64_HH_ */
@@ -134,6 +134,28 @@ public:
 	 */
 	static EThreadLocalRandom* current();
 
+	/**
+	 * Returns the probe value for the current thread without forcing
+	 * initialization. Note that invoking EThreadLocalRandom::current()
+	 * can be used to force initialization on zero return.
+	 *
+	 * <p>The probe is a per-thread hash used by contention-spreading
+	 * classes ({@link ELongAdder}, {@link EConcurrentHashMap} counter
+	 * cells, ...) to select a slot; it is not a random number source.
+	 */
+	static int getProbe();
+
+	/**
+	 * Pseudo-randomly advances and records the given probe value for the
+	 * current thread.
+	 */
+	static int advanceProbe(int probe);
+
+	/**
+	 * Initializes the probe for the current thread.
+	 */
+	static void localInit();
+
 protected:
 	int next(int bits);
 
@@ -22,6 +22,7 @@
 #include "../ESecurityException.hh"
 #include "./ERejectedExecutionHandler.hh"
 #include "../EInterruptedException.hh"
+#include "../ENullPointerException.hh"
 #include "./ERejectedExecutionException.hh"
 
 namespace efc {
@@ -546,6 +547,68 @@ public:
 	 */
 	virtual void execute(sp<ERunnable> command);
 
+	/**
+	 * Executes the given tasks sometime in the future, with the same
+	 * outcome as calling {@link #execute} for each of them in list order,
+	 * but pays the synchronization once per batch: the tasks that go to
+	 * the work queue are inserted by a single
+	 * {@link EBlockingQueue#offerAll} call, so the pool state is read and
+	 * the queue's put lock is taken once rather than once per task.
+	 *
+	 * <p>Leading tasks still start core threads while fewer than
+	 * corePoolSize threads are running.  Tasks that fit neither the
+	 * core threads nor the queue take the path of {@link #execute}, so
+	 * they may start non-core threads or be handed to the
+	 * {@code RejectedExecutionHandler} one at a time.
+	 *
+	 * <p>For workers to take tasks in batches too, give the pool an
+	 * {@link EWorkerLocalQueue} with a {@code batchSize} above one.
+	 *
+	 * @param commands the tasks to execute
+	 * @throws RejectedExecutionException at discretion of
+	 *         {@code RejectedExecutionHandler}, for a task that
+	 *         cannot be accepted for execution
+	 * @throws NullPointerException if {@code commands} or any task is null
+	 */
+	void executeAll(EList<sp<ERunnable> >* commands) {
+		if (commands == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		sp<EIterator<sp<ERunnable> > > it = commands->iterator();
+		while (it->hasNext()) {
+			if (it->next() == null)
+				throw ENullPointerException(__FILE__, __LINE__);
+		}
+		int n = commands->size();
+		int i = 0;
+		while (i < n && workerCountOf(ctl->get()) < corePoolSize
+				&& addWorker(commands->getAt(i), true)) {
+			i++;
+		}
+		if (i < n && isRunning(ctl->get())) {
+			int k = workQueue->offerAll(commands, i);
+			if (k > 0) {
+				int recheck = ctl->get();
+				if (!isRunning(recheck)) {
+					sp<EListIterator<sp<ERunnable> > > qi = commands->listIterator(i);
+					for (int j = 0; j < k; j++) {
+						sp<ERunnable> command = qi->next();
+						if (remove(command))
+							reject(command);
+					}
+				} else if (workerCountOf(recheck) == 0) {
+					addWorker(null, false);
+				}
+				i += k;
+			}
+		}
+		if (i < n) {
+			sp<EListIterator<sp<ERunnable> > > rest = commands->listIterator(i);
+			while (rest->hasNext()) {
+				execute(rest->next());
+			}
+		}
+	}
+
 	/**
 	 * Initiates an orderly shutdown in which previously submitted
 	 * tasks are executed, but no new tasks will be accepted.
@@ -0,0 +1,767 @@
+/*
+ * EWorkerLocalQueue.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EWORKERLOCALQUEUE_HH_
+#define EWORKERLOCALQUEUE_HH_
+
+#include "../EA.hh"
+#include "../ESpinLock.hh"
+#include "../EThreadLocal.hh"
+#include "../EArrayList.hh"
+#include "../ESystem.hh"
+#include "./EBlockingQueue.hh"
+#include "./EAbstractConcurrentQueue.hh"
+#include "./EUnsafe.hh"
+#include "../EInterruptedException.hh"
+#include "../ENullPointerException.hh"
+#include "../EIllegalArgumentException.hh"
+#include "../ENoSuchElementException.hh"
+#include "../EIllegalStateException.hh"
+
+namespace efc {
+
+/**
+ * A {@linkplain EBlockingQueue blocking queue} that puts a small
+ * per-thread cache in front of a shared queue, so that the work a
+ * pool worker submits is usually run by that same worker, on the same
+ * core and with the same data still in cache.
+ *
+ * <p>A thread becomes a <em>worker</em> of this queue the first time
+ * it calls {@link #take} or {@link #poll(llong, ETimeUnit*)}, which is
+ * what the threads of an {@link EThreadPoolExecutor} do.  Each worker
+ * owns:
+ * <ul>
+ * <li>a LIFO slot holding the element it offered last, and
+ * <li>a bounded local queue, into which an older slot element moves
+ *     when a newer one arrives.
+ * </ul>
+ * A worker takes from its slot, then its local queue, then the shared
+ * queue, and finally steals from the local queues and slots of other
+ * workers before it blocks.  Elements offered by threads that are not
+ * workers, such as I/O threads, always go to the shared queue.
+ *
+ * <p>While some worker is blocked waiting, elements are not cached
+ * but sent to the shared queue, which wakes the idle worker; an
+ * element cached just as a worker went idle is handed over the same
+ * way.  A blocked worker that knows of cached elements wakes up every
+ * {@link #STEAL_INTERVAL_NANOS} nanoseconds to steal them, so work a
+ * task submitted and then waits for is run by another worker, if
+ * later than from the shared queue.
+ *
+ * <p>With a {@code batchSize} above one, a worker that finds its own
+ * cache empty moves up to that many elements from the shared queue
+ * into it with one {@link EBlockingQueue#drainTo} call, so it takes
+ * the shared queue's lock once per batch instead of once per element.
+ * The batch stays visible to stealers, and is returned to the shared
+ * queue if another worker is blocked waiting.
+ *
+ * <p>Use with {@link EThreadPoolExecutor}:
+ * <pre> {@code
+ * new EThreadPoolExecutor(n, n, 0, ETimeUnit::MILLISECONDS,
+ *         new EWorkerLocalQueue<ERunnable>(new ELinkedBlockingQueue<ERunnable>()));
+ * }</pre>
+ *
+ * <p>Aggregate operations such as {@link #size}, {@link #drainTo} and
+ * {@link #remove(E*)} cover the shared queue and all cached elements.
+ * Ordering is not FIFO: a worker's own last element comes first.  The
+ * iterator works on a snapshot.
+ *
+ * @param <E> the type of elements held in this collection
+ */
+
+template<typename E>
+class EWorkerLocalQueue: virtual public EAbstractConcurrentQueue<E>,
+		virtual public EBlockingQueue<E> {
+public:
+	/**
+	 * How often a blocked worker looks for cached elements of other
+	 * workers, while there are any.
+	 */
+	static const llong STEAL_INTERVAL_NANOS = 1000000L; // 1ms
+
+	virtual ~EWorkerLocalQueue() {
+		delete local;
+	}
+
+	/**
+	 * Creates a queue in front of the given shared queue.
+	 *
+	 * @param shared the queue receiving elements that are not cached
+	 * @param localCapacity capacity of each worker's local queue
+	 * @param batchSize how many elements a worker takes from the shared
+	 *        queue at once, at most {@code localCapacity + 1}
+	 * @throws NullPointerException if {@code shared} is null
+	 * @throws IllegalArgumentException if {@code localCapacity < 0} or
+	 *         {@code batchSize < 1}
+	 */
+	EWorkerLocalQueue(sp<EBlockingQueue<E> > shared, int localCapacity = 32, int batchSize = 1) {
+		if (shared == null) throw ENullPointerException(__FILE__, __LINE__);
+		if (localCapacity < 0 || batchSize < 1) throw EIllegalArgumentException(__FILE__, __LINE__);
+		registry = new Registry(shared, localCapacity,
+				(batchSize > localCapacity + 1) ? localCapacity + 1 : batchSize);
+		local = new EThreadLocalVariable<EThreadLocal, Lease>();
+	}
+
+	/**
+	 * Inserts the specified element.  From a worker, and while no
+	 * worker is blocked waiting, it goes to the worker's slot, moving
+	 * the previous slot element to the local queue; otherwise, or if
+	 * that has no room, to the shared queue.
+	 *
+	 * @return {@code true} unless the shared queue refused the element
+	 * @throws NullPointerException if the specified element is null
+	 */
+	virtual boolean offer(E* e) {
+		sp<E> x(e);
+		boolean r = offer(x);
+		if (!r) {
+			x.dismiss();
+		}
+		return r;
+	}
+	virtual boolean offer(sp<E> e) {
+		if (e == null) throw ENullPointerException(__FILE__, __LINE__);
+		Lease* l = local->get();
+		if (l == null) {
+			return registry->shared->offer(e);
+		}
+		Local* w = l->record;
+		sp<E> displaced;
+		boolean cached = false;
+		SYNCBLOCK(&w->lock) {
+			if (registry->waiters == 0) {
+				if (w->slot == null) {
+					w->slot = e;
+					cached = true;
+				} else if (w->size < w->ring.length()) {
+					displaced = w->slot;
+					w->ring[(w->head + w->size) % w->ring.length()] = displaced;
+					w->size++;
+					w->slot = e;
+					cached = true;
+				}
+			}
+			if (cached) {
+				w->count++;
+				eso_atomic_add_and_fetch32(&registry->pending, 1);
+			}
+		}}
+		if (!cached) {
+			return registry->shared->offer(e);
+		}
+		// a worker that went idle meanwhile is blocked on the shared
+		// queue and must not miss what was just cached
+		EUnsafe::fullFence();
+		if (registry->waiters > 0) {
+			handOver(w, displaced, false);
+			handOver(w, e, true);
+		}
+		return true;
+	}
+
+	/**
+	 * Inserts the specified element, waiting if necessary for space
+	 * to become available in the shared queue.
+	 */
+	virtual void put(E* e) THROWS(EInterruptedException) {
+		sp<E> x(e);
+		put(x);
+	}
+	virtual void put(sp<E> e) THROWS(EInterruptedException) {
+		if (e == null) throw ENullPointerException(__FILE__, __LINE__);
+		if (!offer(e)) {
+			registry->shared->put(e);
+		}
+	}
+
+	virtual boolean offer(E* e, llong timeout, ETimeUnit* unit)
+			THROWS(EInterruptedException) {
+		sp<E> x(e);
+		boolean r = offer(x, timeout, unit);
+		if (!r) {
+			x.dismiss();
+		}
+		return r;
+	}
+	virtual boolean offer(sp<E> e, llong timeout, ETimeUnit* unit)
+			THROWS(EInterruptedException) {
+		if (e == null) throw ENullPointerException(__FILE__, __LINE__);
+		return offer(e) || registry->shared->offer(e, timeout, unit);
+	}
+
+	virtual sp<E> poll() {
+		Lease* l = local->get();
+		sp<E> x;
+		if (l != null && (x = popLocal(l->record)) != null)
+			return x;
+		if ((x = (l != null) ? pollShared(l->record) : registry->shared->poll()) != null)
+			return x;
+		return steal(l != null ? l->record : null);
+	}
+
+	virtual sp<E> take() THROWS(EInterruptedException) {
+		Local* w = enroll();
+		for (;;) {
+			sp<E> x = popLocal(w);
+			if (x == null) x = pollShared(w);
+			if (x == null) x = steal(w);
+			if (x != null)
+				return x;
+
+			eso_atomic_add_and_fetch32(&registry->waiters, 1);
+			try {
+				// recheck after announcing: offers now see a waiter
+				x = steal(w);
+				if (x == null) {
+					if (registry->pending > 0)
+						x = registry->shared->poll(STEAL_INTERVAL_NANOS, ETimeUnit::NANOSECONDS);
+					else
+						x = registry->shared->take();
+				}
+			} catch (...) {
+				eso_atomic_sub_and_fetch32(&registry->waiters, 1);
+				throw; //!
+			}
+			eso_atomic_sub_and_fetch32(&registry->waiters, 1);
+			if (x != null)
+				return x;
+		}
+	}
+
+	virtual sp<E> poll(llong timeout, ETimeUnit* unit) THROWS(EInterruptedException) {
+		Local* w = enroll();
+		llong nanos = unit->toNanos(timeout);
+		llong deadline = ESystem::nanoTime() + nanos;
+		for (;;) {
+			sp<E> x = popLocal(w);
+			if (x == null) x = pollShared(w);
+			if (x == null) x = steal(w);
+			if (x != null || nanos <= 0)
+				return x;
+
+			eso_atomic_add_and_fetch32(&registry->waiters, 1);
+			try {
+				x = steal(w);
+				if (x == null) {
+					llong wait = (registry->pending > 0 && nanos > STEAL_INTERVAL_NANOS) ?
+							STEAL_INTERVAL_NANOS : nanos;
+					x = registry->shared->poll(wait, ETimeUnit::NANOSECONDS);
+				}
+			} catch (...) {
+				eso_atomic_sub_and_fetch32(&registry->waiters, 1);
+				throw; //!
+			}
+			eso_atomic_sub_and_fetch32(&registry->waiters, 1);
+			if (x != null)
+				return x;
+			nanos = deadline - ESystem::nanoTime();
+		}
+	}
+
+	virtual sp<E> peek() {
+		Lease* l = local->get();
+		if (l != null) {
+			Local* w = l->record;
+			SYNCBLOCK(&w->lock) {
+				if (w->slot != null) return w->slot;
+				if (w->size > 0) return w->ring[w->head];
+			}}
+		}
+		sp<E> x = registry->shared->peek();
+		if (x != null)
+			return x;
+		for (Local* w = registry->records; w != null; w = w->next) {
+			SYNCBLOCK(&w->lock) {
+				if (w->slot != null) return w->slot;
+				if (w->size > 0) return w->ring[w->head];
+			}}
+		}
+		return null;
+	}
+
+	/**
+	 * Returns the number of elements in the shared queue plus those
+	 * cached by workers.
+	 */
+	virtual int size() {
+		llong n = (llong)registry->shared->size() + registry->pending;
+		return (n > EInteger::MAX_VALUE) ? EInteger::MAX_VALUE : (int)n;
+	}
+
+	virtual boolean isEmpty() {
+		return registry->pending == 0 && registry->shared->isEmpty();
+	}
+
+	/**
+	 * Returns the remaining capacity of the shared queue.
+	 */
+	virtual int remainingCapacity() {
+		return registry->shared->remainingCapacity();
+	}
+
+	virtual boolean remove(E* o) {
+		if (o == null) return false;
+		for (Local* w = registry->records; w != null; w = w->next) {
+			SYNCBLOCK(&w->lock) {
+				if (w->slot != null && o->equals(w->slot.get())) {
+					w->slot = null;
+					w->count--;
+					eso_atomic_sub_and_fetch32(&registry->pending, 1);
+					return true;
+				}
+				int n = w->ring.length();
+				for (int i = 0; i < w->size; i++) {
+					if (o->equals(w->ring[(w->head + i) % n].get())) {
+						// close the gap
+						for (int j = i; j < w->size - 1; j++)
+							w->ring[(w->head + j) % n] = w->ring[(w->head + j + 1) % n];
+						w->ring[(w->head + w->size - 1) % n] = null;
+						w->size--;
+						w->count--;
+						eso_atomic_sub_and_fetch32(&registry->pending, 1);
+						return true;
+					}
+				}
+			}}
+		}
+		return registry->shared->remove(o);
+	}
+
+	virtual boolean contains(E* o) {
+		if (o == null) return false;
+		for (Local* w = registry->records; w != null; w = w->next) {
+			SYNCBLOCK(&w->lock) {
+				if (w->slot != null && o->equals(w->slot.get()))
+					return true;
+				for (int i = 0; i < w->size; i++) {
+					if (o->equals(w->ring[(w->head + i) % w->ring.length()].get()))
+						return true;
+				}
+			}}
+		}
+		return registry->shared->contains(o);
+	}
+
+	virtual EA<sp<E> > toArray() {
+		EArrayList<sp<E> > al;
+		for (Local* w = registry->records; w != null; w = w->next) {
+			SYNCBLOCK(&w->lock) {
+				if (w->slot != null)
+					al.add(w->slot);
+				for (int i = 0; i < w->size; i++)
+					al.add(w->ring[(w->head + i) % w->ring.length()]);
+			}}
+		}
+		EA<sp<E> > s = registry->shared->toArray();
+		for (int i = 0; i < s.length(); i++)
+			al.add(s[i]);
+		return al.toArray();
+	}
+
+	virtual void clear() {
+		for (Local* w = registry->records; w != null; w = w->next) {
+			SYNCBLOCK(&w->lock) {
+				registry->discard(w);
+			}}
+		}
+		registry->shared->clear();
+	}
+
+	virtual int drainTo(EConcurrentCollection<E>* c) {
+		return drainTo(c, EInteger::MAX_VALUE);
+	}
+	virtual int drainTo(ECollection<sp<E> >* c) {
+		return drainTo(c, EInteger::MAX_VALUE);
+	}
+
+	virtual int drainTo(EConcurrentCollection<E>* c, int maxElements) {
+		if (c == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		if (c == dynamic_cast<EConcurrentCollection<E>*>(this))
+			throw EIllegalArgumentException(__FILE__, __LINE__);
+		int n = 0;
+		sp<E> x;
+		while (n < maxElements && (x = pollCached()) != null) {
+			c->add(x);
+			n++;
+		}
+		if (n < maxElements)
+			n += registry->shared->drainTo(c, maxElements - n);
+		return n;
+	}
+	virtual int drainTo(ECollection<sp<E> >* c, int maxElements) {
+		if (c == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		if (c == dynamic_cast<ECollection<sp<E> >*>(this))
+			throw EIllegalArgumentException(__FILE__, __LINE__);
+		int n = 0;
+		sp<E> x;
+		while (n < maxElements && (x = pollCached()) != null) {
+			c->add(x);
+			n++;
+		}
+		if (n < maxElements)
+			n += registry->shared->drainTo(c, maxElements - n);
+		return n;
+	}
+
+	virtual boolean add(E* e) {
+		return EAbstractConcurrentQueue<E>::add(e);
+	}
+	virtual boolean add(sp<E> e) {
+		return EAbstractConcurrentQueue<E>::add(e);
+	}
+
+	virtual sp<E> remove() {
+		return EAbstractConcurrentQueue<E>::remove();
+	}
+
+	virtual sp<E> element() {
+		return EAbstractConcurrentQueue<E>::element();
+	}
+
+	virtual sp<EConcurrentIterator<E> > iterator() {
+		return new Itr(this);
+	}
+
+	/**
+	 * Returns the shared queue.
+	 */
+	sp<EBlockingQueue<E> > getSharedQueue() {
+		return registry->shared;
+	}
+
+private:
+	/**
+	 * The cache of one worker.  Records are kept until the queue and
+	 * all leases are gone; a record whose thread terminated is reused.
+	 */
+	class Local {
+	public:
+		ESpinLock lock;
+		sp<E> slot;
+		EA<sp<E> > ring;
+		int head;
+		int size; // elements in ring
+		int count; // slot + ring
+		volatile int inUse;
+		Local* next;
+		EArrayList<sp<E> > batch; // owner only, see pollShared
+
+		Local(int capacity) : ring(capacity), head(0), size(0), count(0), inUse(1), next(null) {
+		}
+	};
+
+	/**
+	 * State shared with the thread-local leases, which may outlive
+	 * the queue itself.
+	 */
+	class Registry: public EObject {
+	public:
+		sp<EBlockingQueue<E> > shared;
+		int localCapacity;
+		int batchSize;
+		Local* volatile records;
+		volatile int waiters; // workers blocked on the shared queue
+		volatile int pending; // elements cached by workers
+
+		Registry(sp<EBlockingQueue<E> > shared, int localCapacity, int batchSize) :
+				shared(shared), localCapacity(localCapacity), batchSize(batchSize),
+				records(null), waiters(0), pending(0) {
+		}
+
+		virtual ~Registry() {
+			Local* w = records;
+			while (w != null) {
+				Local* n = w->next;
+				delete w;
+				w = n;
+			}
+		}
+
+		Local* acquire() {
+			for (Local* w = records; w != null; w = w->next) {
+				if (w->inUse == 0 && EUnsafe::compareAndSwapInt(&w->inUse, 0, 1)) {
+					return w;
+				}
+			}
+			Local* w = new Local(localCapacity);
+			do {
+				w->next = records;
+			} while (!EUnsafe::compareAndSwapObject(&records, w->next, w));
+			return w;
+		}
+
+		void release(Local* w) {
+			// hand the cached elements over to the surviving workers
+			SYNCBLOCK(&w->lock) {
+				if (w->slot != null && shared->offer(w->slot)) {
+					w->slot = null;
+					w->count--;
+					eso_atomic_sub_and_fetch32(&pending, 1);
+				}
+				while (w->size > 0 && shared->offer(w->ring[w->head])) {
+					w->ring[w->head] = null;
+					w->head = (w->head + 1) % w->ring.length();
+					w->size--;
+					w->count--;
+					eso_atomic_sub_and_fetch32(&pending, 1);
+				}
+			}}
+			// what did not fit stays visible to stealers
+			EOrderAccess::release_store(&w->inUse, 0);
+		}
+
+		void discard(Local* w) {
+			w->slot = null;
+			for (int i = 0; i < w->size; i++)
+				w->ring[(w->head + i) % w->ring.length()] = null;
+			eso_atomic_sub_and_fetch32(&pending, w->count);
+			w->head = w->size = w->count = 0;
+		}
+	};
+
+	/**
+	 * Thread-local value binding a worker to its record.
+	 */
+	class Lease: public EObject {
+	public:
+		sp<Registry> registry;
+		Local* record;
+
+		Lease(sp<Registry> registry) : registry(registry), record(registry->acquire()) {
+		}
+		virtual ~Lease() {
+			registry->release(record);
+		}
+	};
+
+	class Itr: public EConcurrentIterator<E> {
+	public:
+		Itr(EWorkerLocalQueue* queue) : queue(queue), items(queue->toArray()), index(0) {
+		}
+
+		boolean hasNext() {
+			return index < items.length();
+		}
+
+		sp<E> next() {
+			if (index >= items.length()) throw ENoSuchElementException(__FILE__, __LINE__);
+			lastRet = items[index++];
+			return lastRet;
+		}
+
+		void remove() {
+			if (lastRet == null) throw EIllegalStateException(__FILE__, __LINE__);
+			queue->remove(lastRet.get());
+			lastRet = null;
+		}
+
+	private:
+		EWorkerLocalQueue* queue;
+		EA<sp<E> > items;
+		int index;
+		sp<E> lastRet;
+	};
+
+	sp<Registry> registry;
+	EThreadLocalVariable<EThreadLocal, Lease>* local;
+
+	Local* enroll() {
+		Lease* l = local->get();
+		if (l == null) {
+			l = new Lease(registry);
+			local->set(l);
+		}
+		return l->record;
+	}
+
+	/**
+	 * Removes the slot element, else the oldest local one.
+	 */
+	sp<E> popLocal(Local* w) {
+		sp<E> x;
+		if (w->count == 0)
+			return x;
+		SYNCBLOCK(&w->lock) {
+			if (w->slot != null) {
+				x = w->slot;
+				w->slot = null;
+			} else if (w->size > 0) {
+				x = w->ring[w->head];
+				w->ring[w->head] = null;
+				w->head = (w->head + 1) % w->ring.length();
+				w->size--;
+			} else {
+				return x;
+			}
+			w->count--;
+			eso_atomic_sub_and_fetch32(&registry->pending, 1);
+		}}
+		return x;
+	}
+
+	/**
+	 * Takes an element from the shared queue for worker {@code w},
+	 * whose cache is empty, and moves up to {@code batchSize - 1} more
+	 * into its local queue.  No batch is taken while another worker is
+	 * blocked waiting; one that blocks meanwhile gets the rest back
+	 * through the shared queue.
+	 */
+	sp<E> pollShared(Local* w) {
+		if (registry->batchSize <= 1 || registry->waiters > 0)
+			return registry->shared->poll();
+		w->batch.clear();
+		int n = registry->shared->drainTo(&w->batch, registry->batchSize);
+		if (n == 0)
+			return null;
+		sp<E> x = w->batch.getAt(0);
+		if (n > 1) {
+			// only the owner appends, and stealers only make room
+			SYNCBLOCK(&w->lock) {
+				for (int i = 1; i < n; i++) {
+					w->ring[(w->head + w->size) % w->ring.length()] = w->batch.getAt(i);
+					w->size++;
+				}
+				w->count += n - 1;
+				eso_atomic_add_and_fetch32(&registry->pending, n - 1);
+			}}
+			EUnsafe::fullFence();
+			if (registry->waiters > 0) {
+				sp<E> y;
+				while ((y = popOldest(w)) != null) {
+					if (!registry->shared->offer(y)) {
+						// full, so the waiter is not stuck either
+						putBack(w, y);
+						break;
+					}
+				}
+			}
+		}
+		w->batch.clear();
+		return x;
+	}
+
+	/**
+	 * Removes the oldest element of the local queue of {@code w}.
+	 */
+	sp<E> popOldest(Local* w) {
+		sp<E> x;
+		SYNCBLOCK(&w->lock) {
+			if (w->size > 0) {
+				x = w->ring[w->head];
+				w->ring[w->head] = null;
+				w->head = (w->head + 1) % w->ring.length();
+				w->size--;
+				w->count--;
+				eso_atomic_sub_and_fetch32(&registry->pending, 1);
+			}
+		}}
+		return x;
+	}
+
+	/**
+	 * Returns an element removed by {@link #popOldest} to the head of
+	 * the local queue of {@code w}.
+	 */
+	void putBack(Local* w, sp<E>& e) {
+		SYNCBLOCK(&w->lock) {
+			w->head = (w->head + w->ring.length() - 1) % w->ring.length();
+			w->ring[w->head] = e;
+			w->size++;
+			w->count++;
+			eso_atomic_add_and_fetch32(&registry->pending, 1);
+		}}
+	}
+
+	/**
+	 * Moves an element just cached in {@code w}, from its slot or as
+	 * the newest one in its local queue, to the shared queue, unless
+	 * it was taken meanwhile.  Only the owner caches in {@code w}, so
+	 * if the shared queue refuses it, the place it left is still free.
+	 */
+	void handOver(Local* w, sp<E>& e, boolean inSlot) {
+		if (e == null)
+			return;
+		sp<E> x;
+		SYNCBLOCK(&w->lock) {
+			if (inSlot) {
+				if (w->slot == e) {
+					x = w->slot;
+					w->slot = null;
+				}
+			} else if (w->size > 0) {
+				int last = (w->head + w->size - 1) % w->ring.length();
+				if (w->ring[last] == e) {
+					x = w->ring[last];
+					w->ring[last] = null;
+					w->size--;
+				}
+			}
+			if (x == null)
+				return;
+			w->count--;
+			eso_atomic_sub_and_fetch32(&registry->pending, 1);
+		}}
+		if (!registry->shared->offer(x)) {
+			SYNCBLOCK(&w->lock) {
+				if (inSlot && w->slot == null) {
+					w->slot = x;
+				} else {
+					w->ring[(w->head + w->size) % w->ring.length()] = x;
+					w->size++;
+				}
+				w->count++;
+				eso_atomic_add_and_fetch32(&registry->pending, 1);
+			}}
+		}
+	}
+
+	/**
+	 * Takes the oldest cached element of another worker, or its slot.
+	 */
+	sp<E> steal(Local* self) {
+		if (registry->pending == 0)
+			return null;
+		for (Local* w = registry->records; w != null; w = w->next) {
+			if (w == self || w->count == 0)
+				continue;
+			sp<E> x;
+			SYNCBLOCK(&w->lock) {
+				if (w->size > 0) {
+					x = w->ring[w->head];
+					w->ring[w->head] = null;
+					w->head = (w->head + 1) % w->ring.length();
+					w->size--;
+				} else if (w->slot != null) {
+					x = w->slot;
+					w->slot = null;
+				} else {
+					continue;
+				}
+				w->count--;
+				eso_atomic_sub_and_fetch32(&registry->pending, 1);
+			}}
+			return x;
+		}
+		return null;
+	}
+
+	sp<E> pollCached() {
+		Lease* l = local->get();
+		sp<E> x;
+		if (l != null && (x = popLocal(l->record)) != null)
+			return x;
+		return steal(l != null ? l->record : null);
+	}
+};
+
+template<typename E>
+const llong EWorkerLocalQueue<E>::STEAL_INTERVAL_NANOS;
+
+} /* namespace efc */
+#endif /* EWORKERLOCALQUEUE_HH_ */
@@ -0,0 +1,127 @@
+/*
+ * EAsyncChannel.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EASYNCCHANNEL_HH_
+#define EASYNCCHANNEL_HH_
+
+#include "./EEventLoop.hh"
+
+#ifdef CPP20_SUPPORT
+
+#include "../ESelectableChannel.hh"
+
+namespace efc {
+namespace nio {
+namespace async {
+
+/**
+ * A pending operation of an {@link EAsyncChannel}.
+ *
+ * <p>{@link #complete} attempts the operation on the non-blocking
+ * channel.  It is called once when the operation is awaited and again
+ * each time the selector reports the channel ready; it returns false if
+ * the operation would still block, and true once the result or an
+ * exception has been stored for {@code await_resume}.
+ */
+class EIoWaiter: public EResumable {
+public:
+	virtual ~EIoWaiter() {
+	}
+	virtual boolean complete() = 0;
+
+	/**
+	 * Completes the operation with an
+	 * {@code EAsynchronousCloseException}, when the channel is closed
+	 * under it.
+	 */
+	void cancel();
+
+protected:
+	std::exception_ptr exception_;
+
+	void rethrow() {
+		if (exception_) {
+			std::rethrow_exception(exception_);
+		}
+	}
+};
+
+/**
+ * A selectable channel bound to an {@link EEventLoop}, the base of the
+ * awaitable channels.
+ *
+ * <p>The channel is switched to non-blocking mode and owned by this
+ * object.  At most one read-side (read, accept) and one write-side
+ * (write, connect) operation may be pending at a time.  Closing the
+ * channel resumes the pending operations, which then throw
+ * {@code EAsynchronousCloseException}.
+ */
+
+abstract class EAsyncChannel: public EObject {
+public:
+	virtual ~EAsyncChannel();
+
+	/**
+	 * Returns the loop this channel is bound to.
+	 */
+	EEventLoop* getLoop();
+
+	/**
+	 * Closes the underlying channel, which also cancels its key, and
+	 * resumes the pending operations with an
+	 * {@code EAsynchronousCloseException}.  Must be called on the loop's
+	 * thread.
+	 */
+	void close() THROWS(EIOException);
+
+	/**
+	 * Tells whether the underlying channel is open.
+	 */
+	boolean isOpen();
+
+protected:
+	friend class EEventLoop;
+
+	EEventLoop* loop_;
+	ESelectableChannel* channel_;
+	ESelectionKey* key_;
+	EIoWaiter* reader_;
+	EIoWaiter* writer_;
+
+	/**
+	 * Binds {@code channel} to {@code loop}, or to the calling thread's
+	 * loop if {@code loop} is null.
+	 */
+	EAsyncChannel(ESelectableChannel* channel, EEventLoop* loop) THROWS(EIOException);
+
+	/**
+	 * Parks {@code waiter} until the channel is ready for {@code ops}.
+	 */
+	void await(int ops, EIoWaiter* waiter) THROWS(EIOException);
+
+	/**
+	 * Called by the loop with the key's ready operations.
+	 */
+	void ready(int readyOps);
+
+	/**
+	 * Resumes {@code waiter}, if any, with an
+	 * {@code EAsynchronousCloseException}.
+	 */
+	void cancel(EIoWaiter* waiter);
+
+	// unsupported.
+	EAsyncChannel(const EAsyncChannel&);
+	EAsyncChannel& operator=(const EAsyncChannel&);
+};
+
+} /* namespace async */
+} /* namespace nio */
+} /* namespace efc */
+
+#endif //!CPP20_SUPPORT
+#endif /* EASYNCCHANNEL_HH_ */
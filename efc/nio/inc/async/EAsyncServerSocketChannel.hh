@@ -0,0 +1,100 @@
+/*
+ * EAsyncServerSocketChannel.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EASYNCSERVERSOCKETCHANNEL_HH_
+#define EASYNCSERVERSOCKETCHANNEL_HH_
+
+#include "./EAsyncChannel.hh"
+
+#ifdef CPP20_SUPPORT
+
+#include "../EServerSocketChannel.hh"
+
+namespace efc {
+namespace nio {
+namespace async {
+
+/**
+ * An {@link EServerSocketChannel} whose accept is awaited with
+ * {@code co_await}.
+ *
+ * <pre> {@code
+ * ETask<void> serve(EEventLoopGroup* group) {
+ *     EAsyncServerSocketChannel server;
+ *     server.bind("0.0.0.0", 8899, 4096);
+ *     for (;;) {
+ *         ESocketChannel* sc = co_await server.accept();
+ *         group->next()->spawn(echo(sc));
+ *     }
+ * }
+ * }</pre>
+ *
+ * <p>The accepted channel is returned in blocking mode and owned by the
+ * caller; wrapping it in an {@link EAsyncSocketChannel} binds it to the
+ * loop that constructs the wrapper, so it may be handed to any loop.
+ */
+
+class EAsyncServerSocketChannel: public EAsyncChannel {
+public:
+	class AcceptAwaiter: public EIoWaiter {
+	public:
+		bool await_ready() {
+			return complete();
+		}
+		void await_suspend(std::coroutine_handle<> h) {
+			handle_ = h;
+			self_->await(ESelectionKey::OP_ACCEPT, this);
+		}
+		ESocketChannel* await_resume() {
+			rethrow();
+			return result_;
+		}
+		virtual boolean complete();
+	private:
+		friend class EAsyncServerSocketChannel;
+		EAsyncServerSocketChannel* self_;
+		ESocketChannel* result_;
+
+		AcceptAwaiter(EAsyncServerSocketChannel* self) :
+				self_(self), result_(null) {
+		}
+	};
+
+public:
+	virtual ~EAsyncServerSocketChannel();
+
+	/**
+	 * Opens an unbound server socket channel bound to {@code loop}, or to
+	 * the calling thread's loop if null.
+	 */
+	EAsyncServerSocketChannel(EEventLoop* loop=null) THROWS(EIOException);
+
+	/**
+	 * Binds the channel's socket to a local address.
+	 */
+	void bind(EInetSocketAddress* local, int backlog=50) THROWS(EIOException);
+	void bind(const char* hostname, int port, int backlog=50) THROWS(EIOException);
+
+	/**
+	 * Accepts a connection; {@code co_await} yields the new channel.
+	 */
+	AcceptAwaiter accept() {
+		return AcceptAwaiter(this);
+	}
+
+	/**
+	 * Returns the underlying channel.
+	 */
+	EServerSocketChannel* channel();
+};
+
+} /* namespace async */
+} /* namespace nio */
+} /* namespace efc */
+
+#endif //!CPP20_SUPPORT
+#endif /* EASYNCSERVERSOCKETCHANNEL_HH_ */
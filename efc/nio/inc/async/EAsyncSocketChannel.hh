@@ -0,0 +1,172 @@
+/*
+ * EAsyncSocketChannel.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EASYNCSOCKETCHANNEL_HH_
+#define EASYNCSOCKETCHANNEL_HH_
+
+#include "./EAsyncChannel.hh"
+
+#ifdef CPP20_SUPPORT
+
+#include "../ESocketChannel.hh"
+
+namespace efc {
+namespace nio {
+namespace async {
+
+/**
+ * An {@link ESocketChannel} whose reads, writes and connect are awaited
+ * with {@code co_await} instead of being driven from selection keys.
+ *
+ * <pre> {@code
+ * ETask<void> echo(ESocketChannel* sc) {
+ *     EAsyncSocketChannel ch(sc);
+ *     EIOByteBuffer buf(4096);
+ *     while (co_await ch.read(&buf) > 0) {
+ *         buf.flip();
+ *         co_await ch.write(&buf);
+ *         buf.clear();
+ *     }
+ * }
+ * }</pre>
+ *
+ * <p>An operation completes without suspending when the channel is
+ * already ready.  The awaiters live in the awaiting coroutine's frame.
+ */
+
+class EAsyncSocketChannel: public EAsyncChannel {
+public:
+	class ReadAwaiter: public EIoWaiter {
+	public:
+		bool await_ready() {
+			return complete();
+		}
+		void await_suspend(std::coroutine_handle<> h) {
+			handle_ = h;
+			self_->await(ESelectionKey::OP_READ, this);
+		}
+		int await_resume() {
+			rethrow();
+			return result_;
+		}
+		virtual boolean complete();
+	private:
+		friend class EAsyncSocketChannel;
+		EAsyncSocketChannel* self_;
+		EIOByteBuffer* dst_;
+		int result_;
+
+		ReadAwaiter(EAsyncSocketChannel* self, EIOByteBuffer* dst) :
+				self_(self), dst_(dst), result_(0) {
+		}
+	};
+
+	class WriteAwaiter: public EIoWaiter {
+	public:
+		bool await_ready() {
+			return complete();
+		}
+		void await_suspend(std::coroutine_handle<> h) {
+			handle_ = h;
+			self_->await(ESelectionKey::OP_WRITE, this);
+		}
+		int await_resume() {
+			rethrow();
+			return result_;
+		}
+		virtual boolean complete();
+	private:
+		friend class EAsyncSocketChannel;
+		EAsyncSocketChannel* self_;
+		EIOByteBuffer* src_;
+		int result_;
+
+		WriteAwaiter(EAsyncSocketChannel* self, EIOByteBuffer* src) :
+				self_(self), src_(src), result_(0) {
+		}
+	};
+
+	class ConnectAwaiter: public EIoWaiter {
+	public:
+		bool await_ready() {
+			return complete();
+		}
+		void await_suspend(std::coroutine_handle<> h) {
+			handle_ = h;
+			self_->await(ESelectionKey::OP_CONNECT, this);
+		}
+		void await_resume() {
+			rethrow();
+		}
+		virtual boolean complete();
+	private:
+		friend class EAsyncSocketChannel;
+		EAsyncSocketChannel* self_;
+		EInetSocketAddress* remote_;
+		boolean pending_;
+
+		ConnectAwaiter(EAsyncSocketChannel* self, EInetSocketAddress* remote) :
+				self_(self), remote_(remote), pending_(false) {
+		}
+	};
+
+public:
+	virtual ~EAsyncSocketChannel();
+
+	/**
+	 * Opens an unconnected socket channel bound to {@code loop}, or to
+	 * the calling thread's loop if null.
+	 */
+	EAsyncSocketChannel(EEventLoop* loop=null) THROWS(EIOException);
+
+	/**
+	 * Takes ownership of {@code channel}, typically one returned by
+	 * {@link EAsyncServerSocketChannel#accept}.
+	 */
+	EAsyncSocketChannel(ESocketChannel* channel, EEventLoop* loop=null) THROWS(EIOException);
+
+	/**
+	 * Reads a sequence of bytes into {@code dst}.
+	 *
+	 * <p>{@code co_await} yields the number of bytes read, -1 at end of
+	 * stream, or 0 if {@code dst} has no space remaining.
+	 */
+	ReadAwaiter read(EIOByteBuffer* dst) {
+		return ReadAwaiter(this, dst);
+	}
+
+	/**
+	 * Writes the remaining bytes of {@code src}.
+	 *
+	 * <p>Unlike {@link ESocketChannel#write}, the operation completes only
+	 * when {@code src} has no bytes remaining; {@code co_await} yields the
+	 * number of bytes written.
+	 */
+	WriteAwaiter write(EIOByteBuffer* src) {
+		return WriteAwaiter(this, src);
+	}
+
+	/**
+	 * Connects the channel; {@code co_await} returns once the connection
+	 * is established or throws if it fails.
+	 */
+	ConnectAwaiter connect(EInetSocketAddress* remote) {
+		return ConnectAwaiter(this, remote);
+	}
+
+	/**
+	 * Returns the underlying channel.
+	 */
+	ESocketChannel* channel();
+};
+
+} /* namespace async */
+} /* namespace nio */
+} /* namespace efc */
+
+#endif //!CPP20_SUPPORT
+#endif /* EASYNCSOCKETCHANNEL_HH_ */
@@ -0,0 +1,203 @@
+/*
+ * EEventLoop.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EEVENTLOOP_HH_
+#define EEVENTLOOP_HH_
+
+#include "./ETask.hh"
+
+#ifdef CPP20_SUPPORT
+
+#include "../ESelector.hh"
+#include "../ESelectionKey.hh"
+
+namespace efc {
+namespace nio {
+namespace async {
+
+class EAsyncChannel;
+
+/**
+ * A single-threaded event loop that resumes coroutines when their
+ * channels become ready, when their timers expire or when another
+ * thread hands them over.
+ *
+ * <p>The loop is built on an {@link ESelector}: every
+ * {@link EAsyncChannel} bound to the loop registers its channel once and
+ * the key's interest set is narrowed to the operations some coroutine
+ * is currently waiting for.  Ready coroutines, timers and coroutines
+ * posted from other threads are kept in intrusive lists and a heap whose
+ * nodes live in the waiting coroutine frames, so an I/O operation or a
+ * sleep allocates nothing beyond the frame itself.
+ *
+ * <pre> {@code
+ * ETask<void> ticker(EEventLoop* loop) {
+ *     for (int i = 0; i < 3; i++) {
+ *         co_await loop->sleep(1000);
+ *         ESystem::out->println("tick");
+ *     }
+ *     loop->stop();
+ * }
+ *
+ * EEventLoop loop;
+ * loop.spawn(ticker(&loop));
+ * loop.run();
+ * }</pre>
+ *
+ * <p>Everything except {@link #spawn}, {@link #post}, {@link #schedule}
+ * and {@link #stop} must be called on the loop's own thread.
+ *
+ * @see EEventLoopGroup
+ */
+
+class EEventLoop: public EObject {
+public:
+	/**
+	 * Awaiter returned by {@link #sleep}.
+	 */
+	class SleepAwaiter: public EResumable {
+	public:
+		bool await_ready() {
+			return millis_ <= 0;
+		}
+		void await_suspend(std::coroutine_handle<> h);
+		void await_resume() {
+		}
+	private:
+		friend class EEventLoop;
+		EEventLoop* loop_;
+		llong millis_;
+		llong deadline_;
+		int index_;
+
+		SleepAwaiter(EEventLoop* loop, llong millis) :
+				loop_(loop), millis_(millis), deadline_(0), index_(-1) {
+		}
+	};
+
+	/**
+	 * Awaiter returned by {@link #schedule}.
+	 */
+	class ScheduleAwaiter: public EResumable {
+	public:
+		bool await_ready() {
+			return false;
+		}
+		void await_suspend(std::coroutine_handle<> h) {
+			handle_ = h;
+			loop_->post(this);
+		}
+		void await_resume() {
+		}
+	private:
+		friend class EEventLoop;
+		EEventLoop* loop_;
+
+		ScheduleAwaiter(EEventLoop* loop) : loop_(loop) {
+		}
+	};
+
+public:
+	virtual ~EEventLoop();
+
+	/**
+	 * Creates a loop with a newly opened selector.
+	 *
+	 * @throws EIOException if the selector cannot be opened
+	 */
+	EEventLoop() THROWS(EIOException);
+
+	/**
+	 * Runs the loop on the calling thread until {@link #stop} is called.
+	 */
+	void run() THROWS(EIOException);
+
+	/**
+	 * Makes {@link #run} return after the current iteration.  May be
+	 * called from any thread.
+	 */
+	void stop();
+
+	/**
+	 * Detaches {@code task} and starts it on this loop.  The frame is
+	 * freed when the task completes.  May be called from any thread.
+	 */
+	void spawn(ETask<void> task);
+
+	/**
+	 * Queues {@code node} to be resumed on this loop.  May be called
+	 * from any thread.
+	 */
+	void post(EResumable* node);
+
+	/**
+	 * Suspends the awaiting coroutine for {@code millis} milliseconds.
+	 */
+	SleepAwaiter sleep(llong millis) {
+		return SleepAwaiter(this, millis);
+	}
+
+	/**
+	 * Resumes the awaiting coroutine on this loop: a yield when awaited
+	 * on the loop itself, a hand-over when awaited on another thread.
+	 */
+	ScheduleAwaiter schedule() {
+		return ScheduleAwaiter(this);
+	}
+
+	/**
+	 * Returns true if called on the thread running this loop.
+	 */
+	boolean inLoop();
+
+	/**
+	 * Returns the selector the loop's channels are registered with.
+	 */
+	ESelector* selector();
+
+	/**
+	 * Returns the loop running on the calling thread, or null.
+	 */
+	static EEventLoop* current();
+
+private:
+	friend class EAsyncChannel;
+
+	ESelector* selector_;
+	volatile int stopped_;
+
+	// ready list, loop thread only
+	EResumable* head_;
+	EResumable* tail_;
+
+	// pushed by other threads, reversed when drained
+	EResumable* volatile inbound_;
+
+	// min-heap of sleepers
+	SleepAwaiter** timers_;
+	int timerCount_;
+	int timerCapacity_;
+
+	void execute(EResumable* node);
+	void drainInbound();
+	void runReady();
+	void addTimer(SleepAwaiter* timer);
+	void siftUp(int i);
+	void siftDown(int i);
+	llong expireTimers();
+
+	// unsupported.
+	EEventLoop(const EEventLoop&);
+	EEventLoop& operator=(const EEventLoop&);
+};
+
+} /* namespace async */
+} /* namespace nio */
+} /* namespace efc */
+
+#endif //!CPP20_SUPPORT
+#endif /* EEVENTLOOP_HH_ */
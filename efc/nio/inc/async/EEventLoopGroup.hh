@@ -0,0 +1,96 @@
+/*
+ * EEventLoopGroup.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef EEVENTLOOPGROUP_HH_
+#define EEVENTLOOPGROUP_HH_
+
+#include "./EEventLoop.hh"
+
+#ifdef CPP20_SUPPORT
+
+#include "../../../inc/EThread.hh"
+#include "../../../inc/concurrent/EThreadFactory.hh"
+
+namespace efc {
+namespace nio {
+namespace async {
+
+/**
+ * A fixed set of {@link EEventLoop}s, each running on its own thread,
+ * normally one per core.
+ *
+ * <pre> {@code
+ * EEventLoopGroup group(0, new EAffinityThreadFactory()); //one pinned loop per core
+ * group.next()->spawn(serve(&group));
+ * ...
+ * group.shutdown();
+ * }</pre>
+ *
+ * <p>Coroutines are distributed with {@link #next}; a coroutine moves to
+ * another loop by awaiting that loop's {@link EEventLoop#schedule}.
+ */
+
+class EEventLoopGroup: public EObject {
+public:
+	/**
+	 * Stops the loops and waits for their threads.
+	 */
+	virtual ~EEventLoopGroup();
+
+	/**
+	 * Starts {@code threads} loops, or one per available processor if
+	 * {@code threads} is not positive.
+	 *
+	 * @param threads the number of loops
+	 * @param factory the factory for the loop threads, or null
+	 */
+	EEventLoopGroup(int threads=0, sp<EThreadFactory> factory=null) THROWS(EIOException);
+
+	/**
+	 * Returns the next loop, round-robin.
+	 */
+	EEventLoop* next();
+
+	/**
+	 * Returns the {@code index}-th loop.
+	 */
+	EEventLoop* get(int index);
+
+	/**
+	 * Returns the number of loops.
+	 */
+	int size();
+
+	/**
+	 * Starts {@code task} on the next loop.
+	 */
+	void spawn(ETask<void> task);
+
+	/**
+	 * Stops all loops and waits for their threads to exit.  Coroutines
+	 * still suspended at that point are not resumed.
+	 */
+	void shutdown();
+
+private:
+	EEventLoop** loops_;
+	EThread** threads_;
+	int size_;
+	volatile int next_;
+	volatile int shutdown_;
+
+	// unsupported.
+	EEventLoopGroup(const EEventLoopGroup&);
+	EEventLoopGroup& operator=(const EEventLoopGroup&);
+};
+
+} /* namespace async */
+} /* namespace nio */
+} /* namespace efc */
+
+#endif //!CPP20_SUPPORT
+#endif /* EEVENTLOOPGROUP_HH_ */
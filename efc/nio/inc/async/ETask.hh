@@ -0,0 +1,231 @@
+/*
+ * ETask.hh
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#ifndef ETASK_HH_
+#define ETASK_HH_
+
+#include "../../../EBase.hh"
+
+#ifdef CPP20_SUPPORT
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace efc {
+namespace nio {
+namespace async {
+
+/**
+ * A suspended coroutine queued for resumption by an {@link EEventLoop}.
+ *
+ * <p>Nodes are embedded in task promises and in awaiters, both of which
+ * live in the coroutine frame, so queueing a coroutine never allocates.
+ */
+struct EResumable {
+	EResumable* next_;
+	std::coroutine_handle<> handle_;
+
+	EResumable() : next_(null) {
+	}
+};
+
+/**
+ * Shared part of the {@link ETask} promises.
+ */
+class ETaskPromiseBase: public EResumable {
+public:
+	struct FinalAwaiter {
+		bool await_ready() noexcept {
+			return false;
+		}
+		template<typename P>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+			ETaskPromiseBase& p = h.promise();
+			if (p.continuation_) {
+				return p.continuation_;
+			}
+			if (p.detached_) {
+				h.destroy();
+			}
+			return std::noop_coroutine();
+		}
+		void await_resume() noexcept {
+		}
+	};
+
+	ETaskPromiseBase() : detached_(false) {
+	}
+
+	std::suspend_always initial_suspend() noexcept {
+		return std::suspend_always();
+	}
+
+	FinalAwaiter final_suspend() noexcept {
+		return FinalAwaiter();
+	}
+
+	void unhandled_exception() {
+		if (detached_) {
+			reportUncaught();
+		} else {
+			exception_ = std::current_exception();
+		}
+	}
+
+	/**
+	 * Prints the exception that ended a detached task.
+	 */
+	static void reportUncaught();
+
+protected:
+	template<typename T> friend class ETask;
+	friend class EEventLoop;
+
+	std::coroutine_handle<> continuation_;
+	std::exception_ptr exception_;
+	bool detached_;
+};
+
+template<typename T>
+class ETaskPromise: public ETaskPromiseBase {
+public:
+	template<typename U>
+	void return_value(U&& value) {
+		value_.emplace(std::forward<U>(value));
+	}
+	T result() {
+		if (exception_) {
+			std::rethrow_exception(exception_);
+		}
+		return std::move(*value_);
+	}
+private:
+	std::optional<T> value_;
+};
+
+template<>
+class ETaskPromise<void>: public ETaskPromiseBase {
+public:
+	void return_void() {
+	}
+	void result() {
+		if (exception_) {
+			std::rethrow_exception(exception_);
+		}
+	}
+};
+
+/**
+ * The return type of coroutines run by an {@link EEventLoop}.
+ *
+ * <p>A task is lazy: its body starts when it is awaited by another task,
+ * which is then resumed by symmetric transfer (a tail call once
+ * optimized) with the task's result or exception, or when it is handed to
+ * {@link EEventLoop#spawn}, which detaches it from its owner.  The
+ * coroutine frame is the only allocation a task makes.
+ *
+ * <pre> {@code
+ * ETask<int> readSome(EAsyncSocketChannel* ch, EIOByteBuffer* buf) {
+ *     co_return co_await ch->read(buf);
+ * }
+ *
+ * ETask<void> session(ESocketChannel* sc) {
+ *     EAsyncSocketChannel ch(sc);
+ *     EIOByteBuffer buf(512);
+ *     while (co_await readSome(&ch, &buf) > 0) {
+ *         buf.flip();
+ *         co_await ch.write(&buf);
+ *         buf.clear();
+ *     }
+ * }
+ * }</pre>
+ *
+ * <p>An exception that escapes a detached task is printed and dropped.
+ */
+template<typename T = void>
+class ETask {
+public:
+	class promise_type: public ETaskPromise<T> {
+	public:
+		ETask get_return_object() {
+			return ETask(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+	};
+
+	typedef std::coroutine_handle<promise_type> handle_type;
+
+	~ETask() {
+		if (handle_) {
+			handle_.destroy();
+		}
+	}
+
+	ETask(ETask&& that) noexcept : handle_(that.handle_) {
+		that.handle_ = nullptr;
+	}
+
+	ETask& operator=(ETask&& that) noexcept {
+		if (this != &that) {
+			if (handle_) {
+				handle_.destroy();
+			}
+			handle_ = that.handle_;
+			that.handle_ = nullptr;
+		}
+		return *this;
+	}
+
+	/**
+	 * Returns true if the task has run to completion.
+	 */
+	boolean isDone() {
+		return !handle_ || handle_.done();
+	}
+
+	// -- awaitable --
+
+	bool await_ready() {
+		return !handle_ || handle_.done();
+	}
+
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) {
+		handle_.promise().continuation_ = awaiter;
+		return handle_;
+	}
+
+	T await_resume() {
+		return handle_.promise().result();
+	}
+
+	/**
+	 * Gives up ownership of the coroutine frame.
+	 */
+	handle_type release() {
+		handle_type h = handle_;
+		handle_ = nullptr;
+		return h;
+	}
+
+private:
+	handle_type handle_;
+
+	explicit ETask(handle_type h) : handle_(h) {
+	}
+
+	// unsupported.
+	ETask(const ETask&);
+	ETask& operator=(const ETask&);
+};
+
+} /* namespace async */
+} /* namespace nio */
+} /* namespace efc */
+
+#endif //!CPP20_SUPPORT
+#endif /* ETASK_HH_ */
@@ -0,0 +1,118 @@
+/*
+ * EAsyncChannel.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/async/EAsyncChannel.hh"
+#include "../../inc/EAsynchronousCloseException.hh"
+#include "../../../inc/EIllegalStateException.hh"
+
+#ifdef CPP20_SUPPORT
+
+namespace efc {
+namespace nio {
+namespace async {
+
+#define READ_OPS (ESelectionKey::OP_READ | ESelectionKey::OP_ACCEPT)
+#define WRITE_OPS (ESelectionKey::OP_WRITE | ESelectionKey::OP_CONNECT)
+
+void EIoWaiter::cancel() {
+	exception_ = std::make_exception_ptr(EAsynchronousCloseException(__FILE__, __LINE__, "Channel closed"));
+}
+
+EAsyncChannel::~EAsyncChannel() {
+	delete channel_;
+}
+
+EAsyncChannel::EAsyncChannel(ESelectableChannel* channel, EEventLoop* loop) :
+		loop_(loop ? loop : EEventLoop::current()), channel_(channel),
+		key_(null), reader_(null), writer_(null) {
+	if (!loop_) {
+		delete channel_;
+		throw EIllegalStateException(__FILE__, __LINE__, "No event loop.");
+	}
+	try {
+		channel_->configureBlocking(false);
+	} catch (...) {
+		delete channel_;
+		throw;
+	}
+}
+
+EEventLoop* EAsyncChannel::getLoop() {
+	return loop_;
+}
+
+void EAsyncChannel::close() {
+	EIoWaiter* r = reader_;
+	EIoWaiter* w = writer_;
+	reader_ = null;
+	writer_ = null;
+	key_ = null; //cancelled by the channel
+
+	// the selector no longer reports this channel: resume the pending
+	// operations here, also when closing fails.
+	try {
+		channel_->close();
+	} catch (...) {
+		cancel(r);
+		cancel(w);
+		throw; //!
+	}
+	cancel(r);
+	cancel(w);
+}
+
+boolean EAsyncChannel::isOpen() {
+	return channel_->isOpen();
+}
+
+void EAsyncChannel::await(int ops, EIoWaiter* waiter) {
+	if (ops & READ_OPS) {
+		reader_ = waiter;
+	} else {
+		writer_ = waiter;
+	}
+	if (!key_) {
+		key_ = channel_->register_(loop_->selector(), ops, this);
+	} else {
+		key_->interestOps(key_->interestOps() | ops);
+	}
+}
+
+void EAsyncChannel::cancel(EIoWaiter* waiter) {
+	if (waiter) {
+		waiter->cancel();
+		loop_->execute(waiter);
+	}
+}
+
+void EAsyncChannel::ready(int readyOps) {
+	int interest = key_->interestOps();
+
+	// on an error the selector reports every interest op ready, and the
+	// retried operation then completes with the exception.
+	EIoWaiter* r = reader_;
+	if (r && (readyOps & READ_OPS) && r->complete()) {
+		reader_ = null;
+		loop_->execute(r);
+	}
+	EIoWaiter* w = writer_;
+	if (w && (readyOps & WRITE_OPS) && w->complete()) {
+		writer_ = null;
+		loop_->execute(w);
+	}
+
+	int ops = (reader_ ? (interest & READ_OPS) : 0) | (writer_ ? (interest & WRITE_OPS) : 0);
+	if (ops != interest) {
+		key_->interestOps(ops);
+	}
+}
+
+} /* namespace async */
+} /* namespace nio */
+} /* namespace efc */
+
+#endif //!CPP20_SUPPORT
@@ -0,0 +1,51 @@
+/*
+ * EAsyncServerSocketChannel.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/async/EAsyncServerSocketChannel.hh"
+
+#ifdef CPP20_SUPPORT
+
+namespace efc {
+namespace nio {
+namespace async {
+
+boolean EAsyncServerSocketChannel::AcceptAwaiter::complete() {
+	try {
+		result_ = self_->channel()->accept();
+		if (!result_) {
+			return false;
+		}
+	} catch (...) {
+		exception_ = std::current_exception();
+	}
+	return true;
+}
+
+EAsyncServerSocketChannel::~EAsyncServerSocketChannel() {
+}
+
+EAsyncServerSocketChannel::EAsyncServerSocketChannel(EEventLoop* loop) :
+		EAsyncChannel(EServerSocketChannel::open(), loop) {
+}
+
+void EAsyncServerSocketChannel::bind(EInetSocketAddress* local, int backlog) {
+	channel()->bind(local, backlog);
+}
+
+void EAsyncServerSocketChannel::bind(const char* hostname, int port, int backlog) {
+	channel()->bind(hostname, port, backlog);
+}
+
+EServerSocketChannel* EAsyncServerSocketChannel::channel() {
+	return static_cast<EServerSocketChannel*>(channel_);
+}
+
+} /* namespace async */
+} /* namespace nio */
+} /* namespace efc */
+
+#endif //!CPP20_SUPPORT
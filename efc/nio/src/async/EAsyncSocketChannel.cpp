@@ -0,0 +1,76 @@
+/*
+ * EAsyncSocketChannel.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/async/EAsyncSocketChannel.hh"
+
+#ifdef CPP20_SUPPORT
+
+namespace efc {
+namespace nio {
+namespace async {
+
+boolean EAsyncSocketChannel::ReadAwaiter::complete() {
+	try {
+		int n = self_->channel()->read(dst_);
+		if (n == 0 && dst_->hasRemaining()) {
+			return false;
+		}
+		result_ = n;
+	} catch (...) {
+		exception_ = std::current_exception();
+	}
+	return true;
+}
+
+boolean EAsyncSocketChannel::WriteAwaiter::complete() {
+	try {
+		while (src_->hasRemaining()) {
+			int n = self_->channel()->write(src_);
+			if (n <= 0) {
+				return false;
+			}
+			result_ += n;
+		}
+	} catch (...) {
+		exception_ = std::current_exception();
+	}
+	return true;
+}
+
+boolean EAsyncSocketChannel::ConnectAwaiter::complete() {
+	try {
+		if (!pending_) {
+			pending_ = true;
+			return self_->channel()->connect(remote_);
+		}
+		return self_->channel()->finishConnect();
+	} catch (...) {
+		exception_ = std::current_exception();
+	}
+	return true;
+}
+
+EAsyncSocketChannel::~EAsyncSocketChannel() {
+}
+
+EAsyncSocketChannel::EAsyncSocketChannel(EEventLoop* loop) :
+		EAsyncChannel(ESocketChannel::open(), loop) {
+}
+
+EAsyncSocketChannel::EAsyncSocketChannel(ESocketChannel* channel, EEventLoop* loop) :
+		EAsyncChannel(channel, loop) {
+}
+
+ESocketChannel* EAsyncSocketChannel::channel() {
+	return static_cast<ESocketChannel*>(channel_);
+}
+
+} /* namespace async */
+} /* namespace nio */
+} /* namespace efc */
+
+#endif //!CPP20_SUPPORT
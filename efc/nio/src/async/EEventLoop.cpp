@@ -0,0 +1,261 @@
+/*
+ * EEventLoop.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/async/EEventLoop.hh"
+#include "../../inc/async/EAsyncChannel.hh"
+#include "../../../inc/ESystem.hh"
+#include "../../../inc/EThrowable.hh"
+
+#ifdef CPP20_SUPPORT
+
+namespace efc {
+namespace nio {
+namespace async {
+
+#define INITIAL_TIMER_CAPACITY 64
+
+static THREAD_TLS EEventLoop* currentLoop = null;
+
+static llong currentMillis() {
+	return ESystem::nanoTime() / 1000000;
+}
+
+void ETaskPromiseBase::reportUncaught() {
+	try {
+		throw;
+	} catch (EThrowable& t) {
+		t.printStackTrace();
+	} catch (...) {
+		ESystem::err->println("Uncaught exception in detached task.");
+	}
+}
+
+void EEventLoop::SleepAwaiter::await_suspend(std::coroutine_handle<> h) {
+	handle_ = h;
+	deadline_ = currentMillis() + millis_;
+	loop_->addTimer(this);
+}
+
+EEventLoop::~EEventLoop() {
+	try {
+		selector_->close();
+	} catch (...) {
+	}
+	delete selector_;
+	delete[] timers_;
+}
+
+EEventLoop::EEventLoop() :
+		selector_(null), stopped_(0), head_(null), tail_(null), inbound_(null),
+		timers_(null), timerCount_(0), timerCapacity_(0) {
+	selector_ = ESelector::open();
+}
+
+void EEventLoop::run() {
+	EEventLoop* outer = currentLoop;
+	currentLoop = this;
+	try {
+		while (!stopped_) {
+			drainInbound();
+			runReady();
+			llong wait = expireTimers();
+			if (head_ || stopped_) {
+				continue;
+			}
+
+			// an inbound push after drainInbound() has woken the selector,
+			// which makes this select return at once.
+			int n = selector_->select(wait < 0 ? 0 : wait);
+			if (n > 0) {
+				ESet<ESelectionKey*>* keys = selector_->selectedKeys();
+				sp<EIterator<ESelectionKey*> > iter = keys->iterator();
+				while (iter->hasNext()) {
+					ESelectionKey* key = iter->next();
+					iter->remove();
+					EAsyncChannel* channel = (EAsyncChannel*)key->attachment();
+					if (channel && key->isValid()) {
+						channel->ready(key->readyOps());
+					}
+				}
+			}
+			expireTimers();
+		}
+	} catch (...) {
+		currentLoop = outer;
+		throw;
+	}
+	currentLoop = outer;
+}
+
+void EEventLoop::stop() {
+	stopped_ = 1;
+	selector_->wakeup();
+}
+
+void EEventLoop::spawn(ETask<void> task) {
+	ETask<void>::handle_type h = task.release();
+	if (!h) {
+		return;
+	}
+	ETaskPromiseBase& promise = h.promise();
+	promise.detached_ = true;
+	promise.handle_ = h;
+	post(&promise);
+}
+
+void EEventLoop::post(EResumable* node) {
+	if (currentLoop == this) {
+		execute(node);
+		return;
+	}
+	EResumable* head;
+	do {
+		head = inbound_;
+		node->next_ = head;
+	} while (!eso_atomic_compare_and_swapptr((void* volatile*)&inbound_, head, node));
+	if (!head) {
+		selector_->wakeup();
+	}
+}
+
+boolean EEventLoop::inLoop() {
+	return currentLoop == this;
+}
+
+ESelector* EEventLoop::selector() {
+	return selector_;
+}
+
+EEventLoop* EEventLoop::current() {
+	return currentLoop;
+}
+
+void EEventLoop::execute(EResumable* node) {
+	node->next_ = null;
+	if (tail_) {
+		tail_->next_ = node;
+	} else {
+		head_ = node;
+	}
+	tail_ = node;
+}
+
+void EEventLoop::drainInbound() {
+	if (!inbound_) {
+		return;
+	}
+	EResumable* list = (EResumable*)eso_atomic_test_and_setptr((es_intptr_t*)&inbound_, null);
+	EResumable* fifo = null;
+	while (list) {
+		EResumable* next = list->next_;
+		list->next_ = fifo;
+		fifo = list;
+		list = next;
+	}
+	while (fifo) {
+		EResumable* next = fifo->next_;
+		execute(fifo);
+		fifo = next;
+	}
+}
+
+void EEventLoop::runReady() {
+	// only what is queued now; coroutines queued while running wait for
+	// the next round so that a yielding coroutine cannot starve the I/O.
+	EResumable* last = tail_;
+	while (head_) {
+		EResumable* node = head_;
+		head_ = node->next_;
+		if (!head_) {
+			tail_ = null;
+		}
+		boolean end = (node == last);
+		node->handle_.resume(); //node may be gone now
+		if (end) {
+			break;
+		}
+	}
+}
+
+void EEventLoop::addTimer(SleepAwaiter* timer) {
+	if (timerCount_ == timerCapacity_) {
+		int capacity = timerCapacity_ ? timerCapacity_ << 1 : INITIAL_TIMER_CAPACITY;
+		SleepAwaiter** timers = new SleepAwaiter*[capacity];
+		for (int i = 0; i < timerCount_; i++) {
+			timers[i] = timers_[i];
+		}
+		delete[] timers_;
+		timers_ = timers;
+		timerCapacity_ = capacity;
+	}
+	timers_[timerCount_] = timer;
+	timer->index_ = timerCount_;
+	siftUp(timerCount_++);
+}
+
+void EEventLoop::siftUp(int i) {
+	SleepAwaiter* t = timers_[i];
+	while (i > 0) {
+		int parent = (i - 1) >> 1;
+		SleepAwaiter* p = timers_[parent];
+		if (p->deadline_ <= t->deadline_) {
+			break;
+		}
+		timers_[i] = p;
+		p->index_ = i;
+		i = parent;
+	}
+	timers_[i] = t;
+	t->index_ = i;
+}
+
+void EEventLoop::siftDown(int i) {
+	SleepAwaiter* t = timers_[i];
+	int half = timerCount_ >> 1;
+	while (i < half) {
+		int child = (i << 1) + 1;
+		int right = child + 1;
+		if (right < timerCount_ && timers_[right]->deadline_ < timers_[child]->deadline_) {
+			child = right;
+		}
+		SleepAwaiter* c = timers_[child];
+		if (t->deadline_ <= c->deadline_) {
+			break;
+		}
+		timers_[i] = c;
+		c->index_ = i;
+		i = child;
+	}
+	timers_[i] = t;
+	t->index_ = i;
+}
+
+llong EEventLoop::expireTimers() {
+	if (timerCount_ == 0) {
+		return -1;
+	}
+	llong now = currentMillis();
+	while (timerCount_ > 0) {
+		SleepAwaiter* t = timers_[0];
+		if (t->deadline_ > now) {
+			return t->deadline_ - now;
+		}
+		if (--timerCount_ > 0) {
+			timers_[0] = timers_[timerCount_];
+			siftDown(0);
+		}
+		t->index_ = -1;
+		execute(t);
+	}
+	return -1;
+}
+
+} /* namespace async */
+} /* namespace nio */
+} /* namespace efc */
+
+#endif //!CPP20_SUPPORT
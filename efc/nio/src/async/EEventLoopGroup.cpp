@@ -0,0 +1,106 @@
+/*
+ * EEventLoopGroup.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/async/EEventLoopGroup.hh"
+#include "../../../inc/ERuntime.hh"
+#include "../../../inc/EThrowable.hh"
+
+#ifdef CPP20_SUPPORT
+
+namespace efc {
+namespace nio {
+namespace async {
+
+static volatile int groupSequence = 0;
+
+class EEventLoopRunner: public ERunnable {
+public:
+	EEventLoopRunner(EEventLoop* loop) : loop(loop) {
+	}
+	virtual void run() {
+		try {
+			loop->run();
+		} catch (EThrowable& t) {
+			t.printStackTrace();
+		}
+	}
+private:
+	EEventLoop* loop;
+};
+
+EEventLoopGroup::~EEventLoopGroup() {
+	shutdown();
+	for (int i = 0; i < size_; i++) {
+		delete threads_[i];
+		delete loops_[i];
+	}
+	delete[] threads_;
+	delete[] loops_;
+}
+
+EEventLoopGroup::EEventLoopGroup(int threads, sp<EThreadFactory> factory) :
+		next_(-1), shutdown_(0) {
+	if (threads <= 0) {
+		threads = ERuntime::getRuntime()->availableProcessors();
+	}
+	size_ = threads;
+
+	int number = eso_atomic_add_and_fetch32(&groupSequence, 1);
+	loops_ = new EEventLoop*[size_];
+	threads_ = new EThread*[size_];
+	for (int i = 0; i < size_; i++) {
+		loops_[i] = new EEventLoop();
+		sp<ERunnable> runner = new EEventLoopRunner(loops_[i]);
+		if (factory != null) {
+			threads_[i] = factory->newThread(runner);
+		} else {
+			threads_[i] = new EThread(runner,
+					EStringBase::formatOf("EventLoopGroup-%d-loop-%d", number, i + 1).c_str());
+		}
+	}
+	for (int i = 0; i < size_; i++) {
+		threads_[i]->start();
+	}
+}
+
+EEventLoop* EEventLoopGroup::next() {
+	int n = eso_atomic_add_and_fetch32(&next_, 1) & 0x7fffffff;
+	return loops_[n % size_];
+}
+
+EEventLoop* EEventLoopGroup::get(int index) {
+	if (index < 0 || index >= size_) {
+		throw EIndexOutOfBoundsException(__FILE__, __LINE__);
+	}
+	return loops_[index];
+}
+
+int EEventLoopGroup::size() {
+	return size_;
+}
+
+void EEventLoopGroup::spawn(ETask<void> task) {
+	next()->spawn(std::move(task));
+}
+
+void EEventLoopGroup::shutdown() {
+	if (!eso_atomic_compare_and_swap32(&shutdown_, 0, 1)) {
+		return;
+	}
+	for (int i = 0; i < size_; i++) {
+		loops_[i]->stop();
+	}
+	for (int i = 0; i < size_; i++) {
+		threads_[i]->join();
+	}
+}
+
+} /* namespace async */
+} /* namespace nio */
+} /* namespace efc */
+
+#endif //!CPP20_SUPPORT
@@ -0,0 +1,54 @@
+/*
+ * EAdaptiveCountDownLatch.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/EAdaptiveCountDownLatch.hh"
+
+namespace efc {
+
+EAdaptiveCountDownLatch::~EAdaptiveCountDownLatch() {
+}
+
+EAdaptiveCountDownLatch::EAdaptiveCountDownLatch(int count,
+		ESpinControl::Policy policy, int maxSpins) :
+		ECountDownLatch(count), spin(policy, maxSpins) {
+}
+
+boolean EAdaptiveCountDownLatch::spinAwait() {
+	if (getCount() == 0)
+		return true;
+	int budget = spin.budget();
+	if (budget == 0)
+		return false;
+	for (int i = 1; i <= budget; i++) {
+		ESpinControl::pause();
+		if (getCount() == 0) {
+			spin.spun(i, true);
+			return true;
+		}
+	}
+	spin.spun(budget, false);
+	return false;
+}
+
+void EAdaptiveCountDownLatch::await() {
+	if (!spinAwait())
+		ECountDownLatch::await();
+}
+
+boolean EAdaptiveCountDownLatch::await(llong timeout, ETimeUnit* unit) {
+	return spinAwait() || ECountDownLatch::await(timeout, unit);
+}
+
+ESpinControl* EAdaptiveCountDownLatch::getSpinControl() {
+	return &spin;
+}
+
+EStringBase EAdaptiveCountDownLatch::toString() {
+	return ECountDownLatch::toString() + spin.toString();
+}
+
+} /* namespace efc */
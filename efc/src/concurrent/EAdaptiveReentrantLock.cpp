@@ -0,0 +1,195 @@
+/*
+ * EAdaptiveReentrantLock.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/EAdaptiveReentrantLock.hh"
+#include "../../inc/EIllegalArgumentException.hh"
+#include "../../inc/ENullPointerException.hh"
+
+namespace efc {
+
+/**
+ * Condition of the base lock that stops the hold-time sample while the
+ * owner waits, and restarts it once the lock is reacquired.
+ */
+class EAdaptiveReentrantLock::Condition: public ECondition {
+public:
+	virtual ~Condition() {
+		delete cond;
+	}
+
+	Condition(EAdaptiveReentrantLock* lock, ECondition* cond) :
+			lock(lock), cond(cond) {
+	}
+
+	virtual void await() THROWS(EInterruptedException) {
+		lock->spin.holdEnd();
+		try {
+			cond->await();
+		} catch (...) {
+			lock->spin.holdBegin();
+			throw; //!
+		}
+		lock->spin.holdBegin();
+	}
+
+	virtual void awaitUninterruptibly() {
+		lock->spin.holdEnd();
+		cond->awaitUninterruptibly();
+		lock->spin.holdBegin();
+	}
+
+	virtual llong awaitNanos(llong nanosTimeout) {
+		lock->spin.holdEnd();
+		llong r;
+		try {
+			r = cond->awaitNanos(nanosTimeout);
+		} catch (...) {
+			lock->spin.holdBegin();
+			throw; //!
+		}
+		lock->spin.holdBegin();
+		return r;
+	}
+
+	virtual boolean await(llong time, ETimeUnit* unit) THROWS(EInterruptedException) {
+		lock->spin.holdEnd();
+		boolean r;
+		try {
+			r = cond->await(time, unit);
+		} catch (...) {
+			lock->spin.holdBegin();
+			throw; //!
+		}
+		lock->spin.holdBegin();
+		return r;
+	}
+
+	virtual boolean awaitUntil(EDate* deadline) THROWS(EInterruptedException) {
+		lock->spin.holdEnd();
+		boolean r;
+		try {
+			r = cond->awaitUntil(deadline);
+		} catch (...) {
+			lock->spin.holdBegin();
+			throw; //!
+		}
+		lock->spin.holdBegin();
+		return r;
+	}
+
+	virtual void signal() {
+		cond->signal();
+	}
+
+	virtual void signalAll() {
+		cond->signalAll();
+	}
+
+	EAdaptiveReentrantLock* lock;
+	ECondition* cond;
+};
+
+EAdaptiveReentrantLock::~EAdaptiveReentrantLock() {
+}
+
+EAdaptiveReentrantLock::EAdaptiveReentrantLock(boolean fair,
+		ESpinControl::Policy policy, int maxSpins) :
+		EReentrantLock(fair), fair(fair), spin(policy, maxSpins) {
+}
+
+boolean EAdaptiveReentrantLock::spinAcquire() {
+	if (!fair && EReentrantLock::tryLock())
+		return true;
+	int budget = spin.budget();
+	if (budget == 0)
+		return false;
+	for (int i = 1; i <= budget; i++) {
+		ESpinControl::pause();
+		// test before test-and-set, and never overtake queued threads of a fair lock
+		if (!isLocked() && (!fair || !hasQueuedThreads()) && EReentrantLock::tryLock()) {
+			spin.spun(i, true);
+			return true;
+		}
+	}
+	spin.spun(budget, false);
+	return false;
+}
+
+void EAdaptiveReentrantLock::lock() {
+	if (isHeldByCurrentThread()) {
+		EReentrantLock::lock();
+		return;
+	}
+	if (!spinAcquire())
+		EReentrantLock::lock();
+	spin.holdBegin();
+}
+
+void EAdaptiveReentrantLock::lockInterruptibly() {
+	if (isHeldByCurrentThread()) {
+		EReentrantLock::lockInterruptibly();
+		return;
+	}
+	if (!spinAcquire())
+		EReentrantLock::lockInterruptibly();
+	spin.holdBegin();
+}
+
+boolean EAdaptiveReentrantLock::tryLock() {
+	if (!EReentrantLock::tryLock())
+		return false;
+	if (getHoldCount() == 1)
+		spin.holdBegin();
+	return true;
+}
+
+boolean EAdaptiveReentrantLock::tryLock(llong timeout, ETimeUnit* unit) {
+	if (isHeldByCurrentThread())
+		return EReentrantLock::tryLock(timeout, unit);
+	if (!spinAcquire() && !EReentrantLock::tryLock(timeout, unit))
+		return false;
+	spin.holdBegin();
+	return true;
+}
+
+void EAdaptiveReentrantLock::unlock() {
+	if (getHoldCount() == 1)
+		spin.holdEnd();
+	EReentrantLock::unlock();
+}
+
+ECondition* EAdaptiveReentrantLock::newCondition() {
+	return new Condition(this, EReentrantLock::newCondition());
+}
+
+boolean EAdaptiveReentrantLock::hasWaiters(ECondition* condition) {
+	if (condition == null)
+		throw ENullPointerException(__FILE__, __LINE__);
+	Condition* c = dynamic_cast<Condition*>(condition);
+	if (c == null || c->lock != this)
+		throw EIllegalArgumentException(__FILE__, __LINE__, "not owner");
+	return EReentrantLock::hasWaiters(c->cond);
+}
+
+int EAdaptiveReentrantLock::getWaitQueueLength(ECondition* condition) {
+	if (condition == null)
+		throw ENullPointerException(__FILE__, __LINE__);
+	Condition* c = dynamic_cast<Condition*>(condition);
+	if (c == null || c->lock != this)
+		throw EIllegalArgumentException(__FILE__, __LINE__, "not owner");
+	return EReentrantLock::getWaitQueueLength(c->cond);
+}
+
+ESpinControl* EAdaptiveReentrantLock::getSpinControl() {
+	return &spin;
+}
+
+EStringBase EAdaptiveReentrantLock::toString() {
+	return EReentrantLock::toString() + spin.toString();
+}
+
+} /* namespace efc */
@@ -0,0 +1,69 @@
+/*
+ * EAdaptiveSemaphore.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/EAdaptiveSemaphore.hh"
+#include "../../inc/EIllegalArgumentException.hh"
+
+namespace efc {
+
+EAdaptiveSemaphore::~EAdaptiveSemaphore() {
+}
+
+EAdaptiveSemaphore::EAdaptiveSemaphore(int permits, boolean fair,
+		ESpinControl::Policy policy, int maxSpins) :
+		ESemaphore(permits, fair), fair(fair), spin(policy, maxSpins) {
+}
+
+boolean EAdaptiveSemaphore::spinAcquire(int permits) {
+	if (permits < 0)
+		throw EIllegalArgumentException(__FILE__, __LINE__);
+	if (!fair && ESemaphore::tryAcquire(permits))
+		return true;
+	int budget = spin.budget();
+	if (budget == 0)
+		return false;
+	for (int i = 1; i <= budget; i++) {
+		ESpinControl::pause();
+		if (availablePermits() >= permits && (!fair || !hasQueuedThreads())
+				&& ESemaphore::tryAcquire(permits)) {
+			spin.spun(i, true);
+			return true;
+		}
+	}
+	spin.spun(budget, false);
+	return false;
+}
+
+void EAdaptiveSemaphore::acquire() {
+	if (!spinAcquire(1))
+		ESemaphore::acquire();
+}
+
+void EAdaptiveSemaphore::acquire(int permits) {
+	if (!spinAcquire(permits))
+		ESemaphore::acquire(permits);
+}
+
+void EAdaptiveSemaphore::acquireUninterruptibly() {
+	if (!spinAcquire(1))
+		ESemaphore::acquireUninterruptibly();
+}
+
+void EAdaptiveSemaphore::acquireUninterruptibly(int permits) {
+	if (!spinAcquire(permits))
+		ESemaphore::acquireUninterruptibly(permits);
+}
+
+ESpinControl* EAdaptiveSemaphore::getSpinControl() {
+	return &spin;
+}
+
+EStringBase EAdaptiveSemaphore::toString() {
+	return ESemaphore::toString() + spin.toString();
+}
+
+} /* namespace efc */
@@ -0,0 +1,98 @@
+/*
+ * EAffinityThreadFactory.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/EAffinityThreadFactory.hh"
+#include "../../inc/concurrent/EExecutors.hh"
+#include "../../inc/ERuntime.hh"
+#include "../../inc/ENullPointerException.hh"
+#include "../../inc/EIllegalArgumentException.hh"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace efc {
+
+/**
+ * The runnable given to the delegate factory.
+ */
+class PinnedRunnable: public ERunnable {
+public:
+	PinnedRunnable(sp<ERunnable> r, int cpu) : r(r), cpu(cpu) {
+	}
+	virtual void run() {
+		EAffinityThreadFactory::pinCurrentThread(cpu);
+		r->run();
+	}
+private:
+	sp<ERunnable> r;
+	int cpu;
+};
+
+static EA<int> allProcessors() {
+	int n = ERuntime::getRuntime()->availableProcessors();
+	EA<int> a(n > 0 ? n : 1);
+	for (int i = 0; i < a.length(); i++) {
+		a[i] = i;
+	}
+	return a;
+}
+
+EAffinityThreadFactory::~EAffinityThreadFactory() {
+}
+
+EAffinityThreadFactory::EAffinityThreadFactory() :
+		factory(EExecutors::defaultThreadFactory()), cpus(allProcessors()), next(0) {
+}
+
+EAffinityThreadFactory::EAffinityThreadFactory(sp<EThreadFactory> factory) :
+		factory(factory), cpus(allProcessors()), next(0) {
+	if (factory == null) {
+		throw ENullPointerException(__FILE__, __LINE__);
+	}
+}
+
+EAffinityThreadFactory::EAffinityThreadFactory(sp<EThreadFactory> factory,
+		EA<int>* cpus) : factory(factory), cpus(0), next(0) {
+	if (factory == null || cpus == null) {
+		throw ENullPointerException(__FILE__, __LINE__);
+	}
+	if (cpus->length() == 0) {
+		throw EIllegalArgumentException(__FILE__, __LINE__);
+	}
+	this->cpus = *cpus;
+}
+
+EThread* EAffinityThreadFactory::newThread(sp<ERunnable> r) {
+	int i = (eso_atomic_add_and_fetch32(&next, 1) - 1) & 0x7fffffff;
+	return factory->newThread(new PinnedRunnable(r, cpus[i % cpus.length()]));
+}
+
+boolean EAffinityThreadFactory::pinCurrentThread(int cpu) {
+	if (cpu < 0) {
+		return false;
+	}
+#if defined(__linux__)
+	if (cpu >= CPU_SETSIZE) {
+		return false;
+	}
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(WIN32)
+	if (cpu >= (int)(sizeof(DWORD_PTR) * 8)) {
+		return false;
+	}
+	return SetThreadAffinityMask(GetCurrentThread(), ((DWORD_PTR)1) << cpu) != 0;
+#else
+	return false;
+#endif
+}
+
+} /* namespace efc */
@@ -0,0 +1,622 @@
+/*
+ * ECompletableFuture.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/ECompletableFuture.hh"
+#include "../../inc/concurrent/EForkJoinPool.hh"
+#include "../../inc/concurrent/ELockSupport.hh"
+#include "../../inc/concurrent/EUnsafe.hh"
+#include "../../inc/concurrent/EOrderAccess.hh"
+#include "../../inc/ESimpleLock.hh"
+#include "../../inc/ECondition.hh"
+#include "../../inc/ESystem.hh"
+#include "../../inc/EThread.hh"
+#include "../../inc/EThreadLocalStorage.hh"
+
+namespace efc {
+
+namespace cf {
+
+/**
+ * Singleton delay scheduler, used only for starting and cancelling
+ * tasks: a single daemon thread waiting on the earliest deadline of
+ * a heap of timeouts.  Timeouts run on this thread, so they only
+ * complete futures and never block.
+ */
+class Delayer : public EThread {
+public:
+	DECLARE_STATIC_INITZZ;
+
+	static void delay(sp<Timeout>& t);
+
+	/**
+	 * Removes the given timeout from the heap, if still there.
+	 */
+	static void remove(Timeout* t);
+
+	virtual void run();
+
+private:
+	static ESimpleLock* lock;
+	static ECondition* available;
+	static sp<Timeout>* heap;   // binary heap ordered by deadline
+	static int capacity;
+	static int size;
+	static Delayer* thread;     // started on first use, never exits
+
+	static void offer(sp<Timeout>& t);
+	static sp<Timeout> poll();
+	static void removeAt(int i);
+	static void siftUp(int k, sp<Timeout>& t);
+	static void siftDown(int k, sp<Timeout>& t);
+
+	static boolean before(sp<Timeout>& a, sp<Timeout>& b) {
+		return a->deadline - b->deadline < 0L;
+	}
+};
+
+ESimpleLock* Delayer::lock = null;
+ECondition* Delayer::available = null;
+sp<Timeout>* Delayer::heap = null;
+int Delayer::capacity = 0;
+int Delayer::size = 0;
+Delayer* Delayer::thread = null;
+
+DEFINE_STATIC_INITZZ_BEGIN(Delayer)
+	lock = new ESimpleLock();
+	available = lock->newCondition();
+	capacity = 16;
+	heap = new sp<Timeout>[capacity];
+DEFINE_STATIC_INITZZ_END
+
+void Delayer::offer(sp<Timeout>& t) {
+	if (size >= capacity) {
+		sp<Timeout>* h = new sp<Timeout>[capacity << 1];
+		for (int i = 0; i < size; i++)
+			h[i] = heap[i];
+		delete[] heap;
+		heap = h;
+		capacity <<= 1;
+	}
+	siftUp(size++, t);
+}
+
+sp<Timeout> Delayer::poll() {
+	sp<Timeout> first = heap[0];
+	removeAt(0);
+	return first;
+}
+
+void Delayer::removeAt(int i) {
+	heap[i]->heapIndex = -1;
+	sp<Timeout> x = heap[--size];
+	heap[size] = null;
+	if (i < size) {
+		siftDown(i, x);
+		if (heap[i] == x)
+			siftUp(i, x);
+	}
+}
+
+void Delayer::siftUp(int k, sp<Timeout>& t) {
+	while (k > 0) {
+		int parent = (k - 1) >> 1;
+		if (!before(t, heap[parent]))
+			break;
+		heap[k] = heap[parent];
+		heap[k]->heapIndex = k;
+		k = parent;
+	}
+	heap[k] = t;
+	t->heapIndex = k;
+}
+
+void Delayer::siftDown(int k, sp<Timeout>& t) {
+	int half = size >> 1;
+	while (k < half) {
+		int child = (k << 1) + 1;
+		int right = child + 1;
+		if (right < size && before(heap[right], heap[child]))
+			child = right;
+		if (!before(heap[child], t))
+			break;
+		heap[k] = heap[child];
+		heap[k]->heapIndex = k;
+		k = child;
+	}
+	heap[k] = t;
+	t->heapIndex = k;
+}
+
+void Delayer::delay(sp<Timeout>& t) {
+	SYNCBLOCK(lock) {
+		if (thread == null) {
+			thread = new Delayer();
+			thread->setDaemon(true);
+			thread->setName("CompletableFutureDelayScheduler");
+			thread->start();
+		}
+		offer(t);
+		if (heap[0] == t)
+			available->signal();
+	}}
+}
+
+void Delayer::remove(Timeout* t) {
+	SYNCBLOCK(lock) {
+		int i = t->heapIndex;
+		if (i >= 0 && i < size && heap[i].get() == t)
+			removeAt(i);
+	}}
+}
+
+void Delayer::run() {
+	for (;;) {
+		sp<Timeout> t;
+		SYNCBLOCK(lock) {
+			for (;;) {
+				if (size == 0) {
+					available->awaitUninterruptibly();
+					continue;
+				}
+				llong nanos = heap[0]->deadline - ESystem::nanoTime();
+				if (nanos <= 0L) {
+					t = poll();
+					break;
+				}
+				available->awaitNanos(nanos);
+			}
+		}}
+		try {
+			t->run();
+		} catch (...) {
+		}
+	}
+}
+
+/**
+ * Dependents still to be fired by the outermost completion running
+ * on this thread.  A future completed while dependents are being
+ * fired only queues its own dependents here, so that a long chain of
+ * synchronous stages is completed by a loop instead of recursing
+ * once per stage.
+ */
+class Trampoline {
+public:
+	DECLARE_STATIC_INITZZ;
+
+	static EThreadLocalStorage* current;
+
+	struct Batch {
+		sp<ECompletableFutureType> src;
+		sp<Completion> list;    // in firing order
+		Batch* next;
+	};
+
+	Batch* head;
+	Batch* tail;
+
+	Trampoline() : head(null), tail(null) {
+	}
+
+	~Trampoline() {
+		while (head != null) {
+			Batch* b = head;
+			head = b->next;
+			delete b;
+		}
+	}
+
+	void add(sp<ECompletableFutureType>& src, sp<Completion>& list) {
+		Batch* b = new Batch();
+		b->src = src;
+		b->list = list;
+		b->next = null;
+		if (tail == null)
+			head = b;
+		else
+			tail->next = b;
+		tail = b;
+	}
+};
+
+EThreadLocalStorage* Trampoline::current = null;
+
+DEFINE_STATIC_INITZZ_BEGIN(Trampoline)
+	current = new EThreadLocalStorage();
+DEFINE_STATIC_INITZZ_END
+
+//=============================================================================
+
+Timeout::~Timeout() {
+}
+
+Timeout::Timeout(sp<ECompletableFutureType> f) :
+		state(0), heapIndex(-1), deadline(0L), f(f) {
+}
+
+void Timeout::run() {
+	if (EUnsafe::compareAndSwapInt(&state, 0, 1)) {
+		sp<ECompletableFutureType> g = f;
+		f = null;
+		if (g != null)
+			onTimeout(g.get());
+	}
+}
+
+void Timeout::cancel() {
+	if (EUnsafe::compareAndSwapInt(&state, 0, 2)) {
+		f = null;
+		Delayer::remove(this);
+	}
+}
+
+void Timeout::delay(sp<Timeout> t, llong nanos) {
+	t->deadline = ESystem::nanoTime() + nanos;
+	Delayer::delay(t);
+}
+
+void Timeout::onTimeout(ECompletableFutureType* f) {
+	ETimeoutException ex(__FILE__, __LINE__);
+	f->completeExceptionally(ex);
+}
+
+/**
+ * Shared state of allOf: the inputs still pending, and the first
+ * exception observed.
+ */
+class AllOf : public EObject {
+public:
+	AllOf(sp<ECompletableFuture<EObject> >& dst, int n) :
+			dst(dst), pending(n), failed(0) {
+	}
+
+	void arrive(ECompletableFutureType* src) {
+		sp<EThrowable> x = src->getException();
+		if (x != null && EUnsafe::compareAndSwapInt(&failed, 0, 1))
+			this->x = x;
+		if (eso_atomic_add_and_fetch32(&pending, -1) == 0) {
+			if (this->x != null)
+				dst->completeExceptionally(*this->x);
+			else
+				dst->complete(null);
+			dst = null;
+		}
+	}
+
+private:
+	sp<ECompletableFuture<EObject> > dst;
+	volatile es_int32_t pending;
+	volatile int failed;
+	sp<EThrowable> x;
+};
+
+class AllRelay : public Completion {
+public:
+	AllRelay(sp<AllOf>& all) : Completion(null), all(all) {
+	}
+	virtual boolean capture(ECompletableFutureType* src) {
+		all->arrive(src);
+		all = null;
+		return false;
+	}
+	virtual void run() {
+	}
+	virtual void reject(EThrowable& ex) {
+	}
+private:
+	sp<AllOf> all;
+};
+
+class AnyRelay : public Completion {
+public:
+	AnyRelay(sp<ECompletableFuture<EObject> >& dst) : Completion(null), dst(dst) {
+	}
+	virtual boolean capture(ECompletableFutureType* src) {
+		sp<EThrowable> x = src->getException();
+		if (x != null)
+			dst->completeExceptionally(*x);
+		else
+			dst->complete(src->rawResult());
+		dst = null;
+		return false;
+	}
+	virtual void run() {
+	}
+	virtual void reject(EThrowable& ex) {
+	}
+private:
+	sp<ECompletableFuture<EObject> > dst;
+};
+
+} /* namespace cf */
+
+//=============================================================================
+
+ECompletableFutureType::~ECompletableFutureType() {
+	// no waiters are left: they only leave awaitDone() unlinked.
+}
+
+ECompletableFutureType::ECompletableFutureType() :
+		status(NEW), waitLock(0), waiters(null) {
+}
+
+boolean ECompletableFutureType::isDone() {
+	return status >= NORMAL;
+}
+
+boolean ECompletableFutureType::isCancelled() {
+	return status == CANCELLED;
+}
+
+boolean ECompletableFutureType::isCompletedExceptionally() {
+	return status > NORMAL;
+}
+
+boolean ECompletableFutureType::completeExceptionally(EThrowable& ex) {
+	return completeThrowable(copyOf(ex));
+}
+
+boolean ECompletableFutureType::cancel(boolean mayInterruptIfRunning) {
+	boolean cancelled = (status == NEW) && completeThrowable(
+			sp<EThrowable>(new ECancellationException(__FILE__, __LINE__)), CANCELLED);
+	return cancelled || isCancelled();
+}
+
+sp<EThrowable> ECompletableFutureType::getException() {
+	return (EOrderAccess::load_acquire(&status) > NORMAL) ? exception : null;
+}
+
+int ECompletableFutureType::getNumberOfDependents() {
+	int count = 0;
+	lockWaiters();
+	for (cf::Completion* p = stack.get(); p != null; p = p->next.get())
+		++count;
+	unlockWaiters();
+	return count;
+}
+
+sp<ECompletableFuture<EObject> > ECompletableFutureType::allOf(
+		ECollection<sp<ECompletableFutureType> >* cfs) {
+	if (cfs == null)
+		throw ENullPointerException(__FILE__, __LINE__);
+	sp<ECompletableFuture<EObject> > d = new ECompletableFuture<EObject>();
+	int n = cfs->size();
+	if (n == 0) {
+		d->complete(null);
+		return d;
+	}
+	sp<cf::AllOf> all = new cf::AllOf(d, n);
+	sp<EIterator<sp<ECompletableFutureType> > > it = cfs->iterator();
+	while (it->hasNext()) {
+		sp<ECompletableFutureType> f = it->next();
+		if (f == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		f->push(sp<cf::Completion>(new cf::AllRelay(all)));
+	}
+	return d;
+}
+
+sp<ECompletableFuture<EObject> > ECompletableFutureType::anyOf(
+		ECollection<sp<ECompletableFutureType> >* cfs) {
+	if (cfs == null)
+		throw ENullPointerException(__FILE__, __LINE__);
+	sp<ECompletableFuture<EObject> > d = new ECompletableFuture<EObject>();
+	sp<EIterator<sp<ECompletableFutureType> > > it = cfs->iterator();
+	while (it->hasNext() && d->status == NEW) {
+		sp<ECompletableFutureType> f = it->next();
+		if (f == null)
+			throw ENullPointerException(__FILE__, __LINE__);
+		f->push(sp<cf::Completion>(new cf::AnyRelay(d)));
+	}
+	return d;
+}
+
+EExecutor* ECompletableFutureType::defaultExecutor() {
+	return EForkJoinPool::commonPool();
+}
+
+boolean ECompletableFutureType::beginCompletion() {
+	return EUnsafe::compareAndSwapInt(&status, NEW, COMPLETING);
+}
+
+void ECompletableFutureType::endCompletion(int state) {
+	sp<cf::Completion> h;
+	lockWaiters();
+	EOrderAccess::release_store(&status, state);
+	h = stack;
+	stack = null;
+	// waiters unlink themselves under the lock, so they are still
+	// alive while we hold it.
+	for (WaitNode* q = waiters; q != null; q = q->next) {
+		EThread* t = q->thread;
+		if (t != null) {
+			q->thread = null;
+			ELockSupport::unpark(t);
+		}
+	}
+	waiters = null;
+	unlockWaiters();
+
+	if (h == null)
+		return;
+
+	// fire dependents in the order they were pushed.
+	sp<cf::Completion> r;
+	while (h != null) {
+		sp<cf::Completion> n = h->next;
+		h->next = r;
+		r = h;
+		h = n;
+	}
+
+	sp<ECompletableFutureType> self = weak_this_.lock();
+	cf::Trampoline* t = (cf::Trampoline*)cf::Trampoline::current->get();
+	if (t != null && self != null) {
+		// fired by a dependent of another future: leave them to the
+		// outermost loop on this thread.
+		t->add(self, r);
+		return;
+	}
+
+	cf::Trampoline local;
+	if (t == null)
+		cf::Trampoline::current->set(&local);
+	try {
+		ECompletableFutureType* src = this;
+		for (;;) {
+			while (r != null) {
+				sp<cf::Completion> n = r->next;
+				r->next = null;
+				src->fire(r);
+				r = n;
+			}
+			if (t != null || local.head == null)
+				break;
+			cf::Trampoline::Batch* b = local.head;
+			local.head = b->next;
+			if (local.head == null)
+				local.tail = null;
+			self = b->src;
+			r = b->list;
+			src = self.get();
+			delete b;
+		}
+	} catch (...) {
+		if (t == null)
+			cf::Trampoline::current->set(null);
+		throw;
+	}
+	if (t == null)
+		cf::Trampoline::current->set(null);
+}
+
+boolean ECompletableFutureType::completeThrowable(sp<EThrowable> x, int state) {
+	if (!beginCompletion())
+		return false;
+	exception = x;
+	endCompletion(state);
+	return true;
+}
+
+void ECompletableFutureType::push(sp<cf::Completion> c) {
+	lockWaiters();
+	if (status < NORMAL) {
+		c->next = stack;
+		stack = c;
+		unlockWaiters();
+		return;
+	}
+	unlockWaiters();
+	fire(c);
+}
+
+void ECompletableFutureType::fire(sp<cf::Completion> c) {
+	if (!c->capture(this))
+		return;
+	if (c->executor == null) {
+		c->run();
+		return;
+	}
+	try {
+		c->executor->execute(c);
+	} catch (EThrowable& ex) {
+		c->reject(ex);
+	}
+}
+
+int ECompletableFutureType::awaitDone(boolean interruptible, boolean timed,
+		llong nanos) {
+	int s = status;
+	if (s >= NORMAL)
+		return s;
+	if (timed && nanos <= 0L)
+		return s;
+	llong deadline = timed ? ESystem::nanoTime() + nanos : 0L;
+	WaitNode q;
+	q.thread = EThread::currentThread();
+	q.next = null;
+	lockWaiters();
+	if ((s = status) < NORMAL) {
+		q.next = waiters;
+		waiters = &q;
+	}
+	unlockWaiters();
+	if (s >= NORMAL)
+		return s;
+
+	boolean interrupted = false;
+	while ((s = EOrderAccess::load_acquire(&status)) < NORMAL) {
+		if (EThread::interrupted()) {
+			interrupted = true;
+			if (interruptible)
+				break;
+		}
+		else if (timed) {
+			nanos = deadline - ESystem::nanoTime();
+			if (nanos <= 0L)
+				break;
+			ELockSupport::parkNanos(nanos);
+		}
+		else
+			ELockSupport::park();
+	}
+
+	lockWaiters();
+	for (WaitNode** p = &waiters; *p != null; p = &(*p)->next) {
+		if (*p == &q) {
+			*p = q.next;
+			break;
+		}
+	}
+	unlockWaiters();
+
+	if (interrupted) {
+		if (interruptible && s < NORMAL)
+			throw EInterruptedException(__FILE__, __LINE__);
+		EThread::currentThread()->interrupt();
+	}
+	return s;
+}
+
+void ECompletableFutureType::reportGet(int s) {
+	if (s == CANCELLED)
+		throw ECancellationException(__FILE__, __LINE__);
+	EThrowable* t = exception.get();
+	if (t) {
+		throw EExecutionException(t->getSourceFile(), t->getSourceLine(), t->getMessage());
+	}
+	else {
+		throw EExecutionException(__FILE__, __LINE__);
+	}
+}
+
+void ECompletableFutureType::reportJoin(int s) {
+	if (s == CANCELLED)
+		throw ECancellationException(__FILE__, __LINE__);
+	EThrowable* t = exception.get();
+	if (t) {
+		throw ECompletionException(t->getSourceFile(), t->getSourceLine(), t->getMessage());
+	}
+	else {
+		throw ECompletionException(__FILE__, __LINE__);
+	}
+}
+
+sp<EThrowable> ECompletableFutureType::copyOf(EThrowable& ex) {
+	return new EThrowable(ex.getSourceFile(), ex.getSourceLine(), ex.getMessage());
+}
+
+void ECompletableFutureType::lockWaiters() {
+	while (!EUnsafe::compareAndSwapInt(&waitLock, 0, 1))
+		EThread::yield();
+}
+
+void ECompletableFutureType::unlockWaiters() {
+	EOrderAccess::release_store(&waitLock, 0);
+}
+
+} /* namespace efc */
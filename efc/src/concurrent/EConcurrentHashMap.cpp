@@ -0,0 +1,139 @@
+/*
+ * EConcurrentHashMap.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/EConcurrentHashMap.hh"
+#include "../../inc/concurrent/EThreadLocalRandom.hh"
+#include "../../inc/ERuntime.hh"
+
+namespace efc {
+namespace chm {
+
+/**
+ * Reader counts for one stripe, one per epoch parity, on their
+ * own cache line.
+ */
+struct Reclaimer::Stripe {
+	volatile int active[2];
+	char pad[ES_CACHE_LINE_SIZE - 2 * sizeof(int)];
+};
+
+struct Reclaimer::Retired {
+	void* p;
+	Deleter d;
+	Retired* next;
+};
+
+/**
+ * Number of retired objects that triggers a reclamation pass.
+ */
+static const int RECLAIM_THRESHOLD = 128;
+
+/**
+ * Upper bound for reader stripes per map.
+ */
+static const int MAX_STRIPES = 32;
+
+static volatile int ncpu = 0;
+
+void Reclaimer::freeAll(Retired* list) {
+	for (Retired* e = list, *next; e != null; e = next) {
+		next = e->next;
+		e->d(e->p);
+		eso_free(e);
+	}
+}
+
+Reclaimer::~Reclaimer() {
+	freeAll(retired);
+	eso_free(stripes);
+}
+
+Reclaimer::Reclaimer() :
+		epoch(0), reclaiming(0), retired(null), pending(0) {
+	int n = 1;
+	int c = getNCPU();
+	while (n < c && n < MAX_STRIPES)
+		n <<= 1;
+	stripes = (Stripe*)eso_calloc(n * sizeof(Stripe));
+	mask = n - 1;
+}
+
+int Reclaimer::enter() {
+	int h = EThreadLocalRandom::getProbe();
+	if (h == 0) {
+		EThreadLocalRandom::localInit();
+		h = EThreadLocalRandom::getProbe();
+	}
+	int i = h & mask;
+	Stripe* s = &stripes[i];
+	for (;;) {
+		int e = EOrderAccess::load_acquire(&epoch);
+		eso_atomic_add_and_fetch32(&s->active[e & 1], 1);
+		// a reclaimer that flipped the epoch meanwhile may already
+		// have scanned this stripe, so back out and use the new parity
+		if (EOrderAccess::load_acquire(&epoch) == e)
+			return (i << 1) | (e & 1);
+		eso_atomic_add_and_fetch32(&s->active[e & 1], -1);
+	}
+}
+
+void Reclaimer::exit(int slot) {
+	eso_atomic_add_and_fetch32(&stripes[slot >> 1].active[slot & 1], -1);
+	if (pending >= RECLAIM_THRESHOLD)
+		reclaim();
+}
+
+void Reclaimer::retire(void* p, Deleter d) {
+	Retired* r = (Retired*)eso_malloc(sizeof(Retired));
+	r->p = p;
+	r->d = d;
+	do {
+		r->next = retired;
+	} while (!EUnsafe::compareAndSwapObject(&retired, r->next, r));
+	eso_atomic_add_and_fetch32(&pending, 1);
+}
+
+void Reclaimer::reclaim() {
+	if (!EUnsafe::compareAndSwapInt(&reclaiming, 0, 1))
+		return;
+
+	Retired* list;
+	do {
+		list = retired;
+	} while (!EUnsafe::compareAndSwapObject(&retired, list, null));
+	int n = 0;
+	for (Retired* e = list; e != null; e = e->next)
+		n++;
+	eso_atomic_add_and_fetch32(&pending, -n);
+
+	// everything in list was unlinked before the flip, so only
+	// sections of the old parity can still reference it
+	int e = epoch;
+	EOrderAccess::release_store(&epoch, e + 1);
+	EUnsafe::fullFence();
+	for (int i = 0; i <= mask; i++) {
+		while (EOrderAccess::load_acquire(&stripes[i].active[e & 1]) != 0)
+			EThread::yield();
+	}
+
+	freeAll(list);
+	EOrderAccess::release_store(&reclaiming, 0);
+}
+
+int Reclaimer::getNCPU() {
+	int n = ncpu;
+	if (n == 0) {
+		n = ERuntime::getRuntime()->availableProcessors();
+		if (n <= 0)
+			n = 1;
+		ncpu = n;
+	}
+	return n;
+}
+
+} /* namespace chm */
+} /* namespace efc */
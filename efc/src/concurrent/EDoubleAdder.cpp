@@ -0,0 +1,108 @@
+/*
+ * EDoubleAdder.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/EDoubleAdder.hh"
+#include "../../inc/concurrent/EThreadLocalRandom.hh"
+#include "../../inc/concurrent/EOrderAccess.hh"
+#include "../../inc/EDouble.hh"
+
+namespace efc {
+
+/*
+ * Note that we must use "llong" for underlying representations,
+ * because there is no compareAndSet for double, due to the fact that
+ * the bitwise equals used in any CAS implementation is not the
+ * same as double-precision equals.  However, we use CAS only to
+ * detect and alleviate contention, for which bitwise equals works
+ * best anyway. In principle, the llong/double conversions used here
+ * should be essentially free on most platforms since they just
+ * re-interpret bits.
+ */
+
+EDoubleAdder::~EDoubleAdder() {
+}
+
+EDoubleAdder::EDoubleAdder() {
+}
+
+void EDoubleAdder::add(double x) {
+	Cells* as; llong b, v; int m; Cell* a;
+	if ((as = (Cells*)EOrderAccess::load_ptr_acquire(&cells)) != null ||
+			!((b = base), casBase(b, doubleToRawBits(rawBitsToDouble(b) + x)))) {
+		boolean uncontended = true;
+		if (as == null || (m = as->length - 1) < 0 ||
+				(a = (Cell*)EOrderAccess::load_ptr_acquire(
+						&as->cells[EThreadLocalRandom::getProbe() & m])) == null ||
+				!(uncontended = ((v = a->value),
+						a->cas(v, doubleToRawBits(rawBitsToDouble(v) + x)))))
+			doubleAccumulate(x, uncontended);
+	}
+}
+
+double EDoubleAdder::sum() {
+	Cells* as = (Cells*)EOrderAccess::load_ptr_acquire(&cells);
+	double sum = rawBitsToDouble(base);
+	if (as != null) {
+		for (int i = 0; i < as->length; ++i) {
+			Cell* a = (Cell*)EOrderAccess::load_ptr_acquire(&as->cells[i]);
+			if (a != null)
+				sum += rawBitsToDouble(a->value);
+		}
+	}
+	return sum;
+}
+
+void EDoubleAdder::reset() {
+	Cells* as = (Cells*)EOrderAccess::load_ptr_acquire(&cells);
+	base = 0L; // relies on fact that double 0 must have same rep as long
+	if (as != null) {
+		for (int i = 0; i < as->length; ++i) {
+			Cell* a = (Cell*)EOrderAccess::load_ptr_acquire(&as->cells[i]);
+			if (a != null)
+				a->value = 0L;
+		}
+	}
+}
+
+double EDoubleAdder::sumThenReset() {
+	Cells* as = (Cells*)EOrderAccess::load_ptr_acquire(&cells);
+	double sum = rawBitsToDouble(base);
+	base = 0L;
+	if (as != null) {
+		for (int i = 0; i < as->length; ++i) {
+			Cell* a = (Cell*)EOrderAccess::load_ptr_acquire(&as->cells[i]);
+			if (a != null) {
+				llong v = a->value;
+				a->value = 0L;
+				sum += rawBitsToDouble(v);
+			}
+		}
+	}
+	return sum;
+}
+
+EStringBase EDoubleAdder::toString() {
+	return EDouble::toString(sum());
+}
+
+double EDoubleAdder::doubleValue() {
+	return sum();
+}
+
+llong EDoubleAdder::llongValue() {
+	return (llong)sum();
+}
+
+int EDoubleAdder::intValue() {
+	return (int)sum();
+}
+
+float EDoubleAdder::floatValue() {
+	return (float)sum();
+}
+
+} /* namespace efc */
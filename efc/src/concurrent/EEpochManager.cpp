@@ -0,0 +1,335 @@
+/*
+ * EEpochManager.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/EEpochManager.hh"
+#include "../../inc/concurrent/EOrderAccess.hh"
+#include "../../inc/concurrent/EUnsafe.hh"
+
+namespace efc {
+
+/**
+ * Number of objects retired by a thread that triggers a reclamation
+ * pass on its next exit or retire.
+ */
+static const int RECLAIM_THRESHOLD = 128;
+
+/**
+ * Retired objects per allocation block.
+ */
+#define BLOCK_SIZE 126
+
+/**
+ * Low bit of Record::state: the thread is in a read section.
+ */
+static const llong ACTIVE = 1L;
+
+struct Retired {
+	void* p;
+	EEpochManager::Deleter d;
+};
+
+struct Block {
+	Block* next;
+	int count;
+	Retired items[BLOCK_SIZE];
+};
+
+/**
+ * Objects retired during one epoch.
+ */
+struct EEpochManager::Bag {
+	llong epoch;
+	int count;
+	Block* blocks;
+	Bag* next; // orphan list only
+};
+
+/**
+ * Per-thread registration.  Records are never freed; a record whose
+ * thread terminated is reused by the next thread that registers.
+ */
+struct EEpochManager::Record {
+	volatile llong state; // (announced epoch << 1) | ACTIVE
+	char pad[ES_CACHE_LINE_SIZE - sizeof(llong)];
+	volatile int inUse;
+	int nest;
+	int pending;
+	Record* next;
+	Bag bags[3];
+};
+
+/**
+ * Thread-local value owning the record of its thread.
+ */
+class EEpochManager::Lease: public EObject {
+public:
+	Record* record;
+
+	Lease(Record* r) : record(r) {
+	}
+	virtual ~Lease() {
+		EEpochManager::getInstance()->releaseRecord(record);
+	}
+};
+
+class EEpochManager::Participant: public EThreadLocal {
+public:
+	virtual EObject* initialValue() {
+		return new Lease(EEpochManager::getInstance()->acquireRecord());
+	}
+};
+
+static EEpochManager* volatile instance = null;
+
+EEpochManager* EEpochManager::getInstance() {
+	EEpochManager* m = (EEpochManager*)EOrderAccess::load_ptr_acquire(&instance);
+	if (m == null) {
+		EEpochManager* n = new EEpochManager();
+		if (EUnsafe::compareAndSwapObject(&instance, null, n)) {
+			m = n;
+		} else {
+			delete n;
+			m = (EEpochManager*)EOrderAccess::load_ptr_acquire(&instance);
+		}
+	}
+	return m;
+}
+
+EEpochManager::~EEpochManager() {
+	delete local;
+}
+
+EEpochManager::EEpochManager() :
+		epoch(0), records(null), orphans(null), orphanCount(0) {
+	local = new EThreadLocalVariable<Participant, Lease>();
+}
+
+EEpochManager::Record* EEpochManager::current() {
+	return local->get()->record;
+}
+
+EEpochManager::Record* EEpochManager::enterRecord() {
+	Record* r = current();
+	if (r->nest++ == 0) {
+		llong e = EOrderAccess::load_acquire(&epoch);
+		// the announcement must be visible before any shared pointer is read
+		EOrderAccess::release_store_fence(&r->state, (e << 1) | ACTIVE);
+	}
+	return r;
+}
+
+void EEpochManager::exitRecord(Record* r) {
+	if (r->nest <= 0) {
+		throw EIllegalStateException(__FILE__, __LINE__, "not in a read section");
+	}
+	if (--r->nest == 0) {
+		EOrderAccess::release_store(&r->state, r->state & ~ACTIVE);
+		if (r->pending >= RECLAIM_THRESHOLD) {
+			collect(r);
+		}
+	}
+}
+
+void EEpochManager::enter() {
+	enterRecord();
+}
+
+void EEpochManager::exit() {
+	exitRecord(current());
+}
+
+boolean EEpochManager::inCriticalSection() {
+	return current()->nest > 0;
+}
+
+void EEpochManager::retire(void* p, Deleter d) {
+	if (p == null) {
+		return;
+	}
+	Record* r = current();
+	llong e = EOrderAccess::load_acquire(&epoch);
+	Bag* b = &r->bags[e % 3];
+	if (b->epoch != e) {
+		// the slot last held epoch e - 3 or older, which is safe now
+		if (b->count > 0) {
+			r->pending -= b->count;
+			freeBag(b);
+		}
+		b->epoch = e;
+	}
+	Block* k = b->blocks;
+	if (k == null || k->count == BLOCK_SIZE) {
+		Block* n = (Block*)eso_malloc(sizeof(Block));
+		n->next = k;
+		n->count = 0;
+		b->blocks = k = n;
+	}
+	Retired* x = &k->items[k->count++];
+	x->p = p;
+	x->d = d;
+	b->count++;
+	if (++r->pending >= RECLAIM_THRESHOLD && r->nest == 0) {
+		collect(r);
+	}
+}
+
+void EEpochManager::reclaim() {
+	Record* r = current();
+	collect(r);
+	collectOrphans(EOrderAccess::load_acquire(&epoch));
+}
+
+void EEpochManager::barrier() {
+	Record* r = current();
+	if (r->nest > 0) {
+		throw EIllegalStateException(__FILE__, __LINE__, "barrier in a read section");
+	}
+	while (r->pending > 0 || orphans != null) {
+		collect(r);
+		if (r->pending > 0 || orphans != null) {
+			EThread::yield();
+		}
+	}
+}
+
+llong EEpochManager::getEpoch() {
+	return EOrderAccess::load_acquire(&epoch);
+}
+
+int EEpochManager::getRegisteredThreads() {
+	int n = 0;
+	for (Record* r = records; r != null; r = r->next) {
+		if (r->inUse) {
+			n++;
+		}
+	}
+	return n;
+}
+
+llong EEpochManager::getPendingCount() {
+	llong n = orphanCount;
+	for (Record* r = records; r != null; r = r->next) {
+		n += r->pending;
+	}
+	return n;
+}
+
+EStringBase EEpochManager::toString() {
+	return EStringBase::formatOf("%s[epoch = %lld, threads = %d, pending = %lld]",
+			"EEpochManager", getEpoch(), getRegisteredThreads(), getPendingCount());
+}
+
+EEpochManager::Record* EEpochManager::acquireRecord() {
+	for (Record* r = records; r != null; r = r->next) {
+		if (r->inUse == 0 && EUnsafe::compareAndSwapInt(&r->inUse, 0, 1)) {
+			return r;
+		}
+	}
+	Record* r = (Record*)eso_calloc(sizeof(Record));
+	r->inUse = 1;
+	do {
+		r->next = records;
+	} while (!EUnsafe::compareAndSwapObject(&records, r->next, r));
+	return r;
+}
+
+void EEpochManager::releaseRecord(Record* r) {
+	// hand unfreed objects over to the surviving threads
+	for (int i = 0; i < 3; i++) {
+		Bag* b = &r->bags[i];
+		if (b->count > 0) {
+			Bag* o = (Bag*)eso_malloc(sizeof(Bag));
+			*o = *b;
+			eso_atomic_add_and_fetch32(&orphanCount, o->count);
+			do {
+				o->next = orphans;
+			} while (!EUnsafe::compareAndSwapObject(&orphans, o->next, o));
+			b->count = 0;
+			b->blocks = null;
+		} else if (b->blocks != null) {
+			freeBag(b);
+			eso_free(b->blocks);
+			b->blocks = null;
+		}
+	}
+	r->nest = 0;
+	r->pending = 0;
+	EOrderAccess::release_store(&r->state, 0);
+	EOrderAccess::release_store(&r->inUse, 0);
+}
+
+boolean EEpochManager::tryAdvance() {
+	llong e = EOrderAccess::load_acquire(&epoch);
+	EUnsafe::fullFence();
+	for (Record* r = records; r != null; r = r->next) {
+		llong s = EOrderAccess::load_acquire(&r->state);
+		if ((s & ACTIVE) != 0 && (s >> 1) != e) {
+			return false;
+		}
+	}
+	return EUnsafe::compareAndSwapLLong(&epoch, e, e + 1);
+}
+
+void EEpochManager::collect(Record* r) {
+	tryAdvance();
+	llong e = EOrderAccess::load_acquire(&epoch);
+	for (int i = 0; i < 3; i++) {
+		Bag* b = &r->bags[i];
+		if (b->count > 0 && b->epoch + 2 <= e) {
+			r->pending -= b->count;
+			freeBag(b);
+		}
+	}
+	if (orphans != null) {
+		collectOrphans(e);
+	}
+}
+
+void EEpochManager::collectOrphans(llong e) {
+	Bag* list = (Bag*)eso_atomic_test_and_setptr((volatile es_intptr_t*)&orphans, null);
+	while (list != null) {
+		Bag* o = list;
+		list = o->next;
+		if (o->epoch + 2 <= e) {
+			eso_atomic_sub_and_fetch32(&orphanCount, o->count);
+			freeBag(o);
+			eso_free(o->blocks);
+			eso_free(o);
+		} else {
+			do {
+				o->next = orphans;
+			} while (!EUnsafe::compareAndSwapObject(&orphans, o->next, o));
+		}
+	}
+}
+
+void EEpochManager::freeBag(Bag* b) {
+	// detach first: a deleter may retire further objects
+	Block* k = b->blocks;
+	b->blocks = null;
+	b->count = 0;
+	Block* keep = null;
+	while (k != null) {
+		for (int i = 0; i < k->count; i++) {
+			k->items[i].d(k->items[i].p);
+		}
+		Block* next = k->next;
+		if (keep == null) {
+			keep = k;
+		} else {
+			eso_free(k);
+		}
+		k = next;
+	}
+	if (keep != null) {
+		keep->count = 0;
+		keep->next = b->blocks;
+		b->blocks = keep;
+	}
+}
+
+} /* namespace efc */
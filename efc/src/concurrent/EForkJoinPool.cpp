@@ -0,0 +1,844 @@
+/*
+ * EForkJoinPool.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/EForkJoinPool.hh"
+#include "../../inc/concurrent/ELockSupport.hh"
+#include "../../inc/concurrent/EUnsafe.hh"
+#include "../../inc/concurrent/EOrderAccess.hh"
+#include "../../inc/EThread.hh"
+#include "../../inc/ESystem.hh"
+#include "../../inc/ERuntime.hh"
+#include "../../inc/ESentry.hh"
+#include "../../inc/EInteger.hh"
+#include "../../inc/EIllegalStateException.hh"
+
+namespace efc {
+
+namespace fjp {
+
+/**
+ * Circular task buffer.  When a queue grows, thieves may still be
+ * reading the replaced buffer, so replaced buffers are chained through
+ * {@code prev} and only released together with their queue.
+ */
+struct TaskArray {
+	int length;
+	TaskArray* prev;
+	EForkJoinTaskType* volatile slots[1];
+
+	static TaskArray* create(int length, TaskArray* prev) {
+		TaskArray* a = (TaskArray*)eso_calloc(sizeof(TaskArray) +
+				(length - 1) * sizeof(EForkJoinTaskType*));
+		a->length = length;
+		a->prev = prev;
+		return a;
+	}
+
+	static void destroy(TaskArray* a) {
+		while (a != null) {
+			TaskArray* p = a->prev;
+			eso_free(a);
+			a = p;
+		}
+	}
+};
+
+/**
+ * Queues supporting work-stealing as well as external task
+ * submission.  Only the owner (or, for shared queues, the holder of
+ * qlock) pushes at top; pops at top and polls at base claim the slot
+ * by CAS so that the owner and thieves never take the same task.
+ */
+class WorkQueue {
+public:
+	/**
+	 * Capacity of work-stealing queue array upon initialization.
+	 * Must be a power of two.
+	 */
+	static const int INITIAL_QUEUE_CAPACITY = 1 << 13;
+
+	/**
+	 * Maximum size for queue arrays. Must be a power of two less
+	 * than or equal to 1 << (31 - width of array entry) to ensure
+	 * lack of wraparound of index calculations.
+	 */
+	static const int MAXIMUM_QUEUE_CAPACITY = 1 << 26; // 64M
+
+	char pad0[ES_CACHE_LINE_SIZE];                 // keep hot fields off neighbours' lines
+	volatile int qlock;            // 1: locked, 0: unlocked
+	volatile int base;             // index of next slot for poll
+	volatile int top;              // index of next slot for push
+	TaskArray* volatile array;     // the elements (initially unallocated)
+	EForkJoinPool* pool;           // the containing pool
+	EForkJoinWorkerThread* owner;  // owning thread or null if shared
+	int poolIndex;                 // index of this queue in pool
+	int hint;                      // randomization and stealer index hint
+	volatile int nsteals;          // number of steals, owner written
+	WorkQueue* nextIdle;           // idle stack link, guarded by mainLock
+	boolean idle;                  // on idle stack, guarded by mainLock
+	char pad1[ES_CACHE_LINE_SIZE];
+
+	WorkQueue(EForkJoinPool* pool, int poolIndex) :
+			qlock(0), base(INITIAL_QUEUE_CAPACITY >> 1),
+			top(INITIAL_QUEUE_CAPACITY >> 1), array(null), pool(pool),
+			owner(null), poolIndex(poolIndex), hint(poolIndex * 0x9e3779b9 | 1),
+			nsteals(0), nextIdle(null), idle(false) {
+		// Place indices in the center of array (that is not yet allocated)
+	}
+
+	~WorkQueue() {
+		TaskArray::destroy(array);
+	}
+
+	int queueSize() {
+		int n = base - top;       // non-owner callers must read base first
+		return (n >= 0) ? 0 : -n; // ignore transient negative
+	}
+
+	boolean isEmpty() {
+		return base - top >= 0;
+	}
+
+	/**
+	 * Xorshift step for randomized scans.
+	 */
+	int nextHint() {
+		int r = hint;
+		r ^= r << 13; r ^= (int)((unsigned)r >> 17); r ^= r << 5;
+		hint = r;
+		return r & 0x7fffffff;
+	}
+
+	boolean tryLock() {
+		return qlock == 0 && EUnsafe::compareAndSwapInt(&qlock, 0, 1);
+	}
+
+	void lock() {
+		while (!tryLock()) {
+			EThread::yield();
+		}
+	}
+
+	void unlock() {
+		EOrderAccess::release_store(&qlock, 0);
+	}
+
+	/**
+	 * Pushes a task. Call only by owner in unshared queues, or
+	 * holding qlock in shared ones.
+	 *
+	 * @return the number of tasks that were queued before the push
+	 */
+	int push(EForkJoinTaskType* task) {
+		TaskArray* a = array;
+		if (a == null)
+			a = growArray();
+		int s = top, n;
+		int m = a->length - 1;
+		EOrderAccess::release_store_ptr(&a->slots[s & m], task);
+		EOrderAccess::release_store(&top, s + 1);
+		if ((n = s - base) >= m)
+			growArray();
+		return n;
+	}
+
+	/**
+	 * Initializes or doubles the capacity of array. Call either
+	 * by owner or with lock held -- it is OK for base, but not
+	 * top, to move while resizings are in progress.
+	 */
+	TaskArray* growArray() {
+		TaskArray* oldA = array;
+		int size = (oldA != null) ? oldA->length << 1 : INITIAL_QUEUE_CAPACITY;
+		if (size > MAXIMUM_QUEUE_CAPACITY)
+			throw ERejectedExecutionException(__FILE__, __LINE__, "Queue capacity exceeded");
+		TaskArray* a = TaskArray::create(size, oldA);
+		int oldMask, t, b;
+		EOrderAccess::release_store_ptr(&array, a);
+		if (oldA != null && (oldMask = oldA->length - 1) >= 0 &&
+			(t = top) - (b = base) > 0) {
+			int mask = size - 1;
+			do { // emulate poll from old array, push to new array
+				EForkJoinTaskType* x = (EForkJoinTaskType*)
+						EOrderAccess::load_ptr_acquire(&oldA->slots[b & oldMask]);
+				if (x != null &&
+					EUnsafe::compareAndSwapObject(&oldA->slots[b & oldMask], x, null))
+					EOrderAccess::release_store_ptr(&a->slots[b & mask], x);
+			} while (++b != t);
+		}
+		EUnsafe::fullFence();
+		return a;
+	}
+
+	/**
+	 * Takes next task, if one exists, in LIFO order.  Call only
+	 * by owner in unshared queues.
+	 */
+	EForkJoinTaskType* pop() {
+		TaskArray* a = array;
+		if (a != null) {
+			int m = a->length - 1;
+			for (int s; (s = top - 1) - base >= 0;) {
+				EForkJoinTaskType* volatile* j = &a->slots[m & s];
+				EForkJoinTaskType* t = (EForkJoinTaskType*)EOrderAccess::load_ptr_acquire(j);
+				if (t == null)
+					break;
+				if (EUnsafe::compareAndSwapObject(j, t, null)) {
+					EOrderAccess::release_store(&top, s);
+					return t;
+				}
+			}
+		}
+		return null;
+	}
+
+	/**
+	 * Takes next task, if one exists, in FIFO order.  May be called
+	 * by any thread.
+	 */
+	EForkJoinTaskType* poll() {
+		TaskArray* a;
+		int b;
+		while ((b = base) - top < 0 && (a = (TaskArray*)EOrderAccess::load_ptr_acquire(&array)) != null) {
+			EForkJoinTaskType* volatile* j = &a->slots[(a->length - 1) & b];
+			EForkJoinTaskType* t = (EForkJoinTaskType*)EOrderAccess::load_ptr_acquire(j);
+			if (base == b) {
+				if (t != null) {
+					if (EUnsafe::compareAndSwapObject(j, t, null)) {
+						EOrderAccess::release_store(&base, b + 1);
+						return t;
+					}
+				}
+				else if (b + 1 == top) // now empty
+					break;
+			}
+		}
+		return null;
+	}
+
+	/**
+	 * Pops the given task only if it is at the current top.
+	 * Call only by owner in unshared queues, or holding qlock in
+	 * shared ones.
+	 */
+	boolean tryUnpush(EForkJoinTaskType* t) {
+		TaskArray* a = array;
+		int s;
+		if (a != null && (s = top) != base) {
+			EForkJoinTaskType* volatile* j = &a->slots[(a->length - 1) & --s];
+			if (EUnsafe::compareAndSwapObject(j, t, null)) {
+				EOrderAccess::release_store(&top, s);
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+/**
+ * Adaptor for Runnables passed to {@link EForkJoinPool#execute}.
+ */
+class RunnableExecuteAction : public EForkJoinTask<EObject> {
+public:
+	RunnableExecuteAction(sp<ERunnable> runnable) : runnable(runnable) {
+	}
+	virtual sp<EObject> getRawResult() {
+		return null;
+	}
+protected:
+	virtual void setRawResult(sp<EObject> v) {
+	}
+	virtual boolean exec() {
+		runnable->run();
+		return true;
+	}
+private:
+	sp<ERunnable> runnable;
+};
+
+/**
+ * Default EForkJoinWorkerThreadFactory implementation; creates a
+ * new EForkJoinWorkerThread.
+ */
+class DefaultForkJoinWorkerThreadFactory : public EForkJoinPool::ForkJoinWorkerThreadFactory {
+public:
+	virtual EForkJoinWorkerThread* newThread(EForkJoinPool* pool) {
+		return new EForkJoinWorkerThread(pool);
+	}
+};
+
+} /* namespace fjp */
+
+using fjp::WorkQueue;
+
+/**
+ * Sequence number for creating workerNamePrefix.
+ */
+static volatile es_int32_t poolNumberSequence = 0;
+
+sp<EForkJoinPool::ForkJoinWorkerThreadFactory> EForkJoinPool::defaultForkJoinWorkerThreadFactory;
+EForkJoinPool* volatile EForkJoinPool::common = null;
+
+DEFINE_STATIC_INITZZ_BEGIN(EForkJoinPool)
+	defaultForkJoinWorkerThreadFactory = new fjp::DefaultForkJoinWorkerThreadFactory();
+DEFINE_STATIC_INITZZ_END
+
+EForkJoinPool::~EForkJoinPool() {
+	if (!isCommon) {
+		shutdown();
+		try {
+			awaitTermination();
+		} catch (...) {
+		}
+	}
+	for (int i = 0; i < parallelism; i++) {
+		if (workers[i] != null) {
+			try {
+				workers[i]->join();
+			} catch (...) {
+			}
+			delete workers[i];
+		}
+	}
+	cancelAllQueued();
+	for (int i = 0; i < nQueues; i++) {
+		delete workQueues[i];
+	}
+	delete[] workQueues;
+	delete[] workers;
+	delete termination;
+}
+
+EForkJoinPool::EForkJoinPool() {
+	init(availableProcessors(), defaultForkJoinWorkerThreadFactory, false);
+}
+
+EForkJoinPool::EForkJoinPool(int parallelism) {
+	init(parallelism, defaultForkJoinWorkerThreadFactory, false);
+}
+
+EForkJoinPool::EForkJoinPool(int parallelism,
+		sp<ForkJoinWorkerThreadFactory> factory, boolean asyncMode) {
+	init(parallelism, factory, asyncMode);
+}
+
+void EForkJoinPool::init(int parallelism,
+		sp<ForkJoinWorkerThreadFactory> factory, boolean asyncMode) {
+	if (parallelism <= 0 || parallelism > MAX_CAP)
+		throw EIllegalArgumentException(__FILE__, __LINE__);
+	if (factory == null)
+		throw ENullPointerException(__FILE__, __LINE__);
+
+	this->runState = RUNNING;
+	this->parallelism = parallelism;
+	this->asyncMode = asyncMode;
+	this->isCommon = false;
+	this->factory = factory;
+	this->poolNumber = eso_atomic_add_and_fetch32(&poolNumberSequence, 1);
+
+	// one shared submission queue per worker, rounded to a power of two
+	int n = 1;
+	while (n < parallelism) n <<= 1;
+	this->submitMask = n - 1;
+	this->nQueues = parallelism + n;
+	this->workQueues = new WorkQueue*[nQueues];
+	for (int i = 0; i < nQueues; i++) {
+		workQueues[i] = new WorkQueue(this, i);
+	}
+	this->workers = new EForkJoinWorkerThread*[parallelism];
+	for (int i = 0; i < parallelism; i++) {
+		workers[i] = null;
+	}
+
+	this->started = 0;
+	this->workerCount = 0;
+	this->termination = mainLock.newCondition();
+	this->idleStack = null;
+	this->idleCount = 0;
+}
+
+int EForkJoinPool::availableProcessors() {
+	return ERuntime::getRuntime()->availableProcessors();
+}
+
+EForkJoinPool* EForkJoinPool::commonPool() {
+	EForkJoinPool* p = common;
+	if (p == null) {
+		int par = availableProcessors() - 1;
+		EForkJoinPool* np = new EForkJoinPool(par > 0 ? par : 1,
+				defaultForkJoinWorkerThreadFactory, false);
+		np->isCommon = true;
+		if (!EUnsafe::compareAndSwapObject(&common, null, np)) {
+			np->isCommon = false;
+			delete np;
+		}
+		p = common;
+	}
+	return p;
+}
+
+int EForkJoinPool::getCommonPoolParallelism() {
+	return commonPool()->parallelism;
+}
+
+void EForkJoinPool::execute(sp<ERunnable> task) {
+	if (task == null)
+		throw ENullPointerException(__FILE__, __LINE__);
+	sp<EForkJoinTaskType> job = new fjp::RunnableExecuteAction(task);
+	externalPush(job);
+}
+
+void EForkJoinPool::externalPush(sp<EForkJoinTaskType> task) {
+	if (task == null)
+		throw ENullPointerException(__FILE__, __LINE__);
+	ensureStarted();
+
+	int h = (int)EThread::currentThread()->getId() * 0x9e3779b9;
+	WorkQueue* q = workQueues[parallelism + ((h ^ ((unsigned)h >> 16)) & submitMask)];
+	EForkJoinTaskType* t = task.get();
+	q->lock();
+	if (runState != RUNNING) {
+		q->unlock();
+		throw ERejectedExecutionException(__FILE__, __LINE__);
+	}
+	t->pinned = task;
+	try {
+		q->push(t);
+	} catch (...) {
+		t->pinned = null;
+		q->unlock();
+		throw;
+	}
+	q->unlock();
+	signalWork();
+
+	// lost a race with shutdown after the check above
+	if (runState >= STOP)
+		cancelAllQueued();
+}
+
+void EForkJoinPool::workerPush(WorkQueue* w, EForkJoinTaskType* task) {
+	if (w->push(task) <= 1)
+		signalWork();
+}
+
+boolean EForkJoinPool::tryUnpush(WorkQueue* w, EForkJoinTaskType* task) {
+	if (w != null)
+		return w->tryUnpush(task);
+	int h = (int)EThread::currentThread()->getId() * 0x9e3779b9;
+	WorkQueue* q = workQueues[parallelism + ((h ^ ((unsigned)h >> 16)) & submitMask)];
+	boolean popped = false;
+	if (!q->isEmpty() && q->tryLock()) {
+		popped = q->tryUnpush(task);
+		q->unlock();
+	}
+	return popped;
+}
+
+void EForkJoinPool::ensureStarted() {
+	if (started)
+		return;
+	SYNCBLOCK(&mainLock) {
+		if (started || runState != RUNNING)
+			return;
+		started = 1;
+		for (int i = 0; i < parallelism; i++) {
+			workers[i] = factory->newThread(this);
+		}
+		for (int i = 0; i < parallelism; i++) {
+			workers[i]->start();
+		}
+	}}
+}
+
+WorkQueue* EForkJoinPool::registerWorker(EForkJoinWorkerThread* wt) {
+	// called from the factory while ensureStarted holds mainLock
+	int i = workerCount;
+	if (i >= parallelism)
+		throw EIllegalStateException(__FILE__, __LINE__, "Too many workers");
+	WorkQueue* w = workQueues[i];
+	w->owner = wt;
+	workerCount = i + 1;
+
+	if (isCommon) {
+		wt->setDaemon(true);
+		wt->setName(EStringBase::formatOf("ForkJoinPool.commonPool-worker-%d", i + 1).c_str());
+	}
+	else {
+		wt->setName(EStringBase::formatOf("ForkJoinPool-%d-worker-%d", poolNumber, i + 1).c_str());
+	}
+	return w;
+}
+
+void EForkJoinPool::deregisterWorker(EForkJoinWorkerThread* wt, EThrowable* ex) {
+	WorkQueue* w = wt->workQueue;
+	SYNCBLOCK(&mainLock) {
+		if (w != null && w->idle) {
+			for (WorkQueue** pp = &idleStack; *pp != null; pp = &(*pp)->nextIdle) {
+				if (*pp == w) {
+					*pp = w->nextIdle;
+					break;
+				}
+			}
+			w->idle = false;
+			w->nextIdle = null;
+			idleCount--;
+		}
+		workerCount--;
+		if (runState >= STOP && workerCount == 0) {
+			runState = TERMINATED;
+			termination->signalAll();
+		}
+	}}
+}
+
+void EForkJoinPool::signalWork() {
+	EUnsafe::fullFence(); // pairs with the fence in awaitWork
+	if (idleCount <= 0)
+		return;
+	EThread* t = null;
+	SYNCBLOCK(&mainLock) {
+		WorkQueue* q = idleStack;
+		if (q != null) {
+			idleStack = q->nextIdle;
+			q->nextIdle = null;
+			q->idle = false;
+			idleCount--;
+			t = q->owner;
+		}
+	}}
+	if (t != null)
+		ELockSupport::unpark(t);
+}
+
+EForkJoinTaskType* EForkJoinPool::scan(WorkQueue* w) {
+	int n = nQueues;
+	int r = (w != null) ? w->nextHint() : (int)(ESystem::nanoTime() & 0x7fffffff);
+	for (int k = 0; k < n; k++) {
+		WorkQueue* q = workQueues[(r + k) % n];
+		if (q != w && !q->isEmpty()) {
+			EForkJoinTaskType* t = q->poll();
+			if (t != null) {
+				if (w != null)
+					w->nsteals = w->nsteals + 1;
+				if (!q->isEmpty()) // propagate to other idle workers
+					signalWork();
+				return t;
+			}
+		}
+	}
+	return null;
+}
+
+boolean EForkJoinPool::hasQueuedTasks() {
+	for (int i = 0; i < nQueues; i++) {
+		if (!workQueues[i]->isEmpty())
+			return true;
+	}
+	return false;
+}
+
+boolean EForkJoinPool::awaitWork(WorkQueue* w) {
+	SYNCBLOCK(&mainLock) {
+		if (runState >= STOP)
+			return false;
+		w->idle = true;
+		w->nextIdle = idleStack;
+		idleStack = w;
+		idleCount++;
+	}}
+
+	// recheck after publishing idleness; pairs with fence in signalWork
+	EUnsafe::fullFence();
+	boolean park = !hasQueuedTasks();
+
+	SYNCBLOCK(&mainLock) {
+		if (park && runState == SHUTDOWN && idleCount == workerCount)
+			tryTerminateLocked(false);
+		if (!park || runState >= STOP) {
+			if (w->idle) {
+				for (WorkQueue** pp = &idleStack; *pp != null; pp = &(*pp)->nextIdle) {
+					if (*pp == w) {
+						*pp = w->nextIdle;
+						break;
+					}
+				}
+				w->idle = false;
+				w->nextIdle = null;
+				idleCount--;
+			}
+			return runState < STOP;
+		}
+	}}
+
+	ELockSupport::park();
+	EThread::interrupted(); // workers ignore interrupts
+
+	SYNCBLOCK(&mainLock) {
+		if (w->idle) { // spurious wakeup
+			for (WorkQueue** pp = &idleStack; *pp != null; pp = &(*pp)->nextIdle) {
+				if (*pp == w) {
+					*pp = w->nextIdle;
+					break;
+				}
+			}
+			w->idle = false;
+			w->nextIdle = null;
+			idleCount--;
+		}
+		return runState < STOP;
+	}}
+}
+
+void EForkJoinPool::tryTerminateLocked(boolean now) {
+	if (runState < STOP)
+		runState = STOP;
+	if (now)
+		cancelAllQueued();
+	for (WorkQueue* q = idleStack; q != null; q = q->nextIdle) {
+		ELockSupport::unpark(q->owner);
+	}
+	if (workerCount == 0 && runState != TERMINATED) {
+		runState = TERMINATED;
+		termination->signalAll();
+	}
+}
+
+void EForkJoinPool::cancelAllQueued() {
+	for (int i = 0; i < nQueues; i++) {
+		EForkJoinTaskType* t;
+		while ((t = workQueues[i]->poll()) != null) {
+			sp<EForkJoinTaskType> hold = t->unpin();
+			t->cancelTask(false);
+		}
+	}
+}
+
+void EForkJoinPool::runTask(EForkJoinTaskType* t) {
+	sp<EForkJoinTaskType> hold = t->unpin();
+	t->doExec();
+}
+
+void EForkJoinPool::runWorker(WorkQueue* w) {
+	while (runState < STOP) {
+		EForkJoinTaskType* t = asyncMode ? w->poll() : w->pop();
+		if (t == null)
+			t = scan(w);
+		if (t != null)
+			runTask(t);
+		else if (!awaitWork(w))
+			break;
+	}
+}
+
+int EForkJoinPool::awaitJoin(WorkQueue* w, EForkJoinTaskType* task) {
+	llong wait = 1000L; // nanos, doubled while there is nothing to help with
+	int s;
+	while ((s = task->status) >= 0) {
+		EForkJoinTaskType* t = w->pop();
+		if (t == null)
+			t = scan(w);
+		if (t != null) {
+			runTask(t);
+			wait = 1000L;
+			continue;
+		}
+		if ((s = task->awaitDone(false, true, wait)) < 0)
+			break;
+		if (wait < 8000000L)
+			wait <<= 1;
+	}
+	return s;
+}
+
+void EForkJoinPool::helpQuiescePool(WorkQueue* w) {
+	for (;;) {
+		EForkJoinTaskType* t = asyncMode ? w->poll() : w->pop();
+		if (t == null)
+			t = scan(w);
+		if (t != null)
+			runTask(t);
+		else if (workerCount - idleCount <= 1 && !hasQueuedTasks())
+			break;
+		else
+			EThread::yield();
+	}
+}
+
+int EForkJoinPool::queuedCount(WorkQueue* w) {
+	return w->queueSize();
+}
+
+int EForkJoinPool::surplusCount(WorkQueue* w) {
+	int p = parallelism;
+	int a = workerCount - idleCount;
+	int n = w->queueSize();
+	return n - ((a > (p >>= 1)) ? 0 :
+				(a > (p >>= 1)) ? 1 :
+				(a > (p >>= 1)) ? 2 :
+				(a > (p >>= 1)) ? 4 :
+				8);
+}
+
+int EForkJoinPool::workerIndex(WorkQueue* w) {
+	return w->poolIndex;
+}
+
+sp<EForkJoinPool::ForkJoinWorkerThreadFactory> EForkJoinPool::getFactory() {
+	return factory;
+}
+
+int EForkJoinPool::getParallelism() {
+	return parallelism;
+}
+
+int EForkJoinPool::getPoolSize() {
+	return workerCount;
+}
+
+boolean EForkJoinPool::getAsyncMode() {
+	return asyncMode;
+}
+
+int EForkJoinPool::getActiveThreadCount() {
+	int r = workerCount - idleCount;
+	return (r <= 0) ? 0 : r;
+}
+
+boolean EForkJoinPool::isQuiescent() {
+	return workerCount - idleCount <= 0 && !hasQueuedTasks();
+}
+
+llong EForkJoinPool::getStealCount() {
+	llong count = 0L;
+	for (int i = 0; i < parallelism; i++) {
+		count += workQueues[i]->nsteals;
+	}
+	return count;
+}
+
+llong EForkJoinPool::getQueuedTaskCount() {
+	llong count = 0L;
+	for (int i = 0; i < parallelism; i++) {
+		count += workQueues[i]->queueSize();
+	}
+	return count;
+}
+
+int EForkJoinPool::getQueuedSubmissionCount() {
+	int count = 0;
+	for (int i = parallelism; i < nQueues; i++) {
+		count += workQueues[i]->queueSize();
+	}
+	return count;
+}
+
+boolean EForkJoinPool::hasQueuedSubmissions() {
+	for (int i = parallelism; i < nQueues; i++) {
+		if (!workQueues[i]->isEmpty())
+			return true;
+	}
+	return false;
+}
+
+EStringBase EForkJoinPool::toString() {
+	int rs = runState;
+	const char* level = ((rs == TERMINATED) ? "Terminated" :
+						 (rs == STOP) ? "Terminating" :
+						 (rs == SHUTDOWN) ? "Shutting down" :
+						 "Running");
+	return EStringBase::formatOf("%s[%s, parallelism = %d, size = %d, active = %d, steals = %lld, tasks = %lld, submissions = %d]",
+			EObject::toString().c_str(), level, parallelism, getPoolSize(),
+			getActiveThreadCount(), getStealCount(), getQueuedTaskCount(),
+			getQueuedSubmissionCount());
+}
+
+void EForkJoinPool::shutdown() {
+	if (isCommon)
+		return;
+	SYNCBLOCK(&mainLock) {
+		if (runState == RUNNING)
+			runState = SHUTDOWN;
+		if (runState == SHUTDOWN && idleCount == workerCount && !hasQueuedTasks())
+			tryTerminateLocked(false);
+	}}
+}
+
+EArrayList<sp<ERunnable> > EForkJoinPool::shutdownNow() {
+	if (!isCommon) {
+		SYNCBLOCK(&mainLock) {
+			if (runState < STOP)
+				tryTerminateLocked(true);
+		}}
+	}
+	return EArrayList<sp<ERunnable> >();
+}
+
+boolean EForkJoinPool::isTerminated() {
+	return runState == TERMINATED;
+}
+
+boolean EForkJoinPool::isTerminating() {
+	return runState == STOP;
+}
+
+boolean EForkJoinPool::isShutdown() {
+	return runState >= SHUTDOWN;
+}
+
+boolean EForkJoinPool::awaitTermination() {
+	if (isCommon) {
+		awaitQuiescence(ELLong::MAX_VALUE, ETimeUnit::NANOSECONDS);
+		return false;
+	}
+	SYNCBLOCK(&mainLock) {
+		while (runState != TERMINATED) {
+			termination->await();
+		}
+		return true;
+	}}
+}
+
+boolean EForkJoinPool::awaitTermination(llong timeout, ETimeUnit* unit) {
+	if (EThread::interrupted())
+		throw EInterruptedException(__FILE__, __LINE__);
+	if (isCommon) {
+		awaitQuiescence(timeout, unit);
+		return false;
+	}
+	llong nanos = unit->toNanos(timeout);
+	SYNCBLOCK(&mainLock) {
+		for (;;) {
+			if (runState == TERMINATED)
+				return true;
+			if (nanos <= 0)
+				return false;
+			nanos = termination->awaitNanos(nanos);
+		}
+	}}
+}
+
+boolean EForkJoinPool::awaitQuiescence(llong timeout, ETimeUnit* unit) {
+	llong nanos = unit->toNanos(timeout);
+	EForkJoinWorkerThread* wt = dynamic_cast<EForkJoinWorkerThread*>(EThread::currentThread());
+	if (wt != null && wt->pool == this) {
+		helpQuiescePool(wt->workQueue);
+		return true;
+	}
+	llong startTime = ESystem::nanoTime();
+	llong wait = 1000L;
+	while (!isQuiescent()) {
+		if (ESystem::nanoTime() - startTime > nanos)
+			return false;
+		ELockSupport::parkNanos(wait);
+		if (wait < 8000000L)
+			wait <<= 1;
+	}
+	return true;
+}
+
+} /* namespace efc */
@@ -0,0 +1,344 @@
+/*
+ * EForkJoinTask.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/EForkJoinTask.hh"
+#include "../../inc/concurrent/EForkJoinPool.hh"
+#include "../../inc/concurrent/EForkJoinWorkerThread.hh"
+#include "../../inc/concurrent/ELockSupport.hh"
+#include "../../inc/concurrent/EUnsafe.hh"
+#include "../../inc/EThread.hh"
+#include "../../inc/ESystem.hh"
+#include "../../inc/ELLong.hh"
+
+namespace efc {
+
+EForkJoinTaskType::~EForkJoinTaskType() {
+}
+
+EForkJoinTaskType::EForkJoinTaskType() :
+		status(0), waiters(null), waitLock(0) {
+}
+
+void EForkJoinTaskType::lockWaiters() {
+	while (!EUnsafe::compareAndSwapInt(&waitLock, 0, 1)) {
+		EThread::yield();
+	}
+}
+
+void EForkJoinTaskType::unlockWaiters() {
+	EUnsafe::putOrdered(&waitLock, 0);
+}
+
+int EForkJoinTaskType::setCompletion(int completion) {
+	for (int s;;) {
+		if ((s = status) < 0)
+			return s;
+		if (EUnsafe::compareAndSwapInt(&status, s, s | completion)) {
+			if ((s & SIGNAL) != 0) {
+				lockWaiters();
+				for (WaitNode* q = waiters; q != null; q = q->next) {
+					EThread* t = q->thread;
+					q->thread = null;
+					ELockSupport::unpark(t);
+				}
+				waiters = null;
+				unlockWaiters();
+			}
+			return completion;
+		}
+	}
+}
+
+int EForkJoinTaskType::setExceptionalCompletion(EThrowable* ex) {
+	int s;
+	if ((s = status) >= 0) {
+		lockWaiters();
+		if (status >= 0 && exception == null) {
+			exception = new EThrowable(ex->getSourceFile(), ex->getSourceLine(), ex->getMessage());
+		}
+		unlockWaiters();
+		s = setCompletion(EXCEPTIONAL);
+	}
+	return s;
+}
+
+int EForkJoinTaskType::doExec() {
+	int s; boolean completed;
+	if ((s = status) >= 0) {
+		try {
+			completed = exec();
+		} catch (EThrowable& rex) {
+			return setExceptionalCompletion(&rex);
+		} catch (...) {
+			ERuntimeException rex(__FILE__, __LINE__, "unknown exception in task");
+			return setExceptionalCompletion(&rex);
+		}
+		if (completed)
+			s = setCompletion(NORMAL);
+	}
+	return s;
+}
+
+int EForkJoinTaskType::awaitDone(boolean interruptible, boolean timed, llong nanos) {
+	llong deadline = timed ? ESystem::nanoTime() + nanos : 0L;
+	WaitNode node;
+	node.thread = EThread::currentThread();
+	node.next = null;
+	boolean queued = false;
+	boolean interrupted = false;
+	int s;
+
+	while ((s = status) >= 0) {
+		if (!queued) {
+			lockWaiters();
+			if ((s = status) >= 0 &&
+				EUnsafe::compareAndSwapInt(&status, s, s | SIGNAL)) {
+				node.next = waiters;
+				waiters = &node;
+				queued = true;
+			}
+			unlockWaiters();
+			continue;
+		}
+		if (node.thread == null) // unlinked by setCompletion
+			break;
+		if (timed) {
+			nanos = deadline - ESystem::nanoTime();
+			if (nanos <= 0L)
+				break;
+			ELockSupport::parkNanos(nanos);
+		}
+		else {
+			ELockSupport::park();
+		}
+		if (EThread::interrupted()) {
+			if (interruptible)
+				break;
+			interrupted = true;
+		}
+	}
+
+	if (queued) {
+		lockWaiters();
+		// setCompletion clears the whole stack, otherwise unlink ourself
+		for (WaitNode** pp = &waiters; *pp != null; pp = &(*pp)->next) {
+			if (*pp == &node) {
+				*pp = node.next;
+				break;
+			}
+		}
+		unlockWaiters();
+	}
+
+	s = status;
+	if (interrupted)
+		EThread::currentThread()->interrupt();
+	else if (interruptible && s >= 0 && (!timed || nanos > 0L))
+		throw EInterruptedException(__FILE__, __LINE__);
+	return s;
+}
+
+int EForkJoinTaskType::externalAwaitDone(boolean interruptible, boolean timed,
+		llong nanos) {
+	if (interruptible && EThread::interrupted())
+		throw EInterruptedException(__FILE__, __LINE__);
+	int s;
+	if ((s = status) < 0)
+		return s;
+	// help by running the task ourselves if it is still queued
+	EForkJoinPool* common = EForkJoinPool::common;
+	if (common != null && common->tryUnpush(null, this)) {
+		sp<EForkJoinTaskType> hold = unpin();
+		s = doExec();
+	}
+	if (s >= 0)
+		s = awaitDone(interruptible, timed, nanos);
+	return s;
+}
+
+int EForkJoinTaskType::doJoin() {
+	int s;
+	if ((s = status) < 0)
+		return s;
+	EForkJoinWorkerThread* wt = currentWorker();
+	if (wt != null) {
+		fjp::WorkQueue* w = wt->workQueue;
+		EForkJoinPool* p = wt->pool;
+		if (p->tryUnpush(w, this)) {
+			sp<EForkJoinTaskType> hold = unpin();
+			if ((s = doExec()) < 0)
+				return s;
+		}
+		return p->awaitJoin(w, this);
+	}
+	return externalAwaitDone(false, false, 0L);
+}
+
+int EForkJoinTaskType::doInvoke() {
+	int s;
+	if ((s = doExec()) < 0)
+		return s;
+	EForkJoinWorkerThread* wt = currentWorker();
+	if (wt != null)
+		return wt->pool->awaitJoin(wt->workQueue, this);
+	return externalAwaitDone(false, false, 0L);
+}
+
+void EForkJoinTaskType::reportException(int s) {
+	if (s == CANCELLED)
+		throw ECancellationException(__FILE__, __LINE__);
+	if (s == EXCEPTIONAL) {
+		sp<EThrowable> ex = exception;
+		if (ex != null)
+			throw ERuntimeException(ex->getSourceFile(), ex->getSourceLine(), ex->getMessage());
+		throw ERuntimeException(__FILE__, __LINE__);
+	}
+}
+
+void EForkJoinTaskType::reportGetException(int s) {
+	if (s == CANCELLED)
+		throw ECancellationException(__FILE__, __LINE__);
+	if (s == EXCEPTIONAL) {
+		sp<EThrowable> ex = exception;
+		if (ex != null)
+			throw EExecutionException(ex->getSourceFile(), ex->getSourceLine(), ex->getMessage());
+		throw EExecutionException(__FILE__, __LINE__);
+	}
+}
+
+void EForkJoinTaskType::pin() {
+	sp<EForkJoinTaskType> self = weak_this_.lock();
+	if (self != null)
+		pinned = self;
+}
+
+sp<EForkJoinTaskType> EForkJoinTaskType::unpin() {
+	sp<EForkJoinTaskType> self = pinned;
+	pinned = null;
+	return self;
+}
+
+EForkJoinWorkerThread* EForkJoinTaskType::currentWorker() {
+	return dynamic_cast<EForkJoinWorkerThread*>(EThread::currentThread());
+}
+
+void EForkJoinTaskType::forkTask() {
+	EForkJoinWorkerThread* wt = currentWorker();
+	if (wt != null) {
+		pin();
+		wt->pool->workerPush(wt->workQueue, this);
+	}
+	else {
+		sp<EForkJoinTaskType> self = weak_this_.lock();
+		if (self == null)
+			throw ENullPointerException(__FILE__, __LINE__,
+					"task forked outside a pool must be owned by sp<>");
+		EForkJoinPool::commonPool()->externalPush(self);
+	}
+}
+
+boolean EForkJoinTaskType::isTaskDone() {
+	return status < 0;
+}
+
+boolean EForkJoinTaskType::isTaskCancelled() {
+	return (status & DONE_MASK) == CANCELLED;
+}
+
+boolean EForkJoinTaskType::isCompletedAbnormally() {
+	return status < NORMAL;
+}
+
+boolean EForkJoinTaskType::isCompletedNormally() {
+	return (status & DONE_MASK) == NORMAL;
+}
+
+sp<EThrowable> EForkJoinTaskType::getException() {
+	int s = status & DONE_MASK;
+	if (s >= NORMAL)
+		return null;
+	if (s == CANCELLED)
+		return new ECancellationException(__FILE__, __LINE__);
+	return exception;
+}
+
+boolean EForkJoinTaskType::cancelTask(boolean mayInterruptIfRunning) {
+	return (setCompletion(CANCELLED) & DONE_MASK) == CANCELLED;
+}
+
+void EForkJoinTaskType::quietlyJoin() {
+	doJoin();
+}
+
+void EForkJoinTaskType::quietlyInvoke() {
+	doInvoke();
+}
+
+boolean EForkJoinTaskType::tryUnfork() {
+	EForkJoinWorkerThread* wt = currentWorker();
+	EForkJoinPool* common = EForkJoinPool::common;
+	boolean unforked = (wt != null) ?
+			wt->pool->tryUnpush(wt->workQueue, this) :
+			(common != null && common->tryUnpush(null, this));
+	if (unforked)
+		unpin();
+	return unforked;
+}
+
+void EForkJoinTaskType::reinitialize() {
+	exception = null;
+	status = 0;
+}
+
+void EForkJoinTaskType::completeExceptionally(EThrowable& ex) {
+	setExceptionalCompletion(&ex);
+}
+
+void EForkJoinTaskType::quietlyComplete() {
+	setCompletion(NORMAL);
+}
+
+void EForkJoinTaskType::invokeAll(sp<EForkJoinTaskType> t1,
+		sp<EForkJoinTaskType> t2) {
+	if (t1 == null || t2 == null)
+		throw ENullPointerException(__FILE__, __LINE__);
+	int s1, s2;
+	t2->forkTask();
+	if ((s1 = t1->doInvoke() & DONE_MASK) != NORMAL)
+		t1->reportException(s1);
+	if ((s2 = t2->doJoin() & DONE_MASK) != NORMAL)
+		t2->reportException(s2);
+}
+
+EForkJoinPool* EForkJoinTaskType::getPool() {
+	EForkJoinWorkerThread* wt = currentWorker();
+	return (wt != null) ? wt->pool : null;
+}
+
+boolean EForkJoinTaskType::inForkJoinPool() {
+	return currentWorker() != null;
+}
+
+int EForkJoinTaskType::getQueuedTaskCount() {
+	EForkJoinWorkerThread* wt = currentWorker();
+	return (wt != null) ? wt->pool->queuedCount(wt->workQueue) : 0;
+}
+
+int EForkJoinTaskType::getSurplusQueuedTaskCount() {
+	EForkJoinWorkerThread* wt = currentWorker();
+	return (wt != null) ? wt->pool->surplusCount(wt->workQueue) : 0;
+}
+
+void EForkJoinTaskType::helpQuiesce() {
+	EForkJoinWorkerThread* wt = currentWorker();
+	if (wt != null)
+		wt->pool->helpQuiescePool(wt->workQueue);
+	else
+		EForkJoinPool::commonPool()->awaitQuiescence(ELLong::MAX_VALUE, ETimeUnit::NANOSECONDS);
+}
+
+} /* namespace efc */
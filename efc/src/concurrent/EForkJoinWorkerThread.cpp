@@ -0,0 +1,57 @@
+/*
+ * EForkJoinWorkerThread.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/EForkJoinWorkerThread.hh"
+#include "../../inc/concurrent/EForkJoinPool.hh"
+#include "../../inc/ENullPointerException.hh"
+
+namespace efc {
+
+EForkJoinWorkerThread::~EForkJoinWorkerThread() {
+}
+
+EForkJoinWorkerThread::EForkJoinWorkerThread(EForkJoinPool* pool) :
+		EThread("ForkJoinPool-worker") {
+	if (pool == null)
+		throw ENullPointerException(__FILE__, __LINE__);
+	this->pool = pool;
+	this->workQueue = pool->registerWorker(this);
+}
+
+EForkJoinPool* EForkJoinWorkerThread::getPool() {
+	return pool;
+}
+
+int EForkJoinWorkerThread::getPoolIndex() {
+	return pool->workerIndex(workQueue);
+}
+
+void EForkJoinWorkerThread::onStart() {
+}
+
+void EForkJoinWorkerThread::onTermination(EThrowable* exception) {
+}
+
+void EForkJoinWorkerThread::run() {
+	EThrowable* exception = null;
+	try {
+		onStart();
+		pool->runWorker(workQueue);
+	} catch (EThrowable& ex) {
+		exception = new EThrowable(ex.getSourceFile(), ex.getSourceLine(), ex.getMessage());
+	}
+	try {
+		onTermination(exception);
+	} catch (EThrowable& ex) {
+		if (exception == null)
+			exception = new EThrowable(ex.getSourceFile(), ex.getSourceLine(), ex.getMessage());
+	}
+	pool->deregisterWorker(this, exception);
+	delete exception;
+}
+
+} /* namespace efc */
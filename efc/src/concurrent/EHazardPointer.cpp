@@ -0,0 +1,262 @@
+/*
+ * EHazardPointer.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/EHazardPointer.hh"
+
+namespace efc {
+
+/**
+ * Minimum number of objects retired by a thread before it scans.
+ */
+static const int SCAN_THRESHOLD = 64;
+
+struct Retired {
+	void* p;
+	EHazardPointer::Deleter d;
+};
+
+/**
+ * Per-thread registration: the slots on their own cache line, then
+ * the retired buffer, which only the owner touches.  Records are
+ * never freed; a record whose thread terminated is reused.
+ */
+struct EHazardPointer::Record {
+	void* volatile hp[SLOTS];
+	char pad[ES_CACHE_LINE_SIZE - SLOTS * sizeof(void*)];
+	volatile int inUse;
+	int used; // bit set of borrowed slots
+	Record* next;
+	Retired* retired;
+	int count;
+	int capacity;
+};
+
+/**
+ * Retired objects left behind by a terminated thread.
+ */
+struct Orphans {
+	Retired* items;
+	int count;
+	Orphans* next;
+};
+
+class EHazardPointer::Domain {
+public:
+	class Lease: public EObject {
+	public:
+		Record* record;
+
+		Lease(Record* r) : record(r) {
+		}
+		virtual ~Lease() {
+			Domain::get()->release(record);
+		}
+	};
+
+	class Participant: public EThreadLocal {
+	public:
+		virtual EObject* initialValue() {
+			return new Lease(Domain::get()->acquire());
+		}
+	};
+
+	Record* volatile records;
+	Orphans* volatile orphans;
+	volatile int recordCount;
+	volatile int orphanCount;
+	EThreadLocalVariable<Participant, Lease>* local;
+
+	Domain() : records(null), orphans(null), recordCount(0), orphanCount(0) {
+		local = new EThreadLocalVariable<Participant, Lease>();
+	}
+
+	~Domain() {
+		delete local;
+	}
+
+	static Domain* get() {
+		static Domain* volatile instance = null;
+		Domain* d = (Domain*)EOrderAccess::load_ptr_acquire(&instance);
+		if (d == null) {
+			Domain* n = new Domain();
+			if (EUnsafe::compareAndSwapObject(&instance, null, n)) {
+				d = n;
+			} else {
+				delete n;
+				d = (Domain*)EOrderAccess::load_ptr_acquire(&instance);
+			}
+		}
+		return d;
+	}
+
+	Record* current() {
+		return local->get()->record;
+	}
+
+	Record* acquire() {
+		for (Record* r = records; r != null; r = r->next) {
+			if (r->inUse == 0 && EUnsafe::compareAndSwapInt(&r->inUse, 0, 1)) {
+				return r;
+			}
+		}
+		Record* r = (Record*)eso_calloc(sizeof(Record));
+		r->inUse = 1;
+		do {
+			r->next = records;
+		} while (!EUnsafe::compareAndSwapObject(&records, r->next, r));
+		eso_atomic_add_and_fetch32(&recordCount, 1);
+		return r;
+	}
+
+	void release(Record* r) {
+		for (int i = 0; i < SLOTS; i++) {
+			r->hp[i] = null;
+		}
+		r->used = 0;
+		if (r->count > 0) {
+			Orphans* o = (Orphans*)eso_malloc(sizeof(Orphans));
+			o->items = r->retired;
+			o->count = r->count;
+			eso_atomic_add_and_fetch32(&orphanCount, o->count);
+			do {
+				o->next = orphans;
+			} while (!EUnsafe::compareAndSwapObject(&orphans, o->next, o));
+		} else {
+			eso_free(r->retired);
+		}
+		r->retired = null;
+		r->count = r->capacity = 0;
+		EOrderAccess::release_store(&r->inUse, 0);
+	}
+
+	static void append(Record* r, void* p, Deleter d) {
+		if (r->count == r->capacity) {
+			int n = r->capacity == 0 ? SCAN_THRESHOLD : r->capacity << 1;
+			r->retired = (Retired*)eso_realloc(r->retired, n * sizeof(Retired));
+			r->capacity = n;
+		}
+		Retired* x = &r->retired[r->count++];
+		x->p = p;
+		x->d = d;
+	}
+
+	int threshold() {
+		int n = recordCount * SLOTS * 2;
+		return n < SCAN_THRESHOLD ? SCAN_THRESHOLD : n;
+	}
+
+	void scan(Record* r) {
+		// adopt what terminated threads left behind
+		if (orphans != null) {
+			Orphans* list = (Orphans*)eso_atomic_test_and_setptr((volatile es_intptr_t*)&orphans, null);
+			while (list != null) {
+				Orphans* o = list;
+				list = o->next;
+				for (int i = 0; i < o->count; i++) {
+					append(r, o->items[i].p, o->items[i].d);
+				}
+				eso_atomic_sub_and_fetch32(&orphanCount, o->count);
+				eso_free(o->items);
+				eso_free(o);
+			}
+		}
+
+		// snapshot the announced pointers
+		int cap = (recordCount + 4) * SLOTS;
+		void** hazards = (void**)eso_malloc(cap * sizeof(void*));
+		int nh = 0;
+		EUnsafe::fullFence();
+		for (Record* q = records; q != null; q = q->next) {
+			for (int i = 0; i < SLOTS; i++) {
+				void* p = q->hp[i];
+				if (p != null) {
+					if (nh == cap) {
+						cap <<= 1;
+						hazards = (void**)eso_realloc(hazards, cap * sizeof(void*));
+					}
+					hazards[nh++] = p;
+				}
+			}
+		}
+		std::sort(hazards, hazards + nh);
+
+		// detach first: a deleter may retire further objects
+		Retired* list = r->retired;
+		int n = r->count;
+		int capacity = r->capacity;
+		r->retired = null;
+		r->count = r->capacity = 0;
+
+		int kept = 0;
+		for (int i = 0; i < n; i++) {
+			if (std::binary_search(hazards, hazards + nh, list[i].p)) {
+				list[kept++] = list[i];
+			} else {
+				list[i].d(list[i].p);
+			}
+		}
+		eso_free(hazards);
+
+		if (r->count == 0) {
+			eso_free(r->retired);
+			r->retired = list;
+			r->count = kept;
+			r->capacity = capacity;
+		} else {
+			for (int i = 0; i < kept; i++) {
+				append(r, list[i].p, list[i].d);
+			}
+			eso_free(list);
+		}
+	}
+};
+
+EHazardPointer::EHazardPointer() {
+	record = Domain::get()->current();
+	for (int i = 0; i < SLOTS; i++) {
+		if ((record->used & (1 << i)) == 0) {
+			record->used |= (1 << i);
+			index = i;
+			slot = &record->hp[i];
+			return;
+		}
+	}
+	throw EIllegalStateException(__FILE__, __LINE__, "no free hazard slot");
+}
+
+EHazardPointer::~EHazardPointer() {
+	clear();
+	record->used &= ~(1 << index);
+}
+
+void EHazardPointer::retire(void* p, Deleter d) {
+	if (p == null) {
+		return;
+	}
+	Domain* dm = Domain::get();
+	Record* r = dm->current();
+	Domain::append(r, p, d);
+	if (r->count >= dm->threshold()) {
+		dm->scan(r);
+	}
+}
+
+void EHazardPointer::reclaim() {
+	Domain* dm = Domain::get();
+	dm->scan(dm->current());
+}
+
+llong EHazardPointer::getPendingCount() {
+	Domain* dm = Domain::get();
+	llong n = dm->orphanCount;
+	for (Record* r = dm->records; r != null; r = r->next) {
+		n += r->count;
+	}
+	return n;
+}
+
+} /* namespace efc */
@@ -0,0 +1,113 @@
+/*
+ * ELongAccumulator.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/ELongAccumulator.hh"
+#include "../../inc/concurrent/EThreadLocalRandom.hh"
+#include "../../inc/concurrent/EOrderAccess.hh"
+#include "../../inc/ENullPointerException.hh"
+#include "../../inc/ELLong.hh"
+
+namespace efc {
+
+ELongAccumulator::~ELongAccumulator() {
+}
+
+ELongAccumulator::ELongAccumulator(sp<ELongBinaryOperator> accumulatorFunction,
+		llong identity) : function(accumulatorFunction), identity(identity) {
+	if (function == null)
+		throw ENullPointerException(__FILE__, __LINE__);
+	base = identity;
+}
+
+#ifdef CPP11_SUPPORT
+ELongAccumulator::ELongAccumulator(std::function<llong(llong, llong)> accumulatorFunction,
+		llong identity) : identity(identity) {
+	function = new ELongBinaryOperatorTarget(accumulatorFunction);
+	base = identity;
+}
+#endif
+
+void ELongAccumulator::accumulate(llong x) {
+	Cells* as; llong b, v, r; int m; Cell* a;
+	ELongBinaryOperator* fn = function.get();
+	if ((as = (Cells*)EOrderAccess::load_ptr_acquire(&cells)) != null ||
+			((b = base), (r = fn->applyAsLong(b, x)) != b && !casBase(b, r))) {
+		boolean uncontended = true;
+		if (as == null || (m = as->length - 1) < 0 ||
+				(a = (Cell*)EOrderAccess::load_ptr_acquire(
+						&as->cells[EThreadLocalRandom::getProbe() & m])) == null ||
+				!(uncontended = ((v = a->value),
+						(r = fn->applyAsLong(v, x)) == v || a->cas(v, r))))
+			longAccumulate(x, fn, uncontended);
+	}
+}
+
+llong ELongAccumulator::get() {
+	Cells* as = (Cells*)EOrderAccess::load_ptr_acquire(&cells);
+	ELongBinaryOperator* fn = function.get();
+	llong result = base;
+	if (as != null) {
+		for (int i = 0; i < as->length; ++i) {
+			Cell* a = (Cell*)EOrderAccess::load_ptr_acquire(&as->cells[i]);
+			if (a != null)
+				result = fn->applyAsLong(result, a->value);
+		}
+	}
+	return result;
+}
+
+void ELongAccumulator::reset() {
+	Cells* as = (Cells*)EOrderAccess::load_ptr_acquire(&cells);
+	base = identity;
+	if (as != null) {
+		for (int i = 0; i < as->length; ++i) {
+			Cell* a = (Cell*)EOrderAccess::load_ptr_acquire(&as->cells[i]);
+			if (a != null)
+				a->value = identity;
+		}
+	}
+}
+
+llong ELongAccumulator::getThenReset() {
+	Cells* as = (Cells*)EOrderAccess::load_ptr_acquire(&cells);
+	ELongBinaryOperator* fn = function.get();
+	llong result = base;
+	base = identity;
+	if (as != null) {
+		for (int i = 0; i < as->length; ++i) {
+			Cell* a = (Cell*)EOrderAccess::load_ptr_acquire(&as->cells[i]);
+			if (a != null) {
+				llong v = a->value;
+				a->value = identity;
+				result = fn->applyAsLong(result, v);
+			}
+		}
+	}
+	return result;
+}
+
+EStringBase ELongAccumulator::toString() {
+	return ELLong::toString(get());
+}
+
+llong ELongAccumulator::llongValue() {
+	return get();
+}
+
+int ELongAccumulator::intValue() {
+	return (int)get();
+}
+
+float ELongAccumulator::floatValue() {
+	return (float)get();
+}
+
+double ELongAccumulator::doubleValue() {
+	return (double)get();
+}
+
+} /* namespace efc */
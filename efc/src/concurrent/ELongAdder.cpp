@@ -0,0 +1,103 @@
+/*
+ * ELongAdder.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/ELongAdder.hh"
+#include "../../inc/concurrent/EThreadLocalRandom.hh"
+#include "../../inc/concurrent/EOrderAccess.hh"
+#include "../../inc/ELLong.hh"
+
+namespace efc {
+
+ELongAdder::~ELongAdder() {
+}
+
+ELongAdder::ELongAdder() {
+}
+
+void ELongAdder::add(llong x) {
+	Cells* as; llong b, v; int m; Cell* a;
+	if ((as = (Cells*)EOrderAccess::load_ptr_acquire(&cells)) != null ||
+			!((b = base), casBase(b, b + x))) {
+		boolean uncontended = true;
+		if (as == null || (m = as->length - 1) < 0 ||
+				(a = (Cell*)EOrderAccess::load_ptr_acquire(
+						&as->cells[EThreadLocalRandom::getProbe() & m])) == null ||
+				!(uncontended = ((v = a->value), a->cas(v, v + x))))
+			longAccumulate(x, null, uncontended);
+	}
+}
+
+void ELongAdder::increment() {
+	add(1L);
+}
+
+void ELongAdder::decrement() {
+	add(-1L);
+}
+
+llong ELongAdder::sum() {
+	Cells* as = (Cells*)EOrderAccess::load_ptr_acquire(&cells);
+	llong sum = base;
+	if (as != null) {
+		for (int i = 0; i < as->length; ++i) {
+			Cell* a = (Cell*)EOrderAccess::load_ptr_acquire(&as->cells[i]);
+			if (a != null)
+				sum += a->value;
+		}
+	}
+	return sum;
+}
+
+void ELongAdder::reset() {
+	Cells* as = (Cells*)EOrderAccess::load_ptr_acquire(&cells);
+	base = 0L;
+	if (as != null) {
+		for (int i = 0; i < as->length; ++i) {
+			Cell* a = (Cell*)EOrderAccess::load_ptr_acquire(&as->cells[i]);
+			if (a != null)
+				a->value = 0L;
+		}
+	}
+}
+
+llong ELongAdder::sumThenReset() {
+	Cells* as = (Cells*)EOrderAccess::load_ptr_acquire(&cells);
+	llong sum = base;
+	base = 0L;
+	if (as != null) {
+		for (int i = 0; i < as->length; ++i) {
+			Cell* a = (Cell*)EOrderAccess::load_ptr_acquire(&as->cells[i]);
+			if (a != null) {
+				sum += a->value;
+				a->value = 0L;
+			}
+		}
+	}
+	return sum;
+}
+
+EStringBase ELongAdder::toString() {
+	return ELLong::toString(sum());
+}
+
+llong ELongAdder::llongValue() {
+	return sum();
+}
+
+int ELongAdder::intValue() {
+	return (int)sum();
+}
+
+float ELongAdder::floatValue() {
+	return (float)sum();
+}
+
+double ELongAdder::doubleValue() {
+	return (double)sum();
+}
+
+} /* namespace efc */
@@ -0,0 +1,676 @@
+/*
+ * EPhaser.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/EPhaser.hh"
+#include "../../inc/concurrent/ELockSupport.hh"
+#include "../../inc/concurrent/ESpinControl.hh"
+#include "../../inc/ERuntime.hh"
+#include "../../inc/ESystem.hh"
+
+namespace efc {
+
+/*
+ * The implementation follows Phaser.java except for the wait stacks.
+ * The JDK pops waiters one by one with a CAS on the head and leaves the
+ * garbage to the collector; here a releaser detaches a whole stack with
+ * one swap, so it owns every node it looks at, and each node carries a
+ * reference count shared by its waiter and the stack.  A node's thread
+ * field is claimed exactly once with a CAS: by the releaser, which then
+ * unparks the thread and hands the node over to it, or by the waiter
+ * itself when it leaves on its own (phase seen advanced, interrupt or
+ * timeout), which leaves the stack's reference to the next releaser.
+ */
+
+static const int  MAX_PARTIES     = 0xffff;
+static const int  MAX_PHASE       = 0x7fffffff;
+static const int  PARTIES_SHIFT   = 16;
+static const int  PHASE_SHIFT     = 32;
+static const int  UNARRIVED_MASK  = 0xffff;      // to mask ints
+static const llong PARTIES_MASK   = 0xffff0000L; // to mask longs
+static const llong COUNTS_MASK    = 0xffffffffL;
+static const llong TERMINATION_BIT = 1LL << 63;
+
+// some special values
+static const int  ONE_ARRIVAL     = 1;
+static const int  ONE_PARTY       = 1 << PARTIES_SHIFT;
+static const int  ONE_DEREGISTER  = ONE_ARRIVAL|ONE_PARTY;
+static const int  EMPTY           = 1;
+
+// The following unpacking methods are usually manually inlined
+
+static inline int unarrivedOf(llong s) {
+	int counts = (int)s;
+	return (counts == EMPTY) ? 0 : (counts & UNARRIVED_MASK);
+}
+
+static inline int partiesOf(llong s) {
+	return (int)((uint)s >> PARTIES_SHIFT);
+}
+
+static inline int phaseOf(llong s) {
+	return (int)((ullong)s >> PHASE_SHIFT);
+}
+
+static inline int arrivedOf(llong s) {
+	int counts = (int)s;
+	return (counts == EMPTY) ? 0 :
+		(int)((uint)counts >> PARTIES_SHIFT) - (counts & UNARRIVED_MASK);
+}
+
+/** The number of CPUs, for spin control */
+static int NCPU = 0;
+
+/**
+ * The number of times to spin before blocking while waiting for
+ * advance, per arrival while waiting. On multiprocessors, fully
+ * blocking and waking up a large number of threads all at once is
+ * usually a very slow process, so we use rechargeable spins to
+ * avoid it when threads regularly arrive: When a thread in
+ * internalAwaitAdvance notices another arrival before blocking,
+ * and there appear to be enough CPUs available, it spins
+ * SPINS_PER_ARRIVAL more times before blocking. The value trades
+ * off good-citizenship vs big unnecessary slowdowns.
+ */
+static int spinsPerArrival() {
+	if (NCPU == 0) {
+		NCPU = ERuntime::getRuntime()->availableProcessors();
+	}
+	return (NCPU < 2) ? 1 : 1 << 8;
+}
+
+namespace phaser {
+
+/**
+ * Wait node of a thread blocked in internalAwaitAdvance.
+ */
+class QNode {
+public:
+	EPhaser* phaser;
+	int phase;
+	boolean interruptible;
+	boolean timed;
+	boolean wasInterrupted;
+	llong nanos;
+	llong deadline;
+	EThread* self;
+	EThread* volatile thread; // claimed (set to null) exactly once
+	QNode* next;              // owned by whoever holds the stack or list
+	QNode* handoff;           // nodes the claimed waiter wakes in turn
+	volatile int refs;        // waiter + stack
+
+	QNode(EPhaser* phaser, int phase, boolean interruptible,
+			boolean timed, llong nanos) :
+			phaser(phaser), phase(phase), interruptible(interruptible),
+			timed(timed), wasInterrupted(false), nanos(nanos),
+			next(null), handoff(null), refs(1) {
+		self = thread = EThread::currentThread();
+		deadline = timed ? ESystem::nanoTime() + nanos : 0L;
+	}
+
+	boolean isReleasable() {
+		if (thread == null)
+			return true;
+		if (phaser->getPhase() != phase)
+			return true;
+		if (EThread::interrupted())
+			wasInterrupted = true;
+		if (wasInterrupted && interruptible)
+			return true;
+		if (timed) {
+			if (nanos > 0L) {
+				nanos = deadline - ESystem::nanoTime();
+			}
+			if (nanos <= 0L)
+				return true;
+		}
+		return false;
+	}
+
+	void block() {
+		if (isReleasable())
+			return;
+		else if (!timed)
+			ELockSupport::park();
+		else if (nanos > 0L)
+			ELockSupport::parkNanos(nanos);
+	}
+
+	void release() {
+		if (eso_atomic_sub_and_fetch32(&refs, 1) == 0) {
+			delete this;
+		}
+	}
+};
+
+static void push(QNode* volatile* head, QNode* node) {
+	QNode* h;
+	do {
+		h = *head;
+		node->next = h;
+	} while (!eso_atomic_compare_and_swapptr((void* volatile*)head, h, node));
+}
+
+/**
+ * Wakes every node of {@code list} as a tree: each claimed waiter is
+ * handed the second half of what is left and wakes it after it
+ * returns, while the caller goes on with the first half.
+ */
+static void wakeAll(QNode* list) {
+	while (list != null) {
+		QNode* q = list;
+		QNode* rest = q->next;
+
+		QNode* theirs = null;
+		int n = 0;
+		for (QNode* p = rest; p != null; p = p->next) {
+			n++;
+		}
+		if (n > 1) {
+			QNode* p = rest;
+			for (int i = 1; i < (n >> 1); i++) {
+				p = p->next;
+			}
+			theirs = p->next;
+			p->next = null;
+		}
+
+		EThread* t = q->thread;
+		q->handoff = theirs;
+		if (t != null && eso_atomic_compare_and_swapptr((void* volatile*)&q->thread, t, null)) {
+			// the waiter owns q and theirs from now on
+			ELockSupport::unpark(t);
+		} else {
+			q->handoff = null; // waiter has gone already
+			q->release();
+			if (theirs != null) {
+				QNode* p = theirs;
+				while (p->next != null) {
+					p = p->next;
+				}
+				p->next = rest;
+				rest = theirs;
+			}
+		}
+		list = rest;
+	}
+}
+
+/**
+ * Called by a waiter when it stops waiting; frees or hands back its
+ * node and wakes the nodes it was handed.
+ */
+static void leave(QNode* node, boolean queued) {
+	if (!queued) {
+		delete node;
+		return;
+	}
+	if (eso_atomic_compare_and_swapptr((void* volatile*)&node->thread, node->self, null)) {
+		node->release(); // the stack still holds it
+		return;
+	}
+	// claimed: the releaser no longer touches the node
+	QNode* handoff = node->handoff;
+	delete node;
+	wakeAll(handoff);
+}
+
+} /* namespace phaser */
+
+using phaser::QNode;
+
+EPhaser::~EPhaser() {
+	if (root == this) {
+		QNode* q = evenQ_;
+		while (q != null) {
+			QNode* n = q->next;
+			q->release();
+			q = n;
+		}
+		q = oddQ_;
+		while (q != null) {
+			QNode* n = q->next;
+			q->release();
+			q = n;
+		}
+	}
+}
+
+EPhaser::EPhaser(int parties) : evenQ_(null), oddQ_(null) {
+	init(parties);
+}
+
+EPhaser::EPhaser(sp<EPhaser> parent, int parties) :
+		parent(parent), evenQ_(null), oddQ_(null) {
+	init(parties);
+}
+
+void EPhaser::init(int parties) {
+	if ((uint)parties >> PARTIES_SHIFT != 0)
+		throw EIllegalArgumentException(__FILE__, __LINE__, "Illegal number of parties");
+	int phase = 0;
+	if (parent != null) {
+		EPhaser* r = parent->root;
+		this->root = r;
+		this->evenQ = r->evenQ;
+		this->oddQ = r->oddQ;
+		if (parties != 0)
+			phase = parent->doRegister(1);
+	}
+	else {
+		this->root = this;
+		this->evenQ = &evenQ_;
+		this->oddQ = &oddQ_;
+	}
+	this->state = (parties == 0) ? (llong)EMPTY :
+		((llong)phase << PHASE_SHIFT) |
+		((llong)parties << PARTIES_SHIFT) |
+		((llong)parties);
+}
+
+int EPhaser::doArrive(int adjust) {
+	EPhaser* root = this->root;
+	for (;;) {
+		llong s = (root == this) ? state : reconcileState();
+		int phase = (int)((ullong)s >> PHASE_SHIFT);
+		if (phase < 0)
+			return phase;
+		int counts = (int)s;
+		int unarrived = (counts == EMPTY) ? 0 : (counts & UNARRIVED_MASK);
+		if (unarrived <= 0)
+			throw EIllegalStateException(__FILE__, __LINE__, ("Attempted arrival of unregistered party for " + stateToString(s)).c_str());
+		llong ns = s - adjust;
+		if (eso_atomic_compare_and_swap64(&state, s, ns)) {
+			s = ns;
+			if (unarrived == 1) {
+				llong n = s & PARTIES_MASK;  // base of next state
+				int nextUnarrived = (int)((uint)n >> PARTIES_SHIFT);
+				if (root == this) {
+					if (onAdvance(phase, nextUnarrived))
+						n |= TERMINATION_BIT;
+					else if (nextUnarrived == 0)
+						n |= EMPTY;
+					else
+						n |= nextUnarrived;
+					int nextPhase = (phase + 1) & MAX_PHASE;
+					n |= (llong)nextPhase << PHASE_SHIFT;
+					eso_atomic_compare_and_swap64(&state, s, n);
+					releaseWaiters(phase);
+				}
+				else if (nextUnarrived == 0) { // propagate deregistration
+					phase = parent->doArrive(ONE_DEREGISTER);
+					eso_atomic_compare_and_swap64(&state, s, s | EMPTY);
+				}
+				else
+					phase = parent->doArrive(ONE_ARRIVAL);
+			}
+			return phase;
+		}
+	}
+}
+
+int EPhaser::doRegister(int registrations) {
+	// adjustment to state
+	llong adjust = ((llong)registrations << PARTIES_SHIFT) | registrations;
+	EPhaser* parent = this->parent.get();
+	int phase;
+	for (;;) {
+		llong s = (parent == null) ? state : reconcileState();
+		int counts = (int)s;
+		int parties = (int)((uint)counts >> PARTIES_SHIFT);
+		int unarrived = counts & UNARRIVED_MASK;
+		if (registrations > MAX_PARTIES - parties)
+			throw EIllegalStateException(__FILE__, __LINE__,
+					EStringBase::formatOf("Attempt to register more than %d parties for %s",
+							MAX_PARTIES, stateToString(s).c_str()).c_str());
+		phase = (int)((ullong)s >> PHASE_SHIFT);
+		if (phase < 0)
+			break;
+		if (counts != EMPTY) {                  // not 1st registration
+			if (parent == null || reconcileState() == s) {
+				if (unarrived == 0) {           // wait out advance
+					boolean interrupted;
+					root->internalAwaitAdvance(phase, false, false, 0L, &interrupted);
+				}
+				else if (eso_atomic_compare_and_swap64(&state, s, s + adjust))
+					break;
+			}
+		}
+		else if (parent == null) {              // 1st root registration
+			llong next = ((llong)phase << PHASE_SHIFT) | adjust;
+			if (eso_atomic_compare_and_swap64(&state, s, next))
+				break;
+		}
+		else {
+			boolean done = false;
+			SYNCHRONIZED(this) {                 // 1st sub registration
+				if (state == s) {               // recheck under lock
+					phase = parent->doRegister(1);
+					done = true;
+					if (phase >= 0) {
+						// finish registration whenever parent registration
+						// succeeded, even when racing with termination,
+						// since these are part of the same "transaction".
+						while (!eso_atomic_compare_and_swap64(&state, s,
+								((llong)phase << PHASE_SHIFT) | adjust)) {
+							s = state;
+							phase = (int)((ullong)root->state >> PHASE_SHIFT);
+							// assert (int)s == EMPTY;
+						}
+					}
+				}
+			}}
+			if (done)
+				break;
+		}
+	}
+	return phase;
+}
+
+llong EPhaser::reconcileState() {
+	EPhaser* root = this->root;
+	llong s = state;
+	if (root != this) {
+		int phase, p;
+		// CAS to root phase with current parties, tripping unarrived
+		while ((phase = (int)((ullong)root->state >> PHASE_SHIFT)) !=
+			   (int)((ullong)s >> PHASE_SHIFT)) {
+			llong ns = (((llong)phase << PHASE_SHIFT) |
+					((phase < 0) ? (s & COUNTS_MASK) :
+					 (((p = (int)((uint)s >> PARTIES_SHIFT)) == 0) ? EMPTY :
+					  ((s & PARTIES_MASK) | p))));
+			if (eso_atomic_compare_and_swap64(&state, s, ns)) {
+				s = ns;
+				break;
+			}
+			s = state;
+		}
+	}
+	return s;
+}
+
+int EPhaser::register_() {
+	return doRegister(1);
+}
+
+int EPhaser::bulkRegister(int parties) {
+	if (parties < 0)
+		throw EIllegalArgumentException(__FILE__, __LINE__);
+	if (parties == 0)
+		return getPhase();
+	return doRegister(parties);
+}
+
+int EPhaser::arrive() {
+	return doArrive(ONE_ARRIVAL);
+}
+
+int EPhaser::arriveAndDeregister() {
+	return doArrive(ONE_DEREGISTER);
+}
+
+int EPhaser::arriveAndAwaitAdvance() {
+	// Specialization of doArrive+awaitAdvance eliminating some reads/paths
+	EPhaser* root = this->root;
+	for (;;) {
+		llong s = (root == this) ? state : reconcileState();
+		int phase = (int)((ullong)s >> PHASE_SHIFT);
+		if (phase < 0)
+			return phase;
+		int counts = (int)s;
+		int unarrived = (counts == EMPTY) ? 0 : (counts & UNARRIVED_MASK);
+		if (unarrived <= 0)
+			throw EIllegalStateException(__FILE__, __LINE__, ("Attempted arrival of unregistered party for " + stateToString(s)).c_str());
+		llong ns = s - ONE_ARRIVAL;
+		if (eso_atomic_compare_and_swap64(&state, s, ns)) {
+			s = ns;
+			if (unarrived > 1) {
+				boolean interrupted;
+				return root->internalAwaitAdvance(phase, false, false, 0L, &interrupted);
+			}
+			if (root != this)
+				return parent->arriveAndAwaitAdvance();
+			llong n = s & PARTIES_MASK;  // base of next state
+			int nextUnarrived = (int)((uint)n >> PARTIES_SHIFT);
+			if (onAdvance(phase, nextUnarrived))
+				n |= TERMINATION_BIT;
+			else if (nextUnarrived == 0)
+				n |= EMPTY;
+			else
+				n |= nextUnarrived;
+			int nextPhase = (phase + 1) & MAX_PHASE;
+			n |= (llong)nextPhase << PHASE_SHIFT;
+			if (!eso_atomic_compare_and_swap64(&state, s, n))
+				return (int)((ullong)state >> PHASE_SHIFT); // terminated
+			releaseWaiters(phase);
+			return nextPhase;
+		}
+	}
+}
+
+int EPhaser::awaitAdvance(int phase) {
+	EPhaser* root = this->root;
+	llong s = (root == this) ? state : reconcileState();
+	int p = (int)((ullong)s >> PHASE_SHIFT);
+	if (phase < 0)
+		return phase;
+	if (p == phase) {
+		boolean interrupted;
+		return root->internalAwaitAdvance(phase, false, false, 0L, &interrupted);
+	}
+	return p;
+}
+
+int EPhaser::awaitAdvanceInterruptibly(int phase) {
+	EPhaser* root = this->root;
+	llong s = (root == this) ? state : reconcileState();
+	int p = (int)((ullong)s >> PHASE_SHIFT);
+	if (phase < 0)
+		return phase;
+	if (p == phase) {
+		boolean interrupted;
+		p = root->internalAwaitAdvance(phase, true, false, 0L, &interrupted);
+		if (interrupted)
+			throw EInterruptedException(__FILE__, __LINE__);
+	}
+	return p;
+}
+
+int EPhaser::awaitAdvanceInterruptibly(int phase, llong timeout, ETimeUnit* unit) {
+	llong nanos = unit->toNanos(timeout);
+	EPhaser* root = this->root;
+	llong s = (root == this) ? state : reconcileState();
+	int p = (int)((ullong)s >> PHASE_SHIFT);
+	if (phase < 0)
+		return phase;
+	if (p == phase) {
+		boolean interrupted;
+		p = root->internalAwaitAdvance(phase, true, true, nanos, &interrupted);
+		if (interrupted)
+			throw EInterruptedException(__FILE__, __LINE__);
+		else if (p == phase)
+			throw ETimeoutException(__FILE__, __LINE__);
+	}
+	return p;
+}
+
+void EPhaser::forceTermination() {
+	// Only need to change root state
+	EPhaser* root = this->root;
+	llong s;
+	while ((s = root->state) >= 0) {
+		if (eso_atomic_compare_and_swap64(&root->state, s, s | TERMINATION_BIT)) {
+			// signal all threads
+			root->releaseWaiters(0); // Waiters on evenQ
+			root->releaseWaiters(1); // Waiters on oddQ
+			return;
+		}
+	}
+}
+
+int EPhaser::getPhase() {
+	return (int)((ullong)root->state >> PHASE_SHIFT);
+}
+
+int EPhaser::getRegisteredParties() {
+	return partiesOf(state);
+}
+
+int EPhaser::getArrivedParties() {
+	return arrivedOf(reconcileState());
+}
+
+int EPhaser::getUnarrivedParties() {
+	return unarrivedOf(reconcileState());
+}
+
+sp<EPhaser> EPhaser::getParent() {
+	return parent;
+}
+
+EPhaser* EPhaser::getRoot() {
+	return root;
+}
+
+boolean EPhaser::isTerminated() {
+	return root->state < 0L;
+}
+
+boolean EPhaser::onAdvance(int phase, int registeredParties) {
+	return registeredParties == 0;
+}
+
+EStringBase EPhaser::toString() {
+	return stateToString(reconcileState());
+}
+
+EStringBase EPhaser::stateToString(llong s) {
+	return EObject::toString() + EStringBase::formatOf("[phase = %d parties = %d arrived = %d]",
+			phaseOf(s), partiesOf(s), arrivedOf(s)).c_str();
+}
+
+// Waiting mechanics
+
+/**
+ * Removes and signals threads from queue for phase, and drops the
+ * nodes of waiters that have left.  Nodes of the current phase are
+ * pushed back; if the phase moved meanwhile they may be stale, so the
+ * stack is scanned again.
+ */
+void EPhaser::releaseWaiters(int phase) {
+	QNode* volatile* head = (phase & 1) == 0 ? evenQ : oddQ;
+	for (;;) {
+		if (*head == null)
+			return;
+		QNode* q = (QNode*)eso_atomic_test_and_setptr((es_intptr_t*)head, null);
+		int p = (int)((ullong)root->state >> PHASE_SHIFT);
+		QNode* wake = null;
+		QNode* keep = null;
+		while (q != null) {
+			QNode* n = q->next;
+			if (q->phase != p) {
+				q->next = wake;
+				wake = q;
+			} else if (q->thread == null) {
+				q->release();
+			} else {
+				q->next = keep;
+				keep = q;
+			}
+			q = n;
+		}
+		phaser::wakeAll(wake);
+		if (keep == null)
+			return;
+		while (keep != null) {
+			QNode* n = keep->next;
+			phaser::push(head, keep);
+			keep = n;
+		}
+		if ((int)((ullong)root->state >> PHASE_SHIFT) == p)
+			return;
+	}
+}
+
+/**
+ * Variant of releaseWaiters that additionally tries to remove any
+ * nodes no longer waiting for advance due to timeout or
+ * interrupt.
+ *
+ * @return current phase on exit
+ */
+int EPhaser::abortWait(int phase) {
+	releaseWaiters(phase);
+	return (int)((ullong)root->state >> PHASE_SHIFT);
+}
+
+/**
+ * Possibly blocks and waits for phase to advance unless aborted.
+ * Call only on root phaser.
+ *
+ * @param phase current phase
+ * @param interruptible, timed, nanos the kind of wait; an untimed,
+ * uninterruptible wait spins before it blocks
+ * @param interrupted set if the thread was interrupted while waiting
+ * @return current phase
+ */
+int EPhaser::internalAwaitAdvance(int phase, boolean interruptible,
+		boolean timed, llong nanos, boolean* interrupted) {
+	// assert root == this;
+	releaseWaiters(phase-1);          // ensure old queue clean
+	QNode* node = null;
+	if (interruptible || timed) {
+		node = new QNode(this, phase, interruptible, timed, nanos);
+	}
+	boolean queued = false;           // true when node is enqueued
+	int lastUnarrived = 0;            // to increase spins upon change
+	int spins = spinsPerArrival();
+	llong s;
+	int p;
+	*interrupted = false;
+	while ((p = (int)((ullong)(s = state) >> PHASE_SHIFT)) == phase) {
+		if (node == null) {           // spinning in noninterruptible mode
+			int unarrived = (int)s & UNARRIVED_MASK;
+			if (unarrived != lastUnarrived &&
+				(lastUnarrived = unarrived) < NCPU)
+				spins += spinsPerArrival();
+			boolean wasInterrupted = EThread::interrupted();
+			if (wasInterrupted || --spins < 0) { // need node to record intr
+				node = new QNode(this, phase, false, false, 0L);
+				node->wasInterrupted = wasInterrupted;
+			} else {
+				ESpinControl::pause();
+			}
+		}
+		else if (node->isReleasable()) // done or aborted
+			break;
+		else if (!queued) {           // push onto queue
+			QNode* volatile* head = (phase & 1) == 0 ? evenQ : oddQ;
+			QNode* q = node->next = *head;
+			node->refs = 2;
+			if ((int)((ullong)state >> PHASE_SHIFT) == phase) // avoid stale enq
+				queued = eso_atomic_compare_and_swapptr((void* volatile*)head, q, node);
+			if (!queued)
+				node->refs = 1;
+		}
+		else {
+			node->block();
+		}
+	}
+
+	if (node != null) {
+		*interrupted = node->wasInterrupted;
+		phaser::leave(node, queued);
+		if (*interrupted && !interruptible)
+			EThread::currentThread()->interrupt();
+		if (p == phase && (p = (int)((ullong)state >> PHASE_SHIFT)) == phase)
+			return abortWait(phase); // possibly clean up on abort
+	}
+	releaseWaiters(phase);
+	return p;
+}
+
+} /* namespace efc */
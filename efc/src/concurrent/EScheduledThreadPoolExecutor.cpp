@@ -0,0 +1,523 @@
+/*
+ * EScheduledThreadPoolExecutor.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/EScheduledThreadPoolExecutor.hh"
+#include "../../inc/concurrent/EExecutors.hh"
+#include "../../inc/concurrent/EAtomicLLong.hh"
+#include "../../inc/ELLong.hh"
+#include "../../inc/EInteger.hh"
+
+namespace efc {
+
+namespace stpe {
+
+/**
+ * The thread advancing a timing wheel.
+ */
+class Ticker : public EThread {
+public:
+	Ticker(TimingWheel* wheel) : wheel(wheel) {
+	}
+	virtual void run() {
+		wheel->run();
+	}
+private:
+	TimingWheel* wheel;
+};
+
+TimingWheel::~TimingWheel() {
+	stop();
+
+	// break the entries' references to themselves.
+	for (int l = 0; l < LEVELS; l++) {
+		for (int i = 0; i < WHEEL_SIZE; i++) {
+			TimerEntry* e = wheel[l][i];
+			wheel[l][i] = null;
+			while (e != null) {
+				TimerEntry* next = e->next;
+				e->next = e->prev = null;
+				e->slot = null;
+				sp<ERunnable> self = e->self;
+				e->self = null;
+				e = next;
+			}
+		}
+	}
+	delete ticked;
+}
+
+TimingWheel::TimingWheel(EBlockingQueue<ERunnable>* expired, llong tickNanos) :
+		expired(expired), ticker(null), startTime(ESystem::nanoTime()),
+		tickNanos(tickNanos), currentTick(0), count(0), stopped(false) {
+	ticked = lock.newCondition();
+	for (int l = 0; l < LEVELS; l++) {
+		for (int i = 0; i < WHEEL_SIZE; i++) {
+			wheel[l][i] = null;
+		}
+	}
+}
+
+void TimingWheel::add(TimerEntry* e, sp<ERunnable> task) {
+	llong d = e->deadline - startTime;
+	e->expireTick = (d <= 0L) ? 0L : (d / tickNanos + ((d % tickNanos != 0) ? 1 : 0));
+	SYNCBLOCK(&lock) {
+		e->self = task;
+		place(e);
+		if (count++ == 0) {
+			if (ticker == null && !stopped) {
+				ticker = new Ticker(this);
+				ticker->setDaemon(true);
+				ticker->setName("ScheduledThreadPoolExecutor-ticker");
+				ticker->start();
+			}
+			ticked->signal();
+		}
+	}}
+}
+
+boolean TimingWheel::remove(TimerEntry* e) {
+	sp<ERunnable> task; // released out of the lock
+	SYNCBLOCK(&lock) {
+		if (e->slot == null)
+			return false;
+		unlink(e);
+		count--;
+		task = e->self;
+		e->self = null;
+	}}
+	return true;
+}
+
+void TimingWheel::removeAll(boolean periodic,
+		EArrayList<sp<ERunnable> >* removed) {
+	SYNCBLOCK(&lock) {
+		for (int l = 0; l < LEVELS; l++) {
+			for (int i = 0; i < WHEEL_SIZE; i++) {
+				TimerEntry* e = wheel[l][i];
+				while (e != null) {
+					TimerEntry* next = e->next;
+					if (e->isPeriodic() == periodic) {
+						unlink(e);
+						count--;
+						removed->add(e->self);
+						e->self = null;
+					}
+					e = next;
+				}
+			}
+		}
+	}}
+}
+
+int TimingWheel::drainTo(ECollection<sp<ERunnable> >* c, int maxElements) {
+	int n = 0;
+	SYNCBLOCK(&lock) {
+		for (int l = 0; l < LEVELS && n < maxElements; l++) {
+			for (int i = 0; i < WHEEL_SIZE && n < maxElements; i++) {
+				TimerEntry* e;
+				while (n < maxElements && (e = wheel[l][i]) != null) {
+					unlink(e);
+					count--;
+					c->add(e->self);
+					e->self = null;
+					n++;
+				}
+			}
+		}
+	}}
+	return n;
+}
+
+int TimingWheel::size() {
+	SYNCBLOCK(&lock) {
+		return count;
+	}}
+}
+
+void TimingWheel::stop() {
+	EThread* t;
+	SYNCBLOCK(&lock) {
+		stopped = true;
+		t = ticker;
+		ticker = null;
+		ticked->signal();
+	}}
+	if (t != null) {
+		if (t != EThread::currentThread()) {
+			t->join();
+			delete t;
+		}
+	}
+}
+
+void TimingWheel::run() {
+	lock.lock();
+	try {
+		while (!stopped) {
+			llong now = ESystem::nanoTime();
+			if (count == 0) {
+				// nothing to cascade, so the wheel can jump to now.
+				llong nowTick = (now - startTime) / tickNanos;
+				if (currentTick < nowTick)
+					currentTick = nowTick;
+				ticked->awaitUninterruptibly();
+				continue;
+			}
+			llong wait = startTime + currentTick * tickNanos - now;
+			if (wait > 0L) {
+				ticked->awaitNanos(wait);
+				continue;
+			}
+			TimerEntry* e = advance();
+			if (e == null)
+				continue;
+			lock.unlock();
+			try {
+				while (e != null) {
+					TimerEntry* next = e->next;
+					e->next = null;
+					sp<ERunnable> task = e->self;
+					e->self = null; // before it can be re-added
+					expired->offer(task);
+					e = next;
+				}
+			} catch (...) {
+				lock.lock();
+				throw; //!
+			}
+			lock.lock();
+		}
+	} catch (...) {
+		lock.unlock();
+		throw; //!
+	}
+	lock.unlock();
+}
+
+void TimingWheel::place(TimerEntry* e) {
+	llong delta = e->expireTick - currentTick;
+	TimerEntry** slot;
+	if (delta <= 0L) {
+		slot = &wheel[0][currentTick & WHEEL_MASK];
+	}
+	else {
+		llong span = (llong)1 << (WHEEL_BITS * LEVELS);
+		if (delta >= span)
+			delta = span - 1; // re-placed when it gets there
+		llong when = currentTick + delta;
+		int level = 0;
+		while (level < LEVELS - 1 && delta >= ((llong)1 << (WHEEL_BITS * (level + 1))))
+			level++;
+		slot = &wheel[level][(when >> (WHEEL_BITS * level)) & WHEEL_MASK];
+	}
+	TimerEntry* head = *slot;
+	e->prev = null;
+	e->next = head;
+	if (head != null)
+		head->prev = e;
+	*slot = e;
+	e->slot = slot;
+}
+
+void TimingWheel::unlink(TimerEntry* e) {
+	if (e->prev != null)
+		e->prev->next = e->next;
+	else
+		*e->slot = e->next;
+	if (e->next != null)
+		e->next->prev = e->prev;
+	e->next = e->prev = null;
+	e->slot = null;
+}
+
+TimerEntry* TimingWheel::advance() {
+	llong t = currentTick;
+
+	// cascade the upper levels whose lower levels wrap around now.
+	for (int l = 1; l < LEVELS; l++) {
+		if ((t & (((llong)1 << (WHEEL_BITS * l)) - 1)) != 0)
+			break;
+		int index = (int)((t >> (WHEEL_BITS * l)) & WHEEL_MASK);
+		TimerEntry* e = wheel[l][index];
+		wheel[l][index] = null;
+		while (e != null) {
+			TimerEntry* next = e->next;
+			place(e);
+			e = next;
+		}
+	}
+
+	// take the entries of this tick.
+	TimerEntry** slot = &wheel[0][t & WHEEL_MASK];
+	TimerEntry* e = *slot;
+	*slot = null;
+	TimerEntry* fired = null;
+	while (e != null) {
+		TimerEntry* next = e->next;
+		if (e->expireTick > t) {
+			place(e); // beyond the span of the wheel
+		}
+		else {
+			e->prev = null;
+			e->slot = null;
+			e->next = fired;
+			fired = e;
+			count--;
+		}
+		e = next;
+	}
+	currentTick = t + 1;
+	return fired;
+}
+
+} /* namespace stpe */
+
+//=============================================================================
+
+const llong EScheduledThreadPoolExecutor::DEFAULT_TICK_NANOS;
+
+static EAtomicLLong sequencer;
+
+/**
+ * The default keep-alive time for pool threads.
+ *
+ * Normally, this value is unused because all pool threads will be
+ * core threads, but if a user creates a pool with a corePoolSize
+ * of zero (against our advice), we keep a thread alive as long as
+ * there are queued tasks.  If the keep alive time is zero (the
+ * historic value), we end up hot-spinning in getTask, wasting a
+ * CPU.  But on the other hand, if we set the value too high, and
+ * users create a one-shot pool which they don't cleanly shutdown,
+ * the pool's non-daemon threads will prevent process exit.  A
+ * small but non-zero value seems best.
+ */
+static const llong DEFAULT_KEEPALIVE_MILLIS = 10L;
+
+EScheduledThreadPoolExecutor::~EScheduledThreadPoolExecutor() {
+	delayedQueue->wheel.stop();
+}
+
+EScheduledThreadPoolExecutor::EScheduledThreadPoolExecutor(int corePoolSize) :
+		EThreadPoolExecutor(corePoolSize, EInteger::MAX_VALUE,
+				DEFAULT_KEEPALIVE_MILLIS, ETimeUnit::MILLISECONDS,
+				newDelayedWorkQueue(DEFAULT_TICK_NANOS)),
+		continueExistingPeriodicTasksAfterShutdown(false),
+		executeExistingDelayedTasksAfterShutdown(true),
+		stopping(false) {
+	delayedQueue = dynamic_pointer_cast<stpe::DelayedWorkQueue>(getQueue());
+}
+
+EScheduledThreadPoolExecutor::EScheduledThreadPoolExecutor(int corePoolSize,
+		sp<EThreadFactory> threadFactory) :
+		EThreadPoolExecutor(corePoolSize, EInteger::MAX_VALUE,
+				DEFAULT_KEEPALIVE_MILLIS, ETimeUnit::MILLISECONDS,
+				newDelayedWorkQueue(DEFAULT_TICK_NANOS), threadFactory),
+		continueExistingPeriodicTasksAfterShutdown(false),
+		executeExistingDelayedTasksAfterShutdown(true),
+		stopping(false) {
+	delayedQueue = dynamic_pointer_cast<stpe::DelayedWorkQueue>(getQueue());
+}
+
+EScheduledThreadPoolExecutor::EScheduledThreadPoolExecutor(int corePoolSize,
+		sp<ERejectedExecutionHandler> handler) :
+		EThreadPoolExecutor(corePoolSize, EInteger::MAX_VALUE,
+				DEFAULT_KEEPALIVE_MILLIS, ETimeUnit::MILLISECONDS,
+				newDelayedWorkQueue(DEFAULT_TICK_NANOS), handler),
+		continueExistingPeriodicTasksAfterShutdown(false),
+		executeExistingDelayedTasksAfterShutdown(true),
+		stopping(false) {
+	delayedQueue = dynamic_pointer_cast<stpe::DelayedWorkQueue>(getQueue());
+}
+
+EScheduledThreadPoolExecutor::EScheduledThreadPoolExecutor(int corePoolSize,
+		sp<EThreadFactory> threadFactory,
+		sp<ERejectedExecutionHandler> handler, llong tickNanos) :
+		EThreadPoolExecutor(corePoolSize, EInteger::MAX_VALUE,
+				DEFAULT_KEEPALIVE_MILLIS, ETimeUnit::MILLISECONDS,
+				newDelayedWorkQueue(tickNanos), threadFactory, handler),
+		continueExistingPeriodicTasksAfterShutdown(false),
+		executeExistingDelayedTasksAfterShutdown(true),
+		stopping(false) {
+	delayedQueue = dynamic_pointer_cast<stpe::DelayedWorkQueue>(getQueue());
+}
+
+sp<EBlockingQueue<ERunnable> > EScheduledThreadPoolExecutor::newDelayedWorkQueue(
+		llong tickNanos) {
+	if (tickNanos <= 0L)
+		throw EIllegalArgumentException(__FILE__, __LINE__);
+	return new stpe::DelayedWorkQueue(tickNanos);
+}
+
+llong EScheduledThreadPoolExecutor::nextSequence() {
+	return sequencer.getAndIncrement();
+}
+
+boolean EScheduledThreadPoolExecutor::canRunInCurrentRunState(boolean periodic) {
+	if (!EThreadPoolExecutor::isShutdown())
+		return true;
+	if (stopping || isTerminated())
+		return false;
+	return periodic ? continueExistingPeriodicTasksAfterShutdown :
+			executeExistingDelayedTasksAfterShutdown;
+}
+
+void EScheduledThreadPoolExecutor::delayedExecute(sp<ERunnable> task,
+		stpe::TimerEntry* e) {
+	if (EThreadPoolExecutor::isShutdown()) {
+		getRejectedExecutionHandler()->rejectedExecution(task, this);
+		return;
+	}
+	e->owner = task;
+	if (e->deadline - ESystem::nanoTime() <= 0L) {
+		// already enabled: straight to the workers.
+		EThreadPoolExecutor::execute(task);
+		return;
+	}
+	delayedQueue->wheel.add(e, task);
+	if (EThreadPoolExecutor::isShutdown() &&
+			!canRunInCurrentRunState(e->isPeriodic()) &&
+			delayedQueue->wheel.remove(e))
+		e->cancel(false);
+	else
+		ensurePrestart();
+}
+
+void EScheduledThreadPoolExecutor::reExecutePeriodic(stpe::TimerEntry* e) {
+	if (canRunInCurrentRunState(true)) {
+		delayedQueue->wheel.add(e, e->owner.lock());
+		if (!canRunInCurrentRunState(true) && delayedQueue->wheel.remove(e))
+			e->cancel(false);
+		else
+			ensurePrestart();
+	}
+	else
+		e->cancel(false);
+}
+
+void EScheduledThreadPoolExecutor::removeDelayed(stpe::TimerEntry* e) {
+	sp<ERunnable> task = e->owner.lock();
+	if (task != null)
+		EThreadPoolExecutor::remove(task); // also tries to terminate
+	else
+		delayedQueue->wheel.remove(e);
+}
+
+llong EScheduledThreadPoolExecutor::triggerTime(llong delay, ETimeUnit* unit) {
+	return triggerTime(unit->toNanos((delay < 0) ? 0 : delay));
+}
+
+llong EScheduledThreadPoolExecutor::triggerTime(llong delay) {
+	return ESystem::nanoTime() +
+		((delay < (ELLong::MAX_VALUE >> 1)) ? delay : (ELLong::MAX_VALUE >> 1));
+}
+
+sp<EScheduledFuture<EObject> > EScheduledThreadPoolExecutor::schedule(
+		sp<ERunnable> command, llong delay, ETimeUnit* unit) {
+	if (command == null || unit == null)
+		throw ENullPointerException(__FILE__, __LINE__);
+	sp<ScheduledFutureTask<EObject> > t = new ScheduledFutureTask<EObject>(
+			command, null, triggerTime(delay, unit), 0L, this);
+	delayedExecute(t, t.get());
+	return t;
+}
+
+sp<EScheduledFuture<EObject> > EScheduledThreadPoolExecutor::scheduleAtFixedRate(
+		sp<ERunnable> command, llong initialDelay, llong period, ETimeUnit* unit) {
+	if (command == null || unit == null)
+		throw ENullPointerException(__FILE__, __LINE__);
+	if (period <= 0)
+		throw EIllegalArgumentException(__FILE__, __LINE__);
+	sp<ScheduledFutureTask<EObject> > t = new ScheduledFutureTask<EObject>(
+			command, null, triggerTime(initialDelay, unit),
+			unit->toNanos(period), this);
+	delayedExecute(t, t.get());
+	return t;
+}
+
+sp<EScheduledFuture<EObject> > EScheduledThreadPoolExecutor::scheduleWithFixedDelay(
+		sp<ERunnable> command, llong initialDelay, llong delay, ETimeUnit* unit) {
+	if (command == null || unit == null)
+		throw ENullPointerException(__FILE__, __LINE__);
+	if (delay <= 0)
+		throw EIllegalArgumentException(__FILE__, __LINE__);
+	sp<ScheduledFutureTask<EObject> > t = new ScheduledFutureTask<EObject>(
+			command, null, triggerTime(initialDelay, unit),
+			unit->toNanos(-delay), this);
+	delayedExecute(t, t.get());
+	return t;
+}
+
+void EScheduledThreadPoolExecutor::setContinueExistingPeriodicTasksAfterShutdownPolicy(
+		boolean value) {
+	continueExistingPeriodicTasksAfterShutdown = value;
+	if (!value && isShutdown())
+		onShutdown();
+}
+
+boolean EScheduledThreadPoolExecutor::getContinueExistingPeriodicTasksAfterShutdownPolicy() {
+	return continueExistingPeriodicTasksAfterShutdown;
+}
+
+void EScheduledThreadPoolExecutor::setExecuteExistingDelayedTasksAfterShutdownPolicy(
+		boolean value) {
+	executeExistingDelayedTasksAfterShutdown = value;
+	if (!value && isShutdown())
+		onShutdown();
+}
+
+boolean EScheduledThreadPoolExecutor::getExecuteExistingDelayedTasksAfterShutdownPolicy() {
+	return executeExistingDelayedTasksAfterShutdown;
+}
+
+void EScheduledThreadPoolExecutor::shutdown() {
+	EThreadPoolExecutor::shutdown();
+}
+
+EArrayList<sp<ERunnable> > EScheduledThreadPoolExecutor::shutdownNow() {
+	stopping = true;
+	return EThreadPoolExecutor::shutdownNow();
+}
+
+boolean EScheduledThreadPoolExecutor::isShutdown() {
+	return EThreadPoolExecutor::isShutdown();
+}
+
+boolean EScheduledThreadPoolExecutor::isTerminated() {
+	return EThreadPoolExecutor::isTerminated();
+}
+
+boolean EScheduledThreadPoolExecutor::awaitTermination() {
+	return EThreadPoolExecutor::awaitTermination();
+}
+
+boolean EScheduledThreadPoolExecutor::awaitTermination(llong timeout,
+		ETimeUnit* unit) {
+	return EThreadPoolExecutor::awaitTermination(timeout, unit);
+}
+
+int EScheduledThreadPoolExecutor::getDelayedTaskCount() {
+	return delayedQueue->wheel.size();
+}
+
+void EScheduledThreadPoolExecutor::onShutdown() {
+	EArrayList<sp<ERunnable> > removed;
+	if (!executeExistingDelayedTasksAfterShutdown)
+		delayedQueue->wheel.removeAll(false, &removed);
+	if (!continueExistingPeriodicTasksAfterShutdown)
+		delayedQueue->wheel.removeAll(true, &removed);
+	for (int i = 0; i < removed.size(); i++) {
+		stpe::TimerEntry* e = dynamic_cast<stpe::TimerEntry*>(removed.getAt(i).get());
+		if (e != null)
+			e->cancel(false);
+	}
+}
+
+void EScheduledThreadPoolExecutor::terminated() {
+	delayedQueue->wheel.stop();
+}
+
+} /* namespace efc */
@@ -0,0 +1,92 @@
+/*
+ * ESpinControl.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/ESpinControl.hh"
+#include "../../inc/ESystem.hh"
+#include "../../inc/ERuntime.hh"
+
+namespace efc {
+
+/** Floor of the adaptive budget, so a cold lock still tries a little. */
+#define MIN_SPINS 16
+
+int ESpinControl::ncpu = 0;
+
+ESpinControl::~ESpinControl() {
+}
+
+ESpinControl::ESpinControl(Policy policy, int maxSpins) :
+		policy(policy), maxSpins(maxSpins < 0 ? 0 : maxSpins),
+		spinLimit(MIN_SPINS), avgHoldNanos(0), holdStamp(0), holdSamples(0) {
+}
+
+int ESpinControl::budget() {
+	if (policy == PARK || getNCPU() <= 1)
+		return 0;
+	if (policy == FIXED)
+		return maxSpins;
+	if (avgHoldNanos > PARK_THRESHOLD_NANOS)
+		return 0;
+	int n = spinLimit * 2 + MIN_SPINS;
+	return (n < maxSpins) ? n : maxSpins;
+}
+
+void ESpinControl::spun(int spins, boolean acquired) {
+	if (policy != ADAPTIVE)
+		return;
+	int s = spinLimit;
+	if (acquired)
+		s += (spins - s) / 8;
+	else
+		s -= s / 4 + 1;
+	spinLimit = (s < MIN_SPINS) ? MIN_SPINS : (s > maxSpins ? maxSpins : s);
+}
+
+void ESpinControl::holdBegin() {
+	if (policy == ADAPTIVE && (++holdSamples & 7) == 0)
+		holdStamp = ESystem::nanoTime();
+}
+
+void ESpinControl::holdEnd() {
+	llong t = holdStamp;
+	if (t != 0) {
+		holdStamp = 0;
+		llong avg = avgHoldNanos;
+		avgHoldNanos = avg + (ESystem::nanoTime() - t - avg) / 8;
+	}
+}
+
+ESpinControl::Policy ESpinControl::getPolicy() {
+	return policy;
+}
+
+int ESpinControl::getSpinLimit() {
+	return spinLimit;
+}
+
+llong ESpinControl::getAverageHoldNanos() {
+	return avgHoldNanos;
+}
+
+EStringBase ESpinControl::toString() {
+	const char* p = (policy == PARK) ? "park" : (policy == FIXED ? "fixed" : "adaptive");
+	return EStringBase::formatOf("[policy = %s, spinLimit = %d, avgHoldNanos = %lld]",
+			p, spinLimit, avgHoldNanos);
+}
+
+int ESpinControl::getNCPU() {
+	int n = ncpu;
+	if (n == 0) {
+		n = ERuntime::getRuntime()->availableProcessors();
+		if (n <= 0)
+			n = 1;
+		ncpu = n;
+	}
+	return n;
+}
+
+} /* namespace efc */
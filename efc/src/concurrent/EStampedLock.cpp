@@ -0,0 +1,476 @@
+/*
+ * EStampedLock.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/EStampedLock.hh"
+#include "../../inc/concurrent/EAbstractQueuedSynchronizer.hh"
+#include "../../inc/concurrent/EUnsafe.hh"
+
+namespace efc {
+
+/** The number of bits to use for reader count before overflowing */
+#define LG_READERS  7
+
+// Values for lock state and stamp operations
+static const llong RUNIT = 1L;
+static const llong WBIT  = 1L << LG_READERS;
+static const llong RBITS = WBIT - 1L;
+static const llong RFULL = RBITS - 1L;
+static const llong ABITS = RBITS | WBIT;
+static const llong SBITS = ~RBITS; // note overlap with ABITS
+
+// Initial value for lock state; avoid failure value zero
+static const llong ORIGIN = WBIT << 1;
+
+namespace stamped {
+
+/**
+ * Only the wait queue of the lock: the lock state lives in the owning
+ * EStampedLock, so the AQS int state is unused and release() carries
+ * no state change of its own.
+ */
+class Sync: public EAbstractQueuedSynchronizer {
+public:
+	Sync(EStampedLock* lock) : lock(lock) {
+	}
+
+protected:
+	virtual boolean tryAcquire(int arg) {
+		llong s = lock->state;
+		return ((s & ABITS) == 0L &&
+				EUnsafe::compareAndSwapLLong(&lock->state, s, s + WBIT));
+	}
+
+	virtual boolean tryRelease(int arg) {
+		return true;
+	}
+
+	virtual int tryAcquireShared(int arg) {
+		// don't overtake a queued writer
+		if (hasQueuedPredecessors())
+			return -1;
+		for (;;) {
+			llong s = lock->state;
+			llong m = s & ABITS;
+			if (m < RFULL) {
+				if (EUnsafe::compareAndSwapLLong(&lock->state, s, s + RUNIT))
+					return 1;
+			}
+			else if (m < WBIT) {
+				if (lock->tryIncReaderOverflow(s) != 0L)
+					return 1;
+			}
+			else
+				return -1;
+		}
+	}
+
+	virtual boolean tryReleaseShared(int arg) {
+		return true;
+	}
+
+private:
+	EStampedLock* lock;
+};
+
+} /* namespace stamped */
+
+EStampedLock::~EStampedLock() {
+	delete sync;
+}
+
+EStampedLock::EStampedLock() :
+		state(ORIGIN), readerOverflow(0), waiters(0) {
+	sync = new stamped::Sync(this);
+}
+
+llong EStampedLock::writeLock() {
+	llong s, next;
+	if (((s = state) & ABITS) == 0L &&
+			EUnsafe::compareAndSwapLLong(&state, s, next = s + WBIT))
+		return next;
+	eso_atomic_add_and_fetch32(&waiters, 1);
+	try {
+		sync->acquire(1);
+	} catch (...) {
+		eso_atomic_add_and_fetch32(&waiters, -1);
+		throw; //!
+	}
+	eso_atomic_add_and_fetch32(&waiters, -1);
+	return EUnsafe::getVolatile(&state);
+}
+
+llong EStampedLock::tryWriteLock() {
+	llong s, next;
+	return ((((s = state) & ABITS) == 0L &&
+			EUnsafe::compareAndSwapLLong(&state, s, next = s + WBIT)) ?
+			next : 0L);
+}
+
+llong EStampedLock::tryWriteLock(llong time, ETimeUnit* unit) {
+	llong nanos = unit->toNanos(time);
+	if (!EThread::interrupted()) {
+		llong next;
+		if ((next = tryWriteLock()) != 0L)
+			return next;
+		if (nanos <= 0L)
+			return 0L;
+		boolean acquired;
+		eso_atomic_add_and_fetch32(&waiters, 1);
+		try {
+			acquired = sync->tryAcquireNanos(1, nanos);
+		} catch (...) {
+			eso_atomic_add_and_fetch32(&waiters, -1);
+			throw; //!
+		}
+		eso_atomic_add_and_fetch32(&waiters, -1);
+		return acquired ? EUnsafe::getVolatile(&state) : 0L;
+	}
+	throw EInterruptedException(__FILE__, __LINE__);
+}
+
+llong EStampedLock::writeLockInterruptibly() {
+	if (!EThread::interrupted()) {
+		llong next;
+		if ((next = tryWriteLock()) != 0L)
+			return next;
+		eso_atomic_add_and_fetch32(&waiters, 1);
+		try {
+			sync->acquireInterruptibly(1);
+		} catch (...) {
+			eso_atomic_add_and_fetch32(&waiters, -1);
+			throw; //!
+		}
+		eso_atomic_add_and_fetch32(&waiters, -1);
+		return EUnsafe::getVolatile(&state);
+	}
+	throw EInterruptedException(__FILE__, __LINE__);
+}
+
+llong EStampedLock::readLock() {
+	llong s = state, next;  // bypass acquireShared if nobody is queued
+	if (waiters == 0 && (s & ABITS) < RFULL &&
+			EUnsafe::compareAndSwapLLong(&state, s, next = s + RUNIT))
+		return next;
+	eso_atomic_add_and_fetch32(&waiters, 1);
+	try {
+		sync->acquireShared(1);
+	} catch (...) {
+		eso_atomic_add_and_fetch32(&waiters, -1);
+		throw; //!
+	}
+	eso_atomic_add_and_fetch32(&waiters, -1);
+	return readStamp();
+}
+
+llong EStampedLock::tryReadLock() {
+	for (;;) {
+		llong s, m, next;
+		if ((m = (s = state) & ABITS) == WBIT)
+			return 0L;
+		else if (m < RFULL) {
+			if (EUnsafe::compareAndSwapLLong(&state, s, next = s + RUNIT))
+				return next;
+		}
+		else if ((next = tryIncReaderOverflow(s)) != 0L)
+			return next;
+	}
+}
+
+llong EStampedLock::tryReadLock(llong time, ETimeUnit* unit) {
+	llong nanos = unit->toNanos(time);
+	if (!EThread::interrupted()) {
+		llong s, m, next;
+		if ((m = (s = state) & ABITS) != WBIT) {
+			if (m < RFULL) {
+				if (EUnsafe::compareAndSwapLLong(&state, s, next = s + RUNIT))
+					return next;
+			}
+			else if ((next = tryIncReaderOverflow(s)) != 0L)
+				return next;
+		}
+		if (nanos <= 0L)
+			return 0L;
+		boolean acquired;
+		eso_atomic_add_and_fetch32(&waiters, 1);
+		try {
+			acquired = sync->tryAcquireSharedNanos(1, nanos);
+		} catch (...) {
+			eso_atomic_add_and_fetch32(&waiters, -1);
+			throw; //!
+		}
+		eso_atomic_add_and_fetch32(&waiters, -1);
+		return acquired ? readStamp() : 0L;
+	}
+	throw EInterruptedException(__FILE__, __LINE__);
+}
+
+llong EStampedLock::readLockInterruptibly() {
+	if (!EThread::interrupted()) {
+		llong s = state, next;
+		if (waiters == 0 && (s & ABITS) < RFULL &&
+				EUnsafe::compareAndSwapLLong(&state, s, next = s + RUNIT))
+			return next;
+		eso_atomic_add_and_fetch32(&waiters, 1);
+		try {
+			sync->acquireSharedInterruptibly(1);
+		} catch (...) {
+			eso_atomic_add_and_fetch32(&waiters, -1);
+			throw; //!
+		}
+		eso_atomic_add_and_fetch32(&waiters, -1);
+		return readStamp();
+	}
+	throw EInterruptedException(__FILE__, __LINE__);
+}
+
+llong EStampedLock::tryOptimisticRead() {
+	llong s;
+	return (((s = EUnsafe::getVolatile(&state)) & WBIT) == 0L) ? (s & SBITS) : 0L;
+}
+
+boolean EStampedLock::validate(llong stamp) {
+	EUnsafe::loadFence();
+	return (stamp & SBITS) == (state & SBITS);
+}
+
+void EStampedLock::unlockWrite(llong stamp) {
+	if (state != stamp || (stamp & WBIT) == 0L)
+		throw EIllegalStateException(__FILE__, __LINE__, "Illegal monitor state");
+	EUnsafe::putVolatile(&state, (stamp += WBIT) == 0L ? ORIGIN : stamp);
+	wakeWaiters();
+}
+
+void EStampedLock::unlockRead(llong stamp) {
+	llong s, m;
+	for (;;) {
+		if (((s = state) & SBITS) != (stamp & SBITS) ||
+				(stamp & ABITS) == 0L || (m = s & ABITS) == 0L || m == WBIT)
+			throw EIllegalStateException(__FILE__, __LINE__, "Illegal monitor state");
+		if (m < RFULL) {
+			if (EUnsafe::compareAndSwapLLong(&state, s, s - RUNIT)) {
+				if (m == RUNIT)
+					wakeWaiters();
+				break;
+			}
+		}
+		else if (tryDecReaderOverflow(s) != 0L)
+			break;
+	}
+}
+
+void EStampedLock::unlock(llong stamp) {
+	llong a = stamp & ABITS, m, s;
+	while (((s = state) & SBITS) == (stamp & SBITS)) {
+		if ((m = s & ABITS) == 0L)
+			break;
+		else if (m == WBIT) {
+			if (a != m)
+				break;
+			EUnsafe::putVolatile(&state, (s += WBIT) == 0L ? ORIGIN : s);
+			wakeWaiters();
+			return;
+		}
+		else if (a == 0L || a >= WBIT)
+			break;
+		else if (m < RFULL) {
+			if (EUnsafe::compareAndSwapLLong(&state, s, s - RUNIT)) {
+				if (m == RUNIT)
+					wakeWaiters();
+				return;
+			}
+		}
+		else if (tryDecReaderOverflow(s) != 0L)
+			return;
+	}
+	throw EIllegalStateException(__FILE__, __LINE__, "Illegal monitor state");
+}
+
+llong EStampedLock::tryConvertToWriteLock(llong stamp) {
+	llong a = stamp & ABITS, m, s, next;
+	while (((s = state) & SBITS) == (stamp & SBITS)) {
+		if ((m = s & ABITS) == 0L) {
+			if (a != 0L)
+				break;
+			if (EUnsafe::compareAndSwapLLong(&state, s, next = s + WBIT))
+				return next;
+		}
+		else if (m == WBIT) {
+			if (a != m)
+				break;
+			return stamp;
+		}
+		else if (m == RUNIT && a != 0L) {
+			if (EUnsafe::compareAndSwapLLong(&state, s, next = s - RUNIT + WBIT))
+				return next;
+		}
+		else
+			break;
+	}
+	return 0L;
+}
+
+llong EStampedLock::tryConvertToReadLock(llong stamp) {
+	llong a = stamp & ABITS, m, s, next;
+	while (((s = state) & SBITS) == (stamp & SBITS)) {
+		if ((m = s & ABITS) == 0L) {
+			if (a != 0L)
+				break;
+			else if (m < RFULL) {
+				if (EUnsafe::compareAndSwapLLong(&state, s, next = s + RUNIT))
+					return next;
+			}
+			else if ((next = tryIncReaderOverflow(s)) != 0L)
+				return next;
+		}
+		else if (m == WBIT) {
+			if (a != m)
+				break;
+			EUnsafe::putVolatile(&state, next = s + (WBIT + RUNIT));
+			wakeWaiters();
+			return next;
+		}
+		else if (a != 0L && a < WBIT)
+			return stamp;
+		else
+			break;
+	}
+	return 0L;
+}
+
+llong EStampedLock::tryConvertToOptimisticRead(llong stamp) {
+	llong a = stamp & ABITS, m, s, next;
+	EUnsafe::loadFence();
+	for (;;) {
+		if (((s = state) & SBITS) != (stamp & SBITS))
+			break;
+		if ((m = s & ABITS) == 0L) {
+			if (a != 0L)
+				break;
+			return s;
+		}
+		else if (m == WBIT) {
+			if (a != m)
+				break;
+			EUnsafe::putVolatile(&state, next = (s += WBIT) == 0L ? ORIGIN : s);
+			wakeWaiters();
+			return next;
+		}
+		else if (a == 0L || a >= WBIT)
+			break;
+		else if (m < RFULL) {
+			if (EUnsafe::compareAndSwapLLong(&state, s, next = s - RUNIT)) {
+				if (m == RUNIT)
+					wakeWaiters();
+				return next & SBITS;
+			}
+		}
+		else if ((next = tryDecReaderOverflow(s)) != 0L)
+			return next & SBITS;
+	}
+	return 0L;
+}
+
+boolean EStampedLock::tryUnlockWrite() {
+	llong s;
+	if (((s = state) & WBIT) != 0L) {
+		EUnsafe::putVolatile(&state, (s += WBIT) == 0L ? ORIGIN : s);
+		wakeWaiters();
+		return true;
+	}
+	return false;
+}
+
+boolean EStampedLock::tryUnlockRead() {
+	llong s, m;
+	while ((m = (s = state) & ABITS) != 0L && m < WBIT) {
+		if (m < RFULL) {
+			if (EUnsafe::compareAndSwapLLong(&state, s, s - RUNIT)) {
+				if (m == RUNIT)
+					wakeWaiters();
+				return true;
+			}
+		}
+		else if (tryDecReaderOverflow(s) != 0L)
+			return true;
+	}
+	return false;
+}
+
+boolean EStampedLock::isWriteLocked() {
+	return (state & WBIT) != 0L;
+}
+
+boolean EStampedLock::isReadLocked() {
+	return (state & RBITS) != 0L;
+}
+
+int EStampedLock::getReadLockCount() {
+	return getReadLockCount(state);
+}
+
+EStringBase EStampedLock::toString() {
+	llong s = state;
+	return EObject::toString() +
+		(((s & ABITS) == 0L) ? "[Unlocked]" :
+		 ((s & WBIT) != 0L) ? "[Write-locked]" :
+		 EStringBase::formatOf("[Read-locks:%d]", getReadLockCount(s)).c_str());
+}
+
+int EStampedLock::getReadLockCount(llong s) {
+	llong readers;
+	if ((readers = s & RBITS) >= RFULL)
+		readers = RFULL + readerOverflow;
+	return (int) readers;
+}
+
+llong EStampedLock::tryIncReaderOverflow(llong s) {
+	// assert (s & ABITS) >= RFULL;
+	if ((s & ABITS) == RFULL) {
+		if (EUnsafe::compareAndSwapLLong(&state, s, s | RBITS)) {
+			++readerOverflow;
+			EUnsafe::putVolatile(&state, s);
+			return s;
+		}
+	}
+	else
+		EThread::yield();
+	return 0L;
+}
+
+llong EStampedLock::tryDecReaderOverflow(llong s) {
+	// assert (s & ABITS) >= RFULL;
+	if ((s & ABITS) == RFULL) {
+		if (EUnsafe::compareAndSwapLLong(&state, s, s | RBITS)) {
+			int r; llong next;
+			if ((r = readerOverflow) > 0) {
+				readerOverflow = r - 1;
+				next = s;
+			}
+			else
+				next = s - RUNIT;
+			EUnsafe::putVolatile(&state, next);
+			return next;
+		}
+	}
+	else
+		EThread::yield();
+	return 0L;
+}
+
+void EStampedLock::wakeWaiters() {
+	// the state change above is fenced, so a waiter that registered
+	// after this read will recheck the state before parking.
+	if (EUnsafe::getVolatile(&waiters) > 0)
+		sync->releaseShared(0);
+}
+
+llong EStampedLock::readStamp() {
+	// no writer can get in while we hold the read lock, so the version is stable
+	return (EUnsafe::getVolatile(&state) & SBITS) | RUNIT;
+}
+
+} /* namespace efc */
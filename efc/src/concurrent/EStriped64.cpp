@@ -0,0 +1,274 @@
+/*
+ * EStriped64.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+
+#include "../../inc/concurrent/EStriped64.hh"
+#include "../../inc/concurrent/EThreadLocalRandom.hh"
+#include "../../inc/concurrent/EUnsafe.hh"
+#include "../../inc/concurrent/EOrderAccess.hh"
+#include "../../inc/EThreadLocalStorage.hh"
+#include "../../inc/ERuntime.hh"
+
+namespace efc {
+
+//=============================================================================
+// EThreadLocalRandom probe support.
+
+namespace tlr {
+
+/**
+ * The increment for generating probe values.
+ */
+static const int PROBE_INCREMENT = 0x9e3779b9;
+
+/**
+ * Per-thread probe, stored directly as the tls value (0 if unset).
+ */
+class Probe {
+public:
+	DECLARE_STATIC_INITZZ;
+
+	static EThreadLocalStorage* probes;
+	static volatile es_int32_t probeGenerator;
+};
+
+EThreadLocalStorage* Probe::probes = null;
+volatile es_int32_t Probe::probeGenerator = 0;
+
+DEFINE_STATIC_INITZZ_BEGIN(Probe)
+	probes = new EThreadLocalStorage();
+DEFINE_STATIC_INITZZ_END
+
+} /* namespace tlr */
+
+int EThreadLocalRandom::getProbe() {
+	return (int)(long)tlr::Probe::probes->get();
+}
+
+int EThreadLocalRandom::advanceProbe(int probe) {
+	probe ^= probe << 13;   // xorshift
+	probe ^= (int)(((unsigned)probe) >> 17);
+	probe ^= probe << 5;
+	tlr::Probe::probes->set((void*)(long)probe);
+	return probe;
+}
+
+void EThreadLocalRandom::localInit() {
+	int p = eso_atomic_add_and_fetch32(&tlr::Probe::probeGenerator,
+			tlr::PROBE_INCREMENT);
+	int probe = (p == 0) ? 1 : p; // skip 0
+	tlr::Probe::probes->set((void*)(long)probe);
+}
+
+//=============================================================================
+
+static volatile int ncpu = 0;
+
+static inline llong apply(llong v, llong x, ELongBinaryOperator* fn,
+		boolean isDouble) {
+	if (isDouble) {
+		union { double d; llong l; } a, b;
+		a.l = v;
+		b.l = x;
+		a.d += b.d;
+		return a.l;
+	}
+	return (fn == null) ? v + x : fn->applyAsLong(v, x);
+}
+
+boolean EStriped64::Cell::cas(llong cmp, llong val) {
+	return EUnsafe::compareAndSwapLLong(&value, cmp, val);
+}
+
+EStriped64::~EStriped64() {
+	Cells* as = cells;
+	if (as != null) {
+		for (int i = 0; i < as->length; i++) {
+			delete as->cells[i];
+		}
+	}
+	while (as != null) {
+		Cells* prev = as->prev;
+		eso_free(as);
+		as = prev;
+	}
+}
+
+EStriped64::EStriped64() : cells(null), base(0), cellsBusy(0) {
+}
+
+boolean EStriped64::casBase(llong cmp, llong val) {
+	return EUnsafe::compareAndSwapLLong(&base, cmp, val);
+}
+
+boolean EStriped64::casCellsBusy() {
+	return EUnsafe::compareAndSwapInt(&cellsBusy, 0, 1);
+}
+
+int EStriped64::NCPU() {
+	int n = ncpu;
+	if (n == 0) {
+		n = ERuntime::getRuntime()->availableProcessors();
+		if (n <= 0)
+			n = 1;
+		ncpu = n;
+	}
+	return n;
+}
+
+EStriped64::Cells* EStriped64::newCells(int n) {
+	Cells* as = (Cells*)eso_calloc(sizeof(Cells) + (n - 1) * sizeof(Cell*));
+	as->length = n;
+	return as;
+}
+
+void EStriped64::longAccumulate(llong x, ELongBinaryOperator* fn,
+		boolean wasUncontended) {
+	int h;
+	if ((h = EThreadLocalRandom::getProbe()) == 0) {
+		EThreadLocalRandom::localInit(); // force initialization
+		h = EThreadLocalRandom::getProbe();
+		wasUncontended = true;
+	}
+	boolean collide = false;                // True if last slot nonempty
+	for (;;) {
+		Cells* as; Cell* a; int n; llong v;
+		if ((as = (Cells*)EOrderAccess::load_ptr_acquire(&cells)) != null &&
+				(n = as->length) > 0) {
+			if ((a = (Cell*)EOrderAccess::load_ptr_acquire(&as->cells[(n - 1) & h])) == null) {
+				if (cellsBusy == 0) {       // Try to attach new Cell
+					Cell* r = new Cell(x);  // Optimistically create
+					if (cellsBusy == 0 && casCellsBusy()) {
+						boolean created = false;
+						Cells* rs; int m, j;
+						if ((rs = cells) != null && (m = rs->length) > 0 &&
+								rs->cells[j = (m - 1) & h] == null) {
+							EOrderAccess::release_store_ptr(&rs->cells[j], r);
+							created = true;
+						}
+						EOrderAccess::release_store(&cellsBusy, 0);
+						if (created)
+							break;
+						delete r;
+						continue;           // Slot is now non-empty
+					}
+					delete r;
+				}
+				collide = false;
+			}
+			else if (!wasUncontended)       // CAS already known to fail
+				wasUncontended = true;      // Continue after rehash
+			else if (((v = a->value), a->cas(v, apply(v, x, fn, false))))
+				break;
+			else if (n >= NCPU() || cells != as)
+				collide = false;            // At max size or stale
+			else if (!collide)
+				collide = true;
+			else if (cellsBusy == 0 && casCellsBusy()) {
+				if (cells == as) {          // Expand table unless stale
+					Cells* rs = newCells(n << 1);
+					for (int i = 0; i < n; ++i)
+						rs->cells[i] = as->cells[i];
+					rs->prev = as;
+					EOrderAccess::release_store_ptr(&cells, rs);
+				}
+				EOrderAccess::release_store(&cellsBusy, 0);
+				collide = false;
+				continue;                   // Retry with expanded table
+			}
+			h = EThreadLocalRandom::advanceProbe(h);
+		}
+		else if (cellsBusy == 0 && cells == as && casCellsBusy()) {
+			boolean init = false;
+			if (cells == as) {              // Initialize table
+				Cells* rs = newCells(2);
+				rs->cells[h & 1] = new Cell(x);
+				EOrderAccess::release_store_ptr(&cells, rs);
+				init = true;
+			}
+			EOrderAccess::release_store(&cellsBusy, 0);
+			if (init)
+				break;
+		}
+		else if (((v = base), casBase(v, apply(v, x, fn, false))))
+			break;                          // Fall back on using base
+	}
+}
+
+void EStriped64::doubleAccumulate(double x, boolean wasUncontended) {
+	llong bits = doubleToRawBits(x);
+	int h;
+	if ((h = EThreadLocalRandom::getProbe()) == 0) {
+		EThreadLocalRandom::localInit(); // force initialization
+		h = EThreadLocalRandom::getProbe();
+		wasUncontended = true;
+	}
+	boolean collide = false;                // True if last slot nonempty
+	for (;;) {
+		Cells* as; Cell* a; int n; llong v;
+		if ((as = (Cells*)EOrderAccess::load_ptr_acquire(&cells)) != null &&
+				(n = as->length) > 0) {
+			if ((a = (Cell*)EOrderAccess::load_ptr_acquire(&as->cells[(n - 1) & h])) == null) {
+				if (cellsBusy == 0) {       // Try to attach new Cell
+					Cell* r = new Cell(bits);
+					if (cellsBusy == 0 && casCellsBusy()) {
+						boolean created = false;
+						Cells* rs; int m, j;
+						if ((rs = cells) != null && (m = rs->length) > 0 &&
+								rs->cells[j = (m - 1) & h] == null) {
+							EOrderAccess::release_store_ptr(&rs->cells[j], r);
+							created = true;
+						}
+						EOrderAccess::release_store(&cellsBusy, 0);
+						if (created)
+							break;
+						delete r;
+						continue;           // Slot is now non-empty
+					}
+					delete r;
+				}
+				collide = false;
+			}
+			else if (!wasUncontended)       // CAS already known to fail
+				wasUncontended = true;      // Continue after rehash
+			else if (((v = a->value), a->cas(v, apply(v, bits, null, true))))
+				break;
+			else if (n >= NCPU() || cells != as)
+				collide = false;            // At max size or stale
+			else if (!collide)
+				collide = true;
+			else if (cellsBusy == 0 && casCellsBusy()) {
+				if (cells == as) {          // Expand table unless stale
+					Cells* rs = newCells(n << 1);
+					for (int i = 0; i < n; ++i)
+						rs->cells[i] = as->cells[i];
+					rs->prev = as;
+					EOrderAccess::release_store_ptr(&cells, rs);
+				}
+				EOrderAccess::release_store(&cellsBusy, 0);
+				collide = false;
+				continue;                   // Retry with expanded table
+			}
+			h = EThreadLocalRandom::advanceProbe(h);
+		}
+		else if (cellsBusy == 0 && cells == as && casCellsBusy()) {
+			boolean init = false;
+			if (cells == as) {              // Initialize table
+				Cells* rs = newCells(2);
+				rs->cells[h & 1] = new Cell(bits);
+				EOrderAccess::release_store_ptr(&cells, rs);
+				init = true;
+			}
+			EOrderAccess::release_store(&cellsBusy, 0);
+			if (init)
+				break;
+		}
+		else if (((v = base), casBase(v, apply(v, bits, null, true))))
+			break;                          // Fall back on using base
+	}
+}
+
+} /* namespace efc */
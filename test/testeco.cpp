@@ -0,0 +1,293 @@
+/*
+ * testeco.cpp
+ *
+ *  Created on: 2026-10-16
+ *      Author: cxxjava@163.com
+ */
+#include "es_main.h"
+#include "Efc.hh"
+#include "Eco.hh"
+
+#define LOG(fmt,...) ESystem::out->println(fmt, ##__VA_ARGS__)
+
+static EAtomicCounter finished;
+
+class YieldTask: public ERunnable {
+public:
+	virtual void run() {
+		for (int i = 0; i < 10; i++) {
+			EFiber::yield();
+		}
+		finished++;
+	}
+};
+
+static void test_fiber_yield() {
+	EFiberScheduler scheduler(2);
+	finished = 0;
+	llong t1 = ESystem::currentTimeMillis();
+	for (int i = 0; i < 100000; i++) {
+		scheduler.schedule(new YieldTask());
+	}
+	scheduler.join();
+	LOG("100000 fibers x 10 yields: finished=%d, %lldms", finished.value(),
+			ESystem::currentTimeMillis() - t1);
+}
+
+class PingPong: public ERunnable {
+public:
+	PingPong(int me, volatile int* turn, int rounds) :
+			me(me), turn(turn), rounds(rounds) {
+	}
+	virtual void run() {
+		for (int i = 0; i < rounds; i++) {
+			while (*turn != me) {
+				EFiber::park();
+			}
+			*turn = 1 - me;
+			peer->unpark();
+		}
+		finished++;
+	}
+	int me;
+	volatile int* turn;
+	int rounds;
+	sp<EFiber> peer;
+};
+
+static void test_fiber_park() {
+	EFiberScheduler scheduler(2);
+	finished = 0;
+	volatile int turn = 0;
+	sp<PingPong> a = new PingPong(0, &turn, 100000);
+	sp<PingPong> b = new PingPong(1, &turn, 100000);
+	sp<EFiber> fa = new EFiber(a);
+	sp<EFiber> fb = new EFiber(b);
+	a->peer = fb;
+	b->peer = fa;
+	llong t1 = ESystem::currentTimeMillis();
+	scheduler.schedule(fa);
+	scheduler.schedule(fb);
+	scheduler.join();
+	a->peer = null;
+	b->peer = null;
+	LOG("park/unpark 2x100000 rounds: finished=%d, %lldms", finished.value(),
+			ESystem::currentTimeMillis() - t1);
+}
+
+class SleepTask: public ERunnable {
+public:
+	virtual void run() {
+		EThread::sleep(100); //hooked, suspends only this fiber
+		finished++;
+	}
+};
+
+static void test_fiber_sleep() {
+	EFiberScheduler scheduler(2);
+	scheduler.setStackGuard(false);
+	finished = 0;
+	llong t1 = ESystem::currentTimeMillis();
+	for (int i = 0; i < 100000; i++) {
+		scheduler.schedule(new SleepTask(), 16 * 1024);
+	}
+	scheduler.join();
+	LOG("100000 fibers sleeping 100ms: finished=%d, %lldms", finished.value(),
+			ESystem::currentTimeMillis() - t1);
+}
+
+class LockTask: public ERunnable {
+public:
+	LockTask(EReentrantLock* lock, int* count) : lock(lock), count(count) {
+	}
+	virtual void run() {
+		for (int i = 0; i < 1000; i++) {
+			lock->lock();
+			int c = *count;
+			EFiber::yield(); //the others find the lock taken and park
+			*count = c + 1;
+			lock->unlock();
+		}
+		finished++;
+	}
+	EReentrantLock* lock;
+	int* count;
+};
+
+static void test_fiber_lock() {
+	// one carrier: a parked carrier thread would never run the holder again
+	EFiberScheduler scheduler(1);
+	EReentrantLock lock;
+	int count = 0;
+	finished = 0;
+	llong t1 = ESystem::currentTimeMillis();
+	for (int i = 0; i < 10; i++) {
+		scheduler.schedule(new LockTask(&lock, &count));
+	}
+	scheduler.join();
+	LOG("10 fibers x 1000 contended locks on 1 carrier: finished=%d, count=%d, %lldms",
+			finished.value(), count, ESystem::currentTimeMillis() - t1);
+}
+
+class PipeReader: public ERunnable {
+public:
+	PipeReader(int fd) : fd(fd) {
+	}
+	virtual void run() {
+		char c;
+		ssize_t n = ::read(fd, &c, 1);
+		LOG("read of a pipe closed meanwhile: n=%d, %s", (int)n,
+				(n < 0 && errno == EBADF) ? "EBADF" : "unexpected");
+		finished++;
+	}
+	int fd;
+};
+
+class PipeCloser: public ERunnable {
+public:
+	PipeCloser(int fd) : fd(fd) {
+	}
+	virtual void run() {
+		EThread::sleep(100);
+		::close(fd);
+		finished++;
+	}
+	int fd;
+};
+
+static void test_fiber_close() {
+	int fds[2];
+	if (::pipe(fds) != 0) {
+		LOG("pipe: errno=%d", errno);
+		return;
+	}
+	EFiberScheduler scheduler(2);
+	finished = 0;
+	scheduler.schedule(new PipeReader(fds[0]));
+	scheduler.schedule(new PipeCloser(fds[0]));
+	scheduler.join();
+	::close(fds[1]);
+	LOG("close wakes a blocked reader: finished=%d", finished.value());
+}
+
+class EchoHandler: public ERunnable {
+public:
+	EchoHandler(ESocket* socket) : socket(socket) {
+	}
+	virtual void run() {
+		try {
+			EInputStream* is = socket->getInputStream();
+			EOutputStream* os = socket->getOutputStream();
+			char buf[512];
+			int n;
+			while ((n = is->read(buf, sizeof(buf))) > 0) {
+				os->write(buf, n);
+			}
+		} catch (EIOException& e) {
+			LOG("handler: %s", e.toString().c_str());
+		}
+		socket->close();
+	}
+	sp<ESocket> socket;
+};
+
+class EchoServer: public ERunnable {
+public:
+	EchoServer(EServerSocket* server, int count) :
+			server(server), count(count) {
+	}
+	virtual void run() {
+		for (int i = 0; i < count; i++) {
+			ESocket* socket = server->accept();
+			EFiberScheduler::currentScheduler()->schedule(new EchoHandler(socket));
+		}
+	}
+	EServerSocket* server;
+	int count;
+};
+
+class EchoClient: public ERunnable {
+public:
+	EchoClient(int port) : port(port) {
+	}
+	virtual void run() {
+		try {
+			ESocket socket("127.0.0.1", port);
+			socket.setSoTimeout(10000);
+			EInputStream* is = socket.getInputStream();
+			EOutputStream* os = socket.getOutputStream();
+			char buf[16];
+			for (int i = 0; i < 10; i++) {
+				os->write("0123456789", 10);
+				int got = 0;
+				while (got < 10) {
+					int n = is->read(buf + got, 10 - got);
+					if (n <= 0) {
+						throw EIOException(__FILE__, __LINE__, "closed");
+					}
+					got += n;
+				}
+				if (eso_memcmp(buf, "0123456789", 10) != 0) {
+					throw EIOException(__FILE__, __LINE__, "corrupted");
+				}
+			}
+			socket.close();
+			finished++;
+		} catch (EIOException& e) {
+			LOG("client: %s", e.toString().c_str());
+		}
+	}
+	int port;
+};
+
+static void test_fiber_echo() {
+	const int clients = 10000;
+
+	EServerSocket server;
+	server.setReuseAddress(true);
+	server.bind("127.0.0.1", 0, 1024);
+	int port = server.getLocalPort();
+
+	EFiberScheduler scheduler;
+	finished = 0;
+	llong t1 = ESystem::currentTimeMillis();
+	scheduler.schedule(new EchoServer(&server, clients));
+	for (int i = 0; i < clients; i++) {
+		scheduler.schedule(new EchoClient(port));
+	}
+	scheduler.join();
+	LOG("%d blocking-style echo connections on %d carriers: ok=%d, %lldms",
+			clients, scheduler.getThreads(), finished.value(),
+			ESystem::currentTimeMillis() - t1);
+}
+
+MAIN_IMPL(testeco) {
+	printf("main()\n");
+
+	ESystem::init(argc, argv);
+
+	LOG("inited.");
+
+	do {
+		try {
+
+			test_fiber_yield();
+			test_fiber_park();
+			test_fiber_sleep();
+			test_fiber_lock();
+			test_fiber_close();
+			test_fiber_echo();
+
+		} catch (EException& e) {
+			LOG("exception: %s", e.toString().c_str());
+		} catch (...) {
+			LOG("Catched a exception.");
+		}
+	} while (0);
+
+	LOG("exit...");
+
+	ESystem::exit(0);
+
+	return 0;
+}
@@ -9669,6 +9669,1938 @@ static void test_bigdecimal() {
 	}
 }
 
+class Fibonacci : public ERecursiveTask<EInteger> {
+public:
+	Fibonacci(int n) : n(n) {
+	}
+protected:
+	sp<EInteger> compute() {
+		if (n <= 10)
+			return new EInteger(seqFib(n));
+		sp<Fibonacci> f1 = new Fibonacci(n - 1);
+		f1->fork();
+		sp<Fibonacci> f2 = new Fibonacci(n - 2);
+		return new EInteger(f2->compute()->intValue() + f1->join()->intValue());
+	}
+private:
+	int n;
+	static int seqFib(int n) {
+		return (n <= 1) ? n : seqFib(n - 1) + seqFib(n - 2);
+	}
+};
+
+class SumAction : public ERecursiveAction {
+public:
+	SumAction(int* array, int lo, int hi, EAtomicLLong* sum) :
+		array(array), lo(lo), hi(hi), sum(sum) {
+	}
+protected:
+	void compute() {
+		if (hi - lo <= 1000) {
+			llong s = 0;
+			for (int i = lo; i < hi; i++) s += array[i];
+			sum->addAndGet(s);
+		} else {
+			int mid = (lo + hi) >> 1;
+			invokeAll(new SumAction(array, lo, mid, sum),
+					new SumAction(array, mid, hi, sum));
+		}
+	}
+private:
+	int* array;
+	int lo, hi;
+	EAtomicLLong* sum;
+};
+
+static void test_forkJoinPool() {
+	EForkJoinPool pool(4);
+
+	llong t1 = ESystem::currentTimeMillis();
+	sp<EInteger> r = pool.invoke<EInteger>(new Fibonacci(30));
+	LOG("fib(30)=%d, cost=%lldms", r->intValue(), ESystem::currentTimeMillis() - t1);
+	ES_ASSERT(r->intValue() == 832040);
+
+	int len = 1000000;
+	int* array = new int[len];
+	for (int i = 0; i < len; i++) array[i] = i % 100;
+	EAtomicLLong sum;
+	pool.invoke<EObject>(new SumAction(array, 0, len, &sum));
+	LOG("sum=%lld, steals=%lld", sum.get(), pool.getStealCount());
+	ES_ASSERT(sum.get() == 49500000L);
+	delete[] array;
+
+	LOG("%s", pool.toString().c_str());
+
+	EExecutorService* executorService = EExecutors::newWorkStealingPool(4);
+	for (int i=0; i<10; i++) {
+		executorService->execute(new Worker(i));
+	}
+	executorService->shutdown();
+	executorService->awaitTermination();
+	delete executorService;
+}
+
+class CollidingKey : public EObject {
+public:
+	int k;
+	CollidingKey(int k) : k(k) {
+	}
+	virtual int hashCode() {
+		return k & 0x7; // many keys per bin to force tree bins
+	}
+	virtual boolean equals(EObject* obj) {
+		CollidingKey* that = dynamic_cast<CollidingKey*>(obj);
+		return that != null && that->k == k;
+	}
+};
+
+struct IntValueReader {
+	int value;
+	void operator()(EInteger* v) {
+		value = v->intValue();
+	}
+};
+
+static void test_concurrentHashmap3() {
+	class chmThread : public EThread {
+	public:
+		chmThread(EConcurrentHashMap<int, EInteger>* chm, int id) :
+				chm(chm), id(id) {
+		}
+		virtual void run() {
+			for (int i = 0; i < 100000; i++) {
+				int k = id * 1000000 + i;
+				chm->put(k, new EInteger(k));
+				if (i % 3 == 0) {
+					sp<EInteger> v = chm->remove(k);
+					ES_ASSERT(v != null && v->intValue() == k);
+				}
+			}
+		}
+	private:
+		EConcurrentHashMap<int, EInteger>* chm;
+		int id;
+	};
+
+	// concurrent inserts across many cooperative resizes
+	EConcurrentHashMap<int, EInteger> chm;
+	EArrayList<chmThread*> arr;
+	for (int i = 0; i < 8; i++) {
+		chmThread* t = new chmThread(&chm, i);
+		arr.add(t);
+		t->start();
+	}
+	for (int i = 0; i < arr.size(); i++) {
+		arr.getAt(i)->join();
+	}
+	LOG("size=%d, mappingCount=%lld", chm.size(), chm.mappingCount());
+	ES_ASSERT(chm.size() == 8 * 66666);
+	IntValueReader reader;
+	boolean found = chm.read(1000001, reader);
+	ES_ASSERT(found && reader.value == 1000001);
+	found = chm.read(1000000, reader);
+	ES_ASSERT(!found);
+
+	// treeified bins
+	EConcurrentHashMap<CollidingKey, EInteger> tree;
+	for (int i = 0; i < 1000; i++) {
+		tree.put(new CollidingKey(i), new EInteger(i));
+	}
+	for (int i = 0; i < 1000; i += 2) {
+		CollidingKey k(i);
+		sp<EInteger> v = tree.remove(&k);
+		ES_ASSERT(v != null && v->intValue() == i);
+	}
+	for (int i = 0; i < 1000; i++) {
+		CollidingKey k(i);
+		ES_ASSERT(tree.containsKey(&k) == (i % 2 == 1));
+	}
+	int n = 0;
+	sp<EConcurrentIterator<EConcurrentMapEntry<CollidingKey, EInteger> > > it = tree.entrySet()->iterator();
+	while (it->hasNext()) {
+		sp<EConcurrentMapEntry<CollidingKey, EInteger> > e = it->next();
+		ES_ASSERT(e->getKey()->k == e->getValue()->intValue());
+		n++;
+	}
+	LOG("tree size=%d, iterated=%d", tree.size(), n);
+	ES_ASSERT(n == 500);
+}
+
+struct ExpireAction {
+	EAtomicLLong* expired;
+	void operator()(int key, sp<EInteger>& value) {
+		if (value->intValue() % 10 == 0)
+			expired->incrementAndGet();
+	}
+};
+
+struct ValueOf {
+	llong operator()(int key, sp<EInteger>& value) {
+		return value->intValue();
+	}
+};
+
+struct SumOf {
+	llong operator()(llong a, llong b) {
+		return a + b;
+	}
+};
+
+struct FindValue {
+	int target;
+	sp<EInteger> operator()(int key, sp<EInteger>& value) {
+		return (value->intValue() == target) ? value : null;
+	}
+};
+
+struct ValueBox {
+	sp<EInteger> operator()(int key, sp<EInteger>& value) {
+		return value;
+	}
+};
+
+struct MaxOf {
+	sp<EInteger> operator()(sp<EInteger> a, sp<EInteger> b) {
+		return (a->intValue() >= b->intValue()) ? a : b;
+	}
+};
+
+static void test_concurrentHashmapBulk() {
+	EConcurrentHashMap<int, EInteger> chm;
+	int n = 1000000;
+	for (int i = 0; i < n; i++) {
+		chm.put(i, new EInteger(i));
+	}
+	LOG("mappingCount=%lld", chm.mappingCount());
+
+	llong t1 = ESystem::currentTimeMillis();
+	EAtomicLLong expired;
+	ExpireAction action = { &expired };
+	chm.forEach(1000, action);
+	LOG("forEach: expired=%lld, cost=%lldms", expired.get(), ESystem::currentTimeMillis() - t1);
+	ES_ASSERT(expired.get() == n / 10);
+
+	t1 = ESystem::currentTimeMillis();
+	llong sum = chm.reduceToLong(1000, ValueOf(), 0L, SumOf());
+	LOG("reduceToLong: sum=%lld, cost=%lldms", sum, ESystem::currentTimeMillis() - t1);
+	t1 = ESystem::currentTimeMillis();
+	llong seq = chm.reduceToLong(ELLong::MAX_VALUE, ValueOf(), 0L, SumOf());
+	LOG("reduceToLong sequential: sum=%lld, cost=%lldms", seq, ESystem::currentTimeMillis() - t1);
+	ES_ASSERT(sum == (llong)n * (n - 1) / 2 && sum == seq);
+
+	FindValue find = { 777777 };
+	sp<EInteger> found = chm.search<EInteger>(1000, find);
+	ES_ASSERT(found != null && found->intValue() == 777777);
+	find.target = -1;
+	found = chm.search<EInteger>(1000, find);
+	ES_ASSERT(found == null);
+
+	sp<EInteger> max = chm.reduce<EInteger>(1000, ValueBox(), MaxOf());
+	ES_ASSERT(max->intValue() == n - 1);
+}
+
+class MaxOperator : public ELongBinaryOperator {
+public:
+	llong applyAsLong(llong left, llong right) {
+		return (left >= right) ? left : right;
+	}
+};
+
+static void test_longAdder() {
+	class adderThread : public EThread {
+	public:
+		adderThread(ELongAdder* adder, EDoubleAdder* dadder,
+				ELongAccumulator* max, int id) :
+				adder(adder), dadder(dadder), max(max), id(id) {
+		}
+		virtual void run() {
+			for (int i = 0; i < 1000000; i++) {
+				adder->increment();
+				dadder->add(0.5);
+				max->accumulate(id * 1000000 + i);
+			}
+		}
+	private:
+		ELongAdder* adder;
+		EDoubleAdder* dadder;
+		ELongAccumulator* max;
+		int id;
+	};
+
+	ELongAdder adder;
+	EDoubleAdder dadder;
+	ELongAccumulator max(new MaxOperator(), ELLong::MIN_VALUE);
+
+	llong t1 = ESystem::currentTimeMillis();
+	EArrayList<adderThread*> arr;
+	for (int i = 0; i < 16; i++) {
+		adderThread* t = new adderThread(&adder, &dadder, &max, i);
+		arr.add(t);
+		t->start();
+	}
+	for (int i = 0; i < arr.size(); i++) {
+		arr.getAt(i)->join();
+	}
+	LOG("sum=%s, dsum=%s, max=%s, cost=%lldms", adder.toString().c_str(),
+			dadder.toString().c_str(), max.toString().c_str(),
+			ESystem::currentTimeMillis() - t1);
+	ES_ASSERT(adder.sum() == 16000000L);
+	ES_ASSERT(dadder.sum() == 8000000.0);
+	ES_ASSERT(max.get() == 15999999L);
+
+	llong sum = adder.sumThenReset();
+	ES_ASSERT(sum == 16000000L && adder.sum() == 0L);
+	LOG("sumThenReset: %lld", sum);
+	max.reset();
+	ES_ASSERT(max.get() == ELLong::MIN_VALUE);
+}
+
+struct SlowSupplier {
+	int value;
+	SlowSupplier(int v) : value(v) {
+	}
+	sp<EInteger> operator()() {
+		EThread::sleep(50);
+		return new EInteger(value);
+	}
+};
+
+struct PlusOne {
+	sp<EInteger> operator()(sp<EInteger> x) {
+		return new EInteger(x->intValue() + 1);
+	}
+};
+
+struct ToText {
+	sp<EString> operator()(sp<EInteger> x) {
+		return new EString(x->toString());
+	}
+};
+
+struct Times10Later {
+	EExecutorService* executor;
+	Times10Later(EExecutorService* e) : executor(e) {
+	}
+	sp<ECompletableFuture<EInteger> > operator()(sp<EInteger> x) {
+		return ECompletableFuture<EInteger>::supplyAsync(
+				SlowSupplier(x->intValue() * 10), executor);
+	}
+};
+
+struct Concat {
+	sp<EString> operator()(sp<EInteger> a, sp<EString> b) {
+		return new EString(EString(a->intValue()) + "/" + b->toString());
+	}
+};
+
+struct Fail {
+	sp<EInteger> operator()(sp<EInteger> x) {
+		throw EIllegalStateException(__FILE__, __LINE__, "failed stage");
+	}
+};
+
+struct Recover {
+	sp<EInteger> operator()(sp<EThrowable> ex) {
+		return new EInteger(-1);
+	}
+};
+
+static void test_completableFuture() {
+	EExecutorService* executor = EExecutors::newFixedThreadPool(4);
+
+	// thenApply/thenApplyAsync: stages run when their input completes.
+	sp<ECompletableFuture<EInteger> > a =
+			ECompletableFuture<EInteger>::supplyAsync(SlowSupplier(1), executor);
+	sp<ECompletableFuture<EInteger> > b = a->thenApplyAsync<EInteger>(PlusOne(), executor);
+	sp<ECompletableFuture<EString> > c = b->thenApply<EString>(ToText());
+	sp<EString> text = c->get();
+	ES_ASSERT(text->equals("2"));
+	ES_ASSERT(a->getNumberOfDependents() == 0);
+
+	// thenCompose: flattens the future returned by the function.
+	sp<ECompletableFuture<EInteger> > d = a->thenCompose<EInteger>(Times10Later(executor));
+	sp<EInteger> v = d->join();
+	ES_ASSERT(v->intValue() == 10);
+
+	// thenCombine: waits for both inputs without holding a thread.
+	sp<ECompletableFuture<EString> > e = d->thenCombineAsync<EString>(c, Concat(), executor);
+	text = e->join();
+	LOG("combined=%s", text->c_str());
+	ES_ASSERT(text->equals("10/2"));
+
+	// exceptionally: failures skip dependent functions, then recover.
+	sp<ECompletableFuture<EInteger> > f = a->thenApply<EInteger>(Fail());
+	sp<ECompletableFuture<EInteger> > g = f->thenApply<EInteger>(PlusOne());
+	v = g->exceptionally(Recover())->join();
+	ES_ASSERT(v->intValue() == -1);
+	ES_ASSERT(g->isCompletedExceptionally());
+	try {
+		g->get();
+		ES_ASSERT(false);
+	} catch (EExecutionException& ex) {
+		LOG("get: %s", ex.getMessage());
+	}
+	try {
+		g->join();
+		ES_ASSERT(false);
+	} catch (ECompletionException& ex) {
+		LOG("join: %s", ex.getMessage());
+	}
+
+	// allOf/anyOf.
+	EArrayList<sp<ECompletableFutureType> > all;
+	for (int i = 0; i < 8; i++) {
+		all.add(ECompletableFuture<EInteger>::supplyAsync(SlowSupplier(i), executor));
+	}
+	ECompletableFutureType::allOf(&all)->join();
+	for (int i = 0; i < all.size(); i++) {
+		ES_ASSERT(all.getAt(i)->isDone());
+	}
+	sp<ECompletableFuture<EInteger> > never = new ECompletableFuture<EInteger>();
+	EArrayList<sp<ECompletableFutureType> > any;
+	any.add(never);
+	any.add(ECompletableFuture<EInteger>::completedFuture(new EInteger(7)));
+	sp<EObject> o = ECompletableFutureType::anyOf(&any)->join();
+	ES_ASSERT(dynamic_cast<EInteger*>(o.get())->intValue() == 7);
+
+	// orTimeout/completeOnTimeout.
+	never->orTimeout(100, ETimeUnit::MILLISECONDS);
+	try {
+		never->join();
+		ES_ASSERT(false);
+	} catch (ECompletionException& ex) {
+		LOG("timeout: %s", never->toString().c_str());
+	}
+	sp<ECompletableFuture<EInteger> > late = new ECompletableFuture<EInteger>();
+	late->completeOnTimeout(new EInteger(42), 10, ETimeUnit::MILLISECONDS);
+	v = late->get();
+	ES_ASSERT(v->intValue() == 42);
+
+	// completing a future takes its timeout off the timer at once.
+	sp<ECompletableFuture<EInteger> > quick = new ECompletableFuture<EInteger>();
+	quick->orTimeout(1, ETimeUnit::HOURS);
+	quick->complete(new EInteger(1));
+	ES_ASSERT(quick->getNumberOfDependents() == 0);
+
+	// a long synchronous chain is completed without recursion.
+	sp<ECompletableFuture<EInteger> > head = new ECompletableFuture<EInteger>();
+	sp<ECompletableFuture<EInteger> > tail = head;
+	for (int i = 0; i < 100000; i++) {
+		tail = tail->thenApply<EInteger>(PlusOne());
+	}
+	head->complete(new EInteger(0));
+	v = tail->join();
+	LOG("chain=%d", v->intValue());
+	ES_ASSERT(v->intValue() == 100000);
+
+	executor->shutdown();
+	executor->awaitTermination();
+	delete executor;
+}
+
+class TickCounter : public ERunnable {
+public:
+	EAtomicCounter count;
+	virtual void run() {
+		++count;
+	}
+};
+
+static void test_scheduledThreadPool() {
+	EScheduledThreadPoolExecutor* stpe = new EScheduledThreadPoolExecutor(2);
+
+	// one-shot delayed runnable and callable.
+	sp<TickCounter> once = new TickCounter();
+	sp<EScheduledFuture<EObject> > f1 = stpe->schedule(once, 50, ETimeUnit::MILLISECONDS);
+	sp<EScheduledFuture<EInteger> > f2 = stpe->schedule<EInteger>(new XCallable(9), 20, ETimeUnit::MILLISECONDS);
+	sp<EInteger> v = f2->get();
+	ES_ASSERT(v->intValue() == 9);
+	f1->get();
+	ES_ASSERT(once->count.value() == 1);
+
+	// periodic tasks keep running until cancelled.
+	sp<TickCounter> rate = new TickCounter();
+	sp<TickCounter> delay = new TickCounter();
+	sp<EScheduledFuture<EObject> > f3 = stpe->scheduleAtFixedRate(rate, 0, 10, ETimeUnit::MILLISECONDS);
+	sp<EScheduledFuture<EObject> > f4 = stpe->scheduleWithFixedDelay(delay, 0, 10, ETimeUnit::MILLISECONDS);
+	EThread::sleep(200);
+	f3->cancel(false);
+	f4->cancel(false);
+	LOG("fixed rate: %d, fixed delay: %d", rate->count.value(), delay->count.value());
+	ES_ASSERT(rate->count.value() > 5 && delay->count.value() > 5);
+
+	// cancelled timers leave the wheel immediately.
+	EArrayList<sp<EScheduledFuture<EObject> > > futures;
+	for (int i = 0; i < 10000; i++) {
+		futures.add(stpe->schedule(once, 3600 + i, ETimeUnit::SECONDS));
+	}
+	ES_ASSERT(stpe->getDelayedTaskCount() == 10000);
+	for (int i = 0; i < futures.size(); i++) {
+		futures.getAt(i)->cancel(false);
+	}
+	ES_ASSERT(stpe->getDelayedTaskCount() == 0);
+
+	// cancelling the last delayed task lets a shut down pool terminate.
+	sp<EScheduledFuture<EObject> > last = stpe->schedule(once, 1, ETimeUnit::HOURS);
+	stpe->shutdown();
+	last->cancel(false);
+	boolean terminated = stpe->awaitTermination(5, ETimeUnit::SECONDS);
+	LOG("terminated after cancel: %d", terminated);
+	ES_ASSERT(terminated);
+	ES_ASSERT(once->count.value() == 1);
+	delete stpe;
+}
+
+template<typename Q>
+class QueueProducer : public EThread {
+public:
+	QueueProducer(Q* q, int base, int n) : q(q), base(base), n(n) {}
+	virtual void run() {
+		for (int i = 0; i < n; i++) {
+			q->put(new EInteger(base + i));
+		}
+	}
+private:
+	Q* q;
+	int base;
+	int n;
+};
+
+template<typename Q>
+class QueueConsumer : public EThread {
+public:
+	EAtomicLLong* sum;
+	QueueConsumer(Q* q, EAtomicLLong* sum, int n) : sum(sum), q(q), n(n) {}
+	virtual void run() {
+		for (int i = 0; i < n; i++) {
+			sp<EInteger> x = q->take();
+			sum->addAndGet(x->intValue());
+		}
+	}
+private:
+	Q* q;
+	int n;
+};
+
+template<typename Q>
+static void run_boundedQueue(Q* q, const char* name) {
+	const int threads = 4, n = 100000;
+	EAtomicLLong sum;
+	EArrayList<EThread*> ts;
+	llong t1 = ESystem::currentTimeMillis();
+	for (int i = 0; i < threads; i++) {
+		ts.add(new QueueProducer<Q>(q, i * n, n));
+		ts.add(new QueueConsumer<Q>(q, &sum, n));
+	}
+	for (int i = 0; i < ts.size(); i++) ts.getAt(i)->start();
+	for (int i = 0; i < ts.size(); i++) ts.getAt(i)->join();
+	llong expect = (llong)threads * n * (threads * n - 1) / 2;
+	LOG("%s: sum=%lld, expect=%lld, cost %lldms", name, sum.get(), expect,
+			ESystem::currentTimeMillis() - t1);
+	ES_ASSERT(sum.get() == expect);
+	ES_ASSERT(q->isEmpty());
+}
+
+static void test_boundedQueues() {
+	EArrayBlockingQueue<EInteger> abq(1024);
+	run_boundedQueue(&abq, "EArrayBlockingQueue");
+
+	EMPMCQueue<EInteger> mpmc(1000);
+	ES_ASSERT(mpmc.capacity() == 1024);
+	run_boundedQueue(&mpmc, "EMPMCQueue");
+
+	// full queue rejects offer, drainTo claims published slots in batches.
+	EMPMCQueue<EInteger> small(4);
+	boolean ok;
+	for (int i = 0; i < 4; i++) {
+		ok = small.offer(new EInteger(i));
+		ES_ASSERT(ok);
+	}
+	ok = small.offer(new EInteger(4));
+	ES_ASSERT(!ok);
+	ok = small.offer(new EInteger(4), 10, ETimeUnit::MILLISECONDS);
+	ES_ASSERT(!ok);
+
+	// remove closes the gap in place, so the order is kept.
+	EInteger one(1);
+	ok = small.remove(&one);
+	ES_ASSERT(ok && small.size() == 3);
+	ok = small.offer(new EInteger(4));
+	ES_ASSERT(ok);
+	sp<EConcurrentIterator<EInteger> > it = small.iterator();
+	while (it->hasNext()) {
+		sp<EInteger> x = it->next();
+		if (x->intValue() == 3)
+			it->remove();
+	}
+	EA<sp<EInteger> > a = small.toArray();
+	ES_ASSERT(a.length() == 3 && a[0]->intValue() == 0 && a[1]->intValue() == 2 && a[2]->intValue() == 4);
+	EArrayList<sp<EInteger> > out;
+	int drained = small.drainTo(&out);
+	ES_ASSERT(drained == 3);
+	LOG("mpmc drained %d", drained);
+	ES_ASSERT(out.getAt(0)->intValue() == 0 && out.getAt(2)->intValue() == 4);
+	sp<EInteger> none = small.poll(10, ETimeUnit::MILLISECONDS);
+	ES_ASSERT(none == null);
+
+	// as the work queue of a thread pool.
+	EThreadPoolExecutor* executor = new EThreadPoolExecutor(4, 4, 0,
+			ETimeUnit::MILLISECONDS, new EMPMCQueue<ERunnable>(4096));
+	sp<TickCounter> counter = new TickCounter();
+	executor->prestartAllCoreThreads();
+	for (int i = 0; i < 100000; i++) {
+		executor->getQueue()->put(counter); // blocks while the ring is full
+	}
+	executor->shutdown();
+	executor->awaitTermination();
+	ES_ASSERT(counter->count.value() == 100000);
+	delete executor;
+}
+
+struct PipelineTask : public EObject, public EMPSCQueueEntry<PipelineTask> {
+	int seq;
+	PipelineTask(int seq) : seq(seq) {}
+};
+
+class SpscProducer : public EThread {
+public:
+	SpscProducer(ESPSCQueue<EInteger>* q, int n) : q(q), n(n) {}
+	virtual void run() {
+		EA<sp<EInteger> > batch(32);
+		for (int i = 0; i < n;) {
+			int k = ES_MIN(32, n - i);
+			for (int j = 0; j < k; j++) batch[j] = new EInteger(i + j);
+			for (int off = 0; off < k; ) {
+				off += q->offerAll(&batch, off, k - off); // one publish per batch
+			}
+			i += k;
+		}
+	}
+private:
+	ESPSCQueue<EInteger>* q;
+	int n;
+};
+
+class MpscProducer : public EThread {
+public:
+	MpscProducer(EMPSCQueue<PipelineTask>* q, int base, int n) : q(q), base(base), n(n) {}
+	virtual void run() {
+		for (int i = 0; i < n; i++) {
+			q->offer(new PipelineTask(base + i));
+		}
+	}
+private:
+	EMPSCQueue<PipelineTask>* q;
+	int base;
+	int n;
+};
+
+static void test_spscMpscQueue() {
+	const int n = 1000000;
+
+	// single producer -> single consumer, FIFO preserved.
+	ESPSCQueue<EInteger> spsc(1024);
+	SpscProducer sp1(&spsc, n);
+	sp1.start();
+	EArrayList<sp<EInteger> > batch;
+	int outOfOrder = 0;
+	for (int expect = 0; expect < n; ) {
+		batch.clear();
+		int k = spsc.drainTo(&batch, 64);
+		for (int i = 0; i < k; i++, expect++) {
+			if (batch.getAt(i)->intValue() != expect)
+				outOfOrder++;
+		}
+	}
+	sp1.join();
+	sp<EInteger> rest = spsc.poll();
+	ES_ASSERT(outOfOrder == 0 && rest == null);
+
+	// many producers -> single consumer, per-producer FIFO preserved.
+	EMPSCQueue<PipelineTask> mpsc;
+	MpscProducer mp1(&mpsc, 0, n), mp2(&mpsc, n, n);
+	mp1.start();
+	mp2.start();
+	int last[2] = {-1, -1};
+	EArrayList<sp<PipelineTask> > tasks;
+	for (int got = 0; got < 2 * n; ) {
+		tasks.clear();
+		int k = mpsc.drainTo(&tasks, 64);
+		for (int i = 0; i < k; i++, got++) {
+			int seq = tasks.getAt(i)->seq;
+			if (seq % n != last[seq / n] + 1)
+				outOfOrder++;
+			last[seq / n] = seq % n;
+		}
+	}
+	mp1.join();
+	mp2.join();
+	LOG("spsc/mpsc: outOfOrder=%d, last=%d/%d", outOfOrder, last[0], last[1]);
+	ES_ASSERT(outOfOrder == 0 && mpsc.isEmpty());
+}
+
+class AdaptiveLockWorker : public EThread {
+public:
+	AdaptiveLockWorker(EAdaptiveReentrantLock* lock, EAdaptiveSemaphore* sem,
+			EAdaptiveCountDownLatch* latch, llong* counter, int n) :
+			lock(lock), sem(sem), latch(latch), counter(counter), n(n) {}
+	virtual void run() {
+		for (int i = 0; i < n; i++) {
+			lock->lock();
+			(*counter)++;
+			lock->unlock();
+
+			sem->acquire();
+			sem->release();
+		}
+		latch->countDown();
+	}
+private:
+	EAdaptiveReentrantLock* lock;
+	EAdaptiveSemaphore* sem;
+	EAdaptiveCountDownLatch* latch;
+	llong* counter;
+	int n;
+};
+
+static void test_adaptiveLocks() {
+	const int threads = 4;
+	const int n = 200000;
+	llong counter = 0;
+
+	EAdaptiveReentrantLock lock;
+	EAdaptiveSemaphore sem(2);
+	EAdaptiveCountDownLatch latch(threads);
+	EArrayList<AdaptiveLockWorker*> workers;
+	for (int i = 0; i < threads; i++) {
+		AdaptiveLockWorker* w = new AdaptiveLockWorker(&lock, &sem, &latch, &counter, n);
+		workers.add(w);
+		w->start();
+	}
+	latch.await();
+	for (int i = 0; i < threads; i++) {
+		workers.getAt(i)->join();
+	}
+	ES_ASSERT(counter == (llong)threads * n);
+	ES_ASSERT(sem.availablePermits() == 2);
+
+	// conditions wrap the base lock's ones.
+	sp<ECondition> cond(lock.newCondition());
+	lock.lock();
+	ES_ASSERT(!lock.hasWaiters(cond.get()));
+	boolean signalled = cond->await(1, ETimeUnit::MILLISECONDS);
+	lock.unlock();
+	ES_ASSERT(!signalled);
+	LOG("cond: timed await %s", signalled ? "signalled" : "timed out");
+
+	// a park-only lock never spins.
+	EAdaptiveReentrantLock parkLock(false, ESpinControl::PARK);
+	ES_ASSERT(parkLock.getSpinControl()->budget() == 0);
+
+	LOG("lock: %s", lock.toString().c_str());
+	LOG("sem: %s", sem.toString().c_str());
+	LOG("latch: %s", latch.toString().c_str());
+}
+
+class StampedPoint {
+public:
+	StampedPoint() : x(0), y(0) {}
+	void move(llong d) {
+		llong stamp = sl.writeLock();
+		x += d;
+		y += d;
+		sl.unlockWrite(stamp);
+	}
+	boolean consistent() {
+		llong stamp = sl.tryOptimisticRead();
+		llong cx = x, cy = y;
+		if (!sl.validate(stamp)) {
+			stamp = sl.readLock();
+			cx = x;
+			cy = y;
+			sl.unlockRead(stamp);
+		}
+		return cx == cy;
+	}
+	volatile llong x, y;
+	EStampedLock sl;
+};
+
+class StampedWorker : public EThread {
+public:
+	StampedWorker(StampedPoint* p, boolean writer, int n, EAtomicCounter* bad) :
+		p(p), writer(writer), n(n), bad(bad) {}
+	virtual void run() {
+		for (int i = 0; i < n; i++) {
+			if (writer) p->move(1);
+			else if (!p->consistent()) ++(*bad);
+		}
+	}
+private:
+	StampedPoint* p;
+	boolean writer;
+	int n;
+	EAtomicCounter* bad;
+};
+
+static void test_stampedLock() {
+	EStampedLock sl;
+
+	// optimistic read is broken by a writer.
+	llong o = sl.tryOptimisticRead();
+	ES_ASSERT(o != 0 && sl.validate(o));
+	llong w = sl.writeLock();
+	int granted = 0;
+	if (sl.tryOptimisticRead() != 0) granted++;
+	if (sl.tryReadLock() != 0) granted++;
+	if (sl.tryWriteLock() != 0) granted++;
+	ES_ASSERT(!sl.validate(o) && granted == 0);
+
+	// write -> read -> write -> optimistic conversions.
+	llong r = sl.tryConvertToReadLock(w);
+	ES_ASSERT(r != 0 && sl.isReadLocked() && !sl.isWriteLocked());
+	w = sl.tryConvertToWriteLock(r);
+	ES_ASSERT(w != 0 && sl.isWriteLocked());
+	o = sl.tryConvertToOptimisticRead(w);
+	ES_ASSERT(o != 0 && sl.validate(o) && !sl.isWriteLocked());
+
+	// read locks stack beyond the in-state reader count.
+	llong stamps[300];
+	for (int i = 0; i < 300; i++) stamps[i] = sl.readLock();
+	ES_ASSERT(sl.getReadLockCount() == 300);
+	if (sl.tryConvertToWriteLock(stamps[0]) != 0) granted++;
+	ES_ASSERT(granted == 0);
+	for (int i = 0; i < 300; i++) sl.unlockRead(stamps[i]);
+	ES_ASSERT(sl.getReadLockCount() == 0 && sl.validate(o));
+	LOG("stamped: granted while held=%d, optimistic stamp %lld valid=%d", granted, o, sl.validate(o));
+
+	try {
+		sl.unlockWrite(w);
+		ES_ASSERT(false);
+	} catch (EIllegalStateException& e) {
+	}
+
+	// optimistic readers never observe a torn point.
+	StampedPoint p;
+	EAtomicCounter bad;
+	StampedWorker w1(&p, true, 200000, &bad), w2(&p, true, 200000, &bad);
+	StampedWorker r1(&p, false, 1000000, &bad), r2(&p, false, 1000000, &bad);
+	w1.start(); w2.start(); r1.start(); r2.start();
+	w1.join(); w2.join(); r1.join(); r2.join();
+	ES_ASSERT(bad.value() == 0);
+	ES_ASSERT(p.x == 400000 && p.y == 400000);
+	LOG("stamped: %s", p.sl.toString().c_str());
+}
+
+class CowReader : public EThread {
+public:
+	CowReader(ECopyOnWriteArrayList<EInteger>* list, volatile boolean* stop) :
+		list(list), stop(stop), reads(0) {}
+	virtual void run() {
+		while (!*stop) {
+			int n = list->size();
+			if (n > 0) {
+				sp<EInteger> v = list->getAt(0);
+				ES_ASSERT(v != null);
+			}
+			sp<EConcurrentIterator<EInteger> > iter = list->iterator();
+			while (iter->hasNext()) {
+				sp<EInteger> v = iter->next();
+				ES_ASSERT(v != null);
+			}
+			reads++;
+		}
+	}
+	ECopyOnWriteArrayList<EInteger>* list;
+	volatile boolean* stop;
+	llong reads;
+};
+
+static void test_copyOnWriteReaders() {
+	ECopyOnWriteArrayList<EInteger> list;
+	list.add(new EInteger(0));
+	volatile boolean stop = false;
+	CowReader r1(&list, &stop), r2(&list, &stop), r3(&list, &stop);
+	r1.start(); r2.start(); r3.start();
+	for (int i = 1; i < 200000; i++) {
+		list.add(new EInteger(i));
+		if (list.size() > 8) list.removeAt(1);
+		list.setAt(0, list.getAt(0)); // same element, list keeps its array
+	}
+	stop = true;
+	r1.join(); r2.join(); r3.join();
+	ES_ASSERT(list.size() == 8);
+	LOG("cow reads: %lld", r1.reads + r2.reads + r3.reads);
+}
+
+class RouteTable : public EObject {
+public:
+	RouteTable(int version) : version(version), check(version) {}
+	int version;
+	int check;
+};
+
+class RouteUpdater : public EThread {
+public:
+	RouteUpdater(EAtomicSharedPtr<RouteTable>* routes, int n) : routes(routes), n(n) {}
+	virtual void run() {
+		for (int i = 0; i < n; i++) {
+			sp<RouteTable> e = atomic_load(routes);
+			while (!atomic_compare_exchange(routes, &e, sp<RouteTable>(new RouteTable(e->version + 1)))) {
+			}
+		}
+	}
+private:
+	EAtomicSharedPtr<RouteTable>* routes;
+	int n;
+};
+
+struct RouteChecker {
+	RouteChecker() : torn(0) {}
+	void operator()(RouteTable* t) {
+		if (t == null || t->version != t->check) torn++;
+	}
+	int torn;
+};
+
+class RouteReader : public EThread {
+public:
+	RouteReader(EAtomicSharedPtr<RouteTable>* routes, volatile boolean* stop) : torn(0), routes(routes), stop(stop) {}
+	virtual void run() {
+		RouteChecker checker;
+		while (!*stop) {
+			sp<RouteTable> t = atomic_load(routes);
+			if (t == null || t->version != t->check) torn++;
+			routes->read(checker);
+			EAtomicSharedPtr<RouteTable>::Guard g(routes);
+			if (g->version != g->check) torn++;
+		}
+		torn += checker.torn;
+	}
+	int torn;
+private:
+	EAtomicSharedPtr<RouteTable>* routes;
+	volatile boolean* stop;
+};
+
+class RouteStorer : public EThread {
+public:
+	RouteStorer(EAtomicSharedPtr<RouteTable>* routes, int n) : routes(routes), n(n) {}
+	virtual void run() {
+		for (int i = 1; i <= n; i++) {
+			atomic_store(routes, sp<RouteTable>(new RouteTable(i)));
+		}
+	}
+private:
+	EAtomicSharedPtr<RouteTable>* routes;
+	int n;
+};
+
+class RouteGuardHolder : public EThread {
+public:
+	RouteGuardHolder(EAtomicSharedPtr<RouteTable>* routes, volatile boolean* stop) : reads(0), torn(0), routes(routes), stop(stop) {}
+	virtual void run() {
+		while (!*stop) {
+			EAtomicSharedPtr<RouteTable>::Guard g(routes);
+			// keep the guard across a little work, so the writer keeps
+			// retiring tables that are still published
+			for (int i = 0; i < 64; i++) {
+				if (g->version != g->check) torn++;
+			}
+			reads++;
+		}
+	}
+	llong reads;
+	int torn;
+private:
+	EAtomicSharedPtr<RouteTable>* routes;
+	volatile boolean* stop;
+};
+
+#define GUARD_HOLDERS 4
+static void test_atomicSharedPtrRetire() {
+	EAtomicSharedPtr<RouteTable> routes(sp<RouteTable>(new RouteTable(0)));
+	llong alone = 0;
+	llong shared = 0;
+
+	for (int round = 0; round < 2; round++) {
+		volatile boolean stop = false;
+		sp<RouteGuardHolder> readers[GUARD_HOLDERS];
+		for (int i = 0; i < GUARD_HOLDERS; i++) {
+			readers[i] = new RouteGuardHolder(&routes, &stop);
+			readers[i]->start();
+		}
+		llong t1 = ESystem::currentTimeMillis();
+		if (round == 0) {
+			EThread::sleep(200);
+		} else {
+			RouteStorer writer(&routes, 200000);
+			writer.start();
+			writer.join();
+		}
+		stop = true;
+		llong t2 = ESystem::currentTimeMillis();
+
+		llong reads = 0;
+		int starved = 0;
+		int torn = 0;
+		for (int i = 0; i < GUARD_HOLDERS; i++) {
+			readers[i]->join();
+			if (readers[i]->reads == 0) starved++;
+			reads += readers[i]->reads;
+			torn += readers[i]->torn;
+		}
+		ES_ASSERT(starved == 0 && torn == 0);
+		llong rate = reads / ES_MAX(t2 - t1, 1);
+		if (round == 0) alone = rate; else shared = rate;
+		LOG("%s: %d readers, %lld reads in %lld ms, starved=%d, torn=%d",
+				round == 0 ? "readers alone" : "readers with retiring writer",
+				GUARD_HOLDERS, reads, t2 - t1, starved, torn);
+	}
+	ES_ASSERT(routes.load()->version == 200000);
+	LOG("guard reads per ms: alone=%lld, with writer=%lld", alone, shared);
+}
+
+static void test_atomicSharedPtr() {
+	EAtomicSharedPtr<RouteTable> empty;
+	ES_ASSERT(empty.load() == null);
+	sp<RouteTable> expect;
+	boolean swapped = atomic_compare_exchange(&empty, &expect, sp<RouteTable>(new RouteTable(1)));
+	ES_ASSERT(swapped);
+	sp<RouteTable> stale(new RouteTable(9));
+	swapped = atomic_compare_exchange(&empty, &stale, sp<RouteTable>(new RouteTable(2)));
+	ES_ASSERT(!swapped && stale->version == 1);
+	sp<RouteTable> old = atomic_exchange(&empty, sp<RouteTable>(new RouteTable(3)));
+	ES_ASSERT(old->version == 1);
+	atomic_store(&empty, null);
+	ES_ASSERT(atomic_load(&empty) == null);
+	RouteChecker checker;
+	empty.read(checker);
+	ES_ASSERT(checker.torn == 1); // called with null
+
+	EAtomicSharedPtr<RouteTable> routes(sp<RouteTable>(new RouteTable(0)));
+	volatile boolean stop = false;
+	RouteReader r1(&routes, &stop), r2(&routes, &stop);
+	RouteUpdater u1(&routes, 100000), u2(&routes, 100000);
+	r1.start(); r2.start(); u1.start(); u2.start();
+	u1.join(); u2.join();
+	stop = true;
+	r1.join(); r2.join();
+	ES_ASSERT(r1.torn == 0 && r2.torn == 0);
+	ES_ASSERT(routes.load()->version == 200000);
+	LOG("atomic sp ok, torn=%d", r1.torn + r2.torn);
+}
+
+class EpochProducer : public EThread {
+public:
+	EpochProducer(EEpochLinkedQueue<EInteger>* queue, int base, int n) : queue(queue), base(base), n(n) {}
+	virtual void run() {
+		for (int i = 0; i < n; i++) {
+			queue->offer(new EInteger(base + i));
+		}
+	}
+private:
+	EEpochLinkedQueue<EInteger>* queue;
+	int base;
+	int n;
+};
+
+class EpochConsumer : public EThread {
+public:
+	EpochConsumer(EEpochLinkedQueue<EInteger>* queue, EAtomicLLong* sum, EAtomicInteger* count, int total) :
+		queue(queue), sum(sum), count(count), total(total) {}
+	virtual void run() {
+		while (count->get() < total) {
+			sp<EInteger> x = queue->poll();
+			if (x != null) {
+				sum->addAndGet(x->intValue());
+				count->incrementAndGet();
+			}
+		}
+	}
+private:
+	EEpochLinkedQueue<EInteger>* queue;
+	EAtomicLLong* sum;
+	EAtomicInteger* count;
+	int total;
+};
+
+class EpochMapWriter : public EThread {
+public:
+	EpochMapWriter(EEpochSkipListMap<EInteger, EInteger>* map, int seed) : map(map), seed(seed) {}
+	virtual void run() {
+		ERandom random(seed);
+		for (int i = 0; i < 100000; i++) {
+			int k = random.nextInt(1000);
+			if (random.nextBoolean()) {
+				map->put(new EInteger(k), new EInteger(k));
+			} else {
+				EInteger key(k);
+				map->remove(&key);
+			}
+		}
+	}
+private:
+	EEpochSkipListMap<EInteger, EInteger>* map;
+	int seed;
+};
+
+class EpochMapReader : public EThread {
+public:
+	EpochMapReader(EEpochSkipListMap<EInteger, EInteger>* map, volatile boolean* stop) : map(map), stop(stop) {}
+	virtual void run() {
+		while (!*stop) {
+			for (int k = 0; k < 1000; k += 7) {
+				EInteger key(k);
+				sp<EInteger> v = map->get(&key);
+				ES_ASSERT(v == null || v->intValue() == k);
+			}
+		}
+	}
+private:
+	EEpochSkipListMap<EInteger, EInteger>* map;
+	volatile boolean* stop;
+};
+
+static void test_epochReclamation() {
+	EEpochManager* em = EEpochManager::getInstance();
+
+	// fifo semantics
+	EEpochLinkedQueue<EInteger> q;
+	q.offer(new EInteger(1));
+	q.offer(new EInteger(2));
+	q.offer(new EInteger(3));
+	EInteger two(2);
+	boolean removed = q.remove(&two);
+	ES_ASSERT(removed && !q.contains(&two));
+	ES_ASSERT(q.size() == 2);
+	sp<EInteger> first = q.poll();
+	sp<EInteger> second = q.poll();
+	sp<EInteger> third = q.poll();
+	ES_ASSERT(first->intValue() == 1 && second->intValue() == 3 && third == null);
+	LOG("epoch queue: removed=%d, polled %d, %d", removed, first->intValue(), second->intValue());
+
+	// mpmc
+	EAtomicLLong sum;
+	EAtomicInteger count;
+	EpochProducer p1(&q, 0, 100000), p2(&q, 100000, 100000);
+	EpochConsumer c1(&q, &sum, &count, 200000), c2(&q, &sum, &count, 200000);
+	p1.start(); p2.start(); c1.start(); c2.start();
+	p1.join(); p2.join(); c1.join(); c2.join();
+	ES_ASSERT(sum.get() == 199999LL * 200000 / 2);
+
+	// sorted map
+	EEpochSkipListMap<EInteger, EInteger> map;
+	for (int i = 0; i < 100; i++) {
+		map.put(new EInteger(i), new EInteger(i));
+	}
+	EInteger k50(50);
+	sp<EInteger> v50 = map.remove(&k50);
+	ES_ASSERT(v50->intValue() == 50);
+	ES_ASSERT(map.get(&k50) == null);
+	ES_ASSERT(map.ceilingKey(&k50)->intValue() == 51);
+	ES_ASSERT(map.firstKey()->intValue() == 0 && map.lastKey()->intValue() == 99);
+	ES_ASSERT(map.size() == 99);
+	map.clear();
+	ES_ASSERT(map.isEmpty());
+
+	volatile boolean stop = false;
+	EpochMapWriter w1(&map, 1), w2(&map, 2);
+	EpochMapReader r1(&map, &stop), r2(&map, &stop);
+	w1.start(); w2.start(); r1.start(); r2.start();
+	w1.join(); w2.join();
+	stop = true;
+	r1.join(); r2.join();
+
+	em->barrier();
+	ES_ASSERT(em->getPendingCount() == 0);
+	LOG("%s", em->toString().c_str());
+
+	// hazard pointers
+	{
+		EHazardPointer hp;
+		EInteger* volatile shared = new EInteger(7);
+		EInteger* p = hp.protect(shared);
+		shared = null;
+		EHazardPointer::retire(p);
+		EHazardPointer::reclaim();
+		ES_ASSERT(p->intValue() == 7); // still protected
+		hp.clear();
+		EHazardPointer::reclaim();
+		ES_ASSERT(EHazardPointer::getPendingCount() == 0);
+	}
+	LOG("epoch reclamation ok");
+}
+
+#define PADDED_BENCH_TIMES 50000000
+static void test_padded_benchmark() {
+	// two counters written by two threads: adjacent vs. padded
+	struct Adjacent {
+		EAtomicCounter a;
+		EAtomicCounter b;
+	};
+	struct Padded {
+		EPadded<EAtomicCounter> a;
+		EPadded<EAtomicCounter> b;
+	};
+	class Counting: public EThread {
+	public:
+		Counting(EAtomicCounter* c) : c(c) {
+		}
+		virtual void run() {
+			for (int i = 0; i < PADDED_BENCH_TIMES; i++) {
+				(*c)++;
+			}
+		}
+	private:
+		EAtomicCounter* c;
+	};
+
+	for (int round = 0; round < 2; round++) {
+		Adjacent adjacent;
+		Padded padded;
+		EAtomicCounter* a = (round == 0) ? &adjacent.a : padded.a.get();
+		EAtomicCounter* b = (round == 0) ? &adjacent.b : padded.b.get();
+
+		llong t1 = ESystem::currentTimeMillis();
+		sp<Counting> t_a = new Counting(a);
+		sp<Counting> t_b = new Counting(b);
+		t_a->start();
+		t_b->start();
+		t_a->join();
+		t_b->join();
+		llong t2 = ESystem::currentTimeMillis();
+
+		LOG("%s: 2 thread run %d times, cost %ld ms", round == 0 ? "adjacent" : "padded",
+				PADDED_BENCH_TIMES, t2 - t1);
+	}
+
+	// the field layout of ELinkedBlockingQueue: consumers write head,
+	// producers write last, both update count
+	struct AdjacentEnds {
+		EAtomicInteger head;
+		EAtomicInteger count;
+		EAtomicInteger last;
+	};
+	struct PaddedEnds {
+		EAtomicInteger head;
+		EPadded<EAtomicInteger> count;
+		EAtomicInteger last;
+	};
+	class QueueEnd: public EThread {
+	public:
+		QueueEnd(EAtomicInteger* end, EAtomicInteger* count, int delta) :
+				end(end), count(count), delta(delta) {
+		}
+		virtual void run() {
+			for (int i = 0; i < PADDED_BENCH_TIMES; i++) {
+				end->set(i);
+				count->getAndAdd(delta);
+			}
+		}
+	private:
+		EAtomicInteger* end;
+		EAtomicInteger* count;
+		int delta;
+	};
+
+	for (int round = 0; round < 2; round++) {
+		AdjacentEnds adjacent;
+		PaddedEnds padded;
+		EAtomicInteger* head = (round == 0) ? &adjacent.head : &padded.head;
+		EAtomicInteger* count = (round == 0) ? &adjacent.count : padded.count.get();
+		EAtomicInteger* last = (round == 0) ? &adjacent.last : &padded.last;
+
+		llong t1 = ESystem::currentTimeMillis();
+		sp<QueueEnd> consumer = new QueueEnd(head, count, -1);
+		sp<QueueEnd> producer = new QueueEnd(last, count, 1);
+		consumer->start();
+		producer->start();
+		consumer->join();
+		producer->join();
+		llong t2 = ESystem::currentTimeMillis();
+
+		ES_ASSERT(count->get() == 0);
+		LOG("%s queue ends: 2 thread run %d times, cost %ld ms",
+				round == 0 ? "adjacent" : "padded", PADDED_BENCH_TIMES, t2 - t1);
+	}
+}
+
+static void test_threadPoolExecuteAll() {
+	sp<TickCounter> counter = new TickCounter();
+
+	// unbounded queue: the whole batch is queued at once
+	EThreadPoolExecutor* executor = new EThreadPoolExecutor(4, 4, 0,
+			ETimeUnit::MILLISECONDS, new ELinkedBlockingQueue<ERunnable>());
+	for (int round = 0; round < 100; round++) {
+		EArrayList<sp<ERunnable> > batch;
+		for (int i = 0; i < 5000; i++) {
+			batch.add(counter);
+		}
+		executor->executeAll(&batch);
+	}
+	executor->shutdown();
+	executor->awaitTermination();
+	ES_ASSERT(counter->count.value() == 500000);
+	delete executor;
+
+	// workers take the queued batch 16 tasks at a time
+	counter = new TickCounter();
+	executor = new EThreadPoolExecutor(4, 4, 0, ETimeUnit::MILLISECONDS,
+			new EWorkerLocalQueue<ERunnable>(new ELinkedBlockingQueue<ERunnable>(), 32, 16));
+	for (int round = 0; round < 100; round++) {
+		EArrayList<sp<ERunnable> > batch;
+		for (int i = 0; i < 5000; i++) {
+			batch.add(counter);
+		}
+		executor->executeAll(&batch);
+	}
+	executor->shutdown();
+	executor->awaitTermination();
+	ES_ASSERT(counter->count.value() == 500000);
+	LOG("executeAll with batched workers: %d", counter->count.value());
+	delete executor;
+
+	// bounded queues: the overflow takes the execute() path
+	counter = new TickCounter();
+	for (int q = 0; q < 2; q++) {
+		sp<EBlockingQueue<ERunnable> > queue;
+		if (q == 0) queue = new ELinkedBlockingQueue<ERunnable>(100);
+		else queue = new EArrayBlockingQueue<ERunnable>(100);
+		executor = new EThreadPoolExecutor(2, 4, 0, ETimeUnit::MILLISECONDS,
+				queue, new EThreadPoolExecutor::CallerRunsPolicy());
+		ELinkedList<sp<ERunnable> > batch;
+		for (int i = 0; i < 10000; i++) {
+			batch.add(counter);
+		}
+		executor->executeAll(&batch);
+		executor->shutdown();
+		executor->awaitTermination();
+		delete executor;
+	}
+	ES_ASSERT(counter->count.value() == 20000);
+
+	// a null task is refused before anything is queued
+	executor = new EThreadPoolExecutor(1, 1, 0,
+			ETimeUnit::MILLISECONDS, new ELinkedBlockingQueue<ERunnable>());
+	EArrayList<sp<ERunnable> > bad;
+	bad.add(counter);
+	bad.add(null);
+	try {
+		executor->executeAll(&bad);
+		ES_ASSERT(false);
+	} catch (ENullPointerException& e) {
+	}
+	ES_ASSERT(executor->getTaskCount() == 0);
+	executor->shutdown();
+	executor->awaitTermination();
+	delete executor;
+	LOG("executeAll ok");
+}
+
+class FollowUpTask : public ERunnable {
+public:
+	FollowUpTask(EExecutorService* executor, EAtomicCounter* done, EAtomicCounter* local, int depth, long owner) :
+		executor(executor), done(done), local(local), depth(depth), owner(owner) {
+	}
+	virtual void run() {
+		long self = EThread::currentThread()->getId();
+		if (owner == self) {
+			++(*local);
+		}
+		++(*done);
+		if (depth > 0) {
+			executor->execute(new FollowUpTask(executor, done, local, depth - 1, self));
+		}
+	}
+private:
+	EExecutorService* executor;
+	EAtomicCounter* done;
+	EAtomicCounter* local;
+	int depth;
+	long owner;
+};
+
+static void test_workerLocalQueue() {
+	EAtomicCounter done;
+	EAtomicCounter local;
+	EExecutorService* executor = EExecutors::newAffinityThreadPool(4);
+	for (int i = 0; i < 1000; i++) {
+		executor->execute(new FollowUpTask(executor, &done, &local, 9, -1));
+	}
+	while (done.value() < 10000) {
+		EThread::sleep(10);
+	}
+	executor->shutdown();
+	executor->awaitTermination();
+	ES_ASSERT(done.value() == 10000);
+	LOG("follow-ups run by the submitting worker: %d of 9000", local.value());
+	delete executor;
+
+	// shutdownNow() also collects the cached tasks
+	sp<EWorkerLocalQueue<ERunnable> > queue = new EWorkerLocalQueue<ERunnable>(
+			new ELinkedBlockingQueue<ERunnable>(), 4);
+	EThreadPoolExecutor* pool = new EThreadPoolExecutor(1, 1, 0, ETimeUnit::MILLISECONDS, queue);
+	pool->prestartAllCoreThreads();
+	ES_ASSERT(queue->isEmpty());
+	pool->shutdown();
+	pool->awaitTermination();
+	delete pool;
+
+	ES_ASSERT(EAffinityThreadFactory::pinCurrentThread(-1) == false);
+	LOG("worker local queue ok");
+}
+
+#define PHASER_PARTIES 64
+#define PHASER_PHASES  200
+
+static EAtomicCounter phaserMisses;
+
+class PhaserParty : public EThread {
+public:
+	PhaserParty(EPhaser* phaser, EAtomicCounter* arrivals) :
+			phaser(phaser), arrivals(arrivals) {
+	}
+	virtual void run() {
+		for (int i = 0; i < PHASER_PHASES; i++) {
+			(*arrivals)++;
+			int phase = phaser->arriveAndAwaitAdvance();
+			// every party of phase i arrived before anyone got here
+			if (phase != i + 1 || arrivals->value() < (i + 1) * PHASER_PARTIES) {
+				phaserMisses++;
+			}
+		}
+		phaser->arriveAndDeregister();
+	}
+private:
+	EPhaser* phaser;
+	EAtomicCounter* arrivals;
+};
+
+static void test_phaser() {
+	phaserMisses = 0;
+
+	// flat: 64 parties on one phaser
+	{
+		EPhaser phaser(PHASER_PARTIES);
+		EAtomicCounter arrivals;
+		EArray<EThread*> arr;
+		llong t1 = ESystem::currentTimeMillis();
+		for (int i = 0; i < PHASER_PARTIES; i++) {
+			EThread* t = new PhaserParty(&phaser, &arrivals);
+			t->start();
+			arr.add(t);
+		}
+		for (int i = 0; i < PHASER_PARTIES; i++) {
+			arr.getAt(i)->join();
+		}
+		llong t2 = ESystem::currentTimeMillis();
+		ES_ASSERT(arrivals.value() == PHASER_PARTIES * PHASER_PHASES);
+		ES_ASSERT(phaser.getRegisteredParties() == 0);
+		ES_ASSERT(phaser.isTerminated());
+		LOG("flat phaser: %d parties, %d phases, cost %ld ms", PHASER_PARTIES, PHASER_PHASES, t2 - t1);
+	}
+
+	// tiered: 8 sub-phasers of 8 parties under one root
+	{
+		sp<EPhaser> root = new EPhaser();
+		EArray<EPhaser*> tiers;
+		for (int i = 0; i < 8; i++) {
+			tiers.add(new EPhaser(root, PHASER_PARTIES / 8));
+		}
+		ES_ASSERT(root->getRegisteredParties() == 8);
+		EAtomicCounter arrivals;
+		EArray<EThread*> arr;
+		llong t1 = ESystem::currentTimeMillis();
+		for (int i = 0; i < PHASER_PARTIES; i++) {
+			EThread* t = new PhaserParty(tiers.getAt(i % 8), &arrivals);
+			t->start();
+			arr.add(t);
+		}
+		for (int i = 0; i < PHASER_PARTIES; i++) {
+			arr.getAt(i)->join();
+		}
+		llong t2 = ESystem::currentTimeMillis();
+		ES_ASSERT(arrivals.value() == PHASER_PARTIES * PHASER_PHASES);
+		ES_ASSERT(root->getRegisteredParties() == 0);
+		ES_ASSERT(root->isTerminated());
+		ES_ASSERT(tiers.getAt(0)->getRoot() == root.get());
+		LOG("tiered phaser: %d parties, %d phases, cost %ld ms", PHASER_PARTIES, PHASER_PHASES, t2 - t1);
+	}
+	ES_ASSERT(phaserMisses.value() == 0);
+	LOG("phaser misses: %d", phaserMisses.value());
+
+	// dynamic registration, timeout and termination
+	{
+		EPhaser phaser(1);
+		int phase = phaser.register_();
+		ES_ASSERT(phase == 0);
+		ES_ASSERT(phaser.getRegisteredParties() == 2);
+		phase = phaser.arrive();
+		ES_ASSERT(phase == 0);
+		ES_ASSERT(phaser.getArrivedParties() == 1);
+		try {
+			phaser.awaitAdvanceInterruptibly(0, 10, ETimeUnit::MILLISECONDS);
+			ES_ASSERT(false);
+		} catch (ETimeoutException& e) {
+		}
+		phase = phaser.arriveAndDeregister();
+		ES_ASSERT(phase == 0);
+		ES_ASSERT(phaser.getPhase() == 1);
+		phase = phaser.bulkRegister(2);
+		ES_ASSERT(phase == 1);
+		ES_ASSERT(phaser.getUnarrivedParties() == 3);
+		phaser.forceTermination();
+		ES_ASSERT(phaser.isTerminated());
+		phase = phaser.arriveAndAwaitAdvance();
+		ES_ASSERT(phase < 0);
+		LOG("%s, last phase %d", phaser.toString().c_str(), phase);
+	}
+
+	LOG("phaser ok");
+}
+
+/**
+ * put/take over a non-blocking queue, for run_boundedQueue: take spins
+ * on poll.
+ */
+template<typename Q>
+class SpinningQueue {
+public:
+	explicit SpinningQueue(Q* q) : q(q) {}
+	void put(EInteger* e) {
+		q->offer(e);
+	}
+	sp<EInteger> take() {
+		for (;;) {
+			sp<EInteger> x = q->poll();
+			if (x != null) return x;
+			EThread::yield();
+		}
+	}
+	boolean isEmpty() {
+		return q->isEmpty();
+	}
+private:
+	Q* q;
+};
+
+static void test_priorityQueues() {
+	// blocking: strict order, growth from a tiny array, blocking take.
+	EPriorityBlockingQueue<EInteger> pbq(2);
+	for (int i = 100; i > 0; i--) pbq.offer(new EInteger(i));
+	EInteger fifty(50);
+	ES_ASSERT(pbq.size() == 100);
+	boolean removed = pbq.remove(&fifty);
+	ES_ASSERT(removed && !pbq.contains(&fifty));
+	int misordered = 0;
+	for (int i = 1; i <= 100; i++) {
+		if (i == 50) continue;
+		sp<EInteger> x = pbq.take();
+		if (x->intValue() != i) misordered++;
+	}
+	sp<EInteger> none = pbq.poll(10, ETimeUnit::MILLISECONDS);
+	LOG("EPriorityBlockingQueue: removed=%d, misordered=%d", removed, misordered);
+	ES_ASSERT(misordered == 0 && none == null);
+	run_boundedQueue(&pbq, "EPriorityBlockingQueue");
+
+	// lock-free skip list: strict pollFirst order single-threaded.
+	EConcurrentSkipListPriorityQueue<EInteger> slpq;
+	for (int i = 1000; i > 0; i--) slpq.offer(new EInteger(i % 10));
+	EA<sp<EInteger> > arr = slpq.toArray();
+	for (int i = 1; i < arr.length(); i++) {
+		ES_ASSERT(arr[i - 1]->intValue() <= arr[i]->intValue());
+	}
+	misordered = 0;
+	for (int i = 0; i < 1000; i++) {
+		sp<EInteger> x = slpq.poll();
+		if (x->intValue() != i / 100) misordered++;
+	}
+	none = slpq.poll();
+	LOG("EConcurrentSkipListPriorityQueue: misordered=%d", misordered);
+	ES_ASSERT(misordered == 0 && none == null && slpq.isEmpty());
+	SpinningQueue<EConcurrentSkipListPriorityQueue<EInteger> > slpqs(&slpq);
+	run_boundedQueue(&slpqs, "EConcurrentSkipListPriorityQueue");
+
+	// relaxed: spray polls return elements close to the head.
+	EConcurrentSkipListPriorityQueue<EInteger> spray(null, 8);
+	for (int i = 0; i < 1000; i++) spray.offer(new EInteger(i));
+	int maxv = 0;
+	for (int i = 0; i < 100; i++) {
+		maxv = ES_MAX(maxv, spray.poll()->intValue());
+	}
+	LOG("spray: max of first 100 polls = %d", maxv);
+	spray.clear();
+	SpinningQueue<EConcurrentSkipListPriorityQueue<EInteger> > sprays(&spray);
+	run_boundedQueue(&sprays, "EConcurrentSkipListPriorityQueue(spray)");
+
+	LOG("priority queues ok");
+}
+
+static void test_flatHashMap() {
+	const int n = 1000000;
+
+	EFlatHashMap<int, sp<EInteger> > fm(16);
+	llong t1 = ESystem::currentTimeMillis();
+	for (int i = 0; i < n; i++) {
+		fm.put(i * 7, new EInteger(i));
+	}
+	int misses = 0;
+	for (int i = 0; i < n; i++) {
+		if (fm.get(i * 7)->intValue() != i) misses++;
+		if (fm.containsKey(i * 7 + 1)) misses++;
+	}
+	llong t2 = ESystem::currentTimeMillis();
+	EHashMap<int, sp<EInteger> > hm;
+	for (int i = 0; i < n; i++) {
+		hm.put(i * 7, new EInteger(i));
+	}
+	for (int i = 0; i < n; i++) {
+		if (hm.get(i * 7)->intValue() != i) misses++;
+		if (hm.containsKey(i * 7 + 1)) misses++;
+	}
+	llong t3 = ESystem::currentTimeMillis();
+	LOG("EFlatHashMap: %lldms, EHashMap: %lldms, capacity=%d, misses=%d", t2 - t1, t3 - t2, fm.capacity(), misses);
+	ES_ASSERT(misses == 0);
+
+	// removal through views and iterators.
+	for (int i = 0; i < n; i += 2) {
+		sp<EInteger> v = fm.remove(i * 7);
+		if (v->intValue() != i) misses++;
+	}
+	ES_ASSERT(misses == 0);
+	ES_ASSERT(fm.size() == n / 2 && fm.get(0) == null);
+	sp<EIterator<EMapEntry<int, sp<EInteger> >*> > it = fm.entrySet()->iterator();
+	while (it->hasNext()) {
+		EMapEntry<int, sp<EInteger> >* e = it->next();
+		ES_ASSERT(e->getKey() == e->getValue()->intValue() * 7);
+		if (e->getValue()->intValue() % 3 == 0) it->remove();
+	}
+	ES_ASSERT(fm.size() == n / 2 - n / 6);
+	fm.clear();
+	ES_ASSERT(fm.isEmpty());
+
+	// object keys use hashCode() and equals().
+	EFlatHashMap<sp<EString>, sp<EInteger> > sm;
+	sm.put(new EString("a"), new EInteger(1));
+	sm.put(new EString("b"), new EInteger(2));
+	EString a("a");
+	ES_ASSERT(sm.get(&a)->intValue() == 1);
+	sp<EInteger> old = sm.put(new EString("a"), new EInteger(3));
+	ES_ASSERT(old->intValue() == 1);
+	ES_ASSERT(sm.size() == 2 && sm.get(&a)->intValue() == 3);
+	LOG("%s, replaced %d", sm.toString().c_str(), old->intValue());
+
+	EFlatHashSet<llong> set;
+	int added = 0, removed = 0;
+	for (int i = 0; i < n; i++) added += set.add((llong)i << 32);
+	boolean again = set.add(0);
+	ES_ASSERT(set.size() == n);
+	for (int i = 0; i < n; i += 2) removed += set.remove((llong)i << 32);
+	LOG("EFlatHashSet: added=%d, added again=%d, removed=%d", added, again, removed);
+	ES_ASSERT(added == n && !again && removed == n / 2);
+	ES_ASSERT(!set.contains(0) && set.contains(1LL << 32));
+
+	LOG("flat hash map ok");
+}
+
+static void test_parallelSort() {
+	const int n = 10000000;
+	EA<llong> a(n);
+	EA<llong> b(n);
+	for (int i = 0; i < n; i++) {
+		a[i] = b[i] = 1700000000000LL + ((llong)(EMath::random() * 60000)); // timestamps of the last minute
+	}
+	llong t1 = ESystem::currentTimeMillis();
+	EArrays::parallelSort(&a);
+	llong t2 = ESystem::currentTimeMillis();
+	b.sort();
+	llong t3 = ESystem::currentTimeMillis();
+	for (int i = 0; i < n; i++) {
+		ES_ASSERT(a[i] == b[i]);
+	}
+	LOG("parallelSort: %lldms, EA::sort: %lldms, parallelism=%d", t2 - t1, t3 - t2,
+			EForkJoinPool::getCommonPoolParallelism());
+
+	// one floating point order on both sides of the radix threshold:
+	// -0.0 before 0.0, NaNs of either sign last.
+	int misordered = 0;
+	for (int len = EArrays::RADIX_SORT_THRESHOLD - 1; len <= EArrays::RADIX_SORT_THRESHOLD; len++) {
+		EA<double> d(len);
+		EA<float> f(len);
+		for (int i = 0; i < len; i++) {
+			switch (i % 5) {
+			case 0: d[i] = -0.0; break;
+			case 1: d[i] = 0.0; break;
+			case 2: d[i] = EDouble::llongBitsToDouble(0x7ff8000000000000LL); break;
+			case 3: d[i] = EDouble::llongBitsToDouble(0xfff8000000000000LL); break;
+			default: d[i] = (i % 7) - 3.5; break;
+			}
+			f[i] = (i % 5 == 3) ? EFloat::intBitsToFloat(0xffc00000) : (float)d[i];
+		}
+		EArrays::sort(&d, 0, len);
+		EArrays::sort(&f, 0, len);
+		int nans = len / 5 * 2 + ((len % 5 > 2) ? 1 : 0) + ((len % 5 > 3) ? 1 : 0);
+		for (int i = 0; i < len; i++) {
+			boolean tail = (i >= len - nans);
+			if (tail != (d[i] != d[i]) || tail != (f[i] != f[i])) misordered++;
+			if (i == 0 || tail) continue;
+			if (d[i - 1] > d[i] || f[i - 1] > f[i]) misordered++;
+			if (EDouble::doubleToLLongBits(d[i - 1]) == 0 &&
+					EDouble::doubleToLLongBits(d[i]) == EDouble::doubleToLLongBits(-0.0)) misordered++;
+			if (EFloat::floatToIntBits(f[i - 1]) == 0 &&
+					EFloat::floatToIntBits(f[i]) == EFloat::floatToIntBits(-0.0f)) misordered++;
+		}
+	}
+	LOG("floating point sort: misordered=%d", misordered);
+	ES_ASSERT(misordered == 0);
+
+	// introsort keeps median-of-3 killers n*log(n).
+	EA<int> pipe(n);
+	for (int i = 0; i < n; i++) {
+		pipe[i] = (i < n / 2) ? i : n - i;
+	}
+	t1 = ESystem::currentTimeMillis();
+	pipe.sort();
+	LOG("organ pipe: %lldms", ESystem::currentTimeMillis() - t1);
+	for (int i = 1; i < n; i++) {
+		ES_ASSERT(pipe[i - 1] <= pipe[i]);
+	}
+
+	LOG("parallel sort ok");
+}
+
+static void test_bTreeMap() {
+	const int n = 1000000;
+
+	EBTreeMap<llong, sp<EInteger> > bm;
+	llong t1 = ESystem::currentTimeMillis();
+	for (int i = 0; i < n; i++) {
+		int k = (int)((llong)i * 7919 % n); // every key once, shuffled
+		bm.put(k, new EInteger(k));
+	}
+	int misses = 0;
+	for (int i = 0; i < n; i++) {
+		if (bm.get(i)->intValue() != i) misses++;
+	}
+	llong t2 = ESystem::currentTimeMillis();
+	ETreeMap<ELLong*, EInteger*> tm;
+	for (int i = 0; i < n; i++) {
+		int k = (int)((llong)i * 7919 % n);
+		tm.put(new ELLong(k), new EInteger(k));
+	}
+	for (int i = 0; i < n; i++) {
+		ELLong k(i);
+		if (tm.get(&k)->intValue() != i) misses++;
+	}
+	llong t3 = ESystem::currentTimeMillis();
+	LOG("EBTreeMap: %lldms, ETreeMap: %lldms, misses=%d", t2 - t1, t3 - t2, misses);
+	ES_ASSERT(misses == 0);
+
+	// navigation and range views.
+	for (int i = 0; i < n; i += 2) {
+		sp<EInteger> v = bm.remove(i);
+		if (v->intValue() != i) misses++;
+	}
+	ES_ASSERT(misses == 0);
+	ES_ASSERT(bm.size() == n / 2);
+	ES_ASSERT(bm.firstKey() == 1 && bm.lastKey() == n - 1);
+	ES_ASSERT(bm.ceilingKey(10) == 11 && bm.floorKey(10) == 9);
+	ES_ASSERT(bm.higherKey(11) == 13 && bm.lowerKey(11) == 9);
+	ES_ASSERT(bm.ceilingEntry(n) == null);
+
+	ENavigableMap<llong, sp<EInteger> >* sub = bm.subMap(1000, true, 2000, false);
+	ES_ASSERT(sub->size() == 500);
+	llong sum = 0;
+	sp<EIterator<EMapEntry<llong, sp<EInteger> >*> > it = sub->entrySet()->iterator();
+	while (it->hasNext()) {
+		EMapEntry<llong, sp<EInteger> >* e = it->next();
+		ES_ASSERT(e->getKey() == e->getValue()->intValue());
+		sum += e->getKey();
+	}
+	ES_ASSERT(sum == 750000);
+	ENavigableMap<llong, sp<EInteger> >* desc = sub->descendingMap();
+	ES_ASSERT(desc->firstKey() == 1999 && desc->higherKey(1501) == 1499);
+	desc->clear();
+	ES_ASSERT(sub->isEmpty() && bm.size() == n / 2 - 500);
+	delete desc;
+	delete sub;
+
+	EMapEntry<llong, sp<EInteger> >* e = bm.pollFirstEntry();
+	LOG("pollFirstEntry: %lld", e->getKey());
+	ES_ASSERT(e->getKey() == 1 && bm.firstKey() == 3);
+
+	// bulk load of sorted input.
+	EA<llong> keys(n);
+	EA<sp<EInteger> > values(n);
+	for (int i = 0; i < n; i++) {
+		keys[i] = 1700000000000LL + i * 10;
+		values[i] = new EInteger(i);
+	}
+	EBTreeMap<llong, sp<EInteger> > tsm;
+	t1 = ESystem::currentTimeMillis();
+	tsm.bulkLoad(&keys, &values);
+	LOG("bulk load: %lldms", ESystem::currentTimeMillis() - t1);
+	ES_ASSERT(tsm.floorEntry(1700000000015LL)->getValue()->intValue() == 1);
+
+	EBTreeSet<sp<EString> > set;
+	set.add(new EString("b"));
+	set.add(new EString("c"));
+	boolean added = set.add(new EString("b"));
+	ES_ASSERT(!added);
+	set.add(new EString("a"));
+	ES_ASSERT(set.size() == 3 && set.first()->equals("a"));
+	EString c("c");
+	ES_ASSERT(set.contains(&c));
+	LOG("EBTreeSet: size=%d, duplicate added=%d", set.size(), added);
+
+	LOG("bTreeMap ok");
+}
+
+static void test_roaringBitmap() {
+	const int bits = 100000000;
+	LOG("EBitWords level: %d", EBitWords::level());
+
+	// sparse segment filters: 1M random bits out of 100M.
+	ERoaringBitmap a, b;
+	EBitSet sa(bits), sb(bits);
+	for (int i = 0; i < 1000000; i++) {
+		int x = EMath::random() * bits;
+		int y = EMath::random() * bits;
+		a.set(x);
+		sa.set(x);
+		b.set(y);
+		sb.set(y);
+	}
+	ES_ASSERT(a.cardinality() == sa.cardinality());
+	ES_ASSERT(a.andCardinality(&b) == sa.andCardinality(&sb));
+
+	llong t1 = ESystem::currentTimeMillis();
+	int n = 0;
+	for (int i = 0; i < 100; i++) {
+		n += a.andCardinality(&b);
+	}
+	llong t2 = ESystem::currentTimeMillis();
+	for (int i = 0; i < 100; i++) {
+		n -= sa.andCardinality(&sb);
+	}
+	llong t3 = ESystem::currentTimeMillis();
+	ES_ASSERT(n == 0);
+	LOG("andCardinality x100: ERoaringBitmap %lldms, EBitSet %lldms", t2 - t1, t3 - t2);
+
+	ERoaringBitmap c(a);
+	c.and_(&b);
+	ES_ASSERT(c.cardinality() == a.andCardinality(&b));
+	for (int i = c.nextSetBit(0); i >= 0; i = c.nextSetBit(i + 1)) {
+		ES_ASSERT(a.get(i) && b.get(i));
+	}
+	c = a;
+	c.or_(&b);
+	c.andNot(&b);
+	ERoaringBitmap f(a);
+	f.andNot(&b);
+	ES_ASSERT(c.equals(&f));
+	c.xor_(&a);
+	ES_ASSERT(c.cardinality() == a.andCardinality(&b));
+
+	// dense ranges turn into bitmap containers.
+	ERoaringBitmap d;
+	d.set(1000, 300000, true);
+	d.clear(2000, 3000);
+	d.flip(299990, 300010);
+	ES_ASSERT(d.cardinality() == 300000 - 1000 - 1000 - 10 + 10);
+	ES_ASSERT(d.nextClearBit(1000) == 2000 && d.nextSetBit(2000) == 3000);
+	ES_ASSERT(d.length() == 300010);
+
+	// serialization round trip.
+	EByteBuffer buf;
+	a.serialize(&buf);
+	ES_ASSERT(buf.size() == a.serializedSizeInBytes());
+	sp<ERoaringBitmap> e = ERoaringBitmap::deserialize(&buf);
+	ES_ASSERT(e->equals(&a) && e->hashCode() == a.hashCode());
+	LOG("serialized %d bits in %d bytes", a.cardinality(), buf.size());
+}
+
+static void test_primitiveCollections() {
+	const int n = 1000000;
+
+	EIntArrayList list;
+	for (int i = 0; i < n; i++) {
+		list.add(n - i);
+	}
+	list.sort();
+	ES_ASSERT(list.getAt(0) == 1 && list.getAt(n - 1) == n);
+	ES_ASSERT(list.binarySearch(4321) == 4320);
+	list.removeRange(0, n / 2);
+	ES_ASSERT(list.size() == n / 2 && list[0] == n / 2 + 1);
+	list.trimToSize();
+	list.addAll(list.data(), 3); // grows while reading its own storage
+	ES_ASSERT(list.size() == n / 2 + 3 && list[n / 2 + 2] == n / 2 + 3);
+
+	ELongArrayList ids;
+	ids.add(1700000000000LL);
+	ids.addAt(0, 42);
+	ES_ASSERT(ids.indexOf(1700000000000LL) == 1);
+
+	llong t1 = ESystem::currentTimeMillis();
+	EIntHashSet set(n);
+	for (int i = 0; i < n; i++) {
+		set.add(i * 7);
+	}
+	int hits = 0;
+	for (int i = 0; i < n; i++) {
+		hits += set.contains(i * 7);
+		hits += set.contains(i * 7 + 1);
+	}
+	llong t2 = ESystem::currentTimeMillis();
+	EHashSet<EInteger*> boxed;
+	for (int i = 0; i < n; i++) {
+		boxed.add(new EInteger(i * 7));
+	}
+	int boxedHits = 0;
+	for (int i = 0; i < n; i++) {
+		EInteger k(i * 7);
+		boxedHits += boxed.contains(&k);
+	}
+	llong t3 = ESystem::currentTimeMillis();
+	LOG("EIntHashSet: %lldms, %d slots, %d hits; EHashSet<EInteger*>: %lldms, %d hits",
+			t2 - t1, set.capacity(), hits, t3 - t2, boxedHits);
+	ES_ASSERT(hits == n && boxedHits == n);
+
+	EIntHashSet::Iterator si = set.iterator();
+	while (si.hasNext()) {
+		if (si.next() % 2 == 0) {
+			si.remove();
+		}
+	}
+	ES_ASSERT(set.size() == n / 2);
+
+	EIntIntHashMap counts(16, -1);
+	for (int i = 0; i < n; i++) {
+		counts.addTo(i % 1000, 1);
+	}
+	ES_ASSERT(counts.size() == 1000 && counts.get(999) == n / 1000);
+	ES_ASSERT(counts.get(1000) == -1 && counts.get(1000, 0) == 0);
+	int old = counts.put(5, 0);
+	int removed = counts.remove(5);
+	LOG("EIntIntHashMap: put returned %d, remove returned %d", old, removed);
+	ES_ASSERT(old == n / 1000 && removed == 0);
+	EIntIntHashMap::Iterator mi = counts.iterator();
+	while (mi.hasNext()) {
+		mi.next();
+		mi.setValue(mi.key());
+	}
+	ES_ASSERT(counts.get(123) == 123);
+
+	ELongObjectHashMap<sp<EString> > names;
+	names.put(1700000000000LL, new EString("a"));
+	names.put(1700000000001LL, new EString("b"));
+	ES_ASSERT(names.get(1700000000001LL)->equals("b"));
+	ES_ASSERT(names.get(1700000000002LL) == null);
+
+	LOG("primitiveCollections ok");
+}
+
 static void test_test(int argc, const char** argv) {
 //	test_null();
 //	test_cmpxchg();
@@ -9795,6 +11727,30 @@ static void test_test(int argc, const char** argv) {
 //	test_c_thread();
 //	test_biginteger();
 //	test_bigdecimal();
+//	test_forkJoinPool();
+//	test_concurrentHashmap3();
+//	test_concurrentHashmapBulk();
+//	test_longAdder();
+//	test_completableFuture();
+//	test_scheduledThreadPool();
+//	test_boundedQueues();
+//	test_spscMpscQueue();
+//	test_adaptiveLocks();
+//	test_stampedLock();
+//	test_copyOnWriteReaders();
+//	test_atomicSharedPtr();
+//	test_atomicSharedPtrRetire();
+//	test_epochReclamation();
+//	test_padded_benchmark();
+//	test_threadPoolExecuteAll();
+//	test_workerLocalQueue();
+//	test_phaser();
+//	test_priorityQueues();
+//	test_flatHashMap();
+//	test_parallelSort();
+//	test_bTreeMap();
+//	test_roaringBitmap();
+//	test_primitiveCollections();
 //
 //	EThread::sleep(3000);
 }
@@ -430,6 +430,108 @@ static void test_nioudpserver() {
 	delete selector;
 }
 
+//===========================================================================
+
+#ifdef CPP20_SUPPORT
+
+static ETask<void> asyncSession(ESocketChannel* sc) {
+	EAsyncSocketChannel client(sc);
+	EIOByteBuffer buf(512);
+	try {
+		while (co_await client.read(&buf) > 0) {
+			buf.flip();
+			co_await client.write(&buf);
+			buf.clear();
+		}
+	} catch (EIOException& e) {
+		LOG("session: %s", e.toString().c_str());
+	}
+	client.close();
+}
+
+static ETask<void> asyncServer(EEventLoopGroup* group) {
+	EAsyncServerSocketChannel server;
+	server.bind("127.0.0.1", 8899, 4096);
+	for (;;) {
+		ESocketChannel* sc = co_await server.accept();
+		group->next()->spawn(asyncSession(sc));
+	}
+}
+
+static EAtomicCounter asyncRounds;
+
+static ETask<void> asyncClient() {
+	EAsyncSocketChannel client;
+	EInetSocketAddress remote("127.0.0.1", 8899);
+	co_await client.connect(&remote);
+	EIOByteBuffer buf(512);
+	for (int i = 0; i < 1000; i++) {
+		buf.clear();
+		buf.put("ping", 4);
+		buf.flip();
+		co_await client.write(&buf);
+		buf.clear();
+		int got = 0;
+		while (got < 4) {
+			int n = co_await client.read(&buf);
+			if (n < 0) {
+				throw EIOException(__FILE__, __LINE__, "closed");
+			}
+			got += n;
+		}
+		asyncRounds++;
+	}
+	client.close();
+}
+
+static void test_nioasync() {
+	EEventLoopGroup group; //one loop per core
+	group.next()->spawn(asyncServer(&group));
+	EThread::sleep(100);
+
+	llong t1 = ESystem::currentTimeMillis();
+	for (int i = 0; i < 1000; i++) {
+		group.spawn(asyncClient());
+	}
+	while (asyncRounds.value() < 1000 * 1000) {
+		EThread::sleep(10);
+	}
+	LOG("async echo: 1000 clients x 1000 rounds, %lldms", ESystem::currentTimeMillis() - t1);
+	group.shutdown();
+}
+
+static volatile int asyncCancelled;
+
+static ETask<void> asyncAcceptor(EAsyncServerSocketChannel* server) {
+	try {
+		delete co_await server->accept();
+	} catch (EAsynchronousCloseException& e) {
+		asyncCancelled = 1;
+	}
+}
+
+static ETask<void> asyncCloser(EEventLoop* loop, EAsyncServerSocketChannel* server) {
+	co_await loop->sleep(100);
+	server->close();
+}
+
+static void test_nioasync_close() {
+	EEventLoopGroup group(1);
+	EEventLoop* loop = group.next();
+	EAsyncServerSocketChannel server(loop);
+	server.bind("127.0.0.1", 0);
+	asyncCancelled = 0;
+	loop->spawn(asyncAcceptor(&server));
+	loop->spawn(asyncCloser(loop, &server));
+	for (int i = 0; i < 100 && !asyncCancelled; i++) {
+		EThread::sleep(10);
+	}
+	LOG("async close resumes a pending accept: %s", asyncCancelled ? "yes" : "no");
+	group.shutdown();
+}
+
+#endif //!CPP20_SUPPORT
+
 MAIN_IMPL(testnio) {
 	ESystem::init(argc, argv);
 
@@ -443,6 +545,10 @@ MAIN_IMPL(testnio) {
 //		test_filechannel();
 		test_nioudpserver();
 //		test_nioudpclient();
+#ifdef CPP20_SUPPORT
+//		test_nioasync();
+//		test_nioasync_close();
+#endif
 
 		} while (1);
 	}